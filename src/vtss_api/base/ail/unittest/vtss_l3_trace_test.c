@@ -0,0 +1,384 @@
+// Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+// SPDX-License-Identifier: MIT
+
+// Call trace test of the AIL L3 layer (vtss_l3.c).
+//
+// vtss_l3.c is linked against stub CIL functions, which record every call
+// (route add with the next network, which is the LPM VCAP insert anchor,
+// route delete and ARP set) in a trace. A random sequence of IPv4/IPv6 route
+// and neighbour add/delete operations is replayed, and the digest of the
+// trace is compared with the one recorded with the list-based vtss_l3.c that
+// preceded the network tree and next-hop hashes. Any change in hardware
+// programming order or LPM VCAP layout changes the digest.
+//
+// Options:
+//   -n <operations>  Replay this many operations (default: 30000). The digest
+//                    is only checked with the default.
+//   -p               Print the trace, e.g. to diff it against an older build.
+//   -b <routes>      Instead, time bulk adding <routes> IPv4 routes over 16
+//                    next-hops, updating the neighbours and bulk deleting the
+//                    routes. Limited by the size of the LPM table.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "vtss_api.h"
+#include "vtss_state.h"
+
+#define L3_TEST_OPS_DEFAULT 30000
+
+// Trace digest of L3_TEST_OPS_DEFAULT operations with the list-based vtss_l3.c,
+// built for VTSS_CHIP_7558 like in CMakeLists.txt
+#define L3_TEST_DIGEST      0x29af3d167f8e94a0ULL
+#define L3_TEST_LINES       472685
+
+static vtss_state_t *l3_test_state;
+static BOOL         l3_test_print;
+static u64          l3_test_digest = 0xcbf29ce484222325ULL; // FNV-1a offset basis
+static u32          l3_test_lines;
+static u32          l3_test_cil_cnt;
+
+// Adds a line to the trace
+static void l3_test_trace(const char *format, ...)
+{
+    char    buf[256];
+    va_list args;
+    int     i;
+
+    va_start(args, format);
+    (void)vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    for (i = 0; buf[i] != '\0'; i++) {
+        l3_test_digest = (l3_test_digest ^ (u8)buf[i]) * 0x100000001b3ULL; // FNV-1a prime
+    }
+
+    l3_test_lines++;
+    if (l3_test_print) {
+        fputs(buf, stdout);
+    }
+}
+
+/* - Stubs of what vtss_l3.c uses from the rest of the API ------- */
+
+vtss_trace_conf_t vtss_trace_conf[VTSS_TRACE_GROUP_COUNT];
+const char        *vtss_func = "";
+
+void vtss_callout_lock(const vtss_api_lock_t *const lock)
+{
+}
+
+void vtss_callout_unlock(const vtss_api_lock_t *const lock)
+{
+}
+
+void vtss_callout_trace_printf(const vtss_trace_layer_t layer, const vtss_trace_group_t group,
+                               const vtss_trace_level_t level, const char *file, const int line,
+                               const char *function, const char *format, ...)
+{
+}
+
+vtss_rc vtss_inst_check(const vtss_inst_t inst, vtss_state_t **vtss_state)
+{
+    *vtss_state = l3_test_state;
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cmn_vcap_res_check(vtss_vcap_obj_t *obj, vtss_res_chg_t *chg)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_vcap_lookup(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, int user, vtss_vcap_id_t id,
+                         vtss_vcap_data_t *data, vtss_vcap_idx_t *idx)
+{
+    return VTSS_RC_ERROR;
+}
+
+vtss_rc vtss_cil_l3_rleg_counters_get(vtss_state_t *vtss_state, const vtss_l3_rleg_id_t rleg_id)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_rleg_counters_reset(vtss_state_t *vtss_state)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_common_set(vtss_state_t *vtss_state, const vtss_l3_common_conf_t *const conf)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_rleg_set(vtss_state_t *vtss_state, const vtss_l3_rleg_id_t rleg_id, const vtss_l3_rleg_conf_t *const conf)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_vlan_set(vtss_state_t *vtss_state, const vtss_l3_rleg_id_t rleg_id, const vtss_vid_t vid, const BOOL enable)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_mc_rt_add(vtss_state_t *vtss_state, vtss_l3_mc_rt_t *mc)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_mc_rt_del(vtss_state_t *vtss_state, vtss_l3_mc_rt_t *mc)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_mc_rt_rleg_add(vtss_state_t *vtss_state, vtss_l3_mc_rt_t *mc)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_mc_rt_rleg_del(vtss_state_t *vtss_state, vtss_l3_mc_rt_t *mc)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_debug_sticky_clear(vtss_state_t *vtss_state)
+{
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_rt_add(vtss_state_t *vtss_state, vtss_l3_net_t *net, vtss_l3_nb_t *nb, u32 cnt)
+{
+    l3_test_cil_cnt++;
+    l3_test_trace("ADD %llu %u/%u next %llu grp %d cnt %u mac %02x%02x rleg %u\n",
+                  (unsigned long long)net->id, net->network.addr.ipv4, net->prefix_size,
+                  net->next ? (unsigned long long)net->next->id : 0ULL, net->grp ? net->grp->idx : -1, cnt,
+                  nb ? nb->dmac.addr[4] : 0, nb ? nb->dmac.addr[5] : 0, nb ? nb->rleg : 0);
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_rt_del(vtss_state_t *vtss_state, vtss_l3_net_t *net)
+{
+    l3_test_cil_cnt++;
+    l3_test_trace("DEL %llu\n", (unsigned long long)net->id);
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_cil_l3_arp_set(vtss_state_t *vtss_state, u32 idx, vtss_l3_nb_t *nb)
+{
+    l3_test_cil_cnt++;
+    l3_test_trace("ARP %u mac %02x%02x\n", idx, nb->dmac.addr[4], nb->dmac.addr[5]);
+    return VTSS_RC_OK;
+}
+
+/* - Trace replay ------------------------------------------------- */
+
+// Same sequence on all hosts, unlike rand()
+static u32 l3_test_rnd_state = 1;
+
+static u32 l3_test_rnd(void)
+{
+    l3_test_rnd_state = l3_test_rnd_state * 1103515245 + 12345;
+    return (l3_test_rnd_state >> 8);
+}
+
+static void l3_test_route(vtss_routing_entry_t *rt, u32 net, u8 prefix_size, u32 nh, BOOL ipv6)
+{
+    memset(rt, 0, sizeof(*rt));
+    if (ipv6) {
+        rt->type = VTSS_ROUTING_ENTRY_TYPE_IPV6_UC;
+        memcpy(&rt->route.ipv6_uc.network.address.addr[12], &net, 4);
+        rt->route.ipv6_uc.network.prefix_size = prefix_size + 96;
+        memcpy(&rt->route.ipv6_uc.destination.addr[12], &nh, 4);
+        rt->vlan = 1 + (nh & 1);
+    } else {
+        rt->type = VTSS_ROUTING_ENTRY_TYPE_IPV4_UC;
+        rt->route.ipv4_uc.network.address = net;
+        rt->route.ipv4_uc.network.prefix_size = prefix_size;
+        rt->route.ipv4_uc.destination = nh;
+    }
+}
+
+static void l3_test_nb(vtss_l3_neighbour_t *nb, u32 ip, u8 mac, BOOL ipv6)
+{
+    memset(nb, 0, sizeof(*nb));
+    nb->vlan = ipv6 ? 1 + (ip & 1) : 1;
+    nb->dmac.addr[4] = ip & 0xff;
+    nb->dmac.addr[5] = mac;
+    if (ipv6) {
+        nb->dip.type = VTSS_IP_TYPE_IPV6;
+        memcpy(&nb->dip.addr.ipv6.addr[12], &ip, 4);
+    } else {
+        nb->dip.type = VTSS_IP_TYPE_IPV4;
+        nb->dip.addr.ipv4 = ip;
+    }
+}
+
+static void l3_test_replay(u32 ops)
+{
+    vtss_routing_entry_t rt;
+    vtss_l3_neighbour_t  nb;
+    u32                  i, r, net, nh;
+    u8                   prefix_size;
+    BOOL                 ipv6;
+
+    for (i = 0; i < ops; i++) {
+        r = l3_test_rnd() % 100;
+        ipv6 = (l3_test_rnd() % 4) == 0;
+        net = (l3_test_rnd() % 64) << 24;
+        net |= (l3_test_rnd() % 4) << 16;
+        prefix_size = 8 + (l3_test_rnd() % 3) * 4;
+        nh = 0x0a000001 + l3_test_rnd() % 12;
+        if (r < 45) {
+            l3_test_route(&rt, net, prefix_size, nh, ipv6);
+            l3_test_trace("rc %d\n", vtss_l3_route_add(NULL, &rt));
+        } else if (r < 80) {
+            l3_test_route(&rt, net, prefix_size, nh, ipv6);
+            l3_test_trace("rc %d\n", vtss_l3_route_del(NULL, &rt));
+        } else if (r < 90) {
+            l3_test_nb(&nb, nh, l3_test_rnd() % 256, ipv6);
+            l3_test_trace("rc %d\n", vtss_l3_neighbour_add(NULL, &nb));
+        } else {
+            l3_test_nb(&nb, nh, 0, ipv6);
+            l3_test_trace("rc %d\n", vtss_l3_neighbour_del(NULL, &nb));
+        }
+    }
+
+    l3_test_trace("free net %u nb %u grp %u nh %u\n", l3_test_state->l3.net.free_cnt, l3_test_state->l3.nb.free_cnt,
+                  l3_test_state->l3.nh_grp.free_cnt, l3_test_state->l3.nh.free_cnt);
+}
+
+static double l3_test_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void l3_test_bench(u32 cnt)
+{
+    vtss_routing_entry_t *rt, tmp;
+    vtss_l3_neighbour_t  nb;
+    u32                  i, j, total, done;
+    double               t0, t1, t2, t3;
+
+    if (cnt > VTSS_L3_NET_CNT) {
+        printf("Limiting %u routes to the LPM table size (%u)\n", cnt, VTSS_L3_NET_CNT);
+        cnt = VTSS_L3_NET_CNT;
+    }
+
+    if ((rt = calloc(cnt, sizeof(*rt))) == NULL) {
+        exit(1);
+    }
+
+    for (i = 0; i < 16; i++) {
+        l3_test_nb(&nb, 0x0a000001 + i, i, FALSE);
+        (void)vtss_l3_neighbour_add(NULL, &nb);
+    }
+
+    for (i = 0; i < cnt; i++) {
+        l3_test_route(&rt[i], 0xc6120000 + (i << 8), 16 + (i % 9), 0x0a000001 + (i % 16), FALSE);
+    }
+
+    // Random order, like a routing table coming from a routing protocol
+    for (i = cnt - 1; i > 0; i--) {
+        j = l3_test_rnd() % (i + 1);
+        tmp = rt[i];
+        rt[i] = rt[j];
+        rt[j] = tmp;
+    }
+
+    t0 = l3_test_ms();
+    for (total = 0; total < cnt; total += done) {
+        if (vtss_l3_route_bulk_add(NULL, cnt - total, rt + total, &done) != VTSS_RC_OK || done == 0) {
+            break;
+        }
+    }
+
+    t1 = l3_test_ms();
+    for (i = 0; i < 16; i++) {
+        l3_test_nb(&nb, 0x0a000001 + i, i + 100, FALSE);
+        (void)vtss_l3_neighbour_add(NULL, &nb);
+    }
+
+    t2 = l3_test_ms();
+    for (i = 0; i < total; i += done) {
+        if (vtss_l3_route_bulk_del(NULL, total - i, rt + i, &done) != VTSS_RC_OK || done == 0) {
+            break;
+        }
+    }
+
+    t3 = l3_test_ms();
+    printf("%u routes: bulk add %.1f ms, neighbour update %.1f ms, bulk del %.1f ms, %u CIL calls\n",
+           total, t1 - t0, t2 - t1, t3 - t2, l3_test_cil_cnt);
+    free(rt);
+}
+
+int main(int argc, char **argv)
+{
+    vtss_l3_common_conf_t common;
+    vtss_l3_rleg_conf_t   rleg;
+    u32                   ops = L3_TEST_OPS_DEFAULT, bench_cnt = 0;
+    int                   opt, vid;
+
+    while ((opt = getopt(argc, argv, "n:pb:")) != -1) {
+        switch (opt) {
+        case 'n':
+            ops = atoi(optarg);
+            break;
+        case 'p':
+            l3_test_print = TRUE;
+            break;
+        case 'b':
+            bench_cnt = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n <operations>] [-p] [-b <routes>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if ((l3_test_state = calloc(1, sizeof(*l3_test_state))) == NULL) {
+        return 1;
+    }
+
+    l3_test_state->create_pre = TRUE;
+    (void)vtss_l3_inst_create(l3_test_state);
+    l3_test_state->create_pre = FALSE;
+    (void)vtss_l3_inst_create(l3_test_state);
+
+    memset(&common, 0, sizeof(common));
+    common.routing_enable = TRUE;
+    common.rleg_mode = VTSS_ROUTING_RLEG_MAC_MODE_SINGLE;
+    (void)vtss_l3_common_set(NULL, &common);
+    for (vid = 1; vid <= 2; vid++) {
+        memset(&rleg, 0, sizeof(rleg));
+        rleg.vlan = vid;
+        rleg.ipv4_unicast_enable = TRUE;
+        rleg.ipv6_unicast_enable = TRUE;
+        (void)vtss_l3_rleg_add(NULL, &rleg);
+    }
+
+    if (bench_cnt != 0) {
+        l3_test_bench(bench_cnt);
+        return 0;
+    }
+
+    l3_test_replay(ops);
+    if (l3_test_print) {
+        return 0;
+    }
+
+    printf("%u operations: %u trace lines, %u CIL calls, digest 0x%016llx\n", ops, l3_test_lines, l3_test_cil_cnt,
+           (unsigned long long)l3_test_digest);
+    if (ops == L3_TEST_OPS_DEFAULT && (l3_test_digest != L3_TEST_DIGEST || l3_test_lines != L3_TEST_LINES)) {
+        fprintf(stderr, "Trace differs from the list-based vtss_l3.c (digest 0x%016llx, %u lines)\n",
+                L3_TEST_DIGEST, L3_TEST_LINES);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
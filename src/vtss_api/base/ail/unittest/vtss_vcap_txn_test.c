@@ -0,0 +1,437 @@
+// Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+// SPDX-License-Identifier: MIT
+
+// Test and benchmark of the VCAP transactions (vtss_vcap_txn_begin() and
+// vtss_vcap_txn_commit()) in vtss_vcap_api.c.
+//
+// vtss_vcap_api.c is linked against a stub IS2 vtss_vcap_obj_t, whose
+// entry_get/add/del/move/move_dist methods emulate a TCAM and count the
+// calls. Like the FA CIL, it moves rules several positions in one operation
+// with entry_move_dist, without which transactions are refused. The
+// same sequence of rule adds (appended, inserted, modified with another key
+// size) and deletes is applied twice: Once rule by rule, like vtss_ace_add()
+// and vtss_ace_del() do, and once in a transaction, like
+// vtss_ace_update_list() does. Both must end with each rule (and its hit
+// counter) at the position given by the rule list. The CIL calls of both are
+// printed.
+//
+// Options:
+//   -n <rules>       Number of rules loaded (default: 1000)
+//   -u <operations>  Number of operations in the update after loading
+//                    (default: 200)
+//   -r <seed>        Random seed (default: 1)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "vtss_api.h"
+#include "vtss_state.h"
+
+// The TCAM is emulated with 48 slots per row, so that a rule of any key size
+// occupies a whole number of slots.
+#define VCAP_TEST_SLOTS 48
+
+typedef struct {
+    u32 id;      // ID of the rule occupying the slot, zero if unused
+    u32 counter; // Hit counter, only kept in the first slot of a rule
+} vcap_test_slot_t;
+
+typedef struct {
+    u32 get;        // entry_get() calls
+    u32 add;        // entry_add() calls
+    u32 del;        // entry_del() calls
+    u32 move;       // entry_move() and entry_move_dist() calls
+    u64 move_slots; // Slots moved by them
+} vcap_test_cnt_t;
+
+typedef struct {
+    BOOL                 add;
+    vtss_vcap_id_t       id;
+    vtss_vcap_id_t       ins_id;
+    vtss_vcap_key_size_t key_size;
+} vcap_test_op_t;
+
+static vtss_state_t     *vcap_test_state;
+static vcap_test_slot_t *vcap_test_tcam;
+static u32              vcap_test_rows;
+static vcap_test_cnt_t  vcap_test_cnt;
+
+/* - Stubs of what vtss_vcap_api.c uses from the rest of the API -- */
+
+vtss_trace_conf_t vtss_trace_conf[VTSS_TRACE_GROUP_COUNT];
+const char        *vtss_func = "";
+
+void vtss_callout_lock(const vtss_api_lock_t *const lock)
+{
+}
+
+void vtss_callout_unlock(const vtss_api_lock_t *const lock)
+{
+}
+
+void vtss_callout_trace_printf(const vtss_trace_layer_t layer, const vtss_trace_group_t group,
+                               const vtss_trace_level_t level, const char *file, const int line,
+                               const char *function, const char *format, ...)
+{
+}
+
+vtss_rc vtss_inst_check(const vtss_inst_t inst, vtss_state_t **vtss_state)
+{
+    *vtss_state = vcap_test_state;
+    return VTSS_RC_OK;
+}
+
+vtss_rc vtss_inst_port_no_check(const vtss_inst_t inst, vtss_state_t **vtss_state, const vtss_port_no_t port_no)
+{
+    *vtss_state = vcap_test_state;
+    return VTSS_RC_OK;
+}
+
+BOOL vtss_debug_group_enabled(const vtss_debug_printf_t pr, const vtss_debug_info_t *const info,
+                              const vtss_debug_group_t group)
+{
+    return FALSE;
+}
+
+void vtss_debug_print_header(const vtss_debug_printf_t pr, const char *header)
+{
+}
+
+void vtss_debug_print_port_header(vtss_state_t *vtss_state, const vtss_debug_printf_t pr,
+                                  const char *txt, u32 count, BOOL nl)
+{
+}
+
+void vtss_debug_print_port_members(vtss_state_t *vtss_state, const vtss_debug_printf_t pr,
+                                   BOOL port_member[VTSS_PORT_ARRAY_SIZE], BOOL nl)
+{
+}
+
+/* - Emulated TCAM ------------------------------------------------ */
+
+// First slot and number of slots of a rule
+static u32 vcap_test_slot(const vtss_vcap_idx_t *idx, u32 *size)
+{
+    *size = (VCAP_TEST_SLOTS / vtss_vcap_key_rule_count(idx->key_size));
+    return (idx->row * VCAP_TEST_SLOTS + idx->col * *size);
+}
+
+static vtss_rc vcap_test_entry_get(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx, u32 *counter, BOOL clear)
+{
+    u32 size, slot = vcap_test_slot(idx, &size);
+
+    vcap_test_cnt.get++;
+    *counter = vcap_test_tcam[slot].counter;
+    if (clear) {
+        vcap_test_tcam[slot].counter = 0;
+    }
+    return VTSS_RC_OK;
+}
+
+static vtss_rc vcap_test_entry_add(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx, vtss_vcap_data_t *data, u32 counter)
+{
+    u32 i, size, slot = vcap_test_slot(idx, &size);
+
+    vcap_test_cnt.add++;
+    if (idx->row >= vcap_test_rows) {
+        fprintf(stderr, "entry_add() row %u outside TCAM\n", idx->row);
+        exit(1);
+    }
+    for (i = 0; i < size; i++) {
+        vcap_test_tcam[slot + i].id = data->u.is2.entry->ace.id;
+        vcap_test_tcam[slot + i].counter = (i == 0 ? counter : 0);
+    }
+    return VTSS_RC_OK;
+}
+
+static vtss_rc vcap_test_entry_del(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx)
+{
+    u32 size, slot = vcap_test_slot(idx, &size);
+
+    vcap_test_cnt.del++;
+    memset(&vcap_test_tcam[slot], 0, size * sizeof(vcap_test_slot_t));
+    return VTSS_RC_OK;
+}
+
+// Moves <count> rules one position up/down. Like the hardware, the position
+// left behind keeps its contents.
+static vtss_rc vcap_test_entry_move(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx, u32 count, BOOL up)
+{
+    u32 size, slot = vcap_test_slot(idx, &size), len = (count * size);
+
+    vcap_test_cnt.move++;
+    vcap_test_cnt.move_slots += len;
+    if ((up && slot < size) || (!up && (slot + len + size) > vcap_test_rows * VCAP_TEST_SLOTS)) {
+        fprintf(stderr, "entry_move() outside TCAM\n");
+        exit(1);
+    }
+    memmove(&vcap_test_tcam[up ? (slot - size) : (slot + size)], &vcap_test_tcam[slot], len * sizeof(vcap_test_slot_t));
+    return VTSS_RC_OK;
+}
+
+// Moves <count> rules <dist> positions up/down in one operation
+static vtss_rc vcap_test_entry_move_dist(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx, u32 count, u32 dist, BOOL up)
+{
+    u32 size, slot = vcap_test_slot(idx, &size), len = (count * size);
+
+    vcap_test_cnt.move++;
+    vcap_test_cnt.move_slots += len;
+    if ((up && slot < dist * size) || (!up && (slot + len + dist * size) > vcap_test_rows * VCAP_TEST_SLOTS)) {
+        fprintf(stderr, "entry_move_dist() outside TCAM\n");
+        exit(1);
+    }
+    memmove(&vcap_test_tcam[up ? (slot - dist * size) : (slot + dist * size)], &vcap_test_tcam[slot],
+            len * sizeof(vcap_test_slot_t));
+    return VTSS_RC_OK;
+}
+
+static void vcap_test_obj_init(vtss_vcap_obj_t *obj, vtss_vcap_entry_t *table, u32 rule_cnt)
+{
+    u32 i;
+
+    memset(obj, 0, sizeof(*obj));
+    memset(table, 0, rule_cnt * sizeof(*table));
+    memset(vcap_test_tcam, 0, vcap_test_rows * VCAP_TEST_SLOTS * sizeof(vcap_test_slot_t));
+    obj->max_count = vcap_test_rows;
+    obj->max_rule_count = rule_cnt;
+    obj->name = "IS2";
+    obj->type = VTSS_VCAP_TYPE_IS2;
+    obj->entry_get = vcap_test_entry_get;
+    obj->entry_add = vcap_test_entry_add;
+    obj->entry_del = vcap_test_entry_del;
+    obj->entry_move = vcap_test_entry_move;
+    obj->entry_move_dist = vcap_test_entry_move_dist;
+    for (i = 0; i < rule_cnt; i++) {
+        table[i].next = obj->free;
+        obj->free = &table[i];
+    }
+}
+
+/* - Test ---------------------------------------------------------- */
+
+static vtss_rc vcap_test_apply(vtss_vcap_obj_t *obj, const vcap_test_op_t *op)
+{
+    vtss_is2_entry_t entry;
+    vtss_vcap_data_t data;
+
+    if (!op->add) {
+        return vtss_vcap_del(vcap_test_state, obj, 0, op->id);
+    }
+    memset(&entry, 0, sizeof(entry));
+    memset(&data, 0, sizeof(data));
+    entry.ace.id = op->id;
+    data.key_size = op->key_size;
+    data.u.is2.entry = &entry;
+    return vtss_vcap_add(vcap_test_state, obj, 0, op->id, op->ins_id, &data, FALSE);
+}
+
+static void vcap_test_run(vtss_vcap_obj_t *obj, const vcap_test_op_t *ops, u32 cnt, BOOL txn)
+{
+    u32 i;
+
+    if (txn && vtss_vcap_txn_begin(vcap_test_state, obj) != VTSS_RC_OK) {
+        fprintf(stderr, "vtss_vcap_txn_begin() failed\n");
+        exit(1);
+    }
+    for (i = 0; i < cnt; i++) {
+        if (vcap_test_apply(obj, &ops[i]) != VTSS_RC_OK) {
+            fprintf(stderr, "operation %u failed\n", i);
+            exit(1);
+        }
+    }
+    if (txn && vtss_vcap_txn_commit(vcap_test_state, obj) != VTSS_RC_OK) {
+        fprintf(stderr, "vtss_vcap_txn_commit() failed\n");
+        exit(1);
+    }
+}
+
+// Gets the position of rule number <ndx> of a key size. Blocks of smaller
+// rules are located before blocks of larger rules.
+static void vcap_test_pos_get(vtss_vcap_obj_t *obj, vtss_vcap_idx_t *idx, u32 ndx)
+{
+    u32 i, cnt = vtss_vcap_key_rule_count(idx->key_size);
+
+    idx->row = (ndx / cnt);
+    idx->col = (ndx % cnt);
+    for (i = (idx->key_size + 1); i < VTSS_VCAP_KEY_SIZE_MAX; i++) {
+        cnt = vtss_vcap_key_rule_count(i);
+        idx->row += ((obj->key_count[i] + cnt - 1) / cnt);
+    }
+}
+
+// Checks that each rule is at the position given by the rule list and has
+// the expected counter. Entries left behind by moves are not checked. If
+// <set> is TRUE, the counters are set to a value depending on the rule ID
+// instead.
+static BOOL vcap_test_check(vtss_vcap_obj_t *obj, u32 *counter, const char *name, BOOL set)
+{
+    vtss_vcap_entry_t *cur;
+    vtss_vcap_idx_t   idx;
+    u32               ndx[VTSS_VCAP_KEY_SIZE_MAX], i, size, slot;
+
+    memset(ndx, 0, sizeof(ndx));
+    for (cur = obj->used; cur != NULL; cur = cur->next) {
+        idx.key_size = cur->data.key_size;
+        vcap_test_pos_get(obj, &idx, ndx[idx.key_size]++);
+        slot = vcap_test_slot(&idx, &size);
+        for (i = 0; i < size; i++) {
+            if (vcap_test_tcam[slot + i].id != cur->id) {
+                fprintf(stderr, "%s: rule %u expected at row %u, col %u, found %u\n",
+                        name, (u32)cur->id, idx.row, idx.col, vcap_test_tcam[slot + i].id);
+                return FALSE;
+            }
+        }
+        if (set) {
+            counter[cur->id] = vcap_test_tcam[slot].counter = (1000 + cur->id);
+        } else if (vcap_test_tcam[slot].counter != counter[cur->id]) {
+            fprintf(stderr, "%s: rule %u has counter %u, expected %u\n",
+                    name, (u32)cur->id, vcap_test_tcam[slot].counter, counter[cur->id]);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+// Key sizes used by IS2 rules
+static vtss_vcap_key_size_t vcap_test_key_size(void)
+{
+    u32 r = (rand() % 8);
+
+    return (r < 5 ? VTSS_VCAP_KEY_SIZE_HALF : r < 7 ? VTSS_VCAP_KEY_SIZE_QUARTER : VTSS_VCAP_KEY_SIZE_FULL);
+}
+
+// Generates <cnt> operations on the IDs in <present>, which is updated
+static u32 vcap_test_ops_gen(vcap_test_op_t *ops, u32 cnt, BOOL *present, u32 id_cnt, BOOL load)
+{
+    u32 i, id, ins;
+
+    for (i = 0; i < cnt; i++) {
+        vcap_test_op_t *op = &ops[i];
+
+        // Pick an ID present (for modify/delete) or not (for add)
+        op->add = (load || (rand() % 3) != 0);
+        do {
+            id = 1 + (rand() % (id_cnt - 1));
+        } while (load && present[id]);
+        if (!op->add && !present[id]) {
+            op->add = TRUE;
+        }
+
+        // Insert before a random rule present or last
+        op->ins_id = VTSS_VCAP_ID_LAST;
+        if (op->add && (rand() % 4) != 0) {
+            for (ins = 1 + (rand() % (id_cnt - 1)); ins < id_cnt && (!present[ins] || ins == id); ins++) {
+            }
+            if (ins < id_cnt) {
+                op->ins_id = ins;
+            }
+        }
+        op->id = id;
+        op->key_size = vcap_test_key_size();
+        present[id] = op->add;
+    }
+    return cnt;
+}
+
+static void vcap_test_print(const char *name, const vcap_test_cnt_t *c)
+{
+    printf("%-28s %8u %8u %8u %8u %12.1f\n", name, c->get, c->add, c->del, c->move,
+           (double)c->move_slots / VCAP_TEST_SLOTS);
+}
+
+int main(int argc, char **argv)
+{
+    vtss_vcap_obj_t   obj;
+    vtss_vcap_entry_t *table;
+    vcap_test_op_t    *load_ops, *upd_ops;
+    vcap_test_cnt_t   cnt[4];
+    BOOL              *present;
+    u32               *counter, rule_cnt = 1000, upd_cnt = 200, seed = 1, id_cnt, run;
+    int               opt;
+
+    while ((opt = getopt(argc, argv, "n:u:r:")) != -1) {
+        switch (opt) {
+        case 'n':
+            rule_cnt = atoi(optarg);
+            break;
+        case 'u':
+            upd_cnt = atoi(optarg);
+            break;
+        case 'r':
+            seed = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n <rules>] [-u <operations>] [-r <seed>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Room for all rules as full rules, also during the update
+    srand(seed);
+    id_cnt = (2 * rule_cnt + 1);
+    vcap_test_rows = (rule_cnt + upd_cnt);
+    vcap_test_state = calloc(1, sizeof(*vcap_test_state));
+    vcap_test_tcam = calloc(vcap_test_rows * VCAP_TEST_SLOTS, sizeof(*vcap_test_tcam));
+    table = calloc(vcap_test_rows, sizeof(*table));
+    load_ops = calloc(rule_cnt, sizeof(*load_ops));
+    upd_ops = calloc(upd_cnt, sizeof(*upd_ops));
+    present = calloc(id_cnt, sizeof(*present));
+    counter = calloc(id_cnt, sizeof(*counter));
+    if (vcap_test_state == NULL || vcap_test_tcam == NULL || table == NULL ||
+        load_ops == NULL || upd_ops == NULL || present == NULL || counter == NULL) {
+        return 1;
+    }
+
+    // Loading a rule list in random order, then updating it
+    (void)vcap_test_ops_gen(load_ops, rule_cnt, present, id_cnt, TRUE);
+    (void)vcap_test_ops_gen(upd_ops, upd_cnt, present, id_cnt, FALSE);
+
+    // Without entry_move_dist, the VCAP is updated directly
+    vcap_test_obj_init(&obj, table, vcap_test_rows);
+    obj.entry_move_dist = NULL;
+    if (vtss_vcap_txn_begin(vcap_test_state, &obj) == VTSS_RC_OK) {
+        fprintf(stderr, "vtss_vcap_txn_begin() accepted a VCAP without entry_move_dist\n");
+        return 1;
+    }
+
+    printf("%u rules loaded, then %u operations, %u rows\n", rule_cnt, upd_cnt, vcap_test_rows);
+    printf("%-28s %8s %8s %8s %8s %12s\n", "", "Get", "Add", "Del", "Move", "Moved rows");
+    for (run = 0; run < 2; run++) {
+        const char *name = (run ? "txn" : "direct");
+        char       buf[64];
+
+        // Load
+        vcap_test_obj_init(&obj, table, vcap_test_rows);
+        memset(&vcap_test_cnt, 0, sizeof(vcap_test_cnt));
+        vcap_test_run(&obj, load_ops, rule_cnt, run);
+        cnt[run * 2] = vcap_test_cnt;
+        memset(counter, 0, id_cnt * sizeof(*counter));
+        if (!vcap_test_check(&obj, counter, name, FALSE)) {
+            return 1;
+        }
+
+        // Update, counters of rules kept must be kept
+        (void)vcap_test_check(&obj, counter, name, TRUE);
+        memset(&vcap_test_cnt, 0, sizeof(vcap_test_cnt));
+        vcap_test_run(&obj, upd_ops, upd_cnt, run);
+        cnt[run * 2 + 1] = vcap_test_cnt;
+        for (u32 i = 0; i < upd_cnt; i++) {
+            // Deleted and re-added rules start counting again
+            if (!upd_ops[i].add) {
+                counter[upd_ops[i].id] = 0;
+            }
+        }
+        if (!vcap_test_check(&obj, counter, name, FALSE)) {
+            return 1;
+        }
+
+        sprintf(buf, "%s: load", name);
+        vcap_test_print(buf, &cnt[run * 2]);
+        sprintf(buf, "%s: update", name);
+        vcap_test_print(buf, &cnt[run * 2 + 1]);
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -1163,6 +1163,171 @@ vtss_rc vtss_mac_table_get_next(const vtss_inst_t       inst,
     return rc;
 }
 
+/* Compare MAC table keys */
+static int vtss_mac_key_cmp(u32 mach_1, u32 macl_1, u32 mach_2, u32 macl_2)
+{
+    if (mach_1 != mach_2) {
+        return (mach_1 < mach_2 ? -1 : 1);
+    }
+    return (macl_1 < macl_2 ? -1 : macl_1 > macl_2 ? 1 : 0);
+}
+
+/* Next static entry, starting at 'cur' */
+static vtss_mac_entry_t *vtss_mac_bulk_static_next(vtss_state_t *vtss_state,
+                                                   vtss_mac_entry_t *cur,
+                                                   vtss_mac_table_entry_t *const entry)
+{
+    u32 pgid = 0;
+
+    for (; cur != NULL; cur = cur->next) {
+        if (cur->user != VTSS_MAC_USER_NONE) {
+            continue;
+        }
+        vtss_mach_macl_set(&entry->vid_mac, cur->mach, cur->macl);
+        if (vtss_mac_get(vtss_state, entry, &pgid) == VTSS_RC_OK) {
+            vtss_mac_pgid_get(vtss_state, entry, pgid);
+            break;
+        }
+    }
+    return cur;
+}
+
+/* Next chip entry after 'entry->vid_mac' */
+static vtss_rc vtss_mac_bulk_chip_next(vtss_state_t *vtss_state,
+                                       vtss_mac_table_entry_t *const entry)
+{
+    u32              pgid = 0, mach, macl;
+    vtss_mac_entry_t *cmp;
+
+    while (vtss_cil_l2_mac_table_get_next(vtss_state, entry, &pgid) == VTSS_RC_OK) {
+        vtss_mach_macl_get(&entry->vid_mac, &mach, &macl);
+        if ((cmp = vtss_mac_entry_get(vtss_state, mach, macl, 0)) != NULL &&
+            cmp->mach == mach && cmp->macl == macl && cmp->user != VTSS_MAC_USER_NONE) {
+            continue;
+        }
+        vtss_mac_pgid_get(vtss_state, entry, pgid);
+        return VTSS_RC_OK;
+    }
+    return VTSS_RC_ERROR;
+}
+
+/* The bulk read keeps one candidate per source (static list, index table and
+   chip), each being the smallest entry of that source greater than the last
+   returned entry. The smallest candidate is returned, and only the sources
+   it was found in are advanced. This gives the same sequence as repeated
+   calls to vtss_mac_get_next(), but the static list is only searched once,
+   and each chip entry is only read once. */
+static vtss_rc vtss_mac_get_next_bulk(vtss_state_t *vtss_state,
+                                      const vtss_vid_mac_t   *const vid_mac,
+                                      const u32              max,
+                                      vtss_mac_table_entry_t *const entries,
+                                      u32                    *const count)
+{
+    vtss_mac_table_entry_t s_entry, c_entry, *entry;
+    vtss_mac_entry_t       *cur;
+    BOOL                   c_valid;
+    u32                    mach, macl, s_mach = 0, s_macl = 0, c_mach = 0, c_macl = 0;
+#if defined(VTSS_FEATURE_MAC_INDEX_TABLE)
+    vtss_mac_table_entry_t i_entry;
+    BOOL                   i_valid;
+    u32                    i_mach = 0, i_macl = 0, pgid = 0;
+#endif
+
+    *count = 0;
+    vtss_mach_macl_get(vid_mac, &mach, &macl);
+
+    // Static candidate
+    VTSS_MEMSET(&s_entry, 0, sizeof(s_entry));
+    if ((cur = vtss_mac_bulk_static_next(vtss_state, vtss_mac_entry_get(vtss_state, mach, macl, 1), &s_entry)) != NULL) {
+        s_mach = cur->mach;
+        s_macl = cur->macl;
+    }
+
+#if defined(VTSS_FEATURE_MAC_INDEX_TABLE)
+    // Index table candidate
+    VTSS_MEMSET(&i_entry, 0, sizeof(i_entry));
+    i_entry.vid_mac = *vid_mac;
+    if ((i_valid = (vtss_mac_index_get(vtss_state, &i_entry, &pgid, 1) == VTSS_RC_OK))) {
+        vtss_mac_pgid_get(vtss_state, &i_entry, pgid);
+        vtss_mach_macl_get(&i_entry.vid_mac, &i_mach, &i_macl);
+    }
+#endif
+
+    // Chip candidate
+    VTSS_MEMSET(&c_entry, 0, sizeof(c_entry));
+    c_entry.vid_mac = *vid_mac;
+    if ((c_valid = (vtss_mac_bulk_chip_next(vtss_state, &c_entry) == VTSS_RC_OK))) {
+        vtss_mach_macl_get(&c_entry.vid_mac, &c_mach, &c_macl);
+    }
+
+    while (*count < max) {
+        // Select the smallest candidate. Static and index entries take
+        // precedence over chip entries with the same key.
+        entry = NULL;
+        if (cur != NULL) {
+            entry = &s_entry;
+            mach = s_mach;
+            macl = s_macl;
+        }
+#if defined(VTSS_FEATURE_MAC_INDEX_TABLE)
+        if (i_valid && (entry == NULL || vtss_mac_key_cmp(i_mach, i_macl, mach, macl) < 0)) {
+            entry = &i_entry;
+            mach = i_mach;
+            macl = i_macl;
+        }
+#endif
+        if (c_valid && (entry == NULL || vtss_mac_key_cmp(c_mach, c_macl, mach, macl) < 0)) {
+            entry = &c_entry;
+            mach = c_mach;
+            macl = c_macl;
+        }
+        if (entry == NULL) {
+            break;
+        }
+        entries[(*count)++] = *entry;
+
+        // Advance the sources holding the returned key
+        if (cur != NULL && vtss_mac_key_cmp(s_mach, s_macl, mach, macl) <= 0) {
+            if ((cur = vtss_mac_bulk_static_next(vtss_state, cur->next, &s_entry)) != NULL) {
+                s_mach = cur->mach;
+                s_macl = cur->macl;
+            }
+        }
+#if defined(VTSS_FEATURE_MAC_INDEX_TABLE)
+        if (i_valid && vtss_mac_key_cmp(i_mach, i_macl, mach, macl) <= 0) {
+            if ((i_valid = (vtss_mac_index_get(vtss_state, &i_entry, &pgid, 1) == VTSS_RC_OK))) {
+                vtss_mac_pgid_get(vtss_state, &i_entry, pgid);
+                vtss_mach_macl_get(&i_entry.vid_mac, &i_mach, &i_macl);
+            }
+        }
+#endif
+        if (c_valid && vtss_mac_key_cmp(c_mach, c_macl, mach, macl) <= 0) {
+            if ((c_valid = (vtss_mac_bulk_chip_next(vtss_state, &c_entry) == VTSS_RC_OK))) {
+                vtss_mach_macl_get(&c_entry.vid_mac, &c_mach, &c_macl);
+            }
+        }
+    }
+
+    VTSS_D("max: %u, count: %u", max, *count);
+    return (*count ? VTSS_RC_OK : VTSS_RC_ERROR);
+}
+
+vtss_rc vtss_mac_table_get_next_bulk(const vtss_inst_t       inst,
+                                     const vtss_vid_mac_t    *const vid_mac,
+                                     const u32               max,
+                                     vtss_mac_table_entry_t  *const entries,
+                                     u32                     *const count)
+{
+    vtss_state_t *vtss_state;
+    vtss_rc      rc;
+
+    VTSS_ENTER();
+    if ((rc = vtss_inst_check(inst, &vtss_state)) == VTSS_RC_OK)
+        rc = vtss_mac_get_next_bulk(vtss_state, vid_mac, max, entries, count);
+    VTSS_EXIT();
+    return rc;
+}
+
 vtss_rc vtss_mac_table_age_time_get(const vtss_inst_t          inst,
                                     vtss_mac_table_age_time_t  *const age_time)
 {
@@ -10,6 +10,7 @@
 #include "vtss_api.h"
 #include "vtss_state.h"
 #include "vtss_os.h"
+#include "vtss_util.h"
 
 // Allow to do bulk opertations for ~20ms
 #define BULK_TIME_MAX 20
@@ -596,6 +597,41 @@ static inline int nh_cmp(const vtss_l3_nh_key_t *a, const vtss_l3_nh_key_t *b)
     return 0;
 }
 
+/* Hash next-hop key. Keys that are equal according to nh_cmp() give the same hash */
+static inline u32 nh_hash(const vtss_l3_nh_key_t *nh)
+{
+    u32 i, hash;
+
+    if (nh->dip.type == VTSS_IP_TYPE_IPV4) {
+        hash = nh->dip.addr.ipv4;
+    } else {
+        hash = nh->vid;
+        for (i = 0; i < 16; i++) {
+            hash = (hash * 31 + nh->dip.addr.ipv6.addr[i]);
+        }
+    }
+
+    /* Mix the bits, so that consecutive addresses spread over the buckets */
+    hash ^= (hash >> 16);
+    hash *= 0x45d9f3b;
+    hash ^= (hash >> 16);
+    return hash;
+}
+
+/* Look for a neighbour */
+static inline vtss_l3_nb_t *nb_lookup(vtss_state_t     *vtss_state,
+                                      vtss_l3_nh_key_t *nh)
+{
+    vtss_l3_nb_t *cur;
+
+    for (cur = vtss_state->l3.nb.hash[nh_hash(nh) % VTSS_L3_HASH_CNT]; cur != NULL; cur = cur->next) {
+        if (nh_cmp(&cur->nh, nh) == 0) {
+            break;
+        }
+    }
+    return cur;
+}
+
 static inline vtss_l3_nh_t *nh_alloc(vtss_state_t *vtss_state,
                                      vtss_l3_nh_t **list,
                                      vtss_l3_nh_t *prev,
@@ -664,6 +700,30 @@ static inline vtss_l3_nh_t *nh_lookup(vtss_state_t *vtss_state,
 
 /* - Next-hop groups ----------------------------------------------- */
 
+/* Hash bucket for a next-hop list */
+static inline u32 nh_grp_hash(vtss_l3_nh_t *list)
+{
+    vtss_l3_nh_t *nh;
+    u32          hash = 0;
+
+    for (nh = list; nh != NULL; nh = nh->next) {
+        hash = (hash * 31 + nh_hash(&nh->nh));
+    }
+    return (hash % VTSS_L3_HASH_CNT);
+}
+
+/* Attach next-hop list to group and add group to hash table */
+static inline void nh_grp_list_set(vtss_state_t     *vtss_state,
+                                   vtss_l3_nh_grp_t *grp,
+                                   vtss_l3_nh_t     *list)
+{
+    vtss_l3_nh_grp_t **bucket = &vtss_state->l3.nh_grp.hash[nh_grp_hash(list)];
+
+    grp->list = list;
+    grp->hash_next = *bucket;
+    *bucket = grp;
+}
+
 static inline vtss_l3_nh_grp_t *nh_grp_alloc(vtss_state_t *vtss_state, u8 cnt)
 {
     vtss_l3_nh_grp_info_t *info = &vtss_state->l3.nh_grp;
@@ -698,10 +758,22 @@ static inline void nh_grp_free(vtss_state_t *vtss_state, vtss_l3_nh_grp_t *grp)
     } else {
         grp->count--;
         if (grp->count == 0) {
+            /* Remove group from hash table */
+            for (prev = NULL, cur = info->hash[nh_grp_hash(grp->list)]; cur != NULL; prev = cur, cur = cur->hash_next) {
+                if (cur == grp) {
+                    if (prev == NULL) {
+                        info->hash[nh_grp_hash(grp->list)] = cur->hash_next;
+                    } else {
+                        prev->hash_next = cur->hash_next;
+                    }
+                    break;
+                }
+            }
+
             /* Free next-hop list and move group to free list */
             nh_free(vtss_state, grp->list);
             (void)arp_free(vtss_state, grp->idx);
-            for (cur = info->list; cur != NULL; prev = cur, cur = cur->next) {
+            for (prev = NULL, cur = info->list; cur != NULL; prev = cur, cur = cur->next) {
                 if (cur == grp) {
                     break;
                 }
@@ -726,29 +798,16 @@ static inline vtss_rc nh_grp_update(vtss_state_t     *vtss_state,
                                     vtss_l3_nh_grp_t *grp)
 {
     vtss_l3_nh_t *nh;
-    vtss_l3_nb_t *nb, nb_zero, *nb_up;
+    vtss_l3_nb_t *nb, nb_zero;
     u32          idx = grp->idx;
-    int          cmp;
 
     VTSS_MEMSET(&nb_zero, 0, sizeof(nb_zero));
-    for (nh = grp->list, nb = vtss_state->l3.nb.list; nh != NULL; ) {
-        cmp = (nb == NULL ? -1 : nh_cmp(&nh->nh, &nb->nh));
-        if (cmp > 0) {
-            /* Next-hop is bigger, take next neighbour */
-            nb = nb->next;
-        } else {
-            if (cmp == 0) {
-                /* Next-hop is equal, update and take next neighbour*/
-                nb_up = nb;
-                nb = nb->next;
-            } else {
-                /* Next-hop is smaller, update with zero DMAC */
-                nb_up = &nb_zero;
-            }
-            VTSS_RC(nh_update(vtss_state, idx, nb_up));
-            idx++;
-            nh = nh->next;
+    for (nh = grp->list; nh != NULL; nh = nh->next, idx++) {
+        if ((nb = nb_lookup(vtss_state, &nh->nh)) == NULL) {
+            /* No neighbour, update with zero DMAC */
+            nb = &nb_zero;
         }
+        VTSS_RC(nh_update(vtss_state, idx, nb));
     }
     return VTSS_RC_OK;
 }
@@ -761,7 +820,7 @@ static inline vtss_l3_nh_grp_t *nh_grp_lookup(vtss_state_t *vtss_state,
     vtss_l3_nh_t     *a, *b;
     int              cmp;
 
-    for (grp = vtss_state->l3.nh_grp.list; grp != NULL; grp = grp->next) {
+    for (grp = vtss_state->l3.nh_grp.hash[nh_grp_hash(list)]; grp != NULL; grp = grp->hash_next) {
         if (grp->list == list) {
             continue;
         }
@@ -795,6 +854,202 @@ static inline int net_cmp(const vtss_l3_net_t *a, const vtss_l3_net_t *b)
     return ip_addr_cmp(&a->network, &b->network);
 }
 
+/* The networks are kept in a list sorted with the biggest network first.
+   The list order determines the LPM VCAP order, so it must be kept as is.
+   To avoid linear searches, the networks are also indexed by an AVL tree
+   sorted with the smallest network first. */
+
+static inline u8 net_height(const vtss_l3_net_t *net)
+{
+    return (net == NULL ? 0 : net->height);
+}
+
+static inline void net_height_update(vtss_l3_net_t *net)
+{
+    net->height = (MAX(net_height(net->left), net_height(net->right)) + 1);
+}
+
+static inline vtss_l3_net_t *net_rotate_left(vtss_l3_net_t *net)
+{
+    vtss_l3_net_t *right = net->right;
+
+    net->right = right->left;
+    right->left = net;
+    net_height_update(net);
+    net_height_update(right);
+    return right;
+}
+
+static inline vtss_l3_net_t *net_rotate_right(vtss_l3_net_t *net)
+{
+    vtss_l3_net_t *left = net->left;
+
+    net->left = left->right;
+    left->right = net;
+    net_height_update(net);
+    net_height_update(left);
+    return left;
+}
+
+/* Update height and rebalance sub-tree, returning the new sub-tree root */
+static vtss_l3_net_t *net_balance(vtss_l3_net_t *net)
+{
+    int bal = (net_height(net->left) - net_height(net->right));
+
+    if (bal > 1) {
+        if (net_height(net->left->left) < net_height(net->left->right)) {
+            net->left = net_rotate_left(net->left);
+        }
+        return net_rotate_right(net);
+    }
+    if (bal < -1) {
+        if (net_height(net->right->right) < net_height(net->right->left)) {
+            net->right = net_rotate_right(net->right);
+        }
+        return net_rotate_left(net);
+    }
+    net_height_update(net);
+    return net;
+}
+
+static vtss_l3_net_t *net_tree_add(vtss_l3_net_t *root, vtss_l3_net_t *net)
+{
+    if (root == NULL) {
+        net->left = NULL;
+        net->right = NULL;
+        net->height = 1;
+        return net;
+    }
+    if (net_cmp(net, root) < 0) {
+        root->left = net_tree_add(root->left, net);
+    } else {
+        root->right = net_tree_add(root->right, net);
+    }
+    return net_balance(root);
+}
+
+static vtss_l3_net_t *net_tree_del_min(vtss_l3_net_t *root, vtss_l3_net_t **min)
+{
+    if (root->left == NULL) {
+        *min = root;
+        return root->right;
+    }
+    root->left = net_tree_del_min(root->left, min);
+    return net_balance(root);
+}
+
+static vtss_l3_net_t *net_tree_del(vtss_l3_net_t *root, vtss_l3_net_t *net)
+{
+    vtss_l3_net_t *min, *right;
+    int           cmp;
+
+    if (root == NULL) {
+        E("network not in index");
+        return NULL;
+    }
+    if ((cmp = net_cmp(net, root)) < 0) {
+        root->left = net_tree_del(root->left, net);
+    } else if (cmp > 0) {
+        root->right = net_tree_del(root->right, net);
+    } else {
+        /* Replace by smallest entry in right sub-tree */
+        if (root->right == NULL) {
+            return root->left;
+        }
+        right = net_tree_del_min(root->right, &min);
+        min->left = root->left;
+        min->right = right;
+        root = min;
+    }
+    return net_balance(root);
+}
+
+/* Look for a network. The previous list entry is returned in 'prev', also if
+   the network is not found. This is the place to insert a new network */
+static inline vtss_l3_net_t *net_lookup(vtss_state_t        *vtss_state,
+                                        const vtss_l3_net_t *net,
+                                        vtss_l3_net_t       **prev)
+{
+    vtss_l3_net_t *cur = vtss_state->l3.net.root;
+    int           cmp;
+
+    *prev = NULL;
+    while (cur != NULL) {
+        if ((cmp = net_cmp(net, cur)) == 0) {
+            /* Found, the previous entry is the smallest bigger network. This is
+               either the smallest network in the right sub-tree or the last
+               entry where the search went left */
+            if (cur->right != NULL) {
+                *prev = cur->right;
+                while ((*prev)->left != NULL) {
+                    *prev = (*prev)->left;
+                }
+            }
+            return cur;
+        }
+        if (cmp < 0) {
+            *prev = cur;
+            cur = cur->left;
+        } else {
+            cur = cur->right;
+        }
+    }
+    return NULL;
+}
+
+/* Add network to next-hop hash table */
+static inline void net_nh_add(vtss_state_t *vtss_state, vtss_l3_net_t *net)
+{
+    vtss_l3_net_t **bucket = &vtss_state->l3.net.nh_hash[nh_hash(&net->nh) % VTSS_L3_HASH_CNT];
+
+    net->nh_next = *bucket;
+    *bucket = net;
+}
+
+/* Delete network from next-hop hash table */
+static inline void net_nh_del(vtss_state_t *vtss_state, vtss_l3_net_t *net)
+{
+    vtss_l3_net_t **cur = &vtss_state->l3.net.nh_hash[nh_hash(&net->nh) % VTSS_L3_HASH_CNT];
+
+    for (; *cur != NULL; cur = &(*cur)->nh_next) {
+        if (*cur == net) {
+            *cur = net->nh_next;
+            return;
+        }
+    }
+    E("network not in next-hop hash");
+}
+
+/* Sort next-hop hash bucket in list order, biggest network first */
+static vtss_l3_net_t *net_nh_sort(vtss_l3_net_t *list)
+{
+    vtss_l3_net_t *a, *b, *slow, *fast, *head = NULL, **tail = &head;
+
+    if (list == NULL || list->nh_next == NULL) {
+        return list;
+    }
+
+    /* Split list in two halves, sort and merge them */
+    for (slow = list, fast = list->nh_next; fast != NULL && fast->nh_next != NULL; fast = fast->nh_next->nh_next) {
+        slow = slow->nh_next;
+    }
+    b = net_nh_sort(slow->nh_next);
+    slow->nh_next = NULL;
+    a = net_nh_sort(list);
+    while (a != NULL && b != NULL) {
+        if (net_cmp(a, b) > 0) {
+            *tail = a;
+            a = a->nh_next;
+        } else {
+            *tail = b;
+            b = b->nh_next;
+        }
+        tail = &(*tail)->nh_next;
+    }
+    *tail = (a == NULL ? b : a);
+    return head;
+}
+
 /* Compare network and return (a > b ? 1 : (a < b ? -1) : 0) */
 static inline int mc_rt_cmp(const vtss_l3_mc_rt_t *a, const vtss_l3_mc_rt_t *b)
 {
@@ -917,19 +1172,6 @@ static inline vtss_rc rt_grp_move(vtss_state_t *vtss_state, u16 idx_old, u16 idx
     return VTSS_RC_OK;
 }
 
-static inline vtss_l3_nb_t *nb_lookup(vtss_state_t     *vtss_state,
-                                      vtss_l3_nh_key_t *nh)
-{
-    vtss_l3_nb_t *cur;
-
-    for (cur = vtss_state->l3.nb.list; cur != NULL; cur = cur->next) {
-        if (nh_cmp(&cur->nh, nh) == 0) {
-            break;
-        }
-    }
-    return cur;
-}
-
 static inline void route2net(const vtss_routing_entry_t *route,
                              vtss_l3_net_t *net)
 {
@@ -1276,7 +1518,7 @@ static inline vtss_rc rt_add(vtss_state_t               *vtss_state,
 {
     vtss_l3_net_info_t *info = &vtss_state->l3.net;
     vtss_vcap_obj_t    *obj = &vtss_state->vcap.lpm.obj;
-    vtss_l3_net_t      *cur, *prev = NULL, net_new;
+    vtss_l3_net_t      *cur, *prev, net_new;
     vtss_l3_nh_grp_t   *grp;
     vtss_l3_nh_t       nh_new, nh_old, *list, *nh, *prev_nh = NULL;
     int                cmp = 1;
@@ -1284,13 +1526,7 @@ static inline vtss_rc rt_add(vtss_state_t               *vtss_state,
 
     /* Search for an existing network or a place to insert new network */
     route2net(route, &net_new);
-    for (cur = info->list; cur != NULL; prev = cur, cur = cur->next) {
-        if ((cmp = net_cmp(&net_new, cur)) >= 0) {
-            break;
-        }
-    }
-
-    if (cmp != 0) {
+    if ((cur = net_lookup(vtss_state, &net_new, &prev)) == NULL) {
         /* Add new network */
         if (vtss_state->l3.common.routing_enable &&
             obj->count == obj->max_count) {
@@ -1316,6 +1552,8 @@ static inline vtss_rc rt_add(vtss_state_t               *vtss_state,
             cur->next = prev->next;
             prev->next = cur;
         }
+        info->root = net_tree_add(info->root, cur);
+        net_nh_add(vtss_state, cur);
         return rt_update(vtss_state, cur, nb_lookup(vtss_state, &cur->nh), 0);
     }
 
@@ -1349,7 +1587,7 @@ static inline vtss_rc rt_add(vtss_state_t               *vtss_state,
             for (nh = list, list = NULL; nh != NULL; nh = nh->next) {
                 prev_nh = nh_alloc(vtss_state, &list, prev_nh, nh);
             }
-            grp->list = list;
+            nh_grp_list_set(vtss_state, grp, list);
             VTSS_RC(nh_grp_update(vtss_state, grp));
         }
         grp->count++;
@@ -1405,7 +1643,7 @@ static inline vtss_rc rt_add(vtss_state_t               *vtss_state,
             }
         }
         (void) nh_alloc(vtss_state, &list, prev_nh, &nh_new);
-        grp->list = list;
+        nh_grp_list_set(vtss_state, grp, list);
         VTSS_RC(nh_grp_update(vtss_state, grp));
     }
 
@@ -1420,20 +1658,14 @@ static inline vtss_rc rt_del(vtss_state_t               *vtss_state,
                              const vtss_routing_entry_t *const route)
 {
     vtss_l3_net_info_t *info = &vtss_state->l3.net;
-    vtss_l3_net_t      *cur, *prev = NULL, net_old;
+    vtss_l3_net_t      *cur, *prev, net_old;
     vtss_l3_nh_grp_t   *grp;
     vtss_l3_nh_t       *nh, *prev_nh = NULL, *list;
     u8                 cnt;
 
     /* Search for network */
     route2net(route, &net_old);
-    for (cur = info->list; cur != NULL; prev = cur, cur = cur->next) {
-        if (net_cmp(&net_old, cur) == 0) {
-            break;
-        }
-    }
-
-    if (cur == NULL) {
+    if ((cur = net_lookup(vtss_state, &net_old, &prev)) == NULL) {
         I("network not found");
         return VTSS_RC_ERROR;
     }
@@ -1445,6 +1677,8 @@ static inline vtss_rc rt_del(vtss_state_t               *vtss_state,
         } else {
             prev->next = cur->next;
         }
+        info->root = net_tree_del(info->root, cur);
+        net_nh_del(vtss_state, cur);
         cur->next = info->free;
         info->free = cur;
         info->free_cnt++;
@@ -1469,7 +1703,9 @@ static inline vtss_rc rt_del(vtss_state_t               *vtss_state,
 
     if (cnt < 3) {
         /* Route has two next-hops and returns to single next-hop */
+        net_nh_del(vtss_state, cur);
         cur->nh = (nh->next == NULL ? list->nh : nh->next->nh);
+        net_nh_add(vtss_state, cur);
         I("single next-hop, free idx: %u", cur->grp->idx);
         nh_grp_free(vtss_state, cur->grp);
         cur->grp = NULL;
@@ -1501,7 +1737,7 @@ static inline vtss_rc rt_del(vtss_state_t               *vtss_state,
                 prev_nh = nh_alloc(vtss_state, &list, prev_nh, nh);
             }
         }
-        grp->list = list;
+        nh_grp_list_set(vtss_state, grp, list);
         VTSS_RC(nh_grp_update(vtss_state, grp));
     }
 
@@ -1526,14 +1762,17 @@ static inline vtss_rc nb_update(vtss_state_t *vtss_state,
                                 vtss_l3_nb_t *nb)
 {
     vtss_l3_state_t  *l3 = &vtss_state->l3;
-    vtss_l3_net_t    *net;
+    vtss_l3_net_t    *net, **bucket;
     vtss_l3_nh_grp_t *grp;
     vtss_l3_nh_t     *nh;
     vtss_rc          rc;
     u32              idx;
 
-    /* Search for single next-hop addresses to update */
-    for (net = l3->net.list; net != NULL; net = net->next) {
+    /* Search for single next-hop addresses to update. The hash bucket is
+       sorted first to update the networks in list order */
+    bucket = &l3->net.nh_hash[nh_hash(&nb->nh) % VTSS_L3_HASH_CNT];
+    *bucket = net_nh_sort(*bucket);
+    for (net = *bucket; net != NULL; net = net->nh_next) {
         if (net->grp == NULL &&
             nh_cmp(&net->nh, &nb->nh) == 0 &&
             (rc = rt_update(vtss_state, net, nb, 0)) != VTSS_RC_OK) {
@@ -1557,22 +1796,15 @@ static inline vtss_rc nb_add(vtss_state_t              *vtss_state,
                              const vtss_l3_neighbour_t *const nb)
 {
     vtss_l3_nb_info_t *info = &vtss_state->l3.nb;
-    vtss_l3_nb_t      *cur, *prev = NULL;
+    vtss_l3_nb_t      *cur, **bucket;
     vtss_l3_rleg_id_t rleg = 0;
     vtss_l3_nh_key_t  nh;
-    int               cmp = 1;
 
     VTSS_RC(rleg_id_get(vtss_state, vtss_state->l3.rleg_conf, nb->vlan, &rleg, NULL));
 
-    /* Search for an existing entry or a place to insert new entry */
+    /* Search for an existing entry */
     nb2nh(nb, &nh);
-    for (cur = info->list; cur != NULL; prev = cur, cur = cur->next) {
-        if ((cmp = nh_cmp(&cur->nh, &nh)) >= 0) {
-            break;
-        }
-    }
-
-    if (cmp != 0) {
+    if ((cur = nb_lookup(vtss_state, &nh)) == NULL) {
         /* Add new entry */
         if ((cur = info->free) == NULL) {
             /* Allocation failed */
@@ -1581,15 +1813,9 @@ static inline vtss_rc nb_add(vtss_state_t              *vtss_state,
         } else {
             info->free_cnt--;
             info->free = cur->next;
-            if (prev == NULL) {
-                /* Insert first */
-                cur->next = info->list;
-                info->list = cur;
-            } else {
-                /* Insert after previous entry */
-                cur->next = prev->next;
-                prev->next = cur;
-            }
+            bucket = &info->hash[nh_hash(&nh) % VTSS_L3_HASH_CNT];
+            cur->next = *bucket;
+            *bucket = cur;
         }
     }
 
@@ -1606,10 +1832,12 @@ static inline vtss_rc nb_del(vtss_state_t              *vtss_state,
     vtss_l3_nb_info_t *info = &vtss_state->l3.nb;
     vtss_l3_nb_t      *cur, *prev = NULL;
     vtss_l3_nh_key_t  nh;
+    u32               hash;
 
     /* Search for entry */
     nb2nh(nb, &nh);
-    for (cur = info->list; cur != NULL; prev = cur, cur = cur->next) {
+    hash = (nh_hash(&nh) % VTSS_L3_HASH_CNT);
+    for (cur = info->hash[hash]; cur != NULL; prev = cur, cur = cur->next) {
         if (nh_cmp(&cur->nh, &nh) == 0) {
             break;
         }
@@ -1621,7 +1849,7 @@ static inline vtss_rc nb_del(vtss_state_t              *vtss_state,
     }
 
     if (prev == NULL) {
-        info->list = cur->next;
+        info->hash[hash] = cur->next;
     } else {
         prev->next = cur->next;
     }
@@ -2380,26 +2608,33 @@ void vtss_debug_print_l3(vtss_state_t *vtss_state,
     pr("Neighbours:\n");
     pr("===========\n");
     pr("Free entries: %u\n", l3->nb.free_cnt);
-    type = VTSS_IP_TYPE_NONE;
-    for (nb = l3->nb.list; nb != NULL; nb = nb->next) {
-        if (nb->nh.dip.type != type) {
-            type = nb->nh.dip.type;
-            pr("\n");
-            if (type == VTSS_IP_TYPE_IPV4) {
-                pr("%-17sDMAC", "DIP");
-            } else {
-                pr("%-41s%-19sVID", "DIP", "DMAC");
+    for (type = VTSS_IP_TYPE_IPV4; type <= VTSS_IP_TYPE_IPV6; type++) {
+        /* Neighbours are hashed, show IPv4 entries first */
+        for (i = 0, cnt = 0; i < VTSS_L3_HASH_CNT; i++) {
+            for (nb = l3->nb.hash[i]; nb != NULL; nb = nb->next) {
+                if (nb->nh.dip.type != type) {
+                    continue;
+                }
+                if (cnt++ == 0) {
+                    pr("\n");
+                    if (type == VTSS_IP_TYPE_IPV4) {
+                        pr("%-17sDMAC", "DIP");
+                    } else {
+                        pr("%-41s%-19sVID", "DIP", "DMAC");
+                    }
+                    pr("\n");
+                }
+                if (type == VTSS_IP_TYPE_IPV4) {
+                    VTSS_SPRINTF(buf, IPV4_FORMAT, IPV4_ARGS(nb->nh.dip.addr.ipv4));
+                    pr("%-17s" MAC_FORMAT "\n", buf, MAC_ARGS(nb->dmac));
+                } else {
+                    pr(IPV6_FORMAT "  " MAC_FORMAT "  %u\n",
+                       IPV6_ARGS(nb->nh.dip.addr.ipv6), MAC_ARGS(nb->dmac), nb->nh.vid);
+                }
             }
-            pr("\n");
-        }
-        if (type == VTSS_IP_TYPE_IPV4) {
-            VTSS_SPRINTF(buf, IPV4_FORMAT, IPV4_ARGS(nb->nh.dip.addr.ipv4));
-            pr("%-17s" MAC_FORMAT "\n", buf, MAC_ARGS(nb->dmac));
-        } else {
-            pr(IPV6_FORMAT "  " MAC_FORMAT "  %u\n",
-               IPV6_ARGS(nb->nh.dip.addr.ipv6), MAC_ARGS(nb->dmac), nb->nh.vid);
         }
     }
+    cnt = 0;
     pr("\n");
 
     pr("ARP Table:\n");
@@ -39,18 +39,23 @@ typedef struct vtss_l3_nh_t {
 
 /* Next-hop group entry */
 typedef struct vtss_l3_nh_grp_t {
-    struct vtss_l3_nh_grp_t *next; /* Next entry */
-    vtss_l3_nh_t            *list; /* Next-hop list */
-    u32                     count; /* Reference count */
-    u16                     idx;   /* ARP base index */
+    struct vtss_l3_nh_grp_t *next;      /* Next entry */
+    struct vtss_l3_nh_grp_t *hash_next; /* Next entry in hash bucket */
+    vtss_l3_nh_t            *list;      /* Next-hop list */
+    u32                     count;      /* Reference count */
+    u16                     idx;        /* ARP base index */
 } vtss_l3_nh_grp_t;
 
 /* UC Network entry */
 typedef struct vtss_l3_net_t {
     struct vtss_l3_net_t *next;       /* Next entry */
+    struct vtss_l3_net_t *left;       /* Index tree, smaller networks */
+    struct vtss_l3_net_t *right;      /* Index tree, bigger networks */
+    struct vtss_l3_net_t *nh_next;    /* Next entry in next-hop hash bucket */
     vtss_l3_nh_grp_t     *grp;        /* Next-hop group */
     vtss_ip_addr_t       network;     /* Network address */
     vtss_prefix_size_t   prefix_size; /* Prefix size */
+    u8                   height;      /* Index tree, height of sub-tree */
     vtss_l3_nh_key_t     nh;          /* Next-hop, if single */
     u64                  id;          /* VCAP ID */
 } vtss_l3_net_t;
@@ -73,6 +78,7 @@ typedef struct vtss_l3_mc_rt_t {
 #define VTSS_L3_NET_CNT    VTSS_LPM_CNT
 #define VTSS_L3_NB_CNT     VTSS_LPM_CNT             /* Neighbours may be encoded directly in LPM table */
 #define VTSS_L3_MC_RT_CNT  VTSS_LPM_MC_CNT
+#define VTSS_L3_HASH_CNT   ((VTSS_LPM_CNT / 4) + 1) /* Hash buckets for next-hop keys and groups */
 
 #define VTSS_L3_MC_RPF_DIS 0xFF   /* ID for disabled RPF  */
 
@@ -93,6 +99,7 @@ typedef struct {
 /* Next-hop group information */
 typedef struct {
     vtss_l3_nh_grp_t *list;                     /* Actual list */
+    vtss_l3_nh_grp_t *hash[VTSS_L3_HASH_CNT];   /* Groups hashed on next-hop list */
     vtss_l3_nh_grp_t *free;                     /* Free list */
     u32              free_cnt;                  /* Free count */
     vtss_l3_nh_grp_t table[VTSS_L3_NH_GRP_CNT]; /* Table */
@@ -101,6 +108,8 @@ typedef struct {
 /* Network information */
 typedef struct {
     vtss_l3_net_t *list;                  /* Actual list */
+    vtss_l3_net_t *root;                  /* Index tree, AVL balanced */
+    vtss_l3_net_t *nh_hash[VTSS_L3_HASH_CNT]; /* Networks hashed on next-hop */
     vtss_l3_net_t *free;                  /* Free list */
     u32           free_cnt;               /* Free count */
     vtss_l3_net_t table[VTSS_L3_NET_CNT]; /* Table */
@@ -109,7 +118,7 @@ typedef struct {
 
 /* Neighbour information */
 typedef struct {
-    vtss_l3_nb_t *list;                 /* Actual list */
+    vtss_l3_nb_t *hash[VTSS_L3_HASH_CNT]; /* Neighbours hashed on next-hop */
     vtss_l3_nb_t *free;                 /* Free list */
     u32          free_cnt;              /* Free count */
     vtss_l3_nb_t table[VTSS_L3_NB_CNT]; /* Table */
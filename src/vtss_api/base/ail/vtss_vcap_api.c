@@ -408,6 +408,96 @@ static void vtss_vcap_pos_get(vtss_vcap_obj_t *obj, vtss_vcap_idx_t *idx, u32 nd
     }
 }
 
+/* TCAM updates are skipped in warm start mode and deferred during transactions */
+static BOOL vtss_vcap_hw_skip(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj)
+{
+#if defined(VTSS_FEATURE_VCAP_TXN)
+    if (obj->txn) {
+        return TRUE;
+    }
+#endif /* VTSS_FEATURE_VCAP_TXN */
+    return vtss_state->warm_start_cur;
+}
+
+#if defined(VTSS_FEATURE_VCAP_TXN)
+/* Size of entry copy, zero if copies are not supported */
+static u32 vtss_vcap_copy_size(vtss_vcap_obj_t *obj)
+{
+    switch (obj->type) {
+#if defined(VTSS_FEATURE_IS0)
+    case VTSS_VCAP_TYPE_IS0:
+        return sizeof(vtss_is0_entry_t);
+#endif /* VTSS_FEATURE_IS0 */
+#if defined(VTSS_FEATURE_IS1)
+    case VTSS_VCAP_TYPE_IS1:
+        return sizeof(vtss_is1_entry_t);
+#endif /* VTSS_FEATURE_IS1 */
+#if defined(VTSS_FEATURE_IS2)
+    case VTSS_VCAP_TYPE_IS2:
+        return sizeof(vtss_is2_entry_t);
+#endif /* VTSS_FEATURE_IS2 */
+#if defined(VTSS_FEATURE_ES0)
+    case VTSS_VCAP_TYPE_ES0:
+        return sizeof(vtss_es0_entry_t);
+#endif /* VTSS_FEATURE_ES0 */
+    default:
+        return 0;
+    }
+}
+
+/* Free list used by VCAP */
+static vtss_vcap_entry_t **vtss_vcap_free_list(vtss_vcap_obj_t *obj)
+{
+#if defined(VTSS_FEATURE_VCAP_SUPER)
+    if (obj->vcap_super != NULL) {
+        return &obj->vcap_super->free;
+    }
+#endif /* VTSS_FEATURE_VCAP_SUPER */
+    return &obj->free;
+}
+
+/* Ensure that the rule written by an add operation has storage for an entry copy */
+static vtss_rc vtss_vcap_txn_copy_alloc(vtss_vcap_obj_t *obj, vtss_vcap_entry_t *old)
+{
+    /* An existing rule is reused, otherwise the first free rule is used */
+    vtss_vcap_entry_t *cur = (old == NULL ? *vtss_vcap_free_list(obj) : old);
+
+    if (cur == NULL || cur->copy != NULL) {
+        return VTSS_RC_OK;
+    }
+    if ((cur->copy = VTSS_OS_MALLOC(vtss_vcap_copy_size(obj), VTSS_MEM_FLAGS_NONE)) == NULL) {
+        VTSS_I("VCAP %s: copy allocation failed", obj->name);
+        return VTSS_RC_ERROR;
+    }
+    cur->txn_flags |= VTSS_VCAP_TXN_FLAG_COPY;
+    return VTSS_RC_OK;
+}
+
+/* Point entry data to the saved copy, the entry of the caller is only valid during the add operation */
+static void vtss_vcap_txn_copy_use(vtss_vcap_obj_t *obj, vtss_vcap_entry_t *cur)
+{
+    vtss_vcap_data_t *data = &cur->data;
+
+    if (obj->type == VTSS_VCAP_TYPE_IS0) {
+#if defined(VTSS_FEATURE_IS0)
+        data->u.is0.entry = (vtss_is0_entry_t *)cur->copy;
+#endif /* VTSS_FEATURE_IS0 */
+    } else if (obj->type == VTSS_VCAP_TYPE_IS1) {
+#if defined(VTSS_FEATURE_IS1)
+        data->u.is1.entry = (vtss_is1_entry_t *)cur->copy;
+#endif /* VTSS_FEATURE_IS1 */
+    } else if (obj->type == VTSS_VCAP_TYPE_IS2) {
+#if defined(VTSS_FEATURE_IS2)
+        data->u.is2.entry = (vtss_is2_entry_t *)cur->copy;
+#endif /* VTSS_FEATURE_IS2 */
+    } else if (obj->type == VTSS_VCAP_TYPE_ES0) {
+#if defined(VTSS_FEATURE_ES0)
+        data->u.es0.entry = (vtss_es0_entry_t *)cur->copy;
+#endif /* VTSS_FEATURE_ES0 */
+    }
+}
+#endif /* VTSS_FEATURE_VCAP_TXN */
+
 char *vtss_vcap_id_txt(vtss_state_t *vtss_state, vtss_vcap_id_t id)
 {
     u32  high = ((id >> 32) & 0xffffffff);
@@ -431,6 +521,14 @@ vtss_rc vtss_vcap_lookup(vtss_state_t *vtss_state,
 
     VTSS_D("VCAP %s, id: %s", obj->name, vtss_vcap_id_txt(vtss_state, id));
 
+#if defined(VTSS_FEATURE_VCAP_TXN)
+    if (idx != NULL && obj->txn) {
+        /* The TCAM position is only valid when the pending updates have been written */
+        VTSS_RC(vtss_vcap_txn_commit(vtss_state, obj));
+        VTSS_RC(vtss_vcap_txn_begin(vtss_state, obj));
+    }
+#endif /* VTSS_FEATURE_VCAP_TXN */
+
     VTSS_MEMSET(ndx, 0, sizeof(ndx));
 
     for (cur = obj->used; cur != NULL; cur = cur->next) {
@@ -504,17 +602,13 @@ static vtss_rc vtss_vcap_super_add(vtss_state_t *vtss_state, vtss_vcap_obj_t *ob
     return VTSS_RC_OK;
 }
 
-static vtss_rc vtss_vcap_super_del(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj)
+/* Free the last super block used by VCAP */
+static vtss_rc vtss_vcap_super_free(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj)
 {
     vtss_vcap_super_obj_t *vcap_super = obj->vcap_super;
     vtss_vcap_type_t      type;
     u32                   i, found = 0;
 
-    if (vcap_super == NULL || (obj->count % vcap_super->row_count) != 0) {
-        VTSS_I("nothing to free for %s", obj->name);
-        return VTSS_RC_OK;
-    }
-
     VTSS_I("free %s, count: %u", obj->name, obj->count);
 
     /* Look for blocks to move */
@@ -550,6 +644,17 @@ static vtss_rc vtss_vcap_super_del(vtss_state_t *vtss_state, vtss_vcap_obj_t *ob
     }
     return VTSS_RC_OK;
 }
+
+static vtss_rc vtss_vcap_super_del(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj)
+{
+    vtss_vcap_super_obj_t *vcap_super = obj->vcap_super;
+
+    if (vcap_super == NULL || (obj->count % vcap_super->row_count) != 0) {
+        VTSS_I("nothing to free for %s", obj->name);
+        return VTSS_RC_OK;
+    }
+    return vtss_vcap_super_free(vtss_state, obj);
+}
 #endif /* VTSS_FEATURE_VCAP_SUPER */
 
 /* Delete rule found in list */
@@ -586,8 +691,8 @@ static vtss_rc vtss_vcap_del_rule(vtss_state_t *vtss_state,
     idx.key_size = key_size;
     obj->key_count[key_size]--;
     cnt = obj->key_count[key_size];
-    if (!vtss_state->warm_start_cur) {
-        /* Avoid VCAP update in warm start mode */
+    if (!vtss_vcap_hw_skip(vtss_state, obj)) {
+        /* Avoid VCAP update in warm start mode and during transactions */
         if (ndx == cnt) {
             /* Last rule in block, just delete */
             vtss_vcap_pos_get(obj, &idx, ndx);
@@ -608,13 +713,19 @@ static vtss_rc vtss_vcap_del_rule(vtss_state_t *vtss_state,
 
     /* Delete and contract by moving rows up */
     obj->count--;
-    if (!vtss_state->warm_start_cur && idx.row != obj->count) {
+    if (!vtss_vcap_hw_skip(vtss_state, obj) && idx.row != obj->count) {
         cnt = (obj->count - idx.row);
         idx.key_size = VTSS_VCAP_KEY_SIZE_FULL;
         idx.row++;
         VTSS_RC(obj->entry_move(vtss_state, &idx, cnt, 1));
     }
 #if defined(VTSS_FEATURE_VCAP_SUPER)
+#if defined(VTSS_FEATURE_VCAP_TXN)
+    if (obj->txn) {
+        /* Super blocks are freed when the transaction is committed */
+        return VTSS_RC_OK;
+    }
+#endif /* VTSS_FEATURE_VCAP_TXN */
     VTSS_RC(vtss_vcap_super_del(vtss_state, obj));
 #endif /* VTSS_FEATURE_VCAP_SUPER */
     return VTSS_RC_OK;
@@ -754,6 +865,13 @@ vtss_rc vtss_vcap_add(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, int user,
     if (data == NULL || dont_add)
         return VTSS_RC_OK;
 
+#if defined(VTSS_FEATURE_VCAP_TXN)
+    if (obj->txn && vtss_vcap_txn_copy_alloc(obj, old) != VTSS_RC_OK) {
+        /* Out of memory, write pending updates and continue with direct update */
+        VTSS_RC(vtss_vcap_txn_commit(vtss_state, obj));
+    }
+#endif /* VTSS_FEATURE_VCAP_TXN */
+
     /* Read counter */
     if (old == NULL) {
         key_size = key_size_new; /* Just to please Lint */
@@ -762,8 +880,8 @@ vtss_rc vtss_vcap_add(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, int user,
         ndx_old = ndx_old_key[key_size];
         idx.key_size = key_size;
         vtss_vcap_pos_get(obj, &idx, ndx_old);
-        if (!vtss_state->warm_start_cur) {
-            /* No need to read counter in warm start mode */
+        if (!vtss_vcap_hw_skip(vtss_state, obj)) {
+            /* No need to read counter in warm start mode, transactions read it when committing */
             VTSS_RC(obj->entry_get(vtss_state, &idx, &cnt, 0));
         }
     }
@@ -813,6 +931,12 @@ vtss_rc vtss_vcap_add(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, int user,
         }
         cur->user = user;
         cur->id = id;
+#if defined(VTSS_FEATURE_VCAP_TXN)
+        if (cur != old) {
+            /* Reused rule, the TCAM position of a deleted rule is not valid */
+            cur->txn_flags &= ~VTSS_VCAP_TXN_FLAG_OLD;
+        }
+#endif /* VTSS_FEATURE_VCAP_TXN */
 
         /* Get position of the entry after the last entry in block */
         key_size = key_size_new;
@@ -823,7 +947,7 @@ vtss_rc vtss_vcap_add(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, int user,
 #if defined(VTSS_FEATURE_VCAP_SUPER)
             VTSS_RC(vtss_vcap_super_add(vtss_state, obj));
 #endif /* VTSS_FEATURE_VCAP_SUPER */
-            if (!vtss_state->warm_start_cur && idx.row < obj->count) {
+            if (!vtss_vcap_hw_skip(vtss_state, obj) && idx.row < obj->count) {
                 /* Move rows down */
                 idx.key_size = VTSS_VCAP_KEY_SIZE_FULL;
                 VTSS_RC(obj->entry_move(vtss_state, &idx, obj->count - idx.row, 0));
@@ -832,7 +956,7 @@ vtss_rc vtss_vcap_add(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, int user,
         }
 
         /* Move rules down */
-        if (!vtss_state->warm_start_cur && key_size != VTSS_VCAP_KEY_SIZE_FULL &&
+        if (!vtss_vcap_hw_skip(vtss_state, obj) && key_size != VTSS_VCAP_KEY_SIZE_FULL &&
             obj->key_count[key_size] > ndx_ins) {
             idx.key_size = key_size;
             vtss_vcap_pos_get(obj, &idx, ndx_ins);
@@ -884,6 +1008,13 @@ vtss_rc vtss_vcap_add(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, int user,
     /* Write entry */
     if (vtss_state->warm_start_cur) {
         return VTSS_RC_OK;
+#if defined(VTSS_FEATURE_VCAP_TXN)
+    } else if (obj->txn) {
+        /* Written from the saved copy when the transaction is committed */
+        vtss_vcap_txn_copy_use(obj, cur);
+        cur->txn_flags |= VTSS_VCAP_TXN_FLAG_DIRTY;
+        return VTSS_RC_OK;
+#endif /* VTSS_FEATURE_VCAP_TXN */
     } else {
         idx.key_size = key_size_new;
         vtss_vcap_pos_get(obj, &idx, ndx_ins);
@@ -891,6 +1022,237 @@ vtss_rc vtss_vcap_add(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, int user,
     }
 }
 
+#if defined(VTSS_FEATURE_VCAP_TXN)
+/* - Transactions --------------------------------------------------
+
+   During a transaction, add/delete operations only update the rule list.
+   The TCAM is updated when the transaction is committed:
+   - Counters of rules being rewritten are read from their old position.
+   - Unchanged rules are moved to their new position. Consecutive rules moved
+     the same distance are moved in one operation.
+   - New and changed rules are written once at their final position.
+   - Unused rules and rows are deleted and unused super blocks are freed.
+   This avoids moving the following rules for each add/delete operation. */
+
+/* Start transaction, an error is returned if the VCAP must be updated directly */
+vtss_rc vtss_vcap_txn_begin(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj)
+{
+    vtss_vcap_entry_t    *cur;
+    vtss_vcap_key_size_t key_size;
+    u32                  ndx[VTSS_VCAP_KEY_SIZE_MAX];
+
+    if (obj->txn) {
+        VTSS_E("VCAP %s: transaction already started", obj->name);
+        return VTSS_RC_ERROR;
+    }
+
+    /* Moving rules one position at a time would cost more move operations than updating directly */
+    if (vtss_state->warm_start_cur || vtss_vcap_copy_size(obj) == 0 || obj->entry_move_dist == NULL) {
+        VTSS_D("VCAP %s: transaction not supported", obj->name);
+        return VTSS_RC_ERROR;
+    }
+
+    /* Save the current TCAM position of all rules */
+    VTSS_D("VCAP %s, count: %u", obj->name, obj->count);
+    VTSS_MEMSET(ndx, 0, sizeof(ndx));
+    for (cur = obj->used; cur != NULL; cur = cur->next) {
+        key_size = cur->data.key_size;
+        cur->txn_flags = VTSS_VCAP_TXN_FLAG_OLD;
+        cur->txn_idx.key_size = key_size;
+        vtss_vcap_pos_get(obj, &cur->txn_idx, ndx[key_size]);
+        ndx[key_size]++;
+    }
+    obj->txn_count = obj->count;
+    obj->txn = TRUE;
+    return VTSS_RC_OK;
+}
+
+/* Move run of rules <dist> positions up/down */
+static vtss_rc vtss_vcap_txn_run_move(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj,
+                                      vtss_vcap_idx_t *idx, u32 count, u32 dist, BOOL up)
+{
+    VTSS_D("VCAP %s, row: %u, col: %u, count: %u, dist: %u, up: %u",
+           obj->name, idx->row, idx->col, count, dist, up);
+    return obj->entry_move_dist(vtss_state, idx, count, dist, up);
+}
+
+/* Move unchanged rules up or down. The rule list must be reversed when moving down */
+static vtss_rc vtss_vcap_txn_move(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj, BOOL up)
+{
+    vtss_vcap_entry_t    *cur;
+    vtss_vcap_key_size_t key_size;
+    vtss_vcap_idx_t      idx, run;
+    u32                  i, cnt, ndx, pos_old, pos_new, dist, count, run_pos = 0, run_dist = 0;
+
+    for (i = 0; i < VTSS_VCAP_KEY_SIZE_MAX; i++) {
+        /* Blocks of smaller rules are located before blocks of larger rules */
+        key_size = (up ? (VTSS_VCAP_KEY_SIZE_LAST - i) : i);
+        cnt = vtss_vcap_key_rule_count(key_size);
+        ndx = (up ? 0 : obj->key_count[key_size]);
+        count = 0;
+        for (cur = obj->used; cur != NULL; cur = cur->next) {
+            if (cur->data.key_size != key_size) {
+                continue;
+            }
+
+            /* Find new position */
+            if (!up) {
+                ndx--;
+            }
+            idx.key_size = key_size;
+            vtss_vcap_pos_get(obj, &idx, ndx);
+            if (up) {
+                ndx++;
+            }
+
+            /* New and changed rules are written later */
+            if ((cur->txn_flags & (VTSS_VCAP_TXN_FLAG_OLD | VTSS_VCAP_TXN_FLAG_DIRTY)) != VTSS_VCAP_TXN_FLAG_OLD) {
+                continue;
+            }
+            pos_old = (cur->txn_idx.row * cnt + cur->txn_idx.col);
+            pos_new = (idx.row * cnt + idx.col);
+            if (up ? (pos_new >= pos_old) : (pos_new <= pos_old)) {
+                continue;
+            }
+
+            /* Extend run if the rule is next to the previous rule and moved the same distance */
+            dist = (up ? (pos_old - pos_new) : (pos_new - pos_old));
+            if (count != 0 && dist == run_dist && pos_old == (up ? (run_pos + 1) : (run_pos - 1))) {
+                if (!up) {
+                    run = cur->txn_idx;
+                }
+                run_pos = pos_old;
+                count++;
+                continue;
+            }
+            if (count != 0) {
+                VTSS_RC(vtss_vcap_txn_run_move(vtss_state, obj, &run, count, run_dist, up));
+            }
+            run = cur->txn_idx;
+            run_pos = pos_old;
+            run_dist = dist;
+            count = 1;
+        }
+        if (count != 0) {
+            VTSS_RC(vtss_vcap_txn_run_move(vtss_state, obj, &run, count, run_dist, up));
+        }
+    }
+    return VTSS_RC_OK;
+}
+
+/* Reverse rule list */
+static void vtss_vcap_txn_reverse(vtss_vcap_obj_t *obj)
+{
+    vtss_vcap_entry_t *cur, *next, *prev = NULL;
+
+    for (cur = obj->used; cur != NULL; cur = next) {
+        next = cur->next;
+        cur->next = prev;
+        prev = cur;
+    }
+    obj->used = prev;
+}
+
+/* Write TCAM layout */
+static vtss_rc vtss_vcap_txn_write(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj)
+{
+    vtss_vcap_entry_t    *cur;
+    vtss_vcap_key_size_t key_size;
+    vtss_vcap_idx_t      idx;
+    u32                  cnt, row, ndx[VTSS_VCAP_KEY_SIZE_MAX];
+    vtss_rc              rc;
+
+    /* Read counters of changed rules before anything is moved */
+    for (cur = obj->used; cur != NULL; cur = cur->next) {
+        cur->txn_counter = 0;
+        if ((cur->txn_flags & VTSS_VCAP_TXN_FLAG_OLD) && (cur->txn_flags & VTSS_VCAP_TXN_FLAG_DIRTY)) {
+            VTSS_RC(obj->entry_get(vtss_state, &cur->txn_idx, &cur->txn_counter, 0));
+        }
+    }
+
+    /* Move rules up in increasing order, then move rules down in decreasing order */
+    VTSS_RC(vtss_vcap_txn_move(vtss_state, obj, 1));
+    vtss_vcap_txn_reverse(obj);
+    rc = vtss_vcap_txn_move(vtss_state, obj, 0);
+    vtss_vcap_txn_reverse(obj);
+    VTSS_RC(rc);
+
+    /* Write new and changed rules */
+    VTSS_MEMSET(ndx, 0, sizeof(ndx));
+    for (cur = obj->used; cur != NULL; cur = cur->next) {
+        key_size = cur->data.key_size;
+        if (cur->txn_flags & VTSS_VCAP_TXN_FLAG_DIRTY) {
+            idx.key_size = key_size;
+            vtss_vcap_pos_get(obj, &idx, ndx[key_size]);
+            VTSS_RC(obj->entry_add(vtss_state, &idx, &cur->data, cur->txn_counter));
+        }
+        ndx[key_size]++;
+    }
+
+    /* Delete unused rules on the last row of each block */
+    for (key_size = VTSS_VCAP_KEY_SIZE_HALF; key_size <= VTSS_VCAP_KEY_SIZE_LAST; key_size++) {
+        cnt = vtss_vcap_key_rule_count(key_size);
+        idx.key_size = key_size;
+        for (ndx[key_size] = obj->key_count[key_size]; (ndx[key_size] % cnt) != 0; ndx[key_size]++) {
+            vtss_vcap_pos_get(obj, &idx, ndx[key_size]);
+            if (idx.row < obj->txn_count) {
+                /* Rows added by the transaction are unused */
+                VTSS_RC(obj->entry_del(vtss_state, &idx));
+            }
+        }
+    }
+
+    /* Delete rows no longer used */
+    idx.key_size = VTSS_VCAP_KEY_SIZE_FULL;
+    idx.col = 0;
+    for (row = obj->count; row < obj->txn_count; row++) {
+        idx.row = row;
+        VTSS_RC(obj->entry_del(vtss_state, &idx));
+    }
+
+#if defined(VTSS_FEATURE_VCAP_SUPER)
+    /* Free unused super blocks */
+    while (obj->vcap_super != NULL && obj->max_count >= (obj->count + obj->vcap_super->row_count)) {
+        cnt = obj->max_count;
+        VTSS_RC(vtss_vcap_super_free(vtss_state, obj));
+        if (obj->max_count == cnt) {
+            break;
+        }
+    }
+#endif /* VTSS_FEATURE_VCAP_SUPER */
+    return VTSS_RC_OK;
+}
+
+/* Release copies allocated during transaction */
+static void vtss_vcap_txn_free(vtss_vcap_entry_t *cur)
+{
+    for ( ; cur != NULL; cur = cur->next) {
+        if (cur->txn_flags & VTSS_VCAP_TXN_FLAG_COPY) {
+            VTSS_OS_FREE(cur->copy, VTSS_MEM_FLAGS_NONE);
+            cur->copy = NULL;
+        }
+        cur->txn_flags = 0;
+    }
+}
+
+/* Commit transaction, writing each changed rule once */
+vtss_rc vtss_vcap_txn_commit(vtss_state_t *vtss_state, vtss_vcap_obj_t *obj)
+{
+    vtss_rc rc;
+
+    if (!obj->txn) {
+        return VTSS_RC_OK;
+    }
+
+    VTSS_D("VCAP %s, count: %u, old count: %u", obj->name, obj->count, obj->txn_count);
+    obj->txn = FALSE;
+    rc = vtss_vcap_txn_write(vtss_state, obj);
+    vtss_vcap_txn_free(obj->used);
+    vtss_vcap_txn_free(*vtss_vcap_free_list(obj));
+    return rc;
+}
+#endif /* VTSS_FEATURE_VCAP_TXN */
+
 /* Get next ID for one user based on another user (special function for PTP) */
 vtss_rc vtss_vcap_get_next_id(vtss_vcap_obj_t *obj, int user1, int user2,
                               vtss_vcap_id_t id, vtss_vcap_id_t *ins_id)
@@ -1565,6 +1927,46 @@ vtss_rc vtss_ace_del(const vtss_inst_t    inst,
     return rc;
 }
 
+vtss_rc vtss_ace_update_list(const vtss_inst_t       inst,
+                             const u32               cnt,
+                             const vtss_ace_update_t *const list)
+{
+    vtss_state_t            *vtss_state;
+    vtss_rc                 rc;
+    u32                     i;
+    const vtss_ace_update_t *upd;
+#if defined(VTSS_FEATURE_VCAP_TXN)
+    vtss_vcap_obj_t         *obj;
+    vtss_rc                 rc_txn = VTSS_RC_ERROR;
+#endif
+
+    VTSS_D("cnt: %u", cnt);
+
+    VTSS_ENTER();
+    if ((rc = vtss_inst_check(inst, &vtss_state)) == VTSS_RC_OK) {
+#if defined(VTSS_FEATURE_VCAP_TXN)
+        /* Use direct update if the transaction can not be started */
+        obj = &vtss_state->vcap.is2.obj;
+        rc_txn = vtss_vcap_txn_begin(vtss_state, obj);
+#endif
+        for (i = 0; i < cnt && rc == VTSS_RC_OK; i++) {
+            upd = &list[i];
+            if (upd->add) {
+                rc = VTSS_FUNC(vcap.acl_ace_add, upd->ace_id_next, &upd->ace);
+            } else {
+                rc = VTSS_FUNC(vcap.acl_ace_del, upd->ace.id);
+            }
+        }
+#if defined(VTSS_FEATURE_VCAP_TXN)
+        if (rc_txn == VTSS_RC_OK && vtss_vcap_txn_commit(vtss_state, obj) != VTSS_RC_OK && rc == VTSS_RC_OK) {
+            rc = VTSS_RC_ERROR;
+        }
+#endif
+    }
+    VTSS_EXIT();
+    return rc;
+}
+
 vtss_rc vtss_ace_counter_get(const vtss_inst_t    inst,
                              const vtss_ace_id_t  ace_id,
                              vtss_ace_counter_t   *const counter)
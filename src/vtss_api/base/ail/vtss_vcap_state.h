@@ -72,6 +72,10 @@
 #endif
 #endif
 
+#if !VTSS_OPT_LIGHT
+#define VTSS_FEATURE_VCAP_TXN        /* Transactional VCAP update with deferred layout */
+#endif
+
 /** \brief VCAP key size */
 typedef enum
 {
@@ -1026,6 +1030,20 @@ typedef struct {
 #endif /* VTSS_ARCH_JAGUAR_2 */
 } vtss_vcap_data_t;
 
+/* VCAP rule index */
+typedef struct {
+    u32                  row;      /* TCAM row */
+    u32                  col;      /* TCAM column */
+    vtss_vcap_key_size_t key_size; /* Rule key size */
+} vtss_vcap_idx_t;
+
+#if defined(VTSS_FEATURE_VCAP_TXN)
+/* VCAP entry transaction flags */
+#define VTSS_VCAP_TXN_FLAG_OLD   0x01 /* Entry was present in TCAM when transaction started */
+#define VTSS_VCAP_TXN_FLAG_DIRTY 0x02 /* Entry must be written when transaction is committed */
+#define VTSS_VCAP_TXN_FLAG_COPY  0x04 /* Entry copy was allocated for the transaction */
+#endif /* VTSS_FEATURE_VCAP_TXN */
+
 /* VCAP entry */
 typedef struct vtss_vcap_entry_t {
     struct vtss_vcap_entry_t *next; /* Next in list */
@@ -1035,15 +1053,13 @@ typedef struct vtss_vcap_entry_t {
 #if !VTSS_OPT_LIGHT
     void                     *copy; /* Entry copy. Points to a copy of entry key/action (or NULL if not needed). */
 #endif
+#if defined(VTSS_FEATURE_VCAP_TXN)
+    u8                       txn_flags;   /* Transaction flags */
+    vtss_vcap_idx_t          txn_idx;     /* TCAM position when transaction started */
+    u32                      txn_counter; /* Counter saved before entry is rewritten */
+#endif /* VTSS_FEATURE_VCAP_TXN */
 } vtss_vcap_entry_t;
 
-/* VCAP rule index */
-typedef struct {
-    u32                  row;      /* TCAM row */
-    u32                  col;      /* TCAM column */
-    vtss_vcap_key_size_t key_size; /* Rule key size */
-} vtss_vcap_idx_t;
-
 typedef struct {
     u32 count;     /* Actual number */
     u32 max_count; /* Maximum number */
@@ -1082,6 +1098,14 @@ typedef struct {
     vtss_rc (* entry_add)(struct vtss_state_s *vtss_state, vtss_vcap_idx_t *idx, vtss_vcap_data_t *data, u32 counter);
     vtss_rc (* entry_del)(struct vtss_state_s *vtss_state, vtss_vcap_idx_t *idx);
     vtss_rc (* entry_move)(struct vtss_state_s *vtss_state, vtss_vcap_idx_t *idx, u32 count, BOOL up);
+#if defined(VTSS_FEATURE_VCAP_TXN)
+    /* Optional: Move <count> rules by <dist> positions in one operation, required for transactions */
+    vtss_rc (* entry_move_dist)(struct vtss_state_s *vtss_state, vtss_vcap_idx_t *idx, u32 count, u32 dist, BOOL up);
+
+    /* Transaction state */
+    BOOL              txn;            /* Transaction active, TCAM updates are deferred */
+    u32               txn_count;      /* Number of rows when transaction started */
+#endif /* VTSS_FEATURE_VCAP_TXN */
 
 #if defined(VTSS_FEATURE_VCAP_SUPER)
     vtss_vcap_super_obj_t *vcap_super;
@@ -1455,6 +1479,10 @@ vtss_rc vtss_vcap_add(struct vtss_state_s *vtss_state, vtss_vcap_obj_t *obj, int
                       vtss_vcap_id_t ins_id, vtss_vcap_data_t *data, BOOL dont_add);
 vtss_rc vtss_vcap_get_next_id(vtss_vcap_obj_t *obj, int user1, int user2,
                               vtss_vcap_id_t id, vtss_vcap_id_t *ins_id);
+#if defined(VTSS_FEATURE_VCAP_TXN)
+vtss_rc vtss_vcap_txn_begin(struct vtss_state_s *vtss_state, vtss_vcap_obj_t *obj);
+vtss_rc vtss_vcap_txn_commit(struct vtss_state_s *vtss_state, vtss_vcap_obj_t *obj);
+#endif /* VTSS_FEATURE_VCAP_TXN */
 #if defined(VTSS_FEATURE_VCAP_SUPER)
 const char *vtss_vcap_type_txt(vtss_vcap_type_t type);
 #endif /* VTSS_FEATURE_VCAP_SUPER */
@@ -659,6 +659,35 @@ static vtss_rc fa_vcap_entry_move(vtss_state_t *vtss_state,
     return fa_vcap_cmd(vtss_state, &info);
 }
 
+#if defined(VTSS_FEATURE_VCAP_TXN)
+/* Move <count> entries <dist> positions in one move command */
+static vtss_rc fa_vcap_entry_move_dist(vtss_state_t *vtss_state, vtss_vcap_type_t type,
+                                       vtss_vcap_idx_t *idx, u32 count, u32 dist, BOOL up)
+{
+    fa_vcap_type_t             bank = fa_vcap_type(type);
+    const fa_vcap_type_props_t *props = &fa_vcap_type_info[bank];
+    u32                        addr, cnt = (props->props->sw_count/vtss_vcap_key_rule_count(idx->key_size));
+    vtss_fa_vcap_reg_info_t    info;
+
+    if (count == 0 || dist == 0) {
+        VTSS_E("illegal count/dist zero");
+        return VTSS_RC_ERROR;
+    }
+    addr = (fa_vcap_entry_addr(vtss_state, type, idx) - (count - 1) * cnt);
+    VTSS_I("%s, row: %u, col: %u, %s, count: %u, dist: %u, up: %u, addr: %u",
+           props->name, idx->row, idx->col, vtss_vcap_key_size2txt(idx->key_size), count, dist, up, addr);
+    VTSS_MEMSET(&info, 0, sizeof(info));
+    info.bank = bank;
+    info.update_addr = addr;
+    info.update_cmd = (up ? FA_VCAP_CMD_MOVE_UP : FA_VCAP_CMD_MOVE_DOWN);
+    info.update_sel = FA_VCAP_SEL_ALL;
+    info.mv_size = (count * cnt - 1);
+    info.mv_pos = (dist * cnt - 1);
+    VTSS_RC(fa_vcap_reg_info_get(vtss_state, &info));
+    return fa_vcap_cmd(vtss_state, &info);
+}
+#endif /* VTSS_FEATURE_VCAP_TXN */
+
 static vtss_rc fa_vcap_entry_get(vtss_state_t *vtss_state,
                                  vtss_vcap_type_t type, vtss_vcap_idx_t *idx, u32 *counter, BOOL clear)
 {
@@ -3061,6 +3090,13 @@ static vtss_rc fa_is2_a_entry_move(vtss_state_t *vtss_state, vtss_vcap_idx_t *id
     return fa_vcap_entry_move(vtss_state, VTSS_VCAP_TYPE_IS2, idx, count, up);
 }
 
+#if defined(VTSS_FEATURE_VCAP_TXN)
+static vtss_rc fa_is2_a_entry_move_dist(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx, u32 count, u32 dist, BOOL up)
+{
+    return fa_vcap_entry_move_dist(vtss_state, VTSS_VCAP_TYPE_IS2, idx, count, dist, up);
+}
+#endif /* VTSS_FEATURE_VCAP_TXN */
+
 static vtss_rc fa_is2_a_entry_get(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx, u32 *counter, BOOL clear)
 {
     return fa_is2_entry_get(vtss_state, VTSS_VCAP_TYPE_IS2, idx, counter, clear);
@@ -4735,6 +4771,13 @@ static vtss_rc fa_es0_entry_move(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx,
     return fa_vcap_entry_move(vtss_state, VTSS_VCAP_TYPE_ES0, idx, count, up);
 }
 
+#if defined(VTSS_FEATURE_VCAP_TXN)
+static vtss_rc fa_es0_entry_move_dist(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx, u32 count, u32 dist, BOOL up)
+{
+    return fa_vcap_entry_move_dist(vtss_state, VTSS_VCAP_TYPE_ES0, idx, count, dist, up);
+}
+#endif /* VTSS_FEATURE_VCAP_TXN */
+
 static vtss_rc fa_es0_entry_get(vtss_state_t *vtss_state, vtss_vcap_idx_t *idx, u32 *counter, BOOL clear)
 {
     return fa_vcap_entry_get(vtss_state, VTSS_VCAP_TYPE_ES0, idx, counter, clear);
@@ -5443,6 +5486,9 @@ vtss_rc vtss_fa_vcap_init(vtss_state_t *vtss_state, vtss_init_cmd_t cmd)
         is2_a->entry_add = fa_is2_a_entry_add;
         is2_a->entry_del = fa_is2_a_entry_del;
         is2_a->entry_move = fa_is2_a_entry_move;
+#if defined(VTSS_FEATURE_VCAP_TXN)
+        is2_a->entry_move_dist = fa_is2_a_entry_move_dist;
+#endif
         is2_a->entry_get = fa_is2_a_entry_get;
         is2_a->vcap_super = vcap_super;
 
@@ -5460,6 +5506,9 @@ vtss_rc vtss_fa_vcap_init(vtss_state_t *vtss_state, vtss_init_cmd_t cmd)
         es0->entry_add = fa_es0_entry_add;
         es0->entry_del = fa_es0_entry_del;
         es0->entry_move = fa_es0_entry_move;
+#if defined(VTSS_FEATURE_VCAP_TXN)
+        es0->entry_move_dist = fa_es0_entry_move_dist;
+#endif
         es0->entry_get = fa_es0_entry_get;
         state->es0_entry_update = fa_es0_entry_update;
         state->es0_esdx_update = fa_es0_esdx_update;
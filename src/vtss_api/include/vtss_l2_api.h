@@ -143,6 +143,27 @@ vtss_rc vtss_mac_table_get_next(const vtss_inst_t       inst,
                                 vtss_mac_table_entry_t  *const entry);
 
 
+/**
+ * \brief Lookup a number of MAC address entries.
+ *
+ * Equivalent to repeated calls to vtss_mac_table_get_next(), but done in
+ * one operation.
+ *
+ * \param inst [IN]      Target instance reference.
+ * \param vid_mac [IN]   VLAN ID and MAC address to get entries after.
+ * \param max [IN]       Maximum number of entries to get.
+ * \param entries [OUT]  Array of at least max MAC address entries in ascending order.
+ * \param count [OUT]    Number of entries returned. If less than max, the end of the table was reached.
+ *
+ * \return Return code. An error is returned if no entries were found.
+ **/
+vtss_rc vtss_mac_table_get_next_bulk(const vtss_inst_t       inst,
+                                     const vtss_vid_mac_t    *const vid_mac,
+                                     const u32               max,
+                                     vtss_mac_table_entry_t  *const entries,
+                                     u32                     *const count);
+
+
 /** \brief MAC address table age time */
 typedef u32 vtss_mac_table_age_time_t;
 
@@ -646,6 +646,33 @@ vtss_rc vtss_ace_del(const vtss_inst_t    inst,
                      const vtss_ace_id_t  ace_id);
 
 
+/** \brief ACE list update operation */
+typedef struct {
+    BOOL          add;         /**< Add/modify ACE if TRUE, delete ACE if FALSE */
+    vtss_ace_id_t ace_id_next; /**< Add: ACE ID of next entry (VTSS_ACE_ID_LAST to insert last) */
+    vtss_ace_t    ace;         /**< Add: ACE structure. Delete: Only the ACE ID is used */
+} vtss_ace_update_t;
+
+/**
+ * \brief Add/modify/delete a list of ACEs.
+ *
+ * The operations are done in list order, with the same result as calling
+ * vtss_ace_add() and vtss_ace_del() for each operation.
+ * The hardware is updated once when all operations are done, so each changed
+ * rule is written once instead of moving following rules for each operation.
+ * If an operation fails, the previous operations are applied and the error is returned.
+ *
+ * \param inst [IN]  Target instance reference.
+ * \param cnt [IN]   Number of operations.
+ * \param list [IN]  Operation list.
+ *
+ * \return Return code.
+ **/
+vtss_rc vtss_ace_update_list(const vtss_inst_t       inst,
+                             const u32               cnt,
+                             const vtss_ace_update_t *const list);
+
+
 
 /** \brief ACE hit counter */
 typedef u32 vtss_ace_counter_t; 
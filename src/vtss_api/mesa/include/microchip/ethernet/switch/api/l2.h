@@ -50,6 +50,18 @@ mesa_rc mesa_mac_table_get_next(const mesa_inst_t       inst,
                                 const mesa_vid_mac_t    *const vid_mac,
                                 mesa_mac_table_entry_t  *const entry);
 
+// Lookup a number of MAC address entries.
+// Equivalent to repeated calls to mesa_mac_table_get_next(), but done in one operation.
+// vid_mac [IN]   VLAN ID and MAC address to get entries after.
+// max [IN]       Maximum number of entries to get.
+// entries [OUT]  Array of at least max MAC address entries in ascending order.
+// count [OUT]    Number of entries returned. If less than max, the end of the table was reached.
+mesa_rc mesa_mac_table_get_next_bulk(const mesa_inst_t       inst,
+                                     const mesa_vid_mac_t    *const vid_mac,
+                                     const uint32_t          max,
+                                     mesa_mac_table_entry_t  *const entries,
+                                     uint32_t                *const count);
+
 
 // MAC address table age time
 typedef uint32_t mesa_mac_table_age_time_t;
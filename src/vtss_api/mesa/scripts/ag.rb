@@ -125,6 +125,7 @@ $methods_blacklist = [
     "mesa_callout_unlock",
     "mesa_vlan_trans_group_to_port_get",
     "mesa_vlan_trans_group_to_port_set",
+    "mesa_mac_table_get_next_bulk",
 ]
 
 $conv_methods = {}
@@ -103,6 +103,7 @@ $methods_blacklist = [
     "mesa_callout_trace_printf",
     "mesa_callout_lock",
     "mesa_callout_unlock",
+    "mesa_mac_table_get_next_bulk",
     "mesa_symreg_data_get",
     "mesa_debug_info_get",
     "mesa_debug_info_print",
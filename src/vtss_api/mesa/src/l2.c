@@ -104,6 +104,44 @@ mesa_rc mesa_conv2_mesa_vce_key_t_to_vtss_vce_key_t(const mesa_vce_key_t *in, vt
 }
 #endif
 
+mesa_rc mesa_mac_table_get_next_bulk(const mesa_inst_t       inst,
+                                     const mesa_vid_mac_t    *const vid_mac,
+                                     const uint32_t          max,
+                                     mesa_mac_table_entry_t  *const entries,
+                                     uint32_t                *const count)
+{
+#if defined(VTSS_FEATURE_LAYER2)
+    mesa_rc                rc;
+    uint32_t               i, n = 0;
+    vtss_mac_table_entry_t *tmp;
+
+    // The entries are read into a heap buffer rather than in stack-sized
+    // chunks, so that the whole request is served under one API lock.
+    *count = 0;
+    if (max == 0) {
+        return VTSS_RC_ERROR;
+    }
+    if ((tmp = (vtss_mac_table_entry_t *)VTSS_OS_MALLOC(sizeof(*tmp) * max, VTSS_MEM_FLAGS_NONE)) == NULL) {
+        return VTSS_RC_ERROR;
+    }
+    memset(tmp, 0, sizeof(*tmp) * max);
+    if ((rc = vtss_mac_table_get_next_bulk((const vtss_inst_t)inst, (const vtss_vid_mac_t *)vid_mac, max, tmp, &n)) == VTSS_RC_OK) {
+        for (i = 0; i < n; i++) {
+            if ((rc = mesa_conv_vtss_mac_table_entry_t_to_mesa_mac_table_entry_t(&tmp[i], &entries[i])) != VTSS_RC_OK) {
+                break;
+            }
+        }
+        if (rc == VTSS_RC_OK) {
+            *count = n;
+        }
+    }
+    VTSS_OS_FREE(tmp, VTSS_MEM_FLAGS_NONE);
+    return rc;
+#else
+    return VTSS_RC_ERROR;
+#endif
+}
+
 mesa_rc mesa_vlan_tx_tag_get(const mesa_inst_t  inst,
                              const mesa_vid_t   vid,
                              const uint32_t     cnt,
@@ -38,6 +38,7 @@
 #include "acl_api.h"
 #include "acl.h"
 #include "misc_api.h"
+#include "vtss_api_if_api.h" // vtss_api_if_reg_batch_begin()
 
 #ifdef VTSS_SW_OPTION_SYSLOG
 #include "syslog_api.h"
@@ -53,6 +54,7 @@
 
 #include <netinet/in.h>
 #include <netinet/ip6.h>
+#include <algorithm>
 
 #include "vtss_common_iterator.hxx"
 #include "vtss/basics/expose/snmp/iterator-compose-static-range.hxx"
@@ -567,7 +569,13 @@ static mesa_rc acl_ace_add(mesa_ace_id_t id, acl_entry_conf_t *conf)
         id_next =  ACL_DEF_PORT_ACE_ID_START;
     }
 
+    // A VCAP update is many register writes and no sleeps, so with SPI
+    // register access they are sent in a few transfers.
+    vtss_api_if_reg_batch_begin();
     rc = mesa_ace_add(NULL, id_next, &ace);
+    if (vtss_api_if_reg_batch_end() != VTSS_RC_OK && rc == VTSS_RC_OK) {
+        rc = VTSS_RC_ERROR;
+    }
 
 #ifdef VTSS_SW_OPTION_IP
     if (acl.ifmux_supported && rc == VTSS_RC_OK) {
@@ -620,7 +628,11 @@ static mesa_rc acl_ace_del(mesa_ace_id_t id)
     }
 #endif
 
+    vtss_api_if_reg_batch_begin();
     rc = mesa_ace_del(NULL, id);
+    if (vtss_api_if_reg_batch_end() != VTSS_RC_OK && rc == VTSS_RC_OK) {
+        rc = VTSS_RC_ERROR;
+    }
     T_D("exit, id: %d", id);
 
     return rc;
@@ -725,6 +737,7 @@ static mesa_rc acl_list_ace_add(mesa_ace_id_t *next_id, acl_entry_conf_t *conf)
     }
 
     if (rc == VTSS_RC_OK) {
+        acl.switch_ace_index.valid = FALSE;
         T_D("using from %s list", new_ace == NULL ? "free" : "used");
         if (new_ace == NULL) {
             /* Use first entry in free list */
@@ -820,6 +833,7 @@ static mesa_rc acl_list_ace_del(mesa_ace_id_t id, BOOL *conflict)
             } else {
                 prev->next = ace->next;
             }
+            acl.switch_ace_index.valid = FALSE;
             *conflict = ace->conf.conflict;
             if (ace->conf.new_allocated) {
                 /* This entry is saving in new memory */
@@ -844,69 +858,113 @@ static mesa_rc acl_list_ace_del(mesa_ace_id_t id, BOOL *conflict)
     return (found ? VTSS_RC_OK : (mesa_rc)VTSS_APPL_ACL_ERROR_ACE_NOT_FOUND);/* FIXME: Using two different annonymous enums, where returned 'VTSS_APPL_ACL_ERROR_ACE_NOT_FOUND' is out of 'mesa_rc' */
 }
 
+/* Rebuild the used list index if the list has changed since last use */
+static mesa_rc acl_list_index_update(void)
+{
+    acl_ace_index_t *idx = &acl.switch_ace_index;
+    acl_ace_t       *ace;
+
+    if (idx->valid) {
+        return VTSS_RC_OK;
+    }
+
+    idx->all.clear();
+    idx->sttc.clear();
+    idx->by_id.clear();
+    for (ace = acl.switch_acl.used; ace != NULL; ace = ace->next) {
+        if ((ACL_USER_ID_GET(ace->conf.id) == ACL_USER_STATIC && !idx->sttc.push_back(ace)) ||
+            !idx->by_id.push_back(idx->all.size()) ||
+            !idx->all.push_back(ace)) {
+            T_E("Unable to allocate ACE index");
+            return VTSS_APPL_ACL_ERROR_MEM_ALLOC_FAIL;
+        }
+    }
+
+    std::sort(idx->by_id.data(), idx->by_id.data() + idx->by_id.size(), [idx](u32 a, u32 b) {
+        return idx->all[a]->conf.id < idx->all[b]->conf.id;
+    });
+
+    idx->valid = TRUE;
+    T_D("rebuilt, %zu ACEs, %zu static", idx->all.size(), idx->sttc.size());
+    return VTSS_RC_OK;
+}
+
+/* Fill in the configuration and counter of an ACE */
+static mesa_rc acl_list_ace_copy(const acl_ace_t *ace, acl_entry_conf_t *conf,
+                                 mesa_ace_counter_t *counter)
+{
+    *conf = ace->conf;
+
+    /* Get counter */
+    if (counter) {
+        *counter = 0;
+    }
+    if (conf->conflict == FALSE && counter != NULL) {
+        return mesa_ace_counter_get(NULL, conf->id, counter);
+    }
+
+    return VTSS_RC_OK;
+}
+
 /* Get ACE or next ACE (use ACL_MGMT_ACE_ID_NONE to get first) */
 mesa_rc acl_list_ace_get(mesa_ace_id_t id, acl_entry_conf_t *conf,
                          mesa_ace_counter_t *counter, BOOL next)
 {
-    mesa_rc    rc = VTSS_RC_OK;
-    acl_ace_t  *ace;
-    acl_list_t *list;
-    BOOL       use_next = 0;
+    mesa_rc               rc;
+    acl_ace_index_t       *idx = &acl.switch_ace_index;
+    u32                   *i, *end;
+    size_t                pos;
 
     T_D("enter, id: %d, next: %d", id, next);
 
     ACL_LOCK_ASSERT_LOCKED("acl_list_ace_get");
-    list = &acl.switch_acl;
-    for (ace = list->used; ace != NULL; ace = ace->next) {
+    VTSS_RC(acl_list_index_update());
 
-        if (ACL_USER_ID_GET(ace->conf.id) != ACL_USER_ID_GET(id)) {
-            /* Skip ACEs for other users */
-            continue;
+    if (ACL_ACE_ID_GET(id) == ACL_MGMT_ACE_ID_NONE) {
+        /* Get first ACE */
+        pos = 0;
+    } else {
+        end = idx->by_id.data() + idx->by_id.size();
+        i = std::lower_bound(idx->by_id.data(), end, id, [idx](u32 a, mesa_ace_id_t b) {
+            return idx->all[a]->conf.id < b;
+        });
+        if (i == end || idx->all[*i]->conf.id != id) {
+            T_D("ACL entry not found id:%d", id);
+            return VTSS_APPL_ACL_ERROR_ACE_NOT_FOUND;
         }
-
-        if (ACL_ACE_ID_GET(id) == ACL_MGMT_ACE_ID_NONE) {
-            /* Found first ACE */
-            T_D("Found first id: %d, conf: %d", id, ace->conf.id);
-            break;
+        if (!next) {
+            return acl_list_ace_copy(idx->all[*i], conf, counter);
         }
+        pos = *i + 1;
+    }
 
-        if (use_next) {
-            /* Found next ACE */
-            T_D("Found use_next:  first id: %d, conf: %d", id, ace->conf.id);
+    /* ACEs of a user are normally adjacent, so this is a short scan */
+    for (; pos < idx->all.size(); pos++) {
+        if (ACL_USER_ID_GET(idx->all[pos]->conf.id) == ACL_USER_ID_GET(id)) {
             break;
         }
-
-        if (ace->conf.id == id) {
-            T_D("Found egual id: %d, conf: %d next %u", id, ace->conf.id, next);
-            /* Found ACE */
-            if (next) {
-                use_next = 1;
-            } else {
-                break;
-            }
-        }
     }
-    if (ace != NULL) {
-        /* Found it */
-        *conf = ace->conf;
-        T_D("Found id: %d  conf: %d", id, ace->conf.id);
-    } else {
+    if (pos == idx->all.size()) {
         T_D("ACL entry not found id:%d", id);
         return VTSS_APPL_ACL_ERROR_ACE_NOT_FOUND;
     }
 
-    /* Get counter */
-    if (counter) {
-        *counter = 0;
-    }
-    if (conf->conflict == FALSE && counter != NULL) {
-        rc = mesa_ace_counter_get(NULL, conf->id, counter);
-    }
-
-    T_D("Return rc:%u id: %d conf: %d", rc,  id, ace->conf.id);
+    rc = acl_list_ace_copy(idx->all[pos], conf, counter);
+    T_D("Return rc:%u id: %d conf: %d", rc, id, conf->id);
     return rc;
 }
 
+/* Get the n'th ACE by precedence, starting from 1.
+   Only static ACEs are counted when isid = VTSS_ISID_GLOBAL */
+static acl_ace_t *acl_list_ace_nth(vtss_isid_t isid, u32 n)
+{
+    acl_ace_index_t *idx = &acl.switch_ace_index;
+    vtss::Vector<acl_ace_t *> &v = (isid == VTSS_ISID_GLOBAL ? idx->sttc : idx->all);
+
+    ACL_LOCK_ASSERT_LOCKED("acl_list_ace_nth");
+    return (n == 0 || n > v.size()) ? NULL : v[n - 1];
+}
+
 /* Get ACE or next ACE by precedence
    Only provide static ACEs when the input parameter isid = VTSS_ISID_GLOBAL
  */
@@ -918,56 +976,18 @@ static mesa_rc acl_list_ace_get_nth(
     mesa_ace_counter_t  *counter
 )
 {
-    mesa_rc    rc = VTSS_RC_OK;
+    mesa_rc    rc;
     acl_ace_t  *ace;
-    acl_list_t *list;
-    BOOL       use_next = 0;
-    u32        ace_cnt = 0;
 
     T_D("enter, isid: %d, precedence: %u, b_next: %s", isid, precedence, b_next ? "TRUE" : "FALSE");
 
     ACL_LOCK_SCOPE();
-    list = &acl.switch_acl;
-    for (ace = list->used; ace != NULL; ace = ace->next) {
-
-        if (isid == VTSS_ISID_GLOBAL &&
-            ACL_USER_ID_GET(ace->conf.id) != ACL_USER_STATIC) {
-            continue;
-        }
-
-        if (precedence == 0 && b_next) {
-            /* Found first ACE */
-            break;
-        }
-
-        if (use_next) {
-            /* Found next ACE */
-            break;
-        }
-
-        if (++ace_cnt == precedence) {
-            /* Found ACE */
-            if (b_next) {
-                use_next = 1;
-            } else {
-                break;
-            }
-        }
-    }
-    if (ace != NULL) {
-        /* Found it */
-        *conf = ace->conf;
-    } else {
+    VTSS_RC(acl_list_index_update());
+    if ((ace = acl_list_ace_nth(isid, b_next ? precedence + 1 : precedence)) == NULL) {
         return VTSS_APPL_ACL_ERROR_ACE_NOT_FOUND;
     }
-    /* Get counter */
-    if (counter) {
-        *counter = 0;
-    }
-    if (conf->conflict == FALSE && counter != NULL) {
-        rc = mesa_ace_counter_get(NULL, conf->id, counter);
-    }
 
+    rc = acl_list_ace_copy(ace, conf, counter);
     T_D("exit rc:%u", rc);
     return rc;
 }
@@ -1958,6 +1978,45 @@ mesa_rc acl_mgmt_ace_get(acl_user_t user_id,
     return rc;
 }
 
+/* Get a batch of ACEs by precedence */
+mesa_rc acl_mgmt_ace_get_bulk(vtss_isid_t isid, u32 precedence, u32 max,
+                              acl_user_t *user_id, acl_entry_conf_t *conf,
+                              mesa_ace_counter_t *counter, u32 *cnt)
+{
+    acl_ace_t *ace;
+    u32       n;
+
+    T_D("enter, isid: %d, precedence: %u, max: %u", isid, precedence, max);
+
+    *cnt = 0;
+
+    /* Check stack role */
+    if (acl_mgmt_isid_invalid(isid)) {
+        T_D("exit - Wrong stack role");
+        return VTSS_APPL_ACL_ERROR_STACK_STATE;
+    }
+
+    if (isid != VTSS_ISID_GLOBAL && msg_switch_is_local(isid)) {
+        isid = VTSS_ISID_LOCAL;
+    }
+
+    ACL_LOCK_SCOPE();
+    VTSS_RC(acl_list_index_update());
+    for (n = 0; n < max && (ace = acl_list_ace_nth(isid, precedence + n + 1)) != NULL; n++) {
+        (void)acl_list_ace_copy(ace, &conf[n], counter ? &counter[n] : NULL);
+
+        /* Restore independent ACE ID */
+        if (user_id) {
+            user_id[n] = (acl_user_t)ACL_USER_ID_GET(conf[n].id);
+        }
+        conf[n].id = ACL_ACE_ID_GET(conf[n].id);
+    }
+    *cnt = n;
+
+    T_D("exit, cnt: %u", n);
+    return n ? VTSS_RC_OK : (mesa_rc)VTSS_APPL_ACL_ERROR_ACE_NOT_FOUND;
+}
+
 /* Check ACL ACE configuration parameters */
 static BOOL acl_ace_ipv4_params_invalid(acl_entry_conf_t *conf)
 {
@@ -2131,6 +2190,7 @@ static void acl_local_ace_conflict_solve(BOOL new_volatile_ace_conflict)
             } else {
                 list->used = new_ace;
             }
+            acl.switch_ace_index.valid = FALSE;
             VTSS_FREE(ace);
             ace = new_ace;
         }
@@ -2161,6 +2221,7 @@ static void acl_local_ace_conflict_solve(BOOL new_volatile_ace_conflict)
 
                     // Then swap location in list
                     temp_ace = ace;
+                    acl.switch_ace_index.valid = FALSE;
 
                     if (prev) {
                         prev->next = last_no_conflict_ace;
@@ -2446,6 +2507,7 @@ static void acl_start(BOOL init)
         list = &acl.switch_acl;
         list->used = NULL;
         list->free = NULL;
+        acl.switch_ace_index.valid = FALSE;
         for (i = 0; i < ACL_MGMT_ACE_MAX; i++) {
             ace = &acl.switch_ace_table[i];
             ace->next = list->free;
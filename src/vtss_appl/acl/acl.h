@@ -39,6 +39,7 @@
 #define VTSS_TRACE_GRP_DEFAULT      0
 
 #include <vtss_trace_api.h>
+#include <vtss/basics/vector.hxx>
 
 /* ================================================================= *
  *  ACE ID definitions
@@ -87,6 +88,17 @@ typedef struct {
     acl_ace_t   *free; /* Free list */
 } acl_list_t;
 
+/* Index of the used list. The list order only changes when ACEs are added,
+   deleted or moved by conflict solving, so the index is rebuilt on first use
+   after such a change. It gives O(1) lookup by precedence and O(log n) lookup
+   by ACE ID, instead of walking the list from the head on every access. */
+typedef struct {
+    BOOL                        valid;  /* Index matches the used list */
+    vtss::Vector<acl_ace_t *>   all;    /* All ACEs, in precedence order */
+    vtss::Vector<acl_ace_t *>   sttc;   /* ACL_USER_STATIC ACEs, in precedence order */
+    vtss::Vector<u32>           by_id;  /* Positions in 'all', sorted by ACE ID */
+} acl_ace_index_t;
+
 /* ACL counters */
 typedef struct {
     mesa_ace_id_t       id;      /* ACE ID */
@@ -106,6 +118,7 @@ typedef struct {
     CapArray<acl_port_conf_t, MEBA_CAP_BOARD_PORT_MAP_COUNT> port_conf;
     CapArray<vtss_appl_acl_config_rate_limiter_t, MESA_CAP_ACL_POLICER_CNT> policer_conf;
     acl_list_t                          switch_acl;
+    acl_ace_index_t                     switch_ace_index;
     CapArray<acl_ace_t, VTSS_APPL_CAP_ACL_ACE_CNT> switch_ace_table;
     char                                log_buf[ACL_LOG_BUF_SIZE];   /* Log buffer */
     CapArray<BOOL, MEBA_CAP_BOARD_PORT_MAP_COUNT>   def_port_ace_init;           /* Identify that default port ACE has been created */
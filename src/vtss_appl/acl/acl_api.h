@@ -511,6 +511,43 @@ mesa_rc acl_mgmt_ace_get(acl_user_t user_id,
                          mesa_ace_id_t id, acl_entry_conf_t *conf,
                          mesa_ace_counter_t *counter, BOOL next);
 
+/**
+ * \brief Get a batch of ACEs by precedence.
+ *
+ * The ACEs and their counters are read under a single lock acquisition,
+ * so walking the whole list takes one call per batch instead of one
+ * call per ACE.
+ *
+ * \param isid       [IN]  The switch ID.
+ *                         isid = VTSS_ISID_GLOBAL: Only static ACEs are
+ *                         returned (and counted in the precedence).
+ *
+ * \param precedence [IN]  Precedence of the last ACE returned by the
+ *                         previous call, or 0 to start from the first ACE.
+ *
+ * \param max        [IN]  Number of entries in the output arrays.
+ *
+ * \param user_id    [OUT] The ACL user ID of each ACE. It can be equal
+ *                         NULL if you don't need the information.
+ *
+ * \param conf       [OUT] The ACE configurations. The ACE IDs are the
+ *                         independent IDs of each user.
+ *
+ * \param counter    [OUT] The ACE counters. It can be equal NULL if you
+ *                         don't need the information.
+ *
+ * \param cnt        [OUT] Number of ACEs returned. The precedence of the
+ *                         last one is 'precedence' + 'cnt'.
+ *
+ * \return
+ *    VTSS_RC_OK on success.\n
+ *    ACL_ERROR_STACK_STATE if the illegal primary/secondary switch state.\n
+ *    ACL_ERROR_ACE_NOT_FOUND if there are no ACEs after 'precedence'.\n
+ **/
+mesa_rc acl_mgmt_ace_get_bulk(vtss_isid_t isid, u32 precedence, u32 max,
+                              acl_user_t *user_id, acl_entry_conf_t *conf,
+                              mesa_ace_counter_t *counter, u32 *cnt);
+
 /* Add ACE entry before given ACE or last (ACL_MGMT_ACE_ID_NONE) */
 /**
  * \brief Add/Edit an ACE by user ID and ACE ID.
@@ -49,6 +49,7 @@
 */
 #include "vtss_dhcp_server.h"
 #include "vtss_dhcp_server_message.h"
+#include "vtss_dhcp_server_ip_run.h"
 #include "vtss/appl/dhcp_relay.h"
 #include "dhcp_server_platform.h"
 #include "vtss_avl_tree_api.h"
@@ -587,6 +588,9 @@ VTSS_AVL_TREE(g_binding_name_avlt, "BINDING_NAME", 0, _binding_name_ip_cmp_func,
 VTSS_AVL_TREE(g_binding_lease_avlt, "BINDING_LEASE", 0, _binding_time_ip_cmp_func, DHCP_SERVER_BINDING_MAX_CNT)
 // AVL tree, index: ip
 VTSS_AVL_TREE(g_binding_expired_avlt, "BINDING_EXPIRED", 0, _binding_ip_cmp_func, DHCP_SERVER_BINDING_MAX_CNT)
+// AVL tree with the same bindings as g_binding_expired_avlt, index: expire_time, ip
+// The first one is the one expired longest ago, which is reused first.
+VTSS_AVL_TREE(g_binding_expiry_avlt, "BINDING_EXPIRY", 0, _binding_time_ip_cmp_func, DHCP_SERVER_BINDING_MAX_CNT)
 
 /*
     Decline IP list
@@ -967,6 +971,31 @@ static void _binding_statistic_dec(
     }
 }
 
+/**
+ *  \brief
+ *      update the used IP index after ip has been added to or deleted from
+ *      the binding or the declined IP list.
+ *      ip is used as long as it is in one of them.
+ */
+static void _ip_used_update(
+    IN  mesa_ipv4_t     ip
+)
+{
+    dhcp_server_binding_t   binding;
+    dhcp_server_binding_t   *bp;
+    BOOL                    b_used;
+
+    memset(&binding, 0, sizeof(binding));
+    binding.ip = ip;
+    bp = &binding;
+    b_used = vtss_avl_tree_get(&g_binding_ip_avlt, (void **)&bp, VTSS_AVL_TREE_GET) || _ip_is_declined(ip);
+
+    if ( vtss_dhcp_server_ip_run_set(ip, b_used) == FALSE ) {
+        // _free_ip_get() double-checks, so the index is only a hint
+        T_D("Full in used IP index for %08x\n", ip);
+    }
+}
+
 /**
  *  \brief
  *      get a new binding from free list
@@ -1069,6 +1098,8 @@ static dhcp_server_binding_t *_binding_new(
 
     _binding_statistic_inc( binding );
 
+    _ip_used_update( binding->ip );
+
     ++( pool->alloc_cnt );
     return binding;
 }
@@ -1087,6 +1118,8 @@ static void _binding_remove(
     IN  dhcp_server_binding_t     *binding
 )
 {
+    mesa_ipv4_t     ip;
+
     switch ( binding->state ) {
     case VTSS_APPL_DHCP_SERVER_BINDING_STATE_COMMITTED:
     case VTSS_APPL_DHCP_SERVER_BINDING_STATE_ALLOCATED:
@@ -1106,12 +1139,17 @@ static void _binding_remove(
     (void)vtss_avl_tree_delete(&g_binding_chaddr_avlt,  (void **)&binding);
     (void)vtss_avl_tree_delete(&g_binding_name_avlt,    (void **)&binding);
     (void)vtss_avl_tree_delete(&g_binding_expired_avlt, (void **)&binding);
+    (void)vtss_avl_tree_delete(&g_binding_expiry_avlt, (void **)&binding);
 
     if (vtss_avl_tree_delete(&g_binding_lease_avlt, (void **)&binding)) {
         T_D("delete %08x from lease tree\n", binding->ip);
     }
 
+    ip = binding->ip;
     vtss_free_list_free(&g_binding_flist, binding);
+
+    // the IP is free unless declined
+    _ip_used_update( ip );
 }
 
 /**
@@ -1147,6 +1185,7 @@ static void _binding_expired_move(
         T_D("delete %08x from lease tree\n", binding->ip);
     }
     (void)vtss_avl_tree_delete(&g_binding_expired_avlt, (void **)&binding);
+    (void)vtss_avl_tree_delete(&g_binding_expiry_avlt, (void **)&binding);
 
     // update state
     binding->type        = VTSS_APPL_DHCP_SERVER_BINDING_TYPE_EXPIRED;
@@ -1157,6 +1196,9 @@ static void _binding_expired_move(
     if ( vtss_avl_tree_add(&g_binding_expired_avlt, (void *)binding) == FALSE ) {
         T_D("Full in g_binding_expired_avlt\n");
     }
+    if ( vtss_avl_tree_add(&g_binding_expiry_avlt, (void *)binding) == FALSE ) {
+        T_D("Full in g_binding_expiry_avlt\n");
+    }
 
     _binding_statistic_inc( binding );
 }
@@ -1206,6 +1248,7 @@ static void _binding_allocated_move(
         T_D("delete %08x from lease tree\n", binding->ip);
     }
     (void)vtss_avl_tree_delete(&g_binding_expired_avlt, (void **)&binding);
+    (void)vtss_avl_tree_delete(&g_binding_expiry_avlt, (void **)&binding);
 
     _binding_statistic_dec( binding );
 
@@ -1252,6 +1295,7 @@ static void _binding_committed_move(
         T_D("delete %08x from lease tree\n", binding->ip);
     }
     (void)vtss_avl_tree_delete(&g_binding_expired_avlt, (void **)&binding);
+    (void)vtss_avl_tree_delete(&g_binding_expiry_avlt, (void **)&binding);
 
     _binding_statistic_dec( binding );
 
@@ -1300,6 +1344,7 @@ static BOOL _old_binding_allocated(
         T_D("delete %08x from lease tree\n", binding->ip);
     }
     (void)vtss_avl_tree_delete(&g_binding_expired_avlt, (void **)&binding);
+    (void)vtss_avl_tree_delete(&g_binding_expiry_avlt, (void **)&binding);
 
     /* remove from id or chaddr tree */
     if ( binding->identifier.type != VTSS_APPL_DHCP_SERVER_CLIENT_IDENTIFIER_TYPE_NONE ) {
@@ -1475,11 +1520,14 @@ static void _declined_ip_delete(
 )
 {
     mesa_ipv4_t     *ipp;
+    mesa_ipv4_t     ip;
 
+    ip  = *declined_ip;
     ipp = declined_ip;
     if ( vtss_avl_tree_delete(&g_decline_ip_avlt, (void **)&ipp) ) {
         vtss_free_list_free(&g_decline_flist, ipp);
         STATISTICS_DEC( declined_cnt );
+        _ip_used_update( ip );
     }
 }
 
@@ -1504,82 +1552,98 @@ static mesa_ipv4_t _free_ip_get(
     OUT dhcp_server_binding_t   **expired
 )
 {
-    u32                         i;
     mesa_ipv4_t                 ip;
-    u32                         count;
+    mesa_ipv4_t                 low_ip;
+    mesa_ipv4_t                 high_ip;
+    mesa_ipv4_t                 netmask;
     mesa_ipv4_t                 *ipp;
+    dhcp_server_binding_t       binding;
+    dhcp_server_binding_t       *bp;
     dhcp_server_binding_t       *ep;
-    dhcp_server_binding_t       *longest_expired;
     dhcp_server_excluded_ip_t   *excluded_ptr;
-    mesa_ipv4_t                 vlan_high_ip;
     dhcp_server_excluded_ip_t   excluded;
 
-    longest_expired = NULL;
-
     memset(&excluded, 0, sizeof(dhcp_server_excluded_ip_t));
     excluded_ptr = &excluded;
 
-    /* 1. get free IP first */
+    /*
+        The addresses to check are those of the smaller of the pool subnet
+        and the VLAN subnet, without the first 0 and the broadcast address.
+    */
     if ( pool->subnet_mask > vlan_netmask ) {
-        ip = pool->ip & pool->subnet_mask;
-        count = ( ~(pool->subnet_mask) ) + 1;
+        ip      = pool->ip;
+        netmask = pool->subnet_mask;
     } else {
-        ip = vlan_ip & vlan_netmask;
-        count = ( ~vlan_netmask ) + 1;
+        ip      = vlan_ip;
+        netmask = vlan_netmask;
     }
 
+    low_ip  = ( ip & netmask ) + 1;
+    high_ip = ( ip | ~netmask ) - 1;
+
     /*
-        It will take a long long time of check IP one by one when all A-class
-        subnet is excluded. Therefore, we need to calculate excluded IP range
-        and just skip that range, but not check IP one by one.
+        1. get free IP first
+
+        The used IP index (bindings and declined IPs) gives the next unused
+        IP in O(log n), and excluded IP ranges are skipped as a whole.
+        The remaining checks are done by _ip_is_free().
     */
-    vlan_high_ip = vlan_ip | (~vlan_netmask);
-    for ( i = 0; i < count; ++i ) {
+    ip = low_ip;
+    while ( netmask < 0xFFffFFfe && ip <= high_ip ) {
+        if ( (ip = vtss_dhcp_server_ip_run_unused_get(ip, high_ip)) == 0 ) {
+            break;
+        }
+
         /* check excluded IP range */
-        if ( _ip_in_all_excluded(ip + i, &excluded_ptr) ) {
-            T_D("check excluded: high 0X%x, low 0X%x, vlan_high 0X%x\n", excluded_ptr->high_ip, excluded_ptr->low_ip, vlan_high_ip);
-            // check high IP is in or over VLAN subnet
-            if (excluded_ptr->high_ip >= vlan_high_ip) {
-                // excluded high IP is over VLAN subnet
-                // it means no free IP
+        if ( _ip_in_all_excluded(ip, &excluded_ptr) ) {
+            T_D("check excluded: high 0X%x, low 0X%x, high 0X%x\n", excluded_ptr->high_ip, excluded_ptr->low_ip, high_ip);
+            if ( excluded_ptr->high_ip >= high_ip ) {
+                // no free IP above the excluded range
                 break;
             }
-
-            // excluded high IP is in VLAN subnet
-            // then check next IP not in the range of excluded IP
-            i = excluded_ptr->high_ip - ip;
+            ip = excluded_ptr->high_ip + 1;
             continue;
         }
 
         /* check others for free */
         ep = NULL;
-        if ( _ip_is_free(ip + i, pool->subnet_mask, vlan_ip, vlan_netmask, &ep) ) {
-            if ( ep ) {
-                if ( longest_expired ) {
-                    if ( ep->expire_time < longest_expired->expire_time ) {
-                        longest_expired = ep;
-                    }
-                } else {
-                    longest_expired = ep;
-                }
-            } else {
-                return (ip + i);
-            }
+        if ( _ip_is_free(ip, pool->subnet_mask, vlan_ip, vlan_netmask, &ep) && ep == NULL ) {
+            return ip;
+        }
+
+        /* VLAN interface IP or manual IP */
+        if ( ip == high_ip ) {
+            break;
         }
+        ++ip;
     }
 
     /* 2. no free IP, then use longest expired IP */
-    if ( longest_expired ) {
-        *expired = longest_expired;
-        return longest_expired->ip;
+    memset(&binding, 0, sizeof(binding));
+    bp = &binding;
+    while ( vtss_avl_tree_get(&g_binding_expiry_avlt, (void **)&bp, VTSS_AVL_TREE_GET_NEXT) ) {
+        if ( bp->ip < low_ip || bp->ip > high_ip ) {
+            continue;
+        }
+
+        ep = NULL;
+        if ( _ip_is_free(bp->ip, pool->subnet_mask, vlan_ip, vlan_netmask, &ep) && ep == bp ) {
+            *expired = bp;
+            return bp->ip;
+        }
     }
 
     /* 3. no expired IP, then use declined IP */
-    ip  = 0;
+    ip  = pool->ip & pool->subnet_mask;
+    ip  = ip ? ip - 1 : 0;
     ipp = &ip;
 
     while ( vtss_avl_tree_get(&g_decline_ip_avlt, (void **)&ipp, VTSS_AVL_TREE_GET_NEXT) ) {
-        if ( _ip_in_pool(pool, *ipp) && !_ip_in_all_excluded(*ipp, NULL) ) {
+        if ( ! _ip_in_pool(pool, *ipp) ) {
+            // declined IPs are sorted, so the rest are above the pool
+            break;
+        }
+        if ( !_ip_in_all_excluded(*ipp, NULL) ) {
             ip = *ipp;
             _declined_ip_delete( ipp );
             return ip;
@@ -2906,6 +2970,7 @@ static void _dhcp_decline(
     }
 
     STATISTICS_INC( declined_cnt );
+    _ip_used_update( ip );
 }
 
 /**
@@ -3903,6 +3968,11 @@ BOOL vtss_dhcp_server_init(
         return FALSE;
     }
 
+    if ( vtss_avl_tree_init(&g_binding_expiry_avlt) == FALSE ) {
+        T_D("Fail to create AVL tree for g_binding_expiry_avlt\n");
+        return FALSE;
+    }
+
     /*
         Decline list
     */
@@ -3916,6 +3986,14 @@ BOOL vtss_dhcp_server_init(
         return FALSE;
     }
 
+    /*
+        Used IP index of bindings and declined IPs
+    */
+    if ( vtss_dhcp_server_ip_run_init() == FALSE ) {
+        T_D("Fail to create used IP index\n");
+        return FALSE;
+    }
+
     return TRUE;
 }
 
@@ -4997,6 +5075,7 @@ mesa_rc vtss_dhcp_server_declined_add(
     }
 
     STATISTICS_INC( declined_cnt );
+    _ip_used_update( declined_ip );
 
     return VTSS_RC_OK;
 }
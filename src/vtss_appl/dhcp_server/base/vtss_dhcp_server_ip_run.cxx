@@ -0,0 +1,352 @@
+/*
+
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+//----------------------------------------------------------------------------
+/**
+ *  \file
+ *      vtss_dhcp_server_ip_run.cxx
+ *
+ *  \brief
+ *      Index of used IP addresses.
+ *
+ *      Bindings and declined IPs are kept in an AVL tree of runs of
+ *      consecutive used addresses, indexed by the first address of the run.
+ *      Adjacent runs are always merged, so the address following a run is
+ *      unused.
+ */
+//----------------------------------------------------------------------------
+
+/*
+==============================================================================
+
+    Include File
+
+==============================================================================
+*/
+#include "vtss_dhcp_server_type.h"
+#include "vtss_dhcp_server_ip_run.h"
+#include "vtss_avl_tree_api.h"
+#include "vtss_free_list_api.h"
+
+/*
+==============================================================================
+
+    Constant
+
+==============================================================================
+*/
+/* Each used address is a binding or a declined IP */
+#define _IP_RUN_MAX_CNT     (2 * DHCP_SERVER_BINDING_MAX_CNT)   /**< max number of runs */
+
+/*
+==============================================================================
+
+    Type Definition
+
+==============================================================================
+*/
+/* run of used IP addresses, [low_ip, high_ip] */
+typedef struct {
+    mesa_ipv4_t     low_ip;
+    mesa_ipv4_t     high_ip;
+} dhcp_server_ip_run_t;
+
+/*
+==============================================================================
+
+    Compare Function
+
+==============================================================================
+*/
+/**
+ *  \brief
+ *      index: low_ip.
+ */
+static i32 _ip_run_cmp_func(
+    IN  void    *data_a,
+    IN  void    *data_b
+)
+{
+    dhcp_server_ip_run_t    *a;
+    dhcp_server_ip_run_t    *b;
+
+    a = (dhcp_server_ip_run_t *)data_a;
+    b = (dhcp_server_ip_run_t *)data_b;
+
+    if ( a->low_ip > b->low_ip ) {
+        return VTSS_AVL_TREE_CMP_RESULT_A_LARGER;
+    } else if ( a->low_ip < b->low_ip ) {
+        return VTSS_AVL_TREE_CMP_RESULT_A_SMALLER;
+    }
+    return VTSS_AVL_TREE_CMP_RESULT_A_B_SAME;
+}
+
+/*
+==============================================================================
+
+    AVL tree and Free list
+
+==============================================================================
+*/
+// Free list
+VTSS_FREE_LIST(g_ip_run_flist, dhcp_server_ip_run_t, _IP_RUN_MAX_CNT)
+// AVL tree, index: low_ip
+VTSS_AVL_TREE(g_ip_run_avlt, "IP_RUN", 0, _ip_run_cmp_func, _IP_RUN_MAX_CNT)
+
+static u32  g_ip_run_cnt;
+
+/*
+==============================================================================
+
+    Static Function
+
+==============================================================================
+*/
+/**
+ *  \brief
+ *      get the run starting at or before ip.
+ *
+ *  \return
+ *      * : the run with the highest low_ip <= ip.
+ *      NULL : no such run.
+ */
+static dhcp_server_ip_run_t *_ip_run_get(
+    IN  mesa_ipv4_t     ip
+)
+{
+    dhcp_server_ip_run_t    run;
+    dhcp_server_ip_run_t    *rp;
+
+    run.low_ip  = ip;
+    run.high_ip = ip;
+    rp = &run;
+    if ( vtss_avl_tree_get(&g_ip_run_avlt, (void **)&rp, VTSS_AVL_TREE_GET) ) {
+        return rp;
+    }
+
+    rp = &run;
+    if ( vtss_avl_tree_get(&g_ip_run_avlt, (void **)&rp, VTSS_AVL_TREE_GET_PREV) ) {
+        return rp;
+    }
+    return NULL;
+}
+
+/**
+ *  \brief
+ *      add a new run [low_ip, high_ip].
+ */
+static BOOL _ip_run_new(
+    IN  mesa_ipv4_t     low_ip,
+    IN  mesa_ipv4_t     high_ip
+)
+{
+    dhcp_server_ip_run_t    *rp;
+
+    rp = (dhcp_server_ip_run_t *)vtss_free_list_malloc( &g_ip_run_flist );
+    if ( rp == NULL ) {
+        return FALSE;
+    }
+
+    rp->low_ip  = low_ip;
+    rp->high_ip = high_ip;
+
+    if ( vtss_avl_tree_add(&g_ip_run_avlt, (void *)rp) == FALSE ) {
+        vtss_free_list_free( &g_ip_run_flist, rp );
+        return FALSE;
+    }
+
+    ++g_ip_run_cnt;
+    return TRUE;
+}
+
+/**
+ *  \brief
+ *      delete a run.
+ */
+static void _ip_run_delete(
+    IN  dhcp_server_ip_run_t    *rp
+)
+{
+    if ( vtss_avl_tree_delete(&g_ip_run_avlt, (void **)&rp) ) {
+        vtss_free_list_free( &g_ip_run_flist, rp );
+        --g_ip_run_cnt;
+    }
+}
+
+/**
+ *  \brief
+ *      mark ip as used, merging with the runs next to it.
+ */
+static BOOL _ip_run_used_add(
+    IN  mesa_ipv4_t     ip
+)
+{
+    dhcp_server_ip_run_t    *prev;
+    dhcp_server_ip_run_t    *next;
+
+    prev = NULL;
+    if ( ip ) {
+        prev = _ip_run_get( ip - 1 );
+        if ( prev && prev->high_ip != ip - 1 ) {
+            prev = NULL;
+        }
+    }
+
+    next = NULL;
+    if ( ip != 0xFFffFFff ) {
+        next = _ip_run_get( ip + 1 );
+        if ( next && next->low_ip != ip + 1 ) {
+            next = NULL;
+        }
+    }
+
+    if ( prev && next ) {
+        // ip joins two runs
+        prev->high_ip = next->high_ip;
+        _ip_run_delete( next );
+    } else if ( prev ) {
+        prev->high_ip = ip;
+    } else if ( next ) {
+        // No run lies between ip and next, so the order of the tree is kept
+        next->low_ip = ip;
+    } else {
+        return _ip_run_new( ip, ip );
+    }
+    return TRUE;
+}
+
+/**
+ *  \brief
+ *      mark ip in run as unused, splitting the run if needed.
+ */
+static BOOL _ip_run_used_delete(
+    IN  dhcp_server_ip_run_t    *rp,
+    IN  mesa_ipv4_t             ip
+)
+{
+    mesa_ipv4_t     high_ip;
+
+    if ( rp->low_ip == rp->high_ip ) {
+        _ip_run_delete( rp );
+    } else if ( ip == rp->low_ip ) {
+        // No run lies between ip and the rest of the run
+        rp->low_ip = ip + 1;
+    } else if ( ip == rp->high_ip ) {
+        rp->high_ip = ip - 1;
+    } else {
+        high_ip = rp->high_ip;
+        rp->high_ip = ip - 1;
+        if ( _ip_run_new(ip + 1, high_ip) == FALSE ) {
+            // restore the run
+            rp->high_ip = high_ip;
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*
+==============================================================================
+
+    Public Function
+
+==============================================================================
+*/
+BOOL vtss_dhcp_server_ip_run_init(
+    void
+)
+{
+    g_ip_run_cnt = 0;
+
+    if ( vtss_free_list_init(&g_ip_run_flist) == FALSE ) {
+        return FALSE;
+    }
+
+    if ( vtss_avl_tree_init(&g_ip_run_avlt) == FALSE ) {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+BOOL vtss_dhcp_server_ip_run_set(
+    IN  mesa_ipv4_t     ip,
+    IN  BOOL            b_used
+)
+{
+    dhcp_server_ip_run_t    *rp;
+
+    rp = _ip_run_get( ip );
+    if ( rp && ip > rp->high_ip ) {
+        rp = NULL;
+    }
+
+    if ( b_used ) {
+        return rp ? TRUE : _ip_run_used_add( ip );
+    }
+    return rp ? _ip_run_used_delete( rp, ip ) : TRUE;
+}
+
+BOOL vtss_dhcp_server_ip_run_used(
+    IN  mesa_ipv4_t     ip
+)
+{
+    dhcp_server_ip_run_t    *rp;
+
+    rp = _ip_run_get( ip );
+    return ( rp && ip <= rp->high_ip ) ? TRUE : FALSE;
+}
+
+mesa_ipv4_t vtss_dhcp_server_ip_run_unused_get(
+    IN  mesa_ipv4_t     low_ip,
+    IN  mesa_ipv4_t     high_ip
+)
+{
+    dhcp_server_ip_run_t    *rp;
+
+    if ( low_ip > high_ip ) {
+        return 0;
+    }
+
+    rp = _ip_run_get( low_ip );
+    if ( rp == NULL || low_ip > rp->high_ip ) {
+        return low_ip;
+    }
+
+    // runs are merged, so the address after the run is unused
+    if ( rp->high_ip >= high_ip ) {
+        return 0;
+    }
+    return rp->high_ip + 1;
+}
+
+u32 vtss_dhcp_server_ip_run_cnt(
+    void
+)
+{
+    return g_ip_run_cnt;
+}
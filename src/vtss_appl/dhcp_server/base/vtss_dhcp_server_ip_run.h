@@ -0,0 +1,118 @@
+/*
+
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+//----------------------------------------------------------------------------
+/**
+ *  \file
+ *      vtss_dhcp_server_ip_run.h
+ *
+ *  \brief
+ *      Index of used IP addresses, kept as runs of consecutive addresses,
+ *      so that the first unused address in a range is found in O(log n).
+ */
+//----------------------------------------------------------------------------
+#ifndef __DHCP_SERVER_IP_RUN_H__
+#define __DHCP_SERVER_IP_RUN_H__
+//----------------------------------------------------------------------------
+
+/*
+==============================================================================
+
+    Include File
+
+==============================================================================
+*/
+#include <main_types.h>
+
+/*
+==============================================================================
+
+    Public Function
+
+==============================================================================
+*/
+/**
+ *  \brief
+ *      Initialize the index to have no used IP addresses.
+ *
+ *  \return
+ *      TRUE  : successful.\n
+ *      FALSE : failed.
+ */
+BOOL vtss_dhcp_server_ip_run_init(
+    void
+);
+
+/**
+ *  \brief
+ *      Mark an IP address as used or unused.
+ *      Marking an address that is already in the requested state is a no-op.
+ *
+ *  \param
+ *      ip     [IN]: IP address.
+ *      b_used [IN]: TRUE - used, FALSE - unused.
+ *
+ *  \return
+ *      TRUE  : successful.\n
+ *      FALSE : no free run left.
+ */
+BOOL vtss_dhcp_server_ip_run_set(
+    IN  mesa_ipv4_t     ip,
+    IN  BOOL            b_used
+);
+
+/**
+ *  \brief
+ *      Check if an IP address is marked as used.
+ */
+BOOL vtss_dhcp_server_ip_run_used(
+    IN  mesa_ipv4_t     ip
+);
+
+/**
+ *  \brief
+ *      Get the first unused IP address in [low_ip, high_ip].
+ *
+ *  \return
+ *      * : unused IP address.
+ *      0 : all addresses in the range are used.
+ */
+mesa_ipv4_t vtss_dhcp_server_ip_run_unused_get(
+    IN  mesa_ipv4_t     low_ip,
+    IN  mesa_ipv4_t     high_ip
+);
+
+/**
+ *  \brief
+ *      Get number of runs in the index.
+ */
+u32 vtss_dhcp_server_ip_run_cnt(
+    void
+);
+
+//----------------------------------------------------------------------------
+#endif //__DHCP_SERVER_IP_RUN_H__
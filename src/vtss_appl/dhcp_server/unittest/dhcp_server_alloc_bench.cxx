@@ -0,0 +1,360 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// DISCOVER storm benchmark of the DHCP server's free IP allocation.
+//
+// A number of clients send DISCOVER at the same time, e.g. after a power cut,
+// and each of them is given the lowest free IP of one pool. The bindings and
+// declined IPs are kept in vtss_avl_tree/vtss_free_list stores like in
+// vtss_dhcp_server.cxx, and the free IP is found in two ways:
+//   scan : Every address from the start of the subnet is checked against the
+//          excluded ranges, the declined IPs and the bindings, which is what
+//          _free_ip_get() used to do.
+//   index: The used IP index (vtss_dhcp_server_ip_run.cxx) gives the next
+//          unused address, which is then checked like above.
+// After the storm, random clients release their IP and a new client takes
+// one (churn), which fragments the used addresses. Both methods must hand out
+// the same addresses. Options:
+//   -n <clients>          (default: DHCP_SERVER_BINDING_MAX_CNT - declined)
+//   -p <prefix length>    (default: 16)
+//   -x <excluded addresses at the start of the subnet> (default: 100)
+//   -d <declined IPs>     (default: 16)
+//   -c <churn operations> (default: 10000)
+
+#include "vtss_dhcp_server_type.h"
+#include "vtss_dhcp_server_ip_run.h"
+#include "vtss_avl_tree_api.h"
+#include "vtss_free_list_api.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <vector>
+
+typedef struct {
+    mesa_ipv4_t ip;
+    u32         client;
+} bench_binding_t;
+
+static i32 bench_ip_cmp(void *data_a, void *data_b)
+{
+    mesa_ipv4_t a = *(mesa_ipv4_t *)data_a, b = *(mesa_ipv4_t *)data_b;
+
+    return a > b ? VTSS_AVL_TREE_CMP_RESULT_A_LARGER : a < b ? VTSS_AVL_TREE_CMP_RESULT_A_SMALLER : VTSS_AVL_TREE_CMP_RESULT_A_B_SAME;
+}
+
+static i32 bench_excluded_cmp(void *data_a, void *data_b)
+{
+    return bench_ip_cmp(&((dhcp_server_excluded_ip_t *)data_a)->low_ip, &((dhcp_server_excluded_ip_t *)data_b)->low_ip);
+}
+
+// The IP is the first member of both bench_binding_t and the declined IP
+VTSS_FREE_LIST(g_binding_flist, bench_binding_t, DHCP_SERVER_BINDING_MAX_CNT)
+VTSS_AVL_TREE(g_binding_ip_avlt, "BINDING_IP", 0, bench_ip_cmp, DHCP_SERVER_BINDING_MAX_CNT)
+VTSS_FREE_LIST(g_decline_flist, mesa_ipv4_t, DHCP_SERVER_BINDING_MAX_CNT)
+VTSS_AVL_TREE(g_decline_ip_avlt, "DECLINE_IP", 0, bench_ip_cmp, DHCP_SERVER_BINDING_MAX_CNT)
+VTSS_FREE_LIST(g_excluded_ip_flist, dhcp_server_excluded_ip_t, DHCP_SERVER_EXCLUDED_MAX_CNT)
+VTSS_AVL_TREE(g_excluded_ip_avlt, "EXCLUDED_IP", 0, bench_excluded_cmp, DHCP_SERVER_EXCLUDED_MAX_CNT)
+
+static mesa_ipv4_t bench_net, bench_mask, bench_vlan_ip;
+static u64         bench_lookups;
+
+static bool bench_excluded(mesa_ipv4_t ip, mesa_ipv4_t *high_ip)
+{
+    dhcp_server_excluded_ip_t excluded = {}, *ep = &excluded;
+
+    while (vtss_avl_tree_get(&g_excluded_ip_avlt, (void **)&ep, VTSS_AVL_TREE_GET_NEXT)) {
+        bench_lookups++;
+        if (ip >= ep->low_ip && ip <= ep->high_ip) {
+            *high_ip = ep->high_ip;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool bench_in_tree(vtss_avl_tree_t *tree, mesa_ipv4_t ip)
+{
+    mesa_ipv4_t *ipp = &ip;
+
+    bench_lookups++;
+    return vtss_avl_tree_get(tree, (void **)&ipp, VTSS_AVL_TREE_GET);
+}
+
+// The checks of _ip_is_free() that apply to the benchmark
+static bool bench_ip_is_free(mesa_ipv4_t ip)
+{
+    mesa_ipv4_t high_ip;
+
+    if ((ip & ~bench_mask) == 0 || (ip | bench_mask) == 0xFFFFFFFF || ip == bench_vlan_ip) {
+        return false;
+    }
+
+    return !bench_excluded(ip, &high_ip) && !bench_in_tree(&g_decline_ip_avlt, ip) && !bench_in_tree(&g_binding_ip_avlt, ip);
+}
+
+static mesa_ipv4_t bench_free_ip_scan(void)
+{
+    mesa_ipv4_t ip, high_ip, last_ip = bench_net | ~bench_mask;
+
+    for (ip = bench_net; ip < last_ip; ip++) {
+        if (bench_excluded(ip, &high_ip)) {
+            ip = high_ip;
+            continue;
+        }
+
+        if (bench_ip_is_free(ip)) {
+            return ip;
+        }
+    }
+
+    return 0;
+}
+
+static mesa_ipv4_t bench_free_ip_index(void)
+{
+    mesa_ipv4_t ip = bench_net + 1, high_ip = (bench_net | ~bench_mask) - 1, excluded_high_ip;
+
+    while (ip <= high_ip) {
+        bench_lookups++;
+        if ((ip = vtss_dhcp_server_ip_run_unused_get(ip, high_ip)) == 0) {
+            break;
+        }
+
+        if (bench_excluded(ip, &excluded_high_ip)) {
+            if (excluded_high_ip >= high_ip) {
+                break;
+            }
+            ip = excluded_high_ip + 1;
+            continue;
+        }
+
+        if (bench_ip_is_free(ip)) {
+            return ip;
+        }
+
+        if (ip == high_ip) {
+            break;
+        }
+        ip++;
+    }
+
+    return 0;
+}
+
+static bool bench_binding_add(mesa_ipv4_t ip, u32 client)
+{
+    bench_binding_t *bp = (bench_binding_t *)vtss_free_list_malloc(&g_binding_flist);
+
+    if (!bp) {
+        return false;
+    }
+
+    bp->ip = ip;
+    bp->client = client;
+    if (!vtss_avl_tree_add(&g_binding_ip_avlt, bp)) {
+        vtss_free_list_free(&g_binding_flist, bp);
+        return false;
+    }
+
+    return vtss_dhcp_server_ip_run_set(ip, TRUE);
+}
+
+static void bench_binding_del(mesa_ipv4_t ip)
+{
+    mesa_ipv4_t *ipp = &ip;
+
+    if (vtss_avl_tree_delete(&g_binding_ip_avlt, (void **)&ipp)) {
+        vtss_free_list_free(&g_binding_flist, ipp);
+        (void)vtss_dhcp_server_ip_run_set(ip, bench_in_tree(&g_decline_ip_avlt, ip));
+    }
+}
+
+static bool bench_init(u32 excluded_cnt, u32 declined_cnt)
+{
+    dhcp_server_excluded_ip_t *ep;
+    mesa_ipv4_t               *ipp;
+    u32                       i;
+
+    if (!vtss_free_list_init(&g_binding_flist) || !vtss_avl_tree_init(&g_binding_ip_avlt) ||
+        !vtss_free_list_init(&g_decline_flist) || !vtss_avl_tree_init(&g_decline_ip_avlt) ||
+        !vtss_free_list_init(&g_excluded_ip_flist) || !vtss_avl_tree_init(&g_excluded_ip_avlt) ||
+        !vtss_dhcp_server_ip_run_init()) {
+        return false;
+    }
+
+    if (excluded_cnt) {
+        if ((ep = (dhcp_server_excluded_ip_t *)vtss_free_list_malloc(&g_excluded_ip_flist)) == NULL) {
+            return false;
+        }
+        ep->low_ip  = bench_net + 1;
+        ep->high_ip = bench_net + excluded_cnt;
+        if (!vtss_avl_tree_add(&g_excluded_ip_avlt, ep)) {
+            return false;
+        }
+    }
+
+    // Declined IPs spread over the first part of the subnet
+    srand(1);
+    for (i = 0; i < declined_cnt; i++) {
+        if ((ipp = (mesa_ipv4_t *)vtss_free_list_malloc(&g_decline_flist)) == NULL) {
+            return false;
+        }
+        *ipp = bench_net + excluded_cnt + 1 + (rand() % (4 * DHCP_SERVER_BINDING_MAX_CNT));
+        if (!vtss_avl_tree_add(&g_decline_ip_avlt, ipp)) {
+            vtss_free_list_free(&g_decline_flist, ipp);
+            continue;
+        }
+        if (!vtss_dhcp_server_ip_run_set(*ipp, TRUE)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+typedef mesa_ipv4_t (*bench_free_ip_t)(void);
+
+// Runs the storm and the churn with one method and returns the IPs handed out
+static bool bench_run(const char *name, bench_free_ip_t free_ip, u32 client_cnt, u32 churn_cnt, std::vector<mesa_ipv4_t> &ips)
+{
+    std::vector<mesa_ipv4_t> client_ip(client_cnt);
+    mesa_ipv4_t              ip;
+    u32                      i, client;
+    double                   storm_ms, churn_ms;
+    u64                      storm_lookups;
+
+    bench_lookups = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (i = 0; i < client_cnt; i++) {
+        if ((ip = free_ip()) == 0 || !bench_binding_add(ip, i)) {
+            fprintf(stderr, "%s: no free IP for client %u\n", name, i);
+            return false;
+        }
+        client_ip[i] = ip;
+        ips.push_back(ip);
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+    storm_lookups = bench_lookups;
+    bench_lookups = 0;
+
+    srand(2);
+    for (i = 0; i < churn_cnt; i++) {
+        client = rand() % client_cnt;
+        bench_binding_del(client_ip[client]);
+        if ((ip = free_ip()) == 0 || !bench_binding_add(ip, client)) {
+            fprintf(stderr, "%s: no free IP in churn %u\n", name, i);
+            return false;
+        }
+        client_ip[client] = ip;
+        ips.push_back(ip);
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+    storm_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    churn_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    printf("%-6s %10.2f %14.2f %14.1f %10.2f %14.2f %14.1f %6u\n", name,
+           storm_ms, storm_ms * 1000 / client_cnt, (double)storm_lookups / client_cnt,
+           churn_ms, churn_cnt ? churn_ms * 1000 / churn_cnt : 0, churn_cnt ? (double)bench_lookups / churn_cnt : 0,
+           vtss_dhcp_server_ip_run_cnt());
+
+    for (i = 0; i < client_cnt; i++) {
+        bench_binding_del(client_ip[i]);
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<mesa_ipv4_t> scan_ips, index_ips;
+    u32                      client_cnt = 0, prefix = 16, excluded_cnt = 100, declined_cnt = 16, churn_cnt = 10000;
+    int                      opt;
+
+    while ((opt = getopt(argc, argv, "n:p:x:d:c:")) != -1) {
+        switch (opt) {
+        case 'n':
+            client_cnt = atoi(optarg);
+            break;
+        case 'p':
+            prefix = atoi(optarg);
+            break;
+        case 'x':
+            excluded_cnt = atoi(optarg);
+            break;
+        case 'd':
+            declined_cnt = atoi(optarg);
+            break;
+        case 'c':
+            churn_cnt = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n clients] [-p prefix length] [-x excluded] [-d declined] [-c churn]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (declined_cnt > DHCP_SERVER_BINDING_MAX_CNT) {
+        declined_cnt = DHCP_SERVER_BINDING_MAX_CNT;
+    }
+
+    if (client_cnt == 0 || client_cnt > DHCP_SERVER_BINDING_MAX_CNT) {
+        client_cnt = DHCP_SERVER_BINDING_MAX_CNT - declined_cnt;
+    }
+
+    if (prefix < 8 || prefix > 30) {
+        fprintf(stderr, "Prefix length must be 8-30\n");
+        return 1;
+    }
+
+    bench_mask    = 0xFFFFFFFF << (32 - prefix);
+    bench_net     = 0x0A000000 & bench_mask;
+    bench_vlan_ip = bench_net + 1;
+
+    if (!bench_init(excluded_cnt, declined_cnt)) {
+        fprintf(stderr, "Initialization failed\n");
+        return 1;
+    }
+
+    printf("/%u pool, %u clients, %u excluded, %u declined, %u churn operations\n", prefix, client_cnt, excluded_cnt, declined_cnt, churn_cnt);
+    printf("%-6s %10s %14s %14s %10s %14s %14s %6s\n", "Method", "Storm [ms]", "us/DISCOVER", "Lookups/DISC.", "Churn [ms]", "us/DISCOVER", "Lookups/DISC.", "Runs");
+
+    if (!bench_run("scan", bench_free_ip_scan, client_cnt, churn_cnt, scan_ips) ||
+        !bench_run("index", bench_free_ip_index, client_cnt, churn_cnt, index_ips)) {
+        return 1;
+    }
+
+    if (scan_ips != index_ips) {
+        fprintf(stderr, "Error: The two methods handed out different IPs\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -36,6 +36,8 @@
 #include "subject.hxx"
 
 #include "fast_cgi_api.hxx"
+#include "fast_cgi_api.h"
+#include "chrono.hxx"
 #include "vtss_https.hxx"
 #include "vtss_https_api.hxx"
 #include "vtss_https_icfg.hxx"
@@ -60,7 +62,7 @@
 #define VTSS_ALLOC_MODULE_ID VTSS_MODULE_ID_FAST_CGI
 
 web_handler_t *web_root;
-CYG_HTTPD_STATE httpstate;
+static thread_local CYG_HTTPD_STATE *fast_cgi_httpstate;
 static vtss_trace_reg_t trace_reg = {
     VTSS_TRACE_MODULE_ID, "fast_cgi", "fast_cgi"
 };
@@ -85,75 +87,142 @@ static vtss_trace_grp_t trace_grps[] = {
 
 VTSS_TRACE_REGISTER(&trace_reg, trace_grps);
 
-static vtss_handle_t fast_cgi_thread_handle;
-static vtss_thread_t fast_cgi_thread_block;
+#define FAST_CGI_WORKERS_DEFAULT 4
+
+#define FAST_CGI_CRIT_ENTER() critd_enter(&fast_cgi_crit, __FUNCTION__, __LINE__)
+#define FAST_CGI_CRIT_EXIT()  critd_exit( &fast_cgi_crit, __FUNCTION__, __LINE__)
+
+// Per-thread state of a FastCGI worker
+typedef struct {
+    FCGX_Request    request;
+    CYG_HTTPD_STATE state;
+    uint64_t        bytes_out; // Bytes written by the handler of the current request
+} FAST_CGI_worker_t;
+
+// Node in the handler router, which is a character trie of handler paths.
+typedef struct {
+    char          c;       // Last character of the path leading to this node
+    uint32_t      child;   // First child or 0 if none
+    uint32_t      sibling; // Next sibling or 0 if none
+    web_handler_t *exact;  // Handler matching this path exactly
+    web_handler_t *fs_like; // File-system-like handler of this path
+} FAST_CGI_route_t;
+
+static vtss_handle_t fast_cgi_thread_handle[FAST_CGI_WORKERS_MAX];
+static vtss_thread_t fast_cgi_thread_block[FAST_CGI_WORKERS_MAX];
+static char          fast_cgi_thread_name[FAST_CGI_WORKERS_MAX][16];
+static uint32_t      fast_cgi_worker_cnt;
+static int           fast_cgi_sock;
 static bool web_handlers_enabled;
 
+static thread_local FAST_CGI_worker_t *fast_cgi_worker;
+
+// Built in INIT_CMD_START, when all handlers have registered themselves, and
+// read-only afterwards.
+static vtss::Vector<FAST_CGI_route_t> fast_cgi_router;
+
+// Protects fast_cgi_statistics
+static critd_t fast_cgi_crit;
+static fast_cgi_statistics_t fast_cgi_statistics;
+
+// The web handlers were written for a server serving one request at a time and
+// may keep state in static variables, so they are called with this held. JSON
+// handlers run concurrently.
+static vtss_mutex_t fast_cgi_web_mutex;
+
 vtss::notifications::ProcessDaemon vtss_process_hiawatha(&vtss::notifications::subject_main_thread, "hiawatha");
 
-static web_handler_t *FAST_CGI_find_handler(const char *path)
+static uint32_t FAST_CGI_router_child(uint32_t node, char c, bool create)
 {
-    web_handler_t *h, *best_handler;
-    size_t        best_len;
-    bool          fs_like_match_found = false;
+    uint32_t         idx;
+    FAST_CGI_route_t r = {};
 
-    T_D("Searching for handler for %s", path);
+    for (idx = fast_cgi_router[node].child; idx; idx = fast_cgi_router[idx].sibling) {
+        if (fast_cgi_router[idx].c == c) {
+            return idx;
+        }
+    }
+
+    if (!create) {
+        return 0;
+    }
+
+    r.c       = c;
+    r.sibling = fast_cgi_router[node].child;
+    idx       = fast_cgi_router.size();
+    fast_cgi_router.push_back(r);
+    fast_cgi_router[node].child = idx;
+    return idx;
+}
+
+static void FAST_CGI_router_build(void)
+{
+    web_handler_t    *h;
+    FAST_CGI_route_t root = {};
+    const char       *c;
+    uint32_t         node;
+
+    fast_cgi_router.clear();
+    fast_cgi_router.push_back(root);
 
     for (h = web_root; h; h = h->next) {
         if (!h->json && !web_handlers_enabled) {
             // Skip web handlers
-        } else if (h->fs_like_match) {
-            // If we don't find an exact match, do the
-            // file-system-like matching below.
-            fs_like_match_found = true;
-        } else if (strcmp(h->path, path) == 0) {
-            T_D("Exact match for %s found", path);
-            return h;
+            continue;
         }
-    }
 
-    if (!fs_like_match_found) {
-        // No need to go through the below stuff, since there
-        // are no handlers that are file-system like.
-        T_D("No exact match for %s found, and there's no file system like handlers", path);
-        return NULL;
+        for (node = 0, c = h->path; *c; c++) {
+            node = FAST_CGI_router_child(node, *c, true);
+        }
+
+        // In case of duplicates, the first one in web_root wins.
+        if (h->fs_like_match) {
+            if (!fast_cgi_router[node].fs_like) {
+                fast_cgi_router[node].fs_like = h;
+            }
+        } else if (!fast_cgi_router[node].exact) {
+            fast_cgi_router[node].exact = h;
+        }
     }
 
-    // Search through all handlers that have the fs_like_match flag set and
-    // find the one with the longest match (don't just stop at the first handler
-    // that matches). In this way, we can have a handler for e.g. "/a/<anything>",
-    // but a more specific handler for "/a/b/<anything>".
-    best_len = 0;
-    best_handler = NULL;
-    for (h = web_root; h; h = h->next) {
-        size_t len;
+    T_I("%zu nodes", fast_cgi_router.size());
+}
 
-        if (!h->fs_like_match) {
-            continue;
-        }
+static web_handler_t *FAST_CGI_find_handler(const char *path)
+{
+    web_handler_t *best_handler = NULL;
+    uint32_t      node = 0;
+    size_t        len;
 
-        len = strlen(h->path);
+    T_D("Searching for handler for %s", path);
 
-        if (strncmp(h->path, path, len) != 0) {
-            continue;
+    if (fast_cgi_router.empty()) {
+        return NULL;
+    }
+
+    // Walk the path through the trie. An exact match wins, and otherwise the
+    // longest file-system-like match. In this way, we can have a handler for
+    // e.g. "/a/<anything>", but a more specific handler for "/a/b/<anything>".
+    for (len = 0; ; len++) {
+        const FAST_CGI_route_t &r = fast_cgi_router[node];
+
+        // If the handler hasn't specified a slash at the end of its path, the
+        // URL must either end here or continue with a slash.
+        if (r.fs_like && len && (path[len - 1] == '/' || path[len] == '\0' || path[len] == '/')) {
+            best_handler = r.fs_like;
         }
 
-        // Candidate found. If the handler hasn't specified a slash
-        // at the end of its path, we must check that as well.
-        if (h->path[len - 1] != '/') {
-            if (strlen(path) != len && path[len] != '/') {
-                // Not an exact match and the URL didn't end with a slash as well.
-                continue;
+        if (path[len] == '\0') {
+            if (r.exact) {
+                T_D("Exact match for %s found", path);
+                return r.exact;
             }
 
-            len++;
+            break;
         }
 
-
-        // See if this candidate is better than any previously found.
-        if (len > best_len) {
-            best_len = len;
-            best_handler = h;
+        if ((node = FAST_CGI_router_child(node, path[len], false)) == 0) {
+            break;
         }
     }
 
@@ -265,7 +334,13 @@ static bool FAST_CGI_web_request(FCGX_Request *request, CYG_HTTPD_STATE *state,
 
     FAST_CGI_setup_request(request, state, path);
 
-    h->h(state);  // Call handler
+    if (h->json) {
+        h->h(state);  // Call handler
+    } else {
+        vtss_mutex_lock(&fast_cgi_web_mutex);
+        h->h(state);  // Call handler
+        vtss_mutex_unlock(&fast_cgi_web_mutex);
+    }
 
     if (state->post_data) {
         VTSS_FREE(state->post_data);
@@ -274,87 +349,151 @@ static bool FAST_CGI_web_request(FCGX_Request *request, CYG_HTTPD_STATE *state,
     return true;
 }
 
+static ssize_t FAST_CGI_out(ssize_t len)
+{
+    if (len > 0 && fast_cgi_worker) {
+        fast_cgi_worker->bytes_out += len;
+    }
+
+    return len;
+}
+
+// Returns the output stream of the request served by the calling thread.
+static FCGX_Stream *FAST_CGI_stream(void)
+{
+    if (!fast_cgi_httpstate || !fast_cgi_httpstate->request) {
+        T_E("Not called from a FastCGI worker");
+        return nullptr;
+    }
+
+    return fast_cgi_httpstate->request->out;
+}
+
+static void FAST_CGI_finish(void)
+{
+    if (FAST_CGI_stream()) {
+        FCGX_Finish_r(fast_cgi_httpstate->request);
+    }
+}
+
+CYG_HTTPD_STATE *cyg_httpd_state_get(void)
+{
+    return fast_cgi_httpstate;
+}
+
+CYG_HTTPD_STATE *cyg_httpd_state_set(CYG_HTTPD_STATE *state)
+{
+    CYG_HTTPD_STATE *prev = fast_cgi_httpstate;
+
+    fast_cgi_httpstate = state;
+    return prev;
+}
+
 ssize_t cyg_httpd_write(char *buf, int buf_len)
 {
-    return FCGX_PutStr(buf, buf_len, httpstate.request->out);
+    FCGX_Stream *out = FAST_CGI_stream();
+
+    return out ? FAST_CGI_out(FCGX_PutStr(buf, buf_len, out)) : -1;
 }
 
 ssize_t cyg_httpd_start_chunked(const char *extension)
 {
-    return FCGX_FPrintF(httpstate.request->out,
-                        "Content-type: text/%s"
-                        HTTP_HEADER_END_MARKER,
-                        extension);
+    FCGX_Stream *out = FAST_CGI_stream();
+
+    return out ? FAST_CGI_out(FCGX_FPrintF(out,
+                                           "Content-type: text/%s"
+                                           HTTP_HEADER_END_MARKER,
+                                           extension)) : -1;
 }
 
 void cyg_httpd_end_chunked(void)
 {
-    FCGX_Finish_r(httpstate.request);
+    FAST_CGI_finish();
 }
 
 ssize_t cyg_httpd_write_chunked(const char *buf, int len)
 {
-    return FCGX_PutStr(buf, len, httpstate.request->out);
+    FCGX_Stream *out = FAST_CGI_stream();
+
+    return out ? FAST_CGI_out(FCGX_PutStr(buf, len, out)) : -1;
 }
 
 void cyg_httpd_send_error(i32 err_type)
 {
+    FCGX_Stream *out = FAST_CGI_stream();
+
+    if (!out) {
+        return;
+    }
+
     switch (err_type) {
     case CYG_HTTPD_STATUS_MOVED_TEMPORARILY:
-        FCGX_FPrintF(httpstate.request->out,
+        FCGX_FPrintF(out,
                      "Location: %s"
                      HTTP_HEADER_END_MARKER,
-                     httpstate.url);
+                     fast_cgi_httpstate->url);
         break;
 
     case CYG_HTTPD_STATUS_BAD_REQUEST:
-        FCGX_FPrintF(httpstate.request->out,
+        FCGX_FPrintF(out,
                      "Status: 400 Bad Request"
                      HTTP_HEADER_END_MARKER);
         break;
 
     case CYG_HTTPD_STATUS_NOT_FOUND:
-        FCGX_FPrintF(httpstate.request->out,
+        FCGX_FPrintF(out,
                      "Status: 404 Not Found"
                      HTTP_HEADER_END_MARKER);
         break;
 
     case CYG_HTTPD_STATUS_SYSTEM_ERROR:
-        FCGX_FPrintF(httpstate.request->out,
+        FCGX_FPrintF(out,
                      "Status: 500 Internal Server Error"
                      HTTP_HEADER_END_MARKER);
         break;
 
     default:
-        FCGX_FPrintF(httpstate.request->out,
+        FCGX_FPrintF(out,
                      "Status: %d"
                      HTTP_HEADER_END_MARKER,
                      err_type);
         break;
     }
-    FCGX_Finish_r(httpstate.request);
+    FAST_CGI_finish();
 }
 
 void cyg_httpd_send_content_disposition(cyg_httpd_ires_table_entry *entry)
 {
-    FCGX_FPrintF(httpstate.request->out,
+    FCGX_Stream *out = FAST_CGI_stream();
+
+    if (!out) {
+        return;
+    }
+
+    FCGX_FPrintF(out,
                  "Content-Type: application/x-download"
                  HTTP_HEADER_LINE_TRAILER
                  "Content-disposition: attachment; filename=\"%s\"; size=%u"
                  HTTP_HEADER_END_MARKER,
                  entry->f_pname,
                  entry->f_size);
-    FCGX_PutStr((char *)entry->f_ptr, entry->f_size, httpstate.request->out);
+    (void)FAST_CGI_out(FCGX_PutStr((char *)entry->f_ptr, entry->f_size, out));
 }
 
 void cyg_httpd_set_xreadonly_tag(int status)
 {
+    FCGX_Stream *out = FAST_CGI_stream();
+
+    if (!out) {
+        return;
+    }
+
     if (status) {
-        FCGX_FPrintF(httpstate.request->out,
+        FCGX_FPrintF(out,
                      "X-ReadOnly: true"
                      HTTP_HEADER_LINE_TRAILER);
     } else {
-        FCGX_FPrintF(httpstate.request->out,
+        FCGX_FPrintF(out,
                      "X-ReadOnly: null"
                      HTTP_HEADER_LINE_TRAILER);
     }
@@ -362,13 +501,18 @@ void cyg_httpd_set_xreadonly_tag(int status)
 
 int cyg_httpd_current_privilege_level()
 {
-    return httpstate.auth_lvl;
+    return fast_cgi_httpstate ? fast_cgi_httpstate->auth_lvl : -1;
 }
 
-void cyg_httpd_current_username(char *username, size_t username_max_len)
+bool cyg_httpd_current_username(char *username, size_t username_max_len)
 {
     memset(username, 0, username_max_len);
-    strncpy(username, httpstate.auth_name, username_max_len);
+    if (!fast_cgi_httpstate) {
+        return false;
+    }
+
+    strncpy(username, fast_cgi_httpstate->auth_name, username_max_len);
+    return true;
 }
 
 #ifdef VTSS_SW_OPTION_AUTH
@@ -427,130 +571,231 @@ static bool FAST_CGI_authenticate(FCGX_Request *req, CYG_HTTPD_STATE *state)
 }
 #endif
 
+// Returns true if a handler was found for the request.
+static bool FAST_CGI_serve(FAST_CGI_worker_t *w)
+{
+    FCGX_Request    *request = &w->request;
+    CYG_HTTPD_STATE *state   = &w->state;
+    BOOL            b_redirect;
+
+    VTSS_TRACE(NOISE) << "Fast-CGI Request:";
+    char **e = request->envp;
+    while (*e) {
+        VTSS_TRACE(NOISE) << "    " << *e;
+        e++;
+    }
+
+    const char *script      = FCGX_GetParam("SCRIPT_NAME", request->envp);
+    const char *http_scheme = FCGX_GetParam("HTTP_SCHEME", request->envp);
+    const char *http_host   = FCGX_GetParam("HTTP_HOST",   request->envp);
+    const char *request_uri = FCGX_GetParam("REQUEST_URI", request->envp);
+
+    // Bugzilla#19826
+    if (!script) {
+        script = "";
+    }
+    if (!http_scheme) {
+        http_scheme = "";
+    }
+    if (!http_host) {
+        http_host = "";
+    }
+    if (!request_uri) {
+        request_uri = "";
+    }
+
+    // Redirect http to https if it is enabled, equivalent as
+    // RequireSSL=yes in hiawatha.conf
+    // redirect can NOT be enabled if https server is not enabled
+    // NOTE: redirect has to be done before the authentication!!!
+    HTTPS_CRIT_ENTER();
+    b_redirect = global_hiawatha_conf.redirect;
+    HTTPS_CRIT_EXIT();
+
+    if ( b_redirect &&
+         http_scheme && (strcmp("https", http_scheme) != 0)) {
+        if (http_host[0] == '\0') {
+            FCGX_FPrintF(request->out,
+                         "Status: 404 Not found"
+                         HTTP_HEADER_LINE_TRAILER
+                         "Content-type: text/html"
+                         HTTP_HEADER_END_MARKER);
+        } else {
+            VTSS_TRACE(NOISE) << "    " << "REDIRECT HTTP TO HTTPS";
+            FCGX_FPrintF(request->out,
+                         "Location: https://%s%s"
+                         HTTP_HEADER_END_MARKER,
+                         http_host,
+                         request_uri);
+        }
+        return true;
+    }
+    // RequireSSL=yes security check ends //
+
+    // Landing page after logout - does not require authentication
+    if (script && strcmp("/logout.htm", script) == 0) {
+        FCGX_FPrintF(request->out,
+                     "Content-type: text/html"
+                     HTTP_HEADER_END_MARKER
+                     "<title>Logout</title>"
+                     "<h1><a href=\"/login.htm\">Go to login!</a></h1>\n");
+        return true;
+    }
+
+#ifdef VTSS_SW_OPTION_AUTH
+    // Check authentication or return 401.
+    if (!FAST_CGI_authenticate(request, state)) {
+        FCGX_FPrintF(request->out,
+                     "Status: 401 Unauthorized"
+                     HTTP_HEADER_LINE_TRAILER
+                     "WWW-Authenticate: Basic realm=\"WebStaX\""
+                     HTTP_HEADER_LINE_TRAILER
+                     "Content-type: text/html"
+                     HTTP_HEADER_END_MARKER);
+        return true;
+    }
+#endif
+    VTSS_TRACE(INFO) << "Fast-CGI Authenticated";
+
+    if (script && strcmp("/login.htm", script) == 0) {
+        // Redirect to the page with the "real" content
+        FCGX_FPrintF(request->out,
+                     "Location: index.htm"
+                     HTTP_HEADER_END_MARKER);
+    } else if (script && strcmp("/logout", script) == 0) {
+        FCGX_FPrintF(request->out,
+                     "Content-type: text/html"
+                     HTTP_HEADER_END_MARKER);
+    } else if (FAST_CGI_web_request(request, state, script)) {
+        // Handled request
+    } else {
+        FCGX_FPrintF(request->out,
+                     "Status: 404 Not found"
+                     HTTP_HEADER_LINE_TRAILER
+                     "Content-type: text/html"
+                     HTTP_HEADER_END_MARKER);
+        return false;
+    }
+
+    return true;
+}
+
+static void FAST_CGI_statistics_update(FAST_CGI_worker_t *w, uint64_t latency_us, bool found)
+{
+    uint64_t ms = latency_us / 1000, limit = 1;
+    uint32_t bucket = 0;
+
+    while (bucket < FAST_CGI_LATENCY_BUCKET_CNT - 1 && ms >= limit) {
+        bucket++;
+        limit *= 4;
+    }
+
+    FAST_CGI_CRIT_ENTER();
+    fast_cgi_statistics.busy--;
+    fast_cgi_statistics.requests++;
+    if (!found) {
+        fast_cgi_statistics.not_found++;
+    }
+    fast_cgi_statistics.bytes_in  += w->state.content_len;
+    fast_cgi_statistics.bytes_out += w->bytes_out;
+    fast_cgi_statistics.latency_us_sum += latency_us;
+    if (latency_us > fast_cgi_statistics.latency_us_max) {
+        fast_cgi_statistics.latency_us_max = latency_us;
+    }
+    fast_cgi_statistics.latency_hist[bucket]++;
+    FAST_CGI_CRIT_EXIT();
+}
+
+static void FAST_CGI_worker_thread(vtss_addrword_t data)
+{
+    FAST_CGI_worker_t *w;
+    uint64_t          start;
+    bool              found;
+
+    if ((w = (FAST_CGI_worker_t *)VTSS_CALLOC(1, sizeof(*w))) == NULL) {
+        T_E("Unable to allocate worker %u", (uint32_t)(uintptr_t)data);
+        return;
+    }
+
+    fast_cgi_worker    = w;
+    fast_cgi_httpstate = &w->state;
+
+    FCGX_InitRequest(&w->request, fast_cgi_sock, 0);
+
+    while (FCGX_Accept_r(&w->request) >= 0) {
+        start                = vtss::uptime_microseconds();
+        w->bytes_out         = 0;
+        w->state.content_len = 0;
+
+        FAST_CGI_CRIT_ENTER();
+        if (++fast_cgi_statistics.busy > fast_cgi_statistics.busy_max) {
+            fast_cgi_statistics.busy_max = fast_cgi_statistics.busy;
+        }
+        FAST_CGI_CRIT_EXIT();
+
+        found = FAST_CGI_serve(w);
+        FCGX_Finish_r(&w->request);
+
+        FAST_CGI_statistics_update(w, vtss::uptime_microseconds() - start, found);
+    }
+
+    T_W("Worker %u: Accept failed", (uint32_t)(uintptr_t)data);
+}
+
+// Opens the socket towards hiawatha, starts the other workers, and becomes the
+// first worker itself.
 static void FAST_CGI_accept_loop(vtss_addrword_t data)
 {
-    int sock;
-    FCGX_Request request;
     const char *sockname = "/tmp/json.socket";
-    BOOL b_redirect;
+    uint32_t   i;
 
     if (FCGX_Init()) {
         T_W("init failed");
         return;
     }
 
-    if ((sock = FCGX_OpenSocket(sockname, 10)) < 0) {
+    if ((fast_cgi_sock = FCGX_OpenSocket(sockname, 10)) < 0) {
         T_W("socket open");
         return;
     }
 
     (void)chmod(sockname, 0777);
 
-    FCGX_InitRequest(&request, sock, 0);
-
-    while (FCGX_Accept_r(&request) >= 0) {
-        VTSS_TRACE(NOISE) << "Fast-CGI Request:";
-        char **e = request.envp;
-        while (*e) {
-            VTSS_TRACE(NOISE) << "    " << *e;
-            e++;
-        }
-
-        const char *script      = FCGX_GetParam("SCRIPT_NAME", request.envp);
-        const char *http_scheme = FCGX_GetParam("HTTP_SCHEME", request.envp);
-        const char *http_host   = FCGX_GetParam("HTTP_HOST",   request.envp);
-        const char *request_uri = FCGX_GetParam("REQUEST_URI", request.envp);
-
-        // Bugzilla#19826
-        if (!script) {
-            script = "";
-        }
-        if (!http_scheme) {
-            http_scheme = "";
-        }
-        if (!http_host) {
-            http_host = "";
-        }
-        if (!request_uri) {
-            request_uri = "";
-        }
+    for (i = 1; i < fast_cgi_worker_cnt; i++) {
+        snprintf(fast_cgi_thread_name[i], sizeof(fast_cgi_thread_name[i]), "Fast CGI %u", i);
+        vtss_thread_create(VTSS_THREAD_PRIO_DEFAULT,
+                           FAST_CGI_worker_thread,
+                           (vtss_addrword_t)(uintptr_t)i,
+                           fast_cgi_thread_name[i],
+                           nullptr,
+                           0,
+                           &fast_cgi_thread_handle[i],
+                           &fast_cgi_thread_block[i]);
+    }
 
-        // Redirect http to https if it is enabled, equivalent as
-        // RequireSSL=yes in hiawatha.conf
-        // redirect can NOT be enabled if https server is not enabled
-        // NOTE: redirect has to be done before the authentication!!!
-        HTTPS_CRIT_ENTER();
-        b_redirect = global_hiawatha_conf.redirect;
-        HTTPS_CRIT_EXIT();
-
-        if ( b_redirect &&
-             http_scheme && (strcmp("https", http_scheme) != 0)) {
-            if (http_host[0] == '\0') {
-                FCGX_FPrintF(request.out,
-                             "Status: 404 Not found"
-                             HTTP_HEADER_LINE_TRAILER
-                             "Content-type: text/html"
-                             HTTP_HEADER_END_MARKER);
-            } else {
-                VTSS_TRACE(NOISE) << "    " << "REDIRECT HTTP TO HTTPS";
-                FCGX_FPrintF(request.out,
-                             "Location: https://%s%s"
-                             HTTP_HEADER_END_MARKER,
-                             http_host,
-                             request_uri);
-            }
-            FCGX_Finish_r(&request);
-            continue;
-        }
-        // RequireSSL=yes security check ends //
+    FAST_CGI_worker_thread(0);
+}
 
-        // Landing page after logout - does not require authentication
-        if (script && strcmp("/logout.htm", script) == 0) {
-            FCGX_FPrintF(request.out,
-                         "Content-type: text/html"
-                         HTTP_HEADER_END_MARKER
-                         "<title>Logout</title>"
-                         "<h1><a href=\"/login.htm\">Go to login!</a></h1>\n");
-            FCGX_Finish_r(&request);
-            continue;
-        }
+void fast_cgi_statistics_get(fast_cgi_statistics_t *statistics)
+{
+    if (!statistics) {
+        return;
+    }
 
-#ifdef VTSS_SW_OPTION_AUTH
-        // Check authentication or return 401.
-        if (!FAST_CGI_authenticate(&request, &httpstate)) {
-            FCGX_FPrintF(request.out,
-                         "Status: 401 Unauthorized"
-                         HTTP_HEADER_LINE_TRAILER
-                         "WWW-Authenticate: Basic realm=\"WebStaX\""
-                         HTTP_HEADER_LINE_TRAILER
-                         "Content-type: text/html"
-                         HTTP_HEADER_END_MARKER);
-            FCGX_Finish_r(&request);
-            continue;
-        }
-#endif
-        VTSS_TRACE(INFO) << "Fast-CGI Authenticated";
+    FAST_CGI_CRIT_ENTER();
+    *statistics = fast_cgi_statistics;
+    FAST_CGI_CRIT_EXIT();
+    statistics->workers = fast_cgi_worker_cnt;
+}
 
-        if (script && strcmp("/login.htm", script) == 0) {
-            // Redirect to the page with the "real" content
-            FCGX_FPrintF(request.out,
-                         "Location: index.htm"
-                         HTTP_HEADER_END_MARKER);
-        } else if (script && strcmp("/logout", script) == 0) {
-            FCGX_FPrintF(request.out,
-                         "Content-type: text/html"
-                         HTTP_HEADER_END_MARKER);
-        } else if (FAST_CGI_web_request(&request, &httpstate, script)) {
-            // Handled request
-        } else {
-            FCGX_FPrintF(request.out,
-                         "Status: 404 Not found"
-                         HTTP_HEADER_LINE_TRAILER
-                         "Content-type: text/html"
-                         HTTP_HEADER_END_MARKER);
-        }
-        FCGX_Finish_r(&request);
-    }
+void fast_cgi_statistics_clear(void)
+{
+    FAST_CGI_CRIT_ENTER();
+    // Requests in progress are still to be accounted for
+    uint32_t busy = fast_cgi_statistics.busy;
+    vtss_clear(fast_cgi_statistics);
+    fast_cgi_statistics.busy = busy;
+    FAST_CGI_CRIT_EXIT();
 }
 
 #ifdef VTSS_SW_OPTION_PRIVATE_MIB
@@ -574,6 +819,8 @@ extern "C" mesa_rc vtss_fast_cgi_init(vtss_init_data_t *data)
     if (data->cmd == INIT_CMD_INIT) {
         /* Init critd for https, register under FAST_CGI(Linux) */
         critd_init(&https_crit, "https", VTSS_MODULE_ID_FAST_CGI, CRITD_TYPE_MUTEX);
+        critd_init(&fast_cgi_crit, "fast_cgi", VTSS_MODULE_ID_FAST_CGI, CRITD_TYPE_MUTEX);
+        vtss_mutex_init(&fast_cgi_web_mutex);
         web_enabled = vtss::appl::main::module_enabled("web");
     }
 
@@ -638,21 +885,24 @@ extern "C" mesa_rc vtss_fast_cgi_init(vtss_init_data_t *data)
         break;
 
     case INIT_CMD_START:
+        {
+            // Check if web handlers are enabled and how many requests to serve
+            // in parallel
+            auto &c = vtss::appl::main::module_conf_get("web");
+            web_handlers_enabled = c.bool_get("handlers", true);
+            fast_cgi_worker_cnt  = MIN(MAX(c.u32_get("fast_cgi_workers", FAST_CGI_WORKERS_DEFAULT), 1), FAST_CGI_WORKERS_MAX);
+        }
+
+        FAST_CGI_router_build();
+
         vtss_thread_create(VTSS_THREAD_PRIO_DEFAULT,
                            FAST_CGI_accept_loop,
                            0,
                            "Fast CGI",
                            nullptr,
                            0,
-                           &fast_cgi_thread_handle,
-                           &fast_cgi_thread_block);
-
-        {
-            // Check if web handlers are enabled
-            auto &c = vtss::appl::main::module_conf_get("web");
-            web_handlers_enabled = c.bool_get("handlers", true);
-        }
-
+                           &fast_cgi_thread_handle[0],
+                           &fast_cgi_thread_block[0]);
         break;
 
     case INIT_CMD_CONF_DEF: {
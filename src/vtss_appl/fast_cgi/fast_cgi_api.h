@@ -32,4 +32,54 @@
 extern "C" mesa_rc vtss_fast_cgi_init(vtss_init_data_t *data);
 bool web_module_enabled(void) ;
 
+// Upper limit of the number of FastCGI worker threads. The actual number is
+// read from the "fast_cgi_workers" key of the "web" module configuration.
+#define FAST_CGI_WORKERS_MAX 16
+
+// Request latency buckets: Below 1, 4, 16, 64, 256, 1024, 4096 ms and the rest.
+#define FAST_CGI_LATENCY_BUCKET_CNT 8
+
+typedef struct {
+    uint32_t workers;                                   // Number of worker threads
+    uint32_t busy;                                      // Workers currently serving a request
+    uint32_t busy_max;                                  // Most workers ever busy at the same time
+    uint64_t requests;                                  // Requests served
+    uint64_t not_found;                                 // Requests without a handler
+    uint64_t bytes_in;                                  // Bytes of POST data received
+    uint64_t bytes_out;                                 // Bytes written by handlers
+    uint64_t latency_us_sum;                            // Sum of all request latencies
+    uint64_t latency_us_max;                            // Largest request latency
+    uint64_t latency_hist[FAST_CGI_LATENCY_BUCKET_CNT]; // Number of requests per latency bucket
+} fast_cgi_statistics_t;
+
+void fast_cgi_statistics_get(fast_cgi_statistics_t *statistics);
+void fast_cgi_statistics_clear(void);
+
+// Load generator, which connects to our own FastCGI socket like the web server
+// does. Each client sends its requests one at a time.
+typedef struct {
+    uint32_t   clients;  // Number of concurrent clients
+    uint32_t   requests; // Number of requests per client
+    const char *path;    // E.g. "/json_rpc"
+    const char *body;    // POST data. A GET request is sent if NULL
+    const char *user;    // User name for basic authentication
+    const char *password;
+} fast_cgi_load_conf_t;
+
+typedef struct {
+    uint64_t requests;       // Requests completed
+    uint64_t errors;         // Requests that failed
+    uint64_t bytes;          // Response bytes received
+    uint64_t elapsed_us;     // Duration of the run
+    uint32_t latency_us_p50; // Latency percentiles of completed requests
+    uint32_t latency_us_p90;
+    uint32_t latency_us_p99;
+    uint32_t latency_us_max;
+} fast_cgi_load_result_t;
+
+#define FAST_CGI_LOAD_CLIENTS_MAX  32
+#define FAST_CGI_LOAD_REQUESTS_MAX 10000
+
+mesa_rc fast_cgi_load_run(const fast_cgi_load_conf_t *conf, fast_cgi_load_result_t *result);
+
 #endif  // __FAST_CGI_FAST_CGI_API_H__
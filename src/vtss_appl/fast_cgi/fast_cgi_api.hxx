@@ -132,10 +132,21 @@ typedef struct web_handler {
 } web_handler_t;
 
 extern web_handler_t *web_root;
-extern CYG_HTTPD_STATE httpstate;
 
+// Each FastCGI worker thread serves its requests with its own state. Returns
+// the state of the calling thread, or nullptr if it is not a worker.
+CYG_HTTPD_STATE *cyg_httpd_state_get(void);
+
+// Lets the calling thread do work on behalf of the request of another thread,
+// which must wait for it. Returns the previous state, to be set back after.
+CYG_HTTPD_STATE *cyg_httpd_state_set(CYG_HTTPD_STATE *state);
+
+// Returns -1 if the calling thread does not serve a request.
 int cyg_httpd_current_privilege_level();
-void cyg_httpd_current_username(char *username, size_t username_max_len);
+
+// Returns false and an empty username if the calling thread does not serve a
+// request.
+bool cyg_httpd_current_username(char *username, size_t username_max_len);
 void cyg_httpd_send_error(i32 err_type);
 void cyg_httpd_set_xreadonly_tag(int status);
 void cyg_httpd_send_content_disposition(cyg_httpd_ires_table_entry *entry);
@@ -0,0 +1,296 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <fastcgi.h>
+
+#include "main.h"
+#include "vtss_trace_api.h"
+#include "vtss_os_wrapper.h"
+#include "chrono.hxx"
+#include "fast_cgi_api.h"
+
+#define VTSS_TRACE_MODULE_ID VTSS_MODULE_ID_FAST_CGI
+#define VTSS_ALLOC_MODULE_ID VTSS_MODULE_ID_FAST_CGI
+
+#define FAST_CGI_LOAD_SOCKET "/tmp/json.socket"
+
+typedef struct {
+    const std::string *request;  // Complete FastCGI request, sent as is
+    uint32_t          cnt;       // Number of requests to send
+    uint32_t          *latency;  // Latency of each completed request
+    uint32_t          completed; // Number of entries in latency
+    uint64_t          errors;
+    uint64_t          bytes;
+    vtss_sem_t        *done;
+    vtss_handle_t     thread_handle;
+    vtss_thread_t     thread_block;
+} FAST_CGI_LOAD_client_t;
+
+static void FAST_CGI_LOAD_record_add(std::string &s, uint8_t type, const char *data, size_t len)
+{
+    FCGI_Header h = {};
+    size_t      l;
+
+    // Empty records terminate streams, so add at least one
+    do {
+        l = MIN(len, FCGI_MAX_LENGTH);
+        h.version         = FCGI_VERSION_1;
+        h.type            = type;
+        h.requestIdB0     = 1;
+        h.contentLengthB1 = l >> 8;
+        h.contentLengthB0 = l & 0xff;
+        s.append((const char *)&h, sizeof(h));
+        s.append(data, l);
+        data += l;
+        len  -= l;
+    } while (len);
+}
+
+static void FAST_CGI_LOAD_param_add(std::string &s, const char *name, const char *value)
+{
+    size_t   len[2] = {strlen(name), strlen(value)};
+    uint32_t i;
+
+    for (i = 0; i < 2; i++) {
+        if (len[i] < 128) {
+            s += (char)len[i];
+        } else {
+            s += (char)(0x80 | (len[i] >> 24));
+            s += (char)(len[i] >> 16);
+            s += (char)(len[i] >> 8);
+            s += (char)len[i];
+        }
+    }
+
+    s += name;
+    s += value;
+}
+
+// Builds the request the way hiawatha would have sent it
+static mesa_rc FAST_CGI_LOAD_request_build(const fast_cgi_load_conf_t *conf, std::string &req)
+{
+    FCGI_BeginRequestBody b = {};
+    std::string           params;
+    char                  buf[128], auth[192], len[16];
+    size_t                body_len = conf->body ? strlen(conf->body) : 0;
+
+    b.roleB0 = FCGI_RESPONDER;
+    FAST_CGI_LOAD_record_add(req, FCGI_BEGIN_REQUEST, (const char *)&b, sizeof(b));
+
+    (void)snprintf(buf, sizeof(buf), "%s:%s", conf->user ? conf->user : "", conf->password ? conf->password : "");
+    strcpy(auth, "Basic ");
+    VTSS_RC(vtss_httpd_base64_encode(auth + 6, sizeof(auth) - 6, buf, strlen(buf)));
+    (void)snprintf(len, sizeof(len), "%zu", body_len);
+
+    FAST_CGI_LOAD_param_add(params, "SCRIPT_NAME", conf->path);
+    FAST_CGI_LOAD_param_add(params, "REQUEST_URI", conf->path);
+    FAST_CGI_LOAD_param_add(params, "REQUEST_METHOD", conf->body ? "POST" : "GET");
+    FAST_CGI_LOAD_param_add(params, "HTTP_SCHEME", "https");
+    FAST_CGI_LOAD_param_add(params, "HTTP_HOST", "localhost");
+    FAST_CGI_LOAD_param_add(params, "REMOTE_ADDR", "127.0.0.1");
+    FAST_CGI_LOAD_param_add(params, "HTTP_AUTHORIZATION", auth);
+    if (conf->body) {
+        FAST_CGI_LOAD_param_add(params, "CONTENT_TYPE", "application/json");
+        FAST_CGI_LOAD_param_add(params, "CONTENT_LENGTH", len);
+    }
+
+    FAST_CGI_LOAD_record_add(req, FCGI_PARAMS, params.data(), params.size());
+    FAST_CGI_LOAD_record_add(req, FCGI_PARAMS, "", 0);
+    if (body_len) {
+        FAST_CGI_LOAD_record_add(req, FCGI_STDIN, conf->body, body_len);
+    }
+    FAST_CGI_LOAD_record_add(req, FCGI_STDIN, "", 0);
+    return VTSS_RC_OK;
+}
+
+static bool FAST_CGI_LOAD_read(int fd, void *buf, size_t len)
+{
+    char    *p = (char *)buf;
+    ssize_t res;
+
+    while (len) {
+        if ((res = read(fd, p, len)) <= 0) {
+            if (res < 0 && errno == EINTR) {
+                continue;
+            }
+
+            return false;
+        }
+
+        p   += res;
+        len -= res;
+    }
+
+    return true;
+}
+
+// Sends one request on a new connection and reads the response until the
+// application ends the request.
+static bool FAST_CGI_LOAD_transact(const std::string &req, uint64_t *bytes)
+{
+    struct sockaddr_un  addr = {};
+    FCGI_Header         h;
+    FCGI_EndRequestBody end;
+    char                buf[FCGI_MAX_LENGTH + 255];
+    size_t              len, pos;
+    ssize_t             res;
+    int                 fd;
+    bool                ok = false;
+
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        T_E("socket(): %s", strerror(errno));
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, FAST_CGI_LOAD_SOCKET, sizeof(addr.sun_path) - 1);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        T_I("connect(): %s", strerror(errno));
+        goto do_exit;
+    }
+
+    for (pos = 0; pos < req.size(); pos += res) {
+        if ((res = write(fd, req.data() + pos, req.size() - pos)) <= 0) {
+            T_I("write(): %s", strerror(errno));
+            goto do_exit;
+        }
+    }
+
+    while (FAST_CGI_LOAD_read(fd, &h, sizeof(h))) {
+        len = ((h.contentLengthB1 << 8) | h.contentLengthB0) + h.paddingLength;
+        if (h.type == FCGI_END_REQUEST) {
+            ok = len >= sizeof(end) && FAST_CGI_LOAD_read(fd, &end, sizeof(end)) && end.protocolStatus == FCGI_REQUEST_COMPLETE;
+            break;
+        }
+
+        if (!FAST_CGI_LOAD_read(fd, buf, len)) {
+            break;
+        }
+
+        if (h.type == FCGI_STDOUT) {
+            *bytes += len - h.paddingLength;
+        }
+    }
+
+do_exit:
+    close(fd);
+    return ok;
+}
+
+static void FAST_CGI_LOAD_client(vtss_addrword_t data)
+{
+    FAST_CGI_LOAD_client_t *c = (FAST_CGI_LOAD_client_t *)data;
+    uint64_t               start;
+    uint32_t               i;
+
+    for (i = 0; i < c->cnt; i++) {
+        start = vtss::uptime_microseconds();
+        if (FAST_CGI_LOAD_transact(*c->request, &c->bytes)) {
+            c->latency[c->completed++] = vtss::uptime_microseconds() - start;
+        } else {
+            c->errors++;
+        }
+    }
+
+    vtss_sem_post(c->done);
+}
+
+mesa_rc fast_cgi_load_run(const fast_cgi_load_conf_t *conf, fast_cgi_load_result_t *result)
+{
+    FAST_CGI_LOAD_client_t *clients = NULL;
+    uint32_t               *latency = NULL, i, cnt;
+    std::string            req;
+    vtss_sem_t             done;
+    uint64_t               start;
+    mesa_rc                rc = VTSS_RC_ERROR;
+
+    if (!conf || !result || !conf->path || conf->clients < 1 || conf->clients > FAST_CGI_LOAD_CLIENTS_MAX ||
+        conf->requests < 1 || conf->requests > FAST_CGI_LOAD_REQUESTS_MAX) {
+        return VTSS_RC_ERR_PARM;
+    }
+
+    vtss_clear(*result);
+    VTSS_RC(FAST_CGI_LOAD_request_build(conf, req));
+
+    clients = (FAST_CGI_LOAD_client_t *)VTSS_CALLOC(conf->clients, sizeof(*clients));
+    latency = (uint32_t *)VTSS_MALLOC(conf->clients * conf->requests * sizeof(*latency));
+    if (!clients || !latency) {
+        goto do_exit;
+    }
+
+    vtss_sem_init(&done, 0);
+    start = vtss::uptime_microseconds();
+    for (i = 0; i < conf->clients; i++) {
+        clients[i].request = &req;
+        clients[i].cnt     = conf->requests;
+        clients[i].latency = latency + i * conf->requests;
+        clients[i].done    = &done;
+        vtss_thread_create(VTSS_THREAD_PRIO_DEFAULT,
+                           FAST_CGI_LOAD_client,
+                           (vtss_addrword_t)&clients[i],
+                           "Fast CGI Load",
+                           nullptr,
+                           0,
+                           &clients[i].thread_handle,
+                           &clients[i].thread_block);
+    }
+
+    for (i = 0; i < conf->clients; i++) {
+        vtss_sem_wait(&done);
+    }
+
+    result->elapsed_us = vtss::uptime_microseconds() - start;
+    vtss_sem_destroy(&done);
+
+    // Pack the latencies of all clients and sort them to find the percentiles
+    for (cnt = 0, i = 0; i < conf->clients; i++) {
+        memmove(latency + cnt, clients[i].latency, clients[i].completed * sizeof(*latency));
+        cnt              += clients[i].completed;
+        result->errors   += clients[i].errors;
+        result->bytes    += clients[i].bytes;
+    }
+
+    result->requests = cnt;
+    if (cnt) {
+        std::sort(latency, latency + cnt);
+        result->latency_us_p50 = latency[(cnt - 1) * 50 / 100];
+        result->latency_us_p90 = latency[(cnt - 1) * 90 / 100];
+        result->latency_us_p99 = latency[(cnt - 1) * 99 / 100];
+        result->latency_us_max = latency[cnt - 1];
+    }
+
+    rc = VTSS_RC_OK;
+
+do_exit:
+    VTSS_FREE(latency);
+    VTSS_FREE(clients);
+    return rc;
+}
@@ -97,7 +97,7 @@ static BOOL redirect_current_connetion(CYG_HTTPD_STATE *p, BOOL redirect_to_http
     }
 
     (void)cyg_httpd_start_chunked("html");
-    ct = sprintf(httpstate.outbuffer, "%s%s%s%s%s%s%s%s",
+    ct = sprintf(p->outbuffer, "%s%s%s%s%s%s%s%s",
                  buf_start,
                  redirect_to_https ? "https://" : "http://",
                  http_referer_host,
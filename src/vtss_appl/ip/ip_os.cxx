@@ -121,10 +121,22 @@ struct State {
     vtss::Set<mesa_vid_mac_t> mac_addr_list;
     vtss::Map<int, vtss_ifindex_t> os_ifindex_to_ifindex;
     vtss::Map<vtss_ifindex_t, mesa_ipv6_network_t> vid_to_ipv6_network;
+    ip_os_netlink_statistics_t netlink_statistics;
 };
 
 static vtss::Synchronized<State, VTSS_MODULE_ID_IP> state;
 
+// Seconds between full reconciliations of the route and neighbor tables with
+// the kernel, and the netlink socket receive timeout used to check for it.
+#define IP_OS_NETLINK_RESYNC_INTERVAL_SECONDS 600
+#define IP_OS_NETLINK_RCV_TIMEOUT_SECONDS     10
+
+#if defined(VTSS_SW_OPTION_L3RT)
+// Route changes received from the kernel, but not yet applied to the chip. The
+// value is true for add and false for delete. Only used by the IP_OS thread.
+static vtss::Map<mesa_routing_entry_t, bool> IP_OS_route_delta;
+#endif
+
 #define DO(FUNC, ...)                                                                 \
     do {                                                                              \
         if ((rc = FUNC(__VA_ARGS__)) != VTSS_RC_OK) {                                 \
@@ -141,6 +153,16 @@ static vtss::Synchronized<State, VTSS_MODULE_ID_IP> state;
         }                                                                             \
     } while (0)
 
+/******************************************************************************/
+// IP_OS_netlink_statistics_inc()
+/******************************************************************************/
+static void IP_OS_netlink_statistics_inc(uint64_t ip_os_netlink_statistics_t::*counter, uint64_t cnt = 1)
+{
+    SYNCHRONIZED(state) {
+        state.netlink_statistics.*counter += cnt;
+    }
+}
+
 /******************************************************************************/
 // IP_OS_u8_to_u32()
 /******************************************************************************/
@@ -1166,7 +1188,7 @@ struct NetlinkCallbackCopyIpv4RouteTable : public netlink::NetlinkCallbackAbstra
         T_NG(IP_TRACE_GRP_NETLINK, "CB type: %s", netlink::AsRtmType(n->nlmsg_type));
         T_NG(IP_TRACE_GRP_NETLINK, "%s", *n);
 
-        if (n->nlmsg_type != RTM_NEWROUTE && n->nlmsg_type != RTM_GETROUTE) {
+        if (n->nlmsg_type != RTM_NEWROUTE && n->nlmsg_type != RTM_DELROUTE && n->nlmsg_type != RTM_GETROUTE) {
             return;
         }
 
@@ -1296,13 +1318,67 @@ struct NetlinkCallbackCopyIpv4RouteTable : public netlink::NetlinkCallbackAbstra
             data.emplace(k, false);
         } else {
             T_DG(IP_TRACE_GRP_NETLINK, "ROUTE4-DISCARD: %s, ifindex = %s", k, ifindex);
+
+            // The interface could not be resolved (anymore), so if this is a
+            // deletion, we cannot tell which of our routes it refers to.
+            unresolved = (got_gateway || got_dst) && !is_blackhole;
         }
     }
 
     vtss::Map<mesa_routing_entry_t, bool> data;
+
+    // Set if a route could not be mapped to one of our interfaces.
+    bool unresolved = false;
 };
 #endif // VTSS_SW_OPTION_L3RT
 
+#if defined(VTSS_SW_OPTION_L3RT)
+/******************************************************************************/
+// IP_OS_route_chip_update()
+// Deletes the routes in #rt_del and then adds the routes in #rt_add to H/W in
+// bulk.
+/******************************************************************************/
+static void IP_OS_route_chip_update(vtss::Vector<mesa_routing_entry_t> &rt_del, vtss::Vector<mesa_routing_entry_t> &rt_add)
+{
+    mesa_routing_entry_t *rt_ptr;
+    uint32_t             rt_missing, tmp;
+    mesa_rc              rc;
+
+    // Delete before adding
+    rt_missing = rt_del.size();
+    rt_ptr     = rt_del.data();
+    while (rt_missing) {
+        tmp = 0;
+        rc  = vtss_ip_chip_route_bulk_del(rt_missing, rt_ptr, &tmp);
+        IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::chip_bulk_calls);
+        T_IG(IP_TRACE_GRP_NETLINK, "ROUTE-CHIP-DEL %u/%u", rt_missing, tmp);
+        if (rc == VTSS_RC_OK) {
+            rt_ptr     += tmp;
+            rt_missing -= tmp;
+        } else {
+            break;
+        }
+    }
+
+    // Add routes
+    rt_missing = rt_add.size();
+    rt_ptr     = rt_add.data();
+    while (rt_missing) {
+        tmp = 0;
+        rc  = vtss_ip_chip_route_bulk_add(rt_missing, rt_ptr, &tmp);
+        IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::chip_bulk_calls);
+        T_IG(IP_TRACE_GRP_NETLINK, "ROUTE-CHIP-ADD %u/%u", rt_missing, tmp);
+        if (rc == VTSS_RC_OK) {
+            rt_ptr     += tmp;
+            rt_missing -= tmp;
+        } else {
+            IP_OS_route_table_full_report();
+            break;
+        }
+    }
+}
+#endif // VTSS_SW_OPTION_L3RT
+
 #if defined(VTSS_SW_OPTION_L3RT)
 /******************************************************************************/
 // IP_OS_poll_ipv4_route_state()
@@ -1310,7 +1386,6 @@ struct NetlinkCallbackCopyIpv4RouteTable : public netlink::NetlinkCallbackAbstra
 static void IP_OS_poll_ipv4_route_state(void)
 {
     NetlinkCallbackCopyIpv4RouteTable p;
-    uint32_t                          rt_missing, tmp;
     uint64_t                          a, b;
 
     struct Ipv4RouteStateChangePrint : ip_os_routes_t::Callback {
@@ -1344,6 +1419,7 @@ static void IP_OS_poll_ipv4_route_state(void)
     }
 
     T_DG(IP_TRACE_GRP_NETLINK, "Polling IPv4 route table");
+    IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::route_resyncs);
 
     a = vtss::uptime_milliseconds();
     IP_OS_nl_req_route_dump(&p, AF_INET);
@@ -1360,39 +1436,7 @@ static void IP_OS_poll_ipv4_route_state(void)
     T_DG(IP_TRACE_GRP_NETLINK, "Event processing took %s ms", (b - a) / 1000);
 
     a = vtss::uptime_milliseconds();
-
-    // Delete before adding
-    rt_missing = cb.rt_del.size();
-    mesa_routing_entry_t *rt_ptr = cb.rt_del.data();
-
-    while (rt_missing) {
-        tmp = 0;
-        mesa_rc rc = vtss_ip_chip_route_bulk_del(rt_missing, rt_ptr, &tmp);
-        T_IG(IP_TRACE_GRP_NETLINK, "ROUTE4-CHIP-DEL %u/%u", rt_missing, tmp);
-        if (rc == VTSS_RC_OK) {
-            rt_ptr     += tmp;
-            rt_missing -= tmp;
-        } else {
-            break;
-        }
-    }
-
-    // Add routes
-    rt_missing = cb.rt_add.size();
-    rt_ptr = cb.rt_add.data();
-    while (rt_missing) {
-        tmp = 0;
-        mesa_rc rc = vtss_ip_chip_route_bulk_add(rt_missing, rt_ptr, &tmp);
-        T_IG(IP_TRACE_GRP_NETLINK, "ROUTE4-CHIP-ADD %u/%u", rt_missing, tmp);
-        if (rc == VTSS_RC_OK) {
-            rt_ptr     += tmp;
-            rt_missing -= tmp;
-        } else {
-            IP_OS_route_table_full_report();
-            break;
-        }
-    }
-
+    IP_OS_route_chip_update(cb.rt_del, cb.rt_add);
     b = vtss::uptime_milliseconds();
 
     T_DG(IP_TRACE_GRP_NETLINK, "Took %s ms. Add-cnt = %zu, del-cnt = %zu", (b - a) / 1000, cb.rt_add.size(), cb.rt_del.size());
@@ -1420,7 +1464,7 @@ struct NetlinkCallbackCopyIpv6RouteTable : public netlink::NetlinkCallbackAbstra
         T_NG(IP_TRACE_GRP_NETLINK, "CB type: %s", netlink::AsRtmType(n->nlmsg_type));
         T_NG(IP_TRACE_GRP_NETLINK, "%s", *n);
 
-        if (n->nlmsg_type != RTM_NEWROUTE && n->nlmsg_type != RTM_GETROUTE) {
+        if (n->nlmsg_type != RTM_NEWROUTE && n->nlmsg_type != RTM_DELROUTE && n->nlmsg_type != RTM_GETROUTE) {
             return;
         }
 
@@ -1485,6 +1529,7 @@ struct NetlinkCallbackCopyIpv6RouteTable : public netlink::NetlinkCallbackAbstra
                             data.emplace(k, false);
                         } else {
                             T_DG(IP_TRACE_GRP_NETLINK, "ROUTE6-DISCARD-MP: %s", k);
+                            unresolved = unresolved || got_dst;
                         }
                     }
                 }
@@ -1538,10 +1583,17 @@ struct NetlinkCallbackCopyIpv6RouteTable : public netlink::NetlinkCallbackAbstra
             data.emplace(k, false);
         } else {
             T_DG(IP_TRACE_GRP_NETLINK, "ROUTE6-DISCARD: %s, ifindex = %s", k, ifindex);
+
+            // The interface could not be resolved (anymore), so if this is a
+            // deletion, we cannot tell which of our routes it refers to.
+            unresolved = (got_gateway || got_dst) && !is_blackhole;
         }
     }
 
     vtss::Map<mesa_routing_entry_t, bool> data;
+
+    // Set if a route could not be mapped to one of our interfaces.
+    bool unresolved = false;
 };
 #endif // VTSS_SW_OPTION_L3RT
 
@@ -1552,7 +1604,6 @@ struct NetlinkCallbackCopyIpv6RouteTable : public netlink::NetlinkCallbackAbstra
 static void IP_OS_poll_ipv6_route_state(void)
 {
     NetlinkCallbackCopyIpv6RouteTable p;
-    uint32_t                          rt_missing, tmp;
     uint64_t                          a, b;
 
     struct Ipv6RouteStateChangePrint : ip_os_routes_t::Callback {
@@ -1586,6 +1637,7 @@ static void IP_OS_poll_ipv6_route_state(void)
     }
 
     T_DG(IP_TRACE_GRP_NETLINK, "Polling IPv6 route table");
+    IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::route_resyncs);
 
     a = vtss::uptime_milliseconds();
     IP_OS_nl_req_route_dump(&p, AF_INET6);
@@ -1602,39 +1654,7 @@ static void IP_OS_poll_ipv6_route_state(void)
     T_DG(IP_TRACE_GRP_NETLINK, "Event processing took %s ms", (b - a) / 1000);
 
     a = vtss::uptime_milliseconds();
-
-    // Delete before adding
-    rt_missing = cb.rt_del.size();
-    mesa_routing_entry_t *rt_ptr = cb.rt_del.data();
-
-    while (rt_missing) {
-        tmp = 0;
-        mesa_rc rc = vtss_ip_chip_route_bulk_del(rt_missing, rt_ptr, &tmp);
-        T_IG(IP_TRACE_GRP_NETLINK, "ROUTE6-CHIP-DEL %u/%u", rt_missing, tmp);
-        if (rc == VTSS_RC_OK) {
-            rt_ptr     += tmp;
-            rt_missing -= tmp;
-        } else {
-            break;
-        }
-    }
-
-    // Add routes
-    rt_missing = cb.rt_add.size();
-    rt_ptr = cb.rt_add.data();
-    while (rt_missing) {
-        tmp = 0;
-        mesa_rc rc = vtss_ip_chip_route_bulk_add(rt_missing, rt_ptr, &tmp);
-        T_IG(IP_TRACE_GRP_NETLINK, "ROUTE6-CHIP-ADD %u/%u", rt_missing, tmp);
-        if (rc == VTSS_RC_OK) {
-            rt_ptr     += tmp;
-            rt_missing -= tmp;
-        } else {
-            IP_OS_route_table_full_report();
-            break;
-        }
-    }
-
+    IP_OS_route_chip_update(cb.rt_del, cb.rt_add);
     b = vtss::uptime_milliseconds();
 
     T_DG(IP_TRACE_GRP_NETLINK, "Took %s ms. Add-cnt = %zu, del-cnt = %zu", (b - a) / 1000, cb.rt_add.size(), cb.rt_del.size());
@@ -1661,7 +1681,7 @@ struct NetlinkCallbackNeighborList : public netlink::NetlinkCallbackAbstract {
         T_NG(IP_TRACE_GRP_NETLINK, "CB type: %s", netlink::AsRtmType(n->nlmsg_type));
         T_NG(IP_TRACE_GRP_NETLINK, "%s", *n);
 
-        if (n->nlmsg_type != RTM_NEWNEIGH) {
+        if (n->nlmsg_type != RTM_NEWNEIGH && n->nlmsg_type != RTM_DELNEIGH) {
             return;
         }
 
@@ -1745,7 +1765,10 @@ struct NetlinkCallbackNeighborList : public netlink::NetlinkCallbackAbstract {
             }
         }
 
-        if (ip_valid && mac_valid) {
+        if (ip_valid && n->nlmsg_type == RTM_DELNEIGH) {
+            T_DG(IP_TRACE_GRP_NETLINK, "NB%d-DEL: %s", k.dip.type == MESA_IP_TYPE_IPV4 ? 4 : 6, k);
+            gone.insert(k);
+        } else if (ip_valid && mac_valid) {
             v.flags = VTSS_APPL_IP_NEIGHBOR_FLAG_VALID;
 
             if ((ndm->ndm_flags & NTF_ROUTER) != 0) {
@@ -1765,11 +1788,14 @@ struct NetlinkCallbackNeighborList : public netlink::NetlinkCallbackAbstract {
                 if (vtss_ipv6_addr_is_link_local(&k.dip.addr.ipv6) || (vtss_ifindex_is_vlan(k.ifindex) && IP_OS_vlan_ipv6_network_match(k.ifindex, &k.dip.addr.ipv6))) {
                     T_DG(IP_TRACE_GRP_NETLINK, "NB6-ADD: %s %s", k, v);
                     data.emplace(k, v);
+                } else {
+                    gone.insert(k);
                 }
             }
         } else {
             if (ip_valid) {
                 T_DG(IP_TRACE_GRP_NETLINK, "NB%d-DISC (MAC not valid): %s", k.dip.type == MESA_IP_TYPE_IPV4 ? 4 : 6, k.dip);
+                gone.insert(k);
             } else if (mac_valid) {
                 T_DG(IP_TRACE_GRP_NETLINK, "NB%d-DISC (IP not valid): %s", k.dip.type == MESA_IP_TYPE_IPV4 ? 4 : 6, v);
             } else {
@@ -1779,6 +1805,10 @@ struct NetlinkCallbackNeighborList : public netlink::NetlinkCallbackAbstract {
     }
 
     vtss::Map<vtss_appl_ip_neighbor_key_t, vtss_appl_ip_neighbor_status_t> data;
+
+    // Neighbors that are deleted or no longer resolved. Only used when
+    // applying notifications, since a dump simply leaves them out of #data.
+    vtss::Set<vtss_appl_ip_neighbor_key_t> gone;
 };
 
 #if defined(VTSS_SW_OPTION_L3RT)
@@ -1891,6 +1921,7 @@ static void IP_OS_poll_neighbor_list(mesa_ip_type_t type)
 #endif // VTSS_SW_OPTION_L3RT
 
     T_DG(IP_TRACE_GRP_NETLINK, "Polling %s neighbor list", type == MESA_IP_TYPE_IPV4 ? "IPv4" : "IPv6");
+    IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::neighbor_resyncs);
 
     // Make a netlink request of all IPv4 members and store them in p.data
     IP_OS_nl_req_neigh_dump(&p, type == MESA_IP_TYPE_IPV4 ? AF_INET : AF_INET6);
@@ -1918,6 +1949,207 @@ static void IP_OS_poll_neighbor_list(mesa_ip_type_t type)
 #endif // VTSS_SW_OPTION_L3RT
 }
 
+#if defined(VTSS_SW_OPTION_L3RT)
+/******************************************************************************/
+// IP_OS_route_delta_queue()
+// Queues a route for addition to or deletion from H/W. A queued change in the
+// opposite direction cancels out, because H/W already has the right state.
+/******************************************************************************/
+static void IP_OS_route_delta_queue(const mesa_routing_entry_t &rt, bool add)
+{
+    auto itr = IP_OS_route_delta.find(rt);
+
+    T_IG(IP_TRACE_GRP_NETLINK, "ROUTE-DELTA-%s: %s", add ? "ADD" : "DEL", rt);
+
+    if (itr != IP_OS_route_delta.end() && itr->second != add) {
+        IP_OS_route_delta.erase(itr);
+    } else {
+        IP_OS_route_delta.set(rt, add);
+    }
+}
+#endif // VTSS_SW_OPTION_L3RT
+
+#if defined(VTSS_SW_OPTION_L3RT)
+/******************************************************************************/
+// IP_OS_route_delta_flush()
+// Applies the queued route changes to H/W in bulk. Must be called before any
+// of the route tables are polled, because the polls assume that H/W matches
+// IP_OS_status_rt_ipv4 and IP_OS_status_rt_ipv6.
+/******************************************************************************/
+static void IP_OS_route_delta_flush(void)
+{
+    vtss::Vector<mesa_routing_entry_t> rt_add, rt_del;
+
+    if (IP_OS_route_delta.empty()) {
+        return;
+    }
+
+    for (const auto &itr : IP_OS_route_delta) {
+        if (itr.second) {
+            rt_add.push_back(itr.first);
+        } else {
+            rt_del.push_back(itr.first);
+        }
+    }
+
+    IP_OS_route_delta.clear();
+    IP_OS_route_chip_update(rt_del, rt_add);
+}
+#endif // VTSS_SW_OPTION_L3RT
+
+#if defined(VTSS_SW_OPTION_L3RT)
+/******************************************************************************/
+// IP_OS_route_same_network()
+/******************************************************************************/
+static bool IP_OS_route_same_network(const mesa_routing_entry_t &a, const mesa_routing_entry_t &b)
+{
+    if (a.type != b.type) {
+        return false;
+    }
+
+    if (a.type == MESA_ROUTING_ENTRY_TYPE_IPV4_UC) {
+        return a.route.ipv4_uc.network == b.route.ipv4_uc.network;
+    }
+
+    return a.route.ipv6_uc.network == b.route.ipv6_uc.network;
+}
+#endif // VTSS_SW_OPTION_L3RT
+
+#if defined(VTSS_SW_OPTION_L3RT)
+/******************************************************************************/
+// IP_OS_route_delta_apply()
+// Updates #status with a single route notification and queues the resulting
+// H/W changes.
+// Returns false if the notification cannot be applied, in which case the route
+// table must be polled.
+/******************************************************************************/
+template <typename T>
+static bool IP_OS_route_delta_apply(struct nlmsghdr *nh, ip_os_routes_t &status)
+{
+    T                    p;
+    mesa_routing_entry_t rt, first;
+    bool                 add     = nh->nlmsg_type != RTM_DELROUTE;
+    bool                 replace = add && (nh->nlmsg_flags & NLM_F_REPLACE) != 0;
+    bool                 dummy   = false;
+    mesa_rc              rc;
+
+    p(nullptr, nh);
+
+    if (p.unresolved && (!add || replace)) {
+        // We cannot tell which of our routes to remove.
+        return false;
+    }
+
+    if (replace && p.data.size()) {
+        // All next-hops of this network are replaced by the ones in the
+        // notification. Start at the lowest possible key of the network.
+        first = rt = p.data.begin()->first;
+        if (rt.type == MESA_ROUTING_ENTRY_TYPE_IPV4_UC) {
+            rt.route.ipv4_uc.destination = 0;
+        } else {
+            vtss_clear(rt.route.ipv6_uc.destination);
+            rt.vlan = 0;
+        }
+
+        rc = status.get(&rt, &dummy);
+        if (rc != VTSS_RC_OK) {
+            rc = status.get_next(&rt, &dummy);
+        }
+
+        while (rc == VTSS_RC_OK && IP_OS_route_same_network(rt, first)) {
+            if (p.data.find(rt) == p.data.end()) {
+                (void)status.del(&rt);
+                IP_OS_route_delta_queue(rt, false);
+            }
+
+            rc = status.get_next(&rt, &dummy);
+        }
+    }
+
+    for (const auto &itr : p.data) {
+        rt = itr.first;
+        if (status.get(&rt, &dummy) == VTSS_RC_OK) {
+            if (!add) {
+                (void)status.del(&rt);
+                IP_OS_route_delta_queue(rt, false);
+            }
+        } else if (add) {
+            (void)status.set(&rt, false);
+            IP_OS_route_delta_queue(rt, true);
+        }
+    }
+
+    return true;
+}
+#endif // VTSS_SW_OPTION_L3RT
+
+/******************************************************************************/
+// IP_OS_neighbor_status()
+/******************************************************************************/
+static StatusNb *IP_OS_neighbor_status(mesa_ip_type_t type)
+{
+#if defined(VTSS_SW_OPTION_IPV6)
+    if (type == MESA_IP_TYPE_IPV6) {
+        return &status_nb_ipv6;
+    }
+#endif
+
+    return type == MESA_IP_TYPE_IPV4 ? &status_nb_ipv4 : nullptr;
+}
+
+/******************************************************************************/
+// IP_OS_neighbor_delta_apply()
+// Updates status_nb_ipv4 or status_nb_ipv6 and H/W with a single neighbor
+// notification.
+/******************************************************************************/
+static void IP_OS_neighbor_delta_apply(struct nlmsghdr *nh)
+{
+    NetlinkCallbackNeighborList    p;
+    vtss_appl_ip_neighbor_key_t    k;
+    vtss_appl_ip_neighbor_status_t v, old;
+    StatusNb                       *status;
+
+    p(nullptr, nh);
+
+    for (const auto &itr : p.data) {
+        k = itr.first;
+        v = itr.second;
+        if ((status = IP_OS_neighbor_status(k.dip.type)) == nullptr) {
+            continue;
+        }
+
+        if (status->get(&k, &old) == VTSS_RC_OK) {
+            // Keep the flag possibly set by IP_OS_neighbor_to_chip()
+            v.flags |= old.flags & VTSS_APPL_IP_NEIGHBOR_FLAG_HARDWARE;
+        } else {
+#if defined(VTSS_SW_OPTION_L3RT)
+            T_IG(IP_TRACE_GRP_NETLINK, "NB%d-CHIP-ADD: %s %s", k.dip.type == MESA_IP_TYPE_IPV4 ? 4 : 6, k, v);
+            if (IP_OS_neighbor_to_chip(k, v, true) != VTSS_RC_OK) {
+                T_WG(IP_TRACE_GRP_NETLINK, "Add neighbor %s %s failed", k, v);
+            }
+#endif // VTSS_SW_OPTION_L3RT
+        }
+
+        (void)status->set(&k, &v);
+    }
+
+    for (const auto &itr : p.gone) {
+        k = itr;
+        if ((status = IP_OS_neighbor_status(k.dip.type)) == nullptr || status->get(&k, &old) != VTSS_RC_OK) {
+            continue;
+        }
+
+#if defined(VTSS_SW_OPTION_L3RT)
+        T_IG(IP_TRACE_GRP_NETLINK, "NB%d-CHIP-DEL: %s %s", k.dip.type == MESA_IP_TYPE_IPV4 ? 4 : 6, k, old);
+        if (IP_OS_neighbor_to_chip(k, old, false) != VTSS_RC_OK) {
+            T_WG(IP_TRACE_GRP_NETLINK, "Del neighbor %s %s failed", k, old);
+        }
+#endif // VTSS_SW_OPTION_L3RT
+
+        (void)status->del(&k);
+    }
+}
+
 /******************************************************************************/
 // IP_OS_netlink_monitor_thread_msg()
 /******************************************************************************/
@@ -1937,10 +2169,38 @@ static int IP_OS_netlink_monitor_thread_msg(struct nlmsghdr *nh, int len, ip_os_
 
         case RTM_NEWLINK:
         case RTM_DELLINK:
-        case RTM_GETLINK:
+        case RTM_GETLINK: {
             T_DG(IP_TRACE_GRP_NETLINK, "RTM_NEWLINK/RTM_DELLINK/RTM_GETLINK");
+            struct ifinfomsg *ifi = (struct ifinfomsg *)NLMSG_DATA(nh);
+            if (len < NLMSG_LENGTH(sizeof(*ifi))) {
+                T_EG(IP_TRACE_GRP_NETLINK, "msg too short for this type!");
+                break;
+            }
+
             poll->link = true;
+
+            // The kernel flushes routes and neighbors of an interface that is
+            // deleted or goes down without notifying about each of them, so
+            // only then are they re-read. All other link changes are followed
+            // by route and neighbor notifications of their own.
+            if (nh->nlmsg_type != RTM_DELLINK &&
+                (nh->nlmsg_type != RTM_NEWLINK || (ifi->ifi_change & IFF_UP) == 0 || (ifi->ifi_flags & IFF_UP) != 0)) {
+                break;
+            }
+
+            T_IG(IP_TRACE_GRP_NETLINK, "os-ifindex %d deleted or down. Resyncing routes and neighbors", ifi->ifi_index);
+#if defined(VTSS_SW_OPTION_L3RT)
+            poll->ipv4_route = true;
+#endif
+#if defined(VTSS_SW_OPTION_L3RT) && defined(VTSS_SW_OPTION_IPV6)
+            poll->ipv6_route = true;
+#endif
+            poll->ipv4_neighbor = true;
+#if defined(VTSS_SW_OPTION_IPV6)
+            poll->ipv6_neighbor = true;
+#endif
             break;
+        }
 
         case RTM_NEWADDR:
         case RTM_DELADDR:
@@ -1952,11 +2212,20 @@ static int IP_OS_netlink_monitor_thread_msg(struct nlmsghdr *nh, int len, ip_os_
                 break;
             }
 
+            // Connected routes come and go silently with the address, and
+            // whether IPv6 neighbors are kept depends on the networks.
             if (ifa->ifa_family == AF_INET) {
                 poll->ipv4_addr = true;
+#if defined(VTSS_SW_OPTION_L3RT)
+                poll->ipv4_route = true;
+#endif
             } else if (ifa->ifa_family == AF_INET6) {
 #if defined(VTSS_SW_OPTION_IPV6)
                 poll->ipv6_addr = true;
+                poll->ipv6_neighbor = true;
+#endif
+#if defined(VTSS_SW_OPTION_L3RT) && defined(VTSS_SW_OPTION_IPV6)
+                poll->ipv6_route = true;
 #endif
             }
 
@@ -1974,11 +2243,20 @@ static int IP_OS_netlink_monitor_thread_msg(struct nlmsghdr *nh, int len, ip_os_
                 break;
             }
 
+            // Apply the change directly, unless it cannot be resolved.
             if (rtm->rtm_family == AF_INET) {
-                poll->ipv4_route = true;
+                if (IP_OS_route_delta_apply<NetlinkCallbackCopyIpv4RouteTable>(nh, IP_OS_status_rt_ipv4)) {
+                    IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::route_deltas);
+                } else {
+                    poll->ipv4_route = true;
+                }
             } else if (rtm->rtm_family == AF_INET6) {
 #if defined(VTSS_SW_OPTION_IPV6)
-                poll->ipv6_route = true;
+                if (IP_OS_route_delta_apply<NetlinkCallbackCopyIpv6RouteTable>(nh, IP_OS_status_rt_ipv6)) {
+                    IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::route_deltas);
+                } else {
+                    poll->ipv6_route = true;
+                }
 #endif
             }
 
@@ -1998,12 +2276,9 @@ static int IP_OS_netlink_monitor_thread_msg(struct nlmsghdr *nh, int len, ip_os_
                 break;
             }
 
-            if (ndm->ndm_family == AF_INET) {
-                poll->ipv4_neighbor = true;
-            } else if (ndm->ndm_family == AF_INET6) {
-#if defined(VTSS_SW_OPTION_IPV6)
-                poll->ipv6_neighbor = true;
-#endif
+            if (ndm->ndm_family == AF_INET || ndm->ndm_family == AF_INET6) {
+                IP_OS_neighbor_delta_apply(nh);
+                IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::neighbor_deltas);
             } else {
                 poll->mac_addr_list = true;
             }
@@ -2070,12 +2345,14 @@ static void IP_OS_netlink_poll(ip_os_netlink_poll_t &poll)
 /******************************************************************************/
 static void IP_OS_thread(vtss_addrword_t data)
 {
-    char               buf[4096];
-    int                len, fd, res;
+    char               buf[8192];
+    int                len, fd, res, rcvbuf = 1048576;
     struct iovec       iov = {buf, sizeof(buf)};
     struct msghdr      msg;
     struct sockaddr_nl sa;
+    struct timeval     tv = {IP_OS_NETLINK_RCV_TIMEOUT_SECONDS, 0};
     bool               socket_ok;
+    uint64_t           resync_time;
 
     while (1) {
         T_DG(IP_TRACE_GRP_NETLINK, "Creating netlink socket");
@@ -2102,11 +2379,26 @@ static void IP_OS_thread(vtss_addrword_t data)
                 T_EG(IP_TRACE_GRP_NETLINK, "Bind failed: %s", strerror(errno));
                 socket_ok = false;
             }
+
+            // A large receive buffer makes it less likely that a burst of
+            // route changes overruns the socket, which causes a full resync.
+            if (setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)) != 0) {
+                T_WG(IP_TRACE_GRP_NETLINK, "Unable to set receive buffer size: %s", strerror(errno));
+            }
+
+            // Wake up now and then to check for periodic resync.
+            if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) != 0) {
+                T_EG(IP_TRACE_GRP_NETLINK, "Unable to set receive timeout: %s", strerror(errno));
+            }
         }
 
         // The netlink connection has (possibly) been reset, meaning that we
         // may have lost messages. We therefore need to poll all as we do not
         // know what messages have been lost.
+#if defined(VTSS_SW_OPTION_L3RT)
+        IP_OS_route_delta_flush();
+#endif
+        resync_time = vtss::uptime_seconds();
         IP_OS_poll_link_state();
         IP_OS_poll_link_mac_address_list();
         IP_OS_poll_ipv4_state();
@@ -2140,9 +2432,20 @@ static void IP_OS_thread(vtss_addrword_t data)
             do {
                 len = recvmsg(fd, &msg, recvmsg_flag);
                 T_DG(IP_TRACE_GRP_NETLINK, "len = %d", len);
-                if (len == -1) {
-                    // Closing and re-opening the socket alleviates most
-                    // problems, including EAGAIN and EWOULDBLOCK.
+                if (len == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    // Queue is empty (or the receive timeout expired).
+                    break;
+                }
+
+                if (len == -1 && errno == EINTR) {
+                    continue;
+                }
+
+                if (len == -1 || (msg.msg_flags & MSG_TRUNC)) {
+                    // Notifications have been lost (typically ENOBUFS).
+                    // Closing and re-opening the socket causes a full resync.
+                    T_IG(IP_TRACE_GRP_NETLINK, "Netlink overrun: %s", len == -1 ? strerror(errno) : "Truncated");
+                    IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::overruns);
                     socket_ok = false;
 
                     // Make sure not to poll anything when breaking out.
@@ -2165,6 +2468,30 @@ static void IP_OS_thread(vtss_addrword_t data)
                 // the kernel.
             } while (socket_ok && cnt < 100);
 
+#if defined(VTSS_SW_OPTION_L3RT)
+            // Route changes are coalesced over the batch, and must hit H/W
+            // before any of the route tables are polled.
+            IP_OS_route_delta_flush();
+#endif
+
+            if (socket_ok && vtss::uptime_seconds() - resync_time >= IP_OS_NETLINK_RESYNC_INTERVAL_SECONDS) {
+                // Slow reconciliation in case a notification got lost without
+                // us noticing.
+                T_DG(IP_TRACE_GRP_NETLINK, "Periodic resync");
+                IP_OS_netlink_statistics_inc(&ip_os_netlink_statistics_t::periodic_resyncs);
+                resync_time = vtss::uptime_seconds();
+#if defined(VTSS_SW_OPTION_L3RT)
+                poll.ipv4_route = true;
+#endif
+#if defined(VTSS_SW_OPTION_L3RT) && defined(VTSS_SW_OPTION_IPV6)
+                poll.ipv6_route = true;
+#endif
+                poll.ipv4_neighbor = true;
+#if defined(VTSS_SW_OPTION_IPV6)
+                poll.ipv6_neighbor = true;
+#endif
+            }
+
             IP_OS_netlink_poll(poll);
         }
 
@@ -2589,6 +2916,30 @@ void ip_os_debug_netlink_poll(ip_os_netlink_poll_t *poll)
     IP_OS_netlink_poll(*poll);
 }
 
+/******************************************************************************/
+// ip_os_netlink_statistics_get()
+/******************************************************************************/
+void ip_os_netlink_statistics_get(ip_os_netlink_statistics_t *statistics)
+{
+    if (!statistics) {
+        return;
+    }
+
+    SYNCHRONIZED(state) {
+        *statistics = state.netlink_statistics;
+    }
+}
+
+/******************************************************************************/
+// ip_os_netlink_statistics_clear()
+/******************************************************************************/
+void ip_os_netlink_statistics_clear(void)
+{
+    SYNCHRONIZED(state) {
+        vtss_clear(state.netlink_statistics);
+    }
+}
+
 /******************************************************************************/
 // ip_os_ifindex_to_ifindex()
 /******************************************************************************/
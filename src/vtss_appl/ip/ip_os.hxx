@@ -57,6 +57,23 @@ typedef struct {
 
 void ip_os_debug_netlink_poll(ip_os_netlink_poll_t *poll);
 
+// Route and neighbor changes are applied directly from the netlink
+// notifications. The kernel tables are only dumped and compared to our copy at
+// startup, when notifications have been lost, on link and address changes, and
+// periodically.
+typedef struct {
+    uint64_t route_deltas;      // Route notifications applied directly
+    uint64_t neighbor_deltas;   // Neighbor notifications applied directly
+    uint64_t route_resyncs;     // Full dumps of a route table
+    uint64_t neighbor_resyncs;  // Full dumps of a neighbor table
+    uint64_t periodic_resyncs;  // Periodic reconciliations of all routes and neighbors
+    uint64_t overruns;          // Lost or truncated notifications, causing a resync of everything
+    uint64_t chip_bulk_calls;   // Route bulk add/delete calls towards the chip
+} ip_os_netlink_statistics_t;
+
+void ip_os_netlink_statistics_get(ip_os_netlink_statistics_t *statistics);
+void ip_os_netlink_statistics_clear(void);
+
 vtss_ifindex_t ip_os_ifindex_to_ifindex(int32_t os_ifindex); // returns VTSS_IFINDEX_NONE on error
 int32_t ip_os_ifindex_from_ifindex(vtss_ifindex_t ifindex);  // returns < 0 on error
 
@@ -1204,13 +1204,18 @@ CYG_HTTPD_HANDLER_TABLE_ENTRY(get_cb_diag_traceroute6, "/config/traceroute6", ha
 /*lint -sem(ip2_printf, thread_protected) ... function only called from web server */
 static int ip2_printf(const char *fmt, ...)
 {
-    int ct;
-    va_list ap; /*lint -e{530} ... 'ap' is initialized by va_start() */
+    CYG_HTTPD_STATE *p = cyg_httpd_state_get();
+    int             ct;
+    va_list         ap; /*lint -e{530} ... 'ap' is initialized by va_start() */
+
+    if (!p) {
+        return 0;
+    }
 
     va_start(ap, fmt);
-    ct = vsnprintf(httpstate.outbuffer, sizeof(httpstate.outbuffer), fmt, ap);
+    ct = vsnprintf(p->outbuffer, sizeof(p->outbuffer), fmt, ap);
     va_end(ap);
-    cyg_httpd_write_chunked(httpstate.outbuffer, ct);
+    cyg_httpd_write_chunked(p->outbuffer, ct);
 
     return ct;
 }
@@ -1766,11 +1766,23 @@ static void IPMC_LIB_rx_thread(vtss_addrword_t data)
     while (1) {
         vtss_flag_wait(&IPMC_LIB_rx_flag, 0xFFFFFFFF, VTSS_FLAG_WAITMODE_OR_CLR);
 
+        // Coalesce the MESA updates caused by the PDUs in the BIP buffer, so
+        // that a group changed by many PDUs in a row only gets written once.
+        {
+            IPMC_LIB_LOCK_SCOPE();
+            ipmc_lib_base_hw_batch_begin(IPMC_LIB_global_lists);
+        }
+
         // Empty the BIP buffer before waiting again.
         while (IPMC_LIB_rx_packet_from_bip_buffer(&frm, &rx_info, &sz)) {
             IPMC_LIB_rx_packet_dispatch(frm, rx_info);
             IPMC_LIB_rx_bip_buffer_decommit(sz);
         }
+
+        {
+            IPMC_LIB_LOCK_SCOPE();
+            ipmc_lib_base_hw_batch_end(IPMC_LIB_global_lists);
+        }
     }
 }
 
@@ -2097,7 +2109,7 @@ static void IPMC_LIB_tick_thread(vtss_addrword_t data)
         now = vtss::uptime_seconds();
 
         // Group map tick - one single that covers all
-        ipmc_lib_base_grp_map_tick(IPMC_LIB_global_lists.grp_map, now);
+        ipmc_lib_base_grp_map_tick(IPMC_LIB_global_lists, now);
 
         // Proxy group map tick - one single that covers all
         ipmc_lib_base_proxy_report_tick(IPMC_LIB_global_lists.proxy_grp_map);
@@ -2718,7 +2730,7 @@ static void IPMC_LIB_port_state_change_callback(mesa_port_no_t port_no, const vt
         return;
     }
 
-    ipmc_lib_base_port_down(IPMC_LIB_global_lists.grp_map, port_no);
+    ipmc_lib_base_port_down(IPMC_LIB_global_lists, port_no);
 
     for (i = 0; i < IPMC_LIB_STATE_CNT; i++) {
         // When a port goes down and it's a dynamic router port, we need to mark
@@ -2901,7 +2913,7 @@ static void IPMC_LIB_aggr_port_mask_update(mesa_port_no_t port_no, mesa_port_lis
     T_IG_PORT(IPMC_LIB_TRACE_GRP_CALLBACK, port_no, "Aggregation port_mask: %s -> %s", IPMC_LIB_global_lists.aggr_port_masks[port_no], port_mask);
 
     IPMC_LIB_global_lists.aggr_port_masks[port_no] = port_mask;
-    ipmc_lib_base_aggr_port_update(IPMC_LIB_global_lists.grp_map, port_no);
+    ipmc_lib_base_aggr_port_update(IPMC_LIB_global_lists, port_no);
 }
 
 /******************************************************************************/
@@ -4398,6 +4410,33 @@ void ipmc_lib_debug_thread_state_change(bool resume)
     IPMC_LIB_thread_running = resume;
 }
 
+/******************************************************************************/
+// ipmc_lib_debug_hw_statistics()
+/******************************************************************************/
+void ipmc_lib_debug_hw_statistics(ipmc_lib_icli_pr_t pr, bool clear)
+{
+    ipmc_lib_hw_statistics_t stati;
+    size_t                   installed_cnt;
+
+    {
+        IPMC_LIB_LOCK_SCOPE();
+        stati         = IPMC_LIB_global_lists.hw_statistics;
+        installed_cnt = IPMC_LIB_global_lists.hw_fwd_lists.size();
+
+        if (clear) {
+            vtss_clear(IPMC_LIB_global_lists.hw_statistics);
+        }
+    }
+
+    pr("Installed entries: %zu\n", installed_cnt);
+    pr("Requested updates: " VPRI64u "\n", stati.requested);
+    pr("Coalesced updates: " VPRI64u "\n", stati.coalesced);
+    pr("Unchanged updates: " VPRI64u "\n", stati.unchanged);
+    pr("Issued updates:    " VPRI64u "\n", stati.issued);
+    pr("Failed updates:    " VPRI64u "\n", stati.failed);
+    pr("Flushes:           " VPRI64u "\n", stati.flushes);
+}
+
 /******************************************************************************/
 // ipmc_lib_debug_src_dump()
 /******************************************************************************/
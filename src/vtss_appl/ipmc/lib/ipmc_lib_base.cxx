@@ -38,6 +38,11 @@
 
 #define IPMC_LIB_BASE_QUERY_SUPPRESSION_TIMEOUT 2 /* seconds */
 
+// While processing PDUs, updates of MESA entries are flushed when this many are
+// pending or the oldest has been pending for this long.
+#define IPMC_LIB_BASE_HW_BATCH_CNT_MAX          64
+#define IPMC_LIB_BASE_HW_BATCH_MSEC_MAX         50
+
 /******************************************************************************/
 // ipmc_lib_grp_key_t::operator<()
 /******************************************************************************/
@@ -194,25 +199,46 @@ static void IPMC_LIB_BASE_next_query_timeout_update(ipmc_lib_src_map_t &src_map)
 }
 
 /******************************************************************************/
-// IPMC_LIB_BASE_mesa_tcam_add()
+// ipmc_lib_hw_key_t::operator<()
 /******************************************************************************/
-static bool IPMC_LIB_BASE_mesa_tcam_add(ipmc_lib_global_state_t &glb, ipmc_lib_grp_itr_t &grp_itr, const vtss_appl_ipmc_lib_ip_t &sip, mesa_port_list_t &fwd_list)
+bool operator<(const ipmc_lib_hw_key_t &lhs, const ipmc_lib_hw_key_t &rhs)
 {
-    bool    is_ipv4 = grp_itr->first.grp_addr.is_ipv4;
-    mesa_rc rc;
+    // Using ipmc_lib_grp_key_t::operator<()
+    if (lhs.grp_key < rhs.grp_key) {
+        return true;
+    }
+
+    if (rhs.grp_key < lhs.grp_key) {
+        return false;
+    }
 
-    T_IG(IPMC_LIB_TRACE_GRP_API, "%s: mesa_ipv%c_mc_add(vid = %u, sip = %s, dip = %s, port_list = %s)", grp_itr->first, is_ipv4 ? '4' : '6', grp_itr->first.vlan_key.vid, sip, grp_itr->first.grp_addr, fwd_list);
-    if (grp_itr->first.grp_addr.is_ipv4) {
-        rc = mesa_ipv4_mc_add(nullptr, grp_itr->first.vlan_key.vid, sip.ipv4, grp_itr->first.grp_addr.ipv4, &fwd_list);
+    // Using vtss_appl_ipmc_lib_ip_t::operator<(). The source address is of the
+    // same IP family as the group address.
+    return lhs.sip < rhs.sip;
+}
+
+/******************************************************************************/
+// IPMC_LIB_BASE_mesa_tcam_add()
+/******************************************************************************/
+static bool IPMC_LIB_BASE_mesa_tcam_add(const ipmc_lib_hw_key_t &hw_key, const mesa_port_list_t &fwd_list)
+{
+    const ipmc_lib_grp_key_t      &grp_key = hw_key.grp_key;
+    const vtss_appl_ipmc_lib_ip_t &sip     = hw_key.sip;
+    bool                          is_ipv4  = grp_key.grp_addr.is_ipv4;
+    mesa_rc                       rc;
+
+    T_IG(IPMC_LIB_TRACE_GRP_API, "%s: mesa_ipv%c_mc_add(vid = %u, sip = %s, dip = %s, port_list = %s)", grp_key, is_ipv4 ? '4' : '6', grp_key.vlan_key.vid, sip, grp_key.grp_addr, fwd_list);
+    if (grp_key.grp_addr.is_ipv4) {
+        rc = mesa_ipv4_mc_add(nullptr, grp_key.vlan_key.vid, sip.ipv4, grp_key.grp_addr.ipv4, &fwd_list);
     } else {
-        rc = mesa_ipv6_mc_add(nullptr, grp_itr->first.vlan_key.vid, sip.ipv6, grp_itr->first.grp_addr.ipv6, &fwd_list);
+        rc = mesa_ipv6_mc_add(nullptr, grp_key.vlan_key.vid, sip.ipv6, grp_key.grp_addr.ipv6, &fwd_list);
     }
 
     if (rc != VTSS_RC_OK) {
         // We cannot make a trace error here, because it might be that the chip
         // has run out of resources, in which case we switch to using the VLAN
         // table.
-        T_IG(IPMC_LIB_TRACE_GRP_API, "%s: mesa_ipv%c_mc_add(vid = %u, sip = %s, dip = %s, port_list = %s) failed: %s", grp_itr->first, is_ipv4 ? '4' : '6', grp_itr->first.vlan_key.vid, sip, grp_itr->first.grp_addr, fwd_list, error_txt(rc));
+        T_IG(IPMC_LIB_TRACE_GRP_API, "%s: mesa_ipv%c_mc_add(vid = %u, sip = %s, dip = %s, port_list = %s) failed: %s", grp_key, is_ipv4 ? '4' : '6', grp_key.vlan_key.vid, sip, grp_key.grp_addr, fwd_list, error_txt(rc));
         return false;
     }
 
@@ -222,22 +248,24 @@ static bool IPMC_LIB_BASE_mesa_tcam_add(ipmc_lib_global_state_t &glb, ipmc_lib_g
 /******************************************************************************/
 // IPMC_LIB_BASE_mesa_tcam_del()
 /******************************************************************************/
-static void IPMC_LIB_BASE_mesa_tcam_del(ipmc_lib_global_state_t &glb, ipmc_lib_grp_itr_t &grp_itr, const vtss_appl_ipmc_lib_ip_t &sip)
+static void IPMC_LIB_BASE_mesa_tcam_del(const ipmc_lib_hw_key_t &hw_key)
 {
-    bool    is_ipv4 = grp_itr->first.grp_addr.is_ipv4;
-    mesa_rc rc;
-
-    T_IG(IPMC_LIB_TRACE_GRP_API, "%s: mesa_ipv%c_mc_del(vid = %u, sip = %s, dip = %s)", grp_itr->first, is_ipv4 ? '4' : '6', grp_itr->first.vlan_key.vid, sip, grp_itr->first.grp_addr);
-    if (grp_itr->first.grp_addr.is_ipv4) {
-        rc = mesa_ipv4_mc_del(nullptr, grp_itr->first.vlan_key.vid, sip.ipv4, grp_itr->first.grp_addr.ipv4);
+    const ipmc_lib_grp_key_t      &grp_key = hw_key.grp_key;
+    const vtss_appl_ipmc_lib_ip_t &sip     = hw_key.sip;
+    bool                          is_ipv4  = grp_key.grp_addr.is_ipv4;
+    mesa_rc                       rc;
+
+    T_IG(IPMC_LIB_TRACE_GRP_API, "%s: mesa_ipv%c_mc_del(vid = %u, sip = %s, dip = %s)", grp_key, is_ipv4 ? '4' : '6', grp_key.vlan_key.vid, sip, grp_key.grp_addr);
+    if (grp_key.grp_addr.is_ipv4) {
+        rc = mesa_ipv4_mc_del(nullptr, grp_key.vlan_key.vid, sip.ipv4, grp_key.grp_addr.ipv4);
     } else {
-        rc = mesa_ipv6_mc_del(nullptr, grp_itr->first.vlan_key.vid, sip.ipv6, grp_itr->first.grp_addr.ipv6);
+        rc = mesa_ipv6_mc_del(nullptr, grp_key.vlan_key.vid, sip.ipv6, grp_key.grp_addr.ipv6);
     }
 
     if (rc != VTSS_RC_OK) {
         // When deleting an entry, we can indeed throw a trace error if MESA
         // returns an error, because we know that it is already there.
-        T_EG(IPMC_LIB_TRACE_GRP_API, "%s: mesa_ipv%c_mc_del(vid = %u, sip = %s, dip = %s) failed: %s", grp_itr->first, is_ipv4 ? '4' : '6', grp_itr->first.vlan_key.vid, sip, grp_itr->first.grp_addr, error_txt(rc));
+        T_EG(IPMC_LIB_TRACE_GRP_API, "%s: mesa_ipv%c_mc_del(vid = %u, sip = %s, dip = %s) failed: %s", grp_key, is_ipv4 ? '4' : '6', grp_key.vlan_key.vid, sip, grp_key.grp_addr, error_txt(rc));
     }
 }
 
@@ -263,6 +291,178 @@ static bool IPMC_LIB_BASE_mesa_mac_table_del(ipmc_lib_global_state_t &glb, ipmc_
     return false;
 }
 
+/******************************************************************************/
+// IPMC_LIB_BASE_hw_add_failed()
+// Called when flushing an update of a TCAM entry failed. Falls back on MAC
+// table-based forwarding for the <G, S> in question, if it still exists.
+/******************************************************************************/
+static void IPMC_LIB_BASE_hw_add_failed(ipmc_lib_global_lists_t &lists, const ipmc_lib_hw_key_t &hw_key, mesa_port_list_t &fwd_list)
+{
+    ipmc_lib_grp_itr_t   grp_itr;
+    ipmc_lib_src_itr_t   src_itr;
+    ipmc_lib_src_state_t *src_state;
+
+    if ((grp_itr = lists.grp_map.find(hw_key.grp_key)) == lists.grp_map.end()) {
+        return;
+    }
+
+    if (hw_key.sip.is_zero()) {
+        src_state = &grp_itr->second.asm_state;
+    } else if ((src_itr = grp_itr->second.src_map.find(hw_key.sip)) != grp_itr->second.src_map.end()) {
+        src_state = &src_itr->second;
+    } else {
+        return;
+    }
+
+    if (IPMC_LIB_BASE_mesa_mac_table_add(*grp_itr->second.vlan_state->global, grp_itr, fwd_list)) {
+        src_state->hw_location = VTSS_APPL_IPMC_LIB_HW_LOCATION_MAC_TABLE;
+    } else {
+        src_state->hw_location = VTSS_APPL_IPMC_LIB_HW_LOCATION_NONE;
+    }
+}
+
+/******************************************************************************/
+// ipmc_lib_base_hw_flush()
+// Writes pending updates of <G, S> entries to MESA. Updates that leave an entry
+// as it already is in MESA are skipped.
+/******************************************************************************/
+void ipmc_lib_base_hw_flush(ipmc_lib_global_lists_t &lists)
+{
+    ipmc_lib_hw_statistics_t                                     &stati = lists.hw_statistics;
+    vtss::Map<ipmc_lib_hw_key_t, ipmc_lib_hw_update_t>::iterator upd_itr;
+    vtss::Map<ipmc_lib_hw_key_t, mesa_port_list_t>::iterator     fwd_itr;
+    int                                                          pass;
+
+    if (lists.hw_pending.empty()) {
+        return;
+    }
+
+    T_DG(IPMC_LIB_TRACE_GRP_API, "Flushing %zu updates", lists.hw_pending.size());
+
+    // Deletions are done first, so that they free up room in TCAM for the
+    // additions.
+    for (pass = 0; pass < 2; pass++) {
+        for (upd_itr = lists.hw_pending.begin(); upd_itr != lists.hw_pending.end(); ++upd_itr) {
+            const ipmc_lib_hw_key_t &hw_key = upd_itr->first;
+            ipmc_lib_hw_update_t    &upd    = upd_itr->second;
+
+            if (upd.add != (pass == 1)) {
+                continue;
+            }
+
+            fwd_itr = lists.hw_fwd_lists.find(hw_key);
+
+            if (!upd.add) {
+                if (fwd_itr == lists.hw_fwd_lists.end()) {
+                    // Added and deleted again before being flushed.
+                    stati.unchanged++;
+                    continue;
+                }
+
+                stati.issued++;
+                IPMC_LIB_BASE_mesa_tcam_del(hw_key);
+                lists.hw_fwd_lists.erase(fwd_itr);
+                continue;
+            }
+
+            if (fwd_itr != lists.hw_fwd_lists.end() && fwd_itr->second == upd.fwd_list) {
+                stati.unchanged++;
+                continue;
+            }
+
+            // Whether we don't have one or already have one in TCAM, we need
+            // to do the same, because there is no such function as
+            // mesa_ipv4_mc_get() or mesa_ipv6_mc_get().
+            stati.issued++;
+            if (IPMC_LIB_BASE_mesa_tcam_add(hw_key, upd.fwd_list)) {
+                if (fwd_itr != lists.hw_fwd_lists.end()) {
+                    fwd_itr->second = upd.fwd_list;
+                } else if (!lists.hw_fwd_lists.set(hw_key, upd.fwd_list)) {
+                    T_EG(IPMC_LIB_TRACE_GRP_API, "%s: Out of memory", hw_key.grp_key);
+                }
+
+                continue;
+            }
+
+            stati.failed++;
+
+            if (fwd_itr != lists.hw_fwd_lists.end()) {
+                // The entry was in the chip before, so why did it fail now?
+                // Anyway, remove it from the chip again and fall back on MAC
+                // table-based forwarding.
+                stati.issued++;
+                IPMC_LIB_BASE_mesa_tcam_del(hw_key);
+                lists.hw_fwd_lists.erase(fwd_itr);
+            }
+
+            IPMC_LIB_BASE_hw_add_failed(lists, hw_key, upd.fwd_list);
+        }
+    }
+
+    lists.hw_pending.clear();
+    stati.flushes++;
+}
+
+/******************************************************************************/
+// ipmc_lib_base_hw_batch_begin()
+// Called by the Rx thread before it processes a number of PDUs. Until it calls
+// ipmc_lib_base_hw_batch_end(), updates of MESA entries it requests are only
+// flushed when too many are pending or they have been pending for too long.
+// Other threads are not affected.
+/******************************************************************************/
+void ipmc_lib_base_hw_batch_begin(ipmc_lib_global_lists_t &lists)
+{
+    lists.hw_batch_thread = vtss_thread_self();
+}
+
+/******************************************************************************/
+// ipmc_lib_base_hw_batch_end()
+/******************************************************************************/
+void ipmc_lib_base_hw_batch_end(ipmc_lib_global_lists_t &lists)
+{
+    lists.hw_batch_thread = 0;
+    ipmc_lib_base_hw_flush(lists);
+}
+
+/******************************************************************************/
+// IPMC_LIB_BASE_hw_update()
+// Requests a <G, S> entry added/updated (add == true) or deleted in MESA.
+/******************************************************************************/
+static void IPMC_LIB_BASE_hw_update(ipmc_lib_global_lists_t &lists, ipmc_lib_grp_itr_t &grp_itr, const vtss_appl_ipmc_lib_ip_t &sip, bool add, const mesa_port_list_t &fwd_list)
+{
+    vtss::Map<ipmc_lib_hw_key_t, ipmc_lib_hw_update_t>::iterator upd_itr;
+    ipmc_lib_hw_key_t                                            hw_key;
+    uint64_t                                                     now_msec = vtss::uptime_milliseconds();
+
+    hw_key.grp_key = grp_itr->first;
+    hw_key.sip     = sip;
+
+    lists.hw_statistics.requested++;
+
+    if ((upd_itr = lists.hw_pending.find(hw_key)) != lists.hw_pending.end()) {
+        // Replace the pending update of this entry.
+        lists.hw_statistics.coalesced++;
+    } else {
+        if (lists.hw_pending.empty()) {
+            lists.hw_pending_msec = now_msec;
+        }
+
+        if ((upd_itr = lists.hw_pending.get(hw_key)) == lists.hw_pending.end()) {
+            T_EG(IPMC_LIB_TRACE_GRP_API, "%s: Out of memory", grp_itr->first);
+            return;
+        }
+    }
+
+    upd_itr->second.add      = add;
+    upd_itr->second.fwd_list = fwd_list;
+
+    if (lists.hw_batch_thread != vtss_thread_self()              ||
+        lists.hw_pending.size() >= IPMC_LIB_BASE_HW_BATCH_CNT_MAX ||
+        now_msec - lists.hw_pending_msec >= IPMC_LIB_BASE_HW_BATCH_MSEC_MAX) {
+        ipmc_lib_base_hw_flush(lists);
+    }
+}
+
 /******************************************************************************/
 // IPMC_LIB_BASE_mesa_add()
 // This function is used to both update and add a TCAM or MAC table entry.
@@ -276,19 +476,12 @@ static void IPMC_LIB_BASE_mesa_add(ipmc_lib_global_state_t &glb, ipmc_lib_grp_it
     case VTSS_APPL_IPMC_LIB_HW_LOCATION_NONE:
     case VTSS_APPL_IPMC_LIB_HW_LOCATION_TCAM:
         if (tcam_support) {
-            // Whether we don't have one or already have one in TCAM, we need to
-            // do the same, because there is no such function as
-            // mesa_ipv4_mc_get() or mesa_ipv6_mc_get().
-            if (IPMC_LIB_BASE_mesa_tcam_add(glb, grp_itr, sip, fwd_list)) {
-                src_state.hw_location = VTSS_APPL_IPMC_LIB_HW_LOCATION_TCAM;
-                break;
-            } else if (src_state.hw_location == VTSS_APPL_IPMC_LIB_HW_LOCATION_TCAM) {
-                // The entry was in the chip when we got in here, so why did it fail
-                // now? Anyway, remove it from the chip again and fall back on
-                // MAC table-based forwarding.
-                IPMC_LIB_BASE_mesa_tcam_del(glb, grp_itr, sip);
-                src_state.hw_location = VTSS_APPL_IPMC_LIB_HW_LOCATION_NONE;
-            }
+            // The TCAM entry is written when the pending updates are flushed.
+            // If that fails, IPMC_LIB_BASE_hw_add_failed() falls back on MAC
+            // table-based forwarding.
+            IPMC_LIB_BASE_hw_update(*glb.lists, grp_itr, sip, true, fwd_list);
+            src_state.hw_location = VTSS_APPL_IPMC_LIB_HW_LOCATION_TCAM;
+            break;
         }
 
     // Fall through
@@ -309,6 +502,8 @@ static void IPMC_LIB_BASE_mesa_add(ipmc_lib_global_state_t &glb, ipmc_lib_grp_it
 /******************************************************************************/
 static void IPMC_LIB_BASE_mesa_del(ipmc_lib_global_state_t &glb, ipmc_lib_grp_itr_t &grp_itr, const vtss_appl_ipmc_lib_ip_t &sip, ipmc_lib_src_state_t &src_state)
 {
+    mesa_port_list_t empty_list;
+
     switch (src_state.hw_location) {
     case VTSS_APPL_IPMC_LIB_HW_LOCATION_NONE:
         // This entry is not in H/W. Skip it.
@@ -316,7 +511,8 @@ static void IPMC_LIB_BASE_mesa_del(ipmc_lib_global_state_t &glb, ipmc_lib_grp_it
 
     case VTSS_APPL_IPMC_LIB_HW_LOCATION_TCAM:
         // This <group, source> is in TCAM. Delete it.
-        IPMC_LIB_BASE_mesa_tcam_del(glb, grp_itr, sip);
+        empty_list.clear_all();
+        IPMC_LIB_BASE_hw_update(*glb.lists, grp_itr, sip, false, empty_list);
         break;
 
     case VTSS_APPL_IPMC_LIB_HW_LOCATION_MAC_TABLE:
@@ -1062,6 +1258,7 @@ static void IPMC_LIB_BASE_grp_itr_erase(ipmc_lib_grp_itr_t &grp_itr)
         ipmc_lib_pdu_tx_leave(vlan_state, grp_itr->first.grp_addr);
     }
 
+    vlan_state.global->lists->grp_timers.del(grp_itr->first);
     vlan_state.global->lists->grp_map.erase(grp_itr);
 
     // This may have changed the VLAN's host compatibility
@@ -1325,6 +1522,47 @@ static void IPMC_LIB_BASE_general_query_tx_tick(ipmc_lib_vlan_state_t &vlan_stat
     }
 }
 
+/******************************************************************************/
+// IPMC_LIB_BASE_grp_next_timeout_get()
+// Returns the earliest time at which ipmc_lib_base_grp_map_tick() has something
+// to do for this group, or 0 if it has no running timers.
+// The checks must match those made by the tick functions called by
+// ipmc_lib_base_grp_map_tick(). A group timer or older version host present
+// timer of 0 is treated as already expired, just as these tick functions do.
+/******************************************************************************/
+static uint32_t IPMC_LIB_BASE_grp_next_timeout_get(const ipmc_lib_grp_state_t &grp_state)
+{
+    ipmc_lib_timer_deadline_t d;
+    mesa_port_no_t            port_no;
+
+    if (grp_state.asm_state.changed) {
+        // MESA needs to be updated on the next tick.
+        return 1;
+    }
+
+    // IPMC_LIB_BASE_src_timer_tick()
+    d.timer(grp_state.src_map.next_src_timeout);
+
+    // IPMC_LIB_BASE_group_timer_tick()
+    for (port_no = 0; port_no < IPMC_LIB_port_cnt; port_no++) {
+        if (grp_state.active_ports[port_no] && grp_state.exclude_mode_ports[port_no]) {
+            d.timer_expired_if_zero(grp_state.ports[port_no].grp_timeout);
+        }
+    }
+
+    // IPMC_LIB_BASE_query_retransmit_tick()
+    d.timer(grp_state.asm_state.next_query_timeout);
+    d.timer(grp_state.src_map.next_query_timeout);
+
+    // IPMC_LIB_BASE_older_version_host_tick()
+    if (grp_state.vlan_state->conf.compatibility == VTSS_APPL_IPMC_LIB_COMPATIBILITY_AUTO &&
+        grp_state.grp_compat == VTSS_APPL_IPMC_LIB_COMPATIBILITY_OLD) {
+        d.timer_expired_if_zero(grp_state.grp_older_version_host_present_timeout_old);
+    }
+
+    return d.deadline;
+}
+
 /******************************************************************************/
 // ipmc_lib_base_grp_map_tick()
 // Checks:
@@ -1333,18 +1571,32 @@ static void IPMC_LIB_BASE_general_query_tx_tick(ipmc_lib_vlan_state_t &vlan_stat
 //  - Older Version Host Present timers.
 //  - Query retransmission timers.
 //  - Per-group Query Tx timers
+//
+// Only groups whose deadline in lists.grp_timers has been reached are visited.
 /******************************************************************************/
-void ipmc_lib_base_grp_map_tick(ipmc_lib_grp_map_t &grp_map, uint32_t now)
+void ipmc_lib_base_grp_map_tick(ipmc_lib_global_lists_t &lists, uint32_t now)
 {
-    ipmc_lib_grp_itr_t grp_itr, grp_itr_next;
-    ipmc_lib_src_itr_t src_itr;
+    ipmc_lib_grp_map_t         &grp_map    = lists.grp_map;
+    ipmc_lib_grp_timer_index_t &grp_timers = lists.grp_timers;
+    ipmc_lib_grp_itr_t         grp_itr;
+    ipmc_lib_grp_key_t         grp_key;
+    uint32_t                   visit_cnt = 0;
 
-    grp_itr = grp_map.begin();
-    while (grp_itr != grp_map.end()) {
-        // We might delete this group as part of the following, so keep a ptr
-        // to the next group
-        grp_itr_next = grp_itr;
-        ++grp_itr_next;
+    // Updates left pending by the Rx thread are not held back for longer than
+    // until the next tick.
+    ipmc_lib_base_hw_flush(lists);
+
+    // Groups deleted after being touched have already been removed from the
+    // index by IPMC_LIB_BASE_grp_itr_erase().
+    grp_timers.touched_update(grp_map, IPMC_LIB_BASE_grp_next_timeout_get);
+
+    while (grp_timers.expired_get(now, grp_key)) {
+        if ((grp_itr = grp_map.find(grp_key)) == grp_map.end()) {
+            T_EG(IPMC_LIB_TRACE_GRP_TICK, "%s: Group in timer index, but not in group map", grp_key);
+            continue;
+        }
+
+        visit_cnt++;
 
         // We check the source timers before the group timer, because the group
         // timer needs to know whether all source timers have expired.
@@ -1363,7 +1615,7 @@ void ipmc_lib_base_grp_map_tick(ipmc_lib_grp_map_t &grp_map, uint32_t now)
             // entire group.
             if (grp_itr->second.active_ports.is_empty()) {
                 IPMC_LIB_BASE_grp_itr_erase(grp_itr);
-                goto next;
+                continue;
             }
         }
 
@@ -1375,9 +1627,10 @@ void ipmc_lib_base_grp_map_tick(ipmc_lib_grp_map_t &grp_map, uint32_t now)
         // older version host timer has timed out.
         IPMC_LIB_BASE_older_version_host_tick(grp_itr, now);
 
-next:
-        grp_itr = grp_itr_next;
+        grp_timers.visited(grp_key, IPMC_LIB_BASE_grp_next_timeout_get(grp_itr->second), now);
     }
+
+    T_DG(IPMC_LIB_TRACE_GRP_TICK, "Now = %u: Visited %u of %zu groups", now, visit_cnt, grp_map.size());
 }
 
 /******************************************************************************/
@@ -2425,6 +2678,9 @@ static bool IPMC_LIB_BASE_rx_report(ipmc_lib_vlan_state_t &vlan_state, const ipm
         grp_key.vlan_key = vlan_state.vlan_key;
         grp_key.grp_addr = grp_rec.grp_addr;
 
+        // Have the group's deadline recalculated on the next tick.
+        vlan_state.global->lists->grp_timers.touch(grp_key);
+
         if ((grp_itr = grp_map.find(grp_key)) == grp_map.end()) {
             // New group.
 
@@ -3008,6 +3264,9 @@ static void IPMC_LIB_BASE_rx_query(ipmc_lib_vlan_state_t &vlan_state, const ipmc
         goto update_querier_compat;
     }
 
+    // Have the group's deadline recalculated on the next tick.
+    vlan_state.global->lists->grp_timers.touch(grp_key);
+
     T_DG_PORT(IPMC_LIB_TRACE_GRP_RX, port_no, "%s: Found group. Querier state = %d", grp_itr->first, vlan_state.status.querier_state);
     if (vlan_state.status.querier_state != VTSS_APPL_IPMC_LIB_QUERIER_STATE_IDLE) {
         // We are querier. Don't listen to other queriers' queries (except for
@@ -3197,6 +3456,8 @@ void ipmc_lib_base_compatibility_status_update(ipmc_lib_vlan_state_t &vlan_state
         rgcs = new_compat == VTSS_APPL_IPMC_LIB_COMPATIBILITY_OLD || new_compat == VTSS_APPL_IPMC_LIB_COMPATIBILITY_GEN;
     }
 
+    vlan_state.global->lists->grp_timers.touch_all();
+
     grp_itr = grp_map.begin();
     while (grp_itr != grp_map.end()) {
         // Keep an iterator to the next entry, because we might delete the
@@ -3281,6 +3542,8 @@ void ipmc_lib_base_deactivate(ipmc_lib_vlan_state_t &vlan_state)
 
     T_IG(IPMC_LIB_TRACE_GRP_BASE, "%s: Deactivating", vlan_state.vlan_key);
 
+    vlan_state.global->lists->grp_timers.touch_all();
+
     grp_itr = grp_map.begin();
     while (grp_itr != grp_map.end()) {
         // We will delete this group as part of the following, so keep a ptr
@@ -3357,6 +3620,8 @@ void ipmc_lib_base_grp_cnt_max_update(ipmc_lib_global_state_t &glb, mesa_port_no
     }
 
     grp_cnt_cur = 0;
+    glb.lists->grp_timers.touch_all();
+
     grp_itr     = grp_map.begin();
 
     while (grp_itr != grp_map.end()) {
@@ -3405,6 +3670,8 @@ void IPMC_LIB_BASE_router_status_changed(ipmc_lib_global_state_t &glb)
 
     T_IG(IPMC_LIB_TRACE_GRP_BASE, "Router state has changed for one of the ports");
 
+    glb.lists->grp_timers.touch_all();
+
     for (grp_itr = grp_map.begin(); grp_itr != grp_map.end(); grp_itr++) {
         if (static_cast<vtss_appl_ipmc_lib_key_t>(grp_itr->first.vlan_key) != glb.key) {
             // This group is not affected by the router port change.
@@ -3465,12 +3732,15 @@ mesa_port_list_t ipmc_lib_base_router_port_mask_get(ipmc_lib_global_state_t &glb
 /******************************************************************************/
 // ipmc_lib_base_port_down()
 /******************************************************************************/
-void ipmc_lib_base_port_down(ipmc_lib_grp_map_t &grp_map, mesa_port_no_t port_no)
+void ipmc_lib_base_port_down(ipmc_lib_global_lists_t &lists, mesa_port_no_t port_no)
 {
+    ipmc_lib_grp_map_t &grp_map = lists.grp_map;
     ipmc_lib_grp_itr_t grp_itr, grp_itr_next;
 
     T_IG_PORT(IPMC_LIB_TRACE_GRP_BASE, port_no, "Port went down");
 
+    lists.grp_timers.touch_all();
+
     grp_itr = grp_map.begin();
     while (grp_itr != grp_map.end()) {
         // We might delete this group as part of the following, so keep a ptr
@@ -3750,6 +4020,8 @@ void ipmc_lib_base_port_profile_changed(ipmc_lib_global_state_t &glb, mesa_port_
 
     // Go through all groups on this <MVR/IPMC, IGMP/MLD> key and check that
     // they adhere to the new profile on port_no. Delete those that don't.
+    glb.lists->grp_timers.touch_all();
+
     grp_itr = grp_map.begin();
     while (grp_itr != grp_map.end()) {
         grp_itr_next = grp_itr;
@@ -3795,6 +4067,8 @@ void ipmc_lib_base_vlan_profile_changed(ipmc_lib_vlan_state_t &vlan_state)
 
     // Go through all groups on this VLAN and check that they adhere to the new
     // profile. Delete those that don't.
+    vlan_state.global->lists->grp_timers.touch_all();
+
     grp_itr = grp_map.begin();
     while (grp_itr != grp_map.end()) {
         grp_itr_next = grp_itr;
@@ -3843,6 +4117,8 @@ void ipmc_lib_base_vlan_compatible_mode_changed(ipmc_lib_vlan_state_t &vlan_stat
 
     // New mode disallows IGMP/MLD reports on source ports. Remove the groups if
     // we saw some.
+    vlan_state.global->lists->grp_timers.touch_all();
+
     grp_itr = grp_map.begin();
     while (grp_itr != grp_map.end()) {
         grp_itr_next = grp_itr;
@@ -3896,6 +4172,8 @@ void ipmc_lib_base_vlan_port_role_changed(ipmc_lib_vlan_state_t &vlan_state, mes
     // Port is now a source port (was something else before) and the VLAN is
     // configured not to receive IGMP/MLD reports on source ports. Go remove
     // those groups where port_no is active.
+    vlan_state.global->lists->grp_timers.touch_all();
+
     grp_itr = grp_map.begin();
     while (grp_itr != grp_map.end()) {
         grp_itr_next = grp_itr;
@@ -3928,10 +4206,13 @@ next:
 // In either case, we must update all MESA entries to include or exclude those
 // other ports.
 /******************************************************************************/
-void ipmc_lib_base_aggr_port_update(ipmc_lib_grp_map_t &grp_map, mesa_port_no_t port_no)
+void ipmc_lib_base_aggr_port_update(ipmc_lib_global_lists_t &lists, mesa_port_no_t port_no)
 {
+    ipmc_lib_grp_map_t &grp_map = lists.grp_map;
     ipmc_lib_grp_itr_t grp_itr;
 
+    lists.grp_timers.touch_all();
+
     for (grp_itr = grp_map.begin(); grp_itr != grp_map.end(); ++grp_itr) {
         if (!grp_itr->second.active_ports[port_no]) {
             // This group is not affected by the aggregation change.
@@ -30,6 +30,7 @@
 #include <vtss/basics/set.hxx>
 #include <vtss/basics/map.hxx>
 #include <vtss/appl/ipmc_lib.h>
+#include "ipmc_lib_timer.hxx"
 
 // Number of ports on DUT.
 extern uint32_t IPMC_LIB_port_cnt;
@@ -602,6 +603,51 @@ typedef ipmc_lib_grp_map_t::const_iterator                  ipmc_lib_grp_const_i
 typedef vtss::Map<ipmc_lib_grp_key_t, struct ipmc_lib_vlan_state_s *> ipmc_lib_proxy_grp_map_t;
 typedef ipmc_lib_proxy_grp_map_t::iterator                            ipmc_lib_proxy_grp_map_itr_t;
 
+// Key of a <G, S> entry in MESA's IP multicast table. S is 0.0.0.0 or :: for
+// the ASM entry.
+typedef struct {
+    ipmc_lib_grp_key_t      grp_key;
+    vtss_appl_ipmc_lib_ip_t sip;
+} ipmc_lib_hw_key_t;
+
+bool operator<(const ipmc_lib_hw_key_t &lhs, const ipmc_lib_hw_key_t &rhs);
+
+// Pending update of a <G, S> entry in MESA. Only the last update of an entry
+// is kept until the pending updates are flushed.
+typedef struct {
+    // true to add or update the entry, false to delete it.
+    bool add;
+
+    // Ports to forward to when add is true.
+    mesa_port_list_t fwd_list;
+} ipmc_lib_hw_update_t;
+
+typedef struct {
+    // Number of times an entry was requested added, updated or deleted.
+    uint64_t requested;
+
+    // Number of requests replaced by a later request for the same entry before
+    // being flushed.
+    uint64_t coalesced;
+
+    // Number of flushed updates that didn't require a MESA call, because the
+    // entry was already as requested.
+    uint64_t unchanged;
+
+    // Number of mesa_ipvX_mc_add()/del() calls issued.
+    uint64_t issued;
+
+    // Number of mesa_ipvX_mc_add() calls that failed.
+    uint64_t failed;
+
+    // Number of times pending updates were flushed.
+    uint64_t flushes;
+} ipmc_lib_hw_statistics_t;
+
+// Index of groups ordered by the next time one of their group, source, query
+// retransmission or older version host present timers fires.
+typedef ipmc_lib_timer_index_t<ipmc_lib_grp_key_t> ipmc_lib_grp_timer_index_t;
+
 // There is one such instance shared by both IPMC and MVR - as well as IGMP and
 // MLD.
 typedef struct {
@@ -612,6 +658,24 @@ typedef struct {
     // Only used by IPMC.
     ipmc_lib_proxy_grp_map_t proxy_grp_map;
 
+    // Deadlines of the groups in grp_map, so that the group tick only needs to
+    // visit groups that have timers firing. Code that modifies a group outside
+    // of the tick must touch() it (or touch_all() if iterating over all).
+    ipmc_lib_grp_timer_index_t grp_timers;
+
+    // MESA <G, S> entries currently installed and the ports they forward to.
+    vtss::Map<ipmc_lib_hw_key_t, mesa_port_list_t> hw_fwd_lists;
+
+    // Updates of MESA <G, S> entries not yet written. Updates requested by
+    // hw_batch_thread (the Rx thread while it is processing PDUs) are flushed
+    // when there are too many of them or the oldest of them is too old.
+    // Updates requested by any other thread (tick, management, port changes)
+    // flush all pending updates immediately.
+    vtss::Map<ipmc_lib_hw_key_t, ipmc_lib_hw_update_t> hw_pending;
+    uint64_t                                           hw_pending_msec;
+    vtss_handle_t                                      hw_batch_thread;
+    ipmc_lib_hw_statistics_t                           hw_statistics;
+
     // Aggregation port masks. If there are no aggregations, these port masks
     // are empty. If e.g. port_no is != 7 and aggregated with port 7,
     // then aggr_port_masks[port_no][7] is set and other bits are cleared.
@@ -694,7 +758,7 @@ mesa_port_list_t ipmc_lib_base_router_port_mask_get(ipmc_lib_global_state_t &glb
 //   proxy_report_tick: Once per second
 //   vlan_tick:         Once per second per VLAN
 //   global_tick:       Once per second per protocol (IPMC/MVR) per IP family (IGMP/MLD)
-void ipmc_lib_base_grp_map_tick(ipmc_lib_grp_map_t &grp_map, uint32_t now);
+void ipmc_lib_base_grp_map_tick(ipmc_lib_global_lists_t &lists, uint32_t now);
 void ipmc_lib_base_proxy_report_tick(ipmc_lib_proxy_grp_map_t &proxy_grp_map);
 void ipmc_lib_base_vlan_tick(ipmc_lib_vlan_state_t &vlan_state, uint32_t now);
 void ipmc_lib_base_global_tick(ipmc_lib_global_state_t &glb);
@@ -705,7 +769,7 @@ void ipmc_lib_base_grp_cnt_max_update(ipmc_lib_global_state_t &glb, mesa_port_no
 void ipmc_lib_base_querier_state_update(ipmc_lib_vlan_state_t &vlan_state);
 void ipmc_lib_base_compatibility_status_update(ipmc_lib_vlan_state_t &vlan_state, vtss_appl_ipmc_lib_compatibility_t old_compat);
 void ipmc_lib_base_proxy_grp_map_clear(ipmc_lib_vlan_state_t &vlan_state);
-void ipmc_lib_base_port_down(ipmc_lib_grp_map_t &grp_map, mesa_port_no_t port_no);
+void ipmc_lib_base_port_down(ipmc_lib_global_lists_t &lists, mesa_port_no_t port_no);
 void ipmc_lib_base_router_status_update(ipmc_lib_global_state_t &glb, mesa_port_no_t port_no, bool dynamic, bool add);
 void ipmc_lib_base_deactivate(ipmc_lib_vlan_state_t &vlan_state);
 void ipmc_lib_base_stp_forwarding_set(ipmc_lib_vlan_state_t &vlan_state, mesa_port_no_t port_no);
@@ -713,7 +777,10 @@ void ipmc_lib_base_port_profile_changed(ipmc_lib_global_state_t &glb, mesa_port_
 void ipmc_lib_base_vlan_profile_changed(ipmc_lib_vlan_state_t &vlan_state);
 void ipmc_lib_base_vlan_compatible_mode_changed(ipmc_lib_vlan_state_t &vlan_state);
 void ipmc_lib_base_vlan_port_role_changed(ipmc_lib_vlan_state_t &vlan_state, mesa_port_no_t port_no);
-void ipmc_lib_base_aggr_port_update(ipmc_lib_grp_map_t &grp_map, mesa_port_no_t port_no);
+void ipmc_lib_base_aggr_port_update(ipmc_lib_global_lists_t &lists, mesa_port_no_t port_no);
+void ipmc_lib_base_hw_batch_begin(ipmc_lib_global_lists_t &lists);
+void ipmc_lib_base_hw_batch_end(ipmc_lib_global_lists_t &lists);
+void ipmc_lib_base_hw_flush(ipmc_lib_global_lists_t &lists);
 
 #endif /* _IPMC_LIB_BASE_HXX_ */
 
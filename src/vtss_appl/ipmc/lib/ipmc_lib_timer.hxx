@@ -0,0 +1,159 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#ifndef _IPMC_LIB_TIMER_HXX_
+#define _IPMC_LIB_TIMER_HXX_
+
+#include <vtss/basics/set.hxx>
+#include <vtss/basics/deadline-index.hxx>
+
+/******************************************************************************/
+// ipmc_lib_timer_deadline_t
+//
+// Collects the earliest of a number of absolute timeouts (in seconds since
+// boot) of a key, which is the deadline to give it in ipmc_lib_timer_index_t.
+/******************************************************************************/
+struct ipmc_lib_timer_deadline_t {
+    // Add a timer. A timeout of 0 means that the timer isn't running.
+    void timer(uint32_t timeout)
+    {
+        if (timeout && (deadline == 0 || deadline > timeout)) {
+            deadline = timeout;
+        }
+    }
+
+    // Add a timer that the tick treats as expired when its timeout is 0.
+    void timer_expired_if_zero(uint32_t timeout)
+    {
+        timer(timeout ? timeout : 1);
+    }
+
+    // The earliest timeout added, or 0 if none of the timers are running.
+    uint32_t deadline = 0;
+};
+
+/******************************************************************************/
+// ipmc_lib_timer_index_t
+//
+// Orders keys (multicast groups in the IPMC library) by the absolute time (in
+// seconds since boot) at which they next need attention from the once-per-
+// second tick, so that the tick only visits keys whose timers actually fire
+// rather than walking all of them.
+//
+// The owner of the index is responsible for calculating a key's deadline. As
+// this may depend on many timers that are updated in many places, keys may
+// instead be touched whenever they are looked up for modification, and their
+// deadlines are then recalculated in one go by the owner prior to the next
+// tick (see touched_get()).
+//
+// A deadline of 0 means that the key doesn't have any running timers.
+/******************************************************************************/
+template <typename KEY>
+struct ipmc_lib_timer_index_t : public vtss::DeadlineIndex<KEY> {
+    // Remove a key from the index, e.g. because it is about to be deleted.
+    void del(const KEY &key)
+    {
+        vtss::DeadlineIndex<KEY>::del(key);
+        touched.erase(key);
+    }
+
+    // Mark a key as subject to having its deadline recalculated.
+    void touch(const KEY &key)
+    {
+        if (!touched_all) {
+            (void)touched.insert(key);
+        }
+    }
+
+    // Mark all keys as subject to having their deadlines recalculated. Used
+    // by events that iterate over all keys anyway.
+    void touch_all(void)
+    {
+        touched_all = true;
+        touched.clear();
+    }
+
+    // Get the keys touched since last call to touched_clear(). If all_ is
+    // returned as true, all keys must be recalculated and the returned set
+    // is empty.
+    const vtss::Set<KEY> &touched_get(bool &all_) const
+    {
+        all_ = touched_all;
+        return touched;
+    }
+
+    void touched_clear(void)
+    {
+        touched_all = false;
+        touched.clear();
+    }
+
+    // Recalculate the deadlines of the keys touched since last call, with
+    // deadline_get(map value) returning the deadline of a key in #map. To be
+    // called prior to each tick. Keys no longer in #map must already have
+    // been del()'ed.
+    template <typename MAP, typename DEADLINE_GET>
+    void touched_update(MAP &map, DEADLINE_GET deadline_get)
+    {
+        if (touched_all) {
+            for (auto itr = map.begin(); itr != map.end(); ++itr) {
+                this->set(itr->first, deadline_get(itr->second));
+            }
+        } else {
+            for (const auto &key : touched) {
+                auto itr = map.find(key);
+
+                if (itr != map.end()) {
+                    this->set(key, deadline_get(itr->second));
+                }
+            }
+        }
+
+        touched_clear();
+    }
+
+    // Give a key returned by expired_get() its new deadline after the tick at
+    // #now has visited it. Timers that are still expired (e.g. a query
+    // retransmission with no retransmissions left) are checked again on the
+    // next tick, just like when walking all keys.
+    void visited(const KEY &key, uint32_t deadline, uint32_t now)
+    {
+        this->set(key, deadline && deadline <= now ? now + 1 : deadline);
+    }
+
+    void clear(void)
+    {
+        vtss::DeadlineIndex<KEY>::clear();
+        touched_clear();
+    }
+
+private:
+    // Keys touched since last tick.
+    vtss::Set<KEY> touched;
+    bool           touched_all = false;
+};
+
+#endif /* _IPMC_LIB_TIMER_HXX_ */
@@ -0,0 +1,428 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Trace replay test (see trace_replay.hxx) of the group timer index
+// (ipmc_lib_timer.hxx), replaying a random join/leave trace against a model of
+// the IPMC library's groups with per-port group timers, per-port-per-source
+// timers and group-specific query retransmissions, all as absolute times like
+// in ipmc_lib_base.hxx. Groups are ticked once per second:
+//   walk : Every group is visited, which is what ipmc_lib_base_grp_map_tick()
+//          used to do.
+//   index: Groups are touched when modified by the trace, and only groups whose
+//          deadline has been reached are visited, like
+//          ipmc_lib_base_grp_map_tick() does now.
+// The count option is -g <groups> (default: 2000).
+
+#include "ipmc_lib_timer.hxx"
+#include "trace_replay.hxx"
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#define TEST_PORT_CNT 16
+#define TEST_SRC_CNT   4
+#define TEST_GMI      260 // Group membership interval
+#define TEST_LMQI       1 // Last member query interval
+#define TEST_LMQC       2 // Last member query count
+
+typedef struct test_grp_key_s {
+    uint16_t vid;
+    uint32_t grp_addr;
+
+    bool operator<(const test_grp_key_s &rhs) const
+    {
+        return vid != rhs.vid ? vid < rhs.vid : grp_addr < rhs.grp_addr;
+    }
+} test_grp_key_t;
+
+typedef struct {
+    bool     active;
+    uint32_t grp_timeout;
+    uint32_t src_timeout[TEST_SRC_CNT];
+    uint32_t query_timeout;
+    uint32_t tx_cnt_left;
+} test_grp_port_t;
+
+typedef struct {
+    test_grp_port_t ports[TEST_PORT_CNT];
+} test_grp_t;
+
+typedef std::map<test_grp_key_t, test_grp_t> test_grp_map_t;
+
+typedef struct {
+    test_grp_map_t                          grp_map;
+    ipmc_lib_timer_index_t<test_grp_key_t>  grp_timers;
+    bool                                    use_index;
+    std::vector<std::string>                events;
+    uint64_t                                visit_cnt;
+    uint64_t                                wakeup_cnt;
+} test_state_t;
+
+static void test_event(test_state_t &s, uint32_t now, const test_grp_key_t &key, const char *what, int port, int src = -1)
+{
+    char buf[100];
+
+    snprintf(buf, sizeof(buf), "%6u %4u %08x %-10s %2d %2d", now, key.vid, key.grp_addr, what, port, src);
+    s.events.push_back(buf);
+}
+
+// Corresponds to IPMC_LIB_BASE_grp_next_timeout_get().
+static uint32_t test_grp_next_timeout_get(const test_grp_t &grp)
+{
+    ipmc_lib_timer_deadline_t d;
+    int                       port, src;
+
+    for (port = 0; port < TEST_PORT_CNT; port++) {
+        const test_grp_port_t &p = grp.ports[port];
+
+        if (!p.active) {
+            continue;
+        }
+
+        // Like the group timer, test_grp_tick() fires a zero one right away.
+        d.timer_expired_if_zero(p.grp_timeout);
+        d.timer(p.query_timeout);
+        for (src = 0; src < TEST_SRC_CNT; src++) {
+            d.timer(p.src_timeout[src]);
+        }
+    }
+
+    return d.deadline;
+}
+
+// Corresponds to the per-group tick functions. Returns false if the group has
+// no more active ports and must be deleted.
+static bool test_grp_tick(test_state_t &s, const test_grp_key_t &key, test_grp_t &grp, uint32_t now)
+{
+    bool active = false;
+    int  port, src;
+
+    s.visit_cnt++;
+
+    for (port = 0; port < TEST_PORT_CNT; port++) {
+        test_grp_port_t &p = grp.ports[port];
+
+        if (!p.active) {
+            continue;
+        }
+
+        for (src = 0; src < TEST_SRC_CNT; src++) {
+            if (p.src_timeout[src] && p.src_timeout[src] <= now) {
+                test_event(s, now, key, "src", port, src);
+                p.src_timeout[src] = 0;
+            }
+        }
+
+        if (p.query_timeout && p.query_timeout <= now) {
+            test_event(s, now, key, "query", port);
+            p.query_timeout = --p.tx_cnt_left ? now + TEST_LMQI : 0;
+        }
+
+        if (p.grp_timeout <= now) {
+            test_event(s, now, key, "grp", port);
+            memset(&p, 0, sizeof(p));
+            continue;
+        }
+
+        active = true;
+    }
+
+    return active;
+}
+
+static void test_walk_tick(test_state_t &s, uint32_t now)
+{
+    test_grp_map_t::iterator itr, itr_next;
+
+    s.wakeup_cnt += !s.grp_map.empty();
+
+    for (itr = s.grp_map.begin(); itr != s.grp_map.end(); itr = itr_next) {
+        itr_next = itr;
+        ++itr_next;
+
+        if (!test_grp_tick(s, itr->first, itr->second, now)) {
+            s.grp_map.erase(itr);
+        }
+    }
+}
+
+// Corresponds to ipmc_lib_base_grp_map_tick().
+static void test_index_tick(test_state_t &s, uint32_t now)
+{
+    test_grp_map_t::iterator itr;
+    test_grp_key_t           key;
+
+    s.grp_timers.touched_update(s.grp_map, test_grp_next_timeout_get);
+
+    if (s.grp_timers.next_get() && s.grp_timers.next_get() <= now) {
+        s.wakeup_cnt++;
+    }
+
+    while (s.grp_timers.expired_get(now, key)) {
+        if ((itr = s.grp_map.find(key)) == s.grp_map.end()) {
+            fprintf(stderr, "Group %u/%08x in index, but not in map\n", key.vid, key.grp_addr);
+            exit(1);
+        }
+
+        if (!test_grp_tick(s, key, itr->second, now)) {
+            s.grp_timers.del(key);
+            s.grp_map.erase(itr);
+            continue;
+        }
+
+        s.grp_timers.visited(key, test_grp_next_timeout_get(itr->second), now);
+    }
+}
+
+// Trace operations
+typedef enum {
+    TEST_OP_JOIN,      // IGMPv2 report: (Re)start the group timer
+    TEST_OP_SRC_JOIN,  // IGMPv3 IS_IN report: (Re)start a source timer
+    TEST_OP_LEAVE,     // IGMPv2 leave: Lower the group timer and start queries
+    TEST_OP_PORT_DOWN, // Port down: Remove the port from all groups (touch_all)
+} test_op_t;
+
+typedef struct {
+    uint32_t       now;
+    test_op_t      op;
+    test_grp_key_t key;
+    int            port;
+    int            src;
+} test_trace_t;
+
+static void test_apply(test_state_t &s, const test_trace_t &t)
+{
+    test_grp_map_t::iterator itr, itr_next;
+    int                      port;
+
+    if (t.op == TEST_OP_PORT_DOWN) {
+        if (s.use_index) {
+            s.grp_timers.touch_all();
+        }
+
+        for (itr = s.grp_map.begin(); itr != s.grp_map.end(); itr = itr_next) {
+            itr_next = itr;
+            ++itr_next;
+
+            memset(&itr->second.ports[t.port], 0, sizeof(itr->second.ports[t.port]));
+
+            // Like ipmc_lib_base_port_down(), remove groups without active
+            // ports right away.
+            for (port = 0; port < TEST_PORT_CNT; port++) {
+                if (itr->second.ports[port].active) {
+                    break;
+                }
+            }
+
+            if (port == TEST_PORT_CNT) {
+                if (s.use_index) {
+                    s.grp_timers.del(itr->first);
+                }
+
+                s.grp_map.erase(itr);
+            }
+        }
+
+        return;
+    }
+
+    if (s.use_index) {
+        s.grp_timers.touch(t.key);
+    }
+
+    if ((itr = s.grp_map.find(t.key)) == s.grp_map.end()) {
+        if (t.op == TEST_OP_LEAVE) {
+            // Leave on unregistered group.
+            return;
+        }
+
+        itr = s.grp_map.insert(std::make_pair(t.key, test_grp_t())).first;
+        memset(&itr->second, 0, sizeof(itr->second));
+    }
+
+    test_grp_port_t &p = itr->second.ports[t.port];
+
+    switch (t.op) {
+    case TEST_OP_JOIN:
+        p.active      = true;
+        p.grp_timeout = t.now + TEST_GMI;
+        break;
+
+    case TEST_OP_SRC_JOIN:
+        if (!p.active) {
+            p.active      = true;
+            p.grp_timeout = t.now + TEST_GMI;
+        }
+
+        p.src_timeout[t.src] = t.now + TEST_GMI;
+        break;
+
+    case TEST_OP_LEAVE:
+        if (!p.active) {
+            break;
+        }
+
+        if (p.grp_timeout > t.now + TEST_LMQI * TEST_LMQC) {
+            p.grp_timeout = t.now + TEST_LMQI * TEST_LMQC;
+        }
+
+        // Tx the first query on the next tick.
+        p.query_timeout = t.now;
+        p.tx_cnt_left   = TEST_LMQC;
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void test_run(test_state_t &s, const std::vector<test_trace_t> &trace, uint32_t seconds)
+{
+    size_t   i = 0;
+    uint32_t now;
+
+    for (now = 1; now <= seconds; now++) {
+        for (; i < trace.size() && trace[i].now == now; i++) {
+            test_apply(s, trace[i]);
+        }
+
+        if (s.use_index) {
+            test_index_tick(s, now);
+        } else {
+            test_walk_tick(s, now);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<test_trace_t> trace;
+    test_trace_t              t;
+    test_state_t              walk, index;
+    trace_replay_opts_t       o;
+    uint32_t                  e, i;
+
+    o.cnt = 2000;
+    if (!trace_replay_opts_get(argc, argv, 'g', "groups", o)) {
+        return 1;
+    }
+
+    if (o.cnt == 0) {
+        o.cnt = 1;
+    }
+
+    // The trace starts with all groups being joined on a random port during
+    // the first minute, followed by random joins and leaves. Hosts re-join
+    // well within the group membership interval, so most groups stay alive.
+    for (i = 0; i < o.cnt; i++) {
+        t.now          = 1 + rand() % 60;
+        t.op           = TEST_OP_JOIN;
+        t.key.vid      = 1 + i % 4;
+        t.key.grp_addr = 0xe0000100 + i;
+        t.port         = rand() % TEST_PORT_CNT;
+        t.src          = 0;
+        trace.push_back(t);
+    }
+
+    for (t.now = 61; t.now <= o.seconds; t.now++) {
+        for (e = 0; e < o.events_per_sec; e++) {
+            i              = rand() % o.cnt;
+            t.key.vid      = 1 + i % 4;
+            t.key.grp_addr = 0xe0000100 + i;
+            t.port         = rand() % TEST_PORT_CNT;
+            t.src          = rand() % TEST_SRC_CNT;
+
+            switch (rand() % 10) {
+            case 0:
+            case 1:
+            case 2:
+                t.op = TEST_OP_LEAVE;
+                break;
+
+            case 3:
+            case 4:
+                t.op = TEST_OP_SRC_JOIN;
+                break;
+
+            default:
+                t.op = TEST_OP_JOIN;
+                break;
+            }
+
+            trace.push_back(t);
+        }
+
+        if (t.now % 600 == 0) {
+            t.op = TEST_OP_PORT_DOWN;
+            trace.push_back(t);
+        }
+    }
+
+    // Stable sort of the initial joins by time.
+    std::stable_sort(trace.begin(), trace.end(), [](const test_trace_t &a, const test_trace_t &b) {
+        return a.now < b.now;
+    });
+
+    walk.use_index   = false;
+    walk.visit_cnt   = 0;
+    walk.wakeup_cnt  = 0;
+    index.use_index  = true;
+    index.visit_cnt  = 0;
+    index.wakeup_cnt = 0;
+
+    test_run(walk,  trace, o.seconds);
+    test_run(index, trace, o.seconds);
+
+    // Within a tick, the walk visits groups by key and the index by deadline,
+    // so compare the events of each tick without regard to order.
+    std::sort(walk.events.begin(),  walk.events.end());
+    std::sort(index.events.begin(), index.events.end());
+
+    if (!trace_replay_compare(trace.size(), "groups", o,
+                              {"walk",  walk.visit_cnt,  walk.wakeup_cnt,  &walk.events,  walk.grp_map.size()},
+                              {"index", index.visit_cnt, index.wakeup_cnt, &index.events, index.grp_map.size()})) {
+        return 1;
+    }
+
+    if (index.grp_timers.size() != index.grp_map.size()) {
+        fprintf(stderr, "Group count differs from index size\n");
+        return 1;
+    }
+
+    for (const auto &g : walk.grp_map) {
+        auto itr = index.grp_map.find(g.first);
+
+        if (itr == index.grp_map.end() || memcmp(&g.second, &itr->second, sizeof(g.second))) {
+            fprintf(stderr, "Group %u/%08x differs\n", g.first.vid, g.first.grp_addr);
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -41,6 +41,43 @@ void json_node_add(expose::json::Node *node);
 
 JsonInventoryPtr json_rpc_inventory_get(bool specific);
 
+// Accounting of the requests served on /json_rpc. The buffer peak is the most
+// memory held by output buffers while a request was handled.
+typedef struct {
+    uint64_t requests;         // Requests handled
+    uint64_t streamed;         // Responses too large to be buffered completely
+    uint64_t bytes_out;        // Response bytes, not counting HTTP headers
+    uint64_t buffer_peak_last; // Buffer peak of the latest request
+    uint64_t buffer_peak_sum;  // Sum of the buffer peaks of all requests
+    uint64_t buffer_peak_max;  // Largest buffer peak of any request
+} json_rpc_statistics_t;
+
+void json_rpc_statistics_get(json_rpc_statistics_t *statistics);
+void json_rpc_statistics_clear();
+
+// Times the lookup of every registered method, by the tree search and through
+// the method index which is built when the startup-config has been loaded.
+typedef struct {
+    uint32_t methods;  // Registered methods
+    uint32_t rounds;   // Lookups per method
+    uint32_t misses;   // Methods the tree search did not find
+    bool     frozen;   // Whether the method index is in use
+    uint64_t tree_ns;  // Average time of a lookup by the tree search
+    uint64_t index_ns; // Average time of a lookup through the index
+} json_rpc_dispatch_benchmark_t;
+
+mesa_rc json_rpc_dispatch_benchmark(uint32_t rounds,
+                                    json_rpc_dispatch_benchmark_t *res);
+
+// Read-only calls ("get" and "itr") in a row in a batch request are run
+// concurrently by up to this many worker threads besides the requesting one.
+// Calls which may change something are always run in order, one at a time.
+// 0 runs all calls in order (default, see "batch_workers" in the module conf).
+#define JSON_RPC_BATCH_WORKERS_MAX 16
+
+mesa_rc json_rpc_batch_workers_set(uint32_t cnt);
+uint32_t json_rpc_batch_workers_get();
+
 }  // namespace vtss
 
 #endif  // __JSON_RPC_API_HXX__
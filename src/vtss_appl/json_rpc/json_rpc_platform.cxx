@@ -27,6 +27,9 @@
 #include "json_rpc_trace.h"
 
 #include "main.h"
+#include "chrono.hxx"
+#include "critd_api.h"
+#include "main_conf.hxx"  // For vtss::appl::main::module_conf_get()
 #include "vtss_trace_api.h"
 
 #include "fast_cgi_api.hxx"
@@ -49,6 +52,7 @@
 #include "vtss/basics/expose/json/root-node.hxx"
 #include "vtss/basics/expose/json/method-split.hxx"
 #include "vtss/basics/expose/json/namespace-node.hxx"
+#include "vtss/basics/expose/json/spill-stream.hxx"
 #include "vtss/basics/expose/json/json-value-ptr-impl.hxx"
 #include "vtss/basics/expose/json/specification/walk.hxx"
 #include "vtss/basics/expose/json/specification/reflector-echo.hxx"
@@ -89,6 +93,16 @@ static vtss_trace_grp_t trace_grps[] =
 
 VTSS_TRACE_REGISTER(&trace_reg, trace_grps);
 
+// Size of the buffer in front of the HTTP output
+#define JSON_RPC_OUTPUT_BUFFER_SIZE 8192
+
+#define JSON_RPC_CRIT_ENTER() critd_enter(&json_rpc_crit, __FUNCTION__, __LINE__)
+#define JSON_RPC_CRIT_EXIT()  critd_exit( &json_rpc_crit, __FUNCTION__, __LINE__)
+
+// Protects json_rpc_statistics
+static critd_t json_rpc_crit;
+static json_rpc_statistics_t json_rpc_statistics;
+
 class json_http_req {
   public:
     json_http_req(CYG_HTTPD_STATE *init);
@@ -133,6 +147,164 @@ void json_http_req::write(std::string &s) {
     }
 }
 
+static bool json_http_send(const char *buf, size_t size) {
+    size_t cnt = 0;
+    ssize_t res = 0;
+
+    while (cnt < size) {
+        res = cyg_httpd_write_chunked(buf + cnt, size - cnt);
+
+        if (res >= 0) {
+            cnt += res;
+        } else {
+            T_I("Failed to write msg res=" VPRIz ", cnt=" VPRIz ", size=" VPRIz,
+                res, cnt, size);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool write_hdr(ostream &o, json::Result::Code res, size_t length,
+               bool streamed = false);
+
+// Output of a json-rpc request. A response which fits in the buffer is sent
+// when complete, with the status code of the request and a Content-Length. A
+// larger response is sent as the buffer fills up, with status 200 and no
+// Content-Length, which the web server passes on as a chunked response. An
+// error found after that is reported inside the JSON-RPC response, as the
+// status line has already gone.
+class json_http_stream : public ostreamBuf {
+  public:
+    json_http_stream() { buf.reserve(JSON_RPC_OUTPUT_BUFFER_SIZE); }
+    ~json_http_stream() { expose::json::buffer_usage_update(buf.size(), 0); }
+
+    bool ok() const { return ok_; }
+    bool push(char c) { return write(&c, &c + 1) == 1; }
+    size_t write(const char *b, const char *e);
+
+    const char *begin() const { return buf.c_str(); }
+    const char *end() const { return buf.c_str() + buf.size(); }
+    void clear();
+
+    bool streaming() const { return true; }
+    bool retractable() const { return !streamed_; }
+
+    // Send what is still buffered, preceded by the header if nothing has
+    // been sent yet.
+    void finish(json::Result::Code res);
+
+    bool streamed() const { return streamed_; }
+    uint64_t bytes() const { return bytes_; }
+
+  private:
+    void flush();
+
+    std::string buf;
+    bool ok_ = true;
+    bool streamed_ = false;
+    uint64_t bytes_ = 0;  // Body bytes written
+};
+
+size_t json_http_stream::write(const char *b, const char *e) {
+    size_t len = e - b;
+
+    bytes_ += len;
+    while (b != e) {
+        size_t old_size = buf.size();
+        size_t cnt = JSON_RPC_OUTPUT_BUFFER_SIZE - old_size;
+
+        if (cnt > (size_t)(e - b)) {
+            cnt = e - b;
+        }
+
+        buf.append(b, cnt);
+        expose::json::buffer_usage_update(old_size, buf.size());
+        b += cnt;
+
+        if (buf.size() == JSON_RPC_OUTPUT_BUFFER_SIZE) {
+            flush();
+        }
+    }
+
+    return len;
+}
+
+void json_http_stream::clear() {
+    // Only what has not been sent can be dropped
+    bytes_ -= buf.size();
+    expose::json::buffer_usage_update(buf.size(), 0);
+    buf.clear();
+}
+
+void json_http_stream::flush() {
+    if (!streamed_) {
+        StringStream header;
+
+        T_D("Response exceeds " VPRIz " bytes, streaming it",
+            (size_t)JSON_RPC_OUTPUT_BUFFER_SIZE);
+        (void)write_hdr(header, json::Result::OK, 0, true);
+        ok_ = json_http_send(header.begin(), header.buf.size());
+        streamed_ = true;
+    }
+
+    if (ok_) {
+        ok_ = json_http_send(begin(), buf.size());
+    }
+
+    expose::json::buffer_usage_update(buf.size(), 0);
+    buf.clear();
+}
+
+void json_http_stream::finish(json::Result::Code res) {
+    if (!streamed_) {
+        StringStream header;
+
+        (void)write_hdr(header, res, buf.size());
+        ok_ = json_http_send(header.begin(), header.buf.size());
+    }
+
+    if (ok_ && buf.size()) {
+        ok_ = json_http_send(begin(), buf.size());
+    }
+
+    expose::json::buffer_usage_update(buf.size(), 0);
+    buf.clear();
+}
+
+static void json_rpc_statistics_update(const json_http_stream &output,
+                                       size_t peak) {
+    JSON_RPC_CRIT_ENTER();
+    json_rpc_statistics.requests++;
+    if (output.streamed()) {
+        json_rpc_statistics.streamed++;
+    }
+    json_rpc_statistics.bytes_out += output.bytes();
+    json_rpc_statistics.buffer_peak_last = peak;
+    json_rpc_statistics.buffer_peak_sum += peak;
+    if (peak > json_rpc_statistics.buffer_peak_max) {
+        json_rpc_statistics.buffer_peak_max = peak;
+    }
+    JSON_RPC_CRIT_EXIT();
+}
+
+void json_rpc_statistics_get(json_rpc_statistics_t *statistics) {
+    if (!statistics) {
+        return;
+    }
+
+    JSON_RPC_CRIT_ENTER();
+    *statistics = json_rpc_statistics;
+    JSON_RPC_CRIT_EXIT();
+}
+
+void json_rpc_statistics_clear() {
+    JSON_RPC_CRIT_ENTER();
+    vtss_clear(json_rpc_statistics);
+    JSON_RPC_CRIT_EXIT();
+}
+
 vtss::expose::json::RootNode JSON_RPC_ROOT;
 
 std::shared_ptr<expose::json::specification::Inventory>
@@ -168,6 +340,238 @@ JsonInventoryPtr json_rpc_inventory_get(bool specific) {
                                        JSON_RPC_ROOT_INVENTORY);
 }
 
+static void json_rpc_methods_get(expose::json::NamespaceNode *ns,
+                                 Vector<std::string> &methods) {
+    for (auto &n : ns->leafs) {
+        if (n.is_namespace_node()) {
+            json_rpc_methods_get(static_cast<expose::json::NamespaceNode *>(&n),
+                                 methods);
+        } else {
+            methods.push_back(n.abs_name());
+        }
+    }
+}
+
+mesa_rc json_rpc_dispatch_benchmark(uint32_t rounds,
+                                    json_rpc_dispatch_benchmark_t *res) {
+    Vector<std::string> methods;
+    uint64_t start, calls;
+    uint32_t r;
+
+    if (!res || !rounds) {
+        return VTSS_RC_ERROR;
+    }
+
+    json_rpc_methods_get(&JSON_RPC_ROOT, methods);
+    if (methods.size() == 0) {
+        return VTSS_RC_ERROR;
+    }
+
+    vtss_clear(*res);
+    res->methods = methods.size();
+    res->rounds = rounds;
+    res->frozen = JSON_RPC_ROOT.frozen();
+    calls = (uint64_t)rounds * methods.size();
+
+    // The tree search, which is what dispatch falls back to
+    start = uptime_microseconds();
+    for (r = 0; r < rounds; r++) {
+        for (const auto &m : methods) {
+            if (!JSON_RPC_ROOT.NamespaceNode::lookup(str(m))) {
+                res->misses++;
+            }
+        }
+    }
+    res->tree_ns = (uptime_microseconds() - start) * 1000 / calls;
+
+    start = uptime_microseconds();
+    for (r = 0; r < rounds; r++) {
+        for (const auto &m : methods) {
+            (void)JSON_RPC_ROOT.lookup(str(m));
+        }
+    }
+    res->index_ns = (uptime_microseconds() - start) * 1000 / calls;
+
+    return VTSS_RC_OK;
+}
+
+// Runs the read-only calls of batch requests on up to
+// JSON_RPC_BATCH_WORKERS_MAX threads. The thread handling the request takes
+// part, so a batch with N calls in a row may use N threads at most.
+class json_rpc_batch_pool : public expose::json::BatchExecutor {
+  public:
+    void init();
+    void workers_set(uint32_t cnt);
+    uint32_t workers_get();
+    void run(Job **jobs, size_t cnt);
+
+  private:
+    // The calls given to run() by one request
+    struct batch_run {
+        Job **jobs;
+        size_t cnt;
+        size_t next;  // Next job to be taken
+        size_t done;  // Jobs which have completed
+        batch_run *q_next;
+
+        // Web request of the requesting thread. Workers run the jobs on
+        // behalf of it, e.g. for users.status.whoami.
+        CYG_HTTPD_STATE *httpstate;
+    };
+
+    static void thread(vtss_addrword_t data);
+    void exec_one(batch_run *r);
+
+    vtss_mutex_t mutex;
+    vtss_cond_t  work;  // Signaled when a run is queued or 'active' changes
+    vtss_cond_t  done;  // Signaled when the last job of a run has completed
+
+    // Runs with jobs not yet taken, oldest first
+    batch_run *q_head = nullptr;
+    batch_run *q_tail = nullptr;
+
+    uint32_t active = 0;   // Workers taking jobs
+    uint32_t created = 0;  // Worker threads created so far, never deleted
+
+    char          names[JSON_RPC_BATCH_WORKERS_MAX][16];
+    vtss_handle_t handles[JSON_RPC_BATCH_WORKERS_MAX];
+    vtss_thread_t blocks[JSON_RPC_BATCH_WORKERS_MAX];
+};
+
+static json_rpc_batch_pool json_rpc_batch_workers;
+
+void json_rpc_batch_pool::init() {
+    vtss_mutex_init(&mutex);
+    vtss_cond_init(&work, &mutex);
+    vtss_cond_init(&done, &mutex);
+}
+
+// Take the next job of 'r' and run it. Called and returns with 'mutex' locked.
+void json_rpc_batch_pool::exec_one(batch_run *r) {
+    Job *job = r->jobs[r->next++];
+
+    if (r->next == r->cnt) {
+        // All jobs taken. Workers take from the head, but the requesting
+        // thread takes from its own run, wherever that is in the queue.
+        batch_run **p = &q_head, *prev = nullptr;
+
+        while (*p != r) {
+            prev = *p;
+            p = &prev->q_next;
+        }
+
+        *p = r->q_next;
+        if (q_tail == r) {
+            q_tail = prev;
+        }
+    }
+
+    vtss_mutex_unlock(&mutex);
+    CYG_HTTPD_STATE *prev = cyg_httpd_state_set(r->httpstate);
+    job->exec();
+    (void)cyg_httpd_state_set(prev);
+    (void)vtss_mutex_lock(&mutex);
+
+    if (++r->done == r->cnt) {
+        vtss_cond_broadcast(&done);
+    }
+}
+
+void json_rpc_batch_pool::thread(vtss_addrword_t data) {
+    json_rpc_batch_pool *pool = &json_rpc_batch_workers;
+    uint32_t id = (uint32_t)(uintptr_t)data;
+
+    (void)vtss_mutex_lock(&pool->mutex);
+    while (1) {
+        if (id >= pool->active || !pool->q_head) {
+            (void)vtss_cond_wait(&pool->work);
+            continue;
+        }
+
+        pool->exec_one(pool->q_head);
+    }
+}
+
+void json_rpc_batch_pool::run(Job **jobs, size_t cnt) {
+    batch_run r = {jobs, cnt, 0, 0, nullptr, cyg_httpd_state_get()};
+
+    if (!cnt) {
+        return;
+    }
+
+    (void)vtss_mutex_lock(&mutex);
+    if (q_tail) {
+        q_tail->q_next = &r;
+    } else {
+        q_head = &r;
+    }
+    q_tail = &r;
+    vtss_cond_broadcast(&work);
+
+    // Rather than waiting, work on our own calls until all are taken. Other
+    // requests' runs are queued in front of this one, so they cannot be
+    // starved by it.
+    while (r.next < r.cnt) {
+        exec_one(&r);
+    }
+
+    while (r.done < r.cnt) {
+        (void)vtss_cond_wait(&done);
+    }
+    vtss_mutex_unlock(&mutex);
+}
+
+void json_rpc_batch_pool::workers_set(uint32_t cnt) {
+    if (cnt > JSON_RPC_BATCH_WORKERS_MAX) {
+        cnt = JSON_RPC_BATCH_WORKERS_MAX;
+    }
+
+    (void)vtss_mutex_lock(&mutex);
+    for (; created < cnt; created++) {
+        T_I("Creating batch worker %u", created);
+        snprintf(names[created], sizeof(names[created]), "JSON_RPC_BATCH_%u", created);
+        vtss_thread_create(VTSS_THREAD_PRIO_DEFAULT,
+                           json_rpc_batch_pool::thread,
+                           (vtss_addrword_t)(uintptr_t)created,
+                           names[created],
+                           nullptr,
+                           0,
+                           &handles[created],
+                           &blocks[created]);
+    }
+
+    active = cnt;
+    vtss_cond_broadcast(&work);
+    vtss_mutex_unlock(&mutex);
+
+    // Runs already given to the pool complete on the requesting threads, if
+    // the workers went away.
+    JSON_RPC_ROOT.batch_executor(cnt ? &json_rpc_batch_workers : nullptr);
+}
+
+uint32_t json_rpc_batch_pool::workers_get() {
+    uint32_t cnt;
+
+    (void)vtss_mutex_lock(&mutex);
+    cnt = active;
+    vtss_mutex_unlock(&mutex);
+
+    return cnt;
+}
+
+mesa_rc json_rpc_batch_workers_set(uint32_t cnt) {
+    if (cnt > JSON_RPC_BATCH_WORKERS_MAX) {
+        return VTSS_RC_ERROR;
+    }
+
+    json_rpc_batch_workers.workers_set(cnt);
+    return VTSS_RC_OK;
+}
+
+uint32_t json_rpc_batch_workers_get() {
+    return json_rpc_batch_workers.workers_get();
+}
+
 void json_node_add(vtss::expose::json::Node *node) {
     // TODO, mutex
     JSON_RPC_ROOT_INVENTORY.reset();
@@ -339,7 +743,8 @@ mesa_rc nodes_generic_get(const std::string *q, Vector<std::string> *nodes) {
 }  // namespace appl
 
 
-bool write_hdr(ostream &o, json::Result::Code res, size_t length) {
+bool write_hdr(ostream &o, json::Result::Code res, size_t length,
+               bool streamed) {
 #define HTTP_RC_FORMAT(_c, _t) "Status: " _c " " _t "\r\n"
     o << "HTTP/1.1 ";
     switch (res) {
@@ -365,7 +770,9 @@ bool write_hdr(ostream &o, json::Result::Code res, size_t length) {
 
     o << "Content-Type: application/json\r\n";
     o << "Cache-Control: no-cache\r\n";
-    o << "Content-Length: " << length << "\r\n";
+    if (!streamed) {
+        o << "Content-Length: " << length << "\r\n";
+    }
     o << "\r\n";
 
     return o.ok();
@@ -385,10 +792,14 @@ static i32 json_http_handler(CYG_HTTPD_STATE *p) {
     T_I("Handling json-rpc request");
 
     json::Result::Code res;
+    size_t peak;
 
     str input(req.post_data());
-    StringStream output;
-    StringStream header;
+
+    // Everything buffered while handling this request counts towards its
+    // memory high-water mark
+    expose::json::buffer_usage_reset();
+    json_http_stream output;
 
     if (!req.is_post()) {
         // TODO, set http error code
@@ -406,32 +817,17 @@ static i32 json_http_handler(CYG_HTTPD_STATE *p) {
         VTSS_TRACE(NOISE) << "Failed to process JSON "
                           << "To be fixed: p->post_data";
 
-    // Check for overflows
+END:
+    output.finish(res);
     if (!output.ok()) {
-        T_I("Output overflow");
-        output.clear();
-        res = json::Result::INTERNAL_ERROR;
-        goto END;
+        T_I("Failed to send output");
     }
 
-    T_I("Result code: %d, output size: " VPRIz, res, output.buf.size());
+    peak = expose::json::buffer_usage_peak();
+    json_rpc_statistics_update(output, peak);
 
-END:
-    if (!write_hdr(header, res, output.buf.size())) {
-        T_I("Output overflow");
-        header.clear();
-        output.clear();
-
-        if (!write_hdr(header, json::Result::INTERNAL_ERROR, output.buf.size())) {
-            T_I("Output overflow - AGAIN!!!");
-            return -1;
-        }
-    }
-
-    req.write(header.buf);
-    if (output.buf.size()) {
-        req.write(output.buf);
-    }
+    T_I("Result code: %d, output size: " VPRI64u "%s, peak buffered: " VPRIz,
+        res, output.bytes(), output.streamed() ? " (streamed)" : "", peak);
     T_I("Done");
     return -1;
 }
@@ -493,10 +889,30 @@ void vtss_appl_json_rpc_json_init();
 
 mesa_rc vtss_json_rpc_init(vtss_init_data_t *data)
 {
+    if (data->cmd == INIT_CMD_INIT) {
+        critd_init(&vtss::json_rpc_crit, "json_rpc", VTSS_MODULE_ID_JSON_RPC,
+                   CRITD_TYPE_MUTEX);
+        vtss::json_rpc_batch_workers.init();
+    }
+
+    if (data->cmd == INIT_CMD_START) {
+        // Concurrent batch calls are opt-in, as all get/itr handlers must then
+        // be safe to call from several threads at a time.
+        auto &c = vtss::appl::main::module_conf_get("json_rpc");
+        (void)vtss::json_rpc_batch_workers_set(c.u32_get("batch_workers", 0));
+    }
+
     if (data->cmd == INIT_CMD_ICFG_LOADING_PRE) {
         VTSS_TRACE(INFO) << "ICFG_LOADING_PRE";
         vtss_appl_json_rpc_json_init();
     }
 
+    if (data->cmd == INIT_CMD_ICFG_LOADING_POST) {
+        // All modules have registered their methods in ICFG_LOADING_PRE. A
+        // method added later makes dispatch fall back to the tree search.
+        VTSS_TRACE(INFO) << "ICFG_LOADING_POST";
+        vtss::JSON_RPC_ROOT.freeze();
+    }
+
     return VTSS_RC_OK;
 }
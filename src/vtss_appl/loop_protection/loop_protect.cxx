@@ -81,6 +81,16 @@ static struct {
     CapArray<vtss_appl_loop_protect_port_info_t, MEBA_CAP_BOARD_PORT_MAP_COUNT> ports;
 } lprot_primary_switch_state[VTSS_ISID_END];
 
+/* PDUs collected by loop_periodic() and sent with one packet_tx_batch() */
+static struct {
+    CapArray<packet_tx_props_t, MEBA_CAP_BOARD_PORT_MAP_COUNT> tx_props;
+    CapArray<mesa_rc, MEBA_CAP_BOARD_PORT_MAP_COUNT> rcs;
+    CapArray<mesa_port_no_t, MEBA_CAP_BOARD_PORT_MAP_COUNT> ports;
+    u32 cnt;
+    /* The Tx info of a port's PDU is the same every time */
+    CapArray<packet_tx_ifh_cache_t, MEBA_CAP_BOARD_PORT_MAP_COUNT> ifh_cache;
+} lprot_tx_batch;
+
 /* Frame data */
 static const u8  dmac[6] = {0x01, 0x01, 0xc1, 0x00, 0x00, 0x00}; /* 01-01-c1-00-00-00 */
 static       u8  switchmac[6];
@@ -517,7 +527,7 @@ static BOOL lprot_egress_filter(mesa_port_no_t egress_port)
     return FALSE;
 }
 
-static void lprot_transmit(vtss_usid_t usid, mesa_port_no_t egress_port, lprot_port_state_t *pstate)
+static void lprot_transmit(vtss_usid_t usid, mesa_port_no_t egress_port, lprot_port_state_t *pstate, BOOL batch = FALSE)
 {
     if (!lprot_egress_filter(egress_port)) {
         vtss_uport_no_t uport = iport2uport(pstate->port);
@@ -543,7 +553,11 @@ static void lprot_transmit(vtss_usid_t usid, mesa_port_no_t egress_port, lprot_p
             pdu->usid = (u16) usid;
             pdu->tstamp = vtss_current_time();
             memcpy(pdu->switchmac, switchmac, sizeof(pdu->switchmac)); /* Own MAC */
-            if(packet_tx(&tx_props) != VTSS_RC_OK)
+            if (batch && lprot_tx_batch.cnt < lprot_tx_batch.tx_props.size()) {
+                tx_props.packet_info.ifh_cache = &lprot_tx_batch.ifh_cache[egress_port];
+                lprot_tx_batch.ports[lprot_tx_batch.cnt] = egress_port;
+                lprot_tx_batch.tx_props[lprot_tx_batch.cnt++] = tx_props;
+            } else if(packet_tx(&tx_props) != VTSS_RC_OK)
                 T_E("transmit fail port %d", uport);
         } else {
             T_E("transmit malloc fail port %d", uport);
@@ -588,14 +602,14 @@ static void lprot_poag_tick(lprot_port_state_t *pstate, const vtss_appl_loop_pro
            pstate->shutdown_timer >= (int)lprot_conf.global.shutdown_time) {
             lprot_enable(pstate);
             if (tx) {
-                lprot_transmit(lprot_state.usid, egress_port, pstate); /* Immediately TX */
+                lprot_transmit(lprot_state.usid, egress_port, pstate, TRUE); /* Immediately TX */
             }
         }
     } else {
         if (pconf->transmit) { /* Are we an active transmitter? */
             pstate->transmit_timer++;
             if (tx && pstate->transmit_timer >= (int)lprot_conf.global.transmission_time) {
-                lprot_transmit(lprot_state.usid, egress_port, pstate);
+                lprot_transmit(lprot_state.usid, egress_port, pstate, TRUE);
             }
         }
     }
@@ -610,6 +624,8 @@ static void loop_periodic(void)
     T_N("loop protect tick");
     if(lprot_conf.global.enabled) {         /* Do we do anything ? */
         port_iter_t pit;
+        u32 i;
+        lprot_tx_batch.cnt = 0;
         /* Ports */
         (void) port_iter_init(&pit, NULL, VTSS_ISID_LOCAL,
                               PORT_ITER_SORT_ORDER_IPORT, PORT_ITER_FLAGS_NORMAL);
@@ -620,6 +636,15 @@ static void loop_periodic(void)
             if(pconf->enabled)
                 lprot_poag_tick(pstate, pconf);
         }
+        /* All ports share the transmission time, so they tend to transmit in the same tick */
+        if (lprot_tx_batch.cnt &&
+            packet_tx_batch(lprot_tx_batch.tx_props.data(), lprot_tx_batch.cnt, lprot_tx_batch.rcs.data()) != VTSS_RC_OK) {
+            for (i = 0; i < lprot_tx_batch.cnt; i++) {
+                if (lprot_tx_batch.rcs[i] != VTSS_RC_OK) {
+                    T_E("transmit fail port %d", iport2uport(lprot_tx_batch.ports[i]));
+                }
+            }
+        }
     }
 }
 
@@ -35,6 +35,8 @@
 #include "packet_api.h"
 #include "misc_api.h"
 #include "l2proto_api.h"
+#include "chrono.hxx"
+#include <vtss/basics/map.hxx>
 #ifdef VTSS_SW_OPTION_ICLI
 #include "mac_icfg.h"
 #endif
@@ -81,6 +83,76 @@ static mac_conf_learn_mode_t       mac_learn_mode;
 /* Learning-disabled VLANS bitmap */
 static u8   lrn_disabled_vids[VTSS_APPL_VLAN_BITMASK_LEN_BYTES];
 
+/* MAC table statistics engine.
+ *
+ * The per-port and per-VLAN counts of learned and static entries are kept in
+ * shadow counters, so that statistics queries do not have to walk the MAC
+ * table. Changes made through this module (static add/delete, flush, port
+ * flush) update the counters directly. Hardware learning and aging do not
+ * report individual entries (the MAC table status only tells that learn/age
+ * events occurred), so when such events are seen, the counters are rebuilt by
+ * a walk. Modules that add or delete entries directly through the API call
+ * mac_stats_table_changed(), which causes a rebuild the same way. Anything
+ * else is picked up by the periodic consistency check, which walks the table
+ * and compares the result with the counters.
+ *
+ * The walk costs in proportion to the number of entries, so rebuilds are at
+ * least mac_stats_sync_interval() seconds apart. That is
+ * MAC_STATS_SYNC_INTERVAL seconds plus one second per
+ * MAC_STATS_SYNC_ENTRIES_PER_SEC entries in the table, but at most
+ * MAC_STATS_SYNC_INTERVAL_MAX seconds. Statistics therefore lag learning and
+ * aging by up to that interval plus MAC_STATS_POLL_INTERVAL_MSEC, i.e. 6
+ * seconds for an empty table and 61 seconds for a table of 55K or more
+ * entries. Changes made through this module are reflected right away. */
+#define MAC_STATS_POLL_INTERVAL_MSEC   1000
+#define MAC_STATS_SYNC_INTERVAL        5
+#define MAC_STATS_SYNC_INTERVAL_MAX    60
+#define MAC_STATS_SYNC_ENTRIES_PER_SEC 1000
+#define MAC_STATS_CHECK_INTERVAL       60
+
+typedef vtss::Map<mesa_vid_t, mac_table_stats_t> mac_stats_vid_map_t;
+
+static struct {
+    critd_t                   crit;
+    vtss_handle_t             thread_handle;
+    vtss_thread_t             thread_block;
+    BOOL                      valid;      /* Counters have been built */
+    BOOL                      dirty;      /* Counters need to be rebuilt */
+    u32                       gen;        /* Incremented on every incremental update */
+    mac_table_stats_t         total;
+    mac_stats_vid_map_t       vid;
+    u64                       sync_time;  /* Uptime (seconds) of the last rebuild */
+    u64                       check_time; /* Uptime (seconds) of the last check */
+    mac_stats_engine_status_t status;
+} mac_stats;
+
+/* Read-ahead caches for get-next walks of the MAC table, one per walker
+ * (thread), so concurrent walkers do not evict each other's entries. The
+ * entries are read with mesa_mac_table_get_next_bulk() and are the ones
+ * following 'key' in the MAC table. If less than MAC_GET_NEXT_CACHE_CNT
+ * entries were read, the end of the table was reached. A walker without a
+ * cache takes over the least recently used one. The caches are invalidated by
+ * changes made through this module, and expire after MAC_GET_NEXT_CACHE_TTL
+ * milliseconds to bound the staleness from learning and aging. */
+#define MAC_GET_NEXT_CACHE_CNT     64
+#define MAC_GET_NEXT_CACHE_WALKERS 4
+#define MAC_GET_NEXT_CACHE_TTL     1000
+
+typedef struct {
+    int                    thread_id; /* Walker owning the cache, 0 if none */
+    BOOL                   valid;
+    u64                    time;      /* Uptime (milliseconds) of the read */
+    u64                    used;      /* Uptime (milliseconds) of the last lookup */
+    mesa_vid_mac_t         key;
+    u32                    cnt;
+    mesa_mac_table_entry_t entry[MAC_GET_NEXT_CACHE_CNT];
+} mac_get_next_cache_t;
+
+static struct {
+    critd_t              crit;
+    mac_get_next_cache_t walker[MAC_GET_NEXT_CACHE_WALKERS];
+} mac_get_next_cache;
+
 /* Forced learning mode - only kept in memory */
 static struct {
     BOOL enable[VTSS_ISID_END][VTSS_MAX_PORTS_LEGACY_CONSTANT_USE_CAPARRAY_INSTEAD + 1];
@@ -105,11 +177,18 @@ VTSS_TRACE_REGISTER(&trace_reg, trace_grps);
 #define MAC_CRIT_EXIT()      critd_exit( &mac_config.crit,     __FILE__, __LINE__)
 #define MAC_RAM_CRIT_ENTER() critd_enter(&mac_config.ram_crit, __FILE__, __LINE__)
 #define MAC_RAM_CRIT_EXIT()  critd_exit( &mac_config.ram_crit, __FILE__, __LINE__)
+#define MAC_STATS_CRIT_ENTER() critd_enter(&mac_stats.crit, __FILE__, __LINE__)
+#define MAC_STATS_CRIT_EXIT()  critd_exit( &mac_stats.crit, __FILE__, __LINE__)
+#define MAC_GET_NEXT_CRIT_ENTER() critd_enter(&mac_get_next_cache.crit, __FILE__, __LINE__)
+#define MAC_GET_NEXT_CRIT_EXIT()  critd_exit( &mac_get_next_cache.crit, __FILE__, __LINE__)
 
 #define MAC_MGMT_ASSERT(x,_txt) if((x)) { T_E("%s",_txt); return MAC_ERROR_GEN;}
 
 static mesa_rc mac_table_add(vtss_isid_t isid, mac_mgmt_addr_entry_t *entry);
 static mesa_rc mac_table_del(vtss_isid_t isid, mesa_vid_mac_t *conf, BOOL vol);
+static void mac_stats_entry_update(const mesa_mac_table_entry_t *entry, int delta);
+static void mac_stats_flush(mesa_port_no_t port_no);
+static void mac_get_next_cache_invalidate(void);
 
 /****************************************************************************/
 /*  Chip API functions and various local functions                          */
@@ -410,7 +489,17 @@ static mesa_rc mac_entry_add(mac_mgmt_addr_entry_t *entry)
         mac_entry.destination[port_no] = entry->destination[port_no];
     }
 
-    rc = mesa_mac_table_add(NULL, &mac_entry);
+    /* Replacing an existing entry must uncount it */
+    mesa_mac_table_entry_t old_entry;
+    BOOL                   old_found = (mesa_mac_table_get(NULL, &mac_entry.vid_mac, &old_entry) == VTSS_RC_OK);
+
+    if ((rc = mesa_mac_table_add(NULL, &mac_entry)) == VTSS_RC_OK) {
+        mac_get_next_cache_invalidate();
+        if (old_found) {
+            mac_stats_entry_update(&old_entry, -1);
+        }
+        mac_stats_entry_update(&mac_entry, 1);
+    }
 
     /*  Add the address to the  local table    */
     if (!msg_switch_is_primary()) {
@@ -447,15 +536,25 @@ static mesa_rc mac_entry_del(mesa_vid_mac_t *vid_mac, BOOL vol)
                 rc = mesa_mac_table_del(NULL, &entry.vid_mac);
                 if (rc != VTSS_RC_OK) {
                     T_N("(mac_msg_rx)Could not del entry,rc:%d", rc);
+                } else {
+                    mac_get_next_cache_invalidate();
+                    mac_stats_entry_update(&entry, -1);
                 }
             }
 
             vid_mac_tmp = entry.vid_mac;
         }
     } else {
+        BOOL found = (mesa_mac_table_get(NULL, vid_mac, &entry) == VTSS_RC_OK);
+
         rc = mesa_mac_table_del(NULL, vid_mac);
         if (rc != VTSS_RC_OK) {
             T_N("(mac_msg_rx)Could not del entry,rc:%d", rc);
+        } else {
+            mac_get_next_cache_invalidate();
+            if (found) {
+                mac_stats_entry_update(&entry, -1);
+            }
         }
     }
 
@@ -503,6 +602,97 @@ static void build_mac_list(void)
     MAC_CRIT_EXIT();
 }
 
+/****************************************************************************/
+// Invalidate the get-next caches
+/****************************************************************************/
+static void mac_get_next_cache_invalidate(void)
+{
+    u32 i;
+
+    MAC_GET_NEXT_CRIT_ENTER();
+    for (i = 0; i < MAC_GET_NEXT_CACHE_WALKERS; i++) {
+        mac_get_next_cache.walker[i].valid = FALSE;
+    }
+    MAC_GET_NEXT_CRIT_EXIT();
+}
+
+/****************************************************************************/
+// Get the get-next cache of the calling thread, taking over the least
+// recently used one if it has none.
+/****************************************************************************/
+static mac_get_next_cache_t *mac_get_next_cache_get(void)
+{
+    int                  thread_id = vtss_thread_id_get();
+    mac_get_next_cache_t *c, *lru = &mac_get_next_cache.walker[0];
+    u32                  i;
+
+    for (i = 0; i < MAC_GET_NEXT_CACHE_WALKERS; i++) {
+        c = &mac_get_next_cache.walker[i];
+        if (c->thread_id == thread_id) {
+            return c;
+        }
+
+        if (c->used < lru->used) {
+            lru = c;
+        }
+    }
+
+    lru->thread_id = thread_id;
+    lru->valid = FALSE;
+    return lru;
+}
+
+/****************************************************************************/
+// Get the next MAC address using the calling thread's get-next cache. The
+// cache is refilled if it does not cover the entry following vid_mac.
+/****************************************************************************/
+static mesa_rc mac_get_next_cache_lookup(mesa_vid_mac_t *vid_mac, mesa_mac_table_entry_t *entry)
+{
+    mac_get_next_cache_t *c;
+    mesa_rc              rc = VTSS_RC_OK;
+    u64                  now = vtss::uptime_milliseconds();
+    u32                  first, last, mid;
+    BOOL                 refill = TRUE;
+
+    MAC_GET_NEXT_CRIT_ENTER();
+    c = mac_get_next_cache_get();
+    c->used = now;
+    if (c->valid && now < c->time + MAC_GET_NEXT_CACHE_TTL && vid_mac_cmp(vid_mac, &c->key) >= 0) {
+        // Locate the first entry greater than vid_mac
+        for (first = 0, last = c->cnt; first != last; ) {
+            mid = (first + last) / 2;
+            if (vid_mac_cmp(&c->entry[mid].vid_mac, vid_mac) > 0) {
+                last = mid;
+            } else {
+                first = mid + 1;
+            }
+        }
+
+        if (first < c->cnt) {
+            *entry = c->entry[first];
+            refill = FALSE;
+        } else if (c->cnt < MAC_GET_NEXT_CACHE_CNT) {
+            // The cache reaches the end of the table
+            rc = VTSS_RC_ERROR;
+            refill = FALSE;
+        }
+    }
+
+    if (refill) {
+        c->key = *vid_mac;
+        c->time = now;
+        if ((rc = mesa_mac_table_get_next_bulk(NULL, vid_mac, MAC_GET_NEXT_CACHE_CNT, c->entry, &c->cnt)) == VTSS_RC_OK) {
+            *entry = c->entry[0];
+        } else {
+            c->cnt = 0;
+        }
+        c->valid = TRUE;
+    }
+    MAC_GET_NEXT_CRIT_EXIT();
+
+    return rc;
+}
+
 /****************************************************************************/
 // Get the next MAC address on the local switch
 /****************************************************************************/
@@ -513,7 +703,7 @@ static mesa_rc mac_local_table_get_next(mesa_vid_mac_t *vid_mac,
     mesa_vid_mac_t         vid_mac_tmp;
 
     if (next) {
-        rc = mesa_mac_table_get_next(NULL, vid_mac, entry);
+        rc = mac_get_next_cache_lookup(vid_mac, entry);
     } else {
         if (vid_mac->vid == MAC_ALL_VLANS) {
             memset(&vid_mac_tmp, 0, sizeof(vid_mac_tmp));
@@ -553,125 +743,349 @@ static mesa_rc mac_local_learn_mode_set(mesa_port_no_t port_no, const mesa_learn
 }
 
 /****************************************************************************/
-// Get MAC address statistics
+// Count (delta = 1) or uncount (delta = -1) an entry in a set of counters
 /****************************************************************************/
-static mesa_rc mac_local_table_get_stats(mac_table_stats_t *stats)
+static void mac_stats_count(mac_table_stats_t *stats, const mesa_mac_table_entry_t *entry, int delta, u32 port_count)
 {
-    int                    i;
-    mesa_vid_mac_t         vid_mac;
-    mesa_mac_table_entry_t mac_entry;
-    mesa_port_no_t         port_no;
-    mesa_rc                rc;
-    BOOL                   next = 1;
-    u32                    port_count = port_count_max();
-
-    T_N("enter mac_local_table_get_stats");
+    mesa_port_no_t port_no;
 
-    // initial search address is 00-00-00-00-00-00, VID: 1
-    vid_mac.vid = 1;
-    for (i = 0; i < 6; i++) {
-        vid_mac.mac.addr[i] = 0;
+    if (entry->locked) {
+        stats->static_total += delta;
+        return;
     }
 
-    for (port_no = VTSS_PORT_NO_START; port_no < fast_cap(MEBA_CAP_BOARD_PORT_MAP_COUNT); port_no++) {
-        stats->learned[port_no] = 0;
+    stats->learned_total += delta;
+    for (port_no = VTSS_PORT_NO_START; port_no < port_count; port_no++) {
+        if (entry->destination[port_no]) {
+            stats->learned[port_no] += delta;
+            /* Count only for the 1.first port (to avoid counting aggregation destinations) */
+            break;
+        }
     }
-    stats->static_total = 0;
-    stats->learned_total = 0;;
+}
 
-    // Run through all existing entries and gather stats
-    for (;;) {
-        rc = mac_local_table_get_next(&vid_mac, &mac_entry, next);
-        if (rc != VTSS_RC_OK) {
-            break;
+/****************************************************************************/
+// Count an entry in the global and the per-VLAN counters
+/****************************************************************************/
+static void mac_stats_count_vid(mac_table_stats_t *total, mac_stats_vid_map_t *vid,
+                                const mesa_mac_table_entry_t *entry, int delta, u32 port_count)
+{
+    mac_stats_count(total, entry, delta, port_count);
+
+    auto itr = vid->find(entry->vid_mac.vid);
+    if (itr == vid->end()) {
+        if (delta < 0 || (itr = vid->get(entry->vid_mac.vid)) == vid->end()) {
+            return;
         }
+        vtss_clear(itr->second);
+    }
 
-        // Search again from the found entry
-        vid_mac = mac_entry.vid_mac;
+    mac_stats_count(&itr->second, entry, delta, port_count);
 
-        if (mac_entry.locked) {
-            stats->static_total++;
-        } else {
-            stats->learned_total++;
-            for (port_no = VTSS_PORT_NO_START; port_no < port_count; port_no++) {
-                if (mac_entry.destination[port_no]) {
-                    stats->learned[port_no]++;
-                    /* Count only for the 1.first port (to avoid counting aggregation destinations) */
-                    break;
+    if (itr->second.static_total == 0 && itr->second.learned_total == 0) {
+        vid->erase(itr);
+    }
+}
+
+/****************************************************************************/
+// Incremental update of the counters when this module adds or deletes an
+// entry.
+/****************************************************************************/
+static void mac_stats_entry_update(const mesa_mac_table_entry_t *entry, int delta)
+{
+    MAC_STATS_CRIT_ENTER();
+    if (mac_stats.valid) {
+        mac_stats_count_vid(&mac_stats.total, &mac_stats.vid, entry, delta, port_count_max());
+        mac_stats.gen++;
+        mac_stats.status.update_cnt++;
+    }
+    MAC_STATS_CRIT_EXIT();
+}
+
+/****************************************************************************/
+// Incremental update of the counters when dynamic entries are flushed, either
+// on a single port or on all ports (port_no == VTSS_PORT_NO_NONE).
+/****************************************************************************/
+static void mac_stats_flush(mesa_port_no_t port_no)
+{
+    u32            port_count = port_count_max();
+    mesa_port_no_t p;
+
+    MAC_STATS_CRIT_ENTER();
+    if (mac_stats.valid) {
+        for (auto itr = mac_stats.vid.begin(); itr != mac_stats.vid.end();) {
+            mac_table_stats_t *stats = &itr->second;
+            for (p = VTSS_PORT_NO_START; p < port_count; p++) {
+                if (port_no == VTSS_PORT_NO_NONE || p == port_no) {
+                    stats->learned_total -= stats->learned[p];
+                    stats->learned[p] = 0;
                 }
             }
+
+            if (stats->static_total == 0 && stats->learned_total == 0) {
+                mac_stats.vid.erase(itr++);
+            } else {
+                ++itr;
+            }
         }
 
-        if (stats->static_total + stats->learned_total > fast_cap(MESA_CAP_L2_MAC_ADDR_CNT)) {
+        for (p = VTSS_PORT_NO_START; p < port_count; p++) {
+            if (port_no == VTSS_PORT_NO_NONE || p == port_no) {
+                mac_stats.total.learned_total -= mac_stats.total.learned[p];
+                mac_stats.total.learned[p] = 0;
+            }
+        }
+
+        mac_stats.gen++;
+        mac_stats.status.update_cnt++;
+    }
+    MAC_STATS_CRIT_EXIT();
+}
+
+/****************************************************************************/
+// Build counters by walking the MAC table
+/****************************************************************************/
+static void mac_stats_walk(mac_table_stats_t *total, mac_stats_vid_map_t *vid)
+{
+    mesa_vid_mac_t         vid_mac;
+    mesa_mac_table_entry_t mac_entry;
+    u32                    port_count = port_count_max(), cnt = 0;
+
+    // Initial search address is 00-00-00-00-00-00, VID 1
+    vtss_clear(vid_mac);
+    vid_mac.vid = 1;
+    vtss_clear(*total);
+    vid->clear();
+
+    while (mesa_mac_table_get_next(NULL, &vid_mac, &mac_entry) == VTSS_RC_OK) {
+        // Search again from the found entry
+        vid_mac = mac_entry.vid_mac;
+
+        mac_stats_count_vid(total, vid, &mac_entry, 1, port_count);
+
+        if (++cnt > fast_cap(MESA_CAP_L2_MAC_ADDR_CNT)) {
             break;
         }
+    }
+}
+
+/****************************************************************************/
+// Compare two sets of counters
+/****************************************************************************/
+static BOOL mac_stats_equal(const mac_table_stats_t *a, const mac_table_stats_t *b, u32 port_count)
+{
+    mesa_port_no_t port_no;
 
+    if (a->static_total != b->static_total || a->learned_total != b->learned_total) {
+        return FALSE;
     }
 
-    T_N("exit mac_local_table_get_stats");
-    return VTSS_RC_OK;
+    for (port_no = VTSS_PORT_NO_START; port_no < port_count; port_no++) {
+        if (a->learned[port_no] != b->learned[port_no]) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
 }
 
 /****************************************************************************/
-// Get MAC address VLAN statistics
+// Rebuild the counters. If check is set, the old counters are compared with
+// the new ones, and a mismatch is counted.
 /****************************************************************************/
-static mesa_rc mac_local_table_get_vlan_stats(mesa_vid_t vlan, mac_table_stats_t *stats)
+static void mac_stats_sync(BOOL check)
 {
+    mac_table_stats_t   total;
+    mac_stats_vid_map_t vid;
+    u32                 gen, port_count = port_count_max();
+    u64                 start, usec;
 
-    int                    i;
-    mesa_vid_mac_t         vid_mac;
-    mesa_mac_table_entry_t mac_entry;
-    mesa_port_no_t         port_no;
-    mesa_rc                rc;
-    BOOL                   next = 1;
-    u32                    port_count = port_count_max();
+    MAC_STATS_CRIT_ENTER();
+    gen = mac_stats.gen;
+    check = check && mac_stats.valid && !mac_stats.dirty;
+    mac_stats.dirty = FALSE;
+    MAC_STATS_CRIT_EXIT();
 
-    T_N("enter mac_local_table_get_vlan_stats");
+    // Walk without holding the lock, as it may take a while
+    start = vtss::uptime_microseconds();
+    mac_stats_walk(&total, &vid);
+    usec = vtss::uptime_microseconds() - start;
 
-    // initial search address is 00-00-00-00-00-00, VID: 1
-    vid_mac.vid = vlan;
-    for (i = 0; i < 6; i++) {
-        vid_mac.mac.addr[i] = 0;
+    MAC_STATS_CRIT_ENTER();
+    if (gen != mac_stats.gen) {
+        // The counters were updated during the walk, which may or may not
+        // have seen the change. Use the walk, but rebuild again soon.
+        check = FALSE;
+        mac_stats.dirty = TRUE;
     }
 
-    for (port_no = VTSS_PORT_NO_START; port_no < fast_cap(MEBA_CAP_BOARD_PORT_MAP_COUNT); port_no++) {
-        stats->learned[port_no] = 0;
+    if (check) {
+        BOOL equal = mac_stats_equal(&total, &mac_stats.total, port_count) && vid.size() == mac_stats.vid.size();
+
+        for (auto itr = vid.begin(); equal && itr != vid.end(); ++itr) {
+            auto old = mac_stats.vid.find(itr->first);
+            equal = (old != mac_stats.vid.end() && mac_stats_equal(&itr->second, &old->second, port_count));
+        }
+
+        mac_stats.status.check_cnt++;
+        if (!equal) {
+            T_I("MAC table statistics out of sync: learned %u/%u, static %u/%u",
+                (u32)mac_stats.total.learned_total, (u32)total.learned_total,
+                (u32)mac_stats.total.static_total, (u32)total.static_total);
+            mac_stats.status.mismatch_cnt++;
+        }
+    } else {
+        mac_stats.status.sync_cnt++;
     }
-    stats->static_total = 0;
-    stats->learned_total = 0;;
 
-    // Run through all existing entries and gather stats
-    for (;;) {
-        rc = mac_local_table_get_next(&vid_mac, &mac_entry, next);
-        if (rc != VTSS_RC_OK || (mac_entry.vid_mac.vid != vlan)) {
-            break;
+    mac_stats.total = total;
+    mac_stats.vid = vtss::move(vid);
+    mac_stats.valid = TRUE;
+    mac_stats.sync_time = vtss::uptime_seconds();
+    mac_stats.status.sync_usec_last = usec;
+    if (usec > mac_stats.status.sync_usec_max) {
+        mac_stats.status.sync_usec_max = usec;
+    }
+    MAC_STATS_CRIT_EXIT();
+}
+
+/****************************************************************************/
+// Minimum number of seconds between two rebuilds, scaled by the table size.
+// Must be called with the statistics lock taken.
+/****************************************************************************/
+static u32 mac_stats_sync_interval(void)
+{
+    u64 interval = MAC_STATS_SYNC_INTERVAL + (mac_stats.total.learned_total + mac_stats.total.static_total) / MAC_STATS_SYNC_ENTRIES_PER_SEC;
+
+    return interval > MAC_STATS_SYNC_INTERVAL_MAX ? MAC_STATS_SYNC_INTERVAL_MAX : interval;
+}
+
+/****************************************************************************/
+// Statistics thread. Polls the MAC table status for learn/age events and
+// rebuilds the counters when needed.
+/****************************************************************************/
+static void mac_stats_thread(vtss_addrword_t data)
+{
+    mesa_mac_table_status_t status;
+    BOOL                    sync, check;
+    u64                     now;
+
+    msg_wait(MSG_WAIT_UNTIL_ICFG_LOADING_POST, VTSS_MODULE_ID_MAC);
+
+    while (1) {
+        VTSS_OS_MSLEEP(MAC_STATS_POLL_INTERVAL_MSEC);
+
+        now = vtss::uptime_seconds();
+        if (mesa_mac_table_status_get(NULL, &status) == VTSS_RC_OK &&
+            (status.learned || status.replaced || status.moved || status.aged)) {
+            MAC_STATS_CRIT_ENTER();
+            mac_stats.dirty = TRUE;
+            MAC_STATS_CRIT_EXIT();
         }
 
-        if (mac_entry.locked) {
-            stats->static_total++;
-        } else {
-            stats->learned_total++;
-            for (port_no = VTSS_PORT_NO_START; port_no < port_count; port_no++) {
-                if (mac_entry.destination[port_no]) {
-                    stats->learned[port_no]++;
-                    /* Count only for the 1.first port (to avoid counting aggregation destinations) */
-                    break;
-                }
-            }
+        MAC_STATS_CRIT_ENTER();
+        mac_stats.status.sync_interval = mac_stats_sync_interval();
+        sync = !mac_stats.valid || (mac_stats.dirty && now >= mac_stats.sync_time + mac_stats.status.sync_interval);
+        check = !sync && now >= mac_stats.check_time + MAC_STATS_CHECK_INTERVAL;
+        if (check) {
+            mac_stats.check_time = now;
         }
+        MAC_STATS_CRIT_EXIT();
 
-        if (stats->static_total + stats->learned_total > fast_cap(MESA_CAP_L2_MAC_ADDR_CNT)) {
-            break;
+        if (sync || check) {
+            mac_stats_sync(check);
         }
+    }
+}
 
-        // Search again from the found entry
-        vid_mac = mac_entry.vid_mac;
+/****************************************************************************/
+// Get MAC address statistics
+/****************************************************************************/
+static mesa_rc mac_local_table_get_stats(mac_table_stats_t *stats)
+{
+    BOOL valid;
+
+    T_N("enter mac_local_table_get_stats");
+
+    MAC_STATS_CRIT_ENTER();
+    valid = mac_stats.valid;
+    MAC_STATS_CRIT_EXIT();
+
+    if (!valid) {
+        mac_stats_sync(FALSE);
     }
 
+    MAC_STATS_CRIT_ENTER();
+    *stats = mac_stats.total;
+    mac_stats.status.query_cnt++;
+    MAC_STATS_CRIT_EXIT();
+
+    T_N("exit mac_local_table_get_stats");
+    return VTSS_RC_OK;
+}
+
+/****************************************************************************/
+// Get MAC address VLAN statistics
+/****************************************************************************/
+static mesa_rc mac_local_table_get_vlan_stats(mesa_vid_t vlan, mac_table_stats_t *stats)
+{
+    BOOL valid;
+
+    T_N("enter mac_local_table_get_vlan_stats");
+
+    MAC_STATS_CRIT_ENTER();
+    valid = mac_stats.valid;
+    MAC_STATS_CRIT_EXIT();
+
+    if (!valid) {
+        mac_stats_sync(FALSE);
+    }
+
+    MAC_STATS_CRIT_ENTER();
+    auto itr = mac_stats.vid.find(vlan);
+    if (itr == mac_stats.vid.end()) {
+        vtss_clear(*stats);
+    } else {
+        *stats = itr->second;
+    }
+    mac_stats.status.query_cnt++;
+    MAC_STATS_CRIT_EXIT();
+
     T_N("exit mac_local_table_get_vlan_stats");
     return VTSS_RC_OK;
 }
 
+/****************************************************************************/
+// Entries changed directly through the MESA API by another module
+/****************************************************************************/
+void mac_stats_table_changed(void)
+{
+    MAC_STATS_CRIT_ENTER();
+    mac_stats.dirty = TRUE;
+    MAC_STATS_CRIT_EXIT();
+}
+
+/****************************************************************************/
+// Get the state of the statistics engine
+/****************************************************************************/
+void mac_stats_engine_status_get(mac_stats_engine_status_t *status)
+{
+    MAC_STATS_CRIT_ENTER();
+    *status = mac_stats.status;
+    status->valid = mac_stats.valid;
+    status->dirty = mac_stats.dirty;
+    status->vid_cnt = mac_stats.vid.size();
+    MAC_STATS_CRIT_EXIT();
+}
+
+/****************************************************************************/
+// Run a consistency check of the statistics engine now
+/****************************************************************************/
+void mac_stats_engine_check(void)
+{
+    mac_stats_sync(TRUE);
+}
+
 /****************************************************************************/
 // Flush the RAM address table
 /****************************************************************************/
@@ -1041,6 +1455,9 @@ static BOOL mac_msg_rx(void *contxt, const void *const rx_msg, const size_t len,
         /* Do a local flush mac */
         if (mesa_mac_table_flush(NULL) != VTSS_RC_OK) {
             T_W("Could not flush");
+        } else {
+            mac_get_next_cache_invalidate();
+            mac_stats_flush(VTSS_PORT_NO_NONE);
         }
         break;
     }
@@ -1721,7 +2138,10 @@ static void mac_port_state_change_callback(mesa_port_no_t port_no, const vtss_ap
             return; // The port is bypassed
         }
         /* Port is down, flush the MAC table for that port */
-        (void)mesa_mac_table_port_flush(NULL, port_no);
+        if (mesa_mac_table_port_flush(NULL, port_no) == VTSS_RC_OK) {
+            mac_get_next_cache_invalidate();
+            mac_stats_flush(port_no);
+        }
     }
 }
 
@@ -1997,6 +2417,9 @@ mesa_rc mac_mgmt_table_flush(void)
     if (!msg_switch_is_primary()) {
         if (mesa_mac_table_flush(NULL) != VTSS_RC_OK) {
             T_W("Could not flush");
+        } else {
+            mac_get_next_cache_invalidate();
+            mac_stats_flush(VTSS_PORT_NO_NONE);
         }
         return VTSS_RC_OK;
     }
@@ -2790,6 +3213,8 @@ mesa_rc mac_init(vtss_init_data_t *data)
         T_D("INIT_CMD_INIT");
         critd_init(&mac_config.crit,     "mac_config",     VTSS_MODULE_ID_MAC, CRITD_TYPE_MUTEX);
         critd_init(&mac_config.ram_crit, "mac_config.ram", VTSS_MODULE_ID_MAC, CRITD_TYPE_MUTEX);
+        critd_init(&mac_stats.crit,      "mac_stats",      VTSS_MODULE_ID_MAC, CRITD_TYPE_MUTEX);
+        critd_init(&mac_get_next_cache.crit, "mac_get_next", VTSS_MODULE_ID_MAC, CRITD_TYPE_MUTEX);
 
         MAC_RAM_CRIT_ENTER();
         MAC_CRIT_ENTER();
@@ -2837,6 +3262,16 @@ mesa_rc mac_init(vtss_init_data_t *data)
                            0,
                            &mac_thread_handle,
                            &mac_thread_block);
+
+        /* Create statistics thread */
+        vtss_thread_create(VTSS_THREAD_PRIO_BELOW_NORMAL,
+                           mac_stats_thread,
+                           0,
+                           "MAC Statistics",
+                           nullptr,
+                           0,
+                           &mac_stats.thread_handle,
+                           &mac_stats.thread_block);
         break;
 
     case INIT_CMD_START:
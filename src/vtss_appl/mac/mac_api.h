@@ -118,12 +118,39 @@ mesa_rc mac_mgmt_table_get_next(vtss_isid_t isid, mesa_vid_mac_t *vid_mac,
 mesa_rc mac_mgmt_stack_get_next(mesa_vid_mac_t *vid_mac, mac_mgmt_table_stack_t *entry,
                                 mac_mgmt_addr_type_t *type, BOOL next);
 
-/* Get MAC address statistics per switch*/
+/* Get MAC address statistics per switch. Learning and aging are reflected
+ * within about 6 to 61 seconds, depending on the size of the MAC table */
 mesa_rc mac_mgmt_table_stats_get(vtss_isid_t isid, mac_table_stats_t *stats);
 
 /* Get MAC address statistics per VLAN */
 mesa_rc mac_mgmt_table_vlan_stats_get(vtss_isid_t isid, mesa_vid_t vlan, mac_table_stats_t *stats);
 
+/* State of the engine maintaining the MAC address statistics (debug) */
+typedef struct {
+    BOOL valid;          /* Counters have been built                              */
+    BOOL dirty;          /* Counters are waiting to be rebuilt                    */
+    u32  vid_cnt;        /* Number of VLANs with entries                          */
+    u32  query_cnt;      /* Number of statistics queries                          */
+    u32  update_cnt;     /* Number of incremental updates                         */
+    u32  sync_cnt;       /* Number of rebuilds due to learn/age events            */
+    u32  check_cnt;      /* Number of consistency checks                          */
+    u32  mismatch_cnt;   /* Number of consistency checks that found a difference  */
+    u64  sync_usec_last; /* Duration of the last MAC table walk                   */
+    u64  sync_usec_max;  /* Duration of the longest MAC table walk                */
+    u32  sync_interval;  /* Current minimum number of seconds between rebuilds    */
+} mac_stats_engine_status_t;
+
+/* Get the state of the statistics engine */
+void mac_stats_engine_status_get(mac_stats_engine_status_t *status);
+
+/* Check the statistics against a walk of the MAC table now */
+void mac_stats_engine_check(void);
+
+/* Tell the statistics engine that entries were added to or deleted from the
+ * MAC table directly through the MESA API, so that the statistics get rebuilt
+ * like after learning and aging */
+void mac_stats_table_changed(void);
+
 /* Flush dynamic MAC address table, static entry are not touched. All switches in the stack are flushed. */
 mesa_rc mac_mgmt_table_flush(void);
 
@@ -0,0 +1,301 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#include <sys/ioctl.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include "spi_reg_io.h"
+#include "main_trace.h"
+
+#define SPI_REG_IO_BUF_SIZE (SPI_REG_IO_BYTE_CNT + SPI_REG_IO_PADDING_MAX)
+#define TO_SPI(_a_)         ((_a_) & 0x007FFFFF) // 23 bit SPI address
+
+static struct {
+    pthread_mutex_t         mutex;
+    int                     fd;
+    int                     pad;
+    int                     freq;
+    spi_reg_io_xfer_t       xfer;
+    bool                    batch;
+    uint32_t                cnt;   // Number of queued transfers
+    uint8_t                 tx[SPI_REG_IO_BATCH_MAX][SPI_REG_IO_BUF_SIZE];
+    uint8_t                 rx[SPI_REG_IO_BATCH_MAX][SPI_REG_IO_BUF_SIZE];
+    struct spi_ioc_transfer tr[SPI_REG_IO_BATCH_MAX];
+    spi_reg_io_counters_t   counters;
+} spi = {PTHREAD_MUTEX_INITIALIZER};
+
+// Batch region nesting level of the calling thread
+static thread_local uint32_t spi_batch_depth;
+
+/******************************************************************************/
+// spi_ioctl_xfer()
+/******************************************************************************/
+static int spi_ioctl_xfer(int fd, struct spi_ioc_transfer *tr, uint32_t cnt)
+{
+    return ioctl(fd, SPI_IOC_MESSAGE(cnt), tr);
+}
+
+/******************************************************************************/
+// spi_queue()
+// Add a transfer to the queue. Returns the index of it.
+/******************************************************************************/
+static uint32_t spi_queue(uint32_t addr, bool write, uint32_t value)
+{
+    uint32_t                i = spi.cnt++, siaddr = TO_SPI(addr);
+    uint8_t                 *tx = spi.tx[i];
+    struct spi_ioc_transfer *tr = &spi.tr[i];
+
+    memset(tr, 0, sizeof(*tr));
+    if (write) {
+        tx[0] = (uint8_t)(siaddr >> 16) | 0x80;
+        tx[3] = (uint8_t)(value  >> 24);
+        tx[4] = (uint8_t)(value  >> 16);
+        tx[5] = (uint8_t)(value  >>  8);
+        tx[6] = (uint8_t)(value  >>  0);
+        tr->len = SPI_REG_IO_BYTE_CNT;
+    } else {
+        memset(tx, 0xff, SPI_REG_IO_BUF_SIZE);
+        tx[0] = (uint8_t)(siaddr >> 16);
+        tr->len = SPI_REG_IO_BYTE_CNT + spi.pad;
+    }
+    tx[1] = (uint8_t)(siaddr >>  8);
+    tx[2] = (uint8_t)(siaddr >>  0);
+
+    tr->tx_buf        = (uint64_t)(uintptr_t)tx;
+    tr->rx_buf        = (uint64_t)(uintptr_t)spi.rx[i];
+    tr->speed_hz      = (uint32_t)spi.freq;
+    tr->bits_per_word = 8;
+    return i;
+}
+
+/******************************************************************************/
+// spi_read_value()
+/******************************************************************************/
+static uint32_t spi_read_value(uint32_t i)
+{
+    uint8_t *rx = &spi.rx[i][3 + spi.pad];
+
+    return (rx[0] << 24) | (rx[1] << 16) | (rx[2] << 8) | (rx[3] << 0);
+}
+
+/******************************************************************************/
+// spi_send()
+// Send all queued transfers in one ioctl.
+/******************************************************************************/
+static mesa_rc spi_send(void)
+{
+    uint32_t i, cnt = spi.cnt;
+
+    if (cnt == 0) {
+        return MESA_RC_OK;
+    }
+
+    // Deselect the chip between transfers, as each one is a register access
+    for (i = 0; i < cnt; i++) {
+        spi.tr[i].cs_change = (i + 1 < cnt);
+    }
+
+    spi.cnt = 0;
+    spi.counters.ioctls++;
+    if (cnt > spi.counters.batch_max) {
+        spi.counters.batch_max = cnt;
+    }
+
+    if (spi.xfer(spi.fd, spi.tr, cnt) < 1) {
+        T_EG(MAIN_TRACE_GRP_BOARD, "SPI: Transfer of %u accesses failed: %s", cnt, strerror(errno));
+        spi.counters.errors++;
+        return MESA_RC_ERROR;
+    }
+
+    return MESA_RC_OK;
+}
+
+/******************************************************************************/
+// spi_reg_io_setup()
+/******************************************************************************/
+void spi_reg_io_setup(int fd, int pad, int freq, spi_reg_io_xfer_t xfer)
+{
+    pthread_mutex_lock(&spi.mutex);
+    spi.fd   = fd;
+    spi.pad  = pad;
+    spi.freq = freq;
+    spi.xfer = (xfer ? xfer : spi_ioctl_xfer);
+    spi.cnt  = 0;
+    pthread_mutex_unlock(&spi.mutex);
+}
+
+/******************************************************************************/
+// spi_reg_io_batch_set()
+/******************************************************************************/
+void spi_reg_io_batch_set(bool enable)
+{
+    pthread_mutex_lock(&spi.mutex);
+    if (!enable && spi.cnt) {
+        spi.counters.flushes[SPI_REG_IO_FLUSH_BARRIER]++;
+        (void)spi_send();
+    }
+    spi.batch = enable;
+    pthread_mutex_unlock(&spi.mutex);
+}
+
+/******************************************************************************/
+// spi_reg_io_batch_get()
+/******************************************************************************/
+bool spi_reg_io_batch_get(void)
+{
+    return spi.batch;
+}
+
+/******************************************************************************/
+// spi_reg_io_batch_begin()
+/******************************************************************************/
+void spi_reg_io_batch_begin(void)
+{
+    spi_batch_depth++;
+}
+
+/******************************************************************************/
+// spi_reg_io_batch_end()
+/******************************************************************************/
+mesa_rc spi_reg_io_batch_end(void)
+{
+    if (spi_batch_depth == 0) {
+        T_EG(MAIN_TRACE_GRP_BOARD, "SPI: Batch region end without begin");
+        return MESA_RC_ERROR;
+    }
+
+    if (--spi_batch_depth) {
+        return MESA_RC_OK;
+    }
+
+    return spi_reg_io_flush(SPI_REG_IO_FLUSH_END);
+}
+
+/******************************************************************************/
+// spi_reg_io_read()
+/******************************************************************************/
+mesa_rc spi_reg_io_read(uint32_t addr, uint32_t *value)
+{
+    return spi_reg_io_read_burst(addr, 1, value);
+}
+
+/******************************************************************************/
+// spi_reg_io_read_burst()
+// Queued writes are sent in the same ioctl as the first reads.
+/******************************************************************************/
+mesa_rc spi_reg_io_read_burst(uint32_t addr, uint32_t cnt, uint32_t *values)
+{
+    mesa_rc  rc = MESA_RC_OK;
+    uint32_t first, i, n;
+
+    pthread_mutex_lock(&spi.mutex);
+    if (spi.cnt) {
+        spi.counters.flushes[SPI_REG_IO_FLUSH_READ]++;
+    }
+
+    while (cnt && rc == MESA_RC_OK) {
+        first = spi.cnt;
+        for (n = 0; n < cnt && spi.cnt < SPI_REG_IO_BATCH_MAX; n++) {
+            (void)spi_queue(addr + n, false, 0);
+        }
+
+        if ((rc = spi_send()) == MESA_RC_OK) {
+            for (i = 0; i < n; i++) {
+                values[i] = spi_read_value(first + i);
+                T_NG(MAIN_TRACE_GRP_BOARD, "Read(0x%06x) = 0x%08x", TO_SPI(addr + i), values[i]);
+            }
+        }
+
+        spi.counters.reads += n;
+        addr   += n;
+        values += n;
+        cnt    -= n;
+    }
+    pthread_mutex_unlock(&spi.mutex);
+
+    return rc;
+}
+
+/******************************************************************************/
+// spi_reg_io_write()
+/******************************************************************************/
+mesa_rc spi_reg_io_write(uint32_t addr, uint32_t value)
+{
+    mesa_rc rc = MESA_RC_OK;
+
+    T_NG(MAIN_TRACE_GRP_BOARD, "Write(0x%06x) = 0x%08x", TO_SPI(addr), value);
+
+    pthread_mutex_lock(&spi.mutex);
+    (void)spi_queue(addr, true, value);
+    spi.counters.writes++;
+    if (!spi.batch || spi_batch_depth == 0) {
+        rc = spi_send();
+    } else if (spi.cnt == SPI_REG_IO_BATCH_MAX) {
+        spi.counters.flushes[SPI_REG_IO_FLUSH_FULL]++;
+        rc = spi_send();
+    }
+    pthread_mutex_unlock(&spi.mutex);
+
+    return rc;
+}
+
+/******************************************************************************/
+// spi_reg_io_flush()
+/******************************************************************************/
+mesa_rc spi_reg_io_flush(spi_reg_io_flush_t reason)
+{
+    mesa_rc rc = MESA_RC_OK;
+
+    pthread_mutex_lock(&spi.mutex);
+    if (spi.cnt) {
+        spi.counters.flushes[reason]++;
+        rc = spi_send();
+    }
+    pthread_mutex_unlock(&spi.mutex);
+
+    return rc;
+}
+
+/******************************************************************************/
+// spi_reg_io_counters_get()
+/******************************************************************************/
+void spi_reg_io_counters_get(spi_reg_io_counters_t *counters)
+{
+    pthread_mutex_lock(&spi.mutex);
+    *counters = spi.counters;
+    pthread_mutex_unlock(&spi.mutex);
+}
+
+/******************************************************************************/
+// spi_reg_io_counters_clear()
+/******************************************************************************/
+void spi_reg_io_counters_clear(void)
+{
+    pthread_mutex_lock(&spi.mutex);
+    memset(&spi.counters, 0, sizeof(spi.counters));
+    pthread_mutex_unlock(&spi.mutex);
+}
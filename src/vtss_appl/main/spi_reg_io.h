@@ -0,0 +1,109 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#ifndef _SPI_REG_IO_H_
+#define _SPI_REG_IO_H_
+
+#include <stdint.h>
+#include <linux/spi/spidev.h>
+#include <microchip/ethernet/common.h> /* For mesa_rc */
+
+// Register access through a spidev device.
+//
+// Writes done by a thread between spi_reg_io_batch_begin() and
+// spi_reg_io_batch_end() are queued and sent as one multi-transfer
+// SPI_IOC_MESSAGE() ioctl when:
+//   - a register is read (the read is appended to the same ioctl),
+//   - spi_reg_io_flush() is called (explicit barrier, API lock release),
+//   - the outermost spi_reg_io_batch_end() is called, or
+//   - the queue is full.
+// All other writes are sent right away. This preserves the order of all
+// accesses as seen by the chip, but delays queued writes, so a batch region
+// must not contain timed sequences (a write followed by a sleep with no read
+// in between), as done by e.g. SerDes and PHY resets.
+//
+// Reads of consecutive registers can be done in one ioctl with
+// spi_reg_io_read_burst().
+
+// Maximum number of transfers in one ioctl. The spidev driver limits the
+// total length of a message to its buffer size (4096 bytes by default).
+#define SPI_REG_IO_BATCH_MAX 64
+
+// Number of bytes in a transfer without padding.
+#define SPI_REG_IO_BYTE_CNT 7
+
+// Maximum number of optional padding bytes in a read.
+#define SPI_REG_IO_PADDING_MAX 15
+
+// Function carrying out SPI_IOC_MESSAGE(cnt) on fd. Returns a value less
+// than one on error, like ioctl().
+typedef int (*spi_reg_io_xfer_t)(int fd, struct spi_ioc_transfer *tr, uint32_t cnt);
+
+// Reason for flushing the write queue.
+typedef enum {
+    SPI_REG_IO_FLUSH_READ,    // A register is read
+    SPI_REG_IO_FLUSH_BARRIER, // spi_reg_io_flush(), e.g. at API lock release
+    SPI_REG_IO_FLUSH_END,     // The outermost batch region ends
+    SPI_REG_IO_FLUSH_FULL,    // The queue is full
+    SPI_REG_IO_FLUSH_CNT
+} spi_reg_io_flush_t;
+
+typedef struct {
+    uint64_t reads;                          // Number of registers read
+    uint64_t writes;                         // Number of registers written
+    uint64_t ioctls;                         // Number of ioctls
+    uint64_t errors;                         // Number of failed ioctls
+    uint64_t flushes[SPI_REG_IO_FLUSH_CNT];  // Number of write queue flushes per reason
+    uint32_t batch_max;                      // Largest number of transfers in one ioctl
+} spi_reg_io_counters_t;
+
+// Set up the transport. xfer may be nullptr, in which case ioctl() is used.
+// A fake xfer function can be used for testing.
+void spi_reg_io_setup(int fd, int pad, int freq, spi_reg_io_xfer_t xfer);
+
+// Enable or disable write queueing. When disabled, batch regions have no
+// effect and every access is done in its own ioctl. Disabling flushes the
+// queue.
+void spi_reg_io_batch_set(bool enable);
+bool spi_reg_io_batch_get(void);
+
+// Start and end a region of the calling thread, in which writes are queued.
+// Regions may be nested. The outermost spi_reg_io_batch_end() flushes the
+// queue and returns the result of that.
+void    spi_reg_io_batch_begin(void);
+mesa_rc spi_reg_io_batch_end(void);
+
+mesa_rc spi_reg_io_read(uint32_t addr, uint32_t *value);
+mesa_rc spi_reg_io_read_burst(uint32_t addr, uint32_t cnt, uint32_t *values);
+mesa_rc spi_reg_io_write(uint32_t addr, uint32_t value);
+
+// Send queued writes, if any.
+mesa_rc spi_reg_io_flush(spi_reg_io_flush_t reason);
+
+void spi_reg_io_counters_get(spi_reg_io_counters_t *counters);
+void spi_reg_io_counters_clear(void);
+
+#endif /* _SPI_REG_IO_H_ */
@@ -0,0 +1,114 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Fake spidev backend for spi_reg_io. It decodes the transfers the way the
+// chip's SPI slave does and keeps the registers in a map, so that tests can
+// check both the register contents and the order in which accesses reached
+// the "chip".
+
+#ifndef _SPI_FAKE_HXX_
+#define _SPI_FAKE_HXX_
+
+#include <map>
+#include <vector>
+#include <chrono>
+#include <errno.h>
+#include "spi_reg_io.h"
+
+struct SpiFakeAccess {
+    bool     write;
+    uint32_t addr;
+    uint32_t value;
+};
+
+struct SpiFake {
+    int                        pad = 0;
+    bool                       fail = false;     // Fail the next ioctl
+    bool                       cs_ok = true;     // cs_change set on all but the last transfer
+    uint32_t                   cost_usec = 0;    // Busy-wait per ioctl, emulating the syscall
+    std::map<uint32_t, uint32_t> regs;
+    std::vector<SpiFakeAccess> log;
+    std::vector<uint32_t>      ioctls;           // Number of transfers per ioctl
+
+    void reset()
+    {
+        fail = false;
+        cs_ok = true;
+        regs.clear();
+        log.clear();
+        ioctls.clear();
+    }
+
+    int xfer(struct spi_ioc_transfer *tr, uint32_t cnt)
+    {
+        if (cost_usec) {
+            auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(cost_usec);
+            while (std::chrono::steady_clock::now() < end) {
+            }
+        }
+
+        if (fail) {
+            fail = false;
+            errno = EIO;
+            return -1;
+        }
+
+        ioctls.push_back(cnt);
+        for (uint32_t i = 0; i < cnt; i++) {
+            const uint8_t *tx = (const uint8_t *)(uintptr_t)tr[i].tx_buf;
+            uint8_t       *rx = (uint8_t *)(uintptr_t)tr[i].rx_buf;
+            uint32_t      addr = ((tx[0] & 0x7f) << 16) | (tx[1] << 8) | tx[2];
+
+            if (tr[i].cs_change != (i + 1 < cnt)) {
+                cs_ok = false;
+            }
+
+            if (tx[0] & 0x80) {
+                uint32_t value = (tx[3] << 24) | (tx[4] << 16) | (tx[5] << 8) | tx[6];
+                regs[addr] = value;
+                log.push_back({true, addr, value});
+            } else {
+                uint32_t value = regs[addr];
+                uint8_t  *p = &rx[3 + pad];
+                p[0] = value >> 24;
+                p[1] = value >> 16;
+                p[2] = value >> 8;
+                p[3] = value;
+                log.push_back({false, addr, value});
+            }
+        }
+        return cnt * SPI_REG_IO_BYTE_CNT;
+    }
+};
+
+extern SpiFake spi_fake;
+
+static inline int spi_fake_xfer(int fd, struct spi_ioc_transfer *tr, uint32_t cnt)
+{
+    return spi_fake.xfer(tr, cnt);
+}
+
+#endif /* _SPI_FAKE_HXX_ */
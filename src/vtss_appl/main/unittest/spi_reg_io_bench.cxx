@@ -0,0 +1,129 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Benchmark of spi_reg_io on the fake spidev backend. Each ioctl busy-waits
+// for a fixed time, emulating the syscall and SPI controller setup cost,
+// which dominates for short transfers. Options:
+//   -n <iterations> (default: 10000)
+//   -c <usec per ioctl> (default: 5)
+//
+// Workloads:
+//   vcap    : 16 register writes, a command write and a status poll, as done
+//             for a VCAP entry update.
+//   counters: Read of a block of 40 consecutive counter registers, with
+//             single reads or one burst read.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include "spi_fake.hxx"
+
+SpiFake spi_fake;
+
+static void bench_vcap(uint32_t n)
+{
+    uint32_t i, j, v;
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < 16; j++) {
+            (void)spi_reg_io_write(0x1000 + j, i + j);
+        }
+        (void)spi_reg_io_write(0x1100, 1);
+        (void)spi_reg_io_read(0x1100, &v);
+    }
+}
+
+static void bench_counters_single(uint32_t n)
+{
+    uint32_t i, j, v;
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < 40; j++) {
+            (void)spi_reg_io_read(0x2000 + j, &v);
+        }
+    }
+}
+
+static void bench_counters_burst(uint32_t n)
+{
+    uint32_t i, v[40];
+
+    for (i = 0; i < n; i++) {
+        (void)spi_reg_io_read_burst(0x2000, 40, v);
+    }
+}
+
+static void bench_run(const char *name, bool batch, void (*func)(uint32_t), uint32_t n)
+{
+    spi_reg_io_counters_t c;
+
+    spi_fake.reset();
+    spi_reg_io_batch_set(batch);
+    spi_reg_io_counters_clear();
+
+    auto start = std::chrono::steady_clock::now();
+    spi_reg_io_batch_begin();
+    func(n);
+    (void)spi_reg_io_batch_end();
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    spi_reg_io_counters_get(&c);
+    printf("%-16s %-8s %10llu %10llu %10llu %12.2f\n", name, batch ? "batched" : "single",
+           (unsigned long long)(c.reads + c.writes), (unsigned long long)c.ioctls,
+           (unsigned long long)usec, (double)usec / n);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t n = 10000, cost = 5;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "n:c:")) != -1) {
+        switch (opt) {
+        case 'n':
+            n = strtoul(optarg, nullptr, 0);
+            break;
+        case 'c':
+            cost = strtoul(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n iterations] [-c usec per ioctl]\n", argv[0]);
+            return 1;
+        }
+    }
+    spi_fake.cost_usec = cost;
+
+    spi_reg_io_setup(-1, 0, 1000000, spi_fake_xfer);
+
+    printf("%-16s %-8s %10s %10s %10s %12s\n", "Workload", "Mode", "Accesses", "Ioctls", "Time[usec]", "usec/iter");
+    bench_run("vcap", false, bench_vcap, n);
+    bench_run("vcap", true, bench_vcap, n);
+    bench_run("counters", false, bench_counters_single, n);
+    bench_run("counters", true, bench_counters_single, n);
+    bench_run("counters-burst", true, bench_counters_burst, n);
+    return 0;
+}
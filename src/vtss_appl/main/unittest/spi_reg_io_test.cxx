@@ -0,0 +1,170 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#include "spi_fake.hxx"
+#include "catch.hpp"
+
+SpiFake spi_fake;
+
+static void spi_test_setup(int pad, bool batch)
+{
+    spi_fake.reset();
+    spi_fake.pad = pad;
+    spi_reg_io_setup(-1, pad, 1000000, spi_fake_xfer);
+    spi_reg_io_batch_set(batch);
+    spi_reg_io_counters_clear();
+}
+
+TEST_CASE("spi_reg_io_unbatched", "[spi_reg_io]") {
+    uint32_t v;
+
+    spi_test_setup(0, false);
+    CHECK(spi_reg_io_write(0x1000, 0x12345678) == MESA_RC_OK);
+    CHECK(spi_reg_io_write(0x1001, 0x9abcdef0) == MESA_RC_OK);
+    CHECK(spi_fake.ioctls.size() == 2);
+    CHECK(spi_reg_io_read(0x1000, &v) == MESA_RC_OK);
+    CHECK(v == 0x12345678);
+    CHECK(spi_fake.ioctls.size() == 3);
+}
+
+TEST_CASE("spi_reg_io_batched", "[spi_reg_io]") {
+    uint32_t v, i;
+
+    // Reads with padding bytes
+    spi_test_setup(2, true);
+    spi_reg_io_batch_begin();
+
+    SECTION("writes are sent with the next read, in order") {
+        for (i = 0; i < 10; i++) {
+            CHECK(spi_reg_io_write(0x2000, i) == MESA_RC_OK);
+        }
+        CHECK(spi_fake.ioctls.empty());
+
+        CHECK(spi_reg_io_read(0x2000, &v) == MESA_RC_OK);
+        CHECK(v == 9);
+        REQUIRE(spi_fake.ioctls.size() == 1);
+        CHECK(spi_fake.ioctls[0] == 11);
+        REQUIRE(spi_fake.log.size() == 11);
+        for (i = 0; i < 10; i++) {
+            CHECK(spi_fake.log[i].write);
+            CHECK(spi_fake.log[i].value == i);
+        }
+        CHECK(!spi_fake.log[10].write);
+        CHECK(spi_fake.cs_ok);
+    }
+
+    SECTION("barrier") {
+        CHECK(spi_reg_io_write(0x10, 1) == MESA_RC_OK);
+        CHECK(spi_reg_io_flush(SPI_REG_IO_FLUSH_BARRIER) == MESA_RC_OK);
+        CHECK(spi_fake.ioctls.size() == 1);
+        CHECK(spi_fake.regs[0x10] == 1);
+
+        // Nothing to flush
+        CHECK(spi_reg_io_flush(SPI_REG_IO_FLUSH_BARRIER) == MESA_RC_OK);
+        CHECK(spi_fake.ioctls.size() == 1);
+    }
+
+    SECTION("full queue") {
+        for (i = 0; i < SPI_REG_IO_BATCH_MAX + 1; i++) {
+            CHECK(spi_reg_io_write(i, i) == MESA_RC_OK);
+        }
+        REQUIRE(spi_fake.ioctls.size() == 1);
+        CHECK(spi_fake.ioctls[0] == SPI_REG_IO_BATCH_MAX);
+        CHECK(spi_reg_io_flush(SPI_REG_IO_FLUSH_BARRIER) == MESA_RC_OK);
+        CHECK(spi_fake.regs.size() == SPI_REG_IO_BATCH_MAX + 1);
+    }
+
+    SECTION("burst read") {
+        uint32_t values[150];
+
+        for (i = 0; i < 150; i++) {
+            spi_fake.regs[0x3000 + i] = 0xa0000000 + i;
+        }
+        CHECK(spi_reg_io_write(0x3000, 0x55) == MESA_RC_OK);
+        CHECK(spi_reg_io_read_burst(0x3000, 150, values) == MESA_RC_OK);
+        CHECK(values[0] == 0x55);
+        for (i = 1; i < 150; i++) {
+            CHECK(values[i] == 0xa0000000 + i);
+        }
+        // One write and 150 reads in chunks of SPI_REG_IO_BATCH_MAX
+        CHECK(spi_fake.ioctls.size() == (151 + SPI_REG_IO_BATCH_MAX - 1) / SPI_REG_IO_BATCH_MAX);
+        CHECK(spi_fake.log[0].write);
+        CHECK(spi_fake.cs_ok);
+    }
+
+    SECTION("error") {
+        spi_reg_io_counters_t c;
+
+        CHECK(spi_reg_io_write(0x10, 1) == MESA_RC_OK);
+        spi_fake.fail = true;
+        CHECK(spi_reg_io_read(0x10, &v) == MESA_RC_ERROR);
+        spi_reg_io_counters_get(&c);
+        CHECK(c.errors == 1);
+        CHECK(spi_reg_io_read(0x10, &v) == MESA_RC_OK);
+    }
+
+    SECTION("disabling flushes") {
+        CHECK(spi_reg_io_write(0x10, 7) == MESA_RC_OK);
+        spi_reg_io_batch_set(false);
+        CHECK(spi_fake.regs[0x10] == 7);
+    }
+
+    CHECK(spi_reg_io_batch_end() == MESA_RC_OK);
+}
+
+TEST_CASE("spi_reg_io_batch_region", "[spi_reg_io]") {
+    spi_test_setup(0, true);
+
+    SECTION("writes outside a region are sent right away") {
+        CHECK(spi_reg_io_write(0x10, 1) == MESA_RC_OK);
+        CHECK(spi_fake.ioctls.size() == 1);
+        CHECK(spi_fake.regs[0x10] == 1);
+    }
+
+    SECTION("the outermost end flushes") {
+        spi_reg_io_batch_begin();
+        CHECK(spi_reg_io_write(0x10, 1) == MESA_RC_OK);
+        spi_reg_io_batch_begin();
+        CHECK(spi_reg_io_write(0x11, 2) == MESA_RC_OK);
+        CHECK(spi_reg_io_batch_end() == MESA_RC_OK);
+        CHECK(spi_fake.ioctls.empty());
+        CHECK(spi_reg_io_batch_end() == MESA_RC_OK);
+        REQUIRE(spi_fake.ioctls.size() == 1);
+        CHECK(spi_fake.ioctls[0] == 2);
+        CHECK(spi_fake.regs[0x11] == 2);
+    }
+
+    SECTION("the end returns a failed flush") {
+        spi_reg_io_batch_begin();
+        CHECK(spi_reg_io_write(0x10, 1) == MESA_RC_OK);
+        spi_fake.fail = true;
+        CHECK(spi_reg_io_batch_end() == MESA_RC_ERROR);
+    }
+
+    SECTION("end without begin") {
+        CHECK(spi_reg_io_batch_end() == MESA_RC_ERROR);
+    }
+}
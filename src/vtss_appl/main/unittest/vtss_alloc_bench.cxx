@@ -0,0 +1,231 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Multi-threaded microbenchmark of vtss_malloc()/vtss_free().
+//
+// Each thread keeps a small working set of allocations of random sizes and
+// module IDs and replaces them one at a time. A share of the frees are done
+// by the next thread (through a hand-over slot) to exercise cross-thread
+// accounting. The benchmark is run with 1 to N threads and prints the
+// throughput for each, so that the scaling can be seen. Options:
+//   -t <max threads>  (default: number of CPUs)
+//   -n <operations per thread> (default: 2000000)
+//   -m heap|locked|libc
+//      heap  : vtss_malloc()/vtss_free() (default)
+//      locked: Same, but with a process-wide recursive mutex around each call,
+//              which is what the accounting used to be protected by.
+//      libc  : Plain malloc()/free() for reference.
+// At the end, the merged heap statistics are checked for consistency.
+
+#include "vtss_alloc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define BENCH_WORKING_SET 64
+#define BENCH_MODIDS      8
+
+typedef enum {
+    BENCH_MODE_HEAP,
+    BENCH_MODE_LOCKED,
+    BENCH_MODE_LIBC,
+} bench_mode_t;
+
+static bench_mode_t    bench_mode = BENCH_MODE_HEAP;
+static pthread_mutex_t bench_global_mutex;
+
+// One hand-over slot per thread. Written by its owner, emptied by the next
+// thread.
+struct alignas(64) bench_slot_t {
+    std::atomic<void *> ptr{nullptr};
+};
+
+static std::vector<bench_slot_t> bench_slots;
+
+static inline void *bench_alloc(vtss_module_id_t modid, size_t sz)
+{
+    void *p;
+
+    switch (bench_mode) {
+    case BENCH_MODE_LOCKED:
+        pthread_mutex_lock(&bench_global_mutex);
+        p = vtss_malloc(modid, sz, __FILE__, __LINE__);
+        pthread_mutex_unlock(&bench_global_mutex);
+        return p;
+
+    case BENCH_MODE_LIBC:
+        return malloc(sz);
+
+    default:
+        return vtss_malloc(modid, sz, __FILE__, __LINE__);
+    }
+}
+
+static inline void bench_free(void *p)
+{
+    switch (bench_mode) {
+    case BENCH_MODE_LOCKED:
+        pthread_mutex_lock(&bench_global_mutex);
+        vtss_free(p, __FILE__, __LINE__);
+        pthread_mutex_unlock(&bench_global_mutex);
+        break;
+
+    case BENCH_MODE_LIBC:
+        free(p);
+        break;
+
+    default:
+        vtss_free(p, __FILE__, __LINE__);
+        break;
+    }
+}
+
+static void bench_thread(uint32_t idx, uint32_t thread_cnt, uint32_t ops)
+{
+    void     *ws[BENCH_WORKING_SET] = {};
+    uint32_t rnd = 0x9E3779B9U * (idx + 1), i, w;
+    void     *p;
+
+    for (i = 0; i < ops; i++) {
+        rnd = rnd * 1664525U + 1013904223U;
+        w   = (rnd >> 8) % BENCH_WORKING_SET;
+
+        if (ws[w]) {
+            if (thread_cnt > 1 && (rnd & 0xF) == 0) {
+                // Hand it over to the next thread, and free what it left for
+                // us if anything.
+                p = bench_slots[(idx + 1) % thread_cnt].ptr.exchange(ws[w]);
+                if (p) {
+                    bench_free(p);
+                }
+            } else {
+                bench_free(ws[w]);
+            }
+        }
+
+        ws[w] = bench_alloc((rnd >> 16) % BENCH_MODIDS + 1, 16 + (rnd >> 20) % 496);
+    }
+
+    for (w = 0; w < BENCH_WORKING_SET; w++) {
+        if (ws[w]) {
+            bench_free(ws[w]);
+        }
+    }
+}
+
+static bool bench_check(void)
+{
+    static heap_usage_t usage[VTSS_MODULE_ID_NONE + 1];
+    uint32_t            tot_max;
+    bool                ok = true;
+
+    vtss_alloc_heap_usage_get(usage, &tot_max);
+
+    for (int modid = 0; modid <= VTSS_MODULE_ID_NONE; modid++) {
+        const heap_usage_t *m = &usage[modid];
+
+        if (m->usage != 0 || m->allocs != m->frees) {
+            printf("Module %d: usage = %u, allocs = %u, frees = %u\n", modid, m->usage, m->allocs, m->frees);
+            ok = false;
+        }
+    }
+
+    printf("Heap statistics %s (max. total usage = %u bytes)\n", ok ? "consistent" : "INCONSISTENT", tot_max);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    pthread_mutexattr_t attr;
+    uint32_t            max_threads = std::thread::hardware_concurrency(), ops = 2000000, thread_cnt, i;
+    double              base = 0;
+    int                 c;
+
+    while ((c = getopt(argc, argv, "t:n:m:")) != -1) {
+        switch (c) {
+        case 't':
+            max_threads = strtoul(optarg, NULL, 0);
+            break;
+
+        case 'n':
+            ops = strtoul(optarg, NULL, 0);
+            break;
+
+        case 'm':
+            bench_mode = strcmp(optarg, "locked") == 0 ? BENCH_MODE_LOCKED : strcmp(optarg, "libc") == 0 ? BENCH_MODE_LIBC : BENCH_MODE_HEAP;
+            break;
+
+        default:
+            fprintf(stderr, "Usage: %s [-t <max threads>] [-n <ops per thread>] [-m heap|locked|libc]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&bench_global_mutex, &attr);
+
+    printf("Threads Mops/s   Speed-up\n");
+    printf("------- -------- --------\n");
+
+    for (thread_cnt = 1; thread_cnt <= max_threads; thread_cnt = thread_cnt < 2 ? thread_cnt + 1 : thread_cnt * 2) {
+        std::vector<std::thread> threads;
+        double                   mops;
+
+        bench_slots = std::vector<bench_slot_t>(thread_cnt);
+
+        auto start = std::chrono::steady_clock::now();
+        for (i = 0; i < thread_cnt; i++) {
+            threads.emplace_back(bench_thread, i, thread_cnt, ops);
+        }
+
+        for (auto &t : threads) {
+            t.join();
+        }
+        auto stop = std::chrono::steady_clock::now();
+
+        for (auto &s : bench_slots) {
+            if (s.ptr.load()) {
+                bench_free(s.ptr.load());
+            }
+        }
+
+        // Each operation is an allocation and (mostly) a free.
+        mops = (double)thread_cnt * ops / std::chrono::duration<double, std::micro>(stop - start).count();
+        if (thread_cnt == 1) {
+            base = mops;
+        }
+
+        printf("%7u %8.2f %7.2fx\n", thread_cnt, mops, mops / base);
+    }
+
+    return bench_mode == BENCH_MODE_LIBC || bench_check() ? 0 : 1;
+}
@@ -28,8 +28,9 @@
 #include <vtss_module_id.h>
 #include "vtss_os_wrapper.h"
 #include "vtss_alloc.h"
-#include <vtss/basics/notifications/lock-global-subject.hxx>
 #include "main_trace.h"
+#include <pthread.h>
+#include <atomic>
 
 static bool alloc_trace_init_done;
 
@@ -44,8 +45,267 @@ static bool alloc_trace_init_done;
 #define VTSS_MEMALLOC_MAGIC_2          0xBAU     /* 1 byte  */
 #define VTSS_MEMALLOC_ADDITIONAL_BYTES 9         /* We need 2 * 4 + 1 bytes for this */
 
-heap_usage_t heap_usage_cur[VTSS_MODULE_ID_NONE + 1];
-u32          heap_usage_tot_max_cur, heap_usage_tot_cur;
+// Heap accounting.
+//
+// Every thread updates its own shard of per-module counters, so that
+// allocations and frees don't serialize on a common lock. A shard is only
+// written by the thread owning it and is merged with the other shards when
+// the heap statistics are read (vtss_alloc_heap_usage_get()).
+//
+// The current usage of a module is the sum of the shards' usage deltas,
+// which may be negative, because memory may be freed by another thread than
+// the one that allocated it. In order to track the maximum usage, a shard
+// flushes its usage delta to heap_global whenever it exceeds
+// HEAP_SHARD_BATCH_BYTES. The maximum is therefore exact to within
+// HEAP_SHARD_BATCH_BYTES per thread.
+#define HEAP_SHARD_BATCH_BYTES VTSS_ALLOC_HEAP_MAX_SLACK_BYTES
+
+// The accummulated usage is flushed before it can wrap.
+#define HEAP_SHARD_TOTAL_FLUSH 0x40000000U
+
+typedef struct {
+    std::atomic<int32_t>  usage;  // Usage delta not yet flushed to heap_global
+    std::atomic<uint32_t> total;  // Accummulated usage not yet flushed to heap_global
+    std::atomic<uint32_t> allocs;
+    std::atomic<uint32_t> frees;
+} heap_shard_counters_t;
+
+typedef struct heap_shard_s {
+    heap_shard_counters_t m[VTSS_MODULE_ID_NONE + 1];
+    std::atomic<int32_t>  tot_usage; // Total usage delta not yet flushed to heap_global
+    struct heap_shard_s   *next;     // Next in heap_shards
+    struct heap_shard_s   *next_free; // Next in heap_shards_free
+} heap_shard_t;
+
+// Shards are never freed. When a thread exits, its shard is put on the free
+// list and handed to the next thread that needs one, so that its counters
+// stay included in the statistics.
+static pthread_mutex_t heap_mutex = PTHREAD_MUTEX_INITIALIZER;
+static heap_shard_t    *heap_shards;      // Protected by heap_mutex
+static heap_shard_t    *heap_shards_free; // Protected by heap_mutex
+static u32             heap_shard_cnt;    // Protected by heap_mutex
+static pthread_key_t   heap_shard_key;
+static pthread_once_t  heap_shard_key_once = PTHREAD_ONCE_INIT;
+static thread_local heap_shard_t *heap_shard;
+
+// Flushed counters. Protected by heap_mutex.
+static struct {
+    struct {
+        std::atomic<int64_t> usage;
+        uint32_t max;
+        uint64_t total;
+    } m[VTSS_MODULE_ID_NONE + 1];
+
+    int64_t  tot_usage;
+    uint32_t tot_max;
+} heap_global;
+
+/******************************************************************************/
+// heap_shard_release()
+// Called by pthreads when a thread with a shard exits.
+/******************************************************************************/
+static void heap_shard_release(void *data)
+{
+    heap_shard_t *shard = (heap_shard_t *)data;
+
+    heap_shard = NULL;
+
+    pthread_mutex_lock(&heap_mutex);
+    shard->next_free = heap_shards_free;
+    heap_shards_free = shard;
+    pthread_mutex_unlock(&heap_mutex);
+}
+
+/******************************************************************************/
+// heap_shard_key_create()
+/******************************************************************************/
+static void heap_shard_key_create(void)
+{
+    (void)pthread_key_create(&heap_shard_key, heap_shard_release);
+}
+
+/******************************************************************************/
+// heap_shard_get()
+// Returns the calling thread's shard. Returns NULL only if out of memory.
+/******************************************************************************/
+static inline heap_shard_t *heap_shard_get(void)
+{
+    heap_shard_t *shard;
+
+    if ((shard = heap_shard) != NULL) {
+        return shard;
+    }
+
+    (void)pthread_once(&heap_shard_key_once, heap_shard_key_create);
+
+    pthread_mutex_lock(&heap_mutex);
+    if ((shard = heap_shards_free) != NULL) {
+        heap_shards_free = shard->next_free;
+    } else if ((shard = (heap_shard_t *)calloc(1, sizeof(*shard))) != NULL) {
+        // Not accounted for, since we're the ones accounting. All-zeros is a
+        // valid initial state of std::atomic<> of integral types.
+        shard->next = heap_shards;
+        heap_shards = shard;
+        heap_shard_cnt++;
+    }
+    pthread_mutex_unlock(&heap_mutex);
+
+    if (shard) {
+        heap_shard = shard;
+        (void)pthread_setspecific(heap_shard_key, shard);
+    }
+
+    return shard;
+}
+
+/******************************************************************************/
+// heap_shard_flush()
+// Moves a module's usage delta and accummulated usage from #shard to
+// heap_global. Must be called by the thread owning #shard. #file and #line
+// are those of the allocation or free that caused the flush.
+//
+// This is also where a module freeing more than it has allocated is caught.
+// Frees on other threads than the allocating one make shards negative all the
+// time, so only if the merged usage is negative are the other shards looked
+// at. Since that only happens once per HEAP_SHARD_BATCH_BYTES, the free path
+// itself never takes heap_mutex for the check.
+/******************************************************************************/
+static void heap_shard_flush(heap_shard_t *shard, vtss_module_id_t modid, const char *const file, const int line)
+{
+    heap_shard_counters_t *c = &shard->m[modid];
+    heap_shard_t          *s;
+    int64_t               usage, exact = 0;
+
+    pthread_mutex_lock(&heap_mutex);
+    usage = heap_global.m[modid].usage.load(std::memory_order_relaxed) + c->usage.load(std::memory_order_relaxed);
+    heap_global.m[modid].usage.store(usage, std::memory_order_relaxed);
+    if (usage > (int64_t)heap_global.m[modid].max) {
+        heap_global.m[modid].max = usage;
+    }
+
+    heap_global.m[modid].total += c->total.load(std::memory_order_relaxed);
+
+    usage = heap_global.tot_usage += shard->tot_usage.load(std::memory_order_relaxed);
+    if (usage > (int64_t)heap_global.tot_max) {
+        heap_global.tot_max = usage;
+    }
+
+    c->usage.store(0, std::memory_order_relaxed);
+    c->total.store(0, std::memory_order_relaxed);
+    shard->tot_usage.store(0, std::memory_order_relaxed);
+
+    if ((usage = heap_global.m[modid].usage.load(std::memory_order_relaxed)) < 0) {
+        // Other threads' shards may hold the allocations that make up for it.
+        exact = usage;
+        for (s = heap_shards; s; s = s->next) {
+            exact += s->m[modid].usage.load(std::memory_order_relaxed);
+        }
+    }
+
+    pthread_mutex_unlock(&heap_mutex);
+
+    if (exact < 0) {
+        T_EG(MAIN_TRACE_GRP_ALLOC, "%s#%d: Something fishy going on. Module %d = %s has freed " VPRI64d " bytes more than it has allocated", file, line, modid, vtss_module_names[modid], -exact);
+    }
+}
+
+/******************************************************************************/
+// heap_account()
+// Accounts for an allocation (#alloc == true) or a free of #sz bytes.
+/******************************************************************************/
+static inline void heap_account(vtss_module_id_t modid, size_t sz, bool alloc, const char *const file, const int line)
+{
+    heap_shard_t          *shard;
+    heap_shard_counters_t *c;
+    int32_t               usage, tot_usage;
+
+    if ((shard = heap_shard_get()) == NULL) {
+        return;
+    }
+
+    // Only this thread writes to the shard, so there's no need for atomic
+    // read-modify-write operations. The atomics are just there for the reader.
+    c = &shard->m[modid];
+    if (alloc) {
+        usage = c->usage.load(std::memory_order_relaxed) + (int32_t)sz;
+        c->allocs.store(c->allocs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        c->total.store(c->total.load(std::memory_order_relaxed) + sz, std::memory_order_relaxed);
+        shard->tot_usage.store(shard->tot_usage.load(std::memory_order_relaxed) + (int32_t)sz, std::memory_order_relaxed);
+    } else {
+        usage = c->usage.load(std::memory_order_relaxed) - (int32_t)sz;
+        c->frees.store(c->frees.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        shard->tot_usage.store(shard->tot_usage.load(std::memory_order_relaxed) - (int32_t)sz, std::memory_order_relaxed);
+    }
+
+    c->usage.store(usage, std::memory_order_relaxed);
+    tot_usage = shard->tot_usage.load(std::memory_order_relaxed);
+
+    if (usage >= HEAP_SHARD_BATCH_BYTES || usage <= -HEAP_SHARD_BATCH_BYTES || tot_usage >= HEAP_SHARD_BATCH_BYTES || tot_usage <= -HEAP_SHARD_BATCH_BYTES || c->total.load(std::memory_order_relaxed) >= HEAP_SHARD_TOTAL_FLUSH) {
+        heap_shard_flush(shard, modid, file, line);
+    }
+}
+
+/******************************************************************************/
+// vtss_alloc_heap_usage_get()
+/******************************************************************************/
+void vtss_alloc_heap_usage_get(heap_usage_t usage[VTSS_MODULE_ID_NONE + 1], uint32_t *tot_max)
+{
+    heap_shard_t     *shard;
+    int64_t          cur[VTSS_MODULE_ID_NONE + 1], tot_cur;
+    vtss_module_id_t modid;
+    heap_usage_t     *m;
+
+    pthread_mutex_lock(&heap_mutex);
+
+    for (modid = 0; modid <= VTSS_MODULE_ID_NONE; modid++) {
+        m         = &usage[modid];
+        cur[modid] = heap_global.m[modid].usage.load(std::memory_order_relaxed);
+        m->max    = heap_global.m[modid].max;
+        m->total  = heap_global.m[modid].total;
+        m->allocs = 0;
+        m->frees  = 0;
+    }
+
+    tot_cur  = heap_global.tot_usage;
+    *tot_max = heap_global.tot_max;
+
+    for (shard = heap_shards; shard; shard = shard->next) {
+        for (modid = 0; modid <= VTSS_MODULE_ID_NONE; modid++) {
+            heap_shard_counters_t *c = &shard->m[modid];
+
+            m           = &usage[modid];
+            cur[modid] += c->usage.load(std::memory_order_relaxed);
+            m->total   += c->total.load(std::memory_order_relaxed);
+            m->allocs  += c->allocs.load(std::memory_order_relaxed);
+            m->frees   += c->frees.load(std::memory_order_relaxed);
+        }
+
+        tot_cur += shard->tot_usage.load(std::memory_order_relaxed);
+    }
+
+    pthread_mutex_unlock(&heap_mutex);
+
+    for (modid = 0; modid <= VTSS_MODULE_ID_NONE; modid++) {
+        m = &usage[modid];
+
+        if (cur[modid] < 0) {
+            T_EG(MAIN_TRACE_GRP_ALLOC, "Something fishy going on. Module %d = %s has freed " VPRI64d " bytes more than it has allocated", modid, vtss_module_names[modid], -cur[modid]);
+            cur[modid] = 0;
+        }
+
+        m->usage = cur[modid];
+        if (m->usage > m->max) {
+            // Not yet flushed
+            m->max = m->usage;
+        }
+    }
+
+    if (tot_cur < 0) {
+        T_EG(MAIN_TRACE_GRP_ALLOC, "Something fishy going on. " VPRI64d " bytes more have been freed than allocated", -tot_cur);
+    } else if (tot_cur > *tot_max) {
+        *tot_max = tot_cur;
+    }
+}
 
 static void vtss_memalloc_check_modid(const char *caller, vtss_module_id_t *modid)
 {
@@ -63,10 +323,6 @@ static void vtss_set_free(void *ptr, vtss_module_id_t check_against_modid, const
     BOOL             modid_ok, magics_ok;
     size_t           sz;
 
-#if VTSS_TRACE_LVL_MIN <= VTSS_TRACE_LVL_DEBUG
-    u32              new_usage = 0, new_alive = 0;
-#endif
-
     if (!ptr) {
         return;
     }
@@ -92,48 +348,11 @@ static void vtss_set_free(void *ptr, vtss_module_id_t check_against_modid, const
     }
 
     if (magics_ok && modid_ok) {
-        BOOL m_sz_ok = TRUE, tot_sz_ok = TRUE;
-        u32  m_mem_in_use = 0, tot_mem_in_use = 0; // Initialize to satisfy Lint
-        heap_usage_t *m = &heap_usage_cur[modid];
-
-        {
-            // Use the lazy-initialized leaf-mutex to protect ourselves.
-            vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
-
-            // Module memory consumption updates
-            m->frees++;
-            if (m->usage < sz) {
-                m_mem_in_use = m->usage;
-                m_sz_ok = FALSE;
-            } else {
-                m->usage -= sz;
-            }
-
-#if VTSS_TRACE_LVL_MIN <= VTSS_TRACE_LVL_DEBUG
-            new_usage = m->usage;
-            new_alive = m->allocs - m->frees;
-#endif
-
-            // Total memory consumption updates
-            if (heap_usage_tot_cur < sz) {
-                tot_mem_in_use = heap_usage_tot_cur;
-                tot_sz_ok = FALSE;
-            } else {
-                heap_usage_tot_cur -= sz;
-            }
-        }
-
-        if (!m_sz_ok) {
-            T_EG(MAIN_TRACE_GRP_ALLOC, "%s:%d: Something fishy going on (%p). Module %d = %s hasn't allocated " VPRIz " bytes. Only %u bytes still unfreed", file, line, ptr, modid, vtss_module_names[modid], sz, m_mem_in_use);
-        }
-
-        if (!tot_sz_ok) {
-            T_EG(MAIN_TRACE_GRP_ALLOC, "%s:%d: Something fishy going on (%p). Total memory currently allocated = %u bytes. Module %d = %s attempted to deallocate " VPRIz " bytes", file, line, ptr, tot_mem_in_use, modid, vtss_module_names[modid], sz);
-        }
+        heap_account(modid, sz, false, file, line);
     }
 
     if (alloc_trace_init_done) {
-        T_DG(MAIN_TRACE_GRP_ALLOC, "Module %s: free(%zu) bytes @ %p from %s#%d. New usage = %u bytes, new alive ptrs = %u", vtss_module_names[modid], sz, ptr, file, line, new_usage, new_alive);
+        T_DG(MAIN_TRACE_GRP_ALLOC, "Module %s: free(%zu) bytes @ %p from %s#%d", vtss_module_names[modid], sz, ptr, file, line);
     }
 
     p[0] &= 0xFF000000; // Clear magic only, so that we can detect double-freeing and still produce valuable module information.
@@ -153,10 +372,6 @@ static void *vtss_do_alloc(vtss_module_id_t modid, size_t sz, void *ptr, const c
 {
     u32 *p;
 
-#if VTSS_TRACE_LVL_MIN <= VTSS_TRACE_LVL_DEBUG
-    u32 new_usage = 0, new_alive = 0;
-#endif
-
     vtss_memalloc_check_modid(caller, &modid);
 
     if (ptr) {
@@ -166,39 +381,14 @@ static void *vtss_do_alloc(vtss_module_id_t modid, size_t sz, void *ptr, const c
     }
 
     if (p != NULL) {
-        heap_usage_t *m = &heap_usage_cur[modid];
-
-        {
-            // Use the lazy-initialized leaf-mutex to protect ourselves.
-            vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
-
-            // Module memory consumption updates
-            m->usage += sz;
-            if (m->usage > m->max) {
-                m->max = m->usage;
-            }
-
-            m->allocs++;
-            m->total += sz;
-
-#if VTSS_TRACE_LVL_MIN <= VTSS_TRACE_LVL_DEBUG
-            new_usage = m->usage;
-            new_alive = m->allocs - m->frees;
-#endif
-
-            // Total memory consumption updates
-            heap_usage_tot_cur += sz;
-            if (heap_usage_tot_cur > heap_usage_tot_max_cur) {
-                heap_usage_tot_max_cur = heap_usage_tot_cur;
-            }
-        }
+        heap_account(modid, sz, true, file, line);
 
         p[0] = ((VTSS_MEMALLOC_MAGIC_1 & 0xFFFFFF) << 0) | (modid & 0xFF) << 24;
         p[1] = sz;
         ((u8 *)p)[2 * sizeof(u32) + sz] = VTSS_MEMALLOC_MAGIC_2;
 
         if (alloc_trace_init_done) {
-            T_DG(MAIN_TRACE_GRP_ALLOC, "Module %s: %s(%zu bytes) @ %p from %s#%d. New usage = %u bytes, new alive ptrs = %u", vtss_module_names[modid], caller, sz, p + 2, file, line, new_usage, new_alive);
+            T_DG(MAIN_TRACE_GRP_ALLOC, "Module %s: %s(%zu bytes) @ %p from %s#%d", vtss_module_names[modid], caller, sz, p + 2, file, line);
         }
 
         return p + 2;
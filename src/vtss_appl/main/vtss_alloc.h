@@ -48,6 +48,14 @@ typedef struct {
     uint32_t frees;   // Number of frees
 } heap_usage_t;
 
+// Heap accounting is done per thread and only merged now and then, so the
+// maximum usages may be up to this many bytes too low per thread.
+#define VTSS_ALLOC_HEAP_MAX_SLACK_BYTES (16 * 1024)
+
+// Merges the per-thread heap accounting into #usage (per module) and
+// #tot_max (the maximum total usage seen).
+void vtss_alloc_heap_usage_get(heap_usage_t usage[VTSS_MODULE_ID_NONE + 1], uint32_t *tot_max);
+
 #define VTSS_MALLOC_MODID(_m_, _s_, _f_, _l_)       vtss_malloc(_m_, _s_, _f_, _l_)
 #define VTSS_CALLOC_MODID(_m_, _n_, _s_, _f_, _l_)  vtss_calloc(_m_, _n_, _s_, _f_, _l_)
 #define VTSS_REALLOC_MODID(_m_, _p_, _s_, _f_, _l_) vtss_realloc(_m_, _p_, _s_, _f_, _l_)
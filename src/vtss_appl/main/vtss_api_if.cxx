@@ -36,6 +36,7 @@
 #include <sys/syscall.h>
 #include <string.h>
 #include <linux/spi/spidev.h> /* For SPI_IOC_WR_MODE and friends */
+#include "spi_reg_io.h"
 
 #include "main.h"
 #include "main_conf.hxx"
@@ -137,9 +138,6 @@ static int  spi_reg_io_pad;                // Padding
 static int  spi_reg_io_freq;               // Frequency
 static bool spi_reg_io;                    // True if using SPI for register access.
 static int  spi_fd;                        // File descriptor to use for R/W of registers
-#define SPI_BYTE_CNT     7                 // Number of bytes to transmit or receive
-#define SPI_PADDING_MAX 15                 // Maximum number of optional padding bytes
-#define TO_SPI(_a_)     (_a_ & 0x007FFFFF) // 23 bit SPI address
 
 /* Board information and instance data */
 static meba_board_interface_t board_info;
@@ -317,6 +315,11 @@ void mesa_callout_lock(const mesa_api_lock_t *const lock)
 
 void mesa_callout_unlock(const mesa_api_lock_t *const lock)
 {
+    // Writes must have reached the chip when the API call returns. The API
+    // call itself cannot be failed from here, so a failure is only traced.
+    if (spi_reg_io && spi_reg_io_flush(SPI_REG_IO_FLUSH_BARRIER) != MESA_RC_OK) {
+        T_E("%s: Sending queued register writes failed", lock->function);
+    }
     API_CRIT_EXIT(lock->function);
 }
 
@@ -614,6 +617,9 @@ void mepa_callout_lock(const mepa_lock_t *const lock)
 }
 void mepa_callout_unlock(const mepa_lock_t *const lock)
 {
+    if (spi_reg_io && spi_reg_io_flush(SPI_REG_IO_FLUSH_BARRIER) != MESA_RC_OK) {
+        T_E("%s: Sending queued register writes failed", lock->function);
+    }
     critd_exit(&mepa_crit, lock->function, 0);
 }
 
@@ -654,8 +660,8 @@ static void spi_reg_io_init(void)
 {
     int mode = 0;
 
-    if (spi_reg_io_pad > SPI_PADDING_MAX) {
-        T_E("Invalid SPI padding %d (valid range is [0; %u]", spi_reg_io_pad, SPI_PADDING_MAX);
+    if (spi_reg_io_pad > SPI_REG_IO_PADDING_MAX) {
+        T_E("Invalid SPI padding %d (valid range is [0; %u]", spi_reg_io_pad, SPI_REG_IO_PADDING_MAX);
         exit(1);
     }
 
@@ -680,6 +686,11 @@ static void spi_reg_io_init(void)
         exit(1);
     }
 
+    // Writes are not queued until the API has been initialized, as the
+    // initialization has timed sequences of writes.
+    spi_reg_io_setup(spi_fd, spi_reg_io_pad, spi_reg_io_freq, nullptr);
+    spi_reg_io_batch_set(false);
+
     T_I("SPI: %s opened successfully", spi_reg_io_dev);
 }
 
@@ -911,64 +922,12 @@ public:
 
     static mesa_rc spi_reg_read(const mesa_chip_no_t chip_no, const uint32_t addr, uint32_t *const value)
     {
-        uint8_t                 tx[SPI_BYTE_CNT + SPI_PADDING_MAX];
-        uint8_t                 rx[sizeof(tx)] = {};
-        uint32_t                siaddr = TO_SPI(addr), rxword;
-        struct spi_ioc_transfer tr = {};
-
-        memset(tx, 0xff, sizeof(tx));
-        tx[0] = (uint8_t)(siaddr >> 16);
-        tx[1] = (uint8_t)(siaddr >>  8);
-        tx[2] = (uint8_t)(siaddr >>  0);
-
-        tr.tx_buf        = (uint64_t)tx;
-        tr.rx_buf        = (uint64_t)rx;
-        tr.len           = (uint32_t)SPI_BYTE_CNT + spi_reg_io_pad;
-        tr.speed_hz      = (uint32_t)spi_reg_io_freq;
-        tr.bits_per_word = 8;
-
-        if (ioctl(spi_fd, SPI_IOC_MESSAGE(1), &tr) < 1) {
-            T_E("spi_read: %s", strerror(errno));
-            return VTSS_RC_ERROR;
-        }
-
-        rxword = (rx[3 + spi_reg_io_pad] << 24) | (rx[4 + spi_reg_io_pad] << 16) | (rx[5 + spi_reg_io_pad] << 8) | (rx[6 + spi_reg_io_pad] << 0);
-        *value = rxword;
-
-        T_N("Read(0x%06x) = 0x%08x", siaddr, rxword);
-
-        return VTSS_RC_OK;
+        return spi_reg_io_read(addr, value);
     }
 
     static mesa_rc spi_reg_write(const mesa_chip_no_t chip_no, const uint32_t addr, const uint32_t value)
     {
-        uint8_t                 tx[SPI_BYTE_CNT] = {};
-        uint8_t                 rx[sizeof(tx)];
-        uint32_t                siaddr = TO_SPI(addr);
-        struct spi_ioc_transfer tr = {};
-
-        tx[0] = (uint8_t)(siaddr >> 16) | 0x80;
-        tx[1] = (uint8_t)(siaddr >>  8);
-        tx[2] = (uint8_t)(siaddr >>  0);
-        tx[3] = (uint8_t)(value  >> 24);
-        tx[4] = (uint8_t)(value  >> 16);
-        tx[5] = (uint8_t)(value  >>  8);
-        tx[6] = (uint8_t)(value  >>  0);
-
-        T_N("Write(0x%06x) = 0x%08x", siaddr, value);
-
-        tr.tx_buf        = (uint64_t)tx;
-        tr.rx_buf        = (uint64_t)rx;
-        tr.len           = sizeof(tx);
-        tr.speed_hz      = spi_reg_io_freq;
-        tr.bits_per_word = 8;
-
-        if (ioctl(spi_fd, SPI_IOC_MESSAGE(1), &tr) < 1) {
-            T_E("spi_write: %s", strerror(errno));
-            return VTSS_RC_ERROR;
-        }
-
-        return VTSS_RC_OK;
+        return spi_reg_io_write(addr, value);
     }
 };
 
@@ -1500,6 +1459,11 @@ static void api_init(void)
 
     rc = mesa_port_map_set(NULL, fast_cap(MEBA_CAP_BOARD_PORT_MAP_COUNT), port_map.data());
     VTSS_ASSERT(rc == MESA_RC_OK);
+
+    if (spi_reg_io) {
+        // Initialization done, allow queueing of writes in batch regions
+        spi_reg_io_batch_set(true);
+    }
 }
 
 static void api_start(void)
@@ -1516,6 +1480,28 @@ u32 vtss_api_if_chip_count(void)
     return 1;    // Legacy
 }
 
+void vtss_api_if_reg_batch_begin(void)
+{
+    if (spi_reg_io) {
+        spi_reg_io_batch_begin();
+    }
+}
+
+mesa_rc vtss_api_if_reg_batch_end(void)
+{
+    return spi_reg_io ? spi_reg_io_batch_end() : VTSS_RC_OK;
+}
+
+mesa_rc vtss_api_if_reg_barrier(void)
+{
+    return spi_reg_io ? spi_reg_io_flush(SPI_REG_IO_FLUSH_BARRIER) : VTSS_RC_OK;
+}
+
+BOOL vtss_api_if_spi_reg_io_get(void)
+{
+    return spi_reg_io;
+}
+
 void vtss_api_if_spi_reg_io_set(const char *spi_dev, int spi_pad, int spi_freq)
 {
     strncpy(spi_reg_io_dev, spi_dev, sizeof(spi_reg_io_dev));
@@ -45,6 +45,22 @@ u32 vtss_api_if_chip_count(void);
 // initialization.
 void vtss_api_if_spi_reg_io_set(const char *spi_dev, int spi_pad, int spi_freq);
 
+// Returns TRUE if SPI is used for register access.
+BOOL vtss_api_if_spi_reg_io_get(void);
+
+// With SPI register access, register writes done by the calling thread
+// between vtss_api_if_reg_batch_begin() and vtss_api_if_reg_batch_end() are
+// queued until the next register read, the API lock is released or the
+// region ends. Only use it around API calls that do not sleep between
+// register writes (e.g. VCAP updates), as the writes would otherwise reach
+// the chip after the sleep. vtss_api_if_reg_batch_end() returns the result of
+// sending the queued writes.
+void    vtss_api_if_reg_batch_begin(void);
+mesa_rc vtss_api_if_reg_batch_end(void);
+
+// Send queued register writes right away.
+mesa_rc vtss_api_if_reg_barrier(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,8 @@
 #include "critd.h"
 #include "critd_api.h"
 #include "crashhandler.hxx"
+#include <atomic>
+#include <pthread.h>
 
 #ifdef VTSS_SW_OPTION_SYSUTIL
 #include "sysutil_api.h"
@@ -164,26 +166,347 @@ struct CritdTblLock {
     }
 };
 
-// And we need another mutex when updating attempts to lock a critd.
-// We cannot use the same mutex as when updating the critd table, because that
-// could result in deadlocks under rare circumstances.
-static struct CritdInternalUpdateLock : public CritdInternalLock {
-} critd_internal_update_lock;
+/******************************************************************************/
+// Contention profiler
+//
+// Every thread has its own shard of call site records, which only the owning
+// thread writes to, so that sampling doesn't serialize critd_enter() and
+// critd_exit() on a common lock. A record is located by hashing the critd and
+// the call site. Once its key is published (by storing crit_p with release
+// semantics), the key is not changed until the shard is cleared.
+//
+// Readers merge the shards under critd_prof_mutex, which is otherwise only
+// taken when a thread gets or releases its shard. critd_prof_clear() bumps
+// critd_prof_epoch under critd_prof_mutex. Shards with an older epoch are
+// skipped by readers and cleared by their owner on its next sample, so a
+// shard is never cleared while it is being read.
+/******************************************************************************/
+#define CRITD_PROF_SITE_CNT  128 // Records per shard. Must be a power of two.
+#define CRITD_PROF_PROBE_CNT 8   // Max. number of records probed per lookup.
+#define CRITD_PROF_MERGE_MAX 256 // Max. number of merged call sites per critd.
+
+typedef struct {
+    std::atomic<const critd_t *> crit_p; // NULL if the record is not in use
+    u32                          prof_id;
+    critd_prof_role_t            role;
+    const char                   *file;
+    int                          line;
+    std::atomic<u32>             cnt;
+    std::atomic<u32>             contended_cnt;
+    std::atomic<u64>             total_ns;
+    std::atomic<u64>             max_ns;
+    std::atomic<u32>             hist[CRITD_PROF_HIST_CNT];
+} critd_prof_rec_t;
+
+typedef struct critd_prof_shard_s {
+    critd_prof_rec_t          rec[CRITD_PROF_SITE_CNT];
+    std::atomic<u32>          epoch;
+    std::atomic<u32>          drop_cnt;  // Samples dropped, because no record was free
+    struct critd_prof_shard_s *next;      // Next in critd_prof_shards
+    struct critd_prof_shard_s *next_free; // Next in critd_prof_shards_free
+} critd_prof_shard_t;
+
+// Merged samples of one critd
+typedef struct {
+    critd_prof_critd_t total;
+    u32                site_cnt;
+    critd_prof_site_t  site[CRITD_PROF_MERGE_MAX];
+} critd_prof_merge_t;
+
+static volatile bool critd_prof_on;
+static std::atomic<u32> critd_prof_epoch;
+static u32 critd_prof_id_next; // Protected by CritdTblLock
+
+// Shards are never freed. When a thread exits, its shard is put on the free
+// list and handed to the next thread that needs one.
+static pthread_mutex_t    critd_prof_mutex = PTHREAD_MUTEX_INITIALIZER;
+static critd_prof_shard_t *critd_prof_shards;      // Protected by critd_prof_mutex
+static critd_prof_shard_t *critd_prof_shards_free; // Protected by critd_prof_mutex
+static pthread_key_t      critd_prof_shard_key;
+static pthread_once_t     critd_prof_shard_key_once = PTHREAD_ONCE_INIT;
+static __thread critd_prof_shard_t *critd_prof_shard;
 
 /******************************************************************************/
-// CritUpdateLock
+// critd_prof_now_ns()
 /******************************************************************************/
-struct CritdUpdateLock {
-    CritdUpdateLock()
-    {
-        critd_internal_update_lock.lock();
+static inline u64 critd_prof_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000LLU + ts.tv_nsec;
+}
+
+/******************************************************************************/
+// critd_prof_bucket()
+// Histogram bucket of a sample. Buckets are log4-spaced in microseconds.
+/******************************************************************************/
+static inline u32 critd_prof_bucket(u64 ns)
+{
+    u64 us = ns / 1000;
+    u32 b;
+
+    if (us == 0) {
+        return 0;
     }
 
-    ~CritdUpdateLock()
-    {
-        critd_internal_update_lock.unlock();
+    b = 1 + (63 - __builtin_clzll(us)) / 2;
+    return MIN(b, CRITD_PROF_HIST_CNT - 1);
+}
+
+/******************************************************************************/
+// critd_prof_shard_release()
+// Called by pthreads when a thread with a shard exits.
+/******************************************************************************/
+static void critd_prof_shard_release(void *data)
+{
+    critd_prof_shard_t *shard = (critd_prof_shard_t *)data;
+
+    critd_prof_shard = NULL;
+
+    pthread_mutex_lock(&critd_prof_mutex);
+    shard->next_free = critd_prof_shards_free;
+    critd_prof_shards_free = shard;
+    pthread_mutex_unlock(&critd_prof_mutex);
+}
+
+/******************************************************************************/
+// critd_prof_shard_key_create()
+/******************************************************************************/
+static void critd_prof_shard_key_create(void)
+{
+    (void)pthread_key_create(&critd_prof_shard_key, critd_prof_shard_release);
+}
+
+/******************************************************************************/
+// critd_prof_shard_get()
+// Returns the calling thread's shard. Returns NULL only if out of memory.
+/******************************************************************************/
+static inline critd_prof_shard_t *critd_prof_shard_get(void)
+{
+    critd_prof_shard_t *shard;
+
+    if ((shard = critd_prof_shard) != NULL) {
+        return shard;
     }
-};
+
+    (void)pthread_once(&critd_prof_shard_key_once, critd_prof_shard_key_create);
+
+    pthread_mutex_lock(&critd_prof_mutex);
+    if ((shard = critd_prof_shards_free) != NULL) {
+        critd_prof_shards_free = shard->next_free;
+    } else if ((shard = (critd_prof_shard_t *)calloc(1, sizeof(*shard))) != NULL) {
+        // All-zeros is a valid initial state of std::atomic<> of integral and
+        // pointer types.
+        shard->next = critd_prof_shards;
+        critd_prof_shards = shard;
+    }
+    pthread_mutex_unlock(&critd_prof_mutex);
+
+    if (shard) {
+        critd_prof_shard = shard;
+        (void)pthread_setspecific(critd_prof_shard_key, shard);
+    }
+
+    return shard;
+}
+
+/******************************************************************************/
+// critd_prof_shard_clear()
+// Must be called by the thread owning #shard.
+/******************************************************************************/
+static void critd_prof_shard_clear(critd_prof_shard_t *shard)
+{
+    critd_prof_rec_t *rec;
+    int              i, b;
+
+    for (i = 0; i < CRITD_PROF_SITE_CNT; i++) {
+        rec = &shard->rec[i];
+        rec->crit_p.store(NULL, std::memory_order_relaxed);
+        rec->cnt.store(0, std::memory_order_relaxed);
+        rec->contended_cnt.store(0, std::memory_order_relaxed);
+        rec->total_ns.store(0, std::memory_order_relaxed);
+        rec->max_ns.store(0, std::memory_order_relaxed);
+        for (b = 0; b < CRITD_PROF_HIST_CNT; b++) {
+            rec->hist[b].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    shard->drop_cnt.store(0, std::memory_order_relaxed);
+}
+
+/******************************************************************************/
+// critd_prof_sample()
+// Adds a sample to the calling thread's shard.
+/******************************************************************************/
+static void critd_prof_sample(const critd_t *crit_p, u32 prof_id, critd_prof_role_t role,
+                              const char *file, int line, u64 ns, bool contended)
+{
+    critd_prof_shard_t *shard;
+    critd_prof_rec_t   *rec;
+    const critd_t      *rec_crit_p;
+    u32                epoch, h, i, b;
+
+    if ((shard = critd_prof_shard_get()) == NULL) {
+        return;
+    }
+
+    epoch = critd_prof_epoch.load(std::memory_order_relaxed);
+    if (shard->epoch.load(std::memory_order_relaxed) != epoch) {
+        critd_prof_shard_clear(shard);
+        shard->epoch.store(epoch, std::memory_order_release);
+    }
+
+    h = ((u32)((uintptr_t)crit_p >> 3) * 2654435761U) ^ ((u32)line * 40503U) ^ (u32)role;
+    for (i = 0; i < CRITD_PROF_PROBE_CNT; i++) {
+        rec = &shard->rec[(h + i) & (CRITD_PROF_SITE_CNT - 1)];
+        rec_crit_p = rec->crit_p.load(std::memory_order_relaxed);
+
+        if (rec_crit_p == NULL) {
+            // Claim it. We are the only writer, so publishing the key with a
+            // release store is enough for readers to see it consistently.
+            rec->prof_id = prof_id;
+            rec->role    = role;
+            rec->file    = file;
+            rec->line    = line;
+            rec->crit_p.store(crit_p, std::memory_order_release);
+            break;
+        }
+
+        if (rec_crit_p == crit_p && rec->prof_id == prof_id && rec->role == role &&
+            rec->line == line && rec->file == file) {
+            break;
+        }
+    }
+
+    if (i == CRITD_PROF_PROBE_CNT) {
+        shard->drop_cnt.store(shard->drop_cnt.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Only this thread writes to the record, so no read-modify-write needed.
+    b = critd_prof_bucket(ns);
+    rec->cnt.store(rec->cnt.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    rec->total_ns.store(rec->total_ns.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    rec->hist[b].store(rec->hist[b].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (contended) {
+        rec->contended_cnt.store(rec->contended_cnt.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    if (ns > rec->max_ns.load(std::memory_order_relaxed)) {
+        rec->max_ns.store(ns, std::memory_order_relaxed);
+    }
+}
+
+/******************************************************************************/
+// critd_prof_stat_add()
+/******************************************************************************/
+static void critd_prof_stat_add(critd_prof_stat_t *stat, const critd_prof_stat_t *add)
+{
+    int b;
+
+    stat->cnt           += add->cnt;
+    stat->contended_cnt += add->contended_cnt;
+    stat->total_ns      += add->total_ns;
+    stat->max_ns         = MAX(stat->max_ns, add->max_ns);
+    for (b = 0; b < CRITD_PROF_HIST_CNT; b++) {
+        stat->hist[b] += add->hist[b];
+    }
+}
+
+/******************************************************************************/
+// critd_prof_site_cmp()
+// Sorts call sites by role and then by decreasing total time.
+/******************************************************************************/
+static int critd_prof_site_cmp(const void *a, const void *b)
+{
+    const critd_prof_site_t *site_a = (const critd_prof_site_t *)a;
+    const critd_prof_site_t *site_b = (const critd_prof_site_t *)b;
+
+    if (site_a->role != site_b->role) {
+        return site_a->role < site_b->role ? -1 : 1;
+    }
+
+    if (site_a->stat.total_ns != site_b->stat.total_ns) {
+        return site_a->stat.total_ns > site_b->stat.total_ns ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+// critd_prof_merge()
+// Merges the samples of #crit_p from all shards. Returns the number of samples
+// dropped by all threads.
+/******************************************************************************/
+static u32 critd_prof_merge(const critd_t *crit_p, critd_prof_merge_t *merge)
+{
+    critd_prof_shard_t *shard;
+    critd_prof_rec_t   *rec;
+    critd_prof_site_t  site, *s;
+    const char         *file;
+    u32                epoch, drop_cnt = 0, i, j;
+    int                b;
+
+    memset(merge, 0, sizeof(*merge));
+    strncpy(merge->total.module_name, vtss_module_names[crit_p->module_id], sizeof(merge->total.module_name) - 1);
+    memcpy(merge->total.name, crit_p->name, sizeof(merge->total.name));
+
+    pthread_mutex_lock(&critd_prof_mutex);
+    epoch = critd_prof_epoch.load(std::memory_order_relaxed);
+    for (shard = critd_prof_shards; shard; shard = shard->next) {
+        if (shard->epoch.load(std::memory_order_acquire) != epoch) {
+            // Cleared, but not yet by its owner.
+            continue;
+        }
+
+        drop_cnt += shard->drop_cnt.load(std::memory_order_relaxed);
+
+        for (i = 0; i < CRITD_PROF_SITE_CNT; i++) {
+            rec = &shard->rec[i];
+            if (rec->crit_p.load(std::memory_order_acquire) != crit_p || rec->prof_id != crit_p->prof_id) {
+                continue;
+            }
+
+            memset(&site, 0, sizeof(site));
+            site.role               = rec->role;
+            site.line               = rec->line;
+            site.stat.cnt           = rec->cnt.load(std::memory_order_relaxed);
+            site.stat.contended_cnt = rec->contended_cnt.load(std::memory_order_relaxed);
+            site.stat.total_ns      = rec->total_ns.load(std::memory_order_relaxed);
+            site.stat.max_ns        = rec->max_ns.load(std::memory_order_relaxed);
+            for (b = 0; b < CRITD_PROF_HIST_CNT; b++) {
+                site.stat.hist[b] = rec->hist[b].load(std::memory_order_relaxed);
+            }
+
+            file = rec->file ? misc_filename(rec->file) : "";
+            strncpy(site.file, file, sizeof(site.file) - 1);
+
+            if (site.role == CRITD_PROF_ROLE_WAIT) {
+                critd_prof_stat_add(&merge->total.wait, &site.stat);
+            } else if (site.role == CRITD_PROF_ROLE_HOLD) {
+                critd_prof_stat_add(&merge->total.hold, &site.stat);
+            }
+
+            // The same call site may be sampled by several threads.
+            for (j = 0; j < merge->site_cnt; j++) {
+                s = &merge->site[j];
+                if (s->role == site.role && s->line == site.line && strcmp(s->file, site.file) == 0) {
+                    critd_prof_stat_add(&s->stat, &site.stat);
+                    break;
+                }
+            }
+
+            if (j == merge->site_cnt && j < CRITD_PROF_MERGE_MAX) {
+                merge->site[merge->site_cnt++] = site;
+            }
+        }
+    }
+    pthread_mutex_unlock(&critd_prof_mutex);
+
+    qsort(merge->site, merge->site_cnt, sizeof(merge->site[0]), critd_prof_site_cmp);
+    return drop_cnt;
+}
 
 /******************************************************************************/
 // critd_peek()
@@ -359,7 +682,9 @@ static void critd_dbg_list_(CritdTblLock &locked,
                 struct tm  timeinfo;
                 time_t lock_time;
 
-                lock_time = critd_p->lock_time;
+                // Derived from the tick count of the lock, so that
+                // critd_enter() doesn't need to call time().
+                lock_time = time(NULL) - VTSS_OS_TICK2MSEC(vtss_current_time() - critd_p->lock_tick_cnt) / 1000;
 #ifdef VTSS_SW_OPTION_SYSUTIL
                 lock_time += (system_get_tz_off() * 60); /* Adjust for TZ minutes => seconds */
 #endif
@@ -583,6 +908,7 @@ static void critd_init_(critd_t *const crit_p, const char *const name,
     crit_p->cookie        = CRITD_T_COOKIE;
     crit_p->type          = type;
     crit_p->leaf          = leaf;
+    crit_p->prof_id       = ++critd_prof_id_next;
 
     // From the application point of view, the critd is created locked
     // to allow the application to do some initializations of the data
@@ -717,6 +1043,10 @@ void critd_enter(critd_t *const crit_p, const char *const file, const int line,
 {
     int my_thread_id = vtss_thread_id_get();
     uint idx;
+    u64 prof_start_ns = 0, prof_now_ns = 0;
+    bool prof_contended = false;
+    const char *prof_blocker_file = NULL;
+    int prof_blocker_line = 0;
 
     if (!crit_p->init_done) {
         critd_trace(crit_p, file, line);
@@ -736,19 +1066,13 @@ void critd_enter(critd_t *const crit_p, const char *const file, const int line,
         CRITD_ASSERT(0,  "Critical region already locked by this thread id!");
     }
 
-    // Store information about lock attempt
-    {
-        CritdUpdateLock locked;
-        ulong lock_cnt_new;
-        lock_cnt_new = crit_p->lock_attempt_cnt;
-        lock_cnt_new++;
-        idx = (lock_cnt_new % CRITD_LOCK_ATTEMPT_SIZE);
-        crit_p->lock_attempt_thread_id[idx] = my_thread_id;
-        crit_p->lock_attempt_line[idx]      = line;
-        crit_p->lock_attempt_file[idx]      = file;
-        crit_p->lock_pending[idx]           = 1;
-        crit_p->lock_attempt_cnt            = lock_cnt_new;
-    }
+    // Store information about lock attempt. The slot is claimed atomically,
+    // so concurrent attempts never share a slot.
+    idx = __atomic_add_fetch(&crit_p->lock_attempt_cnt, 1, __ATOMIC_RELAXED) % CRITD_LOCK_ATTEMPT_SIZE;
+    crit_p->lock_attempt_thread_id[idx] = my_thread_id;
+    crit_p->lock_attempt_line[idx]      = line;
+    crit_p->lock_attempt_file[idx]      = file;
+    crit_p->lock_pending[idx]           = 1;
 
     // It's safe to do the following without the critd mutex taken, because
     // leaf_crit_p is a per-thread entity, so nothing to protect.
@@ -770,6 +1094,21 @@ void critd_enter(critd_t *const crit_p, const char *const file, const int line,
         leaf_crit_p = crit_p;
     }
 
+    if (critd_prof_on) {
+        // Snapshot the holder, which the wait - if any - is attributed to.
+        // This is racy, but at worst the wait is attributed to the previous
+        // holder.
+        if (!dry_run &&
+            crit_p->current_lock_thread_id != CRITD_THREAD_ID_NONE &&
+            crit_p->current_lock_thread_id != (ulong)my_thread_id) {
+            prof_contended    = true;
+            prof_blocker_file = crit_p->lock_file;
+            prof_blocker_line = crit_p->lock_line;
+        }
+
+        prof_start_ns = critd_prof_now_ns();
+    }
+
     // Here is the trick that causes the locking of all waiters until the very
     // first critd_exit() call has taken place. The flag is initially 0 and will
     // be set on the first call to critd_exit(), and remain set ever after,
@@ -803,12 +1142,25 @@ void critd_enter(critd_t *const crit_p, const char *const file, const int line,
         crit_p->lock_thread_id         = my_thread_id;
         crit_p->lock_file              = file;
         crit_p->lock_line              = line;
-        crit_p->lock_time              = time(NULL);
         crit_p->lock_tick_cnt          = vtss_current_time();
+
+        if (prof_start_ns) {
+            prof_now_ns = critd_prof_now_ns();
+            crit_p->prof_lock_ns = prof_now_ns;
+        }
+    } else if (prof_start_ns) {
+        prof_now_ns = critd_prof_now_ns();
     }
 
     crit_p->lock_pending[idx] = 0;
     crit_p->lock_cnt++;
+
+    if (prof_start_ns && !dry_run) {
+        critd_prof_sample(crit_p, crit_p->prof_id, CRITD_PROF_ROLE_WAIT, file, line, prof_now_ns - prof_start_ns, prof_contended);
+        if (prof_contended) {
+            critd_prof_sample(crit_p, crit_p->prof_id, CRITD_PROF_ROLE_BLOCKER, prof_blocker_file, prof_blocker_line, prof_now_ns - prof_start_ns, true);
+        }
+    }
 }
 
 /******************************************************************************/
@@ -818,6 +1170,11 @@ void critd_exit(critd_t *const crit_p, const char *const file, const int line, b
 {
     int my_thread_id = vtss_thread_id_get();
     int recursive_mutex_lock_cnt_after = 0;
+    bool prof_hold = false;
+    u64 prof_hold_ns = 0;
+    u32 prof_id = 0;
+    const char *prof_lock_file = NULL;
+    int prof_lock_line = 0;
 
     if (vtss_flag_peek(&crit_p->flag) == 0) {
         // This is the very first call to critd_exit().
@@ -876,6 +1233,16 @@ void critd_exit(critd_t *const crit_p, const char *const file, const int line, b
             crit_p->max_lock_line      = crit_p->lock_line;
             crit_p->max_lock_thread_id = crit_p->lock_thread_id;
         }
+
+        if (crit_p->prof_lock_ns) {
+            // Sampled once the critd is released.
+            prof_hold            = true;
+            prof_hold_ns         = critd_prof_now_ns() - crit_p->prof_lock_ns;
+            prof_id              = crit_p->prof_id;
+            prof_lock_file       = crit_p->lock_file;
+            prof_lock_line       = crit_p->lock_line;
+            crit_p->prof_lock_ns = 0;
+        }
     }
 
     if (!dry_run) {
@@ -897,6 +1264,10 @@ void critd_exit(critd_t *const crit_p, const char *const file, const int line, b
         }
     }
 
+    if (prof_hold) {
+        critd_prof_sample(crit_p, prof_id, CRITD_PROF_ROLE_HOLD, prof_lock_file, prof_lock_line, prof_hold_ns, false);
+    }
+
     if (!leaf_detection_abuse_disabled && crit_p->leaf) {
         if (!leaf_crit_p) {
             T_E("Internal error: Leaf mutex %s is getting released, but leaf_crit_p is NULL", crit_p->name);
@@ -1036,7 +1407,9 @@ void critd_dbg_list_icli(const u32              session_id,
                 struct tm timeinfo;
                 time_t lock_time;
 
-                lock_time = critd_p->lock_time;
+                // Derived from the tick count of the lock, so that
+                // critd_enter() doesn't need to call time().
+                lock_time = time(NULL) - VTSS_OS_TICK2MSEC(vtss_current_time() - critd_p->lock_tick_cnt) / 1000;
 #ifdef VTSS_SW_OPTION_SYSUTIL
                 lock_time += (system_get_tz_off() * 60); /* Adjust for TZ minutes => seconds */
 #endif
@@ -1200,6 +1573,298 @@ void critd_dbg_max_lock_icli(const u32              session_id,
 }
 #endif /* VTSS_SW_OPTION_ICLI */
 
+/******************************************************************************/
+// critd_prof_enable()
+/******************************************************************************/
+void critd_prof_enable(bool enable)
+{
+    critd_prof_on = enable;
+}
+
+/******************************************************************************/
+// critd_prof_enabled()
+/******************************************************************************/
+bool critd_prof_enabled(void)
+{
+    return critd_prof_on;
+}
+
+/******************************************************************************/
+// critd_prof_clear()
+/******************************************************************************/
+void critd_prof_clear(void)
+{
+    pthread_mutex_lock(&critd_prof_mutex);
+    critd_prof_epoch.fetch_add(1, std::memory_order_relaxed);
+    pthread_mutex_unlock(&critd_prof_mutex);
+}
+
+/******************************************************************************/
+// critd_prof_find()
+// Returns the critd with #id or - if #next - the critd with the smallest ID
+// greater than #id.
+/******************************************************************************/
+static critd_t *critd_prof_find(CritdTblLock &locked, u32 id, bool next)
+{
+    critd_t          *critd_p, *found = NULL;
+    vtss_module_id_t mid;
+
+    for (mid = 0; mid < VTSS_MODULE_ID_NONE; mid++) {
+        for (critd_p = locked.critd_tbl(mid); critd_p; critd_p = critd_p->nxt) {
+            if (!next) {
+                if (critd_p->prof_id == id) {
+                    return critd_p;
+                }
+            } else if (critd_p->prof_id > id && (!found || critd_p->prof_id < found->prof_id)) {
+                found = critd_p;
+            }
+        }
+    }
+
+    return found;
+}
+
+/******************************************************************************/
+// critd_prof_critd_itr()
+/******************************************************************************/
+mesa_rc critd_prof_critd_itr(const u32 *prev_id, u32 *next_id)
+{
+    CritdTblLock locked;
+    critd_t      *critd_p;
+
+    if ((critd_p = critd_prof_find(locked, prev_id ? *prev_id : 0, true)) == NULL) {
+        return VTSS_RC_ERROR;
+    }
+
+    *next_id = critd_p->prof_id;
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// critd_prof_critd_get()
+/******************************************************************************/
+mesa_rc critd_prof_critd_get(u32 id, critd_prof_critd_t *entry)
+{
+    CritdTblLock       locked;
+    critd_t            *critd_p;
+    critd_prof_merge_t *merge;
+
+    if ((critd_p = critd_prof_find(locked, id, false)) == NULL ||
+        (merge = (critd_prof_merge_t *)malloc(sizeof(*merge))) == NULL) {
+        return VTSS_RC_ERROR;
+    }
+
+    (void)critd_prof_merge(critd_p, merge);
+    *entry = merge->total;
+    free(merge);
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// critd_prof_site_itr()
+/******************************************************************************/
+mesa_rc critd_prof_site_itr(const u32 *prev_id, u32 *next_id, const u32 *prev_site, u32 *next_site)
+{
+    CritdTblLock       locked;
+    critd_t            *critd_p;
+    critd_prof_merge_t *merge;
+    u32                id = 0, site;
+    mesa_rc            rc = VTSS_RC_ERROR;
+
+    if ((merge = (critd_prof_merge_t *)malloc(sizeof(*merge))) == NULL) {
+        return VTSS_RC_ERROR;
+    }
+
+    // Next call site of the same critd
+    if (prev_id) {
+        id   = *prev_id;
+        site = prev_site ? *prev_site + 1 : 0;
+        if ((critd_p = critd_prof_find(locked, id, false)) != NULL) {
+            (void)critd_prof_merge(critd_p, merge);
+            if (site < merge->site_cnt) {
+                *next_id   = id;
+                *next_site = site;
+                rc = VTSS_RC_OK;
+            }
+        }
+    }
+
+    // First call site of the next critd with samples
+    while (rc != VTSS_RC_OK && (critd_p = critd_prof_find(locked, id, true)) != NULL) {
+        id = critd_p->prof_id;
+        (void)critd_prof_merge(critd_p, merge);
+        if (merge->site_cnt) {
+            *next_id   = id;
+            *next_site = 0;
+            rc = VTSS_RC_OK;
+        }
+    }
+
+    free(merge);
+    return rc;
+}
+
+/******************************************************************************/
+// critd_prof_site_get()
+/******************************************************************************/
+mesa_rc critd_prof_site_get(u32 id, u32 site, critd_prof_site_t *entry)
+{
+    CritdTblLock       locked;
+    critd_t            *critd_p;
+    critd_prof_merge_t *merge;
+    mesa_rc            rc = VTSS_RC_ERROR;
+
+    if ((critd_p = critd_prof_find(locked, id, false)) == NULL ||
+        (merge = (critd_prof_merge_t *)malloc(sizeof(*merge))) == NULL) {
+        return VTSS_RC_ERROR;
+    }
+
+    (void)critd_prof_merge(critd_p, merge);
+    if (site < merge->site_cnt) {
+        *entry = merge->site[site];
+        rc = VTSS_RC_OK;
+    }
+
+    free(merge);
+    return rc;
+}
+
+#ifdef VTSS_SW_OPTION_ICLI
+/******************************************************************************/
+// critd_dbg_prof_stat_icli()
+/******************************************************************************/
+static void critd_dbg_prof_stat_icli(const u32 session_id, const critd_prof_stat_t *stat)
+{
+    ICLI_PRINTF(" %10u " VPRI64Fu("13") " " VPRI64Fu("13"),
+                stat->cnt,
+                stat->cnt ? stat->total_ns / stat->cnt / 1000 : 0,
+                stat->max_ns / 1000);
+}
+
+/******************************************************************************/
+// critd_dbg_prof_icli()
+/******************************************************************************/
+void critd_dbg_prof_icli(const u32              session_id,
+                         const vtss_module_id_t module_id)
+{
+    static const char   *const role_txt[] = {"Wait", "Hold", "Blocker"};
+    static const char   *const hist_txt[CRITD_PROF_HIST_CNT] = {"<1", "<4", "<16", "<64", "<256", "<1K", "<4K", "<16K", "<64K", ">=64K"};
+    int                 i;
+    const uint          MODULE_NAME_WID = 21;
+    char                module_name_format[10];
+    char                critd_name_format[10];
+    vtss_module_id_t    mid_start = 0;
+    vtss_module_id_t    mid_end = VTSS_MODULE_ID_NONE - 1;
+    vtss_module_id_t    mid;
+    critd_prof_merge_t  *merge;
+    critd_prof_site_t   *site;
+    u32                 drop_cnt = 0, s;
+    int                 b;
+    BOOL                first = 1;
+
+    if ((merge = (critd_prof_merge_t *)malloc(sizeof(*merge))) == NULL) {
+        ICLI_PRINTF("%% Out of memory\n");
+        return;
+    }
+
+    /* Work-around for problem with printf("%*s", ...) */
+    sprintf(module_name_format, "%%-%ds", MODULE_NAME_WID);
+    sprintf(critd_name_format,  "%%-%ds", CRITD_NAME_LEN);
+
+    ICLI_PRINTF("Profiling is %s\n\n", critd_prof_on ? "enabled" : "disabled");
+
+    if (module_id != VTSS_MODULE_ID_NONE) {
+        mid_start = module_id;
+        mid_end   = module_id;
+    }
+
+    for (mid = mid_start; mid <= mid_end; mid++) {
+        CritdTblLock locked;
+        critd_t *critd_p = locked.critd_tbl(mid);
+        while (critd_p) {
+            drop_cnt = critd_prof_merge(critd_p, merge);
+            critd_p  = critd_p->nxt;
+
+            if (merge->total.wait.cnt == 0 && merge->total.hold.cnt == 0) {
+                continue;
+            }
+
+            if (first || module_id != VTSS_MODULE_ID_NONE) {
+                first = 0;
+                ICLI_PRINTF(module_name_format, "Module");
+                ICLI_PRINTF(" ");
+                ICLI_PRINTF(critd_name_format, "Critd Name");
+                ICLI_PRINTF("      Waits  Contended Avg Wait [us] Max Wait [us]      Holds Avg Hold [us] Max Hold [us]\n");
+
+                for (i = 0; i < MODULE_NAME_WID; i++) {
+                    ICLI_PRINTF("-");
+                }
+
+                ICLI_PRINTF(" ");
+
+                for (i = 0; i < CRITD_NAME_LEN; i++) {
+                    ICLI_PRINTF("-");
+                }
+
+                ICLI_PRINTF(" ---------- ---------- ------------- ------------- ---------- ------------- -------------\n");
+            }
+
+            ICLI_PRINTF(module_name_format, merge->total.module_name);
+            ICLI_PRINTF(" ");
+            ICLI_PRINTF(critd_name_format, merge->total.name);
+            ICLI_PRINTF(" %10u", merge->total.wait.cnt);
+            ICLI_PRINTF(" %10u", merge->total.wait.contended_cnt);
+            ICLI_PRINTF(" " VPRI64Fu("13") " " VPRI64Fu("13"),
+                        merge->total.wait.cnt ? merge->total.wait.total_ns / merge->total.wait.cnt / 1000 : 0,
+                        merge->total.wait.max_ns / 1000);
+            critd_dbg_prof_stat_icli(session_id, &merge->total.hold);
+            ICLI_PRINTF("\n");
+
+            if (module_id == VTSS_MODULE_ID_NONE) {
+                continue;
+            }
+
+            // Histograms and call sites are only shown per module.
+            ICLI_PRINTF("\n%-14s", "Histogram [us]");
+            for (b = 0; b < CRITD_PROF_HIST_CNT; b++) {
+                ICLI_PRINTF(" %8s", hist_txt[b]);
+            }
+
+            ICLI_PRINTF("\n%-14s", "Wait");
+            for (b = 0; b < CRITD_PROF_HIST_CNT; b++) {
+                ICLI_PRINTF(" %8u", merge->total.wait.hist[b]);
+            }
+
+            ICLI_PRINTF("\n%-14s", "Hold");
+            for (b = 0; b < CRITD_PROF_HIST_CNT; b++) {
+                ICLI_PRINTF(" %8u", merge->total.hold.hist[b]);
+            }
+
+            ICLI_PRINTF("\n\nRole         Count Avg [us]      Max [us]      Location\n");
+            ICLI_PRINTF("------- ---------- ------------- ------------- ------------------------------\n");
+            for (s = 0; s < merge->site_cnt; s++) {
+                site = &merge->site[s];
+                ICLI_PRINTF("%-7s", role_txt[site->role]);
+                critd_dbg_prof_stat_icli(session_id, &site->stat);
+                ICLI_PRINTF(" %s#%d\n", site->file, site->line);
+            }
+
+            ICLI_PRINTF("\n");
+        }
+    }
+
+    if (drop_cnt) {
+        ICLI_PRINTF("\n%u samples were dropped, because the per-thread buffers were full\n", drop_cnt);
+    }
+
+    free(merge);
+}
+#endif /* VTSS_SW_OPTION_ICLI */
+
+#ifdef VTSS_SW_OPTION_JSON_RPC
+VTSS_PRE_DECLS void vtss_appl_critd_json_init(void);
+#endif
+
 /******************************************************************************/
 // critd_module_init()
 /******************************************************************************/
@@ -1209,6 +1874,9 @@ mesa_rc critd_module_init(vtss_init_data_t *data)
 
     switch (data->cmd) {
     case INIT_CMD_INIT:
+#ifdef VTSS_SW_OPTION_JSON_RPC
+        vtss_appl_critd_json_init();
+#endif
         // Create thread
         vtss_thread_create(VTSS_THREAD_PRIO_DEFAULT,
                            critd_thread,
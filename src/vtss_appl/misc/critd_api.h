@@ -135,7 +135,6 @@ typedef struct _critd_t {
     ulong        lock_thread_id;
     const char   *lock_file;
     int          lock_line;
-    ulong        lock_time;
     u32          lock_cnt;
 
     ulong        unlock_thread_id;
@@ -156,6 +155,10 @@ typedef struct _critd_t {
     ulong            max_lock_thread_id;
     const char *     max_lock_file;
     int              max_lock_line;
+
+    // Contention profiler
+    u32              prof_id;       // Unique ID assigned by critd_init()
+    u64              prof_lock_ns;  // Time the critd was taken. 0 if not profiled.
 } critd_t;
 
 // Initialize critd_t
@@ -242,6 +245,74 @@ void critd_dbg_max_lock_icli(
 );
 #endif /* VTSS_SW_OPTION_ICLI */
 
+// Contention profiler
+// -------------------
+// When enabled, critd_enter() and critd_exit() measure how long a critd is
+// waited for and held. Samples are accumulated per call site in per-thread
+// buffers, which only the owning thread writes to, so profiling doesn't add
+// any locking to critd_enter()/critd_exit(). When a thread has to wait, the
+// wait time is also attributed to the call site that held the critd when
+// the thread started waiting (the blocker).
+//
+// The histograms have log4-spaced buckets in microseconds:
+// <1, <4, <16, <64, <256, <1024, <4096, <16384, <65536 and >= 65536.
+#define CRITD_PROF_HIST_CNT     10
+#define CRITD_PROF_MODULE_LEN   32
+#define CRITD_PROF_FILE_LEN     64
+
+typedef enum {
+    CRITD_PROF_ROLE_WAIT,    // Time spent in critd_enter() at a call site
+    CRITD_PROF_ROLE_HOLD,    // Time held after being taken at a call site
+    CRITD_PROF_ROLE_BLOCKER, // Time others waited while held by a call site
+} critd_prof_role_t;
+
+typedef struct {
+    u32 cnt;                       // Number of samples
+    u32 contended_cnt;             // Number of samples where another thread held the critd (waits only)
+    u64 total_ns;                  // Sum of samples
+    u64 max_ns;                    // Largest sample
+    u32 hist[CRITD_PROF_HIST_CNT]; // Number of samples per bucket
+} critd_prof_stat_t;
+
+// Per-critd totals
+typedef struct {
+    char              module_name[CRITD_PROF_MODULE_LEN];
+    char              name[CRITD_NAME_LEN + 1];
+    critd_prof_stat_t wait;
+    critd_prof_stat_t hold;
+} critd_prof_critd_t;
+
+// Per-call site samples
+typedef struct {
+    critd_prof_role_t role;
+    char              file[CRITD_PROF_FILE_LEN];
+    int               line;
+    critd_prof_stat_t stat;
+} critd_prof_site_t;
+
+// Enable or disable the profiler. It's disabled by default.
+void critd_prof_enable(bool enable);
+bool critd_prof_enabled(void);
+
+// Clear all samples.
+void critd_prof_clear(void);
+
+// Critds are identified by critd_t::prof_id.
+mesa_rc critd_prof_critd_itr(const u32 *prev_id, u32 *next_id);
+mesa_rc critd_prof_critd_get(u32 id, critd_prof_critd_t *entry);
+
+// The call sites of a critd are numbered from 0 in the order waits, holds
+// and blockers, each sorted by decreasing total time.
+mesa_rc critd_prof_site_itr(const u32 *prev_id, u32 *next_id, const u32 *prev_site, u32 *next_site);
+mesa_rc critd_prof_site_get(u32 id, u32 site, critd_prof_site_t *entry);
+
+#ifdef VTSS_SW_OPTION_ICLI
+void critd_dbg_prof_icli(
+    const u32               session_id,
+    const vtss_module_id_t  module_id
+);
+#endif /* VTSS_SW_OPTION_ICLI */
+
 #ifdef __cplusplus
 }
 #endif
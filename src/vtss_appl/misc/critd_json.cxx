@@ -0,0 +1,53 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#include "critd_serializer.hxx"
+#include "vtss/basics/expose/json.hxx"
+
+using namespace vtss;
+using namespace vtss::json;
+using namespace vtss::expose::json;
+using namespace vtss::appl::critd::interfaces;
+
+namespace vtss {
+void json_node_add(Node *node);
+}  // namespace vtss
+
+vtss_enum_descriptor_t critd_prof_role_txt[] {
+    {CRITD_PROF_ROLE_WAIT,    "wait"},
+    {CRITD_PROF_ROLE_HOLD,    "hold"},
+    {CRITD_PROF_ROLE_BLOCKER, "blocker"},
+    {0, 0},
+};
+
+#define NS(N, P, D) static vtss::expose::json::NamespaceNode N(&P, D);
+static NamespaceNode ns_critd("critd");
+extern "C" void vtss_appl_critd_json_init() { json_node_add(&ns_critd); }
+
+NS(ns_status, ns_critd, "status");
+NS(ns_status_profile, ns_status, "profile");
+static TableReadOnly<CritdProfCritdEntry> critd_status_profile_critd_entry(&ns_status_profile, "critd");
+static TableReadOnly<CritdProfSiteEntry> critd_status_profile_site_entry(&ns_status_profile, "site");
@@ -0,0 +1,276 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#ifndef __VTSS_CRITD_SERIALIZER_HXX__
+#define __VTSS_CRITD_SERIALIZER_HXX__
+
+#include "vtss_appl_serialize.hxx"
+#include "critd_api.h"
+
+/*****************************************************************************
+    Enum serializer
+*****************************************************************************/
+
+extern vtss_enum_descriptor_t critd_prof_role_txt[];
+VTSS_XXXX_SERIALIZE_ENUM(
+    critd_prof_role_t,
+    "CritdProfRoleEnum",
+    critd_prof_role_txt,
+    "This enumeration defines what the samples of a call site measure.");
+
+/*****************************************************************************
+    Index serializer
+*****************************************************************************/
+
+VTSS_SNMP_TAG_SERIALIZE(critd_prof_id_index, u32, a, s) {
+    a.add_leaf(
+        vtss::AsInt(s.inner),
+        vtss::tag::Name("CritdId"),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(0),
+        vtss::tag::Description("The ID of the critd.")
+    );
+}
+
+VTSS_SNMP_TAG_SERIALIZE(critd_prof_site_index, u32, a, s) {
+    a.add_leaf(
+        vtss::AsInt(s.inner),
+        vtss::tag::Name("SiteIndex"),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(0),
+        vtss::tag::Description("The index of the call site within the critd.")
+    );
+}
+
+/*****************************************************************************
+    Data serializer
+*****************************************************************************/
+
+// Leaf names of a critd_prof_stat_t. The statistics are flattened into the
+// containing entry, so that waits and holds can share the same struct.
+enum {
+    CRITD_PROF_STAT_NAMES_WAIT,
+    CRITD_PROF_STAT_NAMES_HOLD,
+    CRITD_PROF_STAT_NAMES_SITE,
+};
+
+static const char *const critd_prof_stat_names[][4 + CRITD_PROF_HIST_CNT] = {
+    {
+        "WaitCount", "WaitContendedCount", "WaitTotalNs", "WaitMaxNs",
+        "WaitHistLt1us", "WaitHistLt4us", "WaitHistLt16us", "WaitHistLt64us", "WaitHistLt256us",
+        "WaitHistLt1ms", "WaitHistLt4ms", "WaitHistLt16ms", "WaitHistLt65ms", "WaitHistGe65ms"
+    },
+    {
+        "HoldCount", "HoldContendedCount", "HoldTotalNs", "HoldMaxNs",
+        "HoldHistLt1us", "HoldHistLt4us", "HoldHistLt16us", "HoldHistLt64us", "HoldHistLt256us",
+        "HoldHistLt1ms", "HoldHistLt4ms", "HoldHistLt16ms", "HoldHistLt65ms", "HoldHistGe65ms"
+    },
+    {
+        "Count", "ContendedCount", "TotalNs", "MaxNs",
+        "HistLt1us", "HistLt4us", "HistLt16us", "HistLt64us", "HistLt256us",
+        "HistLt1ms", "HistLt4ms", "HistLt16ms", "HistLt65ms", "HistGe65ms"
+    },
+};
+
+template<typename M>
+void critd_prof_stat_serialize(M &m, int &ix, critd_prof_stat_t &s, int names)
+{
+    const char *const *name = critd_prof_stat_names[names];
+    int               b;
+
+    m.add_leaf(
+        s.cnt,
+        vtss::tag::Name(name[0]),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("Number of samples.")
+    );
+
+    m.add_leaf(
+        s.contended_cnt,
+        vtss::tag::Name(name[1]),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("Number of waits where another thread held the critd.")
+    );
+
+    m.add_leaf(
+        s.total_ns,
+        vtss::tag::Name(name[2]),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("Sum of samples in nanoseconds.")
+    );
+
+    m.add_leaf(
+        s.max_ns,
+        vtss::tag::Name(name[3]),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("Largest sample in nanoseconds.")
+    );
+
+    for (b = 0; b < CRITD_PROF_HIST_CNT; b++) {
+        m.add_leaf(
+            s.hist[b],
+            vtss::tag::Name(name[4 + b]),
+            vtss::expose::snmp::Status::Current,
+            vtss::expose::snmp::OidElementValue(ix++),
+            vtss::tag::Description("Number of samples in this histogram bucket.")
+        );
+    }
+}
+
+template<typename T>
+void serialize(T &a, critd_prof_critd_t &s)
+{
+    typename T::Map_t m = a.as_map(vtss::tag::Typename("critd_prof_critd_t"));
+    int ix = 0;
+
+    m.add_leaf(
+        vtss::AsDisplayString(s.module_name, sizeof(s.module_name)),
+        vtss::tag::Name("Module"),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("Name of the module owning the critd.")
+    );
+
+    m.add_leaf(
+        vtss::AsDisplayString(s.name, sizeof(s.name)),
+        vtss::tag::Name("Name"),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("Name of the critd.")
+    );
+
+    critd_prof_stat_serialize(m, ix, s.wait, CRITD_PROF_STAT_NAMES_WAIT);
+    critd_prof_stat_serialize(m, ix, s.hold, CRITD_PROF_STAT_NAMES_HOLD);
+}
+
+template<typename T>
+void serialize(T &a, critd_prof_site_t &s)
+{
+    typename T::Map_t m = a.as_map(vtss::tag::Typename("critd_prof_site_t"));
+    int ix = 0;
+
+    m.add_leaf(
+        s.role,
+        vtss::tag::Name("Role"),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("What the samples of the call site measure.")
+    );
+
+    m.add_leaf(
+        vtss::AsDisplayString(s.file, sizeof(s.file)),
+        vtss::tag::Name("File"),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("Source file of the call site.")
+    );
+
+    m.add_leaf(
+        s.line,
+        vtss::tag::Name("Line"),
+        vtss::expose::snmp::Status::Current,
+        vtss::expose::snmp::OidElementValue(ix++),
+        vtss::tag::Description("Source line of the call site.")
+    );
+
+    critd_prof_stat_serialize(m, ix, s.stat, CRITD_PROF_STAT_NAMES_SITE);
+}
+
+namespace vtss {
+namespace appl {
+namespace critd {
+namespace interfaces {
+
+struct CritdProfCritdEntry {
+    typedef vtss::expose::ParamList<
+        vtss::expose::ParamKey<u32>,
+        vtss::expose::ParamVal<critd_prof_critd_t *>
+    > P;
+
+    static constexpr const char *table_description =
+        "This is a table of wait and hold time statistics per critd.";
+
+    static constexpr const char *index_description =
+        "Each entry has the statistics of a critd.";
+
+    VTSS_EXPOSE_SERIALIZE_ARG_1(u32 &i) {
+        h.argument_properties(vtss::expose::snmp::OidOffset(1));
+        serialize(h, critd_prof_id_index(i));
+    }
+
+    VTSS_EXPOSE_SERIALIZE_ARG_2(critd_prof_critd_t &i) {
+        h.argument_properties(vtss::expose::snmp::OidOffset(2));
+        serialize(h, i);
+    }
+
+    VTSS_EXPOSE_GET_PTR(critd_prof_critd_get);
+    VTSS_EXPOSE_ITR_PTR(critd_prof_critd_itr);
+    VTSS_EXPOSE_WEB_PRIV(VTSS_PRIV_LVL_STAT_TYPE, VTSS_MODULE_ID_CRITD);
+};
+
+struct CritdProfSiteEntry {
+    typedef vtss::expose::ParamList<
+        vtss::expose::ParamKey<u32>,
+        vtss::expose::ParamKey<u32>,
+        vtss::expose::ParamVal<critd_prof_site_t *>
+    > P;
+
+    static constexpr const char *table_description =
+        "This is a table of wait, hold and blocker statistics per critd call site.";
+
+    static constexpr const char *index_description =
+        "Each entry has the statistics of a call site.";
+
+    VTSS_EXPOSE_SERIALIZE_ARG_1(u32 &i) {
+        h.argument_properties(vtss::expose::snmp::OidOffset(1));
+        serialize(h, critd_prof_id_index(i));
+    }
+
+    VTSS_EXPOSE_SERIALIZE_ARG_2(u32 &i) {
+        h.argument_properties(vtss::expose::snmp::OidOffset(2));
+        serialize(h, critd_prof_site_index(i));
+    }
+
+    VTSS_EXPOSE_SERIALIZE_ARG_3(critd_prof_site_t &i) {
+        h.argument_properties(vtss::expose::snmp::OidOffset(3));
+        serialize(h, i);
+    }
+
+    VTSS_EXPOSE_GET_PTR(critd_prof_site_get);
+    VTSS_EXPOSE_ITR_PTR(critd_prof_site_itr);
+    VTSS_EXPOSE_WEB_PRIV(VTSS_PRIV_LVL_STAT_TYPE, VTSS_MODULE_ID_CRITD);
+};
+
+}  // namespace interfaces
+}  // namespace critd
+}  // namespace appl
+}  // namespace vtss
+
+#endif /* __VTSS_CRITD_SERIALIZER_HXX__ */
@@ -0,0 +1,476 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Microbenchmark of critd_enter()/critd_exit() with the contention profiler
+// disabled and enabled.
+//
+// The real critd.cxx is linked with pthread-based stand-ins for the OS
+// wrapper (behaving like vtss_os_wrapper_linux.cxx). Each run has 1 or N
+// threads taking the same critd around a short critical section, and prints
+// the average time per critd_enter()/critd_exit() pair. A plain pthread mutex
+// is included for reference. Options:
+//   -t <max threads>           (default: 4)
+//   -n <iterations per thread> (default: 1000000)
+// After each profiled run, the merged samples are checked against the number
+// of iterations, so the benchmark fails if samples are lost or misattributed.
+
+#include "main.h"
+#include "critd_api.h"
+#include "crashhandler.hxx"
+#include "misc_api.h"
+#include "vtss_trace_api.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/******************************************************************************/
+// Stand-ins for the parts of the application critd.cxx depends on
+/******************************************************************************/
+vtss_common_assert_cb_t vtss_common_assert_cb;
+
+TraceRegister::TraceRegister(vtss_trace_reg_t *trace_reg_p, vtss_trace_grp_t *trace_grp_p, int grp_cnt)
+{
+}
+
+extern "C" void control_system_assert_do_reset(void)
+{
+    abort();
+}
+
+int crashfile_printf(const char *fmt, ...)
+{
+    return 0;
+}
+
+void crashfile_close(void)
+{
+}
+
+const char *misc_filename(const char *fn)
+{
+    const char *p = strrchr(fn, '/');
+
+    return p ? p + 1 : fn;
+}
+
+vtss_tick_count_t vtss_current_time(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (vtss_tick_count_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int vtss_thread_id_get(void)
+{
+    static std::atomic<int> id_next{1};
+    static thread_local int id;
+
+    if (!id) {
+        id = id_next++;
+    }
+
+    return id;
+}
+
+void vtss_thread_create(vtss_thread_prio_t priority, vtss_thread_entry_f *entry, vtss_addrword_t entry_data,
+                        const char *name, void *stack_base, u32 stack_size, vtss_handle_t *handle,
+                        vtss_thread_t *thread)
+{
+}
+
+static void bench_mutex_init(vtss_mutex_t *mutex, bool recursive)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    if (recursive) {
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    }
+
+    pthread_mutex_init(mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void vtss_mutex_init(vtss_mutex_t *mutex)
+{
+    bench_mutex_init(mutex, false);
+}
+
+void vtss_mutex_destroy(vtss_mutex_t *mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+vtss_bool_t vtss_mutex_lock(vtss_mutex_t *mutex)
+{
+    return pthread_mutex_lock(mutex) == 0;
+}
+
+vtss_bool_t vtss_mutex_trylock(vtss_mutex_t *mutex)
+{
+    return pthread_mutex_trylock(mutex) == 0;
+}
+
+void vtss_mutex_unlock(vtss_mutex_t *mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+
+void vtss_recursive_mutex_init(vtss_recursive_mutex_t *mutex)
+{
+    memset(mutex, 0, sizeof(*mutex));
+    bench_mutex_init(&mutex->mutex_, true);
+}
+
+vtss_bool_t vtss_recursive_mutex_lock(vtss_recursive_mutex_t *mutex)
+{
+    if (pthread_mutex_lock(&mutex->mutex_) == 0) {
+        mutex->lock_cnt++;
+        return true;
+    }
+
+    return false;
+}
+
+vtss_bool_t vtss_recursive_mutex_trylock(vtss_recursive_mutex_t *mutex)
+{
+    if (pthread_mutex_trylock(&mutex->mutex_) == 0) {
+        mutex->lock_cnt++;
+        return true;
+    }
+
+    return false;
+}
+
+int vtss_recursive_mutex_unlock(vtss_recursive_mutex_t *mutex)
+{
+    int lock_cnt_after = --mutex->lock_cnt;
+
+    pthread_mutex_unlock(&mutex->mutex_);
+    return lock_cnt_after;
+}
+
+// Flags and semaphores are protected by a mutex like on Linux.
+void vtss_flag_init(vtss_flag_t *flag)
+{
+    memset(flag, 0, sizeof(*flag));
+    bench_mutex_init(&flag->mutex, false);
+    pthread_cond_init(&flag->cond.cond, NULL);
+    flag->cond.mutex = &flag->mutex;
+}
+
+void vtss_flag_destroy(vtss_flag_t *flag)
+{
+    pthread_cond_destroy(&flag->cond.cond);
+    pthread_mutex_destroy(&flag->mutex);
+}
+
+void vtss_flag_setbits(vtss_flag_t *flag, vtss_flag_value_t value)
+{
+    pthread_mutex_lock(&flag->mutex);
+    flag->flags |= value;
+    pthread_cond_broadcast(&flag->cond.cond);
+    pthread_mutex_unlock(&flag->mutex);
+}
+
+vtss_flag_value_t vtss_flag_wait(vtss_flag_t *flag, vtss_flag_value_t pattern, vtss_flag_mode_t mode)
+{
+    vtss_flag_value_t result;
+
+    pthread_mutex_lock(&flag->mutex);
+    while ((flag->flags & pattern) == 0) {
+        pthread_cond_wait(&flag->cond.cond, &flag->mutex);
+    }
+
+    result = flag->flags;
+    pthread_mutex_unlock(&flag->mutex);
+    return result;
+}
+
+vtss_flag_value_t vtss_flag_peek(vtss_flag_t *flag)
+{
+    vtss_flag_value_t result;
+
+    pthread_mutex_lock(&flag->mutex);
+    result = flag->flags;
+    pthread_mutex_unlock(&flag->mutex);
+    return result;
+}
+
+void vtss_sem_init(vtss_sem_t *sem, u32 val)
+{
+    memset(sem, 0, sizeof(*sem));
+    bench_mutex_init(&sem->mutex, false);
+    pthread_cond_init(&sem->cond.cond, NULL);
+    sem->cond.mutex = &sem->mutex;
+    sem->count = val;
+}
+
+void vtss_sem_destroy(vtss_sem_t *sem)
+{
+    pthread_cond_destroy(&sem->cond.cond);
+    pthread_mutex_destroy(&sem->mutex);
+}
+
+void vtss_sem_wait(vtss_sem_t *sem)
+{
+    pthread_mutex_lock(&sem->mutex);
+    while (sem->count == 0) {
+        pthread_cond_wait(&sem->cond.cond, &sem->mutex);
+    }
+
+    sem->count--;
+    pthread_mutex_unlock(&sem->mutex);
+}
+
+void vtss_sem_post(vtss_sem_t *sem, u32 increment_by)
+{
+    pthread_mutex_lock(&sem->mutex);
+    sem->count += increment_by;
+    pthread_cond_broadcast(&sem->cond.cond);
+    pthread_mutex_unlock(&sem->mutex);
+}
+
+u32 vtss_sem_peek(vtss_sem_t *sem)
+{
+    u32 result;
+
+    pthread_mutex_lock(&sem->mutex);
+    result = sem->count;
+    pthread_mutex_unlock(&sem->mutex);
+    return result;
+}
+
+/******************************************************************************/
+// Benchmark
+/******************************************************************************/
+// Line number passed to critd_enter(), which the samples are attributed to
+#define BENCH_LINE 100
+
+static critd_t         bench_crit;
+static pthread_mutex_t bench_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile u32    bench_data;
+
+static void bench_work(void)
+{
+    int i;
+
+    // A short critical section
+    for (i = 0; i < 8; i++) {
+        bench_data = bench_data + 1;
+    }
+}
+
+static void bench_thread(bool use_critd, u32 iterations)
+{
+    u32 i;
+
+    for (i = 0; i < iterations; i++) {
+        if (use_critd) {
+            critd_enter(&bench_crit, __FILE__, BENCH_LINE);
+            bench_work();
+            critd_exit(&bench_crit, __FILE__, __LINE__);
+        } else {
+            pthread_mutex_lock(&bench_mutex);
+            bench_work();
+            pthread_mutex_unlock(&bench_mutex);
+        }
+    }
+}
+
+static double bench_run(bool use_critd, u32 thread_cnt, u32 iterations)
+{
+    std::vector<std::thread> threads;
+    u32                      t;
+
+    auto start = std::chrono::steady_clock::now();
+    for (t = 0; t < thread_cnt; t++) {
+        threads.emplace_back(bench_thread, use_critd, iterations);
+    }
+
+    for (auto &th : threads) {
+        th.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ((double)thread_cnt * iterations);
+}
+
+static u32 bench_hist_sum(const critd_prof_stat_t *stat)
+{
+    u32 sum = 0;
+    int b;
+
+    for (b = 0; b < CRITD_PROF_HIST_CNT; b++) {
+        sum += stat->hist[b];
+    }
+
+    return sum;
+}
+
+// Checks the merged samples of a run. Returns the number of errors.
+static int bench_check(u32 expected)
+{
+    critd_prof_critd_t entry;
+    critd_prof_site_t  site;
+    u32                id, next_id, s, next_s, contended = 0, blocked = 0;
+    const u32          *prev_id = NULL, *prev_s = NULL;
+    int                errors = 0;
+
+    id = bench_crit.prof_id;
+    if (critd_prof_critd_get(id, &entry) != VTSS_RC_OK) {
+        fprintf(stderr, "critd_prof_critd_get() failed\n");
+        return 1;
+    }
+
+    if (entry.wait.cnt != expected || entry.hold.cnt != expected) {
+        fprintf(stderr, "Expected %u samples, got %u waits and %u holds\n", expected, entry.wait.cnt, entry.hold.cnt);
+        errors++;
+    }
+
+    if (bench_hist_sum(&entry.wait) != entry.wait.cnt || bench_hist_sum(&entry.hold) != entry.hold.cnt) {
+        fprintf(stderr, "Histograms don't add up to the number of samples\n");
+        errors++;
+    }
+
+    if (entry.wait.max_ns > entry.wait.total_ns || entry.hold.max_ns > entry.hold.total_ns) {
+        fprintf(stderr, "Max. sample is larger than the sum of samples\n");
+        errors++;
+    }
+
+    // All waits and holds are at the same call site, and blockers only when
+    // contended.
+    while (critd_prof_site_itr(prev_id, &next_id, prev_s, &next_s) == VTSS_RC_OK) {
+        prev_id = &id;
+        prev_s  = &s;
+        id      = next_id;
+        s       = next_s;
+
+        if (critd_prof_site_get(id, s, &site) != VTSS_RC_OK) {
+            fprintf(stderr, "critd_prof_site_get(%u, %u) failed\n", id, s);
+            errors++;
+            break;
+        }
+
+        if (id != bench_crit.prof_id) {
+            continue;
+        }
+
+        if (site.line != BENCH_LINE || strcmp(site.file, misc_filename(__FILE__)) != 0) {
+            fprintf(stderr, "Unexpected call site %s#%d\n", site.file, site.line);
+            errors++;
+        }
+
+        if (site.role == CRITD_PROF_ROLE_WAIT) {
+            contended += site.stat.contended_cnt;
+        } else if (site.role == CRITD_PROF_ROLE_BLOCKER) {
+            blocked += site.stat.cnt;
+        }
+    }
+
+    if (contended != entry.wait.contended_cnt || blocked != contended) {
+        fprintf(stderr, "%u contended waits, but %u attributed to blockers\n", contended, blocked);
+        errors++;
+    }
+
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    u32                max_threads = 4, iterations = 1000000;
+    std::vector<u32>   thread_cnts;
+    critd_prof_critd_t entry;
+    double             ns_ref, ns_off, ns_on;
+    int                opt, errors = 0;
+
+    while ((opt = getopt(argc, argv, "t:n:")) != -1) {
+        switch (opt) {
+        case 't':
+            max_threads = atoi(optarg);
+            break;
+
+        case 'n':
+            iterations = atoi(optarg);
+            break;
+
+        default:
+            fprintf(stderr, "Usage: %s [-t <max threads>] [-n <iterations per thread>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    critd_init(&bench_crit, "bench", VTSS_MODULE_ID_MISC, CRITD_TYPE_MUTEX);
+
+    printf("%-8s %14s %14s %14s %10s\n", "Threads", "pthread [ns]", "Prof off [ns]", "Prof on [ns]", "Waits");
+    // Uncontended and contended
+    thread_cnts.push_back(1);
+    if (max_threads > 1) {
+        thread_cnts.push_back(max_threads);
+    }
+
+    for (auto thread_cnt : thread_cnts) {
+        ns_ref = bench_run(false, thread_cnt, iterations);
+
+        critd_prof_enable(false);
+        critd_prof_clear();
+        ns_off = bench_run(true, thread_cnt, iterations);
+        if (critd_prof_critd_get(bench_crit.prof_id, &entry) != VTSS_RC_OK || entry.wait.cnt || entry.hold.cnt) {
+            fprintf(stderr, "Samples taken while profiling was disabled\n");
+            errors++;
+        }
+
+        critd_prof_enable(true);
+        ns_on = bench_run(true, thread_cnt, iterations);
+        critd_prof_enable(false);
+        errors += bench_check(thread_cnt * iterations);
+
+        (void)critd_prof_critd_get(bench_crit.prof_id, &entry);
+        printf("%-8u %14.1f %14.1f %14.1f %10u (%u contended, avg wait %llu ns, avg hold %llu ns)\n",
+               thread_cnt, ns_ref, ns_off, ns_on, entry.wait.cnt, entry.wait.contended_cnt,
+               (unsigned long long)(entry.wait.cnt ? entry.wait.total_ns / entry.wait.cnt : 0),
+               (unsigned long long)(entry.hold.cnt ? entry.hold.total_ns / entry.hold.cnt : 0));
+    }
+
+    critd_delete(&bench_crit);
+
+    if (errors) {
+        fprintf(stderr, "FAILED: %d errors\n", errors);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
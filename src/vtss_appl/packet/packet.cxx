@@ -51,6 +51,10 @@
 #include <linux/filter.h>
 #include <sys/stat.h>
 #include "vtss_netlink.hxx"
+#include "packet_rx_classifier.hxx"
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+#include "main_conf.hxx"      /* For vtss::appl::main::module_conf_get() */
+#endif
 
 #define VTSS_ALLOC_MODULE_ID VTSS_MODULE_ID_PACKET
 
@@ -193,6 +197,77 @@ static uint64_t                 RX_xtr_qu_counters[8];
 static u32 TX_alloc_calls;
 static u32 TX_free_calls;
 
+// Tx buffers are allocated from a pool with a free list per size class, so
+// that periodically transmitted frames don't go through the heap every time.
+// Sizes include the possible VLAN tag and extra words from
+// packet_tx_alloc_extra(). Larger buffers are taken directly from the heap.
+static const u32 TX_pool_class_sizes[] = {128, 256, 512, 1024, 1664};
+#define TX_POOL_CLASS_CNT ARRSZ(TX_pool_class_sizes)
+
+// Max. number of free buffers kept per size class.
+#define TX_POOL_FREE_MAX 32
+
+#define TX_POOL_MAGIC 0x7458506c /* "tXPl" */
+
+// Header in front of all Tx buffers. Must keep the buffer 16-byte aligned.
+typedef struct tx_pool_hdr_s {
+    struct tx_pool_hdr_s *next;       // Next free buffer when on a free list
+    u32                  size_class; // Index into TX_pool_class_sizes[] or TX_POOL_CLASS_CNT if from the heap
+    u32                  magic;      // TX_POOL_MAGIC while allocated
+} tx_pool_hdr_t;
+
+#define TX_POOL_HDR_SIZE 16
+static_assert(sizeof(tx_pool_hdr_t) <= TX_POOL_HDR_SIZE, "tx_pool_hdr_t too big");
+
+typedef struct {
+    tx_pool_hdr_t *free_list;
+    u32           free_cnt; // Number of buffers on #free_list
+    u32           hits;     // Allocations served from #free_list
+    u32           misses;   // Allocations served from the heap
+    u32           releases; // Frees handed back to the heap, because #free_list was full
+} tx_pool_class_t;
+
+// Protected by CX_counter_crit. Last entry counts oversized buffers.
+static tx_pool_class_t TX_pool[TX_POOL_CLASS_CNT + 1];
+
+// Max. number of messages handed to sendmmsg() in one go by packet_tx_batch().
+#define TX_BATCH_MAX 32
+
+// State of one packet_tx_batch() call.
+typedef struct {
+    struct mmsghdr   msgs[TX_BATCH_MAX];
+    struct iovec     iov[TX_BATCH_MAX][3];
+    u8               ifh[TX_BATCH_MAX][MESA_PACKET_HDR_SIZE_BYTES];
+    u32              msg_frm_idx[TX_BATCH_MAX];  // Index into packet_tx_batch()'s tx_props of each message
+    u32              msg_cntr_idx[TX_BATCH_MAX]; // Index into CX_port_counters.tx_pkts[] of each message
+    u32              msg_len[TX_BATCH_MAX];      // User's frame length of each message
+    vtss_module_id_t msg_modid[TX_BATCH_MAX];    // Module that transmitted each message
+    u32              msg_cnt;
+
+    // A frame that is sent as more than one message is counted once. The
+    // messages of a frame are contiguous, so remember the last one counted.
+    u32              last_counted_frm_idx;
+
+    // Frame buffers cannot be freed until they have been sent.
+    u8               *free_frms[TX_BATCH_MAX];
+    u32              free_cnt;
+
+    mesa_rc          *rcs;
+    u32              syscalls;
+    u32              errors;
+} packet_tx_batch_t;
+
+// Per-frame context passed through the Tx functions.
+typedef struct {
+    packet_tx_ifh_cache_t *ifh_cache;      // NULL if the user hasn't asked for IFH caching
+    packet_tx_batch_t     *batch;          // NULL if not called through packet_tx_batch()
+    u32                   frm_idx;
+    u32                   cntr_idx;        // Index into CX_port_counters.tx_pkts[]
+    u32                   len;             // User's frame length
+    vtss_module_id_t      modid;
+    u32                   ifh_cache_hits;
+} packet_tx_ctx_t;
+
 // Parameters used in the throttling interface between user- and kernel space.
 // Keep in sync with the Kernel-space definitions
 enum {
@@ -273,6 +348,55 @@ static u32           RX_outstanding_max;   // Holds the maximum number of frames
 static u32           RX_total;             // Total number of frames received with recv()
 static u32           RX_processing = true; // When true, received frames are forwarded to the listeners. Otherwise, they are discarded right away.
 
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+// When running on the internal CPU, frames may be received through a
+// PACKET_MMAP TPACKET_V3 ring mapped on the IFH socket rather than with one
+// VTSS_MALLOC() and one recv() per frame. The frames are handed to
+// RX_thread_packet_handle() in place, and a block is handed back to the kernel
+// when the last frame in it has been processed by the dispatch threads.
+// The ring can be tuned or disabled with the following switch.conf options:
+//   [packet]
+//   rx_ring            = true|false
+//   rx_ring_block_size = <bytes, power-of-two number of pages>
+//   rx_ring_block_cnt  = <number of blocks>
+#define RX_RING_BLOCK_SIZE_DEFAULT (64 * 1024)
+#define RX_RING_BLOCK_CNT_DEFAULT  32
+#define RX_RING_BLOCK_TMO_MSEC     2 /* Kernel retires a partially filled block after this many msecs */
+
+typedef struct {
+    struct tpacket_block_desc *desc;    // Points to the block inside the mmap()ed ring
+    u32                       ref_cnt;  // One for RX_thread() while walking the block plus one per frame in the hands of the application
+} packet_rx_ring_block_t;
+
+typedef struct {
+    u64 blocks;                 // Number of blocks handed to us by the kernel
+    u64 blocks_released;        // Number of blocks handed back to the kernel
+    u64 frames;                 // Number of frames received through the ring
+    u64 frames_oversize;        // Number of frames discarded because they were larger than the current Rx MTU
+    u64 polls;                  // Number of times RX_thread() had to poll() for the next block
+    u64 user_full;              // Number of times RX_thread() had to wait for the application to release a block
+    u64 kernel_pkts;            // tpacket_stats_v3.tp_packets accumulated
+    u64 kernel_drops;           // tpacket_stats_v3.tp_drops accumulated
+    u64 kernel_freeze_q_cnt;    // tpacket_stats_v3.tp_freeze_q_cnt accumulated
+    u32 blocks_outstanding;     // Number of blocks currently owned by user space
+    u32 blocks_outstanding_max; // Maximum number of blocks owned by user space at any one time
+} packet_rx_ring_counters_t;
+
+// All members but the configuration are protected by RX_low_level_mutex.
+static struct {
+    bool                      ena;        // Set during INIT_CMD_INIT from switch.conf
+    bool                      active;     // Set when the ring has successfully been mapped
+    u32                       block_size;
+    u32                       block_cnt;
+    u8                        *map;
+    size_t                    map_size;
+    packet_rx_ring_block_t    *blocks;
+    u32                       cur_block;  // Only used by RX_thread()
+    vtss_cond_t               released;   // Signalled when a block is handed back to the kernel
+    packet_rx_ring_counters_t cnt;
+} RX_ring;
+#endif /* VTSS_SW_OPTION_PACKET_RX_ZERO_COPY */
+
 typedef struct {
     vtss_fifo_cp_t    fifo;                      // Contains the packet descriptors
     vtss_flag_t       flag;                      // Flag to signal when a new packet is ready in the FIFO.
@@ -306,6 +430,10 @@ static mesa_etype_t RX_vlan_s_custom_tpid;
 static u32 RX_filter_lists_alive;
 static u32 RX_filter_lists_total;
 
+// Size of the classifier compiled for the most recent filter list.
+static u32 RX_filter_classifier_leaf_cnt;
+static u32 RX_filter_classifier_entry_cnt;
+
 // NPI encapsulation, EPID is set up using MESA_CAP_PACKET_IFH_EPID during initialization
 static u8 npi_encap[] = {
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0x88, 0x80, 0x00, 0x00
@@ -320,6 +448,10 @@ typedef struct {
     u32                     ref_cnt;
     u32                     item_cnt;
     packet_rx_filter_item_t *items;
+
+    // Compiled version of #items used to find the candidate subscribers of a
+    // frame without walking all of them.
+    PacketRxClassifier      *classifier;
 } packet_rx_filter_list_t;
 
 // Structure passed through Rx FIFOs to prioritized threads executed by RX_dispatch_thread().
@@ -328,6 +460,13 @@ typedef struct packet_dscr_s {
     // only known to the caller of RX_thread_packet_handle().
     void *opaque;
 
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+    // When non-NULL, the frame lives in this block of the Rx ring and #opaque
+    // is NULL. The block is handed back to the kernel by RX_thread_frm_free()
+    // when the last reference to it is gone.
+    packet_rx_ring_block_t *ring_block;
+#endif
+
     // Points to the first byte of the DMAC when the user-module gets called back.
     u8 *frm_ptr;
 
@@ -350,8 +489,17 @@ typedef struct packet_dscr_s {
     // This points to the filter in #filter_list that we're going to callback subscriber for.
     packet_rx_filter_item_t *current_filter;
 
-    // This points to the next item in #filter_list to process.
-    packet_rx_filter_item_t *next_filter;
+    // The fields of the frame that #filter_list's classifier keys on. Only
+    // valid if classifier_key_valid is TRUE, which it's not for runt frames.
+    packet_rx_classifier_key_t classifier_key;
+    BOOL                       classifier_key_valid;
+
+    // The candidate subscribers for this frame as found by #filter_list's
+    // classifier. Only these need to be matched against.
+    const packet_rx_classifier_leaf_t *leaf;
+
+    // Index of the next entry in #leaf to process.
+    u32 next_entry;
 
     // This points to the next item in #filter_list when looking
     // for default-subscribers.
@@ -874,6 +1022,9 @@ static void RX_filter_list_release(packet_rx_filter_list_t *filter_list, BOOL cr
     } else if (--filter_list->ref_cnt == 0) {
         T_RG(TRACE_GRP_RX, "Releasing filter %p", filter_list);
         RX_filter_lists_alive--;
+        if (filter_list->classifier) {
+            vtss_destroy(filter_list->classifier);
+        }
         VTSS_FREE(filter_list);
     }
 
@@ -882,8 +1033,66 @@ static void RX_filter_list_release(packet_rx_filter_list_t *filter_list, BOOL cr
     }
 }
 
+/****************************************************************************/
+// RX_filter_mac_compile()
+// Converts a MAC address or mask to a 48-bit integer
+/****************************************************************************/
+static u64 RX_filter_mac_compile(const u8 *mac)
+{
+    u64 val = 0;
+    u32 i;
+
+    for (i = 0; i < VTSS_MAC_ADDR_SZ_BYTES; i++) {
+        val = (val << 8) | mac[i];
+    }
+
+    return val;
+}
+
+/****************************************************************************/
+// RX_filter_classifier_create()
+// Compiles the items of #filter_list into a classifier.
+/****************************************************************************/
+static PacketRxClassifier *RX_filter_classifier_create(const packet_rx_filter_list_t *filter_list)
+{
+    std::vector<packet_rx_classifier_rule_t> rules;
+    u32                                      i;
+
+    rules.resize(filter_list->item_cnt);
+
+    for (i = 0; i < filter_list->item_cnt; i++) {
+        const packet_rx_filter_t    *filter = &filter_list->items[i].filter;
+        packet_rx_classifier_rule_t &r      = rules[i];
+        u32                         match   = filter->match;
+
+        // The masks of the filters are already in the internal polarity (see
+        // RX_filter_insert()). Default subscribers are never taken in the first
+        // pass of RX_match_next().
+        r.skip             = (match & PACKET_RX_FILTER_MATCH_DEFAULT) != 0;
+        r.etype_ena        = (match & PACKET_RX_FILTER_MATCH_ETYPE)   != 0;
+        r.etype            = filter->etype;
+        r.etype_mask       = filter->etype_mask;
+        r.ip_proto_ena     = (match & PACKET_RX_FILTER_MATCH_IP_PROTO) != 0;
+        r.ip_proto         = filter->ip_proto;
+        r.ip_proto_mask    = filter->ip_proto_mask;
+        r.udp_dst_port_ena = (match & PACKET_RX_FILTER_MATCH_UDP_DST_PORT) != 0;
+        r.udp_dst_port_min = filter->udp_dst_port_min;
+        r.udp_dst_port_max = filter->udp_dst_port_max;
+        r.dmac_ena         = (match & PACKET_RX_FILTER_MATCH_DMAC) != 0;
+        r.dmac             = RX_filter_mac_compile(filter->dmac);
+        r.dmac_mask        = RX_filter_mac_compile(filter->dmac_mask);
+        r.smac_ena         = (match & PACKET_RX_FILTER_MATCH_SMAC) != 0;
+        r.smac             = RX_filter_mac_compile(filter->smac);
+        r.smac_mask        = RX_filter_mac_compile(filter->smac_mask);
+    }
+
+    return VTSS_CREATE(PacketRxClassifier, rules);
+}
+
 /****************************************************************************/
 // RX_filter_list_get()
+// Gets a reference to the current filter list and looks up the candidate
+// subscribers for the frame, whose classifier_key must be filled in.
 /****************************************************************************/
 static void RX_filter_list_get(packet_dscr_t *packet_dscr)
 {
@@ -947,15 +1156,26 @@ static void RX_filter_list_get(packet_dscr_t *packet_dscr)
                 src = src->next;
                 dst = dst->next;
             }
+
+            if ((cached_filter_list->classifier = RX_filter_classifier_create(cached_filter_list)) == NULL) {
+                T_EG(TRACE_GRP_RX, "Unable to create filter list classifier");
+                RX_filter_lists_alive--;
+                VTSS_FREE(cached_filter_list);
+                cached_filter_list = NULL;
+            }
         }
 
+        RX_filter_classifier_leaf_cnt  = cached_filter_list ? cached_filter_list->classifier->leaf_cnt()  : 0;
+        RX_filter_classifier_entry_cnt = cached_filter_list ? cached_filter_list->classifier->entry_cnt() : 0;
+
         RX_filter_list_changed = FALSE;
     }
 
     // Pass a reference to #packet_dscr while increasing the ref-cnt.
     packet_dscr->filter_list = cached_filter_list;
-    packet_dscr->next_filter = cached_filter_list ? cached_filter_list->items : NULL;
-    packet_dscr->next_default_filter = packet_dscr->next_filter;
+    packet_dscr->leaf = cached_filter_list && packet_dscr->classifier_key_valid ? cached_filter_list->classifier->lookup(&packet_dscr->classifier_key) : NULL;
+    packet_dscr->next_entry = 0;
+    packet_dscr->next_default_filter = cached_filter_list ? cached_filter_list->items : NULL;
     if (packet_dscr->filter_list) {
         packet_dscr->filter_list->ref_cnt++;
     }
@@ -1228,6 +1448,32 @@ static int RX_do_callback(packet_rx_dispatch_thread_state_t *thread_state, packe
     return result;
 }
 
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+/****************************************************************************/
+// RX_ring_block_put()
+// Releases one reference to #block and hands the block back to the kernel
+// when it's the last one.
+// RX_low_level_mutex must be taken.
+/****************************************************************************/
+static void RX_ring_block_put(packet_rx_ring_block_t *block)
+{
+    if (block->ref_cnt == 0) {
+        T_EG(TRACE_GRP_RX, "Ref count is already zero on ring block %p", block->desc);
+        return;
+    }
+
+    if (--block->ref_cnt == 0) {
+        // Make sure all our accesses to the frames in the block are done
+        // before the kernel is allowed to overwrite it.
+        __sync_synchronize();
+        block->desc->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        RX_ring.cnt.blocks_released++;
+        RX_ring.cnt.blocks_outstanding--;
+        vtss_cond_signal(&RX_ring.released);
+    }
+}
+#endif /* VTSS_SW_OPTION_PACKET_RX_ZERO_COPY */
+
 /****************************************************************************/
 // RX_thread_frm_free()
 /****************************************************************************/
@@ -1239,9 +1485,17 @@ static void RX_thread_frm_free(packet_dscr_t *packet_dscr)
     // Free the frame pointer and increase the semaphore count since we can now
     // handle one more frame.
     T_RG(TRACE_GRP_RX, "Freeing the frame");
-    VTSS_FREE(packet_dscr->opaque);
+    if (packet_dscr->opaque) {
+        VTSS_FREE(packet_dscr->opaque);
+    }
 
     (void)vtss_mutex_lock(&RX_low_level_mutex);
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+    if (packet_dscr->ring_block) {
+        RX_ring_block_put(packet_dscr->ring_block);
+    }
+#endif
+
     if (RX_outstanding-- == RX_BUF_CNT) {
         max_has_been_hit = true;
     }
@@ -1351,7 +1605,7 @@ static void RX_dispatch_thread(vtss_addrword_t data)
             PACKET_RX_DISPATCH_THREAD_CRIT_EXIT();
 
             if (work) {
-                T_RG(TRACE_GRP_RX, "opaque = %p\nfrm_ptr = %p\nact_len = %u\nfilter_list = %p\nmatch_cnt = %u\nmatch_default_cnt = %u\ncurrent_filter = %p\nnext_filter = %p\nnext_default_filter = %p\n",
+                T_RG(TRACE_GRP_RX, "opaque = %p\nfrm_ptr = %p\nact_len = %u\nfilter_list = %p\nmatch_cnt = %u\nmatch_default_cnt = %u\ncurrent_filter = %p\nnext_entry = %u\nnext_default_filter = %p\n",
                      packet_dscr.opaque,
                      packet_dscr.frm_ptr,
                      packet_dscr.act_len,
@@ -1359,7 +1613,7 @@ static void RX_dispatch_thread(vtss_addrword_t data)
                      packet_dscr.match_cnt,
                      packet_dscr.match_default_cnt,
                      packet_dscr.current_filter,
-                     packet_dscr.next_filter,
+                     packet_dscr.next_entry,
                      packet_dscr.next_default_filter);
                 RX_callback(thread_state, &packet_dscr);
             } else {
@@ -1459,12 +1713,15 @@ static BOOL RX_match_next(packet_dscr_t *packet_dscr)
 {
     mesa_packet_rx_info_t *rx_info = &packet_dscr->rx_info;
     u8                    *frm_ptr = packet_dscr->frm_ptr;
-    u32                   i;
 
-    // Go on with the next filter
-    while (packet_dscr->next_filter) {
-        packet_rx_filter_t *filter = &packet_dscr->next_filter->filter;
-        u32                match  = filter->match;
+    // Go on with the next candidate filter. The classifier has already ruled
+    // out all filters whose EtherType, IP protocol, or UDP destination port
+    // doesn't match the frame, and has compiled the MAC matches.
+    while (packet_dscr->leaf && packet_dscr->next_entry < packet_dscr->leaf->cnt) {
+        const packet_rx_classifier_entry_t *entry = &packet_dscr->leaf->entries[packet_dscr->next_entry];
+        packet_rx_filter_item_t            *item  = &packet_dscr->filter_list->items[entry->idx];
+        packet_rx_filter_t                 *filter = &item->filter;
+        u32                                match  = filter->match;
 
         packet_dscr->strip_outer_tag = FALSE;
 
@@ -1502,20 +1759,9 @@ static BOOL RX_match_next(packet_dscr_t *packet_dscr)
             }
         }
 
-        if (match & PACKET_RX_FILTER_MATCH_DMAC) {
-            for (i = 0; i < sizeof(filter->dmac); i++) {
-                if ((frm_ptr[DMAC_POS + i] & filter->dmac_mask[i]) != filter->dmac[i]) {
-                    goto no_match;
-                }
-            }
-        }
-
-        if (match & PACKET_RX_FILTER_MATCH_SMAC) {
-            for (i = 0; i < sizeof(filter->smac); i++) {
-                if ((frm_ptr[SMAC_POS + i] & filter->smac_mask[i]) != filter->smac[i]) {
-                    goto no_match;
-                }
-            }
+        // Covers both PACKET_RX_FILTER_MATCH_DMAC and PACKET_RX_FILTER_MATCH_SMAC
+        if (!packet_rx_classifier_mac_match(entry, &packet_dscr->classifier_key)) {
+            goto no_match;
         }
 
         if (match & PACKET_RX_FILTER_MATCH_ETYPE) {
@@ -1614,14 +1860,14 @@ static BOOL RX_match_next(packet_dscr_t *packet_dscr)
         // Match!!!
         // Save a ref to the filter we want to call the subscriber for,
         // advance the iteration filter and post the frame on the relevant thread.
-        packet_dscr->current_filter = packet_dscr->next_filter;
-        packet_dscr->next_filter    = packet_dscr->next_filter->next;
+        packet_dscr->current_filter = item;
+        packet_dscr->next_entry++;
         T_DG(TRACE_GRP_RX, "%s: Match", vtss_module_names[filter->modid]);
         return RX_dispatch_thread_put(packet_dscr);
 
 no_match:
         T_RG(TRACE_GRP_RX, "%s: No match", vtss_module_names[filter->modid]);
-        packet_dscr->next_filter = packet_dscr->next_filter->next;
+        packet_dscr->next_entry++;
         continue;
     }
 
@@ -1715,6 +1961,9 @@ static void RX_dispatch_init(packet_dscr_t *packet_dscr)
     packet_dscr->match_cnt = 0;
     packet_dscr->match_default_cnt = 0;
 
+    // Extract the fields used to find the candidate subscribers of the frame.
+    packet_dscr->classifier_key_valid = packet_rx_classifier_key_get(frm_ptr, rx_info->length, packet_dscr->etype, &packet_dscr->classifier_key);
+
     // Get a reference to the most recent Rx filter list while increasing ref_cnt on it.
     RX_filter_list_get(packet_dscr);
 
@@ -2032,6 +2281,216 @@ static int RX_register_based(uint8_t *frm_ptr, int max_len, mesa_packet_rx_info_
     return rx_info.length;
 }
 
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+/****************************************************************************/
+// RX_ring_open()
+// Converts #fd into a TPACKET_V3 socket with an mmap()ed Rx ring.
+/****************************************************************************/
+static mesa_rc RX_ring_open(int fd)
+{
+    struct tpacket_req3 req;
+    int                 ver = TPACKET_V3;
+    long                page_size = sysconf(_SC_PAGESIZE);
+    u32                 i, max_len;
+
+    // A block must be a power-of-two number of pages and must be able to hold
+    // at least one frame of maximum size.
+    max_len = TPACKET_ALIGN(TPACKET3_HDRLEN) + RX_mtu + NPI_ENCAP_LEN + RX_ifh_size;
+    if (page_size <= 0 || RX_ring.block_size < max_len || RX_ring.block_size % page_size || (RX_ring.block_size & (RX_ring.block_size - 1)) || RX_ring.block_cnt < 2) {
+        T_EG(TRACE_GRP_RX, "Invalid Rx ring config (block_size = %u, block_cnt = %u, max frame size = %u)", RX_ring.block_size, RX_ring.block_cnt, max_len);
+        return VTSS_RC_ERROR;
+    }
+
+    if (setsockopt(fd, SOL_PACKET, PACKET_VERSION, &ver, sizeof(ver)) != 0) {
+        T_EG(TRACE_GRP_RX, "setsockopt(PACKET_VERSION) failed: %s", strerror(errno));
+        return VTSS_RC_ERROR;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size       = RX_ring.block_size;
+    req.tp_block_nr         = RX_ring.block_cnt;
+    req.tp_frame_size       = TPACKET_ALIGN(max_len); // Not used by TPACKET_V3 other than for validation
+    req.tp_frame_nr         = (RX_ring.block_size / req.tp_frame_size) * RX_ring.block_cnt;
+    req.tp_retire_blk_tov   = RX_RING_BLOCK_TMO_MSEC;
+    req.tp_feature_req_word = 0;
+
+    if (setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0) {
+        T_EG(TRACE_GRP_RX, "setsockopt(PACKET_RX_RING) failed: %s", strerror(errno));
+        goto do_exit_version;
+    }
+
+    RX_ring.map_size = (size_t)RX_ring.block_size * RX_ring.block_cnt;
+    if ((RX_ring.map = (u8 *)mmap(NULL, RX_ring.map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, fd, 0)) == MAP_FAILED) {
+        T_EG(TRACE_GRP_RX, "mmap() of %zu bytes failed: %s", RX_ring.map_size, strerror(errno));
+        RX_ring.map = NULL;
+        goto do_exit_ring;
+    }
+
+    if ((VTSS_CALLOC_CAST(RX_ring.blocks, RX_ring.block_cnt, sizeof(*RX_ring.blocks))) == NULL) {
+        T_EG(TRACE_GRP_RX, "Unable to allocate %u ring block descriptors", RX_ring.block_cnt);
+        goto do_exit_unmap;
+    }
+
+    for (i = 0; i < RX_ring.block_cnt; i++) {
+        RX_ring.blocks[i].desc = (struct tpacket_block_desc *)(RX_ring.map + (size_t)i * RX_ring.block_size);
+    }
+
+    RX_ring.cur_block = 0;
+    RX_ring.active    = true;
+    T_IG(TRACE_GRP_RX, "Rx ring mapped: %u blocks of %u bytes", RX_ring.block_cnt, RX_ring.block_size);
+    return VTSS_RC_OK;
+
+do_exit_unmap:
+    (void)munmap(RX_ring.map, RX_ring.map_size);
+    RX_ring.map = NULL;
+
+do_exit_ring:
+    // Tear down the ring again by requesting one with zero blocks.
+    memset(&req, 0, sizeof(req));
+    (void)setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+
+do_exit_version:
+    ver = TPACKET_V1;
+    (void)setsockopt(fd, SOL_PACKET, PACKET_VERSION, &ver, sizeof(ver));
+    return VTSS_RC_ERROR;
+}
+
+/****************************************************************************/
+// RX_ring_kernel_stats_update()
+// The kernel clears its statistics when read, so accumulate them.
+// RX_low_level_mutex must be taken.
+/****************************************************************************/
+static void RX_ring_kernel_stats_update(void)
+{
+    struct tpacket_stats_v3 stats;
+    socklen_t               len = sizeof(stats);
+
+    if (!RX_ring.active) {
+        return;
+    }
+
+    if (getsockopt(ifh_sock, SOL_PACKET, PACKET_STATISTICS, &stats, &len) != 0) {
+        T_EG(TRACE_GRP_RX, "getsockopt(PACKET_STATISTICS) failed: %s", strerror(errno));
+        return;
+    }
+
+    RX_ring.cnt.kernel_pkts         += stats.tp_packets;
+    RX_ring.cnt.kernel_drops        += stats.tp_drops;
+    RX_ring.cnt.kernel_freeze_q_cnt += stats.tp_freeze_q_cnt;
+}
+
+/****************************************************************************/
+// RX_ring_thread()
+// Replaces the recv()-based loop in RX_thread() when the Rx ring is active.
+// Never returns.
+/****************************************************************************/
+static void RX_ring_thread(void)
+{
+    packet_dscr_t packet_dscr;
+    struct pollfd pfd;
+    u32           i, pkt_cnt, len, max_len, status, ref_cnt;
+
+    memset(&pfd, 0, sizeof(pfd));
+    pfd.fd     = ifh_sock;
+    pfd.events = POLLIN | POLLERR;
+
+    memset(&packet_dscr, 0, sizeof(packet_dscr));
+
+    while (1) {
+        packet_rx_ring_block_t    *block = &RX_ring.blocks[RX_ring.cur_block];
+        struct tpacket_block_desc *desc  = block->desc;
+        struct tpacket3_hdr       *hdr;
+
+        status = __atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+
+        (void)vtss_mutex_lock(&RX_low_level_mutex);
+        ref_cnt = block->ref_cnt;
+        if ((status & TP_STATUS_USER) == 0) {
+            RX_ring.cnt.polls++;
+        } else if (ref_cnt) {
+            // The block is still owned by the application from the previous
+            // round in the ring, so the kernel can't have filled it again.
+            // All blocks are in use by the application. Wait for it to release
+            // this one. It's then up to the kernel to discard excess frames.
+            RX_ring.cnt.user_full++;
+            while (block->ref_cnt) {
+                (void)vtss_cond_wait(&RX_ring.released);
+            }
+        }
+        vtss_mutex_unlock(&RX_low_level_mutex);
+
+        if ((status & TP_STATUS_USER) == 0) {
+            // Wait for the kernel to retire the block.
+            (void)poll(&pfd, 1, -1);
+            continue;
+        }
+
+        if (ref_cnt) {
+            // Handed back to the kernel in the meanwhile, so start over.
+            continue;
+        }
+
+        pkt_cnt = desc->hdr.bh1.num_pkts;
+        hdr     = (struct tpacket3_hdr *)((u8 *)desc + desc->hdr.bh1.offset_to_first_pkt);
+
+        (void)vtss_mutex_lock(&RX_low_level_mutex);
+        block->ref_cnt = 1; // Our own reference while walking the block
+        RX_ring.cnt.blocks++;
+        if (++RX_ring.cnt.blocks_outstanding > RX_ring.cnt.blocks_outstanding_max) {
+            RX_ring.cnt.blocks_outstanding_max = RX_ring.cnt.blocks_outstanding;
+        }
+        vtss_mutex_unlock(&RX_low_level_mutex);
+
+        for (i = 0; i < pkt_cnt; i++) {
+            // RX_mtu is variable.
+            max_len = RX_mtu + NPI_ENCAP_LEN + RX_ifh_size;
+            len     = hdr->tp_snaplen;
+
+            // Wait until we're allowed to hand out new packets. See RX_thread().
+            vtss_sem_wait(&RX_packet_sem);
+
+            if (hdr->tp_len > hdr->tp_snaplen || len > max_len) {
+                T_IG(TRACE_GRP_RX, "Discarding oversize frame (len = %u, snaplen = %u, max_len = %u)", hdr->tp_len, len, max_len);
+                (void)vtss_mutex_lock(&RX_low_level_mutex);
+                RX_ring.cnt.frames_oversize++;
+                vtss_mutex_unlock(&RX_low_level_mutex);
+                vtss_sem_post(&RX_packet_sem);
+            } else {
+                packet_dscr.opaque     = NULL;
+                packet_dscr.ring_block = block;
+                packet_dscr.frm_ptr    = (u8 *)hdr + hdr->tp_mac;
+                packet_dscr.act_len    = len;
+
+                (void)vtss_mutex_lock(&RX_low_level_mutex);
+                RX_total++;
+                RX_ring.cnt.frames++;
+                block->ref_cnt++;
+                if (++RX_outstanding > RX_outstanding_max) {
+                    RX_outstanding_max = RX_outstanding;
+                }
+                vtss_mutex_unlock(&RX_low_level_mutex);
+
+                if (RX_processing) {
+                    RX_thread_packet_handle(&packet_dscr);
+                } else {
+                    RX_thread_frm_free(&packet_dscr);
+                }
+            }
+
+            hdr = (struct tpacket3_hdr *)((u8 *)hdr + hdr->tp_next_offset);
+        }
+
+        // Release our own reference. If all frames have already been handled,
+        // this hands the block back to the kernel.
+        (void)vtss_mutex_lock(&RX_low_level_mutex);
+        RX_ring_block_put(block);
+        vtss_mutex_unlock(&RX_low_level_mutex);
+
+        RX_ring.cur_block = (RX_ring.cur_block + 1) % RX_ring.block_cnt;
+    }
+}
+#endif /* VTSS_SW_OPTION_PACKET_RX_ZERO_COPY */
+
 /****************************************************************************/
 // RX_thread()
 /****************************************************************************/
@@ -2050,11 +2509,21 @@ static void RX_thread(vtss_addrword_t data)
         if ((ifh_sock = CX_socket_open()) < 0) {
             return;
         }
+
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+        // Fall back to recv() if the ring cannot be set up.
+        if (RX_ring.ena && RX_ring_open(ifh_sock) == VTSS_RC_OK) {
+            RX_ring_thread();
+        }
+#endif
     } else {
         // On an external CPU, we need to use register-based Rx/Tx.
     }
 
     packet_dscr.frm_ptr = NULL;
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+    packet_dscr.ring_block = NULL;
+#endif
 
     while (1) {
         // RX_mtu is variable.
@@ -2191,7 +2660,7 @@ static void DBG_cmd_stat_module_print(packet_dbg_printf_t dbg_printf, u32 parms_
 /****************************************************************************/
 static void DBG_cmd_stat_thread_print(packet_dbg_printf_t dbg_printf, u32 parms_cnt, u32 *parms)
 {
-    u32 a, b;
+    u32 a, b, leaf_cnt, entry_cnt;
     int thread_prio;
 
     // Statistics
@@ -2222,12 +2691,16 @@ static void DBG_cmd_stat_thread_print(packet_dbg_printf_t dbg_printf, u32 parms_
     PACKET_RX_FILTER_CRIT_ENTER();
     a = RX_filter_lists_alive;
     b = RX_filter_lists_total;
+    leaf_cnt  = RX_filter_classifier_leaf_cnt;
+    entry_cnt = RX_filter_classifier_entry_cnt;
     PACKET_RX_FILTER_CRIT_EXIT();
 
     (void)dbg_printf("\nRx Filter Lists\n");
     (void)dbg_printf("---------------\n");
-    (void)dbg_printf("Alive: %8u\n", a);
-    (void)dbg_printf("Total: %8u\n\n", b);
+    (void)dbg_printf("Alive:   %8u\n", a);
+    (void)dbg_printf("Total:   %8u\n", b);
+    (void)dbg_printf("Leaves:  %8u\n", leaf_cnt);
+    (void)dbg_printf("Entries: %8u\n\n", entry_cnt);
 
     (void)vtss_mutex_lock(&RX_low_level_mutex);
     a = RX_outstanding;
@@ -2518,6 +2991,145 @@ static void DBG_cmd_stat_rx_qu_clear(packet_dbg_printf_t dbg_printf, u32 parms_c
     PACKET_CX_COUNTER_CRIT_EXIT();
 }
 
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+/****************************************************************************/
+// DBG_cmd_stat_rx_ring_print()
+// cmd_text   : "Print Rx ring statistics",
+// arg_syntax : NULL,
+// max_arg_cnt: 0
+/****************************************************************************/
+static void DBG_cmd_stat_rx_ring_print(packet_dbg_printf_t dbg_printf, u32 parms_cnt, u32 *parms)
+{
+    packet_rx_ring_counters_t cnt;
+    bool                      active;
+
+    (void)vtss_mutex_lock(&RX_low_level_mutex);
+    RX_ring_kernel_stats_update();
+    active = RX_ring.active;
+    cnt    = RX_ring.cnt;
+    vtss_mutex_unlock(&RX_low_level_mutex);
+
+    (void)dbg_printf("Rx ring            : %s\n", active ? "Active" : RX_ring.ena ? "Enabled, but not active" : "Disabled");
+    if (!active) {
+        return;
+    }
+
+    (void)dbg_printf("Block size         : %10u bytes\n", RX_ring.block_size);
+    (void)dbg_printf("Block count        : %10u\n\n", RX_ring.block_cnt);
+    (void)dbg_printf("Blocks received    : " VPRI64Fu("10") "\n", cnt.blocks);
+    (void)dbg_printf("Blocks released    : " VPRI64Fu("10") "\n", cnt.blocks_released);
+    (void)dbg_printf("Blocks in use      : %10u\n", cnt.blocks_outstanding);
+    (void)dbg_printf("Blocks in use (max): %10u\n", cnt.blocks_outstanding_max);
+    (void)dbg_printf("Frames received    : " VPRI64Fu("10") "\n", cnt.frames);
+    (void)dbg_printf("Frames oversize    : " VPRI64Fu("10") "\n", cnt.frames_oversize);
+    (void)dbg_printf("Polls              : " VPRI64Fu("10") "\n", cnt.polls);
+    (void)dbg_printf("Ring full (user)   : " VPRI64Fu("10") "\n", cnt.user_full);
+    (void)dbg_printf("Kernel packets     : " VPRI64Fu("10") "\n", cnt.kernel_pkts);
+    (void)dbg_printf("Kernel drops       : " VPRI64Fu("10") "\n", cnt.kernel_drops);
+    (void)dbg_printf("Kernel queue freeze: " VPRI64Fu("10") "\n\n", cnt.kernel_freeze_q_cnt);
+}
+
+/****************************************************************************/
+// DBG_cmd_stat_rx_ring_clear()
+// cmd_text   : "Clear Rx ring statistics",
+// arg_syntax : NULL,
+// max_arg_cnt: 0
+/****************************************************************************/
+static void DBG_cmd_stat_rx_ring_clear(packet_dbg_printf_t dbg_printf, u32 parms_cnt, u32 *parms)
+{
+    u32 outstanding;
+
+    (void)vtss_mutex_lock(&RX_low_level_mutex);
+    // Read and thereby clear the kernel's counters as well.
+    RX_ring_kernel_stats_update();
+
+    // Cannot clear blocks_outstanding, because it's decremented when blocks
+    // are released.
+    outstanding = RX_ring.cnt.blocks_outstanding;
+    vtss_clear(RX_ring.cnt);
+    RX_ring.cnt.blocks_outstanding     = outstanding;
+    RX_ring.cnt.blocks_outstanding_max = outstanding;
+    vtss_mutex_unlock(&RX_low_level_mutex);
+}
+#endif /* VTSS_SW_OPTION_PACKET_RX_ZERO_COPY */
+
+/****************************************************************************/
+// DBG_cmd_stat_tx_print()
+// cmd_text   : "Print Tx buffer pool and batch statistics",
+// arg_syntax : NULL,
+// max_arg_cnt: 0
+/****************************************************************************/
+static void DBG_cmd_stat_tx_print(packet_dbg_printf_t dbg_printf, u32 parms_cnt, u32 *parms)
+{
+    tx_pool_class_t          pool[ARRSZ(TX_pool)];
+    packet_module_counters_t cntrs;
+    u32                      c;
+    int                      i;
+
+    PACKET_CX_COUNTER_CRIT_ENTER();
+    memcpy(pool, TX_pool, sizeof(pool));
+    PACKET_CX_COUNTER_CRIT_EXIT();
+
+    (void)dbg_printf("\nBuffer Size Hits       Misses     Releases   Free\n");
+    (void)dbg_printf(  "----------- ---------- ---------- ---------- ----\n");
+    for (c = 0; c < ARRSZ(pool); c++) {
+        if (c < TX_POOL_CLASS_CNT) {
+            (void)dbg_printf("%11u ", TX_pool_class_sizes[c]);
+        } else {
+            (void)dbg_printf("%11s ", "Larger");
+        }
+
+        (void)dbg_printf("%10u %10u %10u %4u\n", pool[c].hits, pool[c].misses, pool[c].releases, pool[c].free_cnt);
+    }
+
+    (void)dbg_printf("\nModule                Batches    Batch Pkts Syscalls   Errors     IFH Cache Hits\n");
+    (void)dbg_printf(  "--------------------- ---------- ---------- ---------- ---------- --------------\n");
+    for (i = 0; i <= VTSS_MODULE_ID_NONE; i++) {
+        PACKET_CX_COUNTER_CRIT_ENTER();
+        cntrs = CX_module_counters[i];
+        PACKET_CX_COUNTER_CRIT_EXIT();
+
+        if (cntrs.tx_batch_calls != 0 || cntrs.tx_ifh_cache_hits != 0) {
+            (void)dbg_printf("%-21s %10u %10u %10u %10u %14u\n", vtss_module_names[i], cntrs.tx_batch_calls, cntrs.tx_batch_pkts, cntrs.tx_batch_syscalls, cntrs.tx_batch_errors, cntrs.tx_ifh_cache_hits);
+        }
+    }
+
+    (void)dbg_printf("\n");
+}
+
+/****************************************************************************/
+// DBG_cmd_stat_tx_clear()
+// cmd_text   : "Clear Tx buffer pool and batch statistics",
+// arg_syntax : NULL,
+// max_arg_cnt: 0
+/****************************************************************************/
+static void DBG_cmd_stat_tx_clear(packet_dbg_printf_t dbg_printf, u32 parms_cnt, u32 *parms)
+{
+    u32 c;
+    int i;
+
+    PACKET_CX_COUNTER_CRIT_ENTER();
+    for (c = 0; c < ARRSZ(TX_pool); c++) {
+        // The free list itself is left untouched.
+        TX_pool[c].hits     = 0;
+        TX_pool[c].misses   = 0;
+        TX_pool[c].releases = 0;
+    }
+
+    for (i = 0; i <= VTSS_MODULE_ID_NONE; i++) {
+        packet_module_counters_t *cntrs = &CX_module_counters[i];
+
+        cntrs->tx_batch_calls    = 0;
+        cntrs->tx_batch_pkts     = 0;
+        cntrs->tx_batch_syscalls = 0;
+        cntrs->tx_batch_errors   = 0;
+        cntrs->tx_ifh_cache_hits = 0;
+    }
+    PACKET_CX_COUNTER_CRIT_EXIT();
+
+    (void)dbg_printf("Tx pool and batch statistics cleared!\n");
+}
+
 static void CX_ufdma_stati_clear(void);
 
 /****************************************************************************/
@@ -2532,6 +3144,10 @@ static void DBG_cmd_stat_all_clear(packet_dbg_printf_t dbg_printf, u32 parms_cnt
     DBG_cmd_stat_port_clear(dbg_printf, parms_cnt, parms);
     DBG_cmd_stat_thread_clear(dbg_printf, parms_cnt, parms);
     DBG_cmd_stat_rx_qu_clear(dbg_printf, parms_cnt, parms);
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+    DBG_cmd_stat_rx_ring_clear(dbg_printf, parms_cnt, parms);
+#endif
+    DBG_cmd_stat_tx_clear(dbg_printf, parms_cnt, parms);
     CX_ufdma_stati_clear();
 }
 
@@ -2623,6 +3239,9 @@ static void RX_init(void)
 
     // Only used for counting at the lowest level.
     vtss_mutex_init(&RX_low_level_mutex);
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+    vtss_cond_init(&RX_ring.released, &RX_low_level_mutex);
+#endif /* VTSS_SW_OPTION_PACKET_RX_ZERO_COPY */
 
     // Critical region protecting the packet subscription filter list.
     critd_init(&RX_filter_crit, "packet_rx_filter", VTSS_MODULE_ID_PACKET, CRITD_TYPE_MUTEX);
@@ -3363,10 +3982,151 @@ static void RX_shaping_init(void)
     (void)packet_rx_shaping_cfg_set(rate_kbps);
 }
 
+/******************************************************************************/
+// TX_batch_flush()
+// Sends all messages queued on #batch and frees the frames afterwards.
+// Only messages that sendmmsg() actually sent are counted.
+/******************************************************************************/
+static mesa_rc TX_batch_flush(packet_tx_batch_t *batch)
+{
+    packet_module_counters_t *cntrs;
+    u32                      sent = 0, i;
+    int                      res;
+    mesa_rc                  rc = VTSS_RC_OK;
+
+    while (sent < batch->msg_cnt) {
+        // sendmmsg() returns the number of messages sent before an error
+        // occurred, so only fail if not even one message could be sent.
+        if ((res = sendmmsg(ifh_sock, &batch->msgs[sent], batch->msg_cnt - sent, 0)) <= 0) {
+            T_E("IFH xmit: Unable to send %u frames. Error = %s", batch->msg_cnt - sent, strerror(errno));
+            rc = VTSS_RC_ERROR;
+            break;
+        }
+
+        batch->syscalls++;
+        sent += res;
+    }
+
+    T_DG(TRACE_GRP_TX, "IFH xmit: %u of %u frames sent OK", sent, batch->msg_cnt);
+
+    PACKET_CX_COUNTER_CRIT_ENTER();
+    for (i = 0; i < sent; i++) {
+        if (batch->msg_frm_idx[i] == batch->last_counted_frm_idx) {
+            continue;
+        }
+
+        batch->last_counted_frm_idx = batch->msg_frm_idx[i];
+        cntrs = &CX_module_counters[batch->msg_modid[i]];
+        CX_port_counters.tx_pkts[batch->msg_cntr_idx[i]]++;
+        cntrs->tx_bytes += batch->msg_len[i];
+        cntrs->tx_pkts++;
+        cntrs->tx_batch_pkts++;
+    }
+    PACKET_CX_COUNTER_CRIT_EXIT();
+
+    for (i = sent; i < batch->msg_cnt; i++) {
+        batch->errors++;
+        if (batch->rcs) {
+            batch->rcs[batch->msg_frm_idx[i]] = VTSS_RC_ERROR;
+        }
+    }
+
+    for (i = 0; i < batch->free_cnt; i++) {
+        packet_tx_free(batch->free_frms[i]);
+    }
+
+    batch->msg_cnt  = 0;
+    batch->free_cnt = 0;
+    return rc;
+}
+
+/******************************************************************************/
+// TX_ifh_encode()
+// Encodes the IFH for #tx_info into #ifh or takes it from #ctx's IFH cache if
+// the cache holds the IFH for the very same #tx_info.
+/******************************************************************************/
+static mesa_rc TX_ifh_encode(const mesa_packet_tx_info_t *tx_info, packet_tx_ctx_t *ctx, u8 *ifh, u32 *ifh_len)
+{
+    packet_tx_ifh_cache_t *cache = ctx->ifh_cache;
+    mesa_rc               rc;
+
+    if (cache && cache->len && cache->len <= *ifh_len && memcmp(&cache->tx_info, tx_info, sizeof(*tx_info)) == 0) {
+        memcpy(ifh, cache->ifh, cache->len);
+        *ifh_len = cache->len;
+        ctx->ifh_cache_hits++;
+        return VTSS_RC_OK;
+    }
+
+    if ((rc = mesa_packet_tx_hdr_encode(NULL, tx_info, *ifh_len, ifh, ifh_len)) != VTSS_RC_OK) {
+        T_EG(TRACE_GRP_TX, "mesa_packet_tx_hdr_encode() failed");
+        return rc;
+    }
+
+    if (cache) {
+        cache->tx_info = *tx_info;
+        cache->len     = *ifh_len;
+        memcpy(cache->ifh, ifh, *ifh_len);
+    }
+
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// TX_batch_add()
+// Queues one frame on #ctx's batch.
+/******************************************************************************/
+static mesa_rc TX_batch_add(const mesa_packet_tx_info_t *tx_info, u8 *frm_ptr, u32 frm_len, packet_tx_ctx_t *ctx)
+{
+    packet_tx_batch_t *batch = ctx->batch;
+    u32               ifh_len = MESA_PACKET_HDR_SIZE_BYTES;
+    u32               m;
+    struct msghdr     *hdr;
+    struct iovec      *iov;
+    mesa_rc           rc;
+
+    if (batch->msg_cnt == ARRSZ(batch->msgs)) {
+        // Errors are reported per frame through batch->rcs.
+        (void)TX_batch_flush(batch);
+    }
+
+    m = batch->msg_cnt;
+    if ((rc = TX_ifh_encode(tx_info, ctx, batch->ifh[m], &ifh_len)) != VTSS_RC_OK) {
+        return rc;
+    }
+
+    T_DG(TRACE_GRP_TX, "%u bytes IFH", ifh_len);
+    T_DG_HEX(TRACE_GRP_TX, batch->ifh[m], ifh_len);
+
+    T_NG(TRACE_GRP_TX, "%u bytes frame (w/o IFH and w/o FCS)", frm_len);
+    T_NG_HEX(TRACE_GRP_TX, frm_ptr, MIN(96, frm_len));
+
+    iov = batch->iov[m];
+    iov[0].iov_base = npi_encap;
+    iov[0].iov_len  = sizeof(npi_encap);
+    iov[1].iov_base = batch->ifh[m];
+    iov[1].iov_len  = ifh_len;
+    iov[2].iov_base = frm_ptr;
+    iov[2].iov_len  = frm_len;
+
+    hdr = &batch->msgs[m].msg_hdr;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->msg_name    = &npi_socket_address;
+    hdr->msg_namelen = sizeof(npi_socket_address);
+    hdr->msg_iov     = iov;
+    hdr->msg_iovlen  = ARRSZ(batch->iov[m]);
+
+    batch->msg_frm_idx[m]  = ctx->frm_idx;
+    batch->msg_cntr_idx[m] = ctx->cntr_idx;
+    batch->msg_len[m]      = ctx->len;
+    batch->msg_modid[m]    = ctx->modid;
+    batch->msg_cnt++;
+    return VTSS_RC_OK;
+}
+
 /******************************************************************************/
 // TX_npi_do()
 /******************************************************************************/
-static mesa_rc TX_npi_do(const mesa_packet_tx_info_t *tx_info, u8 *frm_ptr, u32 frm_len)
+static mesa_rc TX_npi_do(const mesa_packet_tx_info_t *tx_info, u8 *frm_ptr, u32 frm_len, packet_tx_ctx_t *ctx)
 {
     u8            ifh[MESA_PACKET_HDR_SIZE_BYTES];
     u32           ifh_len = sizeof(ifh);
@@ -3379,8 +4139,11 @@ static mesa_rc TX_npi_do(const mesa_packet_tx_info_t *tx_info, u8 *frm_ptr, u32
     }
 
     if (CX_internal_cpu) {
-        if ((rc = mesa_packet_tx_hdr_encode(NULL, tx_info, ifh_len, (u8 *)ifh, &ifh_len)) != VTSS_RC_OK) {
-            T_EG(TRACE_GRP_TX, "mesa_packet_tx_hdr_encode() failed");
+        if (ctx->batch) {
+            return TX_batch_add(tx_info, frm_ptr, frm_len, ctx);
+        }
+
+        if ((rc = TX_ifh_encode(tx_info, ctx, ifh, &ifh_len)) != VTSS_RC_OK) {
             return rc;
         }
 
@@ -3463,7 +4226,7 @@ static const packet_tx_props_t *TX_props_modify_for_redbox(const uint8_t *frm_pt
 // TX_npi()
 // Store tx_props in Tx pending fifo.
 /******************************************************************************/
-static mesa_rc TX_npi(const packet_tx_props_t *tx_props)
+static mesa_rc TX_npi(const packet_tx_props_t *tx_props, packet_tx_ctx_t *ctx)
 {
     mesa_rc                     rc = VTSS_RC_OK;
     u8                          *frm_ptr;
@@ -3474,12 +4237,19 @@ static mesa_rc TX_npi(const packet_tx_props_t *tx_props)
     const mesa_packet_tx_info_t *tx_info;
     packet_tx_props_t           alternative_tx_props;
     const packet_tx_props_t     *resulting_tx_props;
+    packet_tx_ctx_t             ctx_local;
 
     if (ifh_sock < 0) {
         T_EG(TRACE_GRP_TX, "IFH Tx: No IFH interface open");
         return VTSS_RC_ERROR;
     }
 
+    if (ctx->batch && ctx->batch->free_cnt == ARRSZ(ctx->batch->free_frms)) {
+        // Make room for this frame. Errors are reported per frame through
+        // batch->rcs.
+        (void)TX_batch_flush(ctx->batch);
+    }
+
     frm_ptr = tx_props->packet_info.frm;
     frm_len = tx_props->packet_info.len;
 
@@ -3552,26 +4322,34 @@ static mesa_rc TX_npi(const packet_tx_props_t *tx_props)
     if (TX_ifh_has_dst_port_mask || tx_info->dst_port_mask == 0) {
         // This chip supports the dst_port_mask field or the destination port
         // mask is empty (frame is switched). Nothing more to do.
-        rc = TX_npi_do(tx_info, frm_ptr, frm_len);
+        rc = TX_npi_do(tx_info, frm_ptr, frm_len, ctx);
     } else {
         // This chip doesn't support the dst_port_mask field. Go through all
-        // bits and send the frame one by one.
+        // bits and send the frame one by one. The IFH differs per port, so
+        // don't let it thrash the user's IFH cache.
         tx_info_local = *tx_info;
         tx_info_local.dst_port_mask = 0;
+        ctx_local = *ctx;
+        ctx_local.ifh_cache = NULL;
         for (dst_port = 0; dst_port < CX_port_cnt; dst_port++) {
             if (!(tx_info->dst_port_mask & VTSS_BIT64(dst_port))) {
                 continue;
             }
 
             tx_info_local.dst_port = dst_port;
-            if ((rc = TX_npi_do(&tx_info_local, frm_ptr, frm_len)) != VTSS_RC_OK) {
+            if ((rc = TX_npi_do(&tx_info_local, frm_ptr, frm_len, &ctx_local)) != VTSS_RC_OK) {
                 break;
             }
         }
     }
 
     if (!resulting_tx_props->packet_info.no_free) {
-        packet_tx_free(resulting_tx_props->packet_info.frm);
+        if (ctx->batch) {
+            // Gotta wait until the frame has been sent.
+            ctx->batch->free_frms[ctx->batch->free_cnt++] = resulting_tx_props->packet_info.frm;
+        } else {
+            packet_tx_free(resulting_tx_props->packet_info.frm);
+        }
     }
 
     return rc;
@@ -3911,14 +4689,17 @@ void packet_tx_props_init(packet_tx_props_t *tx_props)
 }
 
 /******************************************************************************/
-// packet_tx()
+// TX_do()
+// Does the work for packet_tx() and packet_tx_batch(). #batch is NULL when
+// called from packet_tx().
 /******************************************************************************/
-mesa_rc packet_tx(packet_tx_props_t *tx_props)
+static mesa_rc TX_do(packet_tx_props_t *tx_props, packet_tx_batch_t *batch, u32 frm_idx)
 {
-    mesa_rc        rc;
-    mesa_etype_t   saved_tpid;
-    u32            port_cnt = 0;
-    mesa_port_no_t port_no  = VTSS_PORT_NO_NONE;
+    mesa_rc         rc;
+    mesa_etype_t    saved_tpid;
+    u32             port_cnt = 0;
+    mesa_port_no_t  port_no  = VTSS_PORT_NO_NONE;
+    packet_tx_ctx_t ctx;
 
     // Sanity checks:
 
@@ -4026,14 +4807,29 @@ mesa_rc packet_tx(packet_tx_props_t *tx_props)
              vtss_module_names[tx_props->packet_info.modid]);
     }
 
-    rc = TX_npi(tx_props);
+    ctx.ifh_cache      = tx_props->packet_info.ifh_cache;
+    ctx.batch          = batch;
+    ctx.frm_idx        = frm_idx;
+    ctx.cntr_idx       = tx_props->tx_info.switch_frm ? CX_port_cnt : port_cnt > 1 ? CX_port_cnt + 1 : port_no;
+    ctx.len            = tx_props->packet_info.len;
+    ctx.modid          = tx_props->packet_info.modid;
+    ctx.ifh_cache_hits = 0;
 
-    if (rc == VTSS_RC_OK) {
-        packet_module_counters_t *cntrs = &CX_module_counters[tx_props->packet_info.modid];
+    rc = TX_npi(tx_props, &ctx);
 
+    if (ctx.ifh_cache_hits) {
         PACKET_CX_COUNTER_CRIT_ENTER();
-        CX_port_counters.tx_pkts[tx_props->tx_info.switch_frm ? CX_port_cnt : port_cnt > 1 ? CX_port_cnt + 1 : port_no]++;
-        cntrs->tx_bytes += tx_props->packet_info.len;
+        CX_module_counters[ctx.modid].tx_ifh_cache_hits += ctx.ifh_cache_hits;
+        PACKET_CX_COUNTER_CRIT_EXIT();
+    }
+
+    // Batched frames are counted by TX_batch_flush() once they are sent.
+    if (rc == VTSS_RC_OK && !batch) {
+        packet_module_counters_t *cntrs = &CX_module_counters[ctx.modid];
+
+        PACKET_CX_COUNTER_CRIT_ENTER();
+        CX_port_counters.tx_pkts[ctx.cntr_idx]++;
+        cntrs->tx_bytes += ctx.len;
         cntrs->tx_pkts++;
         PACKET_CX_COUNTER_CRIT_EXIT();
     }
@@ -4043,6 +4839,151 @@ mesa_rc packet_tx(packet_tx_props_t *tx_props)
     return rc;
 }
 
+/******************************************************************************/
+// packet_tx()
+/******************************************************************************/
+mesa_rc packet_tx(packet_tx_props_t *tx_props)
+{
+    return TX_do(tx_props, NULL, 0);
+}
+
+/******************************************************************************/
+// packet_tx_batch()
+/******************************************************************************/
+mesa_rc packet_tx_batch(packet_tx_props_t *tx_props, u32 cnt, mesa_rc *rcs)
+{
+    packet_tx_batch_t        *batch = NULL;
+    packet_module_counters_t *cntrs;
+    mesa_rc                  rc = VTSS_RC_OK, frm_rc;
+    u32                      i, syscalls = 0, errors = 0;
+
+    PACKET_TX_CHECK(tx_props != NULL && cnt > 0);
+    PACKET_TX_CHECK(tx_props[0].packet_info.modid <= VTSS_MODULE_ID_NONE);
+
+    // Only frames injected through the IFH socket can be batched. With an
+    // external CPU, frames go through mesa_packet_tx_frame() one by one.
+    if (CX_internal_cpu && ifh_sock >= 0 && cnt > 1) {
+        if ((batch = (packet_tx_batch_t *)VTSS_MALLOC(sizeof(*batch))) != NULL) {
+            batch->msg_cnt              = 0;
+            batch->last_counted_frm_idx = 0xFFFFFFFF;
+            batch->free_cnt             = 0;
+            batch->rcs      = rcs;
+            batch->syscalls = 0;
+            batch->errors   = 0;
+        } else {
+            T_WG(TRACE_GRP_TX, "Out of memory. Transmitting frames one by one");
+        }
+    }
+
+    for (i = 0; i < cnt; i++) {
+        if (rcs) {
+            rcs[i] = VTSS_RC_OK;
+        }
+
+        if ((frm_rc = TX_do(&tx_props[i], batch, i)) != VTSS_RC_OK) {
+            if (rcs) {
+                rcs[i] = frm_rc;
+            }
+
+            if (rc == VTSS_RC_OK) {
+                rc = frm_rc;
+            }
+        }
+    }
+
+    if (batch) {
+        (void)TX_batch_flush(batch);
+        syscalls = batch->syscalls;
+        errors   = batch->errors;
+        VTSS_FREE(batch);
+
+        if (errors && rc == VTSS_RC_OK) {
+            rc = VTSS_RC_ERROR;
+        }
+    }
+
+    cntrs = &CX_module_counters[tx_props[0].packet_info.modid];
+    PACKET_CX_COUNTER_CRIT_ENTER();
+    cntrs->tx_batch_calls++;
+    cntrs->tx_batch_syscalls += syscalls;
+    cntrs->tx_batch_errors   += errors;
+    PACKET_CX_COUNTER_CRIT_EXIT();
+
+    return rc;
+}
+
+/******************************************************************************/
+// TX_buf_alloc()
+// Returns a buffer of at least #size bytes from the Tx pool.
+/******************************************************************************/
+static u8 *TX_buf_alloc(size_t size)
+{
+    tx_pool_hdr_t *hdr = NULL;
+    u32           c;
+
+    for (c = 0; c < TX_POOL_CLASS_CNT; c++) {
+        if (size <= TX_pool_class_sizes[c]) {
+            break;
+        }
+    }
+
+    PACKET_CX_COUNTER_CRIT_ENTER();
+    if (c < TX_POOL_CLASS_CNT && (hdr = TX_pool[c].free_list) != NULL) {
+        TX_pool[c].free_list = hdr->next;
+        TX_pool[c].free_cnt--;
+        TX_pool[c].hits++;
+        TX_alloc_calls++;
+    }
+    PACKET_CX_COUNTER_CRIT_EXIT();
+
+    if (!hdr) {
+        if ((hdr = (tx_pool_hdr_t *)VTSS_MALLOC(TX_POOL_HDR_SIZE + (c < TX_POOL_CLASS_CNT ? TX_pool_class_sizes[c] : size))) == NULL) {
+            return NULL;
+        }
+
+        hdr->size_class = c;
+
+        PACKET_CX_COUNTER_CRIT_ENTER();
+        TX_pool[c].misses++;
+        TX_alloc_calls++;
+        PACKET_CX_COUNTER_CRIT_EXIT();
+    }
+
+    hdr->magic = TX_POOL_MAGIC;
+    return (u8 *)hdr + TX_POOL_HDR_SIZE;
+}
+
+/******************************************************************************/
+// TX_buf_free()
+// Counterpart to TX_buf_alloc().
+/******************************************************************************/
+static void TX_buf_free(u8 *buffer)
+{
+    tx_pool_hdr_t *hdr = (tx_pool_hdr_t *)(buffer - TX_POOL_HDR_SIZE);
+    u32           c;
+
+    // Also catches double frees.
+    PACKET_CHECK(hdr->magic == TX_POOL_MAGIC, return;);
+    hdr->magic = 0;
+    c = hdr->size_class;
+
+    PACKET_CX_COUNTER_CRIT_ENTER();
+    TX_free_calls++;
+    if (c < TX_POOL_CLASS_CNT && TX_pool[c].free_cnt < TX_POOL_FREE_MAX) {
+        hdr->next = TX_pool[c].free_list;
+        TX_pool[c].free_list = hdr;
+        TX_pool[c].free_cnt++;
+        hdr = NULL;
+    } else {
+        TX_pool[c].releases++;
+    }
+    PACKET_CX_COUNTER_CRIT_EXIT();
+
+    if (hdr) {
+        VTSS_FREE(hdr);
+    }
+}
+
 /******************************************************************************/
 // packet_tx_alloc()
 // Size argument should not include IFH and FCS
@@ -4053,11 +4994,8 @@ u8 *packet_tx_alloc(size_t size)
 
     size = MAX(60, size) /* minimum-sized Ethernet frame excl. FCS */ + 4 /* possible VLAN tag */;
 
-    if ((buffer = (u8 *)VTSS_MALLOC(size))) {
+    if ((buffer = TX_buf_alloc(size))) {
         buffer += 4; /* possible VLAN tag added during TX_npi() */
-        PACKET_CX_COUNTER_CRIT_ENTER();
-        TX_alloc_calls++;
-        PACKET_CX_COUNTER_CRIT_EXIT();
     }
 
     return buffer;
@@ -4088,12 +5026,9 @@ u8 *packet_tx_alloc_extra(size_t size, size_t extra_size_dwords, u8 **extra_ptr)
     PACKET_CHECK(extra_ptr, return NULL;);
     size = MAX(60, size) /* minimum-sized Ethernet frame excl. FCS */ + 4 /* possible VLAN tag */;
 
-    if ((buffer = (u8 *)VTSS_MALLOC(size + extra_size_bytes))) {
+    if ((buffer = TX_buf_alloc(size + extra_size_bytes))) {
         *extra_ptr = buffer;
         buffer    += extra_size_bytes + 4 /* possible VLAN tag */;
-        PACKET_CX_COUNTER_CRIT_ENTER();
-        TX_alloc_calls++;
-        PACKET_CX_COUNTER_CRIT_EXIT();
     }
 
     return buffer;
@@ -4106,10 +5041,7 @@ void packet_tx_free(u8 *buffer)
 {
     PACKET_CHECK(buffer != NULL, return;);
     buffer -= 4 /* possible VLAN tag */;
-    VTSS_FREE(buffer);
-    PACKET_CX_COUNTER_CRIT_ENTER();
-    TX_free_calls++;
-    PACKET_CX_COUNTER_CRIT_EXIT();
+    TX_buf_free(buffer);
 }
 
 /******************************************************************************/
@@ -4121,10 +5053,7 @@ void packet_tx_free(u8 *buffer)
 void packet_tx_free_extra(u8 *extra_ptr)
 {
     PACKET_CHECK(extra_ptr != NULL, return;);
-    VTSS_FREE(extra_ptr);
-    PACKET_CX_COUNTER_CRIT_ENTER();
-    TX_free_calls++;
-    PACKET_CX_COUNTER_CRIT_EXIT();
+    TX_buf_free(extra_ptr);
 }
 
 /******************************************************************************/
@@ -4441,11 +5370,15 @@ typedef enum {
     PACKET_DBG_CMD_SUBSCRIBERS_PRINT,
     PACKET_DBG_CMD_STAT_THREAD_PRINT,
     PACKET_DBG_CMD_STAT_RX_QU_PRINT,
+    PACKET_DBG_CMD_STAT_RX_RING_PRINT,
+    PACKET_DBG_CMD_STAT_TX_PRINT,
     PACKET_DBG_CMD_STAT_PACKET_CLEAR       = 10,
     PACKET_DBG_CMD_STAT_FDMA_CLEAR,
     PACKET_DBG_CMD_STAT_PORT_CLEAR,
     PACKET_DBG_CMD_STAT_THREAD_CLEAR,
     PACKET_DBG_CMD_STAT_RX_QU_CLEAR,
+    PACKET_DBG_CMD_STAT_RX_RING_CLEAR,
+    PACKET_DBG_CMD_STAT_TX_CLEAR,
     PACKET_DBG_CMD_STAT_ALL_CLEAR          = 19,
     PACKET_DBG_CMD_CFG_STACK_TRACE         = 20,
     PACKET_DBG_CMD_CFG_SIGNAL_TX_PEND_COND = 22,
@@ -4507,6 +5440,22 @@ static const packet_dbg_cmd_t packet_dbg_cmds[] = {
         0,
         DBG_cmd_stat_rx_qu_print
     },
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+    {
+        PACKET_DBG_CMD_STAT_RX_RING_PRINT,
+        "Print Rx ring statistics",
+        NULL,
+        0,
+        DBG_cmd_stat_rx_ring_print
+    },
+#endif
+    {
+        PACKET_DBG_CMD_STAT_TX_PRINT,
+        "Print Tx buffer pool and batch statistics",
+        NULL,
+        0,
+        DBG_cmd_stat_tx_print
+    },
     {
         PACKET_DBG_CMD_STAT_PACKET_CLEAR,
         "Clear per-module statistics",
@@ -4535,6 +5484,22 @@ static const packet_dbg_cmd_t packet_dbg_cmds[] = {
         0,
         DBG_cmd_stat_rx_qu_clear
     },
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+    {
+        PACKET_DBG_CMD_STAT_RX_RING_CLEAR,
+        "Clear Rx ring statistics",
+        NULL,
+        0,
+        DBG_cmd_stat_rx_ring_clear
+    },
+#endif
+    {
+        PACKET_DBG_CMD_STAT_TX_CLEAR,
+        "Clear Tx buffer pool and batch statistics",
+        NULL,
+        0,
+        DBG_cmd_stat_tx_clear
+    },
     {
         PACKET_DBG_CMD_STAT_ALL_CLEAR,
         "Clear all statistics (including uFDMA if applicable)",
@@ -4901,6 +5866,16 @@ mesa_rc packet_init(vtss_init_data_t *data)
         // once we open vtss.ifh. See also CX_socket_rcvbuf_set().
         system("sysctl -w net.core.rmem_max=20000000 > /dev/null");
 
+#if defined(VTSS_SW_OPTION_PACKET_RX_ZERO_COPY)
+        {
+            // Rx ring is only applicable on the internal CPU.
+            auto &c = vtss::appl::main::module_conf_get("packet");
+            RX_ring.ena        = CX_internal_cpu && c.bool_get("rx_ring", true);
+            RX_ring.block_size = c.u32_get("rx_ring_block_size", RX_RING_BLOCK_SIZE_DEFAULT);
+            RX_ring.block_cnt  = c.u32_get("rx_ring_block_cnt",  RX_RING_BLOCK_CNT_DEFAULT);
+        }
+#endif
+
         // Initialize injection part
         TX_init();
 
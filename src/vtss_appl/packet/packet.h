@@ -79,6 +79,11 @@ typedef struct tag_packet_module_counters {
     u32              tx_pkts;
     u64              tx_bytes;
     vtss_tick_count_t longest_rx_callback_ticks;
+    u32              tx_batch_calls;    // Number of calls to packet_tx_batch()
+    u32              tx_batch_pkts;     // Number of frames transmitted with packet_tx_batch()
+    u32              tx_batch_syscalls; // Number of sendmmsg() calls issued by packet_tx_batch()
+    u32              tx_batch_errors;   // Number of frames that sendmmsg() failed to send
+    u32              tx_ifh_cache_hits; // Number of IFHs taken from a packet_tx_ifh_cache_t rather than encoded
 } packet_module_counters_t;
 
 #define BITMASK(x) ((1U << (x)) - 1U)
@@ -421,6 +421,30 @@ typedef struct {
 
 } packet_tx_filter_t;
 
+/**
+ * \brief Packet Tx IFH cache
+ *
+ * Holds the injection header last encoded for a given packet_tx_props_t.
+ * Storage is provided by the user (see packet_tx_info_t::ifh_cache), but the
+ * contents are internal to the packet module. Initialize with memset() to 0.
+ */
+typedef struct {
+    /**
+     * The Tx info that #ifh was encoded from.
+     */
+    mesa_packet_tx_info_t tx_info;
+
+    /**
+     * Number of valid bytes in #ifh. 0 if nothing is cached.
+     */
+    u32 len;
+
+    /**
+     * The encoded IFH.
+     */
+    u8 ifh[MESA_PACKET_HDR_SIZE_BYTES];
+} packet_tx_ifh_cache_t;
+
 /**
  * \brief Packet Tx Info
  */
@@ -485,6 +509,17 @@ typedef struct {
      */
     packet_tx_filter_t filter;
 
+    /**
+     * Set to non-NULL if the same tx_info is used for many transmissions
+     * (e.g. periodic PDUs on a given port). The packet module then caches the
+     * encoded injection header in *ifh_cache and reuses it as long as
+     * tx_info is unchanged, so that it doesn't have to be encoded for every
+     * frame.
+     * The cache is owned by the caller and must outlive the call. It must not
+     * be used by two transmissions at the same time.
+     */
+    packet_tx_ifh_cache_t *ifh_cache;
+
     /**
      * Internal flags. Don't use.
      */
@@ -535,6 +570,30 @@ void packet_tx_props_init(packet_tx_props_t *tx_props);
  */
 mesa_rc packet_tx(packet_tx_props_t *tx_props);
 
+/**
+ * \brief Transmit a number of frames.
+ *
+ * Works like calling packet_tx() on each of the #cnt entries in #tx_props,
+ * but when possible, the frames are handed to the kernel with a few
+ * sendmmsg() calls rather than with one system call per frame.
+ * This is useful for modules that transmit a frame on many ports at a time
+ * (e.g. Loop Protection).
+ *
+ * The frames must not share buffers.
+ *
+ * \param tx_props [IN]  Array of #cnt Tx properties.
+ * \param cnt      [IN]  Number of entries in #tx_props.
+ * \param rcs      [OUT] If not NULL, must point to an array of #cnt entries,
+ *                       which will hold what packet_tx() would have returned
+ *                       for the corresponding frame. Ownership of the frame
+ *                       buffers follows these return codes as for packet_tx().
+ *
+ * \return
+ *    VTSS_RC_OK if all frames were transmitted\n
+ *    The first error encountered otherwise.
+ */
+mesa_rc packet_tx_batch(packet_tx_props_t *tx_props, u32 cnt, mesa_rc *rcs);
+
 /******************************************************************************/
 // Tx buffer alloc & free.
 // Args:
@@ -0,0 +1,334 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#include "packet_rx_classifier.hxx"
+#include <algorithm>
+
+// Frame offsets. Keep in sync with packet.h
+#define CLS_ETYPE_IPV4             0x0800
+#define CLS_IP_PROTO_UDP           17
+#define CLS_DMAC_POS               0
+#define CLS_SMAC_POS               6
+#define CLS_PROT_HDR_POS           14
+#define CLS_IP_VER_POS             (CLS_PROT_HDR_POS)
+#define CLS_IPV4_HLEN_POS          (CLS_PROT_HDR_POS)
+#define CLS_IPV4_PROTO_POS         (CLS_PROT_HDR_POS + 9)
+#define CLS_IPV6_PROTO_POS         (CLS_PROT_HDR_POS + 6)
+#define CLS_UDP_DST_PORT_POS(hlen) (CLS_PROT_HDR_POS + (hlen) + 2)
+
+/******************************************************************************/
+// CLS_mac_get()
+/******************************************************************************/
+static inline uint64_t CLS_mac_get(const uint8_t *p)
+{
+    return ((uint64_t)p[0] << 40) | ((uint64_t)p[1] << 32) | ((uint64_t)p[2] << 24) | ((uint64_t)p[3] << 16) | ((uint64_t)p[4] << 8) | ((uint64_t)p[5] << 0);
+}
+
+/******************************************************************************/
+// packet_rx_classifier_key_get()
+// Must extract the IP protocol and UDP port exactly the way RX_match_next()
+// does it.
+/******************************************************************************/
+bool packet_rx_classifier_key_get(const uint8_t *frm, uint32_t len, uint16_t etype, packet_rx_classifier_key_t *key)
+{
+    uint32_t hlen;
+
+    key->ip_valid     = false;
+    key->ip_proto     = 0;
+    key->udp_dst_port = 0;
+
+    if (len < CLS_PROT_HDR_POS) {
+        return false;
+    }
+
+    key->etype = etype;
+    key->dmac  = CLS_mac_get(&frm[CLS_DMAC_POS]);
+    key->smac  = CLS_mac_get(&frm[CLS_SMAC_POS]);
+
+    if (etype == CLS_ETYPE_IPV4) {
+        if (len <= CLS_IPV4_PROTO_POS) {
+            return true;
+        }
+
+        key->ip_valid = (frm[CLS_IP_VER_POS] & 0xF0) == 0x40;
+        key->ip_proto = frm[CLS_IPV4_PROTO_POS];
+        hlen          = 4 * (frm[CLS_IPV4_HLEN_POS] & 0xF);
+    } else {
+        if (len <= CLS_IPV6_PROTO_POS) {
+            return true;
+        }
+
+        // Only the first Next Header field is looked at.
+        key->ip_valid = (frm[CLS_IP_VER_POS] & 0xF0) == 0x60;
+        key->ip_proto = frm[CLS_IPV6_PROTO_POS];
+        hlen          = 40;
+    }
+
+    if (key->ip_valid && key->ip_proto == CLS_IP_PROTO_UDP) {
+        if (len < CLS_UDP_DST_PORT_POS(hlen) + 2) {
+            // Truncated UDP header
+            key->ip_valid = false;
+            key->ip_proto = 0;
+            return true;
+        }
+
+        key->udp_dst_port = (frm[CLS_UDP_DST_PORT_POS(hlen)] << 8) | frm[CLS_UDP_DST_PORT_POS(hlen) + 1];
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+// PacketRxClassifier::leaf_add()
+/******************************************************************************/
+uint32_t PacketRxClassifier::leaf_add(const std::vector<packet_rx_classifier_rule_t> &rules, const std::vector<uint32_t> &idxs)
+{
+    std::vector<packet_rx_classifier_entry_t> entries;
+
+    // Identical leaves are common (e.g. all IP protocols nobody subscribes
+    // to), so share them.
+    for (uint32_t l = 0; l < leaf_entries.size(); l++) {
+        const std::vector<packet_rx_classifier_entry_t> &e = leaf_entries[l];
+
+        if (e.size() != idxs.size()) {
+            continue;
+        }
+
+        uint32_t i;
+        for (i = 0; i < idxs.size(); i++) {
+            if (e[i].idx != idxs[i]) {
+                break;
+            }
+        }
+
+        if (i == idxs.size()) {
+            return l;
+        }
+    }
+
+    entries.reserve(idxs.size());
+    for (auto idx : idxs) {
+        const packet_rx_classifier_rule_t &r = rules[idx];
+        packet_rx_classifier_entry_t      e;
+
+        e.idx       = idx;
+        e.dmac_mask = r.dmac_ena ? r.dmac_mask : 0;
+        e.dmac      = r.dmac_ena ? r.dmac      : 0;
+        e.smac_mask = r.smac_ena ? r.smac_mask : 0;
+        e.smac      = r.smac_ena ? r.smac      : 0;
+        entries.push_back(e);
+    }
+
+    entry_total += entries.size();
+    leaf_entries.push_back(std::move(entries));
+    return leaf_entries.size() - 1;
+}
+
+/******************************************************************************/
+// PacketRxClassifier::etype_node_build()
+// #idxs contains the filters that may match the EtherType of #node.
+/******************************************************************************/
+void PacketRxClassifier::etype_node_build(const std::vector<packet_rx_classifier_rule_t> &rules, const std::vector<uint32_t> &idxs, etype_node_t &node)
+{
+    std::vector<uint32_t> ip_invalid, proto_other, protos, l;
+
+    // Stage two: IP protocol.
+    for (auto idx : idxs) {
+        const packet_rx_classifier_rule_t &r = rules[idx];
+
+        if (!r.ip_proto_ena) {
+            // Doesn't care about the IP protocol.
+            ip_invalid.push_back(idx);
+            proto_other.push_back(idx);
+        } else if (r.ip_proto_mask != 0xFF) {
+            // Wildcarded IP protocol. Only requires a valid IP header.
+            proto_other.push_back(idx);
+        } else if (std::find(protos.begin(), protos.end(), r.ip_proto) == protos.end()) {
+            protos.push_back(r.ip_proto);
+        }
+    }
+
+    std::sort(protos.begin(), protos.end());
+    node.ip_invalid_leaf  = leaf_add(rules, ip_invalid);
+    node.proto_other_leaf = leaf_add(rules, proto_other);
+
+    for (auto proto : protos) {
+        proto_node_t          pn;
+        std::vector<uint32_t> bounds;
+
+        pn.ip_proto = proto;
+        l.clear();
+        for (auto idx : idxs) {
+            const packet_rx_classifier_rule_t &r = rules[idx];
+
+            if (!r.ip_proto_ena || r.ip_proto_mask != 0xFF || r.ip_proto == proto) {
+                l.push_back(idx);
+
+                if (proto == CLS_IP_PROTO_UDP && r.ip_proto_ena && r.udp_dst_port_ena) {
+                    bounds.push_back(r.udp_dst_port_min);
+                    bounds.push_back((uint32_t)r.udp_dst_port_max + 1);
+                }
+            }
+        }
+
+        pn.leaf = leaf_add(rules, l);
+
+        if (!bounds.empty()) {
+            // Stage three: Split the UDP destination port space into segments
+            // in which the set of matching port ranges is constant.
+            bounds.push_back(0);
+            std::sort(bounds.begin(), bounds.end());
+            bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+            for (auto b : bounds) {
+                port_seg_t seg;
+
+                if (b > 0xFFFF) {
+                    break;
+                }
+
+                seg.port_min = b;
+                l.clear();
+                for (auto idx : idxs) {
+                    const packet_rx_classifier_rule_t &r = rules[idx];
+
+                    if (!r.ip_proto_ena || r.ip_proto_mask != 0xFF || r.ip_proto == proto) {
+                        if (r.ip_proto_ena && r.udp_dst_port_ena && (b < r.udp_dst_port_min || b > r.udp_dst_port_max)) {
+                            continue;
+                        }
+
+                        l.push_back(idx);
+                    }
+                }
+
+                seg.leaf = leaf_add(rules, l);
+                pn.segs.push_back(seg);
+            }
+        }
+
+        node.protos.push_back(std::move(pn));
+    }
+}
+
+/******************************************************************************/
+// PacketRxClassifier::PacketRxClassifier()
+/******************************************************************************/
+PacketRxClassifier::PacketRxClassifier(const std::vector<packet_rx_classifier_rule_t> &rules)
+{
+    std::vector<uint16_t> keyed;
+    std::vector<uint32_t> idxs;
+    uint32_t              idx;
+
+    // Stage one: EtherType. Only filters matching all bits of the EtherType
+    // are keyed. All others must be considered for all EtherTypes.
+    for (idx = 0; idx < rules.size(); idx++) {
+        const packet_rx_classifier_rule_t &r = rules[idx];
+
+        if (!r.skip && r.etype_ena && r.etype_mask == 0xFFFF && std::find(keyed.begin(), keyed.end(), r.etype) == keyed.end()) {
+            keyed.push_back(r.etype);
+        }
+    }
+
+    std::sort(keyed.begin(), keyed.end());
+
+    for (auto etype : keyed) {
+        etype_node_t node;
+
+        node.etype = etype;
+        idxs.clear();
+        for (idx = 0; idx < rules.size(); idx++) {
+            const packet_rx_classifier_rule_t &r = rules[idx];
+
+            if (!r.skip && (!r.etype_ena || r.etype_mask != 0xFFFF || r.etype == etype)) {
+                idxs.push_back(idx);
+            }
+        }
+
+        etype_node_build(rules, idxs, node);
+        etypes.push_back(std::move(node));
+    }
+
+    idxs.clear();
+    for (idx = 0; idx < rules.size(); idx++) {
+        const packet_rx_classifier_rule_t &r = rules[idx];
+
+        if (!r.skip && (!r.etype_ena || r.etype_mask != 0xFFFF)) {
+            idxs.push_back(idx);
+        }
+    }
+
+    etype_other.etype = 0;
+    etype_node_build(rules, idxs, etype_other);
+
+    // Now that leaf_entries will no longer change, create the leaves.
+    for (auto &e : leaf_entries) {
+        packet_rx_classifier_leaf_t leaf;
+
+        leaf.cnt     = e.size();
+        leaf.entries = e.data();
+        leaves.push_back(leaf);
+    }
+}
+
+/******************************************************************************/
+// PacketRxClassifier::lookup()
+/******************************************************************************/
+const packet_rx_classifier_leaf_t *PacketRxClassifier::lookup(const packet_rx_classifier_key_t *key) const
+{
+    const etype_node_t *node = &etype_other;
+
+    auto e = std::lower_bound(etypes.begin(), etypes.end(), key->etype, [](const etype_node_t &n, uint16_t etype) {
+        return n.etype < etype;
+    });
+
+    if (e != etypes.end() && e->etype == key->etype) {
+        node = &*e;
+    }
+
+    if (!key->ip_valid) {
+        return &leaves[node->ip_invalid_leaf];
+    }
+
+    auto p = std::lower_bound(node->protos.begin(), node->protos.end(), key->ip_proto, [](const proto_node_t &n, uint8_t proto) {
+        return n.ip_proto < proto;
+    });
+
+    if (p == node->protos.end() || p->ip_proto != key->ip_proto) {
+        return &leaves[node->proto_other_leaf];
+    }
+
+    if (p->segs.empty()) {
+        return &leaves[p->leaf];
+    }
+
+    // Find the last segment starting at or before the port.
+    auto s = std::upper_bound(p->segs.begin(), p->segs.end(), key->udp_dst_port, [](uint16_t port, const port_seg_t &seg) {
+        return port < seg.port_min;
+    });
+
+    // The first segment always starts at port 0, so s can't be begin().
+    return &leaves[(s - 1)->leaf];
+}
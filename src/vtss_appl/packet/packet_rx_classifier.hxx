@@ -0,0 +1,166 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#ifndef _PACKET_RX_CLASSIFIER_HXX_
+#define _PACKET_RX_CLASSIFIER_HXX_
+
+// Pre-classification of received frames against the packet Rx filter list.
+//
+// The filter list is compiled into a three-stage dispatch structure whenever
+// it changes:
+//   1) EtherType (exact match filters get their own node, all others are
+//      present in all nodes),
+//   2) IP protocol (as found by the same rules as RX_match_next() uses), and
+//   3) UDP destination port range (only below the UDP protocol node).
+// Each leaf holds - in filter list order - the indices of the filters that
+// may match a frame with that key, together with their DMAC and SMAC matches
+// compiled into 48-bit masked compares.
+// A leaf is a superset of the filters that match, so the caller must still
+// check the fields that the classifier doesn't key on.
+
+#include <stdint.h>
+#include <vector>
+
+// One rule per filter in the packet Rx filter list and in the same order.
+// All masks are in the internal polarity, that is, bits set are matched
+// against.
+typedef struct {
+    // When true, the rule is never a candidate (e.g. default subscribers,
+    // which are handled separately).
+    bool skip;
+
+    bool     etype_ena;
+    uint16_t etype;
+    uint16_t etype_mask;
+
+    bool     ip_proto_ena;
+    uint8_t  ip_proto;
+    uint8_t  ip_proto_mask;
+
+    bool     udp_dst_port_ena;
+    uint16_t udp_dst_port_min;
+    uint16_t udp_dst_port_max;
+
+    bool     dmac_ena;
+    uint64_t dmac;
+    uint64_t dmac_mask;
+
+    bool     smac_ena;
+    uint64_t smac;
+    uint64_t smac_mask;
+} packet_rx_classifier_rule_t;
+
+// Frame fields the classifier keys on. Use packet_rx_classifier_key_get() to
+// fill it in.
+typedef struct {
+    uint16_t etype;
+
+    // True when the frame's IP version field matches the EtherType (IPv4) or
+    // when it looks like IPv6 (all other EtherTypes).
+    bool     ip_valid;
+    uint8_t  ip_proto;
+
+    // Only valid when ip_valid is true and ip_proto is UDP.
+    uint16_t udp_dst_port;
+
+    uint64_t dmac;
+    uint64_t smac;
+} packet_rx_classifier_key_t;
+
+typedef struct {
+    uint32_t idx; // Index into the filter list
+    uint64_t dmac;
+    uint64_t dmac_mask;
+    uint64_t smac;
+    uint64_t smac_mask;
+} packet_rx_classifier_entry_t;
+
+typedef struct {
+    uint32_t                           cnt;
+    const packet_rx_classifier_entry_t *entries;
+} packet_rx_classifier_leaf_t;
+
+// Fills in #key from #frm, which points to the DMAC of the frame (after a
+// possible stripped VLAN tag) and holds #len bytes, and the frame's #etype.
+// Returns false if the frame is too short to even hold the MACs and the
+// EtherType, in which case #key must not be used.
+// IP protocol and UDP port are only used if the frame is long enough to hold
+// them. Otherwise, the frame is classified as non-IP.
+bool packet_rx_classifier_key_get(const uint8_t *frm, uint32_t len, uint16_t etype, packet_rx_classifier_key_t *key);
+
+// Returns true if the masked MACs of #entry match #key.
+static inline bool packet_rx_classifier_mac_match(const packet_rx_classifier_entry_t *entry, const packet_rx_classifier_key_t *key)
+{
+    return (key->dmac & entry->dmac_mask) == entry->dmac && (key->smac & entry->smac_mask) == entry->smac;
+}
+
+struct PacketRxClassifier {
+    explicit PacketRxClassifier(const std::vector<packet_rx_classifier_rule_t> &rules);
+
+    // Returns the leaf with candidate filters for #key. Never NULL.
+    const packet_rx_classifier_leaf_t *lookup(const packet_rx_classifier_key_t *key) const;
+
+    // Statistics for debug purposes
+    uint32_t leaf_cnt() const
+    {
+        return leaves.size();
+    }
+
+    uint32_t entry_cnt() const
+    {
+        return entry_total;
+    }
+
+private:
+    typedef struct {
+        uint16_t port_min; // First port of this segment. Segments are sorted.
+        uint32_t leaf;
+    } port_seg_t;
+
+    typedef struct {
+        uint8_t  ip_proto;
+        uint32_t leaf;                // Used when segs is empty
+        std::vector<port_seg_t> segs; // UDP destination port segments (UDP only)
+    } proto_node_t;
+
+    typedef struct {
+        uint16_t                  etype;
+        uint32_t                  ip_invalid_leaf; // Frames that aren't IP
+        uint32_t                  proto_other_leaf; // IP frames with protocols not in #protos
+        std::vector<proto_node_t> protos;           // Sorted by ip_proto
+    } etype_node_t;
+
+    uint32_t leaf_add(const std::vector<packet_rx_classifier_rule_t> &rules, const std::vector<uint32_t> &idxs);
+    void etype_node_build(const std::vector<packet_rx_classifier_rule_t> &rules, const std::vector<uint32_t> &idxs, etype_node_t &node);
+
+    std::vector<etype_node_t> etypes;        // Sorted by etype
+    etype_node_t              etype_other;   // Frames with EtherTypes not in #etypes
+    std::vector<std::vector<packet_rx_classifier_entry_t>> leaf_entries;
+    std::vector<packet_rx_classifier_leaf_t> leaves;
+    uint32_t                  entry_total = 0;
+};
+
+#endif /* _PACKET_RX_CLASSIFIER_HXX_ */
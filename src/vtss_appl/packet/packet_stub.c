@@ -44,6 +44,14 @@ mesa_rc packet_tx(packet_tx_props_t *tx_props)
     return VTSS_RC_ERROR;
 }
 
+/******************************************************************************/
+// packet_tx_batch()
+/******************************************************************************/
+mesa_rc packet_tx_batch(packet_tx_props_t *tx_props, u32 cnt, mesa_rc *rcs)
+{
+    return VTSS_RC_ERROR;
+}
+
 /******************************************************************************/
 // packet_tx_alloc()
 // Size argument should not include IFH, CMD, and FCS
@@ -0,0 +1,374 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Differential test of the packet Rx classifier. The reference matcher below
+// is a transcription of the EtherType, IP protocol, UDP destination port and
+// MAC checks of RX_match_next() in packet.cxx as it were before the
+// classifier was introduced. For random filter lists and frames, the
+// classifier's candidates that pass the checks must equal the filters that
+// the reference matches - in the same order. Since the classifier only keys on
+// exact values, only filters with wildcarded EtherType or IP protocol may be
+// candidates without matching. Frames that are too short to hold the IP
+// protocol or UDP port must not match filters on them, and runt frames must
+// not yield a key at all.
+
+#include "../packet_rx_classifier.hxx"
+#include <random>
+#include <string.h>
+#include "catch.hpp"
+
+#define ETYPE_IPV4   0x0800
+#define ETYPE_IPV6   0x86DD
+#define IP_PROTO_UDP 17
+
+typedef struct {
+    bool     etype_ena, ip_proto_ena, udp_dst_port_ena, dmac_ena, smac_ena, dflt;
+    uint16_t etype, etype_mask;
+    uint8_t  ip_proto, ip_proto_mask;
+    uint16_t udp_dst_port_min, udp_dst_port_max;
+    uint8_t  dmac[6], dmac_mask[6], smac[6], smac_mask[6];
+} test_filter_t;
+
+static uint64_t mac_to_u64(const uint8_t *mac)
+{
+    uint64_t v = 0;
+
+    for (int i = 0; i < 6; i++) {
+        v = (v << 8) | mac[i];
+    }
+
+    return v;
+}
+
+static bool reference_match(const test_filter_t &f, const uint8_t *frm, uint32_t len, uint16_t etype)
+{
+    if (f.dflt) {
+        return false;
+    }
+
+    if (f.dmac_ena) {
+        for (int i = 0; i < 6; i++) {
+            if ((frm[i] & f.dmac_mask[i]) != f.dmac[i]) {
+                return false;
+            }
+        }
+    }
+
+    if (f.smac_ena) {
+        for (int i = 0; i < 6; i++) {
+            if ((frm[6 + i] & f.smac_mask[i]) != f.smac[i]) {
+                return false;
+            }
+        }
+    }
+
+    if (f.etype_ena && (etype & f.etype_mask) != f.etype) {
+        return false;
+    }
+
+    if (f.ip_proto_ena) {
+        uint16_t hlen;
+
+        if (etype == ETYPE_IPV4) {
+            if (len < 14 + 10) {
+                return false;
+            }
+
+            if ((frm[14 + 9] & f.ip_proto_mask) != f.ip_proto || (frm[14] & 0xF0) != 0x40) {
+                return false;
+            }
+
+            hlen = 4 * (frm[14] & 0xF);
+        } else {
+            if (len < 14 + 7) {
+                return false;
+            }
+
+            if ((frm[14 + 6] & f.ip_proto_mask) != f.ip_proto || (frm[14] & 0xF0) != 0x60) {
+                return false;
+            }
+
+            hlen = 40;
+        }
+
+        // UDP frames without a complete destination port aren't IP frames to
+        // the classifier.
+        if (frm[etype == ETYPE_IPV4 ? 14 + 9 : 14 + 6] == IP_PROTO_UDP && len < 14u + hlen + 4) {
+            return false;
+        }
+
+        if (f.udp_dst_port_ena) {
+            uint16_t port = (frm[14 + hlen + 2] << 8) | frm[14 + hlen + 3];
+
+            if (port < f.udp_dst_port_min || port > f.udp_dst_port_max) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+struct Differential {
+    std::mt19937 rnd{4711};
+
+    uint32_t r(uint32_t n)
+    {
+        return rnd() % n;
+    }
+
+    // Filters are generated like RX_filter_validate() and RX_filter_insert()
+    // leave them, that is, with masks in internal polarity and the value
+    // already masked.
+    test_filter_t filter_get()
+    {
+        static const uint16_t etypes[] = {ETYPE_IPV4, ETYPE_IPV6, 0x8809, 0x88CC, 0x8902};
+        static const uint8_t  protos[] = {IP_PROTO_UDP, 6, 1, 58, 2};
+        test_filter_t         f;
+
+        memset(&f, 0, sizeof(f));
+        f.dflt = r(10) == 0;
+
+        if ((f.ip_proto_ena = r(2) == 0)) {
+            // IP protocol matching requires an IP EtherType.
+            f.etype_ena = true;
+            f.etype = r(2) ? ETYPE_IPV4 : ETYPE_IPV6;
+            f.etype_mask = 0xFFFF;
+            f.ip_proto = protos[r(sizeof(protos))];
+            f.ip_proto_mask = r(8) == 0 ? 0xF0 : 0xFF;
+            f.ip_proto &= f.ip_proto_mask;
+
+            if (f.ip_proto_mask == 0xFF && f.ip_proto == IP_PROTO_UDP && (f.udp_dst_port_ena = r(3) != 0)) {
+                f.udp_dst_port_min = r(4) == 0 ? 0 : 60 + r(20);
+                f.udp_dst_port_max = r(4) == 0 ? 0xFFFF : f.udp_dst_port_min + r(10);
+            }
+        } else if ((f.etype_ena = r(3) != 0)) {
+            f.etype = etypes[r(sizeof(etypes) / sizeof(etypes[0]))];
+            f.etype_mask = r(6) == 0 ? 0xFF00 : 0xFFFF;
+            f.etype &= f.etype_mask;
+        }
+
+        if ((f.dmac_ena = r(4) == 0)) {
+            for (int i = 0; i < 6; i++) {
+                f.dmac_mask[i] = r(2) ? 0xFF : 0x00;
+                f.dmac[i] = (i == 0 ? 0x01 : r(3)) & f.dmac_mask[i];
+            }
+        }
+
+        if ((f.smac_ena = r(8) == 0)) {
+            for (int i = 0; i < 6; i++) {
+                f.smac_mask[i] = r(2) ? 0xFF : 0x0F;
+                f.smac[i] = r(3) & f.smac_mask[i];
+            }
+        }
+
+        return f;
+    }
+
+    // Frames are biased towards the values used by the filters. Some are cut
+    // short of the fields the classifier keys on.
+    uint16_t frame_get(uint8_t *frm, uint32_t &len)
+    {
+        static const uint16_t etypes[] = {ETYPE_IPV4, ETYPE_IPV6, 0x8809, 0x88CC, 0x8902, 0x8900, 0x1234};
+        static const uint8_t  protos[] = {IP_PROTO_UDP, 6, 1, 58, 2, 3, 0};
+        uint16_t              etype = etypes[r(sizeof(etypes) / sizeof(etypes[0]))];
+        uint32_t              hlen;
+        uint16_t              port;
+
+        for (int i = 0; i < 128; i++) {
+            frm[i] = r(256);
+        }
+
+        for (int i = 0; i < 12; i++) {
+            frm[i] = i == 0 ? r(2) : r(3);
+        }
+
+        frm[12] = etype >> 8;
+        frm[13] = etype & 0xFF;
+
+        // Sometimes use a mismatching IP version.
+        if (etype == ETYPE_IPV4) {
+            frm[14] = (r(8) ? 0x40 : 0x60) | (5 + r(3));
+            frm[14 + 9] = protos[r(sizeof(protos))];
+            hlen = 4 * (frm[14] & 0xF);
+        } else {
+            frm[14] = r(4) ? 0x60 : 0x40;
+            frm[14 + 6] = protos[r(sizeof(protos))];
+            hlen = 40;
+        }
+
+        port = r(4) == 0 ? r(0x10000) : 55 + r(40);
+        frm[14 + hlen + 2] = port >> 8;
+        frm[14 + hlen + 3] = port & 0xFF;
+
+        switch (r(16)) {
+        case 0:
+            len = r(14);
+            break;
+
+        case 1:
+            len = 14 + r(hlen + 4);
+            break;
+
+        default:
+            len = 64 + r(65);
+            break;
+        }
+
+        return etype;
+    }
+};
+
+TEST_CASE_METHOD(Differential, "packet_rx_classifier_random", "[packet_rx_classifier]")
+{
+    uint8_t frm[128];
+
+    for (int list = 0; list < 300; list++) {
+        std::vector<test_filter_t>               filters;
+        std::vector<packet_rx_classifier_rule_t> rules;
+        uint32_t                                 cnt = r(40);
+
+        for (uint32_t i = 0; i < cnt; i++) {
+            const test_filter_t         f = filter_get();
+            packet_rx_classifier_rule_t rule;
+
+            rule.skip             = f.dflt;
+            rule.etype_ena        = f.etype_ena;
+            rule.etype            = f.etype;
+            rule.etype_mask       = f.etype_mask;
+            rule.ip_proto_ena     = f.ip_proto_ena;
+            rule.ip_proto         = f.ip_proto;
+            rule.ip_proto_mask    = f.ip_proto_mask;
+            rule.udp_dst_port_ena = f.udp_dst_port_ena;
+            rule.udp_dst_port_min = f.udp_dst_port_min;
+            rule.udp_dst_port_max = f.udp_dst_port_max;
+            rule.dmac_ena         = f.dmac_ena;
+            rule.dmac             = mac_to_u64(f.dmac);
+            rule.dmac_mask        = mac_to_u64(f.dmac_mask);
+            rule.smac_ena         = f.smac_ena;
+            rule.smac             = mac_to_u64(f.smac);
+            rule.smac_mask        = mac_to_u64(f.smac_mask);
+
+            filters.push_back(f);
+            rules.push_back(rule);
+        }
+
+        PacketRxClassifier classifier(rules);
+
+        for (int frame = 0; frame < 500; frame++) {
+            packet_rx_classifier_key_t        key;
+            std::vector<uint32_t>             expect, got;
+            uint32_t                          len;
+            uint16_t                          etype = frame_get(frm, len);
+            const packet_rx_classifier_leaf_t *leaf;
+
+            INFO("list = " << list << ", frame = " << frame << ", len = " << len);
+
+            if (!packet_rx_classifier_key_get(frm, len, etype, &key)) {
+                // Runt frames don't get any candidates.
+                REQUIRE(len < 14);
+                continue;
+            }
+
+            REQUIRE(len >= 14);
+
+            for (uint32_t i = 0; i < filters.size(); i++) {
+                if (reference_match(filters[i], frm, len, etype)) {
+                    expect.push_back(i);
+                }
+            }
+
+            leaf = classifier.lookup(&key);
+            REQUIRE(leaf != NULL);
+
+            for (uint32_t i = 0; i < leaf->cnt; i++) {
+                // The classifier must never yield filters out of order.
+                if (i) {
+                    REQUIRE(leaf->entries[i - 1].idx < leaf->entries[i].idx);
+                }
+
+                const uint32_t      idx = leaf->entries[i].idx;
+                const test_filter_t &f  = filters[idx];
+
+                if (!packet_rx_classifier_mac_match(&leaf->entries[i], &key)) {
+                    continue;
+                }
+
+                if (reference_match(f, frm, len, etype)) {
+                    got.push_back(idx);
+                } else {
+                    INFO("filter = " << idx);
+                    REQUIRE(((f.etype_ena && f.etype_mask != 0xFFFF) || (f.ip_proto_ena && f.ip_proto_mask != 0xFF)));
+                }
+            }
+
+            REQUIRE(expect == got);
+        }
+    }
+}
+
+TEST_CASE_METHOD(Differential, "packet_rx_classifier_empty", "[packet_rx_classifier]")
+{
+    std::vector<packet_rx_classifier_rule_t> rules;
+    PacketRxClassifier                       classifier(rules);
+    packet_rx_classifier_key_t               key;
+    uint8_t                                  frm[128];
+    uint32_t                                 len;
+    uint16_t                                 etype = frame_get(frm, len);
+
+    REQUIRE(packet_rx_classifier_key_get(frm, sizeof(frm), etype, &key));
+    REQUIRE(classifier.lookup(&key)->cnt == 0);
+}
+
+TEST_CASE_METHOD(Differential, "packet_rx_classifier_runt", "[packet_rx_classifier]")
+{
+    packet_rx_classifier_key_t key;
+    uint8_t                    frm[128];
+    uint32_t                   len;
+
+    memset(frm, 0, sizeof(frm));
+    frm[12] = ETYPE_IPV4 >> 8;
+    frm[13] = ETYPE_IPV4 & 0xFF;
+    frm[14] = 0x45;
+    frm[14 + 9] = IP_PROTO_UDP;
+
+    for (len = 0; len < 14; len++) {
+        REQUIRE(!packet_rx_classifier_key_get(frm, len, ETYPE_IPV4, &key));
+    }
+
+    // MACs and EtherType, but no IP protocol
+    REQUIRE(packet_rx_classifier_key_get(frm, 14 + 9, ETYPE_IPV4, &key));
+    REQUIRE(!key.ip_valid);
+
+    // IP protocol, but no UDP destination port
+    REQUIRE(packet_rx_classifier_key_get(frm, 14 + 20 + 3, ETYPE_IPV4, &key));
+    REQUIRE(!key.ip_valid);
+
+    REQUIRE(packet_rx_classifier_key_get(frm, 14 + 20 + 4, ETYPE_IPV4, &key));
+    REQUIRE(key.ip_valid);
+    REQUIRE(key.ip_proto == IP_PROTO_UDP);
+}
+
@@ -0,0 +1,407 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Host benchmark of the two packet module Rx paths.
+// A pcap file is replayed into one end of a veth pair while the other end is
+// read either like RX_thread() does without the Rx ring (one malloc() and one
+// recv() per frame) or like RX_ring_thread() does (frames handled in place in
+// a TPACKET_V3 block ring). Frames/s and CPU time spent by the Rx thread are
+// reported for each mode.
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#define BENCH_IF_TX "vbench0"
+#define BENCH_IF_RX "vbench1"
+#define BENCH_MTU   10240
+
+static std::vector<std::string> frames;
+static std::atomic<bool>        rx_stop;
+static std::atomic<uint64_t>    rx_frames;
+static std::atomic<uint64_t>    rx_bytes;
+static volatile uint32_t        rx_checksum; // Touch the frame data so that it isn't optimized away
+static uint32_t                 ring_block_size = 64 * 1024;
+static uint32_t                 ring_block_cnt  = 32;
+
+struct pcap_hdr {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t  thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t network;
+};
+
+struct pcap_rec_hdr {
+    uint32_t ts_sec;
+    uint32_t ts_usec;
+    uint32_t incl_len;
+    uint32_t orig_len;
+};
+
+static bool pcap_load(const char *file)
+{
+    struct pcap_hdr     hdr;
+    struct pcap_rec_hdr rec;
+    bool                swap;
+    FILE                *f;
+
+    if ((f = fopen(file, "rb")) == NULL) {
+        fprintf(stderr, "Unable to open %s: %s\n", file, strerror(errno));
+        return false;
+    }
+
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || (hdr.magic != 0xa1b2c3d4 && hdr.magic != 0xd4c3b2a1)) {
+        fprintf(stderr, "%s is not a pcap file\n", file);
+        fclose(f);
+        return false;
+    }
+
+    swap = hdr.magic == 0xd4c3b2a1;
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+        uint32_t len = swap ? __builtin_bswap32(rec.incl_len) : rec.incl_len;
+        std::string frm(len, '\0');
+
+        if (len > BENCH_MTU || fread(&frm[0], len, 1, f) != 1) {
+            break;
+        }
+
+        if (len >= ETH_ZLEN) {
+            frames.push_back(frm);
+        }
+    }
+
+    fclose(f);
+    return !frames.empty();
+}
+
+static void pcap_synthesize(void)
+{
+    // No pcap file given. Use a BPDU-like 64-byte frame and a 1514-byte frame.
+    std::string bpdu(60, '\0'), big(1514, '\0');
+    const uint8_t dmac[6] = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x00};
+
+    memcpy(&bpdu[0], dmac, 6);
+    bpdu[6] = 0x02;
+    bpdu[12] = 0x00;
+    bpdu[13] = 0x26;
+    big[0] = (char)0xff;
+    big[6] = 0x02;
+    big[12] = 0x08;
+    frames.push_back(bpdu);
+    frames.push_back(big);
+}
+
+static int if_index_get(int fd, const char *name)
+{
+    struct ifreq ifr;
+
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+        return -1;
+    }
+
+    return ifr.ifr_ifindex;
+}
+
+static int socket_open(const char *name)
+{
+    struct sockaddr_ll addr;
+    int                fd;
+
+    if ((fd = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_ALL))) < 0) {
+        fprintf(stderr, "socket() failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family   = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex  = if_index_get(fd, name);
+    if (addr.sll_ifindex < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "Unable to bind to %s: %s\n", name, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static uint64_t now_nsec(clockid_t clk)
+{
+    struct timespec ts;
+
+    clock_gettime(clk, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000LLU + ts.tv_nsec;
+}
+
+static void frame_consume(const uint8_t *frm, uint32_t len)
+{
+    // Mimic RX_dispatch_init(), which looks at the EtherType and the MACs.
+    rx_checksum += frm[0] + frm[6] + frm[12] + frm[13] + len;
+    rx_frames.fetch_add(1, std::memory_order_relaxed);
+    rx_bytes.fetch_add(len, std::memory_order_relaxed);
+}
+
+struct rx_result {
+    uint64_t cpu_nsec;
+};
+
+static void *rx_recv_thread(void *arg)
+{
+    int       fd = *(int *)arg;
+    uint64_t  t0 = now_nsec(CLOCK_THREAD_CPUTIME_ID);
+    rx_result *res = new rx_result;
+
+    while (!rx_stop.load()) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        uint8_t       *frm;
+        int           len;
+
+        if (poll(&pfd, 1, 10) <= 0) {
+            continue;
+        }
+
+        // Same as RX_thread(): one allocation and one syscall per frame.
+        if ((frm = (uint8_t *)malloc(BENCH_MTU)) == NULL) {
+            break;
+        }
+
+        if ((len = recv(fd, frm, BENCH_MTU, MSG_TRUNC | MSG_DONTWAIT)) > 0 && len <= BENCH_MTU) {
+            frame_consume(frm, len);
+        }
+
+        free(frm);
+    }
+
+    res->cpu_nsec = now_nsec(CLOCK_THREAD_CPUTIME_ID) - t0;
+    return res;
+}
+
+static void *rx_ring_thread(void *arg)
+{
+    int                 fd = *(int *)arg, ver = TPACKET_V3;
+    struct tpacket_req3 req;
+    uint8_t             *map;
+    uint32_t            cur = 0;
+    uint64_t            t0;
+    rx_result           *res = new rx_result;
+
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size     = ring_block_size;
+    req.tp_block_nr       = ring_block_cnt;
+    req.tp_frame_size     = TPACKET_ALIGN(TPACKET3_HDRLEN + BENCH_MTU);
+    req.tp_frame_nr       = (ring_block_size / req.tp_frame_size) * ring_block_cnt;
+    req.tp_retire_blk_tov = 2;
+
+    if (setsockopt(fd, SOL_PACKET, PACKET_VERSION, &ver, sizeof(ver)) != 0 ||
+        setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0) {
+        fprintf(stderr, "Unable to set up Rx ring: %s\n", strerror(errno));
+        res->cpu_nsec = 0;
+        return res;
+    }
+
+    map = (uint8_t *)mmap(NULL, (size_t)ring_block_size * ring_block_cnt, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, fd, 0);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "mmap() failed: %s\n", strerror(errno));
+        res->cpu_nsec = 0;
+        return res;
+    }
+
+    t0 = now_nsec(CLOCK_THREAD_CPUTIME_ID);
+    while (!rx_stop.load()) {
+        struct tpacket_block_desc *desc = (struct tpacket_block_desc *)(map + (size_t)cur * ring_block_size);
+        struct tpacket3_hdr       *hdr;
+        uint32_t                  i;
+
+        if ((__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) {
+            struct pollfd pfd = {fd, POLLIN | POLLERR, 0};
+            (void)poll(&pfd, 1, 10);
+            continue;
+        }
+
+        hdr = (struct tpacket3_hdr *)((uint8_t *)desc + desc->hdr.bh1.offset_to_first_pkt);
+        for (i = 0; i < desc->hdr.bh1.num_pkts; i++) {
+            frame_consume((uint8_t *)hdr + hdr->tp_mac, hdr->tp_snaplen);
+            hdr = (struct tpacket3_hdr *)((uint8_t *)hdr + hdr->tp_next_offset);
+        }
+
+        __sync_synchronize();
+        desc->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        cur = (cur + 1) % ring_block_cnt;
+    }
+
+    res->cpu_nsec = now_nsec(CLOCK_THREAD_CPUTIME_ID) - t0;
+    (void)munmap(map, (size_t)ring_block_size * ring_block_cnt);
+    return res;
+}
+
+static bool run(const char *mode, bool ring, uint32_t rounds)
+{
+    int         rx_fd, tx_fd, qdisc_bypass = 1;
+    pthread_t   thread;
+    rx_result   *res;
+    uint64_t    t0, t1, tx_frames = 0;
+    uint32_t    r;
+    size_t      i;
+
+    if ((rx_fd = socket_open(BENCH_IF_RX)) < 0 || (tx_fd = socket_open(BENCH_IF_TX)) < 0) {
+        return false;
+    }
+
+    (void)setsockopt(tx_fd, SOL_PACKET, PACKET_QDISC_BYPASS, &qdisc_bypass, sizeof(qdisc_bypass));
+
+    rx_stop = false;
+    rx_frames = 0;
+    rx_bytes = 0;
+    pthread_create(&thread, NULL, ring ? rx_ring_thread : rx_recv_thread, &rx_fd);
+
+    // Give the Rx thread time to set up.
+    usleep(100000);
+
+    t0 = now_nsec(CLOCK_MONOTONIC);
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < frames.size(); i++) {
+            while (send(tx_fd, frames[i].data(), frames[i].size(), 0) < 0) {
+                if (errno != ENOBUFS && errno != EAGAIN) {
+                    fprintf(stderr, "send() failed: %s\n", strerror(errno));
+                    goto do_exit;
+                }
+            }
+
+            tx_frames++;
+        }
+    }
+
+do_exit:
+    // Let the receiver drain.
+    usleep(200000);
+    t1 = now_nsec(CLOCK_MONOTONIC);
+    rx_stop = true;
+    pthread_join(thread, (void **)&res);
+
+    printf("%-6s: Tx %10llu Rx %10llu frames (%5.1f%% lost), %10.0f frames/s, Rx thread CPU %8.3f ms (%6.1f ns/frame)\n",
+           mode,
+           (unsigned long long)tx_frames,
+           (unsigned long long)rx_frames.load(),
+           tx_frames ? 100.0 * (tx_frames - rx_frames.load()) / tx_frames : 0.0,
+           1e9 * rx_frames.load() / (t1 - t0),
+           res->cpu_nsec / 1e6,
+           rx_frames.load() ? (double)res->cpu_nsec / rx_frames.load() : 0.0);
+
+    delete res;
+    close(rx_fd);
+    close(tx_fd);
+    return true;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-r <pcap file>] [-n <rounds>] [-m recv|ring|both] [-b <block size>] [-c <block count>]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    const char *file = NULL, *mode = "both";
+    uint32_t   rounds = 1000;
+    int        opt;
+    bool       ok = true;
+
+    while ((opt = getopt(argc, argv, "r:n:m:b:c:h")) != -1) {
+        switch (opt) {
+        case 'r':
+            file = optarg;
+            break;
+
+        case 'n':
+            rounds = strtoul(optarg, NULL, 0);
+            break;
+
+        case 'm':
+            mode = optarg;
+            break;
+
+        case 'b':
+            ring_block_size = strtoul(optarg, NULL, 0);
+            break;
+
+        case 'c':
+            ring_block_cnt = strtoul(optarg, NULL, 0);
+            break;
+
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (file) {
+        if (!pcap_load(file)) {
+            return 1;
+        }
+    } else {
+        pcap_synthesize();
+    }
+
+    if (system("ip link add " BENCH_IF_TX " mtu 10240 type veth peer name " BENCH_IF_RX " mtu 10240 && "
+               "ip link set " BENCH_IF_TX " up && ip link set " BENCH_IF_RX " up") != 0) {
+        fprintf(stderr, "Unable to create veth pair (must run as root)\n");
+        return 1;
+    }
+
+    printf("Replaying %zu frames %u times\n", frames.size(), rounds);
+
+    if (strcmp(mode, "recv") == 0 || strcmp(mode, "both") == 0) {
+        ok = run("recv", false, rounds) && ok;
+    }
+
+    if (strcmp(mode, "ring") == 0 || strcmp(mode, "both") == 0) {
+        ok = run("ring", true, rounds) && ok;
+    }
+
+    (void)system("ip link del " BENCH_IF_TX);
+    printf("Checksum: 0x%08x\n", rx_checksum);
+    return ok ? 0 : 1;
+}
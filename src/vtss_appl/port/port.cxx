@@ -31,6 +31,7 @@
 #include "port_api.h"
 #include "port_instance.hxx"
 #include "port_listener.hxx"
+#include "port_counters.hxx"
 #include "port_lock.hxx"
 #include "port_trace.h"
 #include "vtss_api_if_api.h"
@@ -175,6 +176,11 @@ static vtss_trace_grp_t trace_grps[] = {
         VTSS_TRACE_LVL_ERROR,
         VTSS_TRACE_FLAGS_USEC
     },
+    [PORT_TRACE_GRP_COUNTERS] = {
+        "counters",
+        "Port counter snapshot cache",
+        VTSS_TRACE_LVL_ERROR
+    },
 };
 
 VTSS_TRACE_REGISTER(&trace_reg, trace_grps);
@@ -1363,7 +1369,7 @@ mesa_rc vtss_appl_port_statistics_get(vtss_ifindex_t ifindex, mesa_port_counters
     // Normal switch port
     VTSS_RC(PORT_ifindex_to_port(ifindex, port_no));
 
-    return mesa_port_counters_get(NULL, port_no, statistics);
+    return port_counters_get(port_no, statistics);
 }
 
 /******************************************************************************/
@@ -1391,7 +1397,11 @@ mesa_rc vtss_appl_port_statistics_clear(vtss_ifindex_t ifindex)
         port_instances[port_no].link_up_down_cnt_clear();
     }
 
-    return mesa_port_counters_clear(NULL, port_no);
+    VTSS_RC(mesa_port_counters_clear(NULL, port_no));
+
+    // Make the next request read the cleared counters
+    port_counters_clear_notify(port_no);
+    return VTSS_RC_OK;
 }
 
 /******************************************************************************/
@@ -2708,6 +2718,9 @@ mesa_rc port_init(vtss_init_data_t *data)
         /* Create critical region protecting callbacks and their registrations  */
         critd_init(&port.cb_crit, "port.cb", VTSS_MODULE_ID_PORT, CRITD_TYPE_MUTEX);
 
+        /* Create counter snapshot cache */
+        port_counters_init();
+
         /* Create event flag for interrupt to signal and PORT_thread to wait for */
         vtss_flag_init(&interrupt_wait_flag);
 
@@ -177,6 +177,54 @@ mesa_rc port_ifindex_valid(vtss_ifindex_t ifindex);
 mesa_rc port_man_neg_set(mesa_port_no_t port_no, mepa_manual_neg_t man_neg);
 mesa_rc port_man_neg_get(mesa_port_no_t port_no, mepa_manual_neg_t *man_neg);
 
+/**
+ * Port counter snapshot cache.
+ *
+ * Port counters are read from hardware by the port module on behalf of all
+ * consumers. A request for a port whose snapshot is older than max_age_msec
+ * refreshes the snapshot of all ports in one sweep, so that consumers polling
+ * the ports one by one share the same hardware reads.
+ *
+ * A max_age_msec of 0 disables the cache, so that each request reads the
+ * counters directly from hardware.
+ */
+typedef struct {
+    uint32_t max_age_msec;
+} port_counters_cache_conf_t;
+
+mesa_rc port_counters_cache_conf_get(port_counters_cache_conf_t *conf);
+mesa_rc port_counters_cache_conf_set(const port_counters_cache_conf_t *conf);
+
+/**
+ * Counter change since the previous call from the same consumer.
+ *
+ * The port module keeps the previous sample per consumer and port, so
+ * consumers do not need to keep their own copies. A consumer is identified by
+ * module_id and an instance number of the module's own choice, e.g. the index
+ * of an RMON history entry.
+ * The first call for a port returns zero counters and msec = 0.
+ * Counters cleared with vtss_appl_port_statistics_clear() count from zero in
+ * the next delta. Counters that have decreased otherwise since the previous
+ * sample are treated as started from zero.
+ */
+typedef struct {
+    uint64_t             msec;     // Milliseconds between the two samples
+    mesa_port_counters_t counters; // Counter change between the two samples
+} port_counters_delta_t;
+
+mesa_rc port_counters_delta_get(vtss_module_id_t module_id, uint32_t instance, mesa_port_no_t port_no, port_counters_delta_t *delta);
+
+/**
+ * Like port_counters_delta_get(), but with each counter converted to a
+ * per-second rate. Shares the previous sample with port_counters_delta_get().
+ */
+mesa_rc port_counters_rate_get(vtss_module_id_t module_id, uint32_t instance, mesa_port_no_t port_no, mesa_port_counters_t *rate);
+
+/**
+ * Forget the previous samples of a consumer on all ports.
+ */
+void port_counters_delta_free(vtss_module_id_t module_id, uint32_t instance);
+
 // For tracing of vtss_appl_port_status_t
 vtss::ostream &operator<<(vtss::ostream &o, const vtss_appl_port_status_t &status);
 size_t fmt(vtss::ostream &o, const vtss::Fmt &fmt, const vtss_appl_port_status_t *status);
@@ -0,0 +1,355 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#include "port_counters.hxx"
+#include "port_trace.h"
+#include "critd_api.h"
+#include <vtss/basics/map.hxx>
+#include <vtss/basics/utility.hxx>
+
+extern vtss_appl_port_capabilities_t PORT_cap;
+
+#define PORT_COUNTERS_MAX_AGE_MSEC_DEFAULT 1000
+
+// The counter arithmetic below treats mesa_port_counters_t as an array of
+// mesa_port_counter_t.
+#define PORT_COUNTERS_CNT (sizeof(mesa_port_counters_t) / sizeof(mesa_port_counter_t))
+static_assert(sizeof(mesa_port_counters_t) % sizeof(mesa_port_counter_t) == 0, "mesa_port_counters_t must only contain mesa_port_counter_t members");
+
+// Counter sample of one port
+typedef struct {
+    mesa_port_counters_t counters;
+    uint64_t             msec;  // Uptime in milliseconds when sampled
+    bool                 valid;
+} port_counters_sample_t;
+
+typedef CapArray<port_counters_sample_t, MEBA_CAP_BOARD_PORT_MAP_COUNT> port_counters_samples_t;
+
+// Protects everything below
+VTSS_CRIT_SCOPE_CLASS(PORT_COUNTERS_crit, PORT_COUNTERS_lock_scope);
+#define PORT_COUNTERS_LOCK_SCOPE() PORT_COUNTERS_lock_scope __lock_guard__(__LINE__)
+
+static port_counters_cache_conf_t                           PORT_COUNTERS_conf;
+static port_counters_samples_t                              PORT_COUNTERS_snapshot;
+static vtss::Map<uint64_t, port_counters_sample_t>          PORT_COUNTERS_consumers;
+static bool                                                 PORT_COUNTERS_sweep_valid;
+static uint64_t                                             PORT_COUNTERS_sweep_msec;
+static port_counters_stats_t                                PORT_COUNTERS_stats;
+static uint64_t                                             PORT_COUNTERS_stats_msec;
+
+/******************************************************************************/
+// PORT_COUNTERS_read()
+// Reads the counters of one port from hardware into the snapshot.
+/******************************************************************************/
+static mesa_rc PORT_COUNTERS_read(mesa_port_no_t port_no, uint64_t now)
+{
+    port_counters_sample_t &snapshot = PORT_COUNTERS_snapshot[port_no];
+    mesa_rc                rc;
+
+    PORT_COUNTERS_stats.api_calls++;
+    if ((rc = mesa_port_counters_get(nullptr, port_no, &snapshot.counters)) != VTSS_RC_OK) {
+        T_DG_PORT(PORT_TRACE_GRP_COUNTERS, port_no, "mesa_port_counters_get() failed: %s", error_txt(rc));
+        snapshot.valid = false;
+        return rc;
+    }
+
+    snapshot.msec  = now;
+    snapshot.valid = true;
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// PORT_COUNTERS_sweep()
+// Refreshes the snapshot of all ports.
+/******************************************************************************/
+static void PORT_COUNTERS_sweep(uint64_t now)
+{
+    mesa_port_no_t port_no;
+
+    T_NG(PORT_TRACE_GRP_COUNTERS, "Refreshing %u ports", PORT_cap.port_cnt);
+    PORT_COUNTERS_stats.sweeps++;
+    PORT_COUNTERS_sweep_valid = true;
+    PORT_COUNTERS_sweep_msec  = now;
+    for (port_no = 0; port_no < PORT_cap.port_cnt; port_no++) {
+        // Errors are traced and leave the snapshot invalid
+        (void)PORT_COUNTERS_read(port_no, now);
+    }
+}
+
+/******************************************************************************/
+// PORT_COUNTERS_get()
+// Returns the snapshot of a port, refreshed if too old.
+/******************************************************************************/
+static mesa_rc PORT_COUNTERS_get(mesa_port_no_t port_no, uint64_t now, const port_counters_sample_t **sample)
+{
+    if (port_no >= PORT_cap.port_cnt) {
+        return VTSS_APPL_PORT_RC_PARM;
+    }
+
+    port_counters_sample_t &snapshot = PORT_COUNTERS_snapshot[port_no];
+
+    PORT_COUNTERS_stats.requests++;
+    *sample = &snapshot;
+
+    if (PORT_COUNTERS_conf.max_age_msec == 0) {
+        // Cache disabled
+        return PORT_COUNTERS_read(port_no, now);
+    }
+
+    if (snapshot.valid && now - snapshot.msec < PORT_COUNTERS_conf.max_age_msec) {
+        PORT_COUNTERS_stats.hits++;
+        return VTSS_RC_OK;
+    }
+
+    if (PORT_COUNTERS_sweep_valid && now - PORT_COUNTERS_sweep_msec < PORT_COUNTERS_conf.max_age_msec) {
+        // The rest of the snapshot is still fresh, but this port has been
+        // cleared (or failed) since the last sweep, so read it alone.
+        return PORT_COUNTERS_read(port_no, now);
+    }
+
+    PORT_COUNTERS_sweep(now);
+    return snapshot.valid ? VTSS_RC_OK : VTSS_RC_ERROR;
+}
+
+/******************************************************************************/
+// PORT_COUNTERS_consumer_key()
+// A consumer's previous sample of a port is kept under this key. Ports are
+// the least significant part, so all ports of a consumer are adjacent.
+/******************************************************************************/
+static uint64_t PORT_COUNTERS_consumer_key(vtss_module_id_t module_id, uint32_t instance, mesa_port_no_t port_no)
+{
+    return ((uint64_t)(module_id & 0xffff) << 48) | ((uint64_t)instance << 16) | (port_no & 0xffff);
+}
+
+/******************************************************************************/
+// PORT_COUNTERS_delta_calc()
+/******************************************************************************/
+static void PORT_COUNTERS_delta_calc(const mesa_port_counters_t &prev, const mesa_port_counters_t &cur, mesa_port_counters_t &delta)
+{
+    const mesa_port_counter_t *p = (const mesa_port_counter_t *)&prev;
+    const mesa_port_counter_t *c = (const mesa_port_counter_t *)&cur;
+    mesa_port_counter_t       *d = (mesa_port_counter_t *)&delta;
+    size_t                    i;
+
+    for (i = 0; i < PORT_COUNTERS_CNT; i++) {
+        // A counter that has decreased has been cleared or has wrapped.
+        d[i] = c[i] >= p[i] ? c[i] - p[i] : c[i];
+    }
+}
+
+/******************************************************************************/
+// port_counters_get()
+/******************************************************************************/
+mesa_rc port_counters_get(mesa_port_no_t port_no, mesa_port_counters_t *counters)
+{
+    const port_counters_sample_t *sample;
+
+    PORT_COUNTERS_LOCK_SCOPE();
+
+    VTSS_RC(PORT_COUNTERS_get(port_no, vtss::uptime_milliseconds(), &sample));
+    *counters = sample->counters;
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// port_counters_read()
+/******************************************************************************/
+mesa_rc port_counters_read(mesa_port_no_t port_no, mesa_port_counters_t *counters)
+{
+    if (port_no >= PORT_cap.port_cnt) {
+        return VTSS_APPL_PORT_RC_PARM;
+    }
+
+    PORT_COUNTERS_LOCK_SCOPE();
+
+    PORT_COUNTERS_stats.requests++;
+    VTSS_RC(PORT_COUNTERS_read(port_no, vtss::uptime_milliseconds()));
+    *counters = PORT_COUNTERS_snapshot[port_no].counters;
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// port_counters_clear_notify()
+// Invoked after the counters of a port have been cleared in hardware.
+/******************************************************************************/
+void port_counters_clear_notify(mesa_port_no_t port_no)
+{
+    if (port_no >= PORT_cap.port_cnt) {
+        return;
+    }
+
+    PORT_COUNTERS_LOCK_SCOPE();
+
+    PORT_COUNTERS_snapshot[port_no].valid = false;
+
+    // The next delta of the consumers is what has been counted since now
+    for (auto &consumer : PORT_COUNTERS_consumers) {
+        if ((consumer.first & 0xffff) == port_no) {
+            vtss_clear(consumer.second.counters);
+        }
+    }
+}
+
+/******************************************************************************/
+// port_counters_cache_conf_get()
+/******************************************************************************/
+mesa_rc port_counters_cache_conf_get(port_counters_cache_conf_t *conf)
+{
+    if (!conf) {
+        return VTSS_APPL_PORT_RC_PARM;
+    }
+
+    PORT_COUNTERS_LOCK_SCOPE();
+    *conf = PORT_COUNTERS_conf;
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// port_counters_cache_conf_set()
+/******************************************************************************/
+mesa_rc port_counters_cache_conf_set(const port_counters_cache_conf_t *conf)
+{
+    mesa_port_no_t port_no;
+
+    if (!conf) {
+        return VTSS_APPL_PORT_RC_PARM;
+    }
+
+    PORT_COUNTERS_LOCK_SCOPE();
+    T_IG(PORT_TRACE_GRP_COUNTERS, "max_age_msec: %u -> %u", PORT_COUNTERS_conf.max_age_msec, conf->max_age_msec);
+    PORT_COUNTERS_conf = *conf;
+
+    // Start over with a fresh snapshot
+    for (port_no = 0; port_no < PORT_cap.port_cnt; port_no++) {
+        PORT_COUNTERS_snapshot[port_no].valid = false;
+    }
+
+    PORT_COUNTERS_sweep_valid = false;
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// port_counters_delta_get()
+/******************************************************************************/
+mesa_rc port_counters_delta_get(vtss_module_id_t module_id, uint32_t instance, mesa_port_no_t port_no, port_counters_delta_t *delta)
+{
+    const port_counters_sample_t *sample;
+    uint64_t                     now = vtss::uptime_milliseconds();
+
+    if (!delta) {
+        return VTSS_APPL_PORT_RC_PARM;
+    }
+
+    PORT_COUNTERS_LOCK_SCOPE();
+
+    VTSS_RC(PORT_COUNTERS_get(port_no, now, &sample));
+
+    auto itr = PORT_COUNTERS_consumers.get(PORT_COUNTERS_consumer_key(module_id, instance, port_no));
+    if (itr == PORT_COUNTERS_consumers.end()) {
+        T_EG(PORT_TRACE_GRP_COUNTERS, "Out of memory for module %d, instance %u", module_id, instance);
+        return VTSS_RC_ERROR;
+    }
+
+    port_counters_sample_t &prev = itr->second;
+
+    if (prev.valid) {
+        delta->msec = sample->msec - prev.msec;
+        PORT_COUNTERS_delta_calc(prev.counters, sample->counters, delta->counters);
+    } else {
+        vtss_clear(*delta);
+    }
+
+    prev = *sample;
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// port_counters_rate_get()
+/******************************************************************************/
+mesa_rc port_counters_rate_get(vtss_module_id_t module_id, uint32_t instance, mesa_port_no_t port_no, mesa_port_counters_t *rate)
+{
+    port_counters_delta_t delta;
+    mesa_port_counter_t   *d = (mesa_port_counter_t *)&delta.counters;
+    mesa_port_counter_t   *r = (mesa_port_counter_t *)rate;
+    size_t                i;
+
+    if (!rate) {
+        return VTSS_APPL_PORT_RC_PARM;
+    }
+
+    VTSS_RC(port_counters_delta_get(module_id, instance, port_no, &delta));
+
+    for (i = 0; i < PORT_COUNTERS_CNT; i++) {
+        r[i] = delta.msec ? d[i] * 1000 / delta.msec : 0;
+    }
+
+    return VTSS_RC_OK;
+}
+
+/******************************************************************************/
+// port_counters_delta_free()
+/******************************************************************************/
+void port_counters_delta_free(vtss_module_id_t module_id, uint32_t instance)
+{
+    uint64_t key = PORT_COUNTERS_consumer_key(module_id, instance, 0);
+
+    PORT_COUNTERS_LOCK_SCOPE();
+
+    auto itr = PORT_COUNTERS_consumers.greater_than_or_equal(key);
+    while (itr != PORT_COUNTERS_consumers.end() && (itr->first & ~0xffffULL) == key) {
+        PORT_COUNTERS_consumers.erase(itr++);
+    }
+}
+
+/******************************************************************************/
+// port_counters_stats_get()
+/******************************************************************************/
+void port_counters_stats_get(port_counters_stats_t &stats)
+{
+    PORT_COUNTERS_LOCK_SCOPE();
+    stats = PORT_COUNTERS_stats;
+    stats.msec = vtss::uptime_milliseconds() - PORT_COUNTERS_stats_msec;
+}
+
+/******************************************************************************/
+// port_counters_stats_clear()
+/******************************************************************************/
+void port_counters_stats_clear(void)
+{
+    PORT_COUNTERS_LOCK_SCOPE();
+    vtss_clear(PORT_COUNTERS_stats);
+    PORT_COUNTERS_stats_msec = vtss::uptime_milliseconds();
+}
+
+/******************************************************************************/
+// port_counters_init()
+/******************************************************************************/
+void port_counters_init(void)
+{
+    critd_init(&PORT_COUNTERS_crit, "port.counters", VTSS_MODULE_ID_PORT, CRITD_TYPE_MUTEX);
+    PORT_COUNTERS_conf.max_age_msec = PORT_COUNTERS_MAX_AGE_MSEC_DEFAULT;
+    PORT_COUNTERS_stats_msec = vtss::uptime_milliseconds();
+}
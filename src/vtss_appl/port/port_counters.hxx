@@ -0,0 +1,59 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#ifndef __PORT_COUNTERS_HXX__
+#define __PORT_COUNTERS_HXX__
+
+#include "port_api.h"
+
+// Invocations from port.cxx and port_instance.cxx.
+// None of them may be invoked with the port module's lock taken except
+// port_counters_get() and port_counters_read(), which never take the port
+// module's lock themselves.
+void    port_counters_init(void);
+mesa_rc port_counters_get(mesa_port_no_t port_no, mesa_port_counters_t *counters);
+void    port_counters_clear_notify(mesa_port_no_t port_no);
+
+// Like port_counters_get(), but always reads the counters from hardware, for
+// users that must see the current values, like the LED update. The snapshot
+// of the port is refreshed with them.
+mesa_rc port_counters_read(mesa_port_no_t port_no, mesa_port_counters_t *counters);
+
+// The remainder is for debug purposes.
+
+// Snapshot cache statistics
+typedef struct {
+    uint64_t requests;   // Number of counter requests from all consumers
+    uint64_t hits;       // Number of requests served from the snapshot
+    uint64_t sweeps;     // Number of times all ports were refreshed in one go
+    uint64_t api_calls;  // Number of mesa_port_counters_get() invocations
+    uint64_t msec;       // Number of milliseconds since statistics were cleared
+} port_counters_stats_t;
+
+void port_counters_stats_get(port_counters_stats_t &stats);
+void port_counters_stats_clear(void);
+
+#endif /* __PORT_COUNTERS_HXX__ */
@@ -27,6 +27,7 @@
 #include "port_instance.hxx"
 #include <vtss/appl/port.h>
 #include "port_listener.hxx"
+#include "port_counters.hxx"
 #include "port_trace.h"
 #include "port_lock.hxx"                       // For PORT_LOCK_SCOPE()
 #include "misc_api.h"                          // For iport2uport()
@@ -4266,7 +4267,9 @@ mesa_rc port_instance::led_update(void)
     mesa_port_status.copper = !_port_status.fiber;
     mesa_port_status.fiber  =  _port_status.fiber;
 
-    if (mesa_port_counters_get(nullptr, _port_no, &counters) != VTSS_RC_OK) {
+    // The collision LED compares with the counters of the previous update, so
+    // a cached snapshot would make it miss or repeat changes.
+    if (port_counters_read(_port_no, &counters) != VTSS_RC_OK) {
         vtss_clear(counters);
     }
 
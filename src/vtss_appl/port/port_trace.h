@@ -46,6 +46,7 @@
 #define PORT_TRACE_GRP_MIB               8
 #define PORT_TRACE_GRP_LINK_FLAP_DETECT  9
 #define PORT_TRACE_GRP_CALLBACK         10
+#define PORT_TRACE_GRP_COUNTERS         11
 
 #include <vtss_trace_api.h>
 
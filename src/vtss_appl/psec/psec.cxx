@@ -35,7 +35,7 @@
 #include "msg_api.h"         /* For message transmission and reception functions.    */
 #include "psec_rate_limit.h" /* For rate-limiter                                     */
 #include "misc_api.h"        /* For misc_mac_txt()                                   */
-#include "mac_api.h"         /* mac_mgmt_learn_mode_XXX() MAC functions              */
+#include "mac_api.h"         /* mac_mgmt_learn_mode_XXX(), mac_stats_table_changed() */
 #include "packet_api.h"      /* For packet_rx_filter_XXX()                           */
 #include "port_api.h"        /* For port_vol_conf_set()                              */
 #include "port_iter.hxx"     /* For port iterators                                   */
@@ -64,6 +64,7 @@
 /****************************************************************************/
 #include <vtss_trace_api.h>
 #include "psec_expose.hxx"
+#include "psec_age.hxx"                        /* For psec_age_index_t                   */
 #include <vtss/basics/memcmp-operator.hxx>     /* For VTSS_BASICS_MEMCMP_OPERATOR        */
 #include <vtss/basics/expose/table-status.hxx> /* For vtss::expose::TableStatus          */
 #include "subject.hxx"                         /* For notifications::subject_main_thread */
@@ -258,6 +259,12 @@ static  vtss::Map<vtss_appl_psec_mac_map_key_t, psec_mac_status_t> psec_mac_map;
 typedef vtss::Map<vtss_appl_psec_mac_map_key_t, psec_mac_status_t>::iterator psec_mac_itr_t;
 typedef vtss::Map<vtss_appl_psec_mac_map_key_t, psec_mac_status_t>::const_iterator psec_mac_const_itr_t;
 
+// Entries in psec_mac_map that are subject to aging or holding, ordered by
+// the time (vtss::uptime_seconds()) at which it runs out. While an entry is in
+// here, its status.age_or_hold_time_secs is not counted down, so use
+// PSEC_age_or_hold_get() to get the remaining time.
+static psec_age_index_t<vtss_appl_psec_mac_map_key_t> psec_age_index;
+
 // The following provides inline functions for comparing two psec_semi_public_interface_status_t structures.
 VTSS_BASICS_MEMCMP_OPERATOR(psec_semi_public_interface_status_t);
 
@@ -412,6 +419,10 @@ static vtss_handle_t PSEC_thread_handle;
 static vtss_thread_t PSEC_thread_state;  // Contains space for the scheduler to hold the current thread state.
 static vtss_flag_t   PSEC_thread_wait_flag;
 #define PSEC_THREAD_WAIT_FLAG_ADD_DEL 0x1
+#define PSEC_THREAD_WAIT_FLAG_AGE     0x2
+
+// Max time PSEC_thread() sleeps when no entries are aging or holding.
+#define PSEC_AGE_IDLE_TIMEOUT_MS 10000
 
 /*lint -save -e19 */
 VTSS_ENUM_INC(vtss_appl_psec_user_t);
@@ -834,12 +845,76 @@ static psec_mac_itr_t PSEC_mac_itr_alloc(const vtss_appl_psec_mac_map_key_t *key
 static void PSEC_mac_itr_free(psec_mac_itr_t mac_itr)
 {
     mac_itr->second.unique = 0;
+    psec_age_index.del(mac_itr->first);
     psec_mac_map.erase(mac_itr);
 
     // One more entry to use
     PSEC_macs_left_set(TRUE /* increment */);
 }
 
+/******************************************************************************/
+// PSEC_age_now()
+/******************************************************************************/
+static u32 PSEC_age_now(void)
+{
+    return (u32)vtss::uptime_seconds();
+}
+
+/******************************************************************************/
+// PSEC_age_or_hold_get()
+// Returns the number of seconds left of an entry's age or hold time, or 0 if
+// it's not subject to aging or holding.
+/******************************************************************************/
+static u32 PSEC_age_or_hold_get(psec_mac_itr_t mac_itr)
+{
+    return psec_age_index.left_get(mac_itr->first, mac_itr->second.status.age_or_hold_time_secs, PSEC_age_now());
+}
+
+/******************************************************************************/
+// PSEC_age_or_hold_set()
+// Starts the age or hold time of an entry. If #secs is 0, the entry is no
+// longer aged/held. If the entry is kept blocked, the time doesn't run until
+// it's no longer kept blocked (see PSEC_age_or_hold_update()).
+/******************************************************************************/
+static void PSEC_age_or_hold_set(psec_mac_itr_t mac_itr, u32 secs)
+{
+    u32 expiry = psec_age_index.start(mac_itr->first, mac_itr->second.status.age_or_hold_time_secs, secs, mac_itr->second.status.kept_blocked, PSEC_age_now());
+
+    if (expiry != 0 && psec_age_index.next_get() == expiry) {
+        // This may be earlier than what PSEC_thread() is currently waiting
+        // for.
+        vtss_flag_setbits(&PSEC_thread_wait_flag, PSEC_THREAD_WAIT_FLAG_AGE);
+    }
+}
+
+/******************************************************************************/
+// PSEC_age_or_hold_update()
+// Freezes or resumes the age or hold time of an entry after its kept_blocked
+// flag has changed.
+/******************************************************************************/
+static void PSEC_age_or_hold_update(psec_mac_itr_t mac_itr)
+{
+    PSEC_age_or_hold_set(mac_itr, PSEC_age_or_hold_get(mac_itr));
+}
+
+/******************************************************************************/
+// PSEC_age_decision()
+/******************************************************************************/
+static psec_age_decision_t PSEC_age_decision(psec_add_method_t add_method)
+{
+    switch (add_method) {
+    case PSEC_ADD_METHOD_FORWARD:
+        return PSEC_AGE_DECISION_FORWARD;
+
+    case PSEC_ADD_METHOD_BLOCK:
+        return PSEC_AGE_DECISION_BLOCK;
+
+    case PSEC_ADD_METHOD_KEEP_BLOCKED:
+    default:
+        return PSEC_AGE_DECISION_KEEP_BLOCKED;
+    }
+}
+
 /******************************************************************************/
 // PSEC_msg_buf_alloc()
 // Blocks until a buffer is available, then takes and returns it.
@@ -1219,6 +1294,7 @@ static BOOL PSEC_mac_module_chg(psec_ifindex_t *psec_ifindex, psec_mac_itr_t mac
         T_DG(TRACE_GRP_MAC_MODULE, "%s: MAC Add failed. Called from line %d. Error = %s", buf, called_from, error_txt(rc));
     } else {
         mac_itr->second.in_mac_module = TRUE;
+        mac_stats_table_changed();
     }
 
     return rc == VTSS_RC_OK;
@@ -1252,6 +1328,7 @@ static void PSEC_mac_module_del(psec_ifindex_t *psec_ifindex, psec_mac_itr_t mac
 
         // Now it's no longer there.
         mac_itr->second.in_mac_module = FALSE;
+        mac_stats_table_changed();
     }
 }
 
@@ -1765,7 +1842,7 @@ static void PSEC_mac_del(psec_ifindex_t *psec_ifindex, psec_interface_status_t *
         mac_itr->second.status.kept_blocked = FALSE;
 
         // Tell the PSEC_thread() to remove this after some time.
-        mac_itr->second.status.age_or_hold_time_secs = PSEC_ZOMBIE_HOLD_TIME_SECS;
+        PSEC_age_or_hold_set(mac_itr, PSEC_ZOMBIE_HOLD_TIME_SECS);
 
         // The number of MAC addresses actually in the H/W MAC table is one less now (but this entry stays in
         // our software-list).
@@ -2124,10 +2201,12 @@ static PSEC_INLINE void PSEC_age_frame_seen(psec_ifindex_t *psec_ifindex, psec_m
 /******************************************************************************/
 static BOOL PSEC_mac_chg(psec_ifindex_t *psec_ifindex, const psec_interface_status_t *const port_state, psec_mac_itr_t mac_itr, BOOL update_age_hold_times_only)
 {
-    psec_add_method_t     new_add_method     = PSEC_ADD_METHOD_FORWARD;
+    psec_add_method_t     new_add_method     = PSEC_ADD_METHOD_FORWARD, cur_add_method = PSEC_ADD_METHOD_FORWARD;
     vtss_appl_psec_user_t user;
     u32                   shortest_age_time  = PSEC_AGE_TIME_MAX + 1;
     u32                   shortest_hold_time = PSEC_HOLD_TIME_MAX;
+    u32                   age_or_hold_time_secs;
+    bool                  age_frame_seen     = false;
     BOOL                  update_mac_entry   = FALSE;
     BOOL                  result             = TRUE;
     char                  buf[PSEC_MAC_STR_BUF_SIZE];
@@ -2182,8 +2261,6 @@ static BOOL PSEC_mac_chg(psec_ifindex_t *psec_ifindex, const psec_interface_stat
         mac_itr->second.in_mac_module);
 
     if (mac_itr->second.in_mac_module) {
-        psec_add_method_t cur_add_method;
-
         // Synthesize the current add method to see if we're gonna
         // update it in the MAC table.
         if (mac_itr->second.status.kept_blocked) {
@@ -2198,134 +2275,47 @@ static BOOL PSEC_mac_chg(psec_ifindex_t *psec_ifindex, const psec_interface_stat
             T_E("Internal error");
         }
 
-        switch (cur_add_method) {
-        case PSEC_ADD_METHOD_FORWARD:
-            switch (new_add_method) {
-            case PSEC_ADD_METHOD_FORWARD:
-                // Going from forwarding to forwarding.
-                // If the previous age period is greater than the new,
-                // then use the new (otherwise keep going from where the
-                // previous took off).
-                // If the new age period is disabled, then make sure
-                // CPU copying gets disabled.
-                if ((mac_itr->second.status.age_or_hold_time_secs == 0 && shortest_age_time != 0) || mac_itr->second.status.age_or_hold_time_secs > shortest_age_time) {
-                    // Adjust the age time if necessary.
-                    mac_itr->second.status.age_or_hold_time_secs = shortest_age_time;
-                    if (shortest_age_time == 0) {
-                        if (mac_itr->second.status.cpu_copying) {
-                            mac_itr->second.status.cpu_copying = FALSE;
-                            if (update_age_hold_times_only) {
-                                // Since we're not going into the update loop below, when
-                                // update_age_hold_times_only is set, we need to disable CPU copying
-                                // here.
-                                (void)PSEC_mac_module_chg(psec_ifindex, mac_itr, __LINE__);
-                            } else {
-                                update_mac_entry = TRUE;
-                            }
-                        }
-                    }
-                }
-
-                break;
-
-            case PSEC_ADD_METHOD_BLOCK:
-                // Going from forwarding to blocking. Update the hold time.
-                mac_itr->second.status.age_or_hold_time_secs = shortest_hold_time;
-            // Fall through
-
-            case PSEC_ADD_METHOD_KEEP_BLOCKED:
-            default:
-                // Going from forwarding to blocking or keep blocking.
-                // Never copy to CPU, but always update the MAC entry.
-                mac_itr->second.status.cpu_copying = FALSE;
-                update_mac_entry = TRUE;
-                break;
-            }
-
-            break;
-
-        case PSEC_ADD_METHOD_BLOCK:
-            switch (new_add_method) {
-            case PSEC_ADD_METHOD_FORWARD:
-                // Going from block to forward
-                // Always update the MAC entry in the MAC table,
-                // but also restart aging and pretend that the frame
-                // was received OK in the current age period.
-                mac_itr->second.status.cpu_copying = FALSE;
-                mac_itr->second.status.age_frame_seen = TRUE;
-                mac_itr->second.status.age_or_hold_time_secs = shortest_age_time;
-                update_mac_entry = TRUE;
-                break;
-
-            case PSEC_ADD_METHOD_BLOCK:
-                // Going from block to block. Adjust the remaining hold time
-                // if needed.
-                if (mac_itr->second.status.age_or_hold_time_secs > shortest_hold_time) {
-                    mac_itr->second.status.age_or_hold_time_secs = shortest_hold_time;
-                }
-                break;
-
-            case PSEC_ADD_METHOD_KEEP_BLOCKED:
-                break;
-
-            default:
-                // Nothing to do when going from blocked to keep blocked.
-                break;
-            }
-
-            break;
-
-        case PSEC_ADD_METHOD_KEEP_BLOCKED:
-        default:
-            switch (new_add_method) {
-            case PSEC_ADD_METHOD_FORWARD:
-                // Going from keep-blocked to forward.
-                // Always update the MAC entry in the MAC table,
-                // but also restart aging and pretend that the frame
-                // was received OK in the current age period.
-                mac_itr->second.status.cpu_copying = FALSE;
-                mac_itr->second.status.age_frame_seen = TRUE;
-                mac_itr->second.status.age_or_hold_time_secs = shortest_age_time;
-                update_mac_entry = TRUE;
-                break;
-
-            case PSEC_ADD_METHOD_BLOCK:
-                // Going from keep-blocked to blocked.
-                // Start the hold timer.
-                mac_itr->second.status.age_or_hold_time_secs = shortest_hold_time;
-                break;
-
-            case PSEC_ADD_METHOD_KEEP_BLOCKED:
-            default:
-                // Nothing to do
-                break;
-            }
-
-            break;
-        } /* switch (cur_add_method) */
+        if ((cur_add_method == PSEC_ADD_METHOD_FORWARD) != (new_add_method == PSEC_ADD_METHOD_FORWARD)) {
+            // Going from forwarding to (keep) blocking or vice versa. Never
+            // copy to CPU, but always update the MAC entry.
+            mac_itr->second.status.cpu_copying = FALSE;
+            update_mac_entry = TRUE;
+        }
     } else {
         // The MAC address is currently not in the table (it's brandnew)
         update_mac_entry = TRUE;
         mac_itr->second.status.cpu_copying = FALSE; // Superfluous.
+    }
 
-        switch (new_add_method) {
-        case PSEC_ADD_METHOD_FORWARD:
-            // Pretend an age frame is seen in the first period.
+    // Restart the age or hold time if needed.
+    if (psec_age_or_hold_chg(mac_itr->second.in_mac_module, PSEC_age_decision(cur_add_method), PSEC_age_decision(new_add_method),
+                             mac_itr->second.in_mac_module ? PSEC_age_or_hold_get(mac_itr) : 0,
+                             shortest_age_time, shortest_hold_time, age_or_hold_time_secs, age_frame_seen)) {
+        if (age_frame_seen) {
             mac_itr->second.status.age_frame_seen = TRUE;
-            mac_itr->second.status.age_or_hold_time_secs = shortest_age_time;
-            break;
-
-        case PSEC_ADD_METHOD_BLOCK:
-            mac_itr->second.status.age_or_hold_time_secs = shortest_hold_time;
-            break;
+        }
 
-        case PSEC_ADD_METHOD_KEEP_BLOCKED:
-        default:
-            break;
+        PSEC_age_or_hold_set(mac_itr, age_or_hold_time_secs);
+
+        if (mac_itr->second.in_mac_module && cur_add_method == PSEC_ADD_METHOD_FORWARD && new_add_method == PSEC_ADD_METHOD_FORWARD &&
+            age_or_hold_time_secs == 0 && mac_itr->second.status.cpu_copying) {
+            // Going from forwarding to forwarding with aging disabled, so make
+            // sure CPU copying gets disabled.
+            mac_itr->second.status.cpu_copying = FALSE;
+            if (update_age_hold_times_only) {
+                // Since we're not going into the update loop below, when
+                // update_age_hold_times_only is set, we need to disable CPU copying
+                // here.
+                (void)PSEC_mac_module_chg(psec_ifindex, mac_itr, __LINE__);
+            } else {
+                update_mac_entry = TRUE;
+            }
         }
     }
 
     if (!update_age_hold_times_only) {
+        BOOL kept_blocked = mac_itr->second.status.kept_blocked;
+
         switch (new_add_method) {
         case PSEC_ADD_METHOD_FORWARD:
             mac_itr->second.status.blocked = FALSE;
@@ -2349,6 +2339,11 @@ static BOOL PSEC_mac_chg(psec_ifindex_t *psec_ifindex, const psec_interface_stat
             return FALSE;
         }
 
+        if (mac_itr->second.status.kept_blocked != kept_blocked) {
+            // The age/hold time doesn't run while kept blocked.
+            PSEC_age_or_hold_update(mac_itr);
+        }
+
         if (update_mac_entry) {
             result = PSEC_mac_module_chg(psec_ifindex, mac_itr, __LINE__);
         }
@@ -3155,75 +3150,89 @@ static mesa_rc PSEC_primary_switch_isid_port_check(vtss_isid_t isid, mesa_port_n
 
 /******************************************************************************/
 // PSEC_do_age_or_hold()
+// Handles the entries whose age or hold time has run out.
 /******************************************************************************/
 static void PSEC_do_age_or_hold(void)
 {
-    char                    buf[PSEC_MAC_STR_BUF_SIZE];
-    psec_mac_itr_t          mac_itr, mac_itr_next;
-    psec_interface_status_t port_state;
-    psec_ifindex_t          psec_ifindex;
-
-    mac_itr = PSEC_mac_itr_get_first();
-
-    while (mac_itr != psec_mac_map.end()) {
-        // Keep a pointer to the next, because it may be that we delete the
-        // current below.
-        mac_itr_next = mac_itr;
-        mac_itr_next++;
+    char                         buf[PSEC_MAC_STR_BUF_SIZE];
+    vtss_appl_psec_mac_map_key_t key;
+    psec_mac_itr_t               mac_itr;
+    psec_interface_status_t      port_state;
+    psec_ifindex_t               psec_ifindex;
+    u32                          now = PSEC_age_now();
 
-        if (mac_itr->second.status.age_or_hold_time_secs == 0 || mac_itr->second.status.kept_blocked) {
-            goto next;
+    // Entries are removed from the index as they are returned. Handling them
+    // below may re-insert them (with a later expiry time) or delete them.
+    while (psec_age_index.expired_get(now, key)) {
+        if ((mac_itr = PSEC_mac_itr_get(&key)) == psec_mac_map.end()) {
+            T_E("Aged entry not found");
+            continue;
         }
 
-        // Subject to aging/holding
-        if (--mac_itr->second.status.age_or_hold_time_secs != 0) {
-            goto next;
-        }
+        mac_itr->second.status.age_or_hold_time_secs = 0;
 
         if (PSEC_ifindex_from_ifindex(mac_itr->second.status.ifindex, &psec_ifindex, __LINE__) != VTSS_RC_OK) {
-            goto next;
+            continue;
         }
 
         if (PSEC_interface_status_get(mac_itr->second.status.ifindex, &port_state, __LINE__) != VTSS_RC_OK) {
-            goto next;
+            continue;
         }
 
         (void)PSEC_mac_itr_to_str(mac_itr, buf);
 
         // Aging or holding timed out.
-        if (mac_itr->second.hw_add_failed || mac_itr->second.sw_add_failed || mac_itr->second.status.blocked) {
+        switch (psec_age_expired_get(mac_itr->second.hw_add_failed || mac_itr->second.sw_add_failed || mac_itr->second.status.blocked, mac_itr->second.status.age_frame_seen)) {
+        case PSEC_AGE_EXPIRED_HOLD_TIMEOUT:
             // It was due to hold time. Remove the entry
             T_I("%s: Hold-timeout", buf);
             PSEC_mac_del(&psec_ifindex, &port_state, mac_itr, PSEC_DEL_REASON_HOLD_TIME_EXPIRED, VTSS_APPL_PSEC_USER_LAST, VTSS_APPL_PSEC_USER_LAST);
-        } else {
-            // Aging timed out.
-            if (mac_itr->second.status.age_frame_seen) {
-                // A frame was seen during this aging period.
-                // Keep entry, but re-enable CPU-copying and update the age time.
-                // The following call will only update the age_or_hold_time_secs (due to the TRUE parameter)
-                // If we had called the function with FALSE instead, then the function would have cleared
-                // the CPU_COPYING flag, set the AGE_FRAME_SEEN flag and called the PSEC_mac_module_chg()
-                // function itself. We want the opposite to happen.
-                T_D("%s: Aging timeout. Age-frame seen", buf);
-                (void)PSEC_mac_chg(&psec_ifindex, &port_state, mac_itr, TRUE);
-                // So we need to restart aging ourselves.
-                mac_itr->second.status.cpu_copying = TRUE;
-                mac_itr->second.status.age_frame_seen = FALSE;
-                (void)PSEC_mac_module_chg(&psec_ifindex, mac_itr, __LINE__);
-            } else {
-                // Aging timed out, but the station has not sent new frames in the aging period.
-                // Unregister it.
-                T_I("%s: Aging timeout. Age-frame NOT seen", buf);
-                PSEC_mac_del(&psec_ifindex, &port_state, mac_itr, PSEC_DEL_REASON_AGED_OUT, VTSS_APPL_PSEC_USER_LAST, VTSS_APPL_PSEC_USER_LAST);
-            }
+            break;
+
+        case PSEC_AGE_EXPIRED_FRAME_SEEN:
+            // A frame was seen during this aging period.
+            // Keep entry, but re-enable CPU-copying and update the age time.
+            // The following call will only update the age_or_hold_time_secs (due to the TRUE parameter)
+            // If we had called the function with FALSE instead, then the function would have cleared
+            // the CPU_COPYING flag, set the AGE_FRAME_SEEN flag and called the PSEC_mac_module_chg()
+            // function itself. We want the opposite to happen.
+            T_D("%s: Aging timeout. Age-frame seen", buf);
+            (void)PSEC_mac_chg(&psec_ifindex, &port_state, mac_itr, TRUE);
+            // So we need to restart aging ourselves.
+            mac_itr->second.status.cpu_copying = TRUE;
+            mac_itr->second.status.age_frame_seen = FALSE;
+            (void)PSEC_mac_module_chg(&psec_ifindex, mac_itr, __LINE__);
+            break;
+
+        case PSEC_AGE_EXPIRED_AGED_OUT:
+            // Aging timed out, but the station has not sent new frames in the aging period.
+            // Unregister it.
+            T_I("%s: Aging timeout. Age-frame NOT seen", buf);
+            PSEC_mac_del(&psec_ifindex, &port_state, mac_itr, PSEC_DEL_REASON_AGED_OUT, VTSS_APPL_PSEC_USER_LAST, VTSS_APPL_PSEC_USER_LAST);
+            break;
         }
 
         // Save the changed state back
         (void)PSEC_interface_status_set(psec_ifindex.ifindex, &port_state, __LINE__);
+    }
+}
 
-next:
-        mac_itr = mac_itr_next;
+/******************************************************************************/
+// PSEC_age_next_timeout_ms()
+// Returns the uptime in milliseconds at which the next entry's age or hold
+// time runs out.
+/******************************************************************************/
+static u64 PSEC_age_next_timeout_ms(void)
+{
+    u32 expiry = psec_age_index.next_get();
+
+    if (expiry == 0) {
+        // Nothing to age or hold. PSEC_age_or_hold_set() wakes us up when that
+        // changes, so this is just for the sake of it.
+        return vtss::uptime_milliseconds() + PSEC_AGE_IDLE_TIMEOUT_MS;
     }
+
+    return (u64)expiry * 1000;
 }
 
 /******************************************************************************/
@@ -3384,34 +3393,28 @@ static void PSEC_xfer_delayed_add_results(psec_mac_add_del_map_t &map)
 static void PSEC_thread(vtss_addrword_t data)
 {
     psec_mac_add_del_map_t auto_mac_add_del_map;
-    u64                    next_timeout_ms, now_ms;
-    bool                   timed_out;
+    u64                    next_timeout_ms;
 
     while (1) {
         if (msg_switch_is_primary()) {
-            // We should timeout every one second (1000 ms)
-            next_timeout_ms = vtss::uptime_milliseconds() + 1000;
+            PSEC_CRIT_ENTER();
+            next_timeout_ms = PSEC_age_next_timeout_ms();
+            PSEC_CRIT_EXIT();
 
             while (msg_switch_is_primary()) {
                 if (!msg_switch_is_primary()) {
                     break;
                 }
 
+                // Sleep until the next entry's age or hold time runs out, or
+                // until we get signaled (MAC addresses to add/delete or an
+                // earlier age or hold time).
                 (void)vtss_flag_timed_wait(&PSEC_thread_wait_flag, 0xFFFFFFFF, VTSS_FLAG_WAITMODE_OR_CLR, VTSS_OS_MSEC2TICK(next_timeout_ms));
-                now_ms = vtss::uptime_milliseconds();
-
-                if (now_ms >= next_timeout_ms) {
-                    timed_out = true;
-                    next_timeout_ms += 1000;
-                } else {
-                    timed_out = false;
-                }
 
                 PSEC_CRIT_ENTER();
 
-                if (timed_out) {
-                    PSEC_do_age_or_hold();
-                }
+                PSEC_do_age_or_hold();
+                next_timeout_ms = PSEC_age_next_timeout_ms();
 
                 // Move current add/del map (empty as well as non-empty) to a
                 // local map, we can process without our mutex taken.
@@ -4219,6 +4222,8 @@ void psec_mgmt_fid_change(mesa_vid_t vid, mesa_vid_t old_fid, mesa_vid_t new_fid
                 mac_itr->second.in_mac_module = FALSE;
                 T_EG(TRACE_GRP_MAC_MODULE, "%s: mesa_mac_table_add() failed (rc = %s)", buf, error_txt(rc));
             }
+
+            mac_stats_table_changed();
         }
 
 next:
@@ -4375,7 +4380,10 @@ mesa_rc vtss_appl_psec_interface_status_mac_get_all(vtss_appl_psec_mac_status_ma
             continue;
         }
 
-        mac_status.insert(vtss::Pair<vtss_appl_psec_mac_map_key_t, vtss_appl_psec_mac_status_t>(mac_itr->first, mac_itr->second.status));
+        auto itr = mac_status.insert(vtss::Pair<vtss_appl_psec_mac_map_key_t, vtss_appl_psec_mac_status_t>(mac_itr->first, mac_itr->second.status));
+        if (itr.second) {
+            itr.first->second.age_or_hold_time_secs = PSEC_age_or_hold_get(mac_itr);
+        }
     }
 
     return VTSS_RC_OK;
@@ -4421,6 +4429,7 @@ mesa_rc vtss_appl_psec_interface_status_mac_get(vtss_ifindex_t ifindex, mesa_vid
         // A few fields need to be updated here, because they are not updated by this module otherwise.
         (void)misc_time2str_r(msg_abstime_get(VTSS_ISID_LOCAL, mac_itr->second.creation_time_secs), mac_status->creation_time);
         (void)misc_time2str_r(msg_abstime_get(VTSS_ISID_LOCAL, mac_itr->second.changed_time_secs),  mac_status->changed_time);
+        mac_status->age_or_hold_time_secs = PSEC_age_or_hold_get(mac_itr);
 
         mac_status->users_forward      = 0;
         mac_status->users_block        = 0;
@@ -0,0 +1,162 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#ifndef _PSEC_AGE_HXX_
+#define _PSEC_AGE_HXX_
+
+#include <stdint.h>
+#include <vtss/basics/deadline-index.hxx>
+
+/******************************************************************************/
+// psec_age_decision_t
+// The forwarding decision of a MAC entry as far as aging and holding goes.
+// Same order as psec_add_method_t.
+/******************************************************************************/
+typedef enum {
+    PSEC_AGE_DECISION_FORWARD,      // Aged with the age time
+    PSEC_AGE_DECISION_BLOCK,        // Held with the hold time
+    PSEC_AGE_DECISION_KEEP_BLOCKED, // Time doesn't run
+} psec_age_decision_t;
+
+/******************************************************************************/
+// psec_age_index_t
+// MAC entries that are subject to aging or holding, ordered by the time (in
+// seconds since boot) at which their age or hold time runs out. While an
+// entry is kept blocked, it's not in here and its remaining time is frozen in
+// its age_or_hold_time_secs.
+/******************************************************************************/
+template <typename KEY>
+struct psec_age_index_t : public vtss::DeadlineIndex<KEY> {
+    // Returns the number of seconds left of an entry's age or hold time, or 0
+    // if it's not subject to aging or holding. #age_or_hold_time_secs is that
+    // of the entry.
+    uint32_t left_get(const KEY &key, uint32_t age_or_hold_time_secs, uint32_t now) const
+    {
+        uint32_t expiry = this->get(key);
+
+        if (expiry == 0) {
+            // Either not aging/holding or kept blocked, in which case the time
+            // left is frozen.
+            return age_or_hold_time_secs;
+        }
+
+        // If it has already run out, the owner is about to handle it, so
+        // don't return 0 (which would mean that it's not aging/holding).
+        return expiry > now ? expiry - now : 1;
+    }
+
+    // Starts the age or hold time of an entry with #secs, which is stored in
+    // its #age_or_hold_time_secs. If #secs is 0, the entry is no longer
+    // aged/held. If the entry is kept blocked, the time doesn't run until
+    // start() is called again with it no longer kept blocked. Returns the
+    // expiry time, or 0 if the time isn't running.
+    uint32_t start(const KEY &key, uint32_t &age_or_hold_time_secs, uint32_t secs, bool kept_blocked, uint32_t now)
+    {
+        uint32_t expiry = secs != 0 && !kept_blocked ? now + secs : 0;
+
+        age_or_hold_time_secs = secs;
+        this->set(key, expiry);
+        return expiry;
+    }
+};
+
+/******************************************************************************/
+// psec_age_or_hold_chg()
+// Given an entry's forwarding decision going from #cur to #nxt with #left
+// seconds left of its age or hold time, tells whether the time must be
+// restarted, and if so, with which number of seconds (#secs). #cur is only
+// used if #in_table, that is, if the entry is already in the MAC table.
+// #age_frame_seen is set to true if the entry must be treated as if a frame
+// was seen in the current age period, and left untouched otherwise.
+/******************************************************************************/
+static inline bool psec_age_or_hold_chg(bool in_table, psec_age_decision_t cur, psec_age_decision_t nxt, uint32_t left, uint32_t age_time, uint32_t hold_time, uint32_t &secs, bool &age_frame_seen)
+{
+    if (!in_table || cur != PSEC_AGE_DECISION_FORWARD) {
+        // Brand new, or going from (keep) blocked.
+        switch (nxt) {
+        case PSEC_AGE_DECISION_FORWARD:
+            // Restart aging and pretend that a frame was seen in the current
+            // age period.
+            age_frame_seen = true;
+            secs = age_time;
+            return true;
+
+        case PSEC_AGE_DECISION_BLOCK:
+            if (in_table && cur == PSEC_AGE_DECISION_BLOCK && left <= hold_time) {
+                // Going from block to block. Keep going unless the new hold
+                // time is shorter.
+                return false;
+            }
+
+            secs = hold_time;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    switch (nxt) {
+    case PSEC_AGE_DECISION_FORWARD:
+        // Going from forwarding to forwarding. If the previous age period is
+        // greater than the new, then use the new (otherwise keep going from
+        // where the previous took off).
+        if ((left == 0 && age_time != 0) || left > age_time) {
+            secs = age_time;
+            return true;
+        }
+
+        return false;
+
+    case PSEC_AGE_DECISION_BLOCK:
+        secs = hold_time;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/******************************************************************************/
+// psec_age_expired_t
+// What to do with an entry whose age or hold time has run out.
+/******************************************************************************/
+typedef enum {
+    PSEC_AGE_EXPIRED_HOLD_TIMEOUT, // Blocked: Delete it.
+    PSEC_AGE_EXPIRED_FRAME_SEEN,   // Forwarding and a frame was seen: Age it again.
+    PSEC_AGE_EXPIRED_AGED_OUT,     // Forwarding and no frame seen: Delete it.
+} psec_age_expired_t;
+
+static inline psec_age_expired_t psec_age_expired_get(bool blocked, bool age_frame_seen)
+{
+    if (blocked) {
+        return PSEC_AGE_EXPIRED_HOLD_TIMEOUT;
+    }
+
+    return age_frame_seen ? PSEC_AGE_EXPIRED_FRAME_SEEN : PSEC_AGE_EXPIRED_AGED_OUT;
+}
+
+#endif /* _PSEC_AGE_HXX_ */
@@ -0,0 +1,398 @@
+/*
+ Copyright (c) 2006-2023 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Trace replay test (see trace_replay.hxx) of the aging/holding index
+// (psec_age.hxx), replaying a random trace of MAC address learning, frames,
+// forwarding decisions and age time changes against a model of the PSEC
+// module's MAC entries. Entries are aged or held in two ways:
+//   countdown: Every entry's remaining age/hold time is counted down once per
+//              second, which is what PSEC_do_age_or_hold() used to do.
+//   index    : Only entries whose age/hold time has run out are visited, like
+//              PSEC_thread() and PSEC_do_age_or_hold() do now.
+// Both runs must also report the same remaining age/hold times.
+// The count option is -m <MAC addresses> (default: 4000).
+
+#include "psec_age.hxx"
+#include "trace_replay.hxx"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef struct {
+    bool     blocked;
+    bool     kept_blocked;
+    bool     age_frame_seen;
+
+    // Like vtss_appl_psec_mac_status_t::age_or_hold_time_secs. Counted down by
+    // the countdown method. Only valid while not indexed by the index method.
+    uint32_t age_or_hold_time_secs;
+} test_mac_t;
+
+typedef struct {
+    bool                            use_index;
+    uint32_t                        now;
+    uint32_t                        age_time;
+    uint32_t                        hold_time;
+    std::map<uint32_t, test_mac_t>  macs;
+    psec_age_index_t<uint32_t>      age_index;
+    uint64_t                        visit_cnt;
+    uint64_t                        wakeup_cnt;
+    std::vector<std::string>        events;
+} test_state_t;
+
+static void test_event(test_state_t &s, uint32_t mac, const char *what)
+{
+    char buf[64];
+
+    snprintf(buf, sizeof(buf), "%6u %6u %s", s.now, mac, what);
+    s.events.push_back(buf);
+}
+
+// Like PSEC_age_or_hold_get()
+static uint32_t test_age_or_hold_get(test_state_t &s, uint32_t mac, const test_mac_t &m)
+{
+    if (!s.use_index) {
+        return m.age_or_hold_time_secs;
+    }
+
+    return s.age_index.left_get(mac, m.age_or_hold_time_secs, s.now);
+}
+
+// Like PSEC_age_or_hold_set()
+static void test_age_or_hold_set(test_state_t &s, uint32_t mac, test_mac_t &m, uint32_t secs)
+{
+    if (!s.use_index) {
+        m.age_or_hold_time_secs = secs;
+        return;
+    }
+
+    (void)s.age_index.start(mac, m.age_or_hold_time_secs, secs, m.kept_blocked, s.now);
+}
+
+static void test_mac_del(test_state_t &s, uint32_t mac, const char *what)
+{
+    test_event(s, mac, what);
+    s.age_index.del(mac);
+    s.macs.erase(mac);
+}
+
+static psec_age_decision_t test_decision(const test_mac_t &m)
+{
+    return m.kept_blocked ? PSEC_AGE_DECISION_KEEP_BLOCKED : m.blocked ? PSEC_AGE_DECISION_BLOCK : PSEC_AGE_DECISION_FORWARD;
+}
+
+// Like the age/hold time handling in PSEC_mac_chg(). #in_table is false for a
+// brand new entry.
+static void test_mac_chg(test_state_t &s, uint32_t mac, test_mac_t &m, bool in_table, psec_age_decision_t decision)
+{
+    bool     kept_blocked   = m.kept_blocked, age_frame_seen = false;
+    uint32_t secs;
+
+    if (psec_age_or_hold_chg(in_table, test_decision(m), decision, in_table ? test_age_or_hold_get(s, mac, m) : 0, s.age_time, s.hold_time, secs, age_frame_seen)) {
+        if (age_frame_seen) {
+            m.age_frame_seen = true;
+        }
+
+        test_age_or_hold_set(s, mac, m, secs);
+    }
+
+    m.blocked      = decision != PSEC_AGE_DECISION_FORWARD;
+    m.kept_blocked = decision == PSEC_AGE_DECISION_KEEP_BLOCKED;
+
+    if (in_table && m.kept_blocked != kept_blocked) {
+        // Like PSEC_age_or_hold_update()
+        test_age_or_hold_set(s, mac, m, test_age_or_hold_get(s, mac, m));
+    }
+}
+
+// Like the handling of an entry whose age or hold time has run out in
+// PSEC_do_age_or_hold()
+static void test_mac_expired(test_state_t &s, uint32_t mac, test_mac_t &m)
+{
+    s.visit_cnt++;
+    m.age_or_hold_time_secs = 0;
+
+    switch (psec_age_expired_get(m.blocked, m.age_frame_seen)) {
+    case PSEC_AGE_EXPIRED_HOLD_TIMEOUT:
+        test_mac_del(s, mac, "hold-timeout");
+        break;
+
+    case PSEC_AGE_EXPIRED_FRAME_SEEN:
+        test_event(s, mac, "age-timeout, frame seen");
+        test_mac_chg(s, mac, m, true, PSEC_AGE_DECISION_FORWARD);
+        m.age_frame_seen = false;
+        break;
+
+    case PSEC_AGE_EXPIRED_AGED_OUT:
+        test_mac_del(s, mac, "age-timeout, frame not seen");
+        break;
+    }
+}
+
+// What PSEC_do_age_or_hold() used to do every second.
+static void test_countdown_tick(test_state_t &s)
+{
+    std::vector<uint32_t> expired;
+
+    s.wakeup_cnt++;
+
+    for (auto &e : s.macs) {
+        s.visit_cnt++;
+
+        if (e.second.age_or_hold_time_secs == 0 || e.second.kept_blocked) {
+            continue;
+        }
+
+        if (--e.second.age_or_hold_time_secs == 0) {
+            expired.push_back(e.first);
+        }
+    }
+
+    for (auto mac : expired) {
+        // Undo the visit counted above, since test_mac_expired() counts it.
+        s.visit_cnt--;
+        test_mac_expired(s, mac, s.macs[mac]);
+    }
+}
+
+// What PSEC_do_age_or_hold() does now.
+static void test_index_tick(test_state_t &s)
+{
+    uint32_t mac;
+
+    s.wakeup_cnt++;
+
+    while (s.age_index.expired_get(s.now, mac)) {
+        auto itr = s.macs.find(mac);
+
+        if (itr == s.macs.end()) {
+            fprintf(stderr, "MAC %u not found\n", mac);
+            exit(1);
+        }
+
+        test_mac_expired(s, mac, itr->second);
+    }
+}
+
+typedef enum {
+    TEST_OP_LEARN,
+    TEST_OP_FRAME,
+    TEST_OP_DECISION,
+    TEST_OP_DEL,
+    TEST_OP_AGE_TIME,
+} test_op_t;
+
+typedef struct {
+    uint32_t            now;
+    test_op_t           op;
+    uint32_t            mac;
+    psec_age_decision_t decision;
+    uint32_t            secs;
+} test_trace_t;
+
+static void test_apply(test_state_t &s, const test_trace_t &t)
+{
+    auto itr = s.macs.find(t.mac);
+
+    switch (t.op) {
+    case TEST_OP_LEARN:
+        if (itr == s.macs.end()) {
+            test_mac_t m = {};
+
+            itr = s.macs.insert(std::make_pair(t.mac, m)).first;
+            test_mac_chg(s, t.mac, itr->second, false, t.decision);
+        }
+
+        break;
+
+    case TEST_OP_FRAME:
+        if (itr != s.macs.end() && !itr->second.blocked) {
+            itr->second.age_frame_seen = true;
+        }
+
+        break;
+
+    case TEST_OP_DECISION:
+        if (itr != s.macs.end()) {
+            test_mac_chg(s, t.mac, itr->second, true, t.decision);
+        }
+
+        break;
+
+    case TEST_OP_DEL:
+        if (itr != s.macs.end()) {
+            test_mac_del(s, t.mac, "deleted");
+        }
+
+        break;
+
+    case TEST_OP_AGE_TIME:
+        // Changing the age or hold time updates all entries
+        s.age_time = t.secs;
+        for (auto &e : s.macs) {
+            s.visit_cnt++;
+            test_mac_chg(s, e.first, e.second, true, test_decision(e.second));
+        }
+
+        break;
+    }
+}
+
+static void test_run(test_state_t &s, const std::vector<test_trace_t> &trace, uint32_t seconds)
+{
+    size_t i = 0;
+
+    s.age_time  = 300;
+    s.hold_time = 120;
+
+    for (s.now = 1; s.now <= seconds; s.now++) {
+        if (s.use_index) {
+            // Only wake up when the earliest entry expires.
+            uint32_t expiry = s.age_index.next_get();
+
+            if (expiry != 0 && expiry <= s.now) {
+                test_index_tick(s);
+            }
+        } else {
+            test_countdown_tick(s);
+        }
+
+        for (; i < trace.size() && trace[i].now == s.now; i++) {
+            test_apply(s, trace[i]);
+        }
+
+        // Sample the remaining time of a few entries.
+        auto itr = s.macs.lower_bound(s.now * 7919 % 65536);
+        for (int cnt = 0; itr != s.macs.end() && cnt < 4; ++itr, ++cnt) {
+            char buf[32];
+
+            snprintf(buf, sizeof(buf), "left %u", test_age_or_hold_get(s, itr->first, itr->second));
+            test_event(s, itr->first, buf);
+        }
+    }
+
+    // Back to the last second of the trace for the final comparison.
+    s.now--;
+}
+
+int main(int argc, char *argv[])
+{
+    test_state_t              countdown = {}, index = {};
+    std::vector<test_trace_t> trace;
+    test_trace_t              t;
+    trace_replay_opts_t       o;
+    uint32_t                  e, i;
+
+    o.cnt = 4000;
+    if (!trace_replay_opts_get(argc, argv, 'm', "MAC addresses", o)) {
+        return 1;
+    }
+
+    if (o.cnt == 0 || o.cnt > 65536) {
+        o.cnt = 4000;
+    }
+
+    // The trace starts with all MAC addresses being learned during the first
+    // minute, mostly forwarding, followed by random frames, forwarding
+    // decisions, deletions and re-learning, and now and then an age time
+    // change. Most stations keep sending frames, so most entries stay.
+    for (i = 0; i < o.cnt; i++) {
+        t.now      = 1 + rand() % 60;
+        t.op       = TEST_OP_LEARN;
+        t.mac      = i;
+        t.decision = rand() % 10 == 0 ? PSEC_AGE_DECISION_BLOCK : PSEC_AGE_DECISION_FORWARD;
+        t.secs     = 0;
+        trace.push_back(t);
+    }
+
+    std::stable_sort(trace.begin(), trace.end(), [](const test_trace_t &a, const test_trace_t &b) {
+        return a.now < b.now;
+    });
+
+    for (t.now = 61; t.now <= o.seconds; t.now++) {
+        for (e = 0; e < o.events_per_sec; e++) {
+            t.mac      = rand() % o.cnt;
+            t.decision = (psec_age_decision_t)(rand() % 3);
+
+            switch (rand() % 20) {
+            case 0:
+                t.op = TEST_OP_DEL;
+                break;
+
+            case 1:
+            case 2:
+                t.op = TEST_OP_LEARN;
+                break;
+
+            case 3:
+            case 4:
+                t.op = TEST_OP_DECISION;
+                break;
+
+            default:
+                t.op = TEST_OP_FRAME;
+                break;
+            }
+
+            trace.push_back(t);
+        }
+
+        if (t.now % 900 == 0) {
+            t.op   = TEST_OP_AGE_TIME;
+            t.secs = rand() % 4 == 0 ? 0 : 60 + rand() % 600;
+            trace.push_back(t);
+        }
+    }
+
+    countdown.use_index = false;
+    index.use_index     = true;
+
+    test_run(countdown, trace, o.seconds);
+    test_run(index,     trace, o.seconds);
+
+    if (!trace_replay_compare(trace.size(), "MAC addresses", o,
+                              {"countdown", countdown.visit_cnt, countdown.wakeup_cnt, &countdown.events, countdown.macs.size()},
+                              {"index",     index.visit_cnt,     index.wakeup_cnt,     &index.events,     index.macs.size()})) {
+        return 1;
+    }
+
+    for (const auto &m : countdown.macs) {
+        auto itr = index.macs.find(m.first);
+
+        if (itr == index.macs.end() ||
+            m.second.blocked != itr->second.blocked ||
+            m.second.kept_blocked != itr->second.kept_blocked ||
+            m.second.age_frame_seen != itr->second.age_frame_seen ||
+            test_age_or_hold_get(countdown, m.first, m.second) != test_age_or_hold_get(index, itr->first, itr->second)) {
+            fprintf(stderr, "MAC %u differs\n", m.first);
+            return 1;
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
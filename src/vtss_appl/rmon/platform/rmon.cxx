@@ -51,7 +51,7 @@
 #include "rmon_api.h"
 #include "misc_api.h"
 #include "msg_api.h"  // msg_switch_exists(), msg_switch_configurable()
-#include "port_api.h" // port_count_max()
+#include "port_api.h" // port_count_max(), port_counters_delta_get()
 #include <vtss_module_id.h>
 #include <vtss_trace_lvl_api.h>
 
@@ -375,9 +375,12 @@ void rmon_create_stat_default_entry(void)
     }
 }
 
-static BOOL update_etherStatsTable_entry(vtss_isid_t isid, mesa_port_no_t port_idx, ETH_STATS_T *table_entry_p)
+/* With a non-zero history_index, the counters are those counted since the
+ * previous call for that history entry rather than the absolute ones. */
+static BOOL update_etherStatsTable_entry(vtss_isid_t isid, mesa_port_no_t port_idx, u_long history_index, ETH_STATS_T *table_entry_p)
 {
-    mesa_port_counters_t counters;
+    mesa_port_counters_t  counters;
+    port_counters_delta_t delta;
 
     if (!msg_switch_configurable(isid)) {
         /* if the switch is not configurable, the counters always equal 0 */
@@ -390,7 +393,17 @@ static BOOL update_etherStatsTable_entry(vtss_isid_t isid, mesa_port_no_t port_i
         return FALSE;
     };
 
-    if (!msg_switch_exists(isid) || vtss_appl_port_statistics_get(ifindex, &counters) != VTSS_RC_OK) {
+    if (!msg_switch_exists(isid)) {
+        return FALSE;
+    }
+
+    if (history_index) {
+        if (port_counters_delta_get(VTSS_MODULE_ID_RMON, history_index, port_idx, &delta) != VTSS_RC_OK) {
+            return FALSE;
+        }
+
+        counters = delta.counters;
+    } else if (vtss_appl_port_statistics_get(ifindex, &counters) != VTSS_RC_OK) {
         return FALSE;
     }
 
@@ -415,7 +428,7 @@ static BOOL update_etherStatsTable_entry(vtss_isid_t isid, mesa_port_no_t port_i
     return TRUE;
 }
 
-BOOL get_etherStatsTable_entry(VAR_OID_T *data_source, ETH_STATS_T *table_entry_p)
+static BOOL get_ether_stats(VAR_OID_T *data_source, u_long history_index, ETH_STATS_T *table_entry_p)
 {
 #ifdef VTSS_SW_OPTION_AGGR
     vtss_isid_t              isid;
@@ -436,7 +449,7 @@ BOOL get_etherStatsTable_entry(VAR_OID_T *data_source, ETH_STATS_T *table_entry_
 
     switch (table_info.type) {
     case IFTABLE_IFINDEX_TYPE_PORT:
-        if (update_etherStatsTable_entry(table_info.isid, table_info.if_id, table_entry_p) == FALSE) {
+        if (update_etherStatsTable_entry(table_info.isid, table_info.if_id, history_index, table_entry_p) == FALSE) {
             return FALSE;
         }
         break;
@@ -454,7 +467,7 @@ BOOL get_etherStatsTable_entry(VAR_OID_T *data_source, ETH_STATS_T *table_entry_
             if (!aggr_members.entry.member[port_idx]) {
                 continue;
             }
-            if (update_etherStatsTable_entry(table_info.isid, port_idx, table_entry_p) == FALSE) {
+            if (update_etherStatsTable_entry(table_info.isid, port_idx, history_index, table_entry_p) == FALSE) {
                 return FALSE;
             }
         }
@@ -472,7 +485,7 @@ BOOL get_etherStatsTable_entry(VAR_OID_T *data_source, ETH_STATS_T *table_entry_
                 if (!aggr_members.entry.member[port_idx]) {
                     continue;
                 }
-                if (update_etherStatsTable_entry(isid, port_idx, table_entry_p) == FALSE) {
+                if (update_etherStatsTable_entry(isid, port_idx, history_index, table_entry_p) == FALSE) {
                     return FALSE;
                 }
             }
@@ -488,6 +501,11 @@ BOOL get_etherStatsTable_entry(VAR_OID_T *data_source, ETH_STATS_T *table_entry_
     return TRUE;
 }
 
+BOOL get_etherStatsTable_entry(VAR_OID_T *data_source, ETH_STATS_T *table_entry_p)
+{
+    return get_ether_stats(data_source, 0, table_entry_p);
+}
+
 
 #endif /* RFC2819_SUPPORTED_STATISTICS */
 
@@ -536,31 +554,13 @@ static BOOL history_delete_all_flag = FALSE;
  * history row management control callbacks
  */
 
-static void
-compute_delta(ETH_STATS_T *delta,
-              ETH_STATS_T *newval, ETH_STATS_T *prevval)
-{
-#define CNT_DIF(X) delta->X = (newval->X >= prevval->X) ? (newval->X - prevval->X) : newval->X
-
-    CNT_DIF(octets);
-    CNT_DIF(packets);
-    CNT_DIF(bcast_pkts);
-    CNT_DIF(mcast_pkts);
-    CNT_DIF(crc_align);
-    CNT_DIF(undersize);
-    CNT_DIF(oversize);
-    CNT_DIF(fragments);
-    CNT_DIF(jabbers);
-    CNT_DIF(collisions);
-}
-
 static void
 history_get_backet(unsigned int clientreg, void *clientarg)
 {
     RMON_ENTRY_T         *hdr_ptr;
     HISTORY_CRTL_ENTRY_T *body;
     HISTORY_DATA_ENTRY_T *bptr;
-    ETH_STATS_T          newSample;
+    ETH_STATS_T          delta;
 
     /*
      * ag_trace ("history_get_backet: timer_id=%d", (int) clientreg);
@@ -590,8 +590,9 @@ history_get_backet(unsigned int clientreg, void *clientarg)
         return;
     }
 
-    /* SYSTEM_get_eth_statistics(&body->data_source, &newSample); */
-    if (!get_etherStatsTable_entry(&body->data_source, &newSample)) {
+    /* The port module keeps the previous sample of each port per history
+     * entry, so this is the change since the previous bucket. */
+    if (!get_ether_stats(&body->data_source, hdr_ptr->ctrl_index, &delta)) {
         return;
     }
 
@@ -612,8 +613,7 @@ history_get_backet(unsigned int clientreg, void *clientarg)
 
     bptr->start_interval = body->previous_bucket.start_interval;
 
-    compute_delta(&bptr->EthData, &newSample,
-                  &body->previous_bucket.EthData);
+    bptr->EthData = delta;
 
     bptr->utilization =
         bptr->EthData.octets * 8 + bptr->EthData.packets * (96 + 64);
@@ -623,8 +623,6 @@ history_get_backet(unsigned int clientreg, void *clientarg)
      * update previous_bucket
      */
     body->previous_bucket.start_interval = AGUTIL_sys_up_time();
-    memcpy(&body->previous_bucket.EthData, &newSample,
-           sizeof(ETH_STATS_T));
 }
 
 /*
@@ -720,10 +718,11 @@ history_Activate(RMON_ENTRY_T *eptr)
                         body->scrlr.data_requested,
                         (u_char)(RMON1_ENTRY_VALID == eptr->status) );
 
-    /* SYSTEM_get_eth_statistics(&body->data_source,
-                              &body->previous_bucket.EthData); */
-    (void)get_etherStatsTable_entry(&body->data_source,
-                                    &body->previous_bucket.EthData);
+    /* Take the first sample of the data source's ports, which the first
+     * bucket is counted from. */
+    port_counters_delta_free(VTSS_MODULE_ID_RMON, eptr->ctrl_index);
+    (void)get_ether_stats(&body->data_source, eptr->ctrl_index,
+                          &body->previous_bucket.EthData);
     body->previous_bucket.start_interval = AGUTIL_sys_up_time();
 
     body->scrlr.current_data_ptr = body->scrlr.first_data_ptr;
@@ -744,6 +743,7 @@ history_Deactivate(RMON_ENTRY_T *eptr)
     if (body->timer_id != 0) {
         ROWAPI_alarm_unregister(body->timer_id);
     }
+    port_counters_delta_free(VTSS_MODULE_ID_RMON, eptr->ctrl_index);
     /*
      * ag_trace ("Dbg: unregistered in history_Deactivate timer_id=%d",
      * (int) body->timer_id);
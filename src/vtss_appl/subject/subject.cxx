@@ -34,6 +34,8 @@
 #include <vtss/basics/notifications.hxx>
 #include <vtss/basics/notifications/process.hxx>
 #include "vtss_trace_api.h"
+#include "subject_api.h"
+#include "icli_api.h"
 
 static init_cmd_t local_init_state;
 
@@ -161,6 +163,51 @@ SubjectRunner &subject_runner_get(vtss_thread_prio_t prio,
 }  // notifications
 }  // vtss
 
+static void subject_debug_lock_print_runner(u32 session_id,
+                                            vtss::notifications::SubjectRunner *sr,
+                                            bool clear)
+{
+    const vtss::notifications::SubjectLock &l = sr->event_lock_get();
+
+    ICLI_PRINTF("%-23s " VPRI64Fu("20") " " VPRI64Fu("20") "\n", sr->name, l.acquired(), l.contended());
+
+    if (clear) {
+        sr->event_lock_counters_clear();
+    }
+}
+
+void subject_debug_lock_print(u32 session_id, bool clear)
+{
+    using namespace vtss::notifications;
+
+    ICLI_PRINTF("Runner                              Acquired            Contended\n");
+    ICLI_PRINTF("----------------------- -------------------- --------------------\n");
+
+    // The runners are never deleted, so they can be inspected without locking.
+    // Default priority runners are present in both arrays once started.
+    subject_debug_lock_print_runner(session_id, &subject_main_thread, clear);
+    subject_debug_lock_print_runner(session_id, &subject_locked_thread, clear);
+    for (auto e : sr_prio) {
+        if (e && e != &subject_locked_thread) {
+            subject_debug_lock_print_runner(session_id, e, clear);
+        }
+    }
+
+    for (auto e : sr_prio_unlock_on_cb) {
+        if (e && e != &subject_main_thread) {
+            subject_debug_lock_print_runner(session_id, e, clear);
+        }
+    }
+
+    ICLI_PRINTF("\nContended (all subject and runner locks): " VPRI64u "\n", SubjectLock::contended_total());
+
+    if (clear) {
+        SubjectLock::contended_total_clear();
+    }
+}
+
+extern "C" int subject_icli_cmd_register();
+
 extern "C" mesa_rc vtss_subject_init(vtss_init_data_t *data)
 {
     using namespace vtss::notifications;
@@ -170,6 +217,10 @@ extern "C" mesa_rc vtss_subject_init(vtss_init_data_t *data)
 
     local_init_state = data->cmd;
 
+    if (data->cmd == INIT_CMD_INIT) {
+        subject_icli_cmd_register();
+    }
+
     if (data->cmd == INIT_CMD_START) {
         VTSS_TRACE(DEBUG) << "Start";
         subject_main_thread.prio = VTSS_THREAD_PRIO_DEFAULT;
@@ -36,6 +36,9 @@ extern "C" {
 
 mesa_rc vtss_subject_init(vtss_init_data_t *data);
 
+// Print the lock counters of all subject runners, and optionally clear them.
+void subject_debug_lock_print(u32 session_id, bool clear);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,294 @@
+/*
+ Copyright (c) 2006-2024 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Stress test of the per-runner and per-subject locks. A number of subject
+// runners observe a number of subjects, which are updated concurrently by a
+// number of publisher threads. At the same time, timers are added to and
+// removed from the runners from other threads, and events are attached to and
+// detached from the subjects.
+//
+// Each observer must see the values of a subject in non-decreasing order and
+// must end up seeing the final value of each subject.
+//
+// Lock contention is printed at the end. Set SUBJECT_LOCK_TEST_BIG=1 to scale
+// up the number of runners, subjects and threads.
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include <vtss/basics/notifications/event-fd.hxx>
+#include <vtss/basics/notifications/event-handler.hxx>
+#include <vtss/basics/notifications/subject-lock.hxx>
+#include <vtss/basics/notifications/subject-read-only.hxx>
+#include <vtss/basics/notifications/subject-runner.hxx>
+#include "catch.hpp"
+
+using namespace vtss::notifications;
+
+namespace {
+
+struct Publisher : public SubjectReadOnly<uint32_t> {
+    Publisher() : SubjectReadOnly<uint32_t>(0) {}
+
+    // Increment the value. Done under the subject lock so that concurrent
+    // publishers do not lose updates.
+    void inc() {
+        SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
+        set(value_ + 1);
+    }
+
+    const SubjectLock &lock() const { return subject_lock; }
+};
+
+struct Observer : public EventHandler {
+    Observer(SubjectRunner *sr, Publisher *p) : EventHandler(sr), e(this), p(p) {}
+
+    void start() { last = p->get(e); }
+
+    void execute(Event *ev) override {
+        uint32_t v = p->get(ev, e);
+        if (v < last) out_of_order++;
+        last = v;
+        executed++;
+    }
+
+    Event e;
+    Publisher *p;
+    std::atomic<uint32_t> last{0};
+    uint32_t out_of_order = 0;
+    uint32_t executed = 0;
+};
+
+// Keeps a runner alive until told to stop, and has timers added and deleted
+// from other threads.
+struct Runner : public EventHandler {
+    Runner(int i)
+        : EventHandler(&sr),
+          name("runner-" + std::to_string(i)),
+          sr(name.c_str(), 1, true),
+          keep_alive(this) {}
+
+    void execute(Timer *t) override {
+        if (t == &keep_alive) {
+            if (!stop) sr.timer_add(keep_alive, vtss::milliseconds(1));
+        } else {
+            timer_cnt++;
+        }
+    }
+
+    void start() {
+        sr.timer_add(keep_alive, vtss::milliseconds(1));
+        thread = std::thread([this]() { sr.run(true); });
+    }
+
+    std::string name;
+    SubjectRunner sr;
+    Timer keep_alive;
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> timer_cnt{0};
+    std::thread thread;
+};
+
+}  // namespace
+
+TEST_CASE("subject locks", "[subject]") {
+    bool big = getenv("SUBJECT_LOCK_TEST_BIG") != nullptr;
+    const int runner_cnt = big ? 32 : 8;
+    const int subject_cnt = big ? 64 : 16;
+    const int publisher_cnt = big ? 16 : 4;
+    const int update_cnt = big ? 100000 : 20000;
+
+    std::vector<std::unique_ptr<Runner>> runners;
+    std::vector<std::unique_ptr<Publisher>> subjects;
+    std::vector<std::unique_ptr<Observer>> observers;
+    std::vector<std::unique_ptr<Timer>> timers;
+    std::vector<std::thread> threads;
+    std::atomic<bool> done{false};
+
+    SubjectLock::contended_total_clear();
+
+    for (int i = 0; i < runner_cnt; ++i)
+        runners.emplace_back(new Runner(i));
+    for (int i = 0; i < subject_cnt; ++i)
+        subjects.emplace_back(new Publisher());
+
+    // Every runner observes every subject
+    for (auto &r : runners)
+        for (auto &s : subjects)
+            observers.emplace_back(new Observer(&r->sr, s.get()));
+
+    for (auto &o : observers) o->start();
+    for (auto &r : runners) r->start();
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < publisher_cnt; ++i) {
+        threads.emplace_back([&, i]() {
+            std::mt19937 rnd(i);
+            for (int n = 0; n < update_cnt; ++n)
+                subjects[rnd() % subject_cnt]->inc();
+        });
+    }
+
+    // Attach and detach events without a handler, and have them destroyed
+    // while attached.
+    threads.emplace_back([&]() {
+        std::mt19937 rnd(1000);
+        while (!done) {
+            Event e1, e2;
+            subjects[rnd() % subject_cnt]->get(e1);
+            subjects[rnd() % subject_cnt]->attach(e2);
+            subjects[rnd() % subject_cnt]->get(e1);
+            subjects[rnd() % subject_cnt]->detach(e2);
+        }
+    });
+
+    // Add and delete timers on the runners from a foreign thread. The timers
+    // must outlive the runners, as a runner may be executing a timer while it
+    // is deleted.
+    for (int i = 0; i < runner_cnt; ++i)
+        timers.emplace_back(new Timer(runners[i].get()));
+
+    threads.emplace_back([&]() {
+        std::mt19937 rnd(2000);
+        while (!done) {
+            int i = rnd() % runner_cnt;
+            switch (rnd() % 3) {
+            case 0:
+                runners[i]->sr.timer_add(*timers[i], vtss::milliseconds(rnd() % 3));
+                break;
+            case 1:
+                runners[i]->sr.timer_del(*timers[i]);
+                break;
+            default:
+                timers[i]->unlink();
+                break;
+            }
+        }
+
+        for (int i = 0; i < runner_cnt; ++i)
+            runners[i]->sr.timer_del(*timers[i]);
+    });
+
+    // Move a file descriptor between the runners from two threads at a time.
+    // The pipe is never written, so the runners never execute it.
+    int pipe_fds[2];
+    REQUIRE(pipe(pipe_fds) == 0);
+    EventFd efd(nullptr, vtss::Fd(pipe_fds[0]));
+
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 rnd(3000 + t);
+            while (!done) {
+                runners[rnd() % runner_cnt]->sr.event_fd_add(efd, EventFd::READ);
+                if (rnd() & 1) efd.unsubscribe();
+            }
+        });
+    }
+
+    for (int i = 0; i < publisher_cnt; ++i) threads[i].join();
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    // Wait for all observers to catch up
+    for (int w = 0; w < 1000; ++w) {
+        bool all = true;
+        for (auto &o : observers)
+            if (o->last != o->p->get()) all = false;
+        if (all) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    done = true;
+    for (size_t i = publisher_cnt; i < threads.size(); ++i) threads[i].join();
+
+    efd.close();
+    close(pipe_fds[1]);
+
+    for (auto &r : runners) r->stop = true;
+    for (auto &r : runners) r->thread.join();
+
+    uint32_t total = 0;
+    for (auto &s : subjects) total += s->get();
+    CHECK(total == (uint32_t)(publisher_cnt * update_cnt));
+
+    for (auto &o : observers) {
+        CHECK(o->out_of_order == 0);
+        CHECK(o->last == o->p->get());
+    }
+
+    uint64_t subject_acquired = 0, subject_contended = 0;
+    for (auto &s : subjects) {
+        subject_acquired += s->lock().acquired();
+        subject_contended += s->lock().contended();
+    }
+
+    std::cout << "Runners: " << runner_cnt << " subjects: " << subject_cnt
+              << " publishers: " << publisher_cnt
+              << " updates: " << publisher_cnt * update_cnt << " in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()
+              << " ms" << std::endl;
+    for (auto &r : runners) {
+        std::cout << r->name
+                  << " acquired: " << r->sr.event_lock_get().acquired()
+                  << " contended: " << r->sr.event_lock_get().contended()
+                  << std::endl;
+    }
+    std::cout << "subjects acquired: " << subject_acquired
+              << " contended: " << subject_contended << std::endl;
+    std::cout << "Contended total: " << SubjectLock::contended_total()
+              << std::endl;
+
+    // Detach the observers before the subjects go away
+    observers.clear();
+}
+
+TEST_CASE("timer copy", "[subject]") {
+    Runner r(0);
+    Timer t(&r), u(&r);
+
+    r.sr.timer_add(t, vtss::milliseconds(100));
+    REQUIRE(t.is_linked());
+
+    // A copy must not share the links of the original
+    Timer c(t);
+    CHECK(!c.is_linked());
+    CHECK(t.is_linked());
+
+    // Assigning to a linked timer unlinks it
+    r.sr.timer_add(u, vtss::milliseconds(100));
+    u = c;
+    CHECK(!u.is_linked());
+
+    r.sr.timer_del(t);
+    CHECK(!t.is_linked());
+}
@@ -26,7 +26,8 @@
 
 #include "main.h"
 #include <unistd.h>
-#include "vtss/basics/list.hxx"
+#include <pthread.h>
+#include "vtss/basics/intrusive_list.hxx"
 #include "vtss/basics/map.hxx"
 #include "vtss/basics/time_unit.hxx"
 #include "vtss/basics/vector.hxx"
@@ -66,49 +67,48 @@ VTSS_TRACE_REGISTER(&trace_reg, trace_grps);
 /****************************************************************************/
 // Vitesse timer implementation using vtss_basics
 /****************************************************************************/
-static  vtss::List<vtss::Timer *> TIMER_list;
-typedef vtss::List<vtss::Timer *>::iterator timer_list_iterator_t;
+// The list only serves timer_debug_print(), so it has its own lock rather
+// than the global one, which ~Timer() would otherwise take on every timer
+// destruction. Statically initialized, because timers may be started or
+// destructed before vtss_timer_init() is called.
+static pthread_mutex_t                            TIMER_list_mutex = PTHREAD_MUTEX_INITIALIZER;
+static vtss::intrusive::List<vtss::TimerListNode> TIMER_list;
+
 static void TIMER_add(vtss::Timer *timer)
 {
-    vtss_global_lock(__FILE__, __LINE__);
-
-    timer_list_iterator_t itr = vtss::find(TIMER_list.begin(), TIMER_list.end(), timer);
+    pthread_mutex_lock(&TIMER_list_mutex);
 
-    if (itr == TIMER_list.end()) {
-        TIMER_list.push_back(timer);
+    if (!timer->list_node.is_linked()) {
+        // The node may have been copied from another timer's.
+        timer->list_node.timer = timer;
+        TIMER_list.push_back(timer->list_node);
     }
 
-    vtss_global_unlock(__FILE__, __LINE__);
+    pthread_mutex_unlock(&TIMER_list_mutex);
 }
 
 void vtss::TIMER_del(vtss::Timer *timer)
 {
-    vtss_global_lock(__FILE__, __LINE__);
-
-    timer_list_iterator_t itr = vtss::find(TIMER_list.begin(), TIMER_list.end(), timer);
-
-    if (itr != TIMER_list.end()) {
-        TIMER_list.erase(itr);
-    }
-
-    vtss_global_unlock(__FILE__, __LINE__);
+    pthread_mutex_lock(&TIMER_list_mutex);
+    TIMER_list.unlink(timer->list_node);
+    pthread_mutex_unlock(&TIMER_list_mutex);
 }
 
 #include "icli_api.h"
 void timer_debug_print(u32 session_id)
 {
     u32 cnt = 0;
-    vtss_global_lock(__FILE__, __LINE__);
+    pthread_mutex_lock(&TIMER_list_mutex);
 
     ICLI_PRINTF("Module                  Repeat Period [ms] Count\n");
     ICLI_PRINTF("----------------------- ------ ----------- ----------\n");
 
-    for (timer_list_iterator_t itr = TIMER_list.begin(); itr != TIMER_list.end(); ++itr) {
+    for (auto &n : TIMER_list) {
         ICLI_PRINTF("%-23s %-6s " VPRI64Fu("11") " %10u\n",
-                    vtss_module_names[(*itr)->modid],
-                    (*itr)->get_repeat() ? "Yes" : "No",
-                    vtss::to_milliseconds((*itr)->get_period()).raw(),
-                    (*itr)->total_cnt);
+                    vtss_module_names[n.timer->modid],
+                    n.timer->get_repeat() ? "Yes" : "No",
+                    vtss::to_milliseconds(n.timer->get_period()).raw(),
+                    n.timer->total_cnt);
         cnt++;
     }
 
@@ -116,7 +116,7 @@ void timer_debug_print(u32 session_id)
         ICLI_PRINTF("<none>\n");
     }
 
-    vtss_global_unlock(__FILE__, __LINE__);
+    pthread_mutex_unlock(&TIMER_list_mutex);
 }
 
 mesa_rc vtss_timer_start(vtss::Timer *timer)
@@ -172,14 +172,13 @@ struct TimerTestTimerState {
         t.set_period(interval);
         t.callback = timer_test_callback;
         t.set_repeat(true);
-
-        (void)vtss_timer_start(&t);
     }
 
     vtss::Timer t;
     uint32_t itr = 0;
     uint32_t itr_cnt;
     vtss::milliseconds duration;
+    vtss::LinuxClock::time_point started;
     vtss::Vector<vtss::LinuxClock::time_point> start_of_execution;
     vtss::Vector<vtss::LinuxClock::time_point> end_of_execution;
 
@@ -203,7 +202,7 @@ void timer_test_callback(vtss::Timer *t)
 struct TimerTestState {
     TimerTestState(uint32_t cnt, uint32_t itr, vtss::milliseconds duration,
                    vtss::milliseconds interval, vtss_thread_prio_t prio) :
-        timers(cnt)
+        timers(cnt), interval(interval)
     {
         for (uint32_t i = 0; i < cnt; ++i) {
             timers.push_back(vtss::make_unique<TimerTestTimerState>(itr,
@@ -211,9 +210,21 @@ struct TimerTestState {
                                                                     interval,
                                                                     prio));
         }
+
+        // Start them all in one go, so that the time it takes can be measured
+        // as a function of the number of timers.
+        auto start = vtss::LinuxClock::now();
+        for (auto &e : timers) {
+            e->started = vtss::LinuxClock::now();
+            (void)vtss_timer_start(&e->t);
+        }
+
+        start_ns = vtss::LinuxClock::to_nanoseconds(vtss::LinuxClock::now() - start).raw() / (cnt ? cnt : 1);
     };
 
     vtss::Vector<std::unique_ptr<TimerTestTimerState>> timers;
+    vtss::milliseconds interval;
+    uint32_t start_ns;
 };
 
 static uint32_t timer_test_handle = 0;
@@ -249,6 +260,8 @@ timer_test_status vtss_timer_test_status(uint32_t handle)
     h.completed = 1;
 
     h.period.min = (uint32_t) - 1;
+    h.late.min = (uint32_t) - 1;
+    h.start_ns = p->start_ns;
 
     for (auto &e : p->timers) {
         if (e->itr < h.min_itr_cnt) {
@@ -277,6 +290,22 @@ timer_test_status vtss_timer_test_status(uint32_t handle)
             h.completed = 0;
         }
 
+        if (e->start_of_execution.size()) {
+            auto expected = e->started + std::chrono::milliseconds(p->interval.raw());
+            auto late = e->start_of_execution[0] > expected ? vtss::LinuxClock::to_microseconds(e->start_of_execution[0] - expected).raw32() : 0;
+
+            if (late < h.late.min) {
+                h.late.min = late;
+            }
+
+            if (late > h.late.max) {
+                h.late.max = late;
+            }
+
+            h.late.cnt += 1;
+            h.late.mean += late;
+        }
+
         if (e->start_of_execution.size() && e->end_of_execution.size()) {
             auto a = e->start_of_execution[0];
             auto b = e->end_of_execution[e->end_of_execution.size() - 1];
@@ -291,9 +320,63 @@ timer_test_status vtss_timer_test_status(uint32_t handle)
         h.period.mean = h.period.mean / h.period.cnt;
     }
 
+    if (h.late.cnt != 0) {
+        h.late.mean = h.late.mean / h.late.cnt;
+    }
+
     return h;
 }
 
+static void timer_bench_callback(vtss::Timer *timer)
+{
+}
+
+void vtss_timer_test_bench(u32 session_id, uint32_t max_cnt)
+{
+    uint32_t rnd = 1, cnt;
+
+    ICLI_PRINTF("Timers     Start [ns] Restart [ns] Cancel [ns]\n");
+    ICLI_PRINTF("---------- ---------- ------------ -----------\n");
+
+    for (cnt = 1000; cnt <= max_cnt; cnt *= 2) {
+        vtss::Vector<std::unique_ptr<vtss::Timer>> timers(cnt);
+        uint64_t start_ns, restart_ns, cancel_ns;
+
+        // Periods between one and two minutes, so that none of them expire
+        // while measuring.
+        for (uint32_t i = 0; i < cnt; i++) {
+            auto t = vtss::make_unique<vtss::Timer>();
+            rnd = rnd * 1664525 + 1013904223;
+            t->set_period(vtss::milliseconds(60000 + rnd % 60000));
+            t->callback = timer_bench_callback;
+            t->modid = VTSS_MODULE_ID_TIMER;
+            timers.push_back(std::move(t));
+        }
+
+        auto t0 = vtss::LinuxClock::now();
+        for (auto &t : timers) {
+            (void)vtss_timer_start(t.get());
+        }
+
+        auto t1 = vtss::LinuxClock::now();
+        for (auto &t : timers) {
+            (void)vtss_timer_start(t.get());
+        }
+
+        auto t2 = vtss::LinuxClock::now();
+        for (auto &t : timers) {
+            (void)vtss_timer_cancel(t.get());
+        }
+
+        auto t3 = vtss::LinuxClock::now();
+
+        start_ns   = vtss::LinuxClock::to_nanoseconds(t1 - t0).raw() / cnt;
+        restart_ns = vtss::LinuxClock::to_nanoseconds(t2 - t1).raw() / cnt;
+        cancel_ns  = vtss::LinuxClock::to_nanoseconds(t3 - t2).raw() / cnt;
+        ICLI_PRINTF("%10u " VPRI64Fu("10") " " VPRI64Fu("12") " " VPRI64Fu("11") "\n", cnt, start_ns, restart_ns, cancel_ns);
+    }
+}
+
 extern "C" int timer_icli_cmd_register();
 
 /****************************************************************************/
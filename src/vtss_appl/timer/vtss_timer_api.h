@@ -30,6 +30,7 @@
 
 #include "main_types.h" /* For vtss_init_data_t */
 #include "subject.hxx"
+#include "vtss/basics/intrusive_list.hxx"
 #include "time.hxx"
 #include "vtss_module_id.h" /* For vtss_module_id_t */
 
@@ -40,14 +41,35 @@ void TIMER_del(struct Timer *timer);
 
 typedef void (vtss_timer_cb_f)(struct Timer *timer);
 
+// Entry in the list of started timers used by timer_debug_print()
+struct TimerListNode : public intrusive::ListNode {
+    explicit TimerListNode(struct Timer *t) : timer(t) {}
+
+    // A copy is not linked into TIMER_list, and assignment keeps the links
+    // and the owner of the destination. #timer is set when linked.
+    TimerListNode(const TimerListNode &rhs) : intrusive::ListNode(), timer(rhs.timer) {}
+    TimerListNode &operator=(const TimerListNode &)
+    {
+        return *this;
+    }
+
+    struct Timer *timer;
+};
+
 struct Timer : public notifications::EventHandler {
     Timer(vtss_thread_prio_t prio = VTSS_THREAD_PRIO_DEFAULT)
         : notifications::EventHandler(
-              &notifications::subject_runner_get(prio, false)), my_timer(this)
+              &notifications::subject_runner_get(prio, false)), my_timer(this),
+          list_node(this)
     {
         modid = VTSS_MODULE_ID_NONE;
     }
 
+    ~Timer()
+    {
+        TIMER_del(this);
+    }
+
     void execute(vtss::notifications::Event *e)
     {
     }
@@ -131,6 +153,11 @@ struct Timer : public notifications::EventHandler {
      * The timer struct defined by vtss::notifications::TimerBasic.
      */
     vtss::notifications::Timer my_timer;
+
+    /**
+     * Private. Links the timer into the list of started timers.
+     */
+    TimerListNode list_node;
 };
 
 } // namespace vtss
@@ -191,6 +218,8 @@ struct timer_test_status {
     uint32_t min_itr_cnt;
     uint32_t test_time;
     timer_test_stats period;
+    uint32_t start_ns;     // Average time spent in vtss_timer_start()
+    timer_test_stats late; // Lateness of the first expiry in microseconds
 };
 
 // Create 'timer_cnt' timer instances, each will sleep for 'duration' ms in its
@@ -201,6 +230,11 @@ uint32_t vtss_timer_test_start(uint32_t timer_cnt, vtss::milliseconds duration,
                                vtss_thread_prio_t prio);
 
 timer_test_status vtss_timer_test_status(uint32_t handle);
+
+// Scaling benchmark. For 1000, 2000, 4000, ... up to 'max_cnt' one-shot timers
+// with periods far out in the future, print the average time it takes to
+// start, re-start and cancel a timer.
+void vtss_timer_test_bench(u32 session_id, uint32_t max_cnt);
 void timer_debug_print(u32 session_id);
 
 #endif /* _VTSS_TIMER_API_H_ */
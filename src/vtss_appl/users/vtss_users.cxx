@@ -976,7 +976,10 @@ mesa_rc vtss_appl_users_whoami(
     }
 
 #if defined(VTSS_SW_OPTION_FAST_CGI)
-    cyg_httpd_current_username(info->username, VTSS_APPL_USERS_NAME_LEN);
+    // Only known when serving a web request
+    if (!cyg_httpd_current_username(info->username, VTSS_APPL_USERS_NAME_LEN)) {
+        return VTSS_RC_ERROR;
+    }
     info->privilege = (u32)cyg_httpd_current_privilege_level();
     return VTSS_RC_OK;
 #else
@@ -0,0 +1,132 @@
+/*
+ Copyright (c) 2006-2022 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+// Common parts of the trace replay tests of the vtss::DeadlineIndex users.
+//
+// Such a test replays a random trace against a simplified model of a module
+// twice: Once visiting all entries every second, which is what the module
+// used to do, and once visiting only the entries whose deadline in the index
+// has been reached, which is what it does now. Both runs must give the same
+// events and end up with the same entries. The model's deadline calculations
+// are shared with the module's production code, so only the bookkeeping
+// around them is modelled.
+//
+// All tests take these options:
+//   -<c> <count>   Number of entries (groups, MAC addresses, ...) in the trace
+//   -s <seconds>   (default: 3600)
+//   -e <events per second> (default: 20)
+//   -r <random seed> (default: 1)
+
+#ifndef _TRACE_REPLAY_HXX_
+#define _TRACE_REPLAY_HXX_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+struct trace_replay_opts_t {
+    uint32_t cnt;
+    uint32_t seconds        = 3600;
+    uint32_t events_per_sec = 20;
+    uint32_t seed           = 1;
+};
+
+// Parses the options into #o, whose cnt must hold the default count. #cnt_opt
+// is the option letter of the count, and #cnt_name what is counted. Returns
+// false after printing the usage if an option is invalid.
+static inline bool trace_replay_opts_get(int argc, char *argv[], char cnt_opt, const char *cnt_name, trace_replay_opts_t &o)
+{
+    char optstring[] = "c:s:e:r:";
+    int  opt;
+
+    optstring[0] = cnt_opt;
+
+    while ((opt = getopt(argc, argv, optstring)) != -1) {
+        if (opt == cnt_opt) {
+            o.cnt = atoi(optarg);
+        } else if (opt == 's') {
+            o.seconds = atoi(optarg);
+        } else if (opt == 'e') {
+            o.events_per_sec = atoi(optarg);
+        } else if (opt == 'r') {
+            o.seed = atoi(optarg);
+        } else {
+            fprintf(stderr, "Usage: %s [-%c <%s>] [-s <seconds>] [-e <events per second>] [-r <random seed>]\n", argv[0], cnt_opt, cnt_name);
+            return false;
+        }
+    }
+
+    srand(o.seed);
+    return true;
+}
+
+// The outcome of one run of a trace
+struct trace_replay_run_t {
+    const char                     *method;
+    uint64_t                       visit_cnt;  // Entries visited
+    uint64_t                       wakeup_cnt; // Seconds in which entries were visited
+    const std::vector<std::string> *events;
+    size_t                         entry_cnt;  // Entries left at the end
+};
+
+// Prints the visits and wakeups of the two runs and checks that they gave
+// the same events and left the same number of entries. Returns false after
+// printing the first difference if not. The caller compares the entries.
+static inline bool trace_replay_compare(size_t op_cnt, const char *cnt_name, const trace_replay_opts_t &o, const trace_replay_run_t &walk, const trace_replay_run_t &index)
+{
+    size_t i;
+
+    printf("Trace: %zu operations on %u %s over %u seconds\n", op_cnt, o.cnt, cnt_name, o.seconds);
+    printf("%-9s %12s %10s %10s %10s\n", "Method", "Visits", "Wakeups", "Events", "Entries");
+    for (const trace_replay_run_t *r : {&walk, &index}) {
+        printf("%-9s %12llu %10llu %10zu %10zu\n", r->method, (unsigned long long)r->visit_cnt, (unsigned long long)r->wakeup_cnt, r->events->size(), r->entry_cnt);
+    }
+
+    if (*walk.events != *index.events) {
+        for (i = 0; i < walk.events->size() && i < index.events->size(); i++) {
+            if ((*walk.events)[i] != (*index.events)[i]) {
+                break;
+            }
+        }
+
+        fprintf(stderr, "Event %zu differs: %s = \"%s\", %s = \"%s\"\n", i,
+                walk.method,  i < walk.events->size()  ? (*walk.events)[i].c_str()  : "",
+                index.method, i < index.events->size() ? (*index.events)[i].c_str() : "");
+        return false;
+    }
+
+    if (walk.entry_cnt != index.entry_cnt) {
+        fprintf(stderr, "Entry count differs\n");
+        return false;
+    }
+
+    return true;
+}
+
+#endif /* _TRACE_REPLAY_HXX_ */
@@ -726,7 +726,7 @@ cyg_httpd_form_varable_find(CYG_HTTPD_STATE* p, const char *name)
     const char *value;
 
     /* Search POST formdata args */
-    if(httpstate.content_type == CYG_HTTPD_CONTENT_TYPE_URLENCODED &&
+    if(p->content_type == CYG_HTTPD_CONTENT_TYPE_URLENCODED &&
        p->post_data &&
        (value = search_arg(p->post_data, name)))
         return value;
@@ -795,7 +795,7 @@ cyg_httpd_form_multi_varable_find(CYG_HTTPD_STATE* p, const char *name, int idx)
     int         i, offset;
 
     /* Search POST formdata args */
-    if (httpstate.content_type == CYG_HTTPD_CONTENT_TYPE_URLENCODED &&
+    if (p->content_type == CYG_HTTPD_CONTENT_TYPE_URLENCODED &&
         p->post_data &&
         (value = search_arg(p->post_data, name))) {
         if (idx == 1) {
@@ -0,0 +1,226 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+// Latency of a JSON-RPC batch request against the number of threads running
+// its read-only calls, see RootNode::batch_executor().
+//
+// Usage: json-batch-bench [-c <calls>] [-d <usec>] [-s <every>] [-r <rounds>]
+//
+// The batch has <calls> calls, each blocking for <usec> like a handler waiting
+// for a lock or a switch register would. Every <every>th call is a "set",
+// which the others must be ordered against. Each response is compared to the
+// one of the sequential run.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "vtss/basics/expose/json/root-node.hxx"
+#include "vtss/basics/expose/json/namespace-node.hxx"
+
+using namespace vtss;
+using namespace vtss::expose::json;
+
+static unsigned delay_us = 100;
+static std::atomic<unsigned> value(0);
+
+struct Leaf : public Node {
+    Leaf(NamespaceNode *p, const char *n, bool w) : Node(p, n), write(w) {}
+
+    vtss::json::Result::Code handle(int priv, str method_name,
+                                    const Request *req, ostreamBuf &out) {
+        if (method_name.begin() != method_name.end())
+            return vtss::json::Result::METHOD_NOT_FOUND;
+
+        usleep(delay_us);
+
+        // A get shows every set before it, and none after it
+        unsigned v = write ? ++value : value.load();
+        std::string s = "{\"id\":\"" + std::string(req->method.begin()) +
+                        "\",\"error\":null,\"result\":" + std::to_string(v) +
+                        "}";
+        out.write(s.c_str(), s.c_str() + s.size());
+        return vtss::json::Result::OK;
+    }
+
+    void handle_reflection(Reflection *r) {}
+
+    const bool write;
+};
+
+// The same algorithm as the worker pool of the json_rpc module, on std::thread
+struct Pool : public BatchExecutor {
+    struct Run {
+        Job **jobs;
+        size_t cnt, next, done;
+    };
+
+    explicit Pool(unsigned n) {
+        for (unsigned i = 0; i < n; ++i)
+            threads.emplace_back([this]() { worker(); });
+    }
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        work.notify_all();
+        for (auto &t : threads) t.join();
+    }
+
+    void exec_one(std::unique_lock<std::mutex> &lock) {
+        Run *r = run_;
+        Job *job = r->jobs[r->next++];
+
+        if (r->next == r->cnt) run_ = nullptr;
+
+        lock.unlock();
+        job->exec();
+        lock.lock();
+
+        if (++r->done == r->cnt) done.notify_all();
+    }
+
+    void worker() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop) {
+            if (!run_) {
+                work.wait(lock);
+                continue;
+            }
+
+            exec_one(lock);
+        }
+    }
+
+    // One request at a time here, so there is no queue of runs
+    void run(Job **jobs, size_t cnt) {
+        Run r = {jobs, cnt, 0, 0};
+        std::unique_lock<std::mutex> lock(mutex);
+
+        run_ = &r;
+        work.notify_all();
+        while (run_ == &r) exec_one(lock);
+        while (r.done < r.cnt) done.wait(lock);
+    }
+
+    std::mutex mutex;
+    std::condition_variable work, done;
+    std::vector<std::thread> threads;
+    Run *run_ = nullptr;
+    bool stop = false;
+};
+
+static double bench(RootNode &root, const std::string &batch, unsigned rounds,
+                    std::string &response) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < rounds; ++r) {
+        StringStream out;
+
+        value = 0;
+        root.process(0, str(batch), out);
+        if (r == 0) response.assign(out.begin(), out.end());
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / rounds;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned calls = 100, set_every = 25, rounds = 20;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:d:s:r:")) != -1) {
+        switch (opt) {
+        case 'c':
+            calls = atoi(optarg);
+            break;
+        case 'd':
+            delay_us = atoi(optarg);
+            break;
+        case 's':
+            set_every = atoi(optarg);
+            break;
+        case 'r':
+            rounds = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-c <calls>] [-d <usec>] [-s <every>] "
+                    "[-r <rounds>]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    RootNode root;
+    NamespaceNode mod(&root, "port");
+    NamespaceNode sub(&mod, "status");
+    Leaf get(&sub, "get", false);
+    Leaf set(&sub, "set", true);
+
+    std::string batch = "[";
+    for (unsigned i = 0; i < calls; ++i) {
+        bool w = set_every && (i % set_every) == set_every - 1;
+        if (i) batch += ",";
+        batch += std::string("{\"method\":\"port.status.") +
+                 (w ? "set" : "get") + "\",\"params\":[],\"id\":" +
+                 std::to_string(i) + "}";
+    }
+    batch += "]";
+
+    root.freeze();
+    printf("%u calls (a set every %u), %u usec each, %u rounds\n", calls,
+           set_every, delay_us, rounds);
+
+    std::string expect, response;
+    double seq = bench(root, batch, rounds, expect);
+    printf("sequential   %10.0f usec per batch\n", seq);
+
+    for (unsigned n : {1, 2, 4, 8, 16}) {
+        Pool pool(n);
+
+        root.batch_executor(&pool);
+        double us = bench(root, batch, rounds, response);
+        root.batch_executor(nullptr);
+
+        printf("%2u workers   %10.0f usec per batch, %5.1fx%s\n", n, us,
+               seq / us, response == expect ? "" : "  RESPONSE MISMATCH");
+        if (response != expect) return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+// Cost of resolving a JSON-RPC method name to its handler, by the tree search
+// in NamespaceNode and by the index built by RootNode::freeze().
+//
+// Usage: json-dispatch-bench [-m <modules>] [-n <calls>]
+//
+// The tree mimics the registered methods of a full build: each module has a
+// few namespaces with the usual set of methods. Every method is dispatched in
+// turn, with a handler which does nothing, so the time is the dispatch cost.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+#include "vtss/basics/expose/json/root-node.hxx"
+#include "vtss/basics/expose/json/namespace-node.hxx"
+
+using namespace vtss;
+using namespace vtss::expose::json;
+
+struct Leaf : public Node {
+    Leaf(NamespaceNode *p, const char *n) : Node(p, n) {}
+
+    vtss::json::Result::Code handle(int priv, str method_name,
+                                    const Request *req, ostreamBuf &out) {
+        if (method_name.begin() != method_name.end())
+            return vtss::json::Result::METHOD_NOT_FOUND;
+
+        calls++;
+        return vtss::json::Result::OK;
+    }
+
+    void handle_reflection(Reflection *r) {}
+
+    static uint64_t calls;
+};
+
+uint64_t Leaf::calls = 0;
+
+static const char *sub_names[] = {"config", "status", "control", "statistics"};
+static const char *leaf_names[] = {"get", "set", "add", "del", "update",
+                                   "capabilities"};
+
+template <typename F>
+static double bench(const char *name, const std::vector<std::string> &methods,
+                    uint64_t cnt, F f) {
+    Request req;
+    nullstream out;
+
+    Leaf::calls = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < cnt; ++i)
+        f(str(methods[i % methods.size()]), &req, out);
+    auto t1 = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("%-12s %8.1f ns per call (%llu handled)\n", name, ns / cnt,
+           (unsigned long long)Leaf::calls);
+
+    return ns / cnt;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned modules = 300;
+    uint64_t cnt = 1000000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:n:")) != -1) {
+        switch (opt) {
+        case 'm':
+            modules = atoi(optarg);
+            break;
+        case 'n':
+            cnt = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-m <modules>] [-n <calls>]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    // Nodes keep pointers to their names
+    std::deque<std::string> names;
+    std::deque<NamespaceNode> namespaces;
+    std::deque<Leaf> leafs;
+    std::vector<std::string> methods;
+    RootNode root;
+
+    for (unsigned m = 0; m < modules; ++m) {
+        names.push_back("module" + std::to_string(m));
+        namespaces.emplace_back(&root, names.back().c_str());
+        NamespaceNode *mod = &namespaces.back();
+
+        for (auto s : sub_names) {
+            namespaces.emplace_back(mod, s);
+            NamespaceNode *sub = &namespaces.back();
+
+            for (auto l : leaf_names) {
+                leafs.emplace_back(sub, l);
+                methods.push_back(names.back() + "." + s + "." + l);
+            }
+        }
+    }
+
+    printf("%u modules, %zu methods, %llu calls\n", modules, methods.size(),
+           (unsigned long long)cnt);
+
+    double tree = bench("tree search", methods, cnt,
+                        [&](str m, const Request *req, ostreamBuf &out) {
+                            root.handle(0, m, req, out);
+                        });
+
+    // Both must resolve every method to the same node
+    root.freeze();
+    for (const auto &m : methods) {
+        if (root.index_lookup(str(m)) != root.NamespaceNode::lookup(str(m))) {
+            printf("Index mismatch for %s\n", m.c_str());
+            return 1;
+        }
+    }
+
+    double index = bench("index", methods, cnt,
+                         [&](str m, const Request *req, ostreamBuf &out) {
+                             root.dispatch(0, m, req, out);
+                         });
+
+    printf("speed-up: %.1fx\n", tree / index);
+
+    // Children are destroyed before their parents
+    leafs.clear();
+    while (namespaces.size()) namespaces.pop_back();
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+
+ Copyright (c) 2006-2017 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+// Throughput of RingBufSpsc and RingBufMpsc compared to the lock based
+// RingBufConcurrent.
+//
+// Usage: ringbuf-bench [-p <producers>] [-n <elements per producer>]
+//
+// First the cost of an uncontended push/pop pair is measured in a single
+// thread, then the throughput with producer threads and a consumer thread.
+// The SPSC variant is only measured with one producer. As RingBufConcurrent
+// overwrites when full, its producers wait while it is full, and the number of
+// overwritten elements is reported.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "vtss/basics/ringbuf.hxx"
+
+#define RB_SIZE 1024
+
+template <typename RB>
+static void bench_single(const char *name, uint64_t cnt) {
+    static RB rb;
+    uint64_t v = 0, sum = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < cnt; ++i) {
+        rb.push(i);
+        rb.pop(v);
+        sum += v;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("%-11s single thread: %6.1f ns per push/pop (%llu)\n", name,
+           ns / cnt, (unsigned long long)(sum & 1));
+}
+
+template <typename RB>
+static void bench(const char *name, unsigned producers, uint64_t cnt) {
+    static RB rb;
+    std::vector<std::thread> threads;
+    std::atomic<unsigned> running(producers);
+    uint64_t popped = 0, v;
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&]() {
+            for (uint64_t i = 0; i < cnt; ++i) {
+                while (rb.full()) std::this_thread::yield();
+                while (!rb.push(i)) std::this_thread::yield();
+            }
+            running--;
+        });
+    }
+
+    while (1) {
+        if (rb.pop(v)) {
+            popped++;
+        } else if (!running) {
+            // Producers are done - drain what is left
+            while (rb.pop(v)) popped++;
+            break;
+        }
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+    for (auto &t : threads) t.join();
+
+    double s = std::chrono::duration<double>(t1 - t0).count();
+    printf("%-11s producers: %2u popped: %10llu lost: %8llu %8.2f Mops/s\n",
+           name, producers, (unsigned long long)popped,
+           (unsigned long long)(producers * cnt - popped),
+           popped / s / 1e6);
+}
+
+int main(int argc, char **argv) {
+    unsigned producers = 4;
+    uint64_t cnt = 1000000;
+    int c;
+
+    while ((c = getopt(argc, argv, "p:n:")) != -1) {
+        switch (c) {
+        case 'p': producers = atoi(optarg); break;
+        case 'n': cnt = strtoull(optarg, nullptr, 0); break;
+        default:
+            fprintf(stderr, "Usage: %s [-p <producers>] [-n <count>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bench_single<vtss::RingBufConcurrent<uint64_t, RB_SIZE>>("concurrent", cnt);
+    bench_single<vtss::RingBufSpsc<uint64_t, RB_SIZE>>("spsc", cnt);
+    bench_single<vtss::RingBufMpsc<uint64_t, RB_SIZE>>("mpsc", cnt);
+
+    bench<vtss::RingBufConcurrent<uint64_t, RB_SIZE>>("concurrent", 1, cnt);
+    bench<vtss::RingBufSpsc<uint64_t, RB_SIZE>>("spsc", 1, cnt);
+    bench<vtss::RingBufMpsc<uint64_t, RB_SIZE>>("mpsc", 1, cnt);
+    bench<vtss::RingBufConcurrent<uint64_t, RB_SIZE>>("concurrent", producers, cnt);
+    bench<vtss::RingBufMpsc<uint64_t, RB_SIZE>>("mpsc", producers, cnt);
+
+    return 0;
+}
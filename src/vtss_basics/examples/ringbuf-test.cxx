@@ -0,0 +1,146 @@
+/*
+
+ Copyright (c) 2006-2017 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+// Tests of RingBufSpsc and RingBufMpsc. Intended to be run with and without
+// -fsanitize=thread. Returns non-zero on failure.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+#include "vtss/basics/ringbuf.hxx"
+
+static int errors = 0;
+
+#define CHECK(X)                                                      \
+    do {                                                              \
+        if (!(X)) {                                                   \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #X); \
+            errors++;                                                 \
+        }                                                             \
+    } while (0)
+
+template <typename RB>
+static void test_single_thread(const char *name) {
+    RB rb;
+    uint32_t v;
+
+    printf("%s: single thread\n", name);
+
+    CHECK(rb.empty());
+    CHECK(!rb.full());
+    CHECK(rb.size() == 0);
+    CHECK(!rb.pop(v));
+
+    // Fill it, and check that push fails without overwriting
+    for (uint32_t i = 0; i < 4; ++i) CHECK(rb.push(i));
+    CHECK(rb.full());
+    CHECK(rb.size() == 4);
+    CHECK(!rb.push(100u));
+    CHECK(rb.size() == 4);
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        CHECK(rb.pop(v));
+        CHECK(v == i);
+    }
+    CHECK(rb.empty());
+
+    // Wrap around many times with a varying fill level
+    uint32_t in = 0, out = 0;
+    for (uint32_t n = 0; n < 1000; ++n) {
+        for (uint32_t i = 0; i < n % 6; ++i)
+            if (rb.push(in)) in++;
+
+        CHECK(rb.size() == in - out);
+
+        for (uint32_t i = 0; i < n % 4; ++i) {
+            if (!rb.pop(v)) break;
+            CHECK(v == out);
+            out++;
+        }
+    }
+
+    rb.clear();
+    CHECK(rb.empty());
+    CHECK(!rb.pop(v));
+    CHECK(rb.push(1u));
+    CHECK(rb.pop(v) && v == 1);
+}
+
+template <typename RB>
+static void test_threads(const char *name, uint32_t producers, uint32_t cnt) {
+    static RB rb;
+    std::vector<std::thread> threads;
+    std::vector<uint32_t> next(producers, 0);
+    uint64_t popped = 0;
+
+    printf("%s: %u producers\n", name, producers);
+
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([p, cnt]() {
+            for (uint32_t i = 0; i < cnt; ++i) {
+                uint64_t v = ((uint64_t)p << 32) | i;
+                while (!rb.push(v)) std::this_thread::yield();
+            }
+        });
+    }
+
+    // Each producer's elements must arrive in order, and none may be lost
+    while (popped < (uint64_t)producers * cnt) {
+        uint64_t v;
+        if (!rb.pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t p = v >> 32, i = (uint32_t)v;
+        CHECK(p < producers);
+        if (p >= producers) break;
+        CHECK(i == next[p]);
+        next[p] = i + 1;
+        popped++;
+    }
+
+    for (auto &t : threads) t.join();
+
+    uint64_t v;
+    CHECK(!rb.pop(v));
+    CHECK(rb.empty());
+}
+
+int main() {
+    test_single_thread<vtss::RingBufSpsc<uint32_t, 4>>("spsc");
+    test_single_thread<vtss::RingBufMpsc<uint32_t, 4>>("mpsc");
+    test_threads<vtss::RingBufSpsc<uint64_t, 64>>("spsc", 1, 1000000);
+    test_threads<vtss::RingBufMpsc<uint64_t, 64>>("mpsc", 1, 1000000);
+    test_threads<vtss::RingBufMpsc<uint64_t, 64>>("mpsc", 4, 250000);
+    test_threads<vtss::RingBufMpsc<uint64_t, 8>>("mpsc", 8, 50000);
+
+    printf("%s\n", errors ? "FAILED" : "PASSED");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,306 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+// Cost of walking a large SNMP table through the GET handler, with and without
+// the OID trie and the row cache.
+//
+// Usage: snmp-walk-bench [-n <rows>] [-m <modules>] [-b <repetitions>]
+//                        [-c <usec>]
+//
+// The table has <rows> rows of eight columns, below <modules> sibling MIBs,
+// like the private MIBs of a full build. A walk asks for the next row of one
+// column at a time, as net-snmp does for each var-bind. A bulk walk asks for
+// all columns of a row in turn, as for a GETBULK of all columns with
+// <repetitions> repetitions, which is when the row cache helps. Each call of
+// the iterator and the getter of the table takes <usec>, like one which takes
+// a lock and reads from the switch would.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <deque>
+#include <string>
+#include "vtss/basics/snmp.hxx"
+#include "vtss/basics/expose/snmp/oid_trie.hxx"
+#include "vtss/basics/expose/snmp/row_cache.hxx"
+
+using namespace vtss;
+using namespace vtss::expose::snmp;
+
+#define COLUMNS 8
+
+struct BenchRow {
+    uint32_t c[COLUMNS];
+};
+
+static uint32_t rows = 10000;
+static double call_usec = 2;
+static uint64_t itr_calls, get_calls;
+
+static void busy() {
+    auto t0 = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double, std::micro>(
+                   std::chrono::steady_clock::now() - t0)
+                   .count() < call_usec)
+        ;
+}
+
+static mesa_rc bench_row_get(uint32_t i, BenchRow *r) {
+    get_calls++;
+    busy();
+    if (i < 1 || i > rows) return MESA_RC_ERROR;
+
+    for (uint32_t c = 0; c < COLUMNS; ++c) r->c[c] = i * 100 + c;
+    return MESA_RC_OK;
+}
+
+static mesa_rc bench_row_itr(const uint32_t *prev, uint32_t *next) {
+    itr_calls++;
+    busy();
+    if (prev && *prev >= rows) return MESA_RC_ERROR;
+
+    *next = prev ? *prev + 1 : 1;
+    return MESA_RC_OK;
+}
+
+VTSS_SNMP_TAG_SERIALIZE(bench_row_index, uint32_t, a, s) {
+    a.add_leaf(s.inner, vtss::tag::Name("Index"),
+               vtss::expose::snmp::Status::Current,
+               vtss::expose::snmp::OidElementValue(0),
+               vtss::tag::Description("Row index"));
+}
+
+template <typename T>
+void serialize(T &a, BenchRow &s) {
+    typename T::Map_t m = a.as_map(vtss::tag::Typename("BenchRow"));
+
+    for (uint32_t c = 0; c < COLUMNS; ++c)
+        m.add_leaf(s.c[c], vtss::tag::Name("Column"),
+                   vtss::expose::snmp::Status::Current,
+                   vtss::expose::snmp::OidElementValue(c),
+                   vtss::tag::Description("Column"));
+}
+
+struct BenchTable {
+    typedef vtss::expose::ParamList<vtss::expose::ParamKey<uint32_t>,
+                                    vtss::expose::ParamVal<BenchRow *>> P;
+
+    static constexpr const char *table_description = "Synthetic table";
+    static constexpr const char *index_description = "Synthetic row";
+
+    VTSS_EXPOSE_SERIALIZE_ARG_1(uint32_t &i) {
+        h.argument_properties(vtss::expose::snmp::OidOffset(1));
+        serialize(h, bench_row_index(i));
+    }
+
+    VTSS_EXPOSE_SERIALIZE_ARG_2(BenchRow &i) {
+        h.argument_properties(vtss::expose::snmp::OidOffset(2));
+        serialize(h, i);
+    }
+
+    VTSS_EXPOSE_GET_PTR(bench_row_get);
+    VTSS_EXPOSE_ITR_PTR(bench_row_itr);
+};
+
+struct Walker {
+    virtual void serialize_get(GetHandler &g) = 0;
+    virtual ~Walker() {}
+    RowCache *cache = nullptr;
+};
+
+struct TreeWalker : public Walker {
+    explicit TreeWalker(NamespaceNode *r) : root(r) {}
+    void serialize_get(GetHandler &g) { serialize(g, *root); }
+    NamespaceNode *root;
+};
+
+struct TrieWalker : public Walker {
+    explicit TrieWalker(NamespaceNode *r) : trie(r) {}
+    void serialize_get(GetHandler &g) { serialize(g, trie); }
+    OidTrie trie;
+};
+
+// Get-next of 'column' after 'idx'. Returns false at the end of the table.
+static bool getnext(Walker &w, OidSequence &column, OidSequence &idx,
+                    StringStream &out) {
+    OidSequence in(idx);
+    GetHandler g(column, in, &out, true);
+
+    g.row_cache = w.cache;
+    w.serialize_get(g);
+    if (g.state() != HandlerState::DONE) return false;
+
+    idx = g.next_index;
+    return true;
+}
+
+// One column at a time, as snmpwalk does
+static void walk(Walker &w, OidSequence *columns, StringStream &out) {
+    for (uint32_t c = 0; c < COLUMNS; ++c) {
+        OidSequence idx;
+
+        if (w.cache) w.cache->clear();
+        while (getnext(w, columns[c], idx, out))
+            ;
+    }
+}
+
+// All columns of a row, then the next row, <repetitions> rows per request
+static void walk_bulk(Walker &w, OidSequence *columns,
+                      uint32_t repetitions, StringStream &out) {
+    OidSequence idx[COLUMNS];
+    bool more = true;
+
+    while (more) {
+        if (w.cache) w.cache->clear();
+
+        for (uint32_t r = 0; r < repetitions && more; ++r)
+            for (uint32_t c = 0; c < COLUMNS; ++c)
+                more = getnext(w, columns[c], idx[c], out) && more;
+    }
+}
+
+static void report(const char *name, double us, uint64_t cells,
+                   const RowCache *cache) {
+    printf("%-24s %8.2f usec per cell, %6.2f itr + %6.2f get per cell",
+           name, us / cells, (double)itr_calls / cells,
+           (double)get_calls / cells);
+    if (cache)
+        printf(", %llu cache hits", (unsigned long long)cache->hits);
+    printf("\n");
+}
+
+template <typename F>
+static double timed(F f) {
+    itr_calls = get_calls = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+
+int main(int argc, char *argv[]) {
+    unsigned modules = 150, repetitions = 50;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:m:b:c:")) != -1) {
+        switch (opt) {
+        case 'n':
+            rows = atoi(optarg);
+            break;
+        case 'm':
+            modules = atoi(optarg);
+            break;
+        case 'b':
+            repetitions = atoi(optarg);
+            break;
+        case 'c':
+            call_usec = atof(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-n <rows>] [-m <modules>] [-b <repetitions>] "
+                    "[-c <usec>]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    // iso.3.6.1.4.1.6603.1.<module>.1.<table>
+    NamespaceNode iso(OidElement(1, "iso"));
+    NamespaceNode org(&iso, OidElement(3, "org"));
+    NamespaceNode dod(&org, OidElement(6, "dod"));
+    NamespaceNode internet(&dod, OidElement(1, "internet"));
+    NamespaceNode priv(&internet, OidElement(4, "private"));
+    NamespaceNode enterprises(&priv, OidElement(1, "enterprises"));
+    NamespaceNode vendor(&enterprises, OidElement(6603, "vtss"));
+    NamespaceNode products(&vendor, OidElement(1, "products"));
+
+    // Other MIBs, each with a table, before the one walked
+    std::deque<NamespaceNode> namespaces;
+    std::deque<TableReadOnly2<BenchTable>> tables;
+    for (unsigned m = 0; m < modules; ++m) {
+        namespaces.emplace_back(&products, OidElement(m + 1, "mib"));
+        NamespaceNode *objects = &namespaces.back();
+        namespaces.emplace_back(objects, OidElement(1, "objects"));
+        tables.emplace_back(&namespaces.back(), OidElement(1, "table"));
+    }
+
+    OidSequence columns[COLUMNS];
+    for (uint32_t c = 0; c < COLUMNS; ++c) {
+        for (uint32_t o : {1, 3, 6, 1, 4, 1, 6603, 1}) columns[c].push(o);
+        columns[c].push(modules), columns[c].push(1), columns[c].push(1);
+        columns[c].push(1), columns[c].push(2 + c);
+    }
+
+    uint64_t cells = (uint64_t)rows * COLUMNS;
+    printf("%u rows x %u columns, %u MIBs, %u repetitions per bulk, "
+           "%.1f usec per itr/get call\n",
+           rows, COLUMNS, modules, repetitions, call_usec);
+
+    TreeWalker tree(&iso);
+    TrieWalker trie(&iso);
+    RowCache cache;
+    StringStream expect, out;
+    double us;
+
+    us = timed([&]() { walk(tree, columns, expect); });
+    report("walk, tree", us, cells, nullptr);
+
+    us = timed([&]() { walk(trie, columns, out); });
+    report("walk, trie", us, cells, nullptr);
+    if (out.buf != expect.buf) {
+        printf("Walk through the trie differs\n");
+        return 1;
+    }
+
+    expect.clear();
+    us = timed([&]() { walk_bulk(tree, columns, repetitions, expect); });
+    report("bulk, tree", us, cells, nullptr);
+
+    out.clear();
+    us = timed([&]() { walk_bulk(trie, columns, repetitions, out); });
+    report("bulk, trie", us, cells, nullptr);
+
+    out.clear();
+    trie.cache = &cache;
+    us = timed([&]() { walk_bulk(trie, columns, repetitions, out); });
+    report("bulk, trie + row cache", us, cells, &cache);
+    if (out.buf != expect.buf) {
+        printf("Bulk walk through the trie and the row cache differs\n");
+        return 1;
+    }
+
+    // Children are destroyed before their parents
+    tables.clear();
+    while (namespaces.size()) namespaces.pop_back();
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+// Tests of SpillStream: buffering towards a plain buffer, spilling into a
+// streaming one, and completing JSON cut off half-way. Returns non-zero on
+// failure.
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "vtss/basics/expose/json/spill-stream.hxx"
+
+using namespace vtss;
+using namespace vtss::expose::json;
+
+static int errors = 0;
+
+#define CHECK(X)                                                      \
+    do {                                                              \
+        if (!(X)) {                                                   \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #X); \
+            errors++;                                                 \
+        }                                                             \
+    } while (0)
+
+// Collects everything written to it, like a socket would
+struct Sink : public ostreamBuf {
+    explicit Sink(bool s) : streaming_(s) {}
+
+    bool ok() const { return true; }
+    bool push(char c) { data.push_back(c); return true; }
+    size_t write(const char *b, const char *e) {
+        data.append(b, e - b);
+        return e - b;
+    }
+    void clear() { data.clear(); }
+    const char *begin() const { return data.c_str(); }
+    const char *end() const { return data.c_str() + data.size(); }
+    bool streaming() const { return streaming_; }
+
+    std::string data;
+    bool streaming_;
+};
+
+struct ResultStream : public SpillStream {
+    ResultStream(Sink *s, size_t limit) : SpillStream(s, limit), sink(s) {}
+    void spill_prefix() { sink->data.append("\"result\":"); }
+    Sink *sink;
+};
+
+// Write 'in' and terminate the output. Returns what the sink received.
+static std::string cut(const char *in) {
+    Sink sink(true);
+    ResultStream s(&sink, 4);
+
+    s.write(in, in + strlen(in));
+    CHECK(s.spilled());
+    CHECK(!s.retractable());
+    s.terminate();
+
+    return sink.data;
+}
+
+static void test_buffered() {
+    printf("buffered\n");
+
+    // A non-streaming parent never receives anything
+    Sink sink(false);
+    SpillStream s(&sink, 4);
+    s << "[1,2,3,4,5]";
+    CHECK(!s.spilled());
+    CHECK(s.retractable());
+    CHECK(s.size() == 11);
+    CHECK(sink.data.empty());
+    CHECK(std::string(s.begin(), s.end()) == "[1,2,3,4,5]");
+
+    s.clear();
+    CHECK(s.size() == 0);
+    CHECK(s.begin() == s.end());
+
+    // Below the limit a streaming parent does not receive anything either
+    Sink sink2(true);
+    SpillStream s2(&sink2, 64);
+    s2 << "[1,2,3]";
+    CHECK(!s2.spilled());
+    CHECK(sink2.data.empty());
+}
+
+static void test_spill() {
+    printf("spill\n");
+
+    Sink sink(true);
+    {
+        ResultStream s(&sink, 4);
+        s << "[1,";
+        CHECK(!s.spilled());
+        s << "2,";
+        CHECK(s.spilled());
+        CHECK(s.begin() == s.end());
+        CHECK(sink.data == "\"result\":[1,2,");
+
+        // Written straight through from now on, and clear() cannot take it
+        // back
+        s << "3]";
+        s.clear();
+        CHECK(s.size() == 7);
+        CHECK(sink.data == "\"result\":[1,2,3]");
+
+        // Nothing to complete
+        s.terminate();
+        CHECK(sink.data == "\"result\":[1,2,3]");
+        CHECK(buffer_usage_current() == 0);
+    }
+}
+
+static void test_terminate() {
+    printf("terminate\n");
+
+    CHECK(cut("[{\"a\":1,\"b\":[1,") == "\"result\":[{\"a\":1,\"b\":[1,null]}]");
+    CHECK(cut("[{\"a\":1,") == "\"result\":[{\"a\":1,\"\":null}]");
+    CHECK(cut("[{\"a\":") == "\"result\":[{\"a\":null}]");
+    CHECK(cut("[{\"a\":\"x]{,") == "\"result\":[{\"a\":\"x]{,\"}]");
+    CHECK(cut("[{\"a\":\"x\\") == "\"result\":[{\"a\":\"x\\\\\"}]");
+    CHECK(cut("{\"a\":{},\"b\":[]") == "\"result\":{\"a\":{},\"b\":[]}");
+}
+
+static void test_usage() {
+    printf("usage\n");
+
+    buffer_usage_reset();
+    CHECK(buffer_usage_current() == 0);
+    CHECK(buffer_usage_peak() == 0);
+    {
+        Sink sink(false);
+        SpillStream a(&sink, 4), b(&sink, 4);
+        a << "12345";
+        b << "123";
+        CHECK(buffer_usage_current() == 8);
+        a.clear();
+        CHECK(buffer_usage_current() == 3);
+    }
+    CHECK(buffer_usage_current() == 0);
+    CHECK(buffer_usage_peak() == 8);
+}
+
+int main() {
+    test_buffered();
+    test_spill();
+    test_terminate();
+    test_usage();
+
+    if (errors) printf("%d errors\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+/*
+ Copyright (c) 2006-2023 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+*/
+
+#ifndef __VTSS_BASICS_DEADLINE_INDEX_HXX__
+#define __VTSS_BASICS_DEADLINE_INDEX_HXX__
+
+#include <stdint.h>
+#include <vtss/basics/set.hxx>
+#include <vtss/basics/map.hxx>
+
+namespace vtss {
+
+// Orders keys by the absolute time (e.g. in seconds since boot) at which they
+// next need attention, so that the owner can sleep until the earliest of them
+// and only visit keys whose deadlines have been reached, rather than walking
+// all keys on every tick.
+//
+// A deadline of 0 means that the key has no deadline and is not indexed.
+template <typename KEY>
+class DeadlineIndex {
+  public:
+    // Set the deadline of a key, replacing any previous. 0 removes it.
+    void set(const KEY &key, uint32_t deadline) {
+        auto itr = deadlines.find(key);
+
+        if (itr != deadlines.end()) {
+            if (itr->second == deadline) {
+                return;
+            }
+
+            entries.erase(Entry(itr->second, key));
+
+            if (!deadline) {
+                deadlines.erase(itr);
+                return;
+            }
+
+            itr->second = deadline;
+        } else if (!deadline || !deadlines.set(key, deadline)) {
+            return;
+        }
+
+        (void)entries.insert(Entry(deadline, key));
+    }
+
+    // Remove a key, e.g. because it is about to be deleted.
+    void del(const KEY &key) { set(key, 0); }
+
+    // Get the deadline of a key, or 0 if it doesn't have one.
+    uint32_t get(const KEY &key) const {
+        auto itr = deadlines.find(key);
+        return itr == deadlines.end() ? 0 : itr->second;
+    }
+
+    // Get the earliest deadline of all keys, or 0 if no keys are indexed.
+    uint32_t next_get() const {
+        auto itr = entries.begin();
+        return itr == entries.end() ? 0 : itr->deadline;
+    }
+
+    // Get and remove the key with the earliest deadline if that deadline is at
+    // or before now. Returns false if no deadlines have been reached. Keys
+    // with the same deadline are returned in key order.
+    bool expired_get(uint32_t now, KEY &key) {
+        auto itr = entries.begin();
+
+        if (itr == entries.end() || itr->deadline > now) {
+            return false;
+        }
+
+        key = itr->key;
+        entries.erase(itr);
+        deadlines.erase(key);
+        return true;
+    }
+
+    // Number of keys with a deadline.
+    size_t size() const { return deadlines.size(); }
+
+    void clear() {
+        entries.clear();
+        deadlines.clear();
+    }
+
+  private:
+    struct Entry {
+        Entry(uint32_t d, const KEY &k) : deadline(d), key(k) {}
+
+        uint32_t deadline;
+        KEY      key;
+
+        bool operator<(const Entry &rhs) const {
+            if (deadline != rhs.deadline) {
+                return deadline < rhs.deadline;
+            }
+
+            return key < rhs.key;
+        }
+    };
+
+    // Keys ordered by <deadline, key>.
+    Set<Entry> entries;
+
+    // Current deadline of each key, needed in order to find its entry in
+    // entries.
+    Map<KEY, uint32_t> deadlines;
+};
+
+}  // namespace vtss
+
+#endif  // __VTSS_BASICS_DEADLINE_INDEX_HXX__
@@ -47,6 +47,18 @@ enum E {
 };
 }  // namespace priv
 
+// Details of why exec() failed, used to compose the error response. They
+// belong to the call, not the node, as a node may execute several requests
+// of a batch concurrently.
+struct ExecStatus {
+    mesa_rc error_code = MESA_RC_OK;
+    void *failing_function = nullptr;
+    unsigned error_argument_index = 0;
+    unsigned arguments_got = 0;
+    unsigned arguments_expect = 0;
+    const char *argument_not_found = nullptr;
+};
+
 struct FunctionExporterAbstract : public Node {
     FunctionExporterAbstract(NamespaceNode *parent, const char *name,
                              const char *description, bool priv_write,
@@ -68,17 +80,10 @@ struct FunctionExporterAbstract : public Node {
     vtss::json::Result::Code handle(int priv, str method_name,
                                     const Request *req, ostreamBuf &out);
 
-    virtual vtss::json::Result::Code exec(const Request *req,
-                                          ostreamBuf *os) = 0;
+    virtual vtss::json::Result::Code exec(const Request *req, ostreamBuf *os,
+                                          ExecStatus *st) = 0;
     virtual ~FunctionExporterAbstract() {}
 
-    mesa_rc error_code = MESA_RC_OK;
-    void *failing_function = nullptr;
-    unsigned error_argument_index = 0;
-    unsigned arguments_got = 0;
-    unsigned arguments_expect = 0;
-    const char *argument_not_found = nullptr;
-
 #ifdef VTSS_SW_OPTION_PRIV_LVL
     const priv::E priv_type = priv::NO_ACCESS_CONTROL;
     const int priv_module_id = 0;
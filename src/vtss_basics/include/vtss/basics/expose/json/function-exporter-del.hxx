@@ -51,7 +51,8 @@ struct FunctionExporterDel : public FunctionExporterAbstract {
                   InterfaceDescriptorPrivModule<INTERFACE_DESCRIPTOR>::value),
           subject_(subject) {}
 
-    virtual vtss::json::Result::Code exec(const Request *req, ostreamBuf *os) {
+    virtual vtss::json::Result::Code exec(const Request *req, ostreamBuf *os,
+                                          ExecStatus *st) {
         HandlerFunctionExporterParser handler_in(req);
         typedef typename Interface2ParamTuple<INTERFACE_DESCRIPTOR>::type Tuple;
         typedef ResponseScalarSingleArgument::handler_type handler_type;
@@ -63,8 +64,8 @@ struct FunctionExporterDel : public FunctionExporterAbstract {
         // Invoke the actual function
         mesa_rc rc = args.call_as_del(subject_);
         if (rc != MESA_RC_OK) {
-            error_code = rc;
-            failing_function = (void *)subject_;
+            st->error_code = rc;
+            st->failing_function = (void *)subject_;
             return vtss::json::Result::INTERNAL_ERROR;
         }
 
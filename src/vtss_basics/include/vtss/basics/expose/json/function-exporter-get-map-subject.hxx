@@ -83,12 +83,13 @@ struct FunctionExporterGetMapSubject
         return vtss::json::Result::OK;
     }
 
-    vtss::json::Result::Code exec(const Request *req, ostreamBuf *os) {
+    vtss::json::Result::Code exec(const Request *req, ostreamBuf *os,
+                                  ExecStatus *st) {
         // If at least one parameter is given, then treat the request as a
         // normal get request, otherwise if no parameters is given, treat it as
         // a get-all request.
         if (req->params.size())
-            return BASE::exec(req, os);
+            return BASE::exec(req, os, st);
         else
             return exec_all(req, os);
 
@@ -83,7 +83,8 @@ struct FunctionExporterGetSetSubject : public FunctionExporterAbstract {
     }
 
     virtual vtss::json::Result::Code exec_one(const Request *req,
-                                              ostreamBuf *os) {
+                                              ostreamBuf *os,
+                                              ExecStatus *st) {
         // Parse the request
         HandlerFunctionExporterParser handler_in(req);
 
@@ -93,8 +94,8 @@ struct FunctionExporterGetSetSubject : public FunctionExporterAbstract {
         typedef typename response_type::handler_type handler_type;
 
         if (handler_in.argument_cnt() != INTERFACE::P::key_cnt) {
-            arguments_got = handler_in.argument_cnt();
-            arguments_expect = INTERFACE::P::key_cnt;
+            st->arguments_got = handler_in.argument_cnt();
+            st->arguments_expect = INTERFACE::P::key_cnt;
             return vtss::json::Result::INVALID_PARAMS;
         }
 
@@ -104,15 +105,15 @@ struct FunctionExporterGetSetSubject : public FunctionExporterAbstract {
         serialize_keys<INTERFACE>(handler_in, k);
 
         if (!handler_in.ok()) {
-            error_argument_index = 0;  // TODO
+            st->error_argument_index = 0;  // TODO
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         // Invoke the actual function
         mesa_rc rc = subject_->get_(k);
         if (rc != MESA_RC_OK) {
-            error_code = rc;
-            failing_function = (void *)subject_;
+            st->error_code = rc;
+            st->failing_function = (void *)subject_;
             return vtss::json::Result::INTERNAL_ERROR;
         }
 
@@ -124,12 +125,13 @@ struct FunctionExporterGetSetSubject : public FunctionExporterAbstract {
         return vtss::json::Result::OK;
     }
 
-    vtss::json::Result::Code exec(const Request *req, ostreamBuf *os) {
+    vtss::json::Result::Code exec(const Request *req, ostreamBuf *os,
+                                  ExecStatus *st) {
         // If at least one parameter is given, then treat the request as a
         // normal get request, otherwise if no parameters is given, treat it as
         // a get-all request.
         if (req->params.size())
-            return exec_one(req, os);
+            return exec_one(req, os, st);
         else
             return exec_all(req, os);
 
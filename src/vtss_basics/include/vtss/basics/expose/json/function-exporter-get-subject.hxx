@@ -55,7 +55,8 @@ struct FunctionExporterGetSubject : public FunctionExporterAbstract {
                   InterfaceDescriptorPrivModule<INTERFACE>::value),
           subject_(subject) {}
 
-    virtual vtss::json::Result::Code exec(const Request *req, ostreamBuf *os) {
+    virtual vtss::json::Result::Code exec(const Request *req, ostreamBuf *os,
+                                          ExecStatus *st) {
         // Parse the request
         HandlerFunctionExporterParser handler_in(req);
 
@@ -65,8 +66,8 @@ struct FunctionExporterGetSubject : public FunctionExporterAbstract {
         typedef typename response_type::handler_type handler_type;
 
         if (handler_in.argument_cnt() != INTERFACE::P::key_cnt) {
-            arguments_got = handler_in.argument_cnt();
-            arguments_expect = INTERFACE::P::key_cnt;
+            st->arguments_got = handler_in.argument_cnt();
+            st->arguments_expect = INTERFACE::P::key_cnt;
             return vtss::json::Result::INVALID_PARAMS;
         }
 
@@ -77,15 +78,15 @@ struct FunctionExporterGetSubject : public FunctionExporterAbstract {
         serialize_keys<INTERFACE>(handler_in, k);
 
         if (!handler_in.ok()) {
-            error_argument_index = 0;  // TODO
+            st->error_argument_index = 0;  // TODO
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         // Invoke the actual function
         mesa_rc rc = subject_->get_(k, v);
         if (rc != MESA_RC_OK) {
-            error_code = rc;
-            failing_function = (void *)subject_;
+            st->error_code = rc;
+            st->failing_function = (void *)subject_;
             return vtss::json::Result::INTERNAL_ERROR;
         }
 
@@ -59,7 +59,8 @@ struct FunctionExporterGet : public FunctionExporterAbstract {
                   InterfaceDescriptorPrivModule<INTERFACE_DESCRIPTOR>::value),
           subject_(subject) {}
 
-    virtual vtss::json::Result::Code exec(const Request *req, ostreamBuf *os) {
+    virtual vtss::json::Result::Code exec(const Request *req, ostreamBuf *os,
+                                          ExecStatus *st) {
         HandlerFunctionExporterParser handler_in(req);
         typedef typename Interface2ParamTuple<INTERFACE_DESCRIPTOR>::type Tuple;
 
@@ -78,22 +79,22 @@ struct FunctionExporterGet : public FunctionExporterAbstract {
         Tuple args;
 
         if (handler_in.argument_cnt() != Tuple::get_context_input_count()) {
-            arguments_got = handler_in.argument_cnt();
-            arguments_expect = Tuple::get_context_input_count();
+            st->arguments_got = handler_in.argument_cnt();
+            st->arguments_expect = Tuple::get_context_input_count();
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         unsigned i = args.template parse_keys<INTERFACE_DESCRIPTOR>(handler_in);
         if (!handler_in.ok()) {
-            error_argument_index = i;
+            st->error_argument_index = i;
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         // Invoke the actual function
         mesa_rc rc = args.call_as_get(subject_);
         if (rc != MESA_RC_OK) {
-            error_code = rc;
-            failing_function = (void *)subject_;
+            st->error_code = rc;
+            st->failing_function = (void *)subject_;
             return vtss::json::Result::INTERNAL_ERROR;
         }
 
@@ -50,7 +50,8 @@ struct FunctionExporterPatch : public FunctionExporterAbstract {
                   InterfaceDescriptorPrivModule<INTERFACE_DESCRIPTOR>::value),
           subject_(subject) {}
 
-    vtss::json::Result::Code exec(const Request *req, ostreamBuf *os) {
+    vtss::json::Result::Code exec(const Request *req, ostreamBuf *os,
+                                  ExecStatus *st) {
         HandlerFunctionExporterParser handler_in(req);
         handler_in.patch_mode(true);
         typedef typename Interface2ParamTuple<INTERFACE_DESCRIPTOR>::type Args;
@@ -58,23 +59,23 @@ struct FunctionExporterPatch : public FunctionExporterAbstract {
 
         Args args;
         if (handler_in.argument_cnt() != Args::set_context_input_count()) {
-            arguments_got = handler_in.argument_cnt();
-            arguments_expect = Args::set_context_input_count();
+            st->arguments_got = handler_in.argument_cnt();
+            st->arguments_expect = Args::set_context_input_count();
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         // start by parsing all the keys - preparing for calling get function
         unsigned i = args.template parse_keys<INTERFACE_DESCRIPTOR>(handler_in);
         if (!handler_in.ok()) {
-            error_argument_index = i;
+            st->error_argument_index = i;
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         // Invoke the actual get-function
         mesa_rc rc = args.call_as_get(subject_);
         if (rc != MESA_RC_OK) {
-            error_code = rc;
-            failing_function = (void *)subject_;
+            st->error_code = rc;
+            st->failing_function = (void *)subject_;
             return vtss::json::Result::INTERNAL_ERROR;
         }
 
@@ -85,15 +86,15 @@ struct FunctionExporterPatch : public FunctionExporterAbstract {
         // step above.
         i = args.template parse_values<INTERFACE_DESCRIPTOR>(handler_in);
         if (!handler_in.ok()) {
-            error_argument_index = i;
+            st->error_argument_index = i;
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         // Invoke the actual set function
         rc = args.call_as_set(subject_);
         if (rc != MESA_RC_OK) {
-            error_code = rc;
-            failing_function = (void *)subject_;
+            st->error_code = rc;
+            st->failing_function = (void *)subject_;
             return vtss::json::Result::INTERNAL_ERROR;
         }
 
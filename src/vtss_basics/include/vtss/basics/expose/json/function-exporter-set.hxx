@@ -50,29 +50,30 @@ struct FunctionExporterSet : public FunctionExporterAbstract {
                   InterfaceDescriptorPrivModule<INTERFACE_DESCRIPTOR>::value),
           subject_(subject) {}
 
-    vtss::json::Result::Code exec(const Request *req, ostreamBuf *os) {
+    vtss::json::Result::Code exec(const Request *req, ostreamBuf *os,
+                                  ExecStatus *st) {
         HandlerFunctionExporterParser handler_in(req);
         typedef typename Interface2ParamTuple<INTERFACE_DESCRIPTOR>::type Args;
         typedef ResponseScalarSingleArgument::handler_type handler_type;
 
         Args args;
         if (handler_in.argument_cnt() != Args::set_context_input_count()) {
-            arguments_got = handler_in.argument_cnt();
-            arguments_expect = Args::set_context_input_count();
+            st->arguments_got = handler_in.argument_cnt();
+            st->arguments_expect = Args::set_context_input_count();
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         unsigned i = args.template parse_set<INTERFACE_DESCRIPTOR>(handler_in);
         if (!handler_in.ok()) {
-            error_argument_index = i;
+            st->error_argument_index = i;
             return vtss::json::Result::INVALID_PARAMS;
         }
 
         // Invoke the actual function
         mesa_rc rc = args.call_as_set(subject_);
         if (rc != MESA_RC_OK) {
-            error_code = rc;
-            failing_function = (void *)subject_;
+            st->error_code = rc;
+            st->failing_function = (void *)subject_;
             return vtss::json::Result::INTERNAL_ERROR;
         }
 
@@ -63,6 +63,7 @@ struct Node : public intrusive::ListNode {
 
     virtual ~Node() {
         // TODO, raise!
+        if (is_linked()) notify_tree_changed();
         unlink();
     }
 
@@ -80,7 +81,7 @@ struct Node : public intrusive::ListNode {
 
     void implemented(get_ptr i) { implemented_ = i; }
 
-    bool implemented() {
+    bool implemented() const {
         if (!implemented_) return true;
         return (*implemented_)();
     }
@@ -94,6 +95,11 @@ struct Node : public intrusive::ListNode {
     std::string abs_name(const std::string &s) const;
 
   protected:
+    // Called on the top node of a tree when a node is attached to or detached
+    // from it.
+    virtual void tree_changed() {}
+    void notify_tree_changed();
+
     Node *parent_ = nullptr;
     const char *name_ = nullptr;
     const char *description_ = nullptr;
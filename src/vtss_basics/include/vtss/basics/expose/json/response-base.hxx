@@ -30,6 +30,7 @@
 #define __VTSS_BASICS_EXPOSE_JSON_RESPONSE_BASE_HXX__
 
 #include <vtss/basics/json-rpc-function.hxx>
+#include <vtss/basics/expose/json/spill-stream.hxx>
 
 namespace vtss {
 namespace expose {
@@ -52,7 +53,17 @@ struct ResponseBase {
     Exporter response;
     Exporter::Map response_map;
 
-    StringStream result_stream;
+    // The result is buffered, such that it can be replaced by an error. A
+    // large result is streamed instead, and an error discovered after that is
+    // reported next to the partial result.
+    struct ResultStream : public SpillStream {
+        ResultStream(ResponseBase *r, ostreamBuf *os)
+            : SpillStream(os), owner(r) {}
+        void spill_prefix();
+        ResponseBase *owner;
+    };
+
+    ResultStream result_stream;
     Exporter result;
 
     StringStream err_stream;
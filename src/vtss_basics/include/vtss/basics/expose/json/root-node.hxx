@@ -29,19 +29,76 @@
 #ifndef __VTSS_BASICS_EXPOSE_JSON_ROOT_NODE_HXX__
 #define __VTSS_BASICS_EXPOSE_JSON_ROOT_NODE_HXX__
 
+#include <atomic>
+#include <memory>
+#include <string>
+#include "vtss/basics/vector.hxx"
 #include "vtss/basics/expose/json/namespace-node.hxx"
 
 namespace vtss {
 namespace expose {
 namespace json {
 
+// Runs calls of a batch request concurrently, see RootNode::batch_executor()
+struct BatchExecutor {
+    struct Job {
+        virtual void exec() = 0;
+        virtual ~Job() {}
+    };
+
+    // Run the 'cnt' jobs and return when all are done. The jobs are
+    // independent, and may run in any order on any thread, including the
+    // calling one.
+    virtual void run(Job **jobs, size_t cnt) = 0;
+    virtual ~BatchExecutor() {}
+};
+
 struct RootNode : public NamespaceNode {
     RootNode() : NamespaceNode("ROOT") {}
     vtss::json::Result::Code process(int priv, str input, ostreamBuf &out);
 
+    // Build a sorted index of the full names of all nodes in the tree, such
+    // that a method is resolved by one binary search instead of a linear
+    // search per name segment. Call it when all nodes are registered. The
+    // index is dropped when a node is attached or detached, and the tree is
+    // searched as before until freeze() is called again.
+    void freeze();
+    bool frozen() const;
+
+    virtual Node *lookup(str method_name);
+
+    // Find a node by its full name in the index. Returns nullptr if it is not
+    // there or if the tree is not frozen.
+    Node *index_lookup(str method_name) const;
+
+    // Handle a request for 'method_name', like NamespaceNode::handle()
+    vtss::json::Result::Code dispatch(int priv, str method_name,
+                                      const Request *req, ostreamBuf &out);
+
+    // Opt-in: consecutive read-only calls ("get" and "itr") of a batch are
+    // given to 'e' to run concurrently. Any other call waits for the ones
+    // before it and runs alone on the calling thread. The responses are
+    // written in request order. nullptr runs all calls in order (default).
+    void batch_executor(BatchExecutor *e) { batch_executor_ = e; }
+
+  protected:
+    void tree_changed();
+
   private:
+    struct IndexEntry {
+        std::string name;
+        Node *node;
+    };
+    typedef Vector<IndexEntry> Index;
+
     vtss::json::Result::Code batch_req(int priv, str input, ostreamBuf &out);
     vtss::json::Result::Code single_req(int priv, str input, ostreamBuf &out);
+
+    // Replaced as a whole, such that requests being dispatched can keep using
+    // the one they got.
+    std::shared_ptr<const Index> index_;
+
+    std::atomic<BatchExecutor *> batch_executor_{nullptr};
 };
 
 }  // namespace json
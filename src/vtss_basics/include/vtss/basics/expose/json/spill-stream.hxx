@@ -0,0 +1,112 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#ifndef __VTSS_BASICS_EXPOSE_JSON_SPILL_STREAM_HXX__
+#define __VTSS_BASICS_EXPOSE_JSON_SPILL_STREAM_HXX__
+
+#include <string>
+#include <vtss/basics/stream.hxx>
+
+namespace vtss {
+namespace expose {
+namespace json {
+
+// Output buffer which keeps what is written to it until 'limit' bytes are
+// buffered. If the parent is a streaming buffer at that point, spill_prefix()
+// and the buffered data are handed to the parent, and the rest of the output
+// is written straight through. Towards a non-streaming parent it behaves like
+// a StringStream.
+//
+// Once spilled, clear() can no longer drop the data that has been handed on.
+// If the producer stops half-way, terminate() closes the open strings, arrays
+// and objects so the JSON value given to the parent is still well-formed.
+struct SpillStream : public ostreamBuf {
+    static constexpr size_t LIMIT_DEFAULT = 4096;
+
+    explicit SpillStream(ostreamBuf *parent, size_t limit = LIMIT_DEFAULT);
+    virtual ~SpillStream();
+
+    bool ok() const;
+    bool push(char c);
+    size_t write(const char *b, const char *e);
+
+    // Data not yet handed on. Empty once spilled.
+    const char *begin() const { return buf_.c_str(); }
+    const char *end() const { return buf_.c_str() + buf_.size(); }
+    void clear();
+
+    bool streaming() const { return parent_->streaming(); }
+    bool retractable() const { return !spilled_; }
+
+    bool spilled() const { return spilled_; }
+
+    // Number of bytes written since construction or the last clear(),
+    // including what has been handed on.
+    size_t size() const { return size_; }
+
+    // Make the JSON value handed on so far complete. Only meaningful once
+    // spilled.
+    void terminate();
+
+  protected:
+    // Called just before the buffered data is handed to the parent, e.g. to
+    // write the member name the value belongs to.
+    virtual void spill_prefix() {}
+
+  private:
+    void spill();
+    void track(const char *b, const char *e);
+
+    ostreamBuf *parent_;
+    size_t limit_;
+    size_t size_ = 0;
+    bool spilled_ = false;
+    std::string buf_;
+
+    // Scanner state for the data handed on, used by terminate()
+    std::string open_;  // Closing character of each open array/object
+    bool in_string_ = false;
+    bool escape_ = false;
+    char last_ = 0;  // Last character outside strings which is not a space
+};
+
+// Bytes held by SpillStream buffers on the calling thread, and the largest
+// amount held since the last buffer_usage_reset(). Lets a request handler
+// report the memory high-water mark of a single request.
+size_t buffer_usage_current();
+size_t buffer_usage_peak();
+void buffer_usage_reset();
+
+// Account for other output buffers, such as the one in front of a socket
+void buffer_usage_update(size_t old_size, size_t new_size);
+
+}  // namespace json
+}  // namespace expose
+}  // namespace vtss
+
+#endif  // __VTSS_BASICS_EXPOSE_JSON_SPILL_STREAM_HXX__
@@ -32,6 +32,7 @@
 #include "vtss/basics/expose/snmp/types.hxx"
 #include "vtss/basics/expose/snmp/handlers/getset_base.hxx"
 #include "vtss/basics/expose/snmp/pre-get-condition.hxx"
+#include "vtss/basics/expose/snmp/row_cache.hxx"
 
 namespace vtss {
 namespace expose {
@@ -105,6 +106,8 @@ struct GetHandlerBase : public GetSetHandlerCommon {
 
     AsnType asn_type_;
 
+    // Optional, rows fetched by earlier handlers of the same request
+    RowCache *row_cache = nullptr;
 };
 
 void serialize(GetHandler &h, NamespaceNode &o);
@@ -64,12 +64,16 @@ struct NamespaceNode : public Node {
     NamespaceNode &operator=(const NamespaceNode &) = delete;
 
     // TODO, thread safety!
-    ~NamespaceNode() { unlink(); }
+    ~NamespaceNode() {
+        unlink();
+        generation++;
+    }
 
     // TODO, check for collaps
     void attach(Node &l) {
         l.parent_ = this;
         leafs.insert_sorted(l);
+        generation++;
     }
 
     virtual void init() override {
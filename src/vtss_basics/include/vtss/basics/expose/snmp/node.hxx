@@ -53,6 +53,9 @@ struct Node : public intrusive::ListNode {
 
     virtual void init() {}
 
+    // Changed whenever a node is attached to or removed from a tree
+    static uint32_t generation;
+
   protected:
     NamespaceNode *parent_;
 
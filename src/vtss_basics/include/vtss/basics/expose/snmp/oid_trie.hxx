@@ -0,0 +1,115 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#ifndef __VTSS_BASICS_EXPOSE_SNMP_OID_TRIE_HXX__
+#define __VTSS_BASICS_EXPOSE_SNMP_OID_TRIE_HXX__
+
+#include <vtss/basics/vector.hxx>
+#include "vtss/basics/expose/snmp/node-impl.hxx"
+#include "vtss/basics/expose/snmp/handler-state.hxx"
+#include "vtss/basics/expose/snmp/oid_sequence.hxx"
+
+namespace vtss {
+namespace expose {
+namespace snmp {
+
+// Finds the table or scalar group (StructBase) an OID belongs to, by looking
+// up one OID element per level instead of visiting the tree from its root.
+//
+// The trie is built on first use, and rebuilt when nodes have been attached
+// to or removed from the tree since (see Node::generation). If two siblings
+// share an OID element, the search of the tree is used instead, as the trie
+// can only hold one of them.
+struct OidTrie {
+    explicit OidTrie(NamespaceNode *root) : root_(root) {}
+
+    OidTrie(const OidTrie &) = delete;
+    OidTrie &operator=(const OidTrie &) = delete;
+
+    NamespaceNode *root() { return root_; }
+
+    // Rebuild if the tree has changed. Returns false if the trie cannot be
+    // used for this tree.
+    bool valid();
+
+    // Returns the node whose OID is a prefix of 'oid', or nullptr. 'depth' is
+    // set to the position of the node's own element in 'oid'. The trie must
+    // be valid().
+    StructBase *find(const OidSequence &oid, uint32_t *depth) const;
+
+    // Number of times the trie has been built
+    uint32_t builds() const { return builds_; }
+
+  private:
+    // Children of a namespace are consecutive entries, sorted by OID
+    struct Entry {
+        uint32_t oid;
+        uint32_t first;     // First child (namespaces only)
+        uint32_t cnt;       // Number of children (namespaces only)
+        StructBase *leaf;   // nullptr for namespaces
+    };
+
+    bool build(NamespaceNode *ns, uint32_t first);
+
+    NamespaceNode *root_;
+    Vector<Entry> entries_;
+    uint32_t root_first_ = 0;
+    uint32_t root_cnt_ = 0;
+    uint32_t generation_ = 0;
+    uint32_t builds_ = 0;
+    bool built_ = false;
+    bool ok_ = false;
+};
+
+// Same as serialize(h, *t.root()), but without visiting the nodes which are
+// not on the path to the requested OID.
+template <typename HANDLER>
+void serialize(HANDLER &h, OidTrie &t) {
+    uint32_t depth;
+    StructBase *s;
+
+    if (!t.valid()) {
+        serialize(h, *t.root());
+        return;
+    }
+
+    if (h.state() != HandlerState::SEARCHING) return;
+
+    s = t.find(h.seq_, &depth);
+    if (!s) return;
+
+    // The node consumes its own element, as if reached from the root
+    h.oid_index_ = depth;
+    serialize(h, *s);
+}
+
+}  // namespace snmp
+}  // namespace expose
+}  // namespace vtss
+
+#endif  // __VTSS_BASICS_EXPOSE_SNMP_OID_TRIE_HXX__
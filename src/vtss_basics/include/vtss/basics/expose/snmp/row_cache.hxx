@@ -0,0 +1,86 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#ifndef __VTSS_BASICS_EXPOSE_SNMP_ROW_CACHE_HXX__
+#define __VTSS_BASICS_EXPOSE_SNMP_ROW_CACHE_HXX__
+
+#include "vtss/basics/memory.hxx"
+#include "vtss/basics/expose/snmp/oid_sequence.hxx"
+#include "vtss/basics/expose/snmp/iterator-common.hxx"
+
+namespace vtss {
+namespace expose {
+namespace snmp {
+
+struct StructBase;
+
+// Rows fetched while handling one request. The var-binds of a GET, GETNEXT or
+// GETBULK request are handled one at a time, and each would otherwise fetch
+// the row again for every column asked for. A GETBULK asking for several
+// columns of a table hits the cache for all but the first column of a row.
+//
+// A row is found by the index it was fetched with: the row itself for a get,
+// and the preceding index for a get-next. The owner must clear() the cache
+// when a new request starts, and when something may have been changed.
+struct RowCache {
+    enum { SIZE = 16 };
+
+    void clear();
+
+    // Returns the iterator holding the row, and sets 'row' to its index
+    IteratorCommon *find(const StructBase *table, bool getnext,
+                         const OidSequence &idx, OidSequence &row);
+
+    // Takes over the iterator, which holds the row found at 'idx'. The oldest
+    // row is evicted if the cache is full.
+    IteratorCommon *add(const StructBase *table, bool getnext,
+                        const OidSequence &idx, const OidSequence &row,
+                        unique_ptr<IteratorCommon> &&i);
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+  private:
+    struct Entry {
+        const StructBase *table = nullptr;
+        bool getnext = false;
+        OidSequence idx;
+        OidSequence row;
+        unique_ptr<IteratorCommon> iter;
+    };
+
+    Entry entries_[SIZE];
+    uint32_t next_ = 0;  // Entry to be used next
+    uint32_t cnt_ = 0;   // Entries in use
+};
+
+}  // namespace snmp
+}  // namespace expose
+}  // namespace vtss
+
+#endif  // __VTSS_BASICS_EXPOSE_SNMP_ROW_CACHE_HXX__
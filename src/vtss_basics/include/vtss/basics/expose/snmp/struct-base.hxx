@@ -65,7 +65,10 @@ struct StructBase : public Node {
     VTSS_SNMP_LIST_OF_HANDLERS
 #undef X
 
-    virtual ~StructBase() { unlink(); }
+    virtual ~StructBase() {
+        unlink();
+        generation++;
+    }
 
     virtual unique_ptr<IteratorCommon> new_iterator() {
         return unique_ptr<IteratorCommon>(nullptr);
@@ -31,7 +31,6 @@
 
 #include <vtss/basics/expose/param-tuple-val.hxx>
 #include <vtss/basics/notifications/subject-base.hxx>
-#include <vtss/basics/notifications/lock-global-subject.hxx>
 
 namespace vtss {
 namespace expose {
@@ -39,14 +38,15 @@ namespace expose {
 template <typename... Args>
 struct StructConfig : public notifications::SubjectBase {
     mesa_rc get(typename Args::get_ptr_type... args) const {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        notifications::SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
         tuple_.get(args...);
 
         return MESA_RC_OK;
     }
 
     mesa_rc get(notifications::Event &ev, typename Args::get_ptr_type... args) {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        ev.unlink();
+        notifications::SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
         attach_(ev);
         tuple_.get(args...);
 
@@ -58,7 +58,7 @@ struct StructConfig : public notifications::SubjectBase {
         mesa_rc rc = set_impl(args...);
         if (rc != MESA_RC_OK) return rc;
 
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        notifications::SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
         if (!tuple_.equal(args...)) {
             tuple_.set(args...);
             signal();
@@ -653,19 +653,20 @@ struct FunctionExporter : public vtss::expose::json::FunctionExporterAbstract {
         return true;
     }
     
-    Result::Code exec(const vtss::expose::json::Request *req, ostreamBuf *os) {
+    Result::Code exec(const vtss::expose::json::Request *req, ostreamBuf *os,
+                      vtss::expose::json::ExecStatus *st) {
         uint32_t cnt = 0;
         tuple_<Args...> args;
 
-        arguments_got = req->params.size();
-        if (!args.parse_input(req, cnt, &argument_not_found)) {
-            error_argument_index = cnt;
-            arguments_expect = arguments_got;
+        st->arguments_got = req->params.size();
+        if (!args.parse_input(req, cnt, &st->argument_not_found)) {
+            st->error_argument_index = cnt;
+            st->arguments_expect = st->arguments_got;
             return Result::INVALID_PARAMS;
         }
 
-        arguments_expect = cnt;
-        if (arguments_got != arguments_expect) {
+        st->arguments_expect = cnt;
+        if (st->arguments_got != st->arguments_expect) {
             return Result::INVALID_PARAMS;
         }
 
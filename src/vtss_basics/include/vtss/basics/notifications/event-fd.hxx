@@ -29,6 +29,7 @@
 #ifndef __VTSS_BASICS_NOTIFICATIONS_EVENT_FD_HXX__
 #define __VTSS_BASICS_NOTIFICATIONS_EVENT_FD_HXX__
 
+#include <atomic>
 #include <vtss/basics/fd.hxx>
 #include <vtss/basics/predefs.hxx>
 #include <vtss/basics/utility.hxx>
@@ -92,7 +93,7 @@ struct EventFd {
 
 #ifdef VTSS_BASICS_OPERATING_SYSTEM_LINUX
     // Check if the handler has been attached to a subject runner
-    bool is_attached() const { return sr_ != nullptr; }
+    bool is_attached() const { return sr_.load(std::memory_order_acquire) != nullptr; }
 #endif
 
     // Returns a mask of events which has triggered.
@@ -109,8 +110,9 @@ struct EventFd {
 
     // This pointer is used to keep track on if the file-descriptor is being
     // listning to by a subject runner. It should only be updated by the
-    // subject-runners.
-    SubjectRunnerEvent *sr_ = nullptr;
+    // subject-runners, and only while holding the lock of the runner it is
+    // changed from or to.
+    std::atomic<SubjectRunnerEvent *> sr_{nullptr};
 };
 
 // Allow to use bit-wise operations on this enumeration.
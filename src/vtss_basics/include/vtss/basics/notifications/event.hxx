@@ -29,6 +29,7 @@
 #ifndef __VTSS_BASICS_NOTIFICATIONS_EVENT_HXX__
 #define __VTSS_BASICS_NOTIFICATIONS_EVENT_HXX__
 
+#include <atomic>
 #include "vtss/basics/intrusive_list.hxx"
 #include "vtss/basics/notifications/subject-runner-predef.hxx"
 
@@ -36,9 +37,14 @@ namespace vtss {
 namespace notifications {
 
 struct EventHandler;
+struct SubjectLock;
 
 struct Event : public intrusive::ListNode {
     friend struct SubjectRunner;
+    friend struct SubjectRunnerEvent;
+    friend struct SubjectBase;
+    template <typename Key, typename Observer>
+    friend struct TableObserverPool;
 
     constexpr Event() : eh_(nullptr) {};
     constexpr explicit Event(EventHandler *eh) : eh_(eh) {};
@@ -54,6 +60,13 @@ struct Event : public intrusive::ListNode {
 
   protected:
     EventHandler *eh_ = nullptr;
+
+  private:
+    // The lock protecting the list the event is linked into (the event list
+    // of a subject or the event queue of a subject runner), or nullptr if the
+    // event is not linked or is linked into a list protected by the global
+    // lock.
+    std::atomic<SubjectLock *> lock_{nullptr};
 };
 
 }  // namespace notifications
@@ -40,6 +40,12 @@ namespace vtss {
 namespace notifications {
 
 #ifdef VTSS_BASICS_OPERATING_SYSTEM_LINUX
+// Compatibility lock. Subject runners, subjects and subject sets are protected
+// by their own SubjectLock (see subject-lock.hxx) - this lock is only kept for
+// code that needs to serialize with other users of it (SynchronizedGlobal,
+// Process and a few application modules) and for unlinking events from lists
+// that are not protected by a SubjectLock. It must be taken before (never
+// while holding) a SubjectLock.
 extern CritdRecursiveLazyInit lock_global_subject;
 struct LockGlobalSubject {
     LockGlobalSubject(const char *file, int line) {
@@ -31,6 +31,7 @@
 
 #include "vtss/basics/intrusive_list.hxx"
 #include "vtss/basics/notifications/event.hxx"
+#include "vtss/basics/notifications/subject-lock.hxx"
 
 namespace vtss {
 namespace notifications {
@@ -48,6 +49,10 @@ struct SubjectBase {
   protected:
     void attach_(Event &ev);
 
+    // Protects the event list and whatever state the derived subject
+    // publishes. May be held while events are added to a subject runner.
+    mutable SubjectLock subject_lock;
+
   private:
     intrusive::List<Event> event_list_;
 };
@@ -0,0 +1,100 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#ifndef __VTSS_BASICS_NOTIFICATIONS_SUBJECT_LOCK_HXX__
+#define __VTSS_BASICS_NOTIFICATIONS_SUBJECT_LOCK_HXX__
+
+#include <pthread.h>
+#include <atomic>
+#include <vtss/basics/predefs.hxx>
+
+namespace vtss {
+namespace notifications {
+
+// Recursive leaf lock protecting the data structures of one subject runner or
+// one subject. Each of them owns one, so that unrelated modules publishing
+// status do not contend with each other. The only nesting allowed is subject
+// lock -> runner lock (signaling a subject adds events to a runner).
+//
+// The lock is constexpr-constructible so that statically allocated subjects
+// can own one without depending on the static initialization order.
+//
+// It counts how many times it has been acquired and how many of those times it
+// was held by another thread. The number of contended acquisitions is also
+// summed over all subject locks.
+struct SubjectLock {
+    constexpr SubjectLock() {}
+    SubjectLock(const SubjectLock &) = delete;
+    SubjectLock &operator=(const SubjectLock &) = delete;
+
+    void lock(const char *file, int line);
+    void unlock(const char *file, int line);
+
+    // Number of times the lock has been acquired (recursive acquisitions not
+    // counted).
+    uint64_t acquired() const {
+        return acquired_.load(std::memory_order_relaxed);
+    }
+
+    // Number of times the lock was held by another thread when acquired.
+    uint64_t contended() const {
+        return contended_.load(std::memory_order_relaxed);
+    }
+
+    void counters_clear();
+
+    // Contended acquisitions summed over all subject locks.
+    static uint64_t contended_total();
+    static void contended_total_clear();
+
+  private:
+    pthread_mutex_t m_ = PTHREAD_MUTEX_INITIALIZER;
+    std::atomic<pthread_t> owner_{0};
+    uint32_t depth_ = 0;
+    const char *file_ = nullptr;
+    int line_ = 0;
+    std::atomic<uint64_t> acquired_{0};
+    std::atomic<uint64_t> contended_{0};
+};
+
+struct SubjectLockGuard {
+    SubjectLockGuard(SubjectLock *l, const char *file, int line) : l_(l) {
+        l_->lock(file, line);
+    }
+    SubjectLockGuard(const SubjectLockGuard &) = delete;
+    SubjectLockGuard &operator=(const SubjectLockGuard &) = delete;
+    ~SubjectLockGuard() { l_->unlock(__FILE__, __LINE__); }
+
+  private:
+    SubjectLock *l_;
+};
+
+}  // namespace notifications
+}  // namespace vtss
+
+#endif  // __VTSS_BASICS_NOTIFICATIONS_SUBJECT_LOCK_HXX__
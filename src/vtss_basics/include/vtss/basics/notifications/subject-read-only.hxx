@@ -31,7 +31,6 @@
 
 #include <vtss/basics/intrusive_list.hxx>
 #include <vtss/basics/notifications/subject-base.hxx>
-#include <vtss/basics/notifications/lock-global-subject.hxx>
 
 namespace vtss {
 namespace notifications {
@@ -44,18 +43,21 @@ struct SubjectReadOnly : public SubjectBase {
         signal(); }
 
     T get() const {
-        LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
         return value_;
     }
 
     T get(Event& t) {
-        LockGlobalSubject lock(__FILE__, __LINE__);
+        t.unlink();
+        SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
         attach_(t);
         return value_;
     }
 
     T get(Event *e, Event& t) {
-        LockGlobalSubject lock(__FILE__, __LINE__);
+        if (e == &t)
+            t.unlink();
+        SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
         if (e == &t)
             attach_(t);
         return value_;
@@ -63,7 +65,7 @@ struct SubjectReadOnly : public SubjectBase {
 
   protected:
     void set(const T& value, bool force = false) {
-        LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
         if (force || value != SubjectReadOnly<T>::value_) {
             SubjectReadOnly<T>::value_ = value;
             SubjectReadOnly<T>::signal();
@@ -38,26 +38,21 @@
 #include <vtss/basics/map.hxx>
 #include <vtss/basics/mutex.hxx>
 #include <vtss/basics/notifications/event-fd.hxx>
-#include <vtss/basics/notifications/lock-global-subject.hxx>
+#include <vtss/basics/notifications/subject-lock.hxx>
 #include <vtss/basics/notifications/timer.hxx>
+#include <vtss/basics/notifications/timer-wheel.hxx>
 #include <vtss/basics/predefs.hxx>
 #include <vtss/basics/time_unit.hxx>
 
 namespace vtss {
 namespace notifications {
 
-template <typename T>
-T get_relative_time(LinuxClock::time_point now, LinuxClock::time_point abs_time);
-
-template <typename T>
-constexpr T get_refresh_rate();
-
 // Subject runner is divided in two classes: SubjectRunnerEvent and
 // SubjectRunner.
 
 // SubjectRunnerEvent contains all the data that can be accessed from several
-// threads. The global lock is used to insert and remove elements from data
-// structures without jeopardizing the data structures. Elements can be taken
+// threads. The runner's own event_lock is used to insert and remove elements
+// from data structures without jeopardizing the data structures. Elements can be taken
 // in and out of data structures while a subject runner is processing an
 // element, but elements should not be deleted while being processed by the
 // subject runner.
@@ -67,7 +62,7 @@ struct SubjectRunnerEvent {
     // Return true if the timer was sucessfully removed.
     bool timer_del(Timer &t);
 
-    // Add a timer to timer_queue.
+    // Add a timer to the timer wheel matching the unit of #period.
     void timer_add(Timer &t, TimeUnit period);
 
     // Change timeout of a timer. However, if the timer already is
@@ -89,11 +84,24 @@ struct SubjectRunnerEvent {
     // Get remaining time
     vtss::milliseconds get_remaining(Timer *t) const;
 
+    // The lock protecting the event queue, timer wheels and event-fd map.
+    // Exposed to allow its counters to be inspected.
+    const SubjectLock &event_lock_get() const { return event_lock; }
+    void event_lock_counters_clear() { event_lock.counters_clear(); }
+
   protected:
     // Returns nullptr if empty
     Timer *timer_pop_msec(LinuxClock::time_point);
     Timer *timer_pop_sec(LinuxClock::time_point);
-    TimeUnitMilliseconds timer_timeout();
+
+    // Re-insert a repeating timer that has just been popped. The new expiry is
+    // one period after the previous one - or one period from #now if the
+    // runner has fallen more than a period behind.
+    void timer_rearm(Timer &t, LinuxClock::time_point now);
+
+    // Get the time of the next timer event in milliseconds since
+    // absolute_time. Returns false if there are no active timers.
+    bool timer_timeout(uint64_t *msec);
 
     // Set a mark in the event queue. This allows the subject runner to iterate
     // through the event_queue without making an infinite loop.
@@ -106,68 +114,34 @@ struct SubjectRunnerEvent {
     // Return pointer to the event-fd associated with fd.
     EventFd *event_fd_pop(int fd);
 
-    // Updates absolute time and all the timeouts in container
-    void update_absolute_time(LinuxClock::time_point time_now);
-
     int fd_cnt = 0;
     bool signaled = false;
     Fd epoll_fd;
     Fd epoll_event_fd;
     void request_service();
 
+    // Epoch of the timer wheels
     LinuxClock::time_point absolute_time;
 
   private:
-    template <typename TimeUnitT>
-    void timer_add(Timer &t, TimeUnitT timeout,
-                   intrusive::List<Timer> &container) {
-        LockGlobalSubject lock(__FILE__, __LINE__);
-        if (t.is_linked() && !timer_del_unprotected(t)) {
-            VTSS_ASSERT("Timer event belongs to an alternative subject-runner");
-        }
-
-        t.timeout(timeout + get_relative_time<TimeUnitT>(LinuxClock::now(),
-                                                         absolute_time));
-
-        container.insert_sorted(t);
-        if (&(*container.begin()) == &t) request_service();
-    }
-
-    template <typename TimeUnitT>
-    void timer_inc(Timer &t, TimeUnitT timeout,
-                   intrusive::List<Timer> &container) {
-        LockGlobalSubject lock(__FILE__, __LINE__);
-        if (t.is_linked() && !timer_del_unprotected(t)) {
-            VTSS_ASSERT("Timer event belongs to an alternative subject-runner");
-        }
-
-        t.timeout(TimeUnitT(t.timeout().get_value()) + timeout);
-
-        container.insert_sorted(t);
-        if (&(*container.begin()) == &t) request_service();
-    }
-
-    template <typename TimeUnitT>
-    Timer *timer_pop(LinuxClock::time_point now,
-                     intrusive::List<Timer> &container) {
-        LockGlobalSubject lock(__FILE__, __LINE__);
-
-        if (container.empty()) return nullptr;
-
-        auto t = container.begin();
-        if (get_relative_time<TimeUnitT>(now, absolute_time) <
-            TimeUnitT(t->timeout().get_value())) {
-            return nullptr;
-        }
-
-        container.pop_front();
-        return &(*t);
-    }
-
+    TimerWheel &timer_wheel(TimeUnit::Unit unit);
+    uint64_t timer_now(TimeUnit::Unit unit, LinuxClock::time_point now) const;
+    static uint64_t timer_expires(const Timer &t, TimeUnit::Unit unit);
+    void timer_insert(Timer &t, TimerWheel &wheel, uint64_t expires);
     bool timer_del_unprotected(Timer &t);
-    bool timer_del_unprotected(Timer &t, intrusive::List<Timer> &container);
-    intrusive::List<Timer> timer_queue_msec;
-    intrusive::List<Timer> timer_queue_sec;
+    mesa_rc event_fd_add_unprotected(EventFd &e, EventFd::E flags);
+    mesa_rc event_fd_del_unprotected(EventFd &e);
+
+    // Leaf lock, except that a subject lock may be held while taking it
+    SubjectLock event_lock;
+
+    TimerWheel timer_wheel_msec{TimeUnit::Unit::milliseconds, &event_lock};
+    TimerWheel timer_wheel_sec{TimeUnit::Unit::seconds, &event_lock};
+
+    // The time (in milliseconds since absolute_time) the runner was last told
+    // to sleep until. Timers added with an earlier expiry wake up the runner.
+    uint64_t timer_wakeup = 0;
+
     intrusive::List<Event> event_queue;
     Event *event_mark;
     Map<int, EventFd *> event_fd_queue;
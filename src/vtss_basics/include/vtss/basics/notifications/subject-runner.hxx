@@ -75,9 +75,11 @@ struct SubjectRunner : SubjectRunnerEvent {
     bool return_when_out_of_work_ = false;
     CritdRecursive runner_mutex;
 
-    TimeUnitMilliseconds run_generic();
+    // Returns false if no timers are active. Otherwise, #next_timeout is the
+    // time of the next timer event in milliseconds since absolute_time.
+    bool run_generic(uint64_t *next_timeout);
     int sleep(void *epoll_event, int max);
-    int sleep(void *epoll_event, int max, TimeUnitMilliseconds time);
+    int sleep(void *epoll_event, int max, uint64_t next_timeout);
     int epoll_wait(epoll_event *e, int max, int timeout);
 };
 
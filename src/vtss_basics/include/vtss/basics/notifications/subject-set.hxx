@@ -34,7 +34,7 @@
 #include <vtss/basics/notifications/table-observer.hxx>
 #include <vtss/basics/notifications/table-observer-pool.hxx>
 #include <vtss/basics/notifications/table-observer-values.hxx>
-#include <vtss/basics/notifications/lock-global-subject.hxx>
+#include <vtss/basics/notifications/subject-lock.hxx>
 
 namespace vtss {
 namespace notifications {
@@ -43,13 +43,17 @@ template <class K>
 struct SubjectSet {
     typedef TableObserver<K> Observer;
 
+    SubjectSet() : observers(&lock_) {}
+
     mesa_rc observer_new(notifications::Event* ev) {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        ev->unlink();
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return observers.observer_new(ev);
     }
 
     mesa_rc observer_new(notifications::Event* ev, Observer& o) {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        ev->unlink();
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         mesa_rc rc = observers.observer_new(ev);
         if (rc != MESA_RC_OK) return rc;
 
@@ -61,30 +65,31 @@ struct SubjectSet {
     }
 
     mesa_rc observer_del(notifications::Event* ev) {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return observers.observer_del(ev);
     }
 
     mesa_rc observer_get(notifications::Event* ev, Observer& o) {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        ev->unlink();
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return observers.observer_get(ev, o);
     }
 
     mesa_rc observer_mask_key(notifications::Event* ev, EventType::E et,
                               const K& k) {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return observers.observer_mask_key(ev, et, k);
     }
 
     mesa_rc get(const K& k) const {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         auto itr = data_.find(k);
         if (itr == data_.end()) return MESA_RC_ERROR;
         return MESA_RC_OK;
     }
 
     mesa_rc get_first(K& k) const {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         auto itr = data_.begin();
         if (itr == data_.end()) return MESA_RC_ERROR;
         k = *itr;
@@ -92,7 +97,7 @@ struct SubjectSet {
     }
 
     mesa_rc get_next(K& k) const {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         auto itr = data_.greater_than(k);
         if (itr == data_.end()) return MESA_RC_ERROR;
         k = *itr;
@@ -100,7 +105,7 @@ struct SubjectSet {
     }
 
     mesa_rc set(const K& k) {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         auto itr = data_.find(k);
         if (itr == data_.end()) {  // this is an add operation
             (void)data_.insert(k);
@@ -110,7 +115,7 @@ struct SubjectSet {
     }
 
     mesa_rc del(const K& k) {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         auto itr = data_.find(k);
         if (itr == data_.end()) return MESA_RC_ERROR;
         data_.erase(itr);
@@ -119,13 +124,14 @@ struct SubjectSet {
     }
 
     void clear() {
-        notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         data_.clear();
     }
 
     size_t size() const { return data_.size(); }
 
   protected:
+    mutable SubjectLock lock_;
     Set<K> data_;
     TableObserverPool<K, Observer> observers;
 };
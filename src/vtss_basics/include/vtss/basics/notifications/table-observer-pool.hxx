@@ -33,12 +33,19 @@
 #include <vtss/basics/intrusive_list.hxx>
 #include <vtss/basics/notifications/event.hxx>
 #include <vtss/basics/notifications/event-type.hxx>
+#include <vtss/basics/notifications/subject-lock.hxx>
 
 namespace vtss {
 namespace notifications {
 
+// The pool is protected by the lock of the owning table. If that lock is a
+// SubjectLock it must be passed to the constructor, to allow observer events
+// to be unlinked safely from other threads.
 template <typename Key, typename Observer>
 struct TableObserverPool {
+    TableObserverPool() {}
+    explicit TableObserverPool(SubjectLock *lock) : lock_(lock) {}
+
     void event_add(const Key &k) {
         for (auto &e : observers_) e.second.add(k);
         signal();
@@ -63,7 +70,7 @@ struct TableObserverPool {
         i->second.clear();
 
         // registere the event in the observer list.
-        observer_list_.push_back(*ev);
+        link(ev);
 
         return MESA_RC_OK;
     }
@@ -73,7 +80,11 @@ struct TableObserverPool {
 
         if (i == observers_.end()) return MESA_RC_ERROR;
         observers_.erase(i);
-        observer_list_.unlink(*ev);
+        if (lock_) {
+            ev->unlink();
+        } else {
+            observer_list_.unlink(*ev);
+        }
 
         return MESA_RC_OK;
     }
@@ -87,7 +98,7 @@ struct TableObserverPool {
         i->second.swap(o);
 
         // registere the event in the observer list.
-        observer_list_.push_back(*ev);
+        link(ev);
 
         return MESA_RC_OK;
     }
@@ -100,14 +111,30 @@ struct TableObserverPool {
     }
 
   private:
+    void link(notifications::Event *ev) {
+        if (!lock_) {
+            observer_list_.push_back(*ev);
+            return;
+        }
+
+        ev->unlink();
+        observer_list_.push_back(*ev);
+        ev->lock_.store(lock_, std::memory_order_release);
+    }
+
     void signal() {
         while (!observer_list_.empty()) {
             notifications::Event &t = observer_list_.front();
             observer_list_.pop_front();
             t.signal();
+            if (lock_) {
+                SubjectLock *l = lock_;
+                t.lock_.compare_exchange_strong(l, nullptr);
+            }
         }
     }
 
+    SubjectLock *const lock_ = nullptr;
     Map<uintptr_t, Observer> observers_;
     intrusive::List<notifications::Event> observer_list_;
 };
@@ -0,0 +1,116 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#ifndef __VTSS_BASICS_NOTIFICATIONS_TIMER_WHEEL_HXX__
+#define __VTSS_BASICS_NOTIFICATIONS_TIMER_WHEEL_HXX__
+
+#include <vtss/basics/intrusive_list.hxx>
+#include <vtss/basics/notifications/subject-lock.hxx>
+#include <vtss/basics/notifications/timer.hxx>
+#include <vtss/basics/time_unit.hxx>
+
+namespace vtss {
+namespace notifications {
+
+// Hashed hierarchical timer wheel.
+//
+// Time is measured in ticks (milliseconds or seconds, depending on the unit of
+// the wheel) since the owner's epoch. Level N has SLOTS slots, each covering
+// SLOTS^N ticks. A timer is placed in the lowest level where its expiry falls
+// within the current rotation of the level above. When time reaches the start
+// of a higher-level slot, the timers in that slot are cascaded to lower
+// levels. Timers too far out for the top level are kept in an overflow list,
+// which is revisited every SLOTS^LEVELS ticks.
+//
+// Insert and remove are O(1). Advancing time is proportional to the number of
+// expired and cascaded timers - empty slots are skipped by means of a per-level
+// bitmap.
+//
+// The wheel is not thread safe. The owner must serialize access by means of
+// #lock, which is also taken when a timer unlinks itself.
+struct TimerWheel {
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr unsigned SLOTS = 1 << SLOT_BITS;
+    static constexpr unsigned LEVELS = 6;
+
+    TimerWheel(TimeUnit::Unit unit, SubjectLock *lock)
+        : unit_(unit), lock_(lock) {}
+    TimerWheel(const TimerWheel &) = delete;
+    ~TimerWheel();
+
+    TimeUnit::Unit unit() const { return unit_; }
+
+    SubjectLock *lock() const { return lock_; }
+
+    // The tick the wheel has been advanced to.
+    uint64_t now() const { return now_; }
+
+    // Insert #t (which must not be linked) to expire at tick #expires. Timers
+    // that have already expired are returned by the next call to pop().
+    void insert(Timer &t, uint64_t expires);
+
+    // Remove #t. Returns false if #t is not in this wheel.
+    bool remove(Timer &t);
+
+    // Advance the wheel to tick #now and return the next expired timer, or
+    // nullptr if no more timers have expired.
+    Timer *pop(uint64_t now);
+
+    // Get the next tick where the owner must call pop(), which is either when
+    // a timer expires or when timers must be cascaded to a lower level.
+    // Returns false if the wheel is empty.
+    bool next_event(uint64_t *tick);
+
+    // Invoke #f on all timers in the wheel (in no particular order).
+    template <typename F>
+    void for_each(F f) {
+        for (auto &t : expired_) f(t);
+        for (unsigned l = 0; l < LEVELS; ++l)
+            for (unsigned s = 0; s < SLOTS; ++s)
+                for (auto &t : slot_[l][s]) f(t);
+        for (auto &t : overflow_) f(t);
+    }
+
+  private:
+    void place(Timer &t);
+    void cascade(intrusive::List<Timer> &list);
+    bool next_slot(uint64_t *tick);
+
+    const TimeUnit::Unit unit_;
+    SubjectLock *const lock_;
+    uint64_t now_ = 0;
+    uint64_t bitmap_[LEVELS] = {};
+    intrusive::List<Timer> slot_[LEVELS][SLOTS];
+    intrusive::List<Timer> overflow_;
+    intrusive::List<Timer> expired_;
+};
+
+}  // namespace notifications
+}  // namespace vtss
+
+#endif  // __VTSS_BASICS_NOTIFICATIONS_TIMER_WHEEL_HXX__
@@ -29,6 +29,7 @@
 #ifndef __VTSS_BASICS_NOTIFICATIONS_TIMER_HXX__
 #define __VTSS_BASICS_NOTIFICATIONS_TIMER_HXX__
 
+#include <atomic>
 #include <vtss/basics/intrusive_list.hxx>
 #include <vtss/basics/notifications/event-handler.hxx>
 #include <vtss/basics/ptr-bits2.hxx>
@@ -37,13 +38,24 @@
 namespace vtss {
 namespace notifications {
 
+struct TimerWheel;
+struct SubjectLock;
+
 struct Timer : public intrusive::ListNode {
     friend struct SubjectRunner;
     friend struct SubjectRunnerEvent;
+    friend struct TimerWheel;
 
     Timer(EventHandler *cb);
     ~Timer() { unlink(); }
 
+    // A copy is not linked into any timer wheel, and assigning to a timer
+    // unlinks it.
+    Timer(const Timer &rhs);
+    Timer &operator=(const Timer &rhs);
+
+    // Expiry relative to the epoch of the subject runner, in the unit of the
+    // timer wheel it is inserted into.
     TimeUnit timeout() const;
     bool operator<(const Timer &rhs);
 
@@ -56,13 +68,19 @@ struct Timer : public intrusive::ListNode {
     void set_repeat(bool repeat) { cb_.bit0(repeat); }
 
   private:
-    void timeout(TimeUnit to);
     void invoke_cb();
+    // expires_ in milliseconds, whatever the unit of wheel_.
+    uint64_t expires_ms() const;
 
     PtrBits2<EventHandler> cb_;
-    // timeout_ is relative to an absolute time which is updateded every refresh
-    // period. Absolute time is updated inside function update_absolute_time
-    TimeUnit timeout_;
+    // Expiry in ticks of wheel_ (milliseconds or seconds) relative to the
+    // epoch of the subject runner.
+    uint64_t expires_ = 0;
+    // The wheel the timer is (or was last) inserted into.
+    TimerWheel *wheel_ = nullptr;
+    // The lock of the wheel the timer is linked into, or nullptr if it is
+    // not linked.
+    std::atomic<SubjectLock *> lock_{nullptr};
     TimeUnit period_;
 };
 
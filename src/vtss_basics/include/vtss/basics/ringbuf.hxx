@@ -29,7 +29,10 @@
 #ifndef __RINGBUF_HXX__
 #define __RINGBUF_HXX__
 
-#include <vtss/basics/notifications/lock-global-subject.hxx>
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <vtss/basics/notifications/subject-lock.hxx>
 #include <vtss/basics/iterator.hxx>
 
 namespace vtss {
@@ -210,48 +213,224 @@ class RingBuf {
     T data_[SIZE];
 };
 
+// Thread safe ring buffer. Push overwrites the oldest element when full. See
+// RingBufSpsc and RingBufMpsc below for lock-free alternatives.
 template<typename T, unsigned SIZE>
 class RingBufConcurrent {
   public:
     RingBufConcurrent() {
-        vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        vtss::notifications::SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         impl.clear();
     }
 
     template <typename TT>
     bool push(const TT& t) {
-        vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        vtss::notifications::SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return impl.template push<TT>(t);
     }
 
     bool pop(T& t) {
-        vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        vtss::notifications::SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return impl.pop(t);
     }
 
     bool empty() const {
-        vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        vtss::notifications::SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return impl.empty();
     }
 
     bool full() const {
-        vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        vtss::notifications::SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return impl.full();
     }
 
     unsigned size() const {
-        vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        vtss::notifications::SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         return impl.size();
     }
 
     void clear() {
-        vtss::notifications::LockGlobalSubject lock(__FILE__, __LINE__);
+        vtss::notifications::SubjectLockGuard lock(&lock_, __FILE__, __LINE__);
         impl.clear();
     }
 
   private:
+    mutable vtss::notifications::SubjectLock lock_;
     RingBuf<T, SIZE> impl;
 };
 
+// Size of the cache lines the indices of the lock-free ring buffers are padded
+// to, to avoid false sharing between producers and consumer.
+static constexpr size_t RINGBUF_CACHE_LINE_SIZE = 64;
+
+// Lock-free ring buffer with one producer thread and one consumer thread.
+//
+// Same interface as RingBufConcurrent, but push() never overwrites: when the
+// buffer is full the new element is dropped and false is returned.
+//
+// push() must only be called by the producer. pop() and clear() must only be
+// called by the consumer. empty(), full() and size() may be called by anyone,
+// but are only snapshots when called concurrently with push() or pop().
+template <typename T, unsigned SIZE>
+class RingBufSpsc {
+    static_assert(SIZE > 0, "SIZE must be positive");
+    // The indices run freely and wrap at the size of size_t, which only
+    // preserves "index % SIZE" when SIZE divides it.
+    static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+  public:
+    RingBufSpsc() {}
+    RingBufSpsc(const RingBufSpsc &) = delete;
+    RingBufSpsc &operator=(const RingBufSpsc &) = delete;
+
+    template <typename TT>
+    bool push(const TT &t) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+
+        // Only re-read the consumer's index when the cached copy says full
+        if (tail - head_cache_ >= SIZE) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ >= SIZE) return false;
+        }
+
+        data_[tail % SIZE] = t;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns true if a value was pop'ed
+    bool pop(T &t) {
+        size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+
+        t = data_[head % SIZE];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() == SIZE; }
+
+    unsigned size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+
+        // The indices are read in the order that keeps tail >= head
+        return tail - head > SIZE ? SIZE : (unsigned)(tail - head);
+    }
+
+    void clear() {
+        head_.store(tail_.load(std::memory_order_acquire),
+                    std::memory_order_release);
+    }
+
+  private:
+    // Consumer side
+    alignas(RINGBUF_CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
+
+    // Producer side
+    alignas(RINGBUF_CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
+
+    alignas(RINGBUF_CACHE_LINE_SIZE) T data_[SIZE];
+};
+
+// Lock-free ring buffer with any number of producer threads and one consumer
+// thread (a bounded queue with a sequence number per slot).
+//
+// Same interface and restrictions as RingBufSpsc, except that push() may be
+// called from any thread.
+template <typename T, unsigned SIZE>
+class RingBufMpsc {
+    static_assert(SIZE > 0, "SIZE must be positive");
+    // The indices run freely and wrap at the size of size_t, which only
+    // preserves "index % SIZE" when SIZE divides it.
+    static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+  public:
+    RingBufMpsc() {
+        for (size_t i = 0; i < SIZE; ++i)
+            slot_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    RingBufMpsc(const RingBufMpsc &) = delete;
+    RingBufMpsc &operator=(const RingBufMpsc &) = delete;
+
+    template <typename TT>
+    bool push(const TT &t) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+
+        while (1) {
+            Slot &s = slot_[tail % SIZE];
+            size_t seq = s.seq.load(std::memory_order_acquire);
+
+            if (seq == tail) {
+                // The slot is free - claim it
+                if (tail_.compare_exchange_weak(tail, tail + 1,
+                                                std::memory_order_relaxed)) {
+                    s.data = t;
+                    s.seq.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+
+            } else if ((intptr_t)(seq - tail) < 0) {
+                // The slot still holds the element from the previous lap.
+                // Compared by difference to survive the indices wrapping.
+                return false;
+
+            } else {
+                // Another producer got here first
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns true if a value was pop'ed
+    bool pop(T &t) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        Slot &s = slot_[head % SIZE];
+
+        // Empty, or the producer that claimed the slot has not finished
+        if (s.seq.load(std::memory_order_acquire) != head + 1) return false;
+
+        t = s.data;
+        s.seq.store(head + SIZE, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() == SIZE; }
+
+    unsigned size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+
+        // Includes slots that are claimed, but not yet written
+        return tail - head > SIZE ? SIZE : (unsigned)(tail - head);
+    }
+
+    void clear() {
+        T t;
+        while (pop(t)) {
+        }
+    }
+
+  private:
+    struct Slot {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    alignas(RINGBUF_CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    alignas(RINGBUF_CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    alignas(RINGBUF_CACHE_LINE_SIZE) Slot slot_[SIZE];
+};
+
 }  // namespace vtss
 #endif  // __RINGBUF_HXX__
@@ -57,6 +57,13 @@ struct ostreamBuf : public ostream {
     virtual void clear() = 0;
     virtual const char * begin() const = 0;
     virtual const char * end() const = 0;
+
+    // A streaming buffer hands data on (e.g. to a socket) while it is being
+    // written. clear() can then only drop what has not yet been handed on, and
+    // retractable() tells whether everything written so far can still be
+    // dropped.
+    virtual bool streaming() const { return false; }
+    virtual bool retractable() const { return true; }
 };
 
 struct nullstream : public ostreamBuf {
@@ -81,6 +81,7 @@ vtss::json::Result::Code FunctionExporterAbstract::handle(int priv,
                                                           const Request *req,
                                                           ostreamBuf &out) {
     vtss::json::Result::Code ec;
+    ExecStatus st;
     VTSS_BASICS_TRACE(NOISE) << "Handling request: " << method_name;
 
     // Check that a leaf node was requested
@@ -118,9 +119,8 @@ vtss::json::Result::Code FunctionExporterAbstract::handle(int priv,
 
     // will invoke the function
     {
-        error_code = MESA_RC_OK;
         VTSS_BASICS_TRACE(NOISE) << "Executing";
-        ec = exec(req, &out);
+        ec = exec(req, &out, &st);
         VTSS_BASICS_TRACE(NOISE) << "Execution retuls: " << ec;
 
         if (ec == vtss::json::Result::OK) {
@@ -131,21 +131,28 @@ vtss::json::Result::Code FunctionExporterAbstract::handle(int priv,
         }
     }
 
-    if (error_code != MESA_RC_OK) {
-        VTSS_BASICS_TRACE(INFO) << "Request failed. Code: " << error_code
-                                << " Rc: " << AsErrorCode(error_code)
-                                << " Function-pointer: " << failing_function;
+    if (st.error_code != MESA_RC_OK) {
+        VTSS_BASICS_TRACE(INFO) << "Request failed. Code: " << st.error_code
+                                << " Rc: " << AsErrorCode(st.error_code)
+                                << " Function-pointer: " << st.failing_function;
     } else {
-        VTSS_BASICS_TRACE(INFO) << "Request failed. Code: " << error_code;
+        VTSS_BASICS_TRACE(INFO) << "Request failed. Code: " << st.error_code;
     }
 
 WriteResponseMsg:
+    // A response which has already been partly sent cannot be replaced. The
+    // error has been reported in it by ResponseBase.
+    if (!out.retractable()) {
+        VTSS_BASICS_TRACE(INFO) << "Response already sent, ec: " << ec;
+        return ec;
+    }
+
     // Compose a error message
     out.clear();
 
     {
         Exporter e(&out);
-        int64_t ptr = (int64_t)failing_function;
+        int64_t ptr = (int64_t)st.failing_function;
         const char *s_parse_error = "Parse error";
         const char *s_invalid_request = "Invalid request";
         const char *s_method_not_found = "Method not found";
@@ -158,20 +165,20 @@ WriteResponseMsg:
 
         Exporter::Map em = m.as_map(vtss::tag::Name("error"));
         em.add_leaf(ec, vtss::tag::Name("code"));
-        if (error_code != MESA_RC_OK) {
+        if (st.error_code != MESA_RC_OK) {
 #if defined(VTSS_USE_API_HEADERS)
-            em.add_leaf(str(error_txt(error_code)), vtss::tag::Name("message"));
+            em.add_leaf(str(error_txt(st.error_code)), vtss::tag::Name("message"));
 #else
             const char *e_txt = "Internal error";
             em.add_leaf(str(e_txt), vtss::tag::Name("message"));
 #endif
             Exporter::Map dm = em.as_map(vtss::tag::Name("data"));
-            dm.add_leaf(error_code, vtss::tag::Name("vtss-error-code"));
+            dm.add_leaf(st.error_code, vtss::tag::Name("vtss-error-code"));
             dm.add_leaf(ptr, vtss::tag::Name("vtss-failing-function-ptr"));
 #if defined(VTSS_USE_API_HEADERS)
-            dm.add_leaf(VTSS_RC_GET_MODULE_ID(error_code),
+            dm.add_leaf(VTSS_RC_GET_MODULE_ID(st.error_code),
                         vtss::tag::Name("vtss-failing-module"));
-            dm.add_leaf(VTSS_RC_GET_MODULE_CODE(error_code),
+            dm.add_leaf(VTSS_RC_GET_MODULE_CODE(st.error_code),
                         vtss::tag::Name("vtss-module-code"));
 #endif
         } else {
@@ -201,17 +208,17 @@ WriteResponseMsg:
             }
 
             Exporter::Map dm = em.as_map(vtss::tag::Name("data"));
-            if (arguments_got != arguments_expect) {
-                dm.add_leaf(arguments_expect,
+            if (st.arguments_got != st.arguments_expect) {
+                dm.add_leaf(st.arguments_expect,
                             vtss::tag::Name("vtss-argument-cnt-expect"));
-                dm.add_leaf(arguments_got,
+                dm.add_leaf(st.arguments_got,
                             vtss::tag::Name("vtss-argument-cnt-actual"));
             } else {
-                if (error_argument_index || ec ==  vtss::json::Result::INVALID_PARAMS)
-                    dm.add_leaf(error_argument_index,
+                if (st.error_argument_index || ec ==  vtss::json::Result::INVALID_PARAMS)
+                    dm.add_leaf(st.error_argument_index,
                                 vtss::tag::Name("vtss-failing-argument-index"));
-                if (argument_not_found && ec ==  vtss::json::Result::INVALID_PARAMS)
-                    dm.add_leaf(str(argument_not_found),
+                if (st.argument_not_found && ec ==  vtss::json::Result::INVALID_PARAMS)
+                    dm.add_leaf(str(st.argument_not_found),
                                 vtss::tag::Name("vtss-argument-not-found"));
             }
         }
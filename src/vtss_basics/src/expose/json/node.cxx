@@ -40,9 +40,17 @@ Node::Node(NamespaceNode *p, const char *n, const char *d)
 }
 
 void Node::attach_to(NamespaceNode *p) {
+    if (is_linked()) notify_tree_changed();
     unlink();
     p->attach__(this);
     parent_ = p;
+    notify_tree_changed();
+}
+
+void Node::notify_tree_changed() {
+    Node *n = this;
+    while (n->parent_) n = n->parent_;
+    n->tree_changed();
 }
 
 std::string Node::abs_name(const std::string &n) const {
@@ -36,6 +36,7 @@ namespace json {
 ResponseBase::ResponseBase(ostreamBuf *os, const JsonValue &id)
     : response(os),
       response_map(response.as_map()),
+      result_stream(this, os),
       result(&result_stream),
       err(&err_stream),
       err_map(err.as_map()) {
@@ -54,7 +55,30 @@ void ResponseBase::error(vtss::json::Result::Code c) {
     error_ = c;
 }
 
+void ResponseBase::ResultStream::spill_prefix() {
+    owner->response_map.as_ref("result");
+}
+
 ResponseBase::~ResponseBase() {
+    if (result_stream.spilled()) {
+        // A result which failed to serialize can no longer be dropped by the
+        // caller, so it must be flagged here.
+        if (!result.ok() && ok()) error(vtss::json::Result::INTERNAL_ERROR);
+
+        err_map.close();
+        result_stream.terminate();
+
+        if (ok()) {
+            response_map.add_leaf(lit_null, vtss::tag::Name("error"));
+        } else {
+            response_map.add_leaf(
+                    JsonEncodedData(err_stream.begin(), err_stream.end()),
+                    vtss::tag::Name("error"));
+        }
+
+        return;
+    }
+
     // Map must be explicit closed, it destructor runs too late!
     err_map.close();
 
@@ -26,6 +26,8 @@
 
 */
 
+#include <string.h>
+#include <vtss/basics/map.hxx>
 #include <vtss/basics/trace_grps.hxx>
 #define VTSS_TRACE_DEFAULT_GROUP VTSS_BASICS_TRACE_GRP_JSON
 
@@ -34,6 +36,7 @@
 #include "vtss/basics/expose/json/exporter.hxx"
 #include "vtss/basics/expose/json/loader.hxx"
 #include "vtss/basics/expose/json/root-node.hxx"
+#include "vtss/basics/expose/json/spill-stream.hxx"
 
 namespace vtss {
 namespace expose {
@@ -51,6 +54,112 @@ static vtss::json::Result::Code make_invalid_req(Exporter::Map &m) {
     return rc;
 }
 
+// Adds the full names of the nodes below 'ns'. Where names are repeated
+// within a namespace, the tree search only ever finds the first node, so only
+// that one is added.
+static void index_add(Map<std::string, Node *> &names, NamespaceNode *ns,
+                      const std::string &prefix) {
+    for (auto &n : ns->leafs) {
+        str s = n.name();
+
+        // Not reachable by the tree search either
+        if (s.begin() == s.end() || find(s.begin(), s.end(), '.') != s.end())
+            continue;
+
+        std::string name(prefix);
+        if (name.size()) name.push_back('.');
+        name.append(s.begin(), s.size());
+
+        if (!names.insert(vtss::make_pair(name, &n)).second) continue;
+
+        if (n.is_namespace_node())
+            index_add(names, static_cast<NamespaceNode *>(&n), name);
+    }
+}
+
+static int index_compare(const std::string &a, const str &b) {
+    size_t l = a.size() < b.size() ? a.size() : b.size();
+    int res = l ? memcmp(a.data(), b.begin(), l) : 0;
+
+    if (res) return res;
+    if (a.size() == b.size()) return 0;
+    return a.size() < b.size() ? -1 : 1;
+}
+
+// The tree search checks that the namespaces on the way are implemented
+static bool implemented_above(const Node *n, const Node *top) {
+    for (n = n->parent(); n && n != top; n = n->parent())
+        if (!n->implemented()) return false;
+
+    return true;
+}
+
+void RootNode::freeze() {
+    Map<std::string, Node *> names;
+    std::shared_ptr<Index> index = std::make_shared<Index>();
+
+    index_add(names, this, std::string());
+
+    index->reserve(names.size());
+    for (const auto &e : names) index->push_back(IndexEntry{e.first, e.second});
+
+    VTSS_BASICS_TRACE(INFO) << "Method index holds " << index->size()
+                            << " names";
+    std::atomic_store(&index_, std::shared_ptr<const Index>(index));
+}
+
+bool RootNode::frozen() const {
+    return std::atomic_load(&index_) != nullptr;
+}
+
+void RootNode::tree_changed() {
+    std::atomic_store(&index_, std::shared_ptr<const Index>());
+}
+
+Node *RootNode::index_lookup(str method_name) const {
+    std::shared_ptr<const Index> index = std::atomic_load(&index_);
+    size_t lo = 0, hi;
+
+    if (!index) return nullptr;
+
+    hi = index->size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int res = index_compare((*index)[mid].name, method_name);
+
+        if (res == 0) return (*index)[mid].node;
+
+        if (res < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return nullptr;
+}
+
+Node *RootNode::lookup(str method_name) {
+    Node *n = index_lookup(method_name);
+
+    if (n && implemented_above(n, this)) return n;
+
+    return NamespaceNode::lookup(method_name);
+}
+
+vtss::json::Result::Code RootNode::dispatch(int priv, str method_name,
+                                            const Request *req,
+                                            ostreamBuf &out) {
+    Node *n = index_lookup(method_name);
+
+    // Everything else, including composing the error responses, is left to
+    // the tree search.
+    if (n && !n->is_namespace_node() && implemented() && n->implemented() &&
+        implemented_above(n, this))
+        return n->handle(priv, str(), req, out);
+
+    return handle(priv, method_name, req, out);
+}
+
 vtss::json::Result::Code RootNode::single_req(int priv, str input,
                                               ostreamBuf &out) {
     Request single_req;
@@ -60,7 +169,116 @@ vtss::json::Result::Code RootNode::single_req(int priv, str input,
 
     VTSS_BASICS_TRACE(NOISE) << "Handling single request";
 
-    return handle(priv, str(single_req.method.begin()), &single_req, out);
+    return dispatch(priv, str(single_req.method.begin()), &single_req, out);
+}
+
+// Handle one call of a batch and add its response to 't'. 'req' is nullptr if
+// the call could not be parsed.
+static void batch_call(RootNode *root, int priv, Exporter::Tuple &t,
+                       const Request *req, ostreamBuf &out) {
+    Exporter::Ref ref = t.as_ref();
+
+    if (!req) {
+        Exporter::Map m = ref.as_map();
+        (void)make_invalid_req(m);
+        return;
+    }
+
+    // Buffers the sub-response, unless it is large and the output is
+    // streamed, in which case it is written straight into 'out'.
+    SpillStream oo(&out);
+
+    (void)root->dispatch(priv, str(req->method.begin()), req, oo);
+    if (oo.size() == 0) {
+        Exporter::Map m = ref.as_map();
+        (void)make_invalid_req(m);
+    } else if (!oo.spilled()) {
+        ref.raw_write(oo.begin(), oo.end());
+    }
+}
+
+namespace {
+
+// A call of a batch which is run by a BatchExecutor
+struct BatchCall : public BatchExecutor::Job {
+    void exec() {
+        (void)root->dispatch(priv, str(req.method.begin()), &req, out);
+    }
+
+    RootNode *root = nullptr;
+    int priv = 0;
+    bool loaded = false;
+    bool read_only = false;
+    Request req;
+    StringStream out;
+};
+
+}  // namespace
+
+static bool read_only_method(str method_name) {
+    const char *b = method_name.end();
+
+    while (b != method_name.begin() && *(b - 1) != '.') --b;
+
+    str last(b, method_name.end());
+    return last == str("get") || last == str("itr");
+}
+
+static void batch_concurrent(RootNode *root, int priv,
+                             const JsonArrayPtr &batch, Exporter::Tuple &t,
+                             ostreamBuf &out, BatchExecutor *executor) {
+    size_t n = batch.data.size(), i = 0, j, k;
+    Vector<BatchCall> calls;
+    Vector<BatchExecutor::Job *> jobs;
+
+    // Parse all calls up front, the executor needs them in a row
+    calls.reserve(n);
+    jobs.reserve(n);
+    for (const auto &e : batch.data) {
+        Loader ll(e.begin(), e.end());
+
+        VTSS_BASICS_TRACE(NOISE) << "Sub msg: " << e.as_str();
+
+        calls.emplace_back();
+        BatchCall &c = calls.back();
+        c.root = root;
+        c.priv = priv;
+        c.loaded = ll.load(c.req);
+        c.read_only = c.loaded && read_only_method(str(c.req.method.begin()));
+    }
+
+    while (i < n) {
+        // A call which may change something must see the effect of the calls
+        // before it, and be seen by the calls after it.
+        for (j = i; j < n && calls[j].read_only; ++j)
+            ;
+
+        if (j - i < 2) {
+            batch_call(root, priv, t, calls[i].loaded ? &calls[i].req : nullptr,
+                       out);
+            i++;
+            continue;
+        }
+
+        VTSS_BASICS_TRACE(NOISE) << "Running calls " << i << "-" << j - 1
+                                 << " concurrently";
+        jobs.clear();
+        for (k = i; k < j; ++k) jobs.push_back(&calls[k]);
+        executor->run(jobs.data(), jobs.size());
+
+        for (k = i; k < j; ++k) {
+            Exporter::Ref ref = t.as_ref();
+
+            if (calls[k].out.buf.size() == 0) {
+                Exporter::Map m = ref.as_map();
+                (void)make_invalid_req(m);
+            } else {
+                ref.raw_write(calls[k].out.begin(), calls[k].out.end());
+            }
+        }
+
+        i = j;
+    }
 }
 
 vtss::json::Result::Code RootNode::batch_req(int priv, str input,
@@ -68,6 +286,7 @@ vtss::json::Result::Code RootNode::batch_req(int priv, str input,
     JsonArrayPtr batch_req;
     Loader l(input.begin(), input.end());
     vtss::json::Result::Code rc = vtss::json::Result::INVALID_REQUEST;
+    BatchExecutor *executor = batch_executor_;
 
     if (!l.load(batch_req)) return rc;
 
@@ -81,26 +300,17 @@ vtss::json::Result::Code RootNode::batch_req(int priv, str input,
 
     VTSS_BASICS_TRACE(NOISE) << "Handling batch request - start";
     Exporter::Tuple t = e.as_tuple();
-    for (const auto &e : batch_req.data) {
-        Exporter::Ref ref = t.as_ref();
-        Request single_req;
-        Loader ll(e.begin(), e.end());
-        StringStream oo;
+    if (executor && batch_req.data.size() > 1) {
+        batch_concurrent(this, priv, batch_req, t, out, executor);
+    } else {
+        for (const auto &e : batch_req.data) {
+            Request single_req;
+            Loader ll(e.begin(), e.end());
 
-        VTSS_BASICS_TRACE(NOISE) << "Sub msg: " << e.as_str();
+            VTSS_BASICS_TRACE(NOISE) << "Sub msg: " << e.as_str();
 
-        if (!ll.load(single_req)) {
-            Exporter::Map m = ref.as_map();
-            (void)make_invalid_req(m);
-            continue;
-        }
-
-        rc = handle(priv, str(single_req.method.begin()), &single_req, oo);
-        if (oo.buf.size() == 0) {
-            Exporter::Map m = ref.as_map();
-            (void)make_invalid_req(m);
-        } else {
-            ref.raw_write(oo.begin(), oo.end());
+            batch_call(this, priv, t,
+                       ll.load(single_req) ? &single_req : nullptr, out);
         }
     }
 
@@ -109,17 +319,19 @@ vtss::json::Result::Code RootNode::batch_req(int priv, str input,
 }
 
 vtss::json::Result::Code RootNode::process(int priv, str input, ostreamBuf &out) {
-    vtss::json::Result::Code rc;
+    const char *i = input.begin();
 
     VTSS_BASICS_TRACE(NOISE) << "Root node";
 
-    // Try load as a single request
-    rc = single_req(priv, input, out);
-    if (rc != vtss::json::Result::INVALID_REQUEST) return rc;
+    // A single request is an object and a batch is an array, so the first
+    // character tells how to parse it.
+    while (i != input.end() &&
+           (*i == ' ' || *i == '\t' || *i == '\r' || *i == '\n'))
+        ++i;
+
+    if (i != input.end() && *i == '{') return single_req(priv, input, out);
 
-    // Try load as a batch request
-    rc = batch_req(priv, input, out);
-    if (rc != vtss::json::Result::INVALID_REQUEST) return rc;
+    if (i != input.end() && *i == '[') return batch_req(priv, input, out);
 
     // Failed to load
     VTSS_BASICS_TRACE(NOISE) << "Failed to load request";
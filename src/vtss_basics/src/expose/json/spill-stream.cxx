@@ -0,0 +1,165 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#include <vtss/basics/expose/json/spill-stream.hxx>
+
+namespace vtss {
+namespace expose {
+namespace json {
+
+static thread_local size_t usage_current;
+static thread_local size_t usage_peak;
+
+size_t buffer_usage_current() { return usage_current; }
+
+size_t buffer_usage_peak() { return usage_peak; }
+
+void buffer_usage_reset() { usage_peak = usage_current; }
+
+void buffer_usage_update(size_t old_size, size_t new_size) {
+    usage_current = usage_current - old_size + new_size;
+    if (usage_current > usage_peak) usage_peak = usage_current;
+}
+
+SpillStream::SpillStream(ostreamBuf *parent, size_t limit)
+    : parent_(parent), limit_(limit) {}
+
+SpillStream::~SpillStream() { buffer_usage_update(buf_.size(), 0); }
+
+bool SpillStream::ok() const { return spilled_ ? parent_->ok() : true; }
+
+bool SpillStream::push(char c) { return write(&c, &c + 1) == 1; }
+
+size_t SpillStream::write(const char *b, const char *e) {
+    size_t old_size = buf_.size();
+
+    size_ += e - b;
+    if (spilled_) {
+        track(b, e);
+        return parent_->write(b, e);
+    }
+
+    buf_.append(b, e - b);
+    buffer_usage_update(old_size, buf_.size());
+
+    if (buf_.size() >= limit_ && parent_->streaming()) spill();
+
+    return e - b;
+}
+
+void SpillStream::clear() {
+    // Whatever has been handed on is out of reach
+    if (spilled_) return;
+
+    buffer_usage_update(buf_.size(), 0);
+    buf_.clear();
+    size_ = 0;
+}
+
+void SpillStream::spill() {
+    spilled_ = true;
+    spill_prefix();
+
+    track(begin(), end());
+    parent_->write(begin(), end());
+
+    // Give the memory back, the buffer is not used any more
+    buffer_usage_update(buf_.size(), 0);
+    std::string().swap(buf_);
+}
+
+void SpillStream::track(const char *b, const char *e) {
+    for (; b != e; ++b) {
+        char c = *b;
+
+        if (in_string_) {
+            if (escape_) {
+                escape_ = false;
+            } else if (c == '\\') {
+                escape_ = true;
+            } else if (c == '"') {
+                in_string_ = false;
+                last_ = c;
+            }
+            continue;
+        }
+
+        switch (c) {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            continue;
+
+        case '"':
+            in_string_ = true;
+            break;
+
+        case '{':
+            open_.push_back('}');
+            break;
+
+        case '[':
+            open_.push_back(']');
+            break;
+
+        case '}':
+        case ']':
+            if (open_.size()) open_.pop_back();
+            break;
+        }
+
+        last_ = c;
+    }
+}
+
+void SpillStream::terminate() {
+    if (!spilled_) return;
+
+    if (in_string_) {
+        // Do not let the closing quote be escaped
+        if (escape_) push('\\');
+        push('"');
+    }
+
+    // A value is missing after a member name, a delimiter or at the very
+    // beginning. After a delimiter in an object a member name is missing too.
+    if (last_ == 0 || last_ == ':' ||
+        (last_ == ',' && (open_.empty() || open_.back() == ']'))) {
+        *this << "null";
+    } else if (last_ == ',') {
+        *this << "\"\":null";
+    }
+
+    // track() pops the closing characters as they pass
+    while (open_.size()) push(open_.back());
+}
+
+}  // namespace json
+}  // namespace expose
+}  // namespace vtss
@@ -36,6 +36,47 @@ namespace vtss {
 namespace expose {
 namespace snmp {
 
+// Fetch the row at 'idx' (get), or the one after it (get-next), into 'own' or
+// the row cache of the handler. Returns the iterator holding the row, and sets
+// 'row' to its index.
+static IteratorCommon *fetch_row(GetHandler &g, StructBase &o, bool getnext,
+                                 const OidSequence &idx, OidSequence &row,
+                                 unique_ptr<IteratorCommon> &own) {
+    IteratorCommon *i = nullptr;
+    mesa_rc rc;
+
+    if (g.row_cache) {
+        i = g.row_cache->find(&o, getnext, idx, row);
+        if (i) return i;
+
+        // The cache takes over the iterator, so it cannot be reused
+        own.reset();
+    }
+
+    if (!own) own = o.new_iterator();
+    if (!own) return nullptr;
+
+    if (getnext) {
+        // 'idx' and 'row' may be the same
+        OidSequence from(idx);
+        row.clear();
+        rc = own->get_next(from, row);
+        if (rc != MESA_RC_OK) return nullptr;
+
+        if (g.row_cache)
+            return g.row_cache->add(&o, getnext, from, row, vtss::move(own));
+    } else {
+        row = idx;
+        rc = own->get(idx);
+        if (rc != MESA_RC_OK) return nullptr;
+
+        if (g.row_cache)
+            return g.row_cache->add(&o, getnext, idx, row, vtss::move(own));
+    }
+
+    return own.get();
+}
+
 void serialize_get_struct_ro_generic(GetHandler &h, StructBase &o) {
     VTSS_BASICS_TRACE(VTSS_BASICS_TRACE_GRP_SNMP, NOISE) << __PRETTY_FUNCTION__;
 
@@ -56,11 +97,11 @@ void serialize_get_struct_ro_generic(GetHandler &h, StructBase &o) {
         h.next_index = h.oid_seq_index;
     }
 
-    // Create a new iterator which holds the values
-    auto iter = o.new_iterator();
-
     // Ask the iterator to call the get function.
-    if (!iter || iter->get(h.next_index) != MESA_RC_OK) {
+    unique_ptr<IteratorCommon> own;
+    OidSequence idx(h.next_index);
+    IteratorCommon *iter = fetch_row(h, o, false, idx, h.next_index, own);
+    if (!iter) {
         if (h.getnext)
             h.state(HandlerState::AGAIN);
         else
@@ -82,27 +123,18 @@ void serialize_get_table_ro_generic(GetHandler &g, StructBase &o) {
     if (!g.consume_oid(1)) return;
 
     // Fetch the values
-    auto i = o.new_iterator();
+    unique_ptr<IteratorCommon> own;
+    IteratorCommon *i =
+            fetch_row(g, o, g.getnext, g.oid_seq_index, g.next_index, own);
 
-    // Prepare the first iteration
-    if (g.getnext) {
-        g.next_index.clear();
-        if (!i || i->get_next(g.oid_seq_index, g.next_index) != MESA_RC_OK) {
+    if (!i) {
+        if (g.getnext)
             g.state(HandlerState::AGAIN);
-            return;
-        }
-
-    } else {
-        g.next_index = g.oid_seq_index;
-        if (!i || i->get(g.oid_seq_index) != MESA_RC_OK) {
+        else
             g.error_code(ErrorCode::noSuchName, __FILE__, __LINE__);
-            return;
-        }
+        return;
     }
 
-    // Out of memory? (or maybe other cases???)
-    if (!i.get()) return;
-
     if (!g.getnext) {  // implement the get-handler path
         i->call_serialize_values(g);
         return;
@@ -124,7 +156,8 @@ void serialize_get_table_ro_generic(GetHandler &g, StructBase &o) {
 
         // call the "itr" function followed by "get", until both succedes or the
         // "itr" function fails (which means end-of-table).
-        if (i->get_next(g.next_index, g.next_index) != MESA_RC_OK) break;
+        i = fetch_row(g, o, true, g.next_index, g.next_index, own);
+        if (!i) break;
 
         // Restore the seraching state (was in AGAIN state).
         g.state(HandlerState::SEARCHING);
@@ -30,6 +30,8 @@
 #include <stdlib.h>
 #include "vtss/basics/snmp.hxx"
 #include "vtss/basics/expose/snmp/utils.hxx"
+#include "vtss/basics/expose/snmp/oid_trie.hxx"
+#include "vtss/basics/expose/snmp/row_cache.hxx"
 #include "vtss/basics/expose/snmp/handlers/linux/walkcapture_linux.hxx"
 #include "vtss/basics/trace_basics.hxx"
 #include "vtss/basics/formatting_tags.hxx"
@@ -333,6 +335,38 @@ static vtss::expose::snmp::OidSequence SNMP_oid_name_and_index;
 static vtss::expose::snmp::OidSequence SNMP_seq_in;
 static vtss::expose::snmp::Action::E last_action = vtss::expose::snmp::Action::reserve1;
 
+// Finds the table or scalar group of a request without searching the tree
+static vtss::expose::snmp::OidTrie SNMP_oid_trie(&vtss::expose::snmp::vtss_snmp_globals.iso);
+
+// Rows fetched by the current request, see SNMP_row_cache_get()
+static vtss::expose::snmp::RowCache SNMP_row_cache;
+static netsnmp_agent_session *SNMP_row_cache_session;
+static long SNMP_row_cache_transid;
+
+// The row cache is only used for the PDU it was filled by. The var-binds of a
+// PDU, and all repetitions of a GETBULK, are handled in the same session.
+static vtss::expose::snmp::RowCache *SNMP_row_cache_get() {
+    netsnmp_agent_session *asp = netsnmp_get_current_agent_session();
+
+    if (!asp || !asp->pdu) {
+        SNMP_row_cache.clear();
+        SNMP_row_cache_session = nullptr;
+        return nullptr;
+    }
+
+    if (asp != SNMP_row_cache_session ||
+        asp->pdu->transid != SNMP_row_cache_transid) {
+        VTSS_BASICS_TRACE(NOISE) << "New request, row cache hits: "
+                                 << SNMP_row_cache.hits << " misses: "
+                                 << SNMP_row_cache.misses;
+        SNMP_row_cache.clear();
+        SNMP_row_cache_session = asp;
+        SNMP_row_cache_transid = asp->pdu->transid;
+    }
+
+    return &SNMP_row_cache;
+}
+
 static int VTSS_SNMP_write_handler_reserve1(u_char *var_val,
                                             u_char var_val_type,
                                             size_t var_val_len) {
@@ -348,7 +382,7 @@ static int VTSS_SNMP_write_handler_reserve1(u_char *var_val,
     }
 
     SetHandler set(SNMP_oid_name, SNMP_oid_index, var_val, var_val_len, t);
-    serialize(set, vtss::expose::snmp::vtss_snmp_globals.iso);
+    serialize(set, SNMP_oid_trie);
 
     VTSS_BASICS_TRACE(INFO) << "Snmp write handler reserve1: " << SNMP_oid_name
                             << " value: " << Binary(var_val, var_val_len)
@@ -473,6 +507,9 @@ int VTSS_SNMP_default_write_handler(int action, u_char *var_val,
     VTSS_BASICS_TRACE(NOISE) << "Action: " << a
                              << " last action: " << last_action;
 
+    // Rows read before the set may be stale
+    SNMP_row_cache.clear();
+
     switch (a) {
     case Action::reserve1:
         // Allow repeated calls when handling bulk requests
@@ -542,7 +579,8 @@ u_char *VTSS_SNMP_default_handler(struct variable *vp, oid *name,
 
     if (exact) {
         GetHandler get(SNMP_oid_name, SNMP_oid_index, false);
-        serialize(get, vtss::expose::snmp::vtss_snmp_globals.iso);
+        get.row_cache = SNMP_row_cache_get();
+        serialize(get, SNMP_oid_trie);
 
         if (get.state() != vtss::expose::snmp::HandlerState::DONE) {
             VTSS_BASICS_TRACE(INFO) << "Could not complete: " << SNMP_oid_name
@@ -561,7 +599,8 @@ u_char *VTSS_SNMP_default_handler(struct variable *vp, oid *name,
 
     } else {
         GetHandler getnext(SNMP_oid_name, SNMP_oid_index, true);
-        serialize(getnext, vtss::expose::snmp::vtss_snmp_globals.iso);
+        getnext.row_cache = SNMP_row_cache_get();
+        serialize(getnext, SNMP_oid_trie);
 
         if (getnext.state() != vtss::expose::snmp::HandlerState::DONE) {
             VTSS_BASICS_TRACE(INFO) << "Could not complete: " << SNMP_oid_name
@@ -0,0 +1,142 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#include "vtss/basics/trace_grps.hxx"
+#define VTSS_TRACE_DEFAULT_GROUP VTSS_BASICS_TRACE_GRP_SNMP
+
+#include "vtss/basics/trace_basics.hxx"
+#include "vtss/basics/expose/snmp/oid_trie.hxx"
+
+namespace vtss {
+namespace expose {
+namespace snmp {
+
+static uint32_t children(NamespaceNode *ns) {
+    uint32_t cnt = 0;
+
+    for (auto i = ns->leafs.begin(); i != ns->leafs.end(); ++i) cnt++;
+    return cnt;
+}
+
+bool OidTrie::valid() {
+    if (built_ && generation_ == Node::generation) return ok_;
+
+    entries_.clear();
+    generation_ = Node::generation;
+    built_ = true;
+    builds_++;
+
+    root_first_ = 0;
+    root_cnt_ = children(root_);
+    ok_ = entries_.insert(entries_.end(), root_cnt_, Entry()) &&
+          build(root_, root_first_);
+
+    VTSS_BASICS_TRACE(INFO) << "OID trie built: " << entries_.size()
+                            << " entries" << (ok_ ? "" : " (not usable)");
+
+    if (!ok_) entries_.clear();
+    return ok_;
+}
+
+// Fill in the entries from 'first' for the children of 'ns', which have been
+// allocated by the caller.
+bool OidTrie::build(NamespaceNode *ns, uint32_t first) {
+    uint32_t idx = first;
+
+    for (auto &n : ns->leafs) {
+        uint32_t oid = n.element().numeric_;
+
+        if (idx != first && entries_[idx - 1].oid >= oid) {
+            VTSS_BASICS_TRACE(WARNING) << "OID element " << oid << " of "
+                                       << n.element() << " not unique";
+            return false;
+        }
+
+        entries_[idx].oid = oid;
+        entries_[idx].first = 0;
+        entries_[idx].cnt = 0;
+        entries_[idx].leaf = nullptr;
+
+        if (n.get_kind() == Node::Leaf) {
+            entries_[idx].leaf = static_cast<StructBase *>(&n);
+        } else {
+            NamespaceNode *c = static_cast<NamespaceNode *>(&n);
+            uint32_t c_first = entries_.size();
+            uint32_t c_cnt = children(c);
+
+            // 'entries_' may move, so it is indexed rather than referenced
+            entries_[idx].first = c_first;
+            entries_[idx].cnt = c_cnt;
+            if (!entries_.insert(entries_.end(), c_cnt, Entry()) ||
+                !build(c, c_first))
+                return false;
+        }
+
+        idx++;
+    }
+
+    return true;
+}
+
+StructBase *OidTrie::find(const OidSequence &oid, uint32_t *depth) const {
+    uint32_t first = root_first_, cnt = root_cnt_, i;
+
+    if (oid.valid == 0 || oid.oids[0] != root_->element().numeric_)
+        return nullptr;
+
+    for (i = 1; i < oid.valid && cnt; ++i) {
+        const Entry *b = entries_.data() + first, *e = b + cnt;
+
+        // Binary search for oid.oids[i] among the children
+        while (b < e) {
+            const Entry *m = b + (e - b) / 2;
+
+            if (m->oid < oid.oids[i])
+                b = m + 1;
+            else
+                e = m;
+        }
+
+        if (b == entries_.data() + first + cnt || b->oid != oid.oids[i])
+            return nullptr;
+
+        if (b->leaf) {
+            *depth = i;
+            return b->leaf;
+        }
+
+        first = b->first;
+        cnt = b->cnt;
+    }
+
+    return nullptr;
+}
+
+}  // namespace snmp
+}  // namespace expose
+}  // namespace vtss
@@ -0,0 +1,90 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#include "vtss/basics/trace_grps.hxx"
+#define VTSS_TRACE_DEFAULT_GROUP VTSS_BASICS_TRACE_GRP_SNMP
+
+#include "vtss/basics/trace_basics.hxx"
+#include "vtss/basics/expose/snmp/row_cache.hxx"
+
+namespace vtss {
+namespace expose {
+namespace snmp {
+
+void RowCache::clear() {
+    for (uint32_t i = 0; i < cnt_; ++i) {
+        entries_[i].table = nullptr;
+        entries_[i].iter.reset();
+    }
+
+    next_ = 0;
+    cnt_ = 0;
+}
+
+IteratorCommon *RowCache::find(const StructBase *table, bool getnext,
+                               const OidSequence &idx, OidSequence &row) {
+    // Newest first, a walk asks for the row it just got
+    for (uint32_t n = 0; n < cnt_; ++n) {
+        Entry &e = entries_[(next_ + SIZE - 1 - n) % SIZE];
+
+        if (e.table != table) continue;
+
+        // Any row will do for a get, but a get-next must have started at the
+        // same index.
+        if (getnext ? (!e.getnext || e.idx != idx) : e.row != idx) continue;
+
+        VTSS_BASICS_TRACE(NOISE) << "Hit: " << idx << " -> " << e.row;
+        row = e.row;
+        hits++;
+        return e.iter.get();
+    }
+
+    misses++;
+    return nullptr;
+}
+
+IteratorCommon *RowCache::add(const StructBase *table, bool getnext,
+                              const OidSequence &idx, const OidSequence &row,
+                              unique_ptr<IteratorCommon> &&i) {
+    Entry &e = entries_[next_];
+
+    e.table = table;
+    e.getnext = getnext;
+    e.idx = idx;
+    e.row = row;
+    e.iter = vtss::move(i);
+
+    next_ = (next_ + 1) % SIZE;
+    if (cnt_ < SIZE) cnt_++;
+
+    return e.iter.get();
+}
+
+}  // namespace snmp
+}  // namespace expose
+}  // namespace vtss
@@ -91,6 +91,8 @@ KnownOid *is_known_oid(const NamespaceNode *o) {
     return nullptr;
 }
 
+uint32_t Node::generation = 0;
+
 void print_numeric_oid_seq(ostream *os, const NamespaceNode *o) {
     KnownOid *known_oid = is_known_oid(o);
     if (known_oid) {
@@ -51,7 +51,8 @@ void EventFd::close() {
 }
 
 void EventFd::unsubscribe() {
-    if (sr_) sr_->event_fd_del(*this);
+    SubjectRunnerEvent *sr = sr_.load(std::memory_order_acquire);
+    if (sr) sr->event_fd_del(*this);
 }
 
 void EventFd::invoke_cb() {
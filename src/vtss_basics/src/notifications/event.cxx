@@ -29,6 +29,7 @@
 #include "vtss/basics/notifications/event.hxx"
 #include "vtss/basics/notifications/event-handler.hxx"
 #include "vtss/basics/notifications/lock-global-subject.hxx"
+#include "vtss/basics/notifications/subject-lock.hxx"
 
 namespace vtss {
 namespace notifications {
@@ -44,8 +45,28 @@ void Event::execute() {
 }
 
 void Event::unlink() {
-    LockGlobalSubject lock(__FILE__, __LINE__);
-    intrusive::ListNode::unlink();
+    while (1) {
+        SubjectLock *l = lock_.load(std::memory_order_acquire);
+
+        if (l == nullptr) {
+            // Only the owner of an event links it into a list, so an event
+            // that is not linked stays that way.
+            if (!is_linked()) return;
+
+            LockGlobalSubject lock(__FILE__, __LINE__);
+            if (lock_.load(std::memory_order_acquire) != nullptr) continue;
+            intrusive::ListNode::unlink();
+            return;
+        }
+
+        // The event may be moved to another list (from a subject to a subject
+        // runner) while we are waiting for the lock.
+        SubjectLockGuard lock(l, __FILE__, __LINE__);
+        if (lock_.load(std::memory_order_acquire) != l) continue;
+        intrusive::ListNode::unlink();
+        lock_.store(nullptr, std::memory_order_release);
+        return;
+    }
 }
 
 void Event::unlink_() {
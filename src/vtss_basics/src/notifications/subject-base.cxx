@@ -28,7 +28,6 @@
 
 #include "vtss/basics/trace_basics.hxx"
 #include "vtss/basics/notifications/subject-base.hxx"
-#include <vtss/basics/notifications/lock-global-subject.hxx>
 
 #define TRACE(X) VTSS_BASICS_TRACE(VTSS_BASICS_TRACE_GRP_NOTIFICATIONS, X)
 
@@ -36,7 +35,7 @@ namespace vtss {
 namespace notifications {
 
 void SubjectBase::signal() {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
 
     TRACE(NOISE) << "Signal " << (void *)this;
 
@@ -45,29 +44,38 @@ void SubjectBase::signal() {
         event_list_.pop_front();
 
         TRACE(NOISE) << "Signal-event " << (void *)this << " " << (void *)(&t);
+
+        // The event keeps pointing to the subject lock until the subject
+        // runner has taken over (or not, if there is no handler).
         t.signal();
+        SubjectLock *l = &subject_lock;
+        t.lock_.compare_exchange_strong(l, nullptr);
     }
 }
 
 void SubjectBase::attach(Event &e) {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    e.unlink();
+    SubjectLockGuard lock(&subject_lock, __FILE__, __LINE__);
     attach_(e);
 }
 
 bool SubjectBase::detach(Event &e) {
-    LockGlobalSubject lock(__FILE__, __LINE__);
     TRACE(NOISE) << "Signal-detach " << (void *)this << " " << (void *)(&e);
-    event_list_.unlink(e);
+    e.unlink();
     return true;
 }
 
 void SubjectBase::attach_(Event &e) {
     TRACE(NOISE) << "Signal-attach " << (void *)this << " " << (void *)(&e);
 
-    if (e.is_linked())
-        detach(e);
+    // The event may be queued in a subject runner or attached to another
+    // subject. Event::unlink() takes the lock of whichever list it is in.
+    // Callers should unlink the event before taking the subject lock, as
+    // subject locks must not be nested.
+    e.unlink();
 
     event_list_.push_back(e);
+    e.lock_.store(&subject_lock, std::memory_order_release);
 }
 
 }  // namespace notifications
@@ -0,0 +1,88 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#include "vtss/basics/assert.hxx"
+#include "vtss/basics/notifications/subject-lock.hxx"
+
+namespace vtss {
+namespace notifications {
+
+static std::atomic<uint64_t> subject_lock_contended_total{0};
+
+void SubjectLock::lock(const char *file, int line) {
+    pthread_t self = pthread_self();
+
+    // Only this thread can have stored itself as owner
+    if (owner_.load(std::memory_order_relaxed) == self) {
+        depth_++;
+        return;
+    }
+
+    if (pthread_mutex_trylock(&m_) != 0) {
+        contended_.fetch_add(1, std::memory_order_relaxed);
+        subject_lock_contended_total.fetch_add(1, std::memory_order_relaxed);
+        int ec = pthread_mutex_lock(&m_);
+        VTSS_ASSERT(ec == 0);
+    }
+
+    owner_.store(self, std::memory_order_relaxed);
+    depth_ = 1;
+    file_ = file;
+    line_ = line;
+
+    // Only updated with the lock held
+    acquired_.store(acquired_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+}
+
+void SubjectLock::unlock(const char *file, int line) {
+    VTSS_ASSERT(owner_.load(std::memory_order_relaxed) == pthread_self());
+
+    if (--depth_) return;
+
+    owner_.store(0, std::memory_order_relaxed);
+    file_ = nullptr;
+    line_ = 0;
+    pthread_mutex_unlock(&m_);
+}
+
+void SubjectLock::counters_clear() {
+    acquired_.store(0, std::memory_order_relaxed);
+    contended_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t SubjectLock::contended_total() {
+    return subject_lock_contended_total.load(std::memory_order_relaxed);
+}
+
+void SubjectLock::contended_total_clear() {
+    subject_lock_contended_total.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace notifications
+}  // namespace vtss
@@ -38,28 +38,6 @@
 namespace vtss {
 namespace notifications {
 
-template <>
-TimeUnitMilliseconds get_relative_time<TimeUnitMilliseconds>(
-        LinuxClock::time_point now, LinuxClock::time_point abs_time) {
-    return LinuxClock::to_milliseconds(now - abs_time).raw();
-}
-
-template <>
-TimeUnitSeconds get_relative_time<TimeUnitSeconds>(
-        LinuxClock::time_point now, LinuxClock::time_point abs_time) {
-    return LinuxClock::to_seconds(now - abs_time).raw();
-}
-
-template <>
-constexpr TimeUnitSeconds get_refresh_rate() {
-    return TimeUnitSeconds{86400};
-}
-
-template <>
-constexpr TimeUnitMilliseconds get_refresh_rate() {
-    return TimeUnitMilliseconds{86400000};
-}
-
 SubjectRunnerEvent::SubjectRunnerEvent()
     : event_mark(nullptr) {
     epoll_event_fd.assign(eventfd(0, EPOLL_CLOEXEC | EFD_NONBLOCK));
@@ -70,115 +48,138 @@ SubjectRunnerEvent::SubjectRunnerEvent()
     }
 }
 
-bool SubjectRunnerEvent::timer_del_unprotected(Timer &t,
-                                               intrusive::List<Timer> &container) {
-    typedef typename intrusive::List<Timer>::iterator I;
-    for (I i = container.begin(); i != container.end(); ++i) {
-        if (&(*i) == &t) {
-            container.unlink(t);
-            request_service();
-            return true;
-        }
+TimerWheel &SubjectRunnerEvent::timer_wheel(TimeUnit::Unit unit) {
+    return unit == TimeUnit::Unit::seconds ? timer_wheel_sec : timer_wheel_msec;
+}
+
+uint64_t SubjectRunnerEvent::timer_now(TimeUnit::Unit unit,
+                                       LinuxClock::time_point now) const {
+    if (unit == TimeUnit::Unit::seconds)
+        return LinuxClock::to_seconds(now - absolute_time).raw();
+
+    return LinuxClock::to_milliseconds(now - absolute_time).raw();
+}
+
+uint64_t SubjectRunnerEvent::timer_expires(const Timer &t,
+                                           TimeUnit::Unit unit) {
+    if (!t.wheel_ || t.wheel_->unit() == unit) return t.expires_;
+
+    if (unit == TimeUnit::Unit::seconds) return t.expires_ / 1000;
+
+    return t.expires_ * 1000;
+}
+
+void SubjectRunnerEvent::timer_insert(Timer &t, TimerWheel &wheel,
+                                      uint64_t expires) {
+    wheel.insert(t, expires);
+
+    // Only wake up the runner if it is going to sleep past the new expiry.
+    if (wheel.unit() == TimeUnit::Unit::seconds) expires *= 1000;
+    if (expires < timer_wakeup) {
+        timer_wakeup = expires;
+        request_service();
     }
-    return false;
 }
 
 bool SubjectRunnerEvent::timer_del_unprotected(Timer &t) {
+    uint64_t tick;
+
     if (!t.is_linked()) {
         return true;
     }
 
-    return timer_del_unprotected(t, timer_queue_msec) ||
-           timer_del_unprotected(t, timer_queue_sec);
-}
-
-void SubjectRunnerEvent::update_absolute_time(LinuxClock::time_point time_now) {
-    if (TimeUnitMilliseconds(
-                LinuxClock::to_milliseconds(time_now - absolute_time).raw()) >
-        get_refresh_rate<TimeUnitMilliseconds>()) {
-        absolute_time = time_now;  // Update absolute time
-        LockGlobalSubject lock(__FILE__, __LINE__);
-
-        // Update timers relative to the new absolute time
-        for (auto &t : timer_queue_msec) {
-            if (!(TimeUnitMilliseconds(t.timeout().get_value()) <
-                  get_refresh_rate<TimeUnitMilliseconds>()))
-                t.timeout(TimeUnitMilliseconds(t.timeout().get_value()) -
-                          get_refresh_rate<TimeUnitMilliseconds>());
-            else
-                t.timeout(TimeUnitMilliseconds(0));
-        }
+    if (!timer_wheel_msec.remove(t) && !timer_wheel_sec.remove(t)) {
+        return false;
+    }
 
-        // Update timers relative to the new absolute times
-        for (auto &t : timer_queue_sec) {
-            if (!(TimeUnitSeconds(t.timeout().get_value()) <
-                  get_refresh_rate<TimeUnitSeconds>()))
-                t.timeout(TimeUnitSeconds(t.timeout().get_value()) -
-                          get_refresh_rate<TimeUnitSeconds>());
-            else
-                t.timeout(TimeUnitSeconds(0));
-        }
+    // A runner that is sleeping towards a deleted timer just wakes up to find
+    // nothing to do, so there is no need to wake it up now - unless it is out
+    // of timers, in which case it may have to return from run().
+    if (!timer_wheel_msec.next_event(&tick) &&
+        !timer_wheel_sec.next_event(&tick)) {
+        request_service();
     }
+
+    return true;
 }
 
 bool SubjectRunnerEvent::timer_del(Timer &t) {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
     return timer_del_unprotected(t);
 }
 
 void SubjectRunnerEvent::timer_add(Timer &t, TimeUnit timeout) {
-    switch (timeout.get_unit()) {
-    case TimeUnit::Unit::seconds:
-        timer_add(t, TimeUnitSeconds(timeout.get_value()), timer_queue_sec);
-        break;
-    case TimeUnit::Unit::milliseconds:
-        timer_add(t, TimeUnitMilliseconds(timeout.get_value()), timer_queue_msec);
-        break;
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
+    if (t.is_linked() && !timer_del_unprotected(t)) {
+        VTSS_ASSERT("Timer event belongs to an alternative subject-runner");
     }
+
+    TimerWheel &wheel = timer_wheel(timeout.get_unit());
+    timer_insert(t, wheel,
+                 timer_now(wheel.unit(), LinuxClock::now()) +
+                         timeout.get_value());
 }
 
 void SubjectRunnerEvent::timer_inc(Timer &t, TimeUnit timeout) {
-    switch (timeout.get_unit()) {
-    case TimeUnit::Unit::seconds:
-        timer_inc(t, TimeUnitSeconds(timeout.get_value()), timer_queue_sec);
-        break;
-    case TimeUnit::Unit::milliseconds:
-        timer_inc(t, TimeUnitMilliseconds(timeout.get_value()), timer_queue_msec);
-        break;
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
+    uint64_t expires = timer_expires(t, timeout.get_unit());
+
+    if (t.is_linked() && !timer_del_unprotected(t)) {
+        VTSS_ASSERT("Timer event belongs to an alternative subject-runner");
     }
+
+    timer_insert(t, timer_wheel(timeout.get_unit()),
+                 expires + timeout.get_value());
+}
+
+void SubjectRunnerEvent::timer_rearm(Timer &t, LinuxClock::time_point now) {
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
+    TimerWheel &wheel = timer_wheel(t.get_period().get_unit());
+    uint64_t period = t.get_period().get_value();
+    uint64_t expires = timer_expires(t, wheel.unit()) + period;
+    uint64_t cur = timer_now(wheel.unit(), now);
+
+    if (expires < cur) {
+        expires = cur + period;
+    }
+
+    if (t.is_linked() && !timer_del_unprotected(t)) {
+        VTSS_ASSERT("Timer event belongs to an alternative subject-runner");
+    }
+
+    timer_insert(t, wheel, expires);
 }
 
 // returns nullptr if empty
 Timer *SubjectRunnerEvent::timer_pop_msec(LinuxClock::time_point now) {
-    return timer_pop<TimeUnitMilliseconds>(now, timer_queue_msec);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
+    return timer_wheel_msec.pop(timer_now(TimeUnit::Unit::milliseconds, now));
 }
 
 Timer *SubjectRunnerEvent::timer_pop_sec(LinuxClock::time_point now) {
-    return timer_pop<TimeUnitSeconds>(now, timer_queue_sec);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
+    return timer_wheel_sec.pop(timer_now(TimeUnit::Unit::seconds, now));
 }
 
-TimeUnitMilliseconds SubjectRunnerEvent::timer_timeout() {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+bool SubjectRunnerEvent::timer_timeout(uint64_t *msec) {
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
+    uint64_t next = UINT64_MAX, tick;
 
-    if (!timer_queue_msec.empty() && !timer_queue_sec.empty()) {
-        return TimeUnitMilliseconds(
-                min(timer_queue_msec.begin()->timeout().get_value(),
-                    timer_queue_sec.begin()->timeout().get_value() * 1000));
-    }
-    if (!timer_queue_msec.empty() && timer_queue_sec.empty()) {
-        return TimeUnitMilliseconds(
-                timer_queue_msec.begin()->timeout().get_value());
+    if (timer_wheel_msec.next_event(&tick)) {
+        next = tick;
     }
-    if (timer_queue_msec.empty() && !timer_queue_sec.empty()) {
-        return TimeUnitMilliseconds(
-                timer_queue_sec.begin()->timeout().get_value() * 1000);
+
+    if (timer_wheel_sec.next_event(&tick) && tick * 1000 < next) {
+        next = tick * 1000;
     }
 
-    return TimeUnitMilliseconds{0};
+    timer_wakeup = next;
+    *msec = next;
+    return next != UINT64_MAX;
 }
 
 bool SubjectRunnerEvent::event_del(Event &t) {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
 
     typedef typename intrusive::List<Event>::iterator I;
     for (I i = event_queue.begin(); i != event_queue.end(); ++i) {
@@ -187,6 +188,7 @@ bool SubjectRunnerEvent::event_del(Event &t) {
                 event_mark = nullptr;
             }
             event_queue.unlink(t);
+            t.lock_.store(nullptr, std::memory_order_release);
             request_service();
             return true;
         }
@@ -196,16 +198,17 @@ bool SubjectRunnerEvent::event_del(Event &t) {
 }
 
 void SubjectRunnerEvent::event_add(Event &t) {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
 
     VTSS_ASSERT(!t.is_linked());
     TRACE(NOISE) << "Event add: " << &t;
     event_queue.push_back(t);
+    t.lock_.store(&event_lock, std::memory_order_release);
     request_service();
 }
 
 void SubjectRunnerEvent::event_set_mark() {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
 
     if (!event_queue.empty()) {
         auto last = event_queue.end();
@@ -218,29 +221,49 @@ void SubjectRunnerEvent::event_set_mark() {
 
 // returns nullptr if empty or mark is reached
 Event *SubjectRunnerEvent::event_pop() {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
 
     if (event_queue.empty() || event_mark == nullptr) return nullptr;
 
-    auto t = event_queue.begin();
-    if (&(*t) == event_mark) {
+    Event *t = &event_queue.front();
+    if (t == event_mark) {
         event_mark = nullptr;
     }
 
     event_queue.pop_front();
+    t->lock_.store(nullptr, std::memory_order_release);
 
-    return &(*t);
+    return t;
 }
 
 bool SubjectRunnerEvent::event_queue_empty() {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
 
     return event_queue.empty();
 }
 
 mesa_rc SubjectRunnerEvent::event_fd_add(EventFd &efd, EventFd::E flags) {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    while (1) {
+        SubjectRunnerEvent *sr = efd.sr_.load(std::memory_order_acquire);
+
+        // The file-descriptor is part of another epoll group - it must be
+        // removed from that group at first. This is done before taking our
+        // own lock, as runner locks must not be nested.
+        if (sr != this && sr != nullptr) {
+            sr->event_fd_del(efd);
+            continue;
+        }
+
+        // The file-descriptor may have been added to or deleted from a
+        // subject runner while we were waiting for the lock.
+        SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
+        if (efd.sr_.load(std::memory_order_acquire) != sr) continue;
+        return event_fd_add_unprotected(efd, flags);
+    }
+}
 
+mesa_rc SubjectRunnerEvent::event_fd_add_unprotected(EventFd &efd,
+                                                     EventFd::E flags) {
     int res = 0;
     bool rearm = false;
     epoll_event e = {};
@@ -251,7 +274,7 @@ mesa_rc SubjectRunnerEvent::event_fd_add(EventFd &efd, EventFd::E flags) {
 
     // The file-descriptor is already part of this epoll group, it just needs to
     // be re-activated.
-    if (efd.sr_ == this) {
+    if (efd.sr_.load(std::memory_order_relaxed) == this) {
         TRACE(NOISE) << "Fd: " << efd.fd_.raw() << " rearm";
         res = epoll_ctl(epoll_fd.raw(), EPOLL_CTL_MOD, efd.fd_.raw(), &e);
         rearm = true;
@@ -263,16 +286,10 @@ mesa_rc SubjectRunnerEvent::event_fd_add(EventFd &efd, EventFd::E flags) {
         }
     }
 
-    // The file-descriptor is part of another epoll group - it must be
-    // removed from that group at first.
-    if (efd.sr_ != this && efd.sr_ != nullptr) {
-        efd.sr_->event_fd_del(efd);
-    }
-
     // The file-descriptor is not part of any other epoll instance - add it
     // to
     // this subject-runner (it might just have been deleted).
-    if (efd.sr_ == nullptr) {
+    if (efd.sr_.load(std::memory_order_relaxed) == nullptr) {
         TRACE(NOISE) << "Fd: " << efd.fd_.raw() << " add";
         res = epoll_ctl(epoll_fd.raw(), EPOLL_CTL_ADD, efd.fd_.raw(), &e);
 
@@ -297,7 +314,7 @@ mesa_rc SubjectRunnerEvent::event_fd_add(EventFd &efd, EventFd::E flags) {
             return MESA_RC_ERROR;
 
         } else {
-            efd.sr_ = this;
+            efd.sr_.store(this, std::memory_order_release);
         }
     }
 
@@ -306,56 +323,61 @@ mesa_rc SubjectRunnerEvent::event_fd_add(EventFd &efd, EventFd::E flags) {
 }
 
 mesa_rc SubjectRunnerEvent::event_fd_del(EventFd &efd) {
-    // Not registered
-    if (efd.sr_ == nullptr) {
-        return true;
-    }
+    while (1) {
+        SubjectRunnerEvent *sr = efd.sr_.load(std::memory_order_acquire);
 
-    if (efd.sr_ == this) {
-        LockGlobalSubject lock(__FILE__, __LINE__);
-
-        bool found = false;
-        for (auto i = event_fd_queue.begin(); i != event_fd_queue.end();) {
-            if (i->second == &efd) {
-                event_fd_queue.erase(i++);
-                found = true;
-                break;
-            } else {
-                ++i;
-            }
+        // Not registered
+        if (sr == nullptr) {
+            return true;
         }
 
-        // Try to delete it regardless of if it is found or not.
-        TRACE(NOISE) << "Fd: " << efd.fd_.raw() << " del";
-        int res =
-                epoll_ctl(epoll_fd.raw(), EPOLL_CTL_DEL, efd.fd_.raw(), nullptr);
-
-        if (res == -1)
-            TRACE(DEBUG) << "epoll_ctl: " << strerror(errno) << "(" << errno
-                         << ")";
+        // Belongs to a different subject runner.
+        if (sr != this) {
+            return sr->event_fd_del(efd);
+        }
 
-        // No need to come back to this subject runner
-        efd.sr_ = nullptr;
+        // The file-descriptor may have been deleted (and possibly added to
+        // another subject runner) while we were waiting for the lock.
+        SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
+        if (efd.sr_.load(std::memory_order_acquire) != this) continue;
+        return event_fd_del_unprotected(efd);
+    }
+}
 
-        if (found) {
-            fd_cnt--;
-            return MESA_RC_OK;
+mesa_rc SubjectRunnerEvent::event_fd_del_unprotected(EventFd &efd) {
+    bool found = false;
+    for (auto i = event_fd_queue.begin(); i != event_fd_queue.end();) {
+        if (i->second == &efd) {
+            event_fd_queue.erase(i++);
+            found = true;
+            break;
         } else {
-            TRACE(ERROR) << "Registered here, but not found here...";
-            return MESA_RC_ERROR;
+            ++i;
         }
+    }
+
+    // Try to delete it regardless of if it is found or not.
+    TRACE(NOISE) << "Fd: " << efd.fd_.raw() << " del";
+    int res = epoll_ctl(epoll_fd.raw(), EPOLL_CTL_DEL, efd.fd_.raw(), nullptr);
+
+    if (res == -1)
+        TRACE(DEBUG) << "epoll_ctl: " << strerror(errno) << "(" << errno
+                     << ")";
 
+    // No need to come back to this subject runner
+    efd.sr_.store(nullptr, std::memory_order_release);
+
+    if (found) {
+        fd_cnt--;
+        return MESA_RC_OK;
     } else {
-        // Belongs to a different subject runner.
-        return efd.sr_->event_fd_del(efd);
+        TRACE(ERROR) << "Registered here, but not found here...";
+        return MESA_RC_ERROR;
     }
-
-    // Not reachable
-    return MESA_RC_ERROR;
 }
 
 EventFd *SubjectRunnerEvent::event_fd_pop(int fd) {
-    LockGlobalSubject lock(__FILE__, __LINE__);
+    SubjectLockGuard lock(&event_lock, __FILE__, __LINE__);
     auto itr = event_fd_queue.find(fd);
 
     if (itr == event_fd_queue.end()) {
@@ -367,10 +389,10 @@ EventFd *SubjectRunnerEvent::event_fd_pop(int fd) {
 }
 
 vtss::milliseconds SubjectRunnerEvent::get_remaining(Timer *t) const {
-    vtss::milliseconds timeout = vtss::milliseconds{t->timeout().get_value()};
-    return timeout +
-           vtss::milliseconds(LinuxClock::time_point_to_raw(absolute_time)) -
-           vtss::milliseconds(LinuxClock::time_point_to_raw(LinuxClock::now()));
+    uint64_t expires = timer_expires(*t, TimeUnit::Unit::milliseconds);
+    uint64_t now = timer_now(TimeUnit::Unit::milliseconds, LinuxClock::now());
+
+    return vtss::milliseconds(expires > now ? expires - now : 0);
 }
 
 void SubjectRunnerEvent::request_service() {
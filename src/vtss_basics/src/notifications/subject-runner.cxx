@@ -84,22 +84,23 @@ int SubjectRunner::sleep(void *epoll_event_, int max) {
     return res;
 }
 
-int SubjectRunner::sleep(void *epoll_event_, int max,
-                         TimeUnitMilliseconds next_timeout) {
-    auto sleep_time = TimeUnitMilliseconds{0};
-    auto relative_time = get_relative_time<TimeUnitMilliseconds>(
-            LinuxClock::now(), absolute_time);
-    if (!(next_timeout < relative_time))
-        sleep_time = next_timeout - relative_time;
-
-    TRACE(NOISE) << "Sleping for " << sleep_time.data_;
-    int res = epoll_wait((epoll_event *)epoll_event_, max, sleep_time.data_);
+int SubjectRunner::sleep(void *epoll_event_, int max, uint64_t next_timeout) {
+    uint64_t sleep_time = 0;
+    uint64_t relative_time =
+            LinuxClock::to_milliseconds(LinuxClock::now() - absolute_time).raw();
+    if (next_timeout > relative_time) sleep_time = next_timeout - relative_time;
+
+    // epoll_wait() takes an int. Waking up early is harmless.
+    if (sleep_time > INT32_MAX) sleep_time = INT32_MAX;
+
+    TRACE(NOISE) << "Sleping for " << sleep_time;
+    int res = epoll_wait((epoll_event *)epoll_event_, max, (int)sleep_time);
     return res;
 }
 
 void process_sigchild();
 
-TimeUnitMilliseconds SubjectRunner::run_generic() {
+bool SubjectRunner::run_generic(uint64_t *next_timeout) {
     typename LinuxClock::time_point now = LinuxClock::now();
 
     ScopeLock<CritdRecursive> runner_lock(&runner_mutex, __FILE__, __LINE__);
@@ -126,25 +127,11 @@ TimeUnitMilliseconds SubjectRunner::run_generic() {
     }
 
 
-    // first try to update timers in case there is needed a refresh
-    update_absolute_time(now);
-
-    // evaluate timer_queues
+    // evaluate timer wheels
     for (auto t = timer_pop_msec(now); t != nullptr; t = timer_pop_msec(now)) {
         TRACE(NOISE) << "timer-event-execute " << &(*t);
         if (t->get_repeat()) {
-            auto relative_time =
-                    get_relative_time<TimeUnitMilliseconds>(now, absolute_time);
-            if (TimeUnitMilliseconds(t->timeout().get_value() +
-                                     t->get_period().get_value()) <
-                relative_time) {
-                timer_inc(*t, TimeUnit(relative_time.data_ -
-                                               (t->timeout().get_value() -
-                                                t->get_period().get_value()),
-                                       TimeUnit::Unit::milliseconds));
-            } else {
-                timer_inc(*t, t->get_period());
-            }
+            timer_rearm(*t, now);
         }
 
         if (unlock_on_callback) {
@@ -161,17 +148,7 @@ TimeUnitMilliseconds SubjectRunner::run_generic() {
     for (auto t = timer_pop_sec(now); t != nullptr; t = timer_pop_sec(now)) {
         TRACE(NOISE) << "timer-event-execute " << &(*t);
         if (t->get_repeat()) {
-            auto relative_time =
-                    get_relative_time<TimeUnitSeconds>(now, absolute_time);
-            if (TimeUnitSeconds(t->timeout().get_value() +
-                                t->get_period().get_value()) < relative_time) {
-                timer_inc(*t, TimeUnit(relative_time.data_ -
-                                               (t->timeout().get_value() -
-                                                t->get_period().get_value()),
-                                       TimeUnit::Unit::seconds));
-            } else {
-                timer_inc(*t, t->get_period());
-            }
+            timer_rearm(*t, now);
         }
 
         if (unlock_on_callback) {
@@ -188,7 +165,7 @@ TimeUnitMilliseconds SubjectRunner::run_generic() {
     TRACE(NOISE) << "TriggerCnt: " << trigger_cnt
                  << " TimerTriggerCnt: " << timer_trigger_cnt;
 
-    return timer_timeout();
+    return timer_timeout(next_timeout);
 }
 
 void SubjectRunner::run(bool return_when_out_of_work) {
@@ -203,7 +180,8 @@ void SubjectRunner::run(bool return_when_out_of_work) {
         // We do not want to be signaled while invoking the callback handlers
         sigfillset(&signal_set);
         pthread_sigmask(SIG_BLOCK, &signal_set, NULL);
-        auto next_timeout = run_generic();
+        uint64_t next_timeout;
+        bool timer_pending = run_generic(&next_timeout);
 
         // Process the epoll events
         TRACE(NOISE) << "epoll_event_cnt: " << epoll_event_cnt;
@@ -252,7 +230,7 @@ void SubjectRunner::run(bool return_when_out_of_work) {
         // Open up for signaling again
         pthread_sigmask(SIG_UNBLOCK, &signal_set, NULL);
 
-        if (next_timeout == TimeUnitMilliseconds{0}) {
+        if (!timer_pending) {
             if (!fd_cnt) {
                 TRACE(NOISE) << "Out of work";
                 if (return_when_out_of_work_ && !signaled) {
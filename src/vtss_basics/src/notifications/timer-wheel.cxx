@@ -0,0 +1,191 @@
+/*
+
+ Copyright (c) 2006-2019 Microsemi Corporation "Microsemi". All Rights Reserved.
+
+ Unpublished rights reserved under the copyright laws of the United States of
+ America, other countries and international treaties. Permission to use, copy,
+ store and modify, the software and its source code is granted but only in
+ connection with products utilizing the Microsemi switch and PHY products.
+ Permission is also granted for you to integrate into other products, disclose,
+ transmit and distribute the software only in an absolute machine readable
+ format (e.g. HEX file) and only in or with products utilizing the Microsemi
+ switch and PHY products.  The source code of the software may not be
+ disclosed, transmitted or distributed without the prior written permission of
+ Microsemi.
+
+ This copyright notice must appear in any copy, modification, disclosure,
+ transmission or distribution of the software.  Microsemi retains all
+ ownership, copyright, trade secret and proprietary rights in the software and
+ its source code, including all modifications thereto.
+
+ THIS SOFTWARE HAS BEEN PROVIDED "AS IS". MICROSEMI HEREBY DISCLAIMS ALL
+ WARRANTIES OF ANY KIND WITH RESPECT TO THE SOFTWARE, WHETHER SUCH WARRANTIES
+ ARE EXPRESS, IMPLIED, STATUTORY OR OTHERWISE INCLUDING, WITHOUT LIMITATION,
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR USE OR PURPOSE AND
+ NON-INFRINGEMENT.
+
+*/
+
+#include "vtss/basics/notifications/timer-wheel.hxx"
+
+namespace vtss {
+namespace notifications {
+
+static constexpr uint64_t SLOT_MASK = TimerWheel::SLOTS - 1;
+
+// Number of ticks covered by one slot at level #l
+static constexpr unsigned level_shift(unsigned l) {
+    return l * TimerWheel::SLOT_BITS;
+}
+
+TimerWheel::~TimerWheel() {
+    // Timers are owned by the users - just let go of them.
+    auto release = [](intrusive::List<Timer> &list) {
+        while (!list.empty()) {
+            Timer &t = list.front();
+            list.pop_front();
+            t.lock_.store(nullptr, std::memory_order_release);
+        }
+    };
+
+    release(expired_);
+    release(overflow_);
+    for (unsigned l = 0; l < LEVELS; ++l)
+        for (unsigned s = 0; s < SLOTS; ++s) release(slot_[l][s]);
+}
+
+void TimerWheel::place(Timer &t) {
+    uint64_t e = t.expires_;
+
+    if (e <= now_) {
+        expired_.push_back(t);
+        return;
+    }
+
+    for (unsigned l = 0; l < LEVELS; ++l) {
+        unsigned shift = level_shift(l + 1);
+        if ((e >> shift) == (now_ >> shift)) {
+            unsigned s = (e >> level_shift(l)) & SLOT_MASK;
+            slot_[l][s].push_back(t);
+            bitmap_[l] |= 1ULL << s;
+            return;
+        }
+    }
+
+    overflow_.push_back(t);
+}
+
+// Re-place all timers in #list. A timer never ends up in the slot it is
+// cascaded from.
+void TimerWheel::cascade(intrusive::List<Timer> &list) {
+    while (!list.empty()) {
+        Timer &t = list.front();
+        list.pop_front();
+        place(t);
+    }
+}
+
+void TimerWheel::insert(Timer &t, uint64_t expires) {
+    VTSS_ASSERT(!t.is_linked());
+    t.expires_ = expires;
+    t.wheel_ = this;
+    place(t);
+    t.lock_.store(lock_, std::memory_order_release);
+}
+
+bool TimerWheel::remove(Timer &t) {
+    if (!t.is_linked() || t.wheel_ != this) return false;
+
+    // The bitmap bit of the slot is left set. It is cleared the next time the
+    // slot is found empty.
+    t.ListNode::unlink();
+    t.lock_.store(nullptr, std::memory_order_release);
+    return true;
+}
+
+bool TimerWheel::next_slot(uint64_t *tick) {
+    for (unsigned l = 0; l < LEVELS; ++l) {
+        // Only slots after the current one can be in use. The current slot at
+        // each level was emptied when time reached it.
+        unsigned cur = (now_ >> level_shift(l)) & SLOT_MASK;
+        uint64_t pending = bitmap_[l] & ~((2ULL << cur) - 1);
+
+        while (pending) {
+            unsigned s = __builtin_ctzll(pending);
+            if (slot_[l][s].empty()) {
+                bitmap_[l] &= ~(1ULL << s);
+                pending &= pending - 1;
+                continue;
+            }
+
+            // A slot at a lower level always expires before any slot at a
+            // higher level.
+            unsigned shift = level_shift(l + 1);
+            *tick = ((now_ >> shift) << shift) | ((uint64_t)s << level_shift(l));
+            return true;
+        }
+    }
+
+    if (!overflow_.empty()) {
+        unsigned shift = level_shift(LEVELS);
+        *tick = ((now_ >> shift) + 1) << shift;
+        return true;
+    }
+
+    return false;
+}
+
+bool TimerWheel::next_event(uint64_t *tick) {
+    if (!expired_.empty()) {
+        *tick = now_;
+        return true;
+    }
+
+    return next_slot(tick);
+}
+
+Timer *TimerWheel::pop(uint64_t now) {
+    uint64_t next;
+
+    while (now_ < now) {
+        if (!next_slot(&next) || next > now) {
+            // Nothing happens until #now, so just skip ahead.
+            now_ = now;
+            break;
+        }
+
+        now_ = next;
+
+        // Cascade the slots that have become current, starting from the top.
+        if ((now_ & ((1ULL << level_shift(LEVELS)) - 1)) == 0) {
+            // Timers still out of range go back into the overflow list, so
+            // take them all out first.
+            intrusive::List<Timer> overflow;
+            while (!overflow_.empty()) {
+                Timer &t = overflow_.front();
+                overflow_.pop_front();
+                overflow.push_back(t);
+            }
+
+            cascade(overflow);
+        }
+
+        for (unsigned l = LEVELS; l-- > 0;) {
+            if (now_ & ((1ULL << level_shift(l)) - 1)) continue;
+
+            unsigned s = (now_ >> level_shift(l)) & SLOT_MASK;
+            bitmap_[l] &= ~(1ULL << s);
+            cascade(slot_[l][s]);
+        }
+    }
+
+    if (expired_.empty()) return nullptr;
+
+    Timer &t = expired_.front();
+    expired_.pop_front();
+    t.lock_.store(nullptr, std::memory_order_release);
+    return &t;
+}
+
+}  // namespace notifications
+}  // namespace vtss
@@ -27,31 +27,64 @@
 */
 
 #include "vtss/basics/notifications/timer.hxx"
-#include "vtss/basics/notifications/lock-global-subject.hxx"
+#include "vtss/basics/notifications/timer-wheel.hxx"
+#include "vtss/basics/notifications/subject-lock.hxx"
 
 namespace vtss {
 namespace notifications {
 
 void Timer::unlink() {
-    LockGlobalSubject lock(__FILE__, __LINE__);
-    intrusive::ListNode::unlink();
+    while (1) {
+        // The wheel may be gone if the timer is not linked, so don't touch
+        // it unless it holds the timer.
+        SubjectLock *l = lock_.load(std::memory_order_acquire);
+        if (l == nullptr) return;
+
+        // The timer may have expired or been moved to another wheel while we
+        // were waiting for the lock.
+        SubjectLockGuard lock(l, __FILE__, __LINE__);
+        if (lock_.load(std::memory_order_acquire) != l) continue;
+        if (is_linked()) intrusive::ListNode::unlink();
+        lock_.store(nullptr, std::memory_order_release);
+        return;
+    }
 }
 
 Timer::Timer(EventHandler * cb)
     : cb_(cb)
-    , timeout_{TimeUnitMilliseconds{0}}
     , period_{TimeUnitMilliseconds{0}} {}
 
+Timer::Timer(const Timer &rhs)
+    : intrusive::ListNode()
+    , cb_(rhs.cb_)
+    , expires_(rhs.expires_)
+    , wheel_(rhs.wheel_)
+    , period_(rhs.period_) {}
+
+Timer &Timer::operator=(const Timer &rhs) {
+    if (this == &rhs) return *this;
+
+    unlink();
+    cb_ = rhs.cb_;
+    expires_ = rhs.expires_;
+    wheel_ = rhs.wheel_;
+    period_ = rhs.period_;
+    return *this;
+}
+
 TimeUnit Timer::timeout() const {
-    return timeout_;
+    return TimeUnit(expires_, wheel_ ? wheel_->unit() : TimeUnit::Unit::milliseconds);
 }
 
-bool Timer::operator<(const Timer& rhs) {
-    return timeout_.get_value() < rhs.timeout().get_value();
+uint64_t Timer::expires_ms() const {
+    if (wheel_ && wheel_->unit() == TimeUnit::Unit::seconds)
+        return expires_ * 1000;
+    return expires_;
 }
 
-void Timer::timeout(TimeUnit to) {
-    timeout_ = to;
+bool Timer::operator<(const Timer& rhs) {
+    // The two timers may be in wheels of different units.
+    return expires_ms() < rhs.expires_ms();
 }
 
 void Timer::invoke_cb() {